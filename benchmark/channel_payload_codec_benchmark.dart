@@ -0,0 +1,79 @@
+// 截图通道载荷的编解码基准（不属于单元测试，`flutter test` 默认只跑 test/）
+//
+// 运行：flutter test benchmark/channel_payload_codec_benchmark.dart
+//
+// 对比原生端返回 EncodableList（旧实现，每个字节装箱成 int，Dart 收到 List<Object?>
+// 后再转 Uint8List）和返回 std::vector<uint8_t>（Dart 直接收到 Uint8List）两种方式
+// 在 StandardMethodCodec 上的耗时和信封大小。载荷按约 1 字节/像素的 PNG 截图估算。
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+
+const _codec = StandardMethodCodec();
+
+const _frames = <String, List<int>>{
+  '1080p': [1920, 1080],
+  '4K': [3840, 2160],
+  '8K': [7680, 4320],
+};
+
+/// 每种方式先预热一次，再取多次运行的中位数
+const _runs = 5;
+
+Uint8List _makePayload(int length) {
+  final bytes = Uint8List(length);
+  for (var i = 0; i < length; i++) {
+    bytes[i] = (i * 31) & 0xFF;
+  }
+  return bytes;
+}
+
+/// 运行 body 并返回耗时中位数（微秒）
+int _medianMicros(void Function() body) {
+  body();
+  final samples = <int>[];
+  final stopwatch = Stopwatch();
+  for (var i = 0; i < _runs; i++) {
+    stopwatch
+      ..reset()
+      ..start();
+    body();
+    samples.add(stopwatch.elapsedMicroseconds);
+  }
+  samples.sort();
+  return samples[samples.length ~/ 2];
+}
+
+void main() {
+  for (final entry in _frames.entries) {
+    final payloadLength = entry.value[0] * entry.value[1];
+
+    test('codec cost (${entry.key})', () {
+      final payload = _makePayload(payloadLength);
+
+      late ByteData envelope;
+      final typedUs = _medianMicros(() {
+        envelope = _codec.encodeSuccessEnvelope(payload);
+        _codec.decodeEnvelope(envelope) as Uint8List;
+      });
+
+      // 旧实现：原生端逐字节装箱，Dart 端还要再拷贝一次
+      final boxed = List<int>.from(payload);
+      late ByteData legacyEnvelope;
+      final legacyUs = _medianMicros(() {
+        legacyEnvelope = _codec.encodeSuccessEnvelope(boxed);
+        final decoded = _codec.decodeEnvelope(legacyEnvelope) as List<Object?>;
+        Uint8List.fromList(List<int>.from(decoded));
+      });
+
+      print(
+        '${entry.key}: payload ${payloadLength ~/ 1024} KiB | '
+        'EncodableList ${legacyUs ~/ 1000} ms, '
+        'envelope ${legacyEnvelope.lengthInBytes ~/ 1024} KiB | '
+        'Uint8List ${typedUs ~/ 1000} ms, '
+        'envelope ${envelope.lengthInBytes ~/ 1024} KiB',
+      );
+    }, timeout: const Timeout(Duration(minutes: 10)));
+  }
+}
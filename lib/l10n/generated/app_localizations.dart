@@ -3980,6 +3980,66 @@ abstract class AppLocalizations {
   /// **'保存目录'**
   String get screenshot_save_directory;
 
+  /// No description provided for @screenshot_fast_storage.
+  ///
+  /// In zh, this message translates to:
+  /// **'快速存储（先存为 QOI，空闲时转成 PNG）'**
+  String get screenshot_fast_storage;
+
+  /// No description provided for @screenshot_change_detection.
+  ///
+  /// In zh, this message translates to:
+  /// **'变化检测'**
+  String get screenshot_change_detection;
+
+  /// No description provided for @screenshot_change_detection_off.
+  ///
+  /// In zh, this message translates to:
+  /// **'每次都保存'**
+  String get screenshot_change_detection_off;
+
+  /// No description provided for @screenshot_change_detection_skip.
+  ///
+  /// In zh, this message translates to:
+  /// **'画面未变化时跳过'**
+  String get screenshot_change_detection_skip;
+
+  /// No description provided for @screenshot_change_detection_tiles.
+  ///
+  /// In zh, this message translates to:
+  /// **'只保存变化的分块'**
+  String get screenshot_change_detection_tiles;
+
+  /// No description provided for @screenshot_dedup.
+  ///
+  /// In zh, this message translates to:
+  /// **'近似重复过滤'**
+  String get screenshot_dedup;
+
+  /// No description provided for @screenshot_dedup_off.
+  ///
+  /// In zh, this message translates to:
+  /// **'关闭'**
+  String get screenshot_dedup_off;
+
+  /// No description provided for @screenshot_dedup_strict.
+  ///
+  /// In zh, this message translates to:
+  /// **'严格（只过滤几乎相同的截图）'**
+  String get screenshot_dedup_strict;
+
+  /// No description provided for @screenshot_dedup_normal.
+  ///
+  /// In zh, this message translates to:
+  /// **'标准（忽略光标、时钟等变化）'**
+  String get screenshot_dedup_normal;
+
+  /// No description provided for @screenshot_dedup_loose.
+  ///
+  /// In zh, this message translates to:
+  /// **'宽松（忽略小范围内容变化）'**
+  String get screenshot_dedup_loose;
+
   /// No description provided for @screenshot_interval_unit.
   ///
   /// In zh, this message translates to:
@@ -4406,6 +4466,36 @@ abstract class AppLocalizations {
   /// **'全屏截图'**
   String get screenshot_shortcut_fullscreen;
 
+  /// No description provided for @screenshot_shortcut_save_replay.
+  ///
+  /// In zh, this message translates to:
+  /// **'保存即时回放'**
+  String get screenshot_shortcut_save_replay;
+
+  /// No description provided for @screenshot_settings_section_replay.
+  ///
+  /// In zh, this message translates to:
+  /// **'即时回放'**
+  String get screenshot_settings_section_replay;
+
+  /// No description provided for @screenshot_instant_replay_enable.
+  ///
+  /// In zh, this message translates to:
+  /// **'开启即时回放'**
+  String get screenshot_instant_replay_enable;
+
+  /// No description provided for @screenshot_instant_replay_desc.
+  ///
+  /// In zh, this message translates to:
+  /// **'后台保留主显示器最近 {seconds} 秒的画面，按快捷键保存为动画'**
+  String screenshot_instant_replay_desc(int seconds);
+
+  /// No description provided for @screenshot_instant_replay_stats.
+  ///
+  /// In zh, this message translates to:
+  /// **'CPU {cpu}% · 内存 {memory} MB'**
+  String screenshot_instant_replay_stats(String cpu, String memory);
+
   /// No description provided for @screenshot_settings_json_editor.
   ///
   /// In zh, this message translates to:
@@ -5571,6 +5661,48 @@ abstract class AppLocalizations {
   /// **'窗口截图'**
   String get screenshot_main_window_capture;
 
+  /// No description provided for @screenshot_main_record_region.
+  ///
+  /// In zh, this message translates to:
+  /// **'录制区域'**
+  String get screenshot_main_record_region;
+
+  /// No description provided for @screenshot_main_stop_recording.
+  ///
+  /// In zh, this message translates to:
+  /// **'停止录制'**
+  String get screenshot_main_stop_recording;
+
+  /// No description provided for @screenshot_recording_saved.
+  ///
+  /// In zh, this message translates to:
+  /// **'录屏已保存'**
+  String get screenshot_recording_saved;
+
+  /// No description provided for @screenshot_recording_failed.
+  ///
+  /// In zh, this message translates to:
+  /// **'录屏失败'**
+  String get screenshot_recording_failed;
+
+  /// No description provided for @screenshot_main_scrolling_capture.
+  ///
+  /// In zh, this message translates to:
+  /// **'长截图'**
+  String get screenshot_main_scrolling_capture;
+
+  /// No description provided for @screenshot_scrolling_saved.
+  ///
+  /// In zh, this message translates to:
+  /// **'长截图已保存'**
+  String get screenshot_scrolling_saved;
+
+  /// No description provided for @screenshot_scrolling_failed.
+  ///
+  /// In zh, this message translates to:
+  /// **'长截图失败'**
+  String get screenshot_scrolling_failed;
+
   /// No description provided for @screenshot_main_recent_screenshots.
   ///
   /// In zh, this message translates to:
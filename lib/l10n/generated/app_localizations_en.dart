@@ -2139,6 +2139,38 @@ class AppLocalizationsEn extends AppLocalizations {
   @override
   String get screenshot_save_directory => 'Save Directory';
 
+  @override
+  String get screenshot_fast_storage =>
+      'Fast storage (QOI, converted to PNG when idle)';
+
+  @override
+  String get screenshot_change_detection => 'Change detection';
+
+  @override
+  String get screenshot_change_detection_off => 'Save every shot';
+
+  @override
+  String get screenshot_change_detection_skip => 'Skip unchanged shots';
+
+  @override
+  String get screenshot_change_detection_tiles => 'Save only changed tiles';
+
+  @override
+  String get screenshot_dedup => 'Near-duplicate filter';
+
+  @override
+  String get screenshot_dedup_off => 'Off';
+
+  @override
+  String get screenshot_dedup_strict => 'Strict (almost identical only)';
+
+  @override
+  String get screenshot_dedup_normal =>
+      'Normal (ignore cursor and clock changes)';
+
+  @override
+  String get screenshot_dedup_loose => 'Loose (ignore small content changes)';
+
   @override
   String get screenshot_interval_unit => 'Unit';
 
@@ -2375,6 +2407,25 @@ class AppLocalizationsEn extends AppLocalizations {
   @override
   String get screenshot_shortcut_fullscreen => 'Fullscreen Screenshot';
 
+  @override
+  String get screenshot_shortcut_save_replay => 'Save Instant Replay';
+
+  @override
+  String get screenshot_settings_section_replay => 'Instant Replay';
+
+  @override
+  String get screenshot_instant_replay_enable => 'Enable Instant Replay';
+
+  @override
+  String screenshot_instant_replay_desc(int seconds) {
+    return 'Keep the last $seconds seconds of the primary display in memory; press the shortcut to save them as an animation';
+  }
+
+  @override
+  String screenshot_instant_replay_stats(String cpu, String memory) {
+    return 'CPU $cpu% · Memory $memory MB';
+  }
+
   @override
   String get screenshot_settings_json_editor => 'JSON Configuration Editor';
 
@@ -3018,6 +3069,27 @@ class AppLocalizationsEn extends AppLocalizations {
   @override
   String get screenshot_main_window_capture => 'Window Capture';
 
+  @override
+  String get screenshot_main_record_region => 'Record Region';
+
+  @override
+  String get screenshot_main_stop_recording => 'Stop Recording';
+
+  @override
+  String get screenshot_recording_saved => 'Recording saved';
+
+  @override
+  String get screenshot_recording_failed => 'Recording failed';
+
+  @override
+  String get screenshot_main_scrolling_capture => 'Scrolling Capture';
+
+  @override
+  String get screenshot_scrolling_saved => 'Scrolling screenshot saved';
+
+  @override
+  String get screenshot_scrolling_failed => 'Scrolling screenshot failed';
+
   @override
   String get screenshot_main_recent_screenshots => 'Recent Screenshots';
 
@@ -2076,6 +2076,36 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get screenshot_save_directory => '保存目录';
 
+  @override
+  String get screenshot_fast_storage => '快速存储（先存为 QOI，空闲时转成 PNG）';
+
+  @override
+  String get screenshot_change_detection => '变化检测';
+
+  @override
+  String get screenshot_change_detection_off => '每次都保存';
+
+  @override
+  String get screenshot_change_detection_skip => '画面未变化时跳过';
+
+  @override
+  String get screenshot_change_detection_tiles => '只保存变化的分块';
+
+  @override
+  String get screenshot_dedup => '近似重复过滤';
+
+  @override
+  String get screenshot_dedup_off => '关闭';
+
+  @override
+  String get screenshot_dedup_strict => '严格（只过滤几乎相同的截图）';
+
+  @override
+  String get screenshot_dedup_normal => '标准（忽略光标、时钟等变化）';
+
+  @override
+  String get screenshot_dedup_loose => '宽松（忽略小范围内容变化）';
+
   @override
   String get screenshot_interval_unit => '单位';
 
@@ -2297,6 +2327,25 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get screenshot_shortcut_fullscreen => '全屏截图';
 
+  @override
+  String get screenshot_shortcut_save_replay => '保存即时回放';
+
+  @override
+  String get screenshot_settings_section_replay => '即时回放';
+
+  @override
+  String get screenshot_instant_replay_enable => '开启即时回放';
+
+  @override
+  String screenshot_instant_replay_desc(int seconds) {
+    return '后台保留主显示器最近 $seconds 秒的画面，按快捷键保存为动画';
+  }
+
+  @override
+  String screenshot_instant_replay_stats(String cpu, String memory) {
+    return 'CPU $cpu% · 内存 $memory MB';
+  }
+
   @override
   String get screenshot_settings_json_editor => 'JSON 配置编辑器';
 
@@ -2916,6 +2965,27 @@ class AppLocalizationsZh extends AppLocalizations {
   @override
   String get screenshot_main_window_capture => '窗口截图';
 
+  @override
+  String get screenshot_main_record_region => '录制区域';
+
+  @override
+  String get screenshot_main_stop_recording => '停止录制';
+
+  @override
+  String get screenshot_recording_saved => '录屏已保存';
+
+  @override
+  String get screenshot_recording_failed => '录屏失败';
+
+  @override
+  String get screenshot_main_scrolling_capture => '长截图';
+
+  @override
+  String get screenshot_scrolling_saved => '长截图已保存';
+
+  @override
+  String get screenshot_scrolling_failed => '长截图失败';
+
   @override
   String get screenshot_main_recent_screenshots => '最近截图';
 
@@ -20,7 +20,8 @@ class ScreenshotConfigDefaults {
   "historyRetentionDays": 30,
   "shortcuts": {
     "regionCapture": "Ctrl+Shift+A",
-    "fullScreenCapture": "Ctrl+Shift+F"
+    "fullScreenCapture": "Ctrl+Shift+F",
+    "saveReplay": "Ctrl+Shift+R"
   },
   "pinSettings": {
     "alwaysOnTop": true,
@@ -28,6 +29,13 @@ class ScreenshotConfigDefaults {
     "enableDrag": true,
     "enableResize": false,
     "showCloseButton": true
+  },
+  "instantReplay": {
+    "enabled": false,
+    "seconds": 30,
+    "fps": 2,
+    "memoryLimitMb": 64,
+    "format": "apng"
   }
 }''';
 
@@ -78,7 +86,9 @@ class ScreenshotConfigDefaults {
   "shortcuts": {
     "_help": "快捷键设置",
     "regionCapture": "Ctrl+Shift+A",
-    "fullScreenCapture": "Ctrl+Shift+F"
+    "fullScreenCapture": "Ctrl+Shift+F",
+    "saveReplay": "Ctrl+Shift+R",
+    "_saveReplay_help": "保存即时回放（最近 N 秒的画面），需要先开启 instantReplay"
   },
 
   "pinSettings": {
@@ -89,6 +99,19 @@ class ScreenshotConfigDefaults {
     "enableDrag": true,
     "enableResize": false,
     "showCloseButton": true
+  },
+
+  "instantReplay": {
+    "_help": "即时回放：后台低帧率采集主显示器，只在内存中保留最近一段画面",
+    "enabled": false,
+    "seconds": 30,
+    "_seconds_help": "保留的秒数，范围: 1-600",
+    "fps": 2,
+    "_fps_help": "采集帧率，范围: 1-10；越低越省 CPU",
+    "memoryLimitMb": 64,
+    "_memoryLimitMb_help": "压缩帧的内存上限，范围: 8-2048，超出时丢掉最旧的画面",
+    "format": "apng",
+    "_format_help": "可选值: apng (无损), gif (256 色，兼容性好)"
   }
 }''';
 
@@ -185,7 +208,8 @@ class ScreenshotConfigDefaults {
       "description": "快捷键设置",
       "properties": {
         "regionCapture": {"type": "string"},
-        "fullScreenCapture": {"type": "string"}
+        "fullScreenCapture": {"type": "string"},
+        "saveReplay": {"type": "string"}
       }
     },
     "pinSettings": {
@@ -202,6 +226,17 @@ class ScreenshotConfigDefaults {
         "enableResize": {"type": "boolean"},
         "showCloseButton": {"type": "boolean"}
       }
+    },
+    "instantReplay": {
+      "type": "object",
+      "description": "即时回放设置",
+      "properties": {
+        "enabled": {"type": "boolean"},
+        "seconds": {"type": "integer", "minimum": 1, "maximum": 600},
+        "fps": {"type": "integer", "minimum": 1, "maximum": 10},
+        "memoryLimitMb": {"type": "integer", "minimum": 8, "maximum": 2048},
+        "format": {"type": "string", "enum": ["apng", "gif"]}
+      }
     }
   }
 }''';
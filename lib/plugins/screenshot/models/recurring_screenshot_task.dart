@@ -15,6 +15,21 @@ enum TaskStatus {
   stopped,
 }
 
+/// 循环截图的变化检测方式
+///
+/// 原生端把每一帧按 64x64 分块哈希，和同一任务上一次保存的整帧比较
+enum ChangeDetection {
+  /// 每次都保存
+  off,
+
+  /// 画面没有变化时跳过
+  skipUnchanged,
+
+  /// 跳过未变化的截图；变化不大时只保存变化的分块（透明 PNG 补丁），
+  /// 存放在任务自己的增量目录中，不进入历史记录
+  dirtyTiles,
+}
+
 /// 循环截图任务模型
 class RecurringScreenshotTask {
   /// 任务唯一ID
@@ -38,6 +53,20 @@ class RecurringScreenshotTask {
   /// 存放目录（如果为null，则使用默认目录）
   final String? saveDirectory;
 
+  /// 快速存储：先以 QOI 落盘，截图空闲时再转成 PNG
+  ///
+  /// 适合秒级间隔的高频截图，每次截图不必等待 PNG 压缩
+  final bool fastStorage;
+
+  /// 变化检测方式
+  final ChangeDetection changeDetection;
+
+  /// 近似重复过滤：与上一次保存的截图的感知哈希汉明距离不超过该值时不保存
+  ///
+  /// 为 null 时不过滤。分块变化检测对光标闪烁、时钟跳动这类变化无能为力，
+  /// 感知哈希（9x8 灰度 dHash）对它们几乎不敏感
+  final int? dedupDistance;
+
   /// 任务状态
   final TaskStatus status;
 
@@ -58,6 +87,9 @@ class RecurringScreenshotTask {
     required this.intervalSeconds,
     this.totalShots,
     this.saveDirectory,
+    this.fastStorage = false,
+    this.changeDetection = ChangeDetection.off,
+    this.dedupDistance,
     required this.status,
     this.completedShots = 0,
     required this.createdAt,
@@ -74,6 +106,12 @@ class RecurringScreenshotTask {
       intervalSeconds: json['intervalSeconds'] as int,
       totalShots: json['totalShots'] as int?,
       saveDirectory: json['saveDirectory'] as String?,
+      fastStorage: json['fastStorage'] as bool? ?? false,
+      changeDetection: ChangeDetection.values.firstWhere(
+        (e) => e.name == json['changeDetection'],
+        orElse: () => ChangeDetection.off,
+      ),
+      dedupDistance: json['dedupDistance'] as int?,
       status: TaskStatus.values.firstWhere(
         (e) => e.name == json['status'] as String,
         orElse: () => TaskStatus.stopped,
@@ -96,6 +134,9 @@ class RecurringScreenshotTask {
       'intervalSeconds': intervalSeconds,
       'totalShots': totalShots,
       'saveDirectory': saveDirectory,
+      'fastStorage': fastStorage,
+      'changeDetection': changeDetection.name,
+      'dedupDistance': dedupDistance,
       'status': status.name,
       'completedShots': completedShots,
       'createdAt': createdAt.toIso8601String(),
@@ -112,6 +153,9 @@ class RecurringScreenshotTask {
     int? intervalSeconds,
     int? totalShots,
     String? saveDirectory,
+    bool? fastStorage,
+    ChangeDetection? changeDetection,
+    int? dedupDistance,
     TaskStatus? status,
     int? completedShots,
     DateTime? createdAt,
@@ -125,6 +169,9 @@ class RecurringScreenshotTask {
       intervalSeconds: intervalSeconds ?? this.intervalSeconds,
       totalShots: totalShots ?? this.totalShots,
       saveDirectory: saveDirectory ?? this.saveDirectory,
+      fastStorage: fastStorage ?? this.fastStorage,
+      changeDetection: changeDetection ?? this.changeDetection,
+      dedupDistance: dedupDistance ?? this.dedupDistance,
       status: status ?? this.status,
       completedShots: completedShots ?? this.completedShots,
       createdAt: createdAt ?? this.createdAt,
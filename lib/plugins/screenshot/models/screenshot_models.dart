@@ -2,6 +2,7 @@ library;
 
 import 'dart:typed_data';
 import 'dart:io';
+import 'screenshot_settings.dart';
 
 /// 截图类型枚举
 enum ScreenshotType {
@@ -30,6 +31,17 @@ enum HistoryPeriod {
   older,
 }
 
+/// 两个 64 位感知哈希不同的位数（0-64），越小越相似
+int hammingDistance(int a, int b) {
+  var v = a ^ b;
+  var count = 0;
+  while (v != 0) {
+    v &= v - 1;
+    count++;
+  }
+  return count;
+}
+
 /// 截图记录模型
 class ScreenshotRecord {
   /// 唯一标识符
@@ -103,6 +115,23 @@ class ScreenshotRecord {
     return filePath.isNotEmpty && File(filePath).existsSync();
   }
 
+  /// 截图时原生端计算的感知哈希（dHash），保存在 [metadata] 的 `perceptualHash`
+  int? get perceptualHash {
+    final hex = metadata?['perceptualHash'];
+    if (hex is! String) return null;
+    return BigInt.tryParse(hex, radix: 16)?.toSigned(64).toInt();
+  }
+
+  /// 把感知哈希写成元数据（16 位十六进制，避免 JSON 处理 64 位整数的精度问题）
+  static Map<String, dynamic> perceptualHashMetadata(int? hash) {
+    if (hash == null) return {};
+    return {
+      'perceptualHash': BigInt.from(
+        hash,
+      ).toUnsigned(64).toRadixString(16).padLeft(16, '0'),
+    };
+  }
+
   /// 获取文件扩展名
   String get fileExtension {
     return filePath.split('.').last.toLowerCase();
@@ -176,6 +205,22 @@ class WindowInfo {
     );
   }
 
+  /// 从原生通道返回的 map 创建实例（getAvailableWindows 不带坐标时边界为空）
+  factory WindowInfo.fromMap(Map<dynamic, dynamic> map) {
+    return WindowInfo(
+      id: map['id'] as String,
+      title: map['title'] as String,
+      bounds: Rect.fromLTWH(
+        (map['x'] as int? ?? 0).toDouble(),
+        (map['y'] as int? ?? 0).toDouble(),
+        (map['width'] as int? ?? 0).toDouble(),
+        (map['height'] as int? ?? 0).toDouble(),
+      ),
+      appName: map['appName'] as String?,
+      icon: map['icon'] as Uint8List?,
+    );
+  }
+
   /// 转换为 JSON
   Map<String, dynamic> toJson() {
     return {
@@ -191,6 +236,836 @@ class WindowInfo {
   }
 }
 
+/// 窗口列表的一次变化（[ScreenshotPlatformInterface.watchWindows]）
+///
+/// 原生端按窗口合并一批事件：同一窗口只出现一次，出现后又消失的窗口不报告。
+class WindowListChange {
+  /// 为 true 时 [added] 是完整的初始列表，替换当前列表
+  final bool reset;
+
+  /// 新出现的窗口，最近出现的在前
+  final List<WindowInfo> added;
+
+  /// 标题、图标或位置变化的窗口
+  final List<WindowInfo> updated;
+
+  /// 消失（关闭、隐藏、最小化）的窗口 ID
+  final List<String> removed;
+
+  const WindowListChange({
+    this.reset = false,
+    this.added = const [],
+    this.updated = const [],
+    this.removed = const [],
+  });
+
+  /// 从原生端 onWindowsChanged 的参数创建实例
+  factory WindowListChange.fromMap(Map<dynamic, dynamic> map) {
+    List<WindowInfo> windows(Object? list) => [
+      for (final window in list as List<dynamic>? ?? const [])
+        WindowInfo.fromMap(window as Map<dynamic, dynamic>),
+    ];
+    return WindowListChange(
+      added: windows(map['added']),
+      updated: windows(map['updated']),
+      removed: List<String>.from(map['removed'] as List<dynamic>? ?? const []),
+    );
+  }
+
+  /// 把变化应用到 [windows]，返回新的列表
+  List<WindowInfo> applyTo(List<WindowInfo> windows) {
+    if (reset) return List.of(added);
+    final gone = removed.toSet();
+    final changed = {for (final window in updated) window.id: window};
+    final addedIds = {for (final window in added) window.id};
+    return [
+      ...added,
+      for (final window in windows)
+        if (!gone.contains(window.id) && !addedIds.contains(window.id))
+          changed[window.id] ?? window,
+    ];
+  }
+}
+
+/// 显示器信息模型
+class MonitorInfo {
+  /// 显示器序号（与原生端枚举顺序一致）
+  final int index;
+
+  /// 显示器在虚拟桌面中的区域，副屏坐标可能为负
+  final Rect bounds;
+
+  /// 是否为主屏
+  final bool primary;
+
+  /// 显示器名称（Windows 为设备名，X11 为输出名）
+  final String name;
+
+  MonitorInfo({
+    required this.index,
+    required this.bounds,
+    required this.primary,
+    required this.name,
+  });
+
+  /// 从原生通道返回的 map 创建实例
+  factory MonitorInfo.fromMap(Map<dynamic, dynamic> map) {
+    return MonitorInfo(
+      index: map['index'] as int,
+      bounds: Rect.fromLTWH(
+        (map['x'] as int).toDouble(),
+        (map['y'] as int).toDouble(),
+        (map['width'] as int).toDouble(),
+        (map['height'] as int).toDouble(),
+      ),
+      primary: map['primary'] as bool? ?? false,
+      name: map['name'] as String? ?? '',
+    );
+  }
+}
+
+/// 单个显示器的截图
+class MonitorCapture {
+  final MonitorInfo monitor;
+
+  /// PNG 数据
+  final Uint8List bytes;
+
+  MonitorCapture({required this.monitor, required this.bytes});
+}
+
+/// 批量窗口截图中的一个窗口（窗口选择器的缩略图）
+class WindowCapture {
+  /// 窗口 ID
+  final String id;
+
+  /// 按当前编码设置编码的图像
+  final Uint8List bytes;
+
+  /// 图像尺寸（缩小后）
+  final int width;
+  final int height;
+
+  /// 窗口的原始尺寸
+  final int sourceWidth;
+  final int sourceHeight;
+
+  WindowCapture({
+    required this.id,
+    required this.bytes,
+    required this.width,
+    required this.height,
+    required this.sourceWidth,
+    required this.sourceHeight,
+  });
+
+  /// 从原生通道返回的 map 创建实例
+  factory WindowCapture.fromMap(Map<dynamic, dynamic> map) {
+    return WindowCapture(
+      id: map['id'] as String,
+      bytes: map['bytes'] as Uint8List,
+      width: map['width'] as int,
+      height: map['height'] as int,
+      sourceWidth: map['sourceWidth'] as int,
+      sourceHeight: map['sourceHeight'] as int,
+    );
+  }
+}
+
+/// 整个虚拟桌面的截图（所有显示器拼接）
+class VirtualDesktopCapture {
+  /// PNG 数据，显示器未覆盖的区域为黑色
+  final Uint8List bytes;
+
+  /// 虚拟桌面区域，左上角可能为负
+  final Rect bounds;
+
+  /// 截图时的显示器布局
+  final List<MonitorInfo> monitors;
+
+  VirtualDesktopCapture({
+    required this.bytes,
+    required this.bounds,
+    required this.monitors,
+  });
+}
+
+/// 两阶段截图的请求
+///
+/// 原生端拿到像素就返回帧句柄，编码和保存在后台进行
+class CaptureRequest {
+  /// fullScreen / region / selectedRegion / window
+  final String mode;
+
+  /// region、selectedRegion 的区域（屏幕坐标）
+  final Rect? region;
+
+  /// window 模式的窗口 ID
+  final String? windowId;
+
+  const CaptureRequest.fullScreen()
+      : mode = 'fullScreen',
+        region = null,
+        windowId = null;
+
+  const CaptureRequest.region(Rect this.region)
+      : mode = 'region',
+        windowId = null;
+
+  const CaptureRequest.selectedRegion(Rect this.region)
+      : mode = 'selectedRegion',
+        windowId = null;
+
+  const CaptureRequest.window(String this.windowId)
+      : mode = 'window',
+        region = null;
+
+  /// 转换为原生通道参数
+  Map<String, dynamic> toArguments() {
+    return {
+      'mode': mode,
+      if (region != null) ...{
+        'x': region!.left.toInt(),
+        'y': region!.top.toInt(),
+        'width': region!.width.toInt(),
+        'height': region!.height.toInt(),
+      },
+      if (windowId != null) 'windowId': windowId,
+    };
+  }
+}
+
+/// 原生端的编码参数，随每个截图请求发送
+///
+/// 原生端按 [format] 选择 PNG、JPEG 或 QOI 编码器，[quality] 只对 JPEG 有效
+class EncodeOptions {
+  final ImageFormat format;
+
+  /// JPEG 质量（1-100）
+  final int quality;
+
+  const EncodeOptions({this.format = ImageFormat.png, this.quality = 90});
+
+  /// 从截图设置创建
+  factory EncodeOptions.fromSettings(ScreenshotSettings settings) {
+    return EncodeOptions(
+      format: settings.imageFormat,
+      quality: settings.imageQuality,
+    );
+  }
+
+  /// 转换为原生通道参数
+  Map<String, dynamic> toArguments() {
+    return {'format': format.name, 'quality': quality};
+  }
+}
+
+/// 后台编码的结束状态
+enum EncodeStatus { ok, failed, cancelled }
+
+/// 后台编码结束的结果
+class EncodeCompletion {
+  final int handle;
+  final EncodeStatus status;
+
+  /// 编码后的图片数据（PNG 或 JPEG），仅 [EncodeStatus.ok] 时有
+  final Uint8List? bytes;
+
+  /// 原生端已写入的文件路径（请求了 savePath 且写入成功时才有）
+  final String? path;
+
+  EncodeCompletion({
+    required this.handle,
+    required this.status,
+    this.bytes,
+    this.path,
+  });
+
+  bool get succeeded => status == EncodeStatus.ok && bytes != null;
+
+  /// 从原生通道的 onEncodeComplete 参数创建实例
+  factory EncodeCompletion.fromMap(Map<dynamic, dynamic> map) {
+    final status = switch (map['status'] as String?) {
+      'ok' => EncodeStatus.ok,
+      'cancelled' => EncodeStatus.cancelled,
+      _ => EncodeStatus.failed,
+    };
+    return EncodeCompletion(
+      handle: map['handle'] as int,
+      status: status,
+      bytes: map['bytes'] as Uint8List?,
+      path: map['path'] as String?,
+    );
+  }
+}
+
+/// 循环截图的分块变化检测参数（beginCapture 时传入）
+class ChangeTracking {
+  /// 参考帧的键（循环任务 ID），每个键独立比较
+  final String key;
+
+  /// 变化不大时只编码变化的分块（透明补丁，JPEG 会改为 PNG）
+  final bool tileDelta;
+
+  const ChangeTracking(this.key, {this.tileDelta = false});
+
+  Map<String, dynamic> toArguments() => {
+    'changeKey': key,
+    if (tileDelta) 'tileDelta': true,
+  };
+}
+
+/// 只包含变化分块的补丁在整帧中的位置
+class TilePatch {
+  final int x;
+  final int y;
+  final int width;
+  final int height;
+
+  const TilePatch({
+    required this.x,
+    required this.y,
+    required this.width,
+    required this.height,
+  });
+}
+
+/// 已捕获、正在后台编码的截图
+class PendingCapture {
+  /// 原生端的帧句柄，用于预览和取消
+  final int handle;
+
+  /// 整帧尺寸（[patch] 不为空时编码的只是补丁）
+  final int width;
+  final int height;
+
+  /// 编码（和保存）结束时完成
+  final Future<EncodeCompletion> completion;
+
+  /// 变化检测：画面与参考帧相同时为 false，此时没有帧句柄，也不会编码
+  final bool changed;
+
+  /// 变化检测：这一帧是整帧并成为新的参考帧
+  final bool keyframe;
+
+  /// 变化检测：编码的是变化分块的补丁，贴回最近的整帧即得到这一帧
+  final TilePatch? patch;
+
+  /// 变化检测：变化的分块数 / 总分块数（未请求变化检测时为 0）
+  final int dirtyTiles;
+  final int totalTiles;
+
+  /// 整帧的 64 位感知哈希（dHash），平台不支持时为 null
+  ///
+  /// 用 [hammingDistance] 比较，距离小说明画面看起来几乎一样
+  final int? perceptualHash;
+
+  PendingCapture({
+    required this.handle,
+    required this.width,
+    required this.height,
+    required this.completion,
+    this.changed = true,
+    this.keyframe = false,
+    this.patch,
+    this.dirtyTiles = 0,
+    this.totalTiles = 0,
+    this.perceptualHash,
+  });
+
+  /// 画面没有变化、不会编码的截图
+  PendingCapture.unchanged({
+    required this.width,
+    required this.height,
+    required this.totalTiles,
+    this.perceptualHash,
+  }) : handle = 0,
+       completion = Future.value(
+         EncodeCompletion(handle: 0, status: EncodeStatus.cancelled),
+       ),
+       changed = false,
+       keyframe = false,
+       patch = null,
+       dirtyTiles = 0;
+}
+
+/// 交给原生调度器的循环截图计划（startRecurringSchedule）
+///
+/// 原生端在专用线程上按固定节拍计时，截图、编码和写文件都不经过 Dart，
+/// 每次触发只推送一个 [ScheduledShot]
+class RecurringSchedule {
+  /// 循环任务 ID，同一任务的旧计划会被替换
+  final String taskId;
+
+  final CaptureRequest request;
+  final Duration interval;
+
+  /// 触发次数，null 表示无限
+  final int? totalShots;
+
+  /// 第一次触发距开始的时间，null 表示等于 [interval]
+  final Duration? firstDelay;
+
+  /// 文件写到 [directory] 下的 `<filePrefix><毫秒时间戳>.<扩展名>`
+  final String directory;
+  final String filePrefix;
+
+  final EncodeOptions encodeOptions;
+
+  /// 分块变化检测，null 表示每次都保存
+  final ChangeTracking? changeTracking;
+
+  /// 近似重复过滤的汉明距离阈值，null 表示不过滤
+  final int? dedupDistance;
+
+  const RecurringSchedule({
+    required this.taskId,
+    required this.request,
+    required this.interval,
+    this.totalShots,
+    this.firstDelay,
+    required this.directory,
+    this.filePrefix = '',
+    this.encodeOptions = const EncodeOptions(),
+    this.changeTracking,
+    this.dedupDistance,
+  });
+
+  /// 转换为原生通道参数
+  Map<String, dynamic> toArguments() {
+    return {
+      'taskId': taskId,
+      ...request.toArguments(),
+      ...encodeOptions.toArguments(),
+      'intervalMs': interval.inMilliseconds,
+      if (totalShots != null) 'totalShots': totalShots,
+      if (firstDelay != null) 'firstDelayMs': firstDelay!.inMilliseconds,
+      'directory': directory,
+      'filePrefix': filePrefix,
+      ...?changeTracking?.toArguments(),
+      if (dedupDistance != null) 'dedupDistance': dedupDistance,
+    };
+  }
+}
+
+/// 原生调度的一次触发的结果
+enum ScheduledShotStatus {
+  /// 已写入 [ScheduledShot.path]
+  saved,
+
+  /// 画面与参考帧相同，没有保存
+  unchanged,
+
+  /// 与上一次保存的截图近似重复，没有保存
+  duplicate,
+
+  /// 上一次还没写完或队列已满，这次没有截图
+  skipped,
+
+  /// 截图或写文件失败
+  failed,
+}
+
+/// 原生调度器推送的一次触发（onScheduledShot）
+class ScheduledShot {
+  final String taskId;
+
+  /// 原生计划 ID，用来丢弃已被替换的计划迟到的通知
+  final int scheduleId;
+
+  /// 本次计划中的第几次触发（从 1 开始）
+  final int index;
+
+  /// 调度落后（系统休眠等）时跳过的触发数，已计入 [index]
+  final int missed;
+
+  /// 计划的最后一次触发，之后原生端不再触发
+  final bool last;
+
+  final ScheduledShotStatus status;
+
+  /// 相对计划时间的延迟（被跳过的触发为 0）
+  final Duration lateness;
+
+  /// 截图时间（没有截图时为 null）
+  final DateTime? time;
+
+  /// 已写入的文件（仅 [ScheduledShotStatus.saved]）
+  final String? path;
+
+  final int width;
+  final int height;
+
+  /// 变化检测：这一帧是整帧并成为新的参考帧
+  final bool keyframe;
+
+  /// 变化检测：写入的是变化分块的补丁
+  final TilePatch? patch;
+
+  final int dirtyTiles;
+  final int totalTiles;
+  final int? perceptualHash;
+
+  ScheduledShot({
+    required this.taskId,
+    required this.scheduleId,
+    required this.index,
+    required this.status,
+    this.missed = 0,
+    this.last = false,
+    this.lateness = Duration.zero,
+    this.time,
+    this.path,
+    this.width = 0,
+    this.height = 0,
+    this.keyframe = false,
+    this.patch,
+    this.dirtyTiles = 0,
+    this.totalTiles = 0,
+    this.perceptualHash,
+  });
+
+  /// 从原生通道的 onScheduledShot 参数创建实例
+  factory ScheduledShot.fromMap(Map<dynamic, dynamic> map) {
+    final time = map['time'] as int?;
+    return ScheduledShot(
+      taskId: map['taskId'] as String,
+      scheduleId: map['scheduleId'] as int,
+      index: map['index'] as int,
+      status: ScheduledShotStatus.values.firstWhere(
+        (e) => e.name == map['status'],
+        orElse: () => ScheduledShotStatus.failed,
+      ),
+      missed: map['missed'] as int? ?? 0,
+      last: map['last'] as bool? ?? false,
+      lateness: Duration(microseconds: map['latenessUs'] as int? ?? 0),
+      time: time != null ? DateTime.fromMillisecondsSinceEpoch(time) : null,
+      path: map['path'] as String?,
+      width: map['width'] as int? ?? 0,
+      height: map['height'] as int? ?? 0,
+      keyframe: map['keyframe'] as bool? ?? false,
+      patch: map.containsKey('patchX')
+          ? TilePatch(
+              x: map['patchX'] as int,
+              y: map['patchY'] as int,
+              width: map['patchWidth'] as int,
+              height: map['patchHeight'] as int,
+            )
+          : null,
+      dirtyTiles: map['dirtyTiles'] as int? ?? 0,
+      totalTiles: map['totalTiles'] as int? ?? 0,
+      perceptualHash: map['perceptualHash'] as int?,
+    );
+  }
+}
+
+/// 录屏的输出格式
+enum RecordingFormat {
+  /// 动画 GIF：每帧最多 255 色，兼容性最好
+  gif,
+
+  /// 动画 PNG：无损，体积通常比 GIF 大
+  apng;
+
+  /// 文件扩展名（APNG 沿用 .png，不支持动画的查看器显示第一帧）
+  String get extension => this == RecordingFormat.gif ? 'gif' : 'png';
+}
+
+/// 区域录屏请求
+///
+/// 原生端按 [fps] 的固定节拍采集 [region]（屏幕坐标），边录边写到 [path]，
+/// 内存占用与录制时长无关
+class RecordingRequest {
+  final Rect region;
+
+  /// 目标帧率，原生端限制在 1-50
+  final int fps;
+
+  final RecordingFormat format;
+  final String path;
+
+  const RecordingRequest({
+    required this.region,
+    this.fps = 10,
+    this.format = RecordingFormat.gif,
+    required this.path,
+  });
+
+  /// 转换为原生通道参数
+  Map<String, dynamic> toArguments() {
+    return {
+      'x': region.left.toInt(),
+      'y': region.top.toInt(),
+      'width': region.width.toInt(),
+      'height': region.height.toInt(),
+      'fps': fps,
+      'format': format.name,
+      'path': path,
+    };
+  }
+}
+
+/// 一段录屏的结果
+class RecordingResult {
+  final String path;
+  final RecordingFormat format;
+
+  /// 写入文件的帧数；与上一帧完全相同的帧合并进上一帧（[mergedFrames]）
+  final int frames;
+  final int mergedFrames;
+
+  /// 编码跟不上而丢掉的帧数
+  final int droppedFrames;
+
+  final Duration duration;
+  final int fileSize;
+
+  const RecordingResult({
+    required this.path,
+    required this.format,
+    required this.frames,
+    this.mergedFrames = 0,
+    this.droppedFrames = 0,
+    required this.duration,
+    required this.fileSize,
+  });
+
+  /// 从原生通道 stopRecording 的回复创建实例
+  factory RecordingResult.fromMap(
+    String path,
+    RecordingFormat format,
+    Map<dynamic, dynamic> map,
+  ) {
+    return RecordingResult(
+      path: path,
+      format: format,
+      frames: map['frames'] as int? ?? 0,
+      mergedFrames: map['merged'] as int? ?? 0,
+      droppedFrames: map['dropped'] as int? ?? 0,
+      duration: Duration(milliseconds: map['durationMs'] as int? ?? 0),
+      fileSize: map['bytes'] as int? ?? 0,
+    );
+  }
+}
+
+/// 即时回放请求
+///
+/// 原生端按 [fps] 持续采集 [region]（通常是一个显示器），压缩后只在内存中保留最近
+/// [duration] 的画面，压缩帧不超过 [memoryLimitMb]。saveReplay 热键按下时由原生端
+/// 直接把回放以 [format] 写到 [directory]
+class InstantReplayRequest {
+  final Rect region;
+
+  /// 采集帧率，原生端限制在 1-10
+  final int fps;
+
+  /// 保留的时长，原生端限制在 1-600 秒
+  final Duration duration;
+
+  /// 压缩帧的内存上限（MB），原生端限制在 8-2048
+  final int memoryLimitMb;
+
+  final RecordingFormat format;
+  final String directory;
+
+  const InstantReplayRequest({
+    required this.region,
+    this.fps = 2,
+    this.duration = const Duration(seconds: 30),
+    this.memoryLimitMb = 64,
+    this.format = RecordingFormat.apng,
+    required this.directory,
+  });
+
+  /// 转换为原生通道参数
+  Map<String, dynamic> toArguments() {
+    return {
+      'x': region.left.toInt(),
+      'y': region.top.toInt(),
+      'width': region.width.toInt(),
+      'height': region.height.toInt(),
+      'fps': fps,
+      'seconds': duration.inSeconds,
+      'memoryLimitMb': memoryLimitMb,
+      'format': format.name,
+      'directory': directory,
+    };
+  }
+}
+
+/// 即时回放的运行开销，用来确认它可以整天开着
+class InstantReplayStats {
+  /// 采集到的帧和采集失败的次数
+  final int capturedFrames;
+  final int failedCaptures;
+
+  /// 与上一帧相同、没有存储的帧；因超出时长或内存上限丢掉的帧
+  final int unchangedFrames;
+  final int evictedFrames;
+
+  /// 缓冲中的帧（其中关键帧的个数）和覆盖的时长
+  final int bufferedFrames;
+  final int keyframes;
+  final Duration span;
+
+  /// 压缩帧占用的字节数及其峰值；未压缩的工作缓冲
+  final int bufferBytes;
+  final int peakBufferBytes;
+  final int workingBytes;
+
+  /// 运行时长、采集和压缩花费的时间、采集线程消耗的 CPU 时间
+  final Duration uptime;
+  final Duration captureTime;
+  final Duration encodeTime;
+  final Duration cpuTime;
+
+  const InstantReplayStats({
+    required this.capturedFrames,
+    this.failedCaptures = 0,
+    this.unchangedFrames = 0,
+    this.evictedFrames = 0,
+    required this.bufferedFrames,
+    this.keyframes = 0,
+    this.span = Duration.zero,
+    required this.bufferBytes,
+    this.peakBufferBytes = 0,
+    this.workingBytes = 0,
+    required this.uptime,
+    this.captureTime = Duration.zero,
+    this.encodeTime = Duration.zero,
+    this.cpuTime = Duration.zero,
+  });
+
+  /// 采集线程平均占用一个 CPU 核心的百分比
+  double get cpuPercent => uptime == Duration.zero
+      ? 0
+      : cpuTime.inMicroseconds * 100 / uptime.inMicroseconds;
+
+  /// 全部内存占用：压缩帧加工作缓冲
+  int get memoryBytes => bufferBytes + workingBytes;
+
+  /// 从原生通道 getInstantReplayStats 的回复创建实例
+  factory InstantReplayStats.fromMap(Map<dynamic, dynamic> map) {
+    return InstantReplayStats(
+      capturedFrames: map['captured'] as int? ?? 0,
+      failedCaptures: map['failedCaptures'] as int? ?? 0,
+      unchangedFrames: map['unchanged'] as int? ?? 0,
+      evictedFrames: map['evicted'] as int? ?? 0,
+      bufferedFrames: map['frames'] as int? ?? 0,
+      keyframes: map['keyframes'] as int? ?? 0,
+      span: Duration(milliseconds: map['spanMs'] as int? ?? 0),
+      bufferBytes: map['bytes'] as int? ?? 0,
+      peakBufferBytes: map['peakBytes'] as int? ?? 0,
+      workingBytes: map['workingBytes'] as int? ?? 0,
+      uptime: Duration(milliseconds: map['uptimeMs'] as int? ?? 0),
+      captureTime: Duration(microseconds: map['captureUs'] as int? ?? 0),
+      encodeTime: Duration(microseconds: map['encodeUs'] as int? ?? 0),
+      cpuTime: Duration(microseconds: map['cpuUs'] as int? ?? 0),
+    );
+  }
+}
+
+/// 长截图请求
+///
+/// 原生端在 [target]（区域或窗口，不支持 selectedRegion 的冻结画面）中反复截图、
+/// 发送 [wheelSteps] 格鼠标滚轮并拼接，直到页面到底、找不到重叠或达到上限，
+/// 结果以 PNG 逐段写入 [path]
+class ScrollCaptureRequest {
+  final CaptureRequest target;
+  final String path;
+
+  /// 每次滚动的滚轮格数，需要小于一屏，原生端限制在 1-20
+  final int wheelSteps;
+
+  /// 最多截取的帧数和输出的最大高度（像素）
+  final int maxFrames;
+  final int maxHeight;
+
+  /// 每次滚动后等待页面重绘的时间
+  final Duration settle;
+
+  const ScrollCaptureRequest({
+    required this.target,
+    required this.path,
+    this.wheelSteps = 5,
+    this.maxFrames = 100,
+    this.maxHeight = 30000,
+    this.settle = const Duration(milliseconds: 120),
+  });
+
+  /// 转换为原生通道参数
+  Map<String, dynamic> toArguments() {
+    return {
+      ...target.toArguments(),
+      'path': path,
+      'wheelSteps': wheelSteps,
+      'maxFrames': maxFrames,
+      'maxHeight': maxHeight,
+      'settleMs': settle.inMilliseconds,
+    };
+  }
+}
+
+/// 长截图的结果
+class ScrollCaptureResult {
+  final String path;
+  final int width;
+  final int height;
+
+  /// 截取的帧数（包括没有变化和找不到重叠的帧）
+  final int frames;
+  final int fileSize;
+
+  const ScrollCaptureResult({
+    required this.path,
+    required this.width,
+    required this.height,
+    required this.frames,
+    required this.fileSize,
+  });
+
+  /// 从原生通道 captureScrolling 的回复创建实例
+  factory ScrollCaptureResult.fromMap(String path, Map<dynamic, dynamic> map) {
+    return ScrollCaptureResult(
+      path: map['path'] as String? ?? path,
+      width: map['width'] as int? ?? 0,
+      height: map['height'] as int? ?? 0,
+      frames: map['frames'] as int? ?? 0,
+      fileSize: map['bytes'] as int? ?? 0,
+    );
+  }
+}
+
+/// 编码完成前的原始帧预览（RGBA，可能已缩小）
+class FramePreview {
+  final int width;
+  final int height;
+
+  /// RGBA 像素，紧凑排列
+  final Uint8List pixels;
+
+  FramePreview({
+    required this.width,
+    required this.height,
+    required this.pixels,
+  });
+}
+
+/// 注册为原生外部纹理的截图帧，用 Texture(textureId: ...) 显示
+///
+/// 纹理持有自己的 RGBA 像素，不再需要时调用 disposeFrameTexture 释放
+class FrameTexture {
+  final int textureId;
+  final int width;
+  final int height;
+
+  FrameTexture({
+    required this.textureId,
+    required this.width,
+    required this.height,
+  });
+}
+
 /// 矩形区域类
 class Rect {
   final double left;
@@ -1,6 +1,7 @@
 library;
 
 import '../../../core/models/base_plugin_settings.dart';
+import 'screenshot_models.dart' show RecordingFormat;
 
 /// 剪贴板内容类型
 enum ClipboardContentType {
@@ -73,6 +74,9 @@ class ScreenshotSettings extends BasePluginSettings {
   /// 钉图设置
   final PinSettings pinSettings;
 
+  /// 即时回放设置
+  final InstantReplaySettings instantReplay;
+
   ScreenshotSettings({
     this.version = '1.0.0',
     required this.savePath,
@@ -86,6 +90,7 @@ class ScreenshotSettings extends BasePluginSettings {
     this.historyRetentionPeriod = const Duration(days: 30),
     required this.shortcuts,
     required this.pinSettings,
+    this.instantReplay = const InstantReplaySettings(),
   });
 
   /// 默认设置
@@ -97,6 +102,7 @@ class ScreenshotSettings extends BasePluginSettings {
       shortcuts: {
         'regionCapture': 'Ctrl+Shift+A',
         'fullScreenCapture': 'Ctrl+Shift+F',
+        'saveReplay': 'Ctrl+Shift+R',
       },
       pinSettings: const PinSettings(),
     );
@@ -105,7 +111,7 @@ class ScreenshotSettings extends BasePluginSettings {
   /// 从 JSON 创建实例
   factory ScreenshotSettings.fromJson(Map<String, dynamic> json) {
     // 过滤快捷键，只保留允许的快捷键
-    final allowedShortcuts = {'regionCapture', 'fullScreenCapture'};
+    final allowedShortcuts = {'regionCapture', 'fullScreenCapture', 'saveReplay'};
     final savedShortcuts = Map<String, String>.from(json['shortcuts'] as Map? ?? {});
     final filteredShortcuts = Map.fromEntries(
       savedShortcuts.entries.where((entry) => allowedShortcuts.contains(entry.key)),
@@ -117,7 +123,7 @@ class ScreenshotSettings extends BasePluginSettings {
       filenameFormat:
           json['filenameFormat'] as String? ?? 'screenshot_{timestamp}',
       imageFormat: ImageFormat.values.firstWhere(
-        (e) => e.name == json['imageFormat'] as String?,
+        (e) => e != ImageFormat.qoi && e.name == json['imageFormat'] as String?,
         orElse: () => ImageFormat.png,
       ),
       imageQuality: json['imageQuality'] as int? ?? 95,
@@ -137,6 +143,11 @@ class ScreenshotSettings extends BasePluginSettings {
       pinSettings: json['pinSettings'] != null
           ? PinSettings.fromJson(json['pinSettings'] as Map<String, dynamic>)
           : const PinSettings(),
+      instantReplay: json['instantReplay'] != null
+          ? InstantReplaySettings.fromJson(
+              json['instantReplay'] as Map<String, dynamic>,
+            )
+          : const InstantReplaySettings(),
     );
   }
 
@@ -156,6 +167,7 @@ class ScreenshotSettings extends BasePluginSettings {
       'historyRetentionDays': historyRetentionPeriod.inDays,
       'shortcuts': shortcuts,
       'pinSettings': pinSettings.toJson(),
+      'instantReplay': instantReplay.toJson(),
     };
   }
 
@@ -174,6 +186,7 @@ class ScreenshotSettings extends BasePluginSettings {
     Duration? historyRetentionPeriod,
     Map<String, String>? shortcuts,
     PinSettings? pinSettings,
+    InstantReplaySettings? instantReplay,
   }) {
     return ScreenshotSettings(
       version: version ?? this.version,
@@ -189,6 +202,7 @@ class ScreenshotSettings extends BasePluginSettings {
           historyRetentionPeriod ?? this.historyRetentionPeriod,
       shortcuts: shortcuts ?? this.shortcuts,
       pinSettings: pinSettings ?? this.pinSettings,
+      instantReplay: instantReplay ?? this.instantReplay,
     );
   }
 
@@ -267,8 +281,81 @@ class PinSettings {
   }
 }
 
+/// 即时回放设置
+///
+/// 开启后后台按 [fps] 持续采集主显示器，只在内存中保留最近 [seconds] 秒，
+/// 按 saveReplay 快捷键把这段画面保存成动画
+class InstantReplaySettings {
+  /// 是否开启
+  final bool enabled;
+
+  /// 保留的秒数（1-600）
+  final int seconds;
+
+  /// 采集帧率（1-10）
+  final int fps;
+
+  /// 压缩帧的内存上限（MB，8-2048）
+  final int memoryLimitMb;
+
+  /// 保存格式
+  final RecordingFormat format;
+
+  const InstantReplaySettings({
+    this.enabled = false,
+    this.seconds = 30,
+    this.fps = 2,
+    this.memoryLimitMb = 64,
+    this.format = RecordingFormat.apng,
+  });
+
+  /// 从 JSON 创建实例
+  factory InstantReplaySettings.fromJson(Map<String, dynamic> json) {
+    return InstantReplaySettings(
+      enabled: json['enabled'] as bool? ?? false,
+      seconds: (json['seconds'] as int? ?? 30).clamp(1, 600),
+      fps: (json['fps'] as int? ?? 2).clamp(1, 10),
+      memoryLimitMb: (json['memoryLimitMb'] as int? ?? 64).clamp(8, 2048),
+      format: json['format'] == 'gif'
+          ? RecordingFormat.gif
+          : RecordingFormat.apng,
+    );
+  }
+
+  /// 转换为 JSON
+  Map<String, dynamic> toJson() {
+    return {
+      'enabled': enabled,
+      'seconds': seconds,
+      'fps': fps,
+      'memoryLimitMb': memoryLimitMb,
+      'format': format.name,
+    };
+  }
+
+  /// 复制并修改部分设置
+  InstantReplaySettings copyWith({
+    bool? enabled,
+    int? seconds,
+    int? fps,
+    int? memoryLimitMb,
+    RecordingFormat? format,
+  }) {
+    return InstantReplaySettings(
+      enabled: enabled ?? this.enabled,
+      seconds: seconds ?? this.seconds,
+      fps: fps ?? this.fps,
+      memoryLimitMb: memoryLimitMb ?? this.memoryLimitMb,
+      format: format ?? this.format,
+    );
+  }
+}
+
 /// 图片格式枚举
-enum ImageFormat { png, jpeg }
+///
+/// [qoi] 只用于高频循环截图的快速落盘，空闲时由原生端转成 PNG，
+/// 不在设置中提供给用户选择
+enum ImageFormat { png, jpeg, qoi }
 
 /// 图片格式扩展
 extension ImageFormatExtension on ImageFormat {
@@ -279,6 +366,8 @@ extension ImageFormatExtension on ImageFormat {
         return 'png';
       case ImageFormat.jpeg:
         return 'jpg';
+      case ImageFormat.qoi:
+        return 'qoi';
     }
   }
 
@@ -289,6 +378,8 @@ extension ImageFormatExtension on ImageFormat {
         return 'image/png';
       case ImageFormat.jpeg:
         return 'image/jpeg';
+      case ImageFormat.qoi:
+        return 'image/qoi';
     }
   }
 }
@@ -1,5 +1,6 @@
 library;
 
+import 'dart:async';
 import 'dart:io';
 import 'package:flutter/foundation.dart';
 import 'package:flutter/services.dart';
@@ -37,6 +38,348 @@ class RegionSelectedEvent {
   );
 }
 
+/// 原生端推送的 onEncodeComplete 分发给对应的 [PendingCapture]
+///
+/// Windows 和 Linux 共用截图通道。编码很快时完成通知可能先于
+/// beginCapture 的回复到达，这种通知先暂存，等句柄注册后再交付。
+/// onTranscodeComplete 按源文件路径分发给 [transcodeWhenIdle] 的调用方，
+/// onScheduledShot 按任务 ID 分发给 [startRecurringSchedule] 的回调，
+/// onReplaySaved（热键触发的即时回放保存）交给 [startInstantReplay] 的回调，
+/// onWindowsChanged 交给 [watchWindows] 的订阅者。
+class _EncodeCompletionRouter {
+  _EncodeCompletionRouter._(this._channel) {
+    _channel.setMethodCallHandler(_handleCall);
+  }
+
+  static _EncodeCompletionRouter? _instance;
+
+  static _EncodeCompletionRouter of(MethodChannel channel) {
+    return _instance ??= _EncodeCompletionRouter._(channel);
+  }
+
+  final MethodChannel _channel;
+  final Map<int, Completer<EncodeCompletion>> _waiting = {};
+  final Map<int, EncodeCompletion> _early = {};
+  final Map<String, Completer<bool>> _transcodes = {};
+  final Map<String, _ScheduleListener> _schedules = {};
+  void Function(RecordingResult? result)? _replaySaved;
+  StreamController<WindowListChange>? _windowChanges;
+
+  /// startWindowTracking 回复前到达的变化，初始列表交付后再补上
+  List<WindowListChange>? _earlyWindowChanges;
+
+  Future<dynamic> _handleCall(MethodCall call) async {
+    if (call.method == 'onWindowsChanged') {
+      final change = WindowListChange.fromMap(
+        call.arguments as Map<dynamic, dynamic>,
+      );
+      final early = _earlyWindowChanges;
+      if (early != null) {
+        early.add(change);
+      } else {
+        _windowChanges?.add(change);
+      }
+      return null;
+    }
+    if (call.method == 'onReplaySaved') {
+      final args = call.arguments as Map<dynamic, dynamic>;
+      _replaySaved?.call(args['ok'] == true ? replayResult(args) : null);
+      return null;
+    }
+    if (call.method == 'onScheduledShot') {
+      _deliverShot(
+        ScheduledShot.fromMap(call.arguments as Map<dynamic, dynamic>),
+      );
+      return null;
+    }
+    if (call.method == 'onTranscodeComplete') {
+      final args = call.arguments as Map<dynamic, dynamic>;
+      _transcodes
+          .remove(args['source'] as String)
+          ?.complete(args['status'] == 'ok');
+      return null;
+    }
+    if (call.method != 'onEncodeComplete') return null;
+    final completion = EncodeCompletion.fromMap(
+      call.arguments as Map<dynamic, dynamic>,
+    );
+    final completer = _waiting.remove(completion.handle);
+    if (completer != null) {
+      completer.complete(completion);
+    } else {
+      _early[completion.handle] = completion;
+    }
+    return null;
+  }
+
+  /// 调用原生 beginCapture，返回 null 表示捕获失败或不支持
+  Future<PendingCapture?> begin(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions encodeOptions = const EncodeOptions(),
+    ChangeTracking? changeTracking,
+  }) async {
+    final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+      'beginCapture',
+      {
+        ...request.toArguments(),
+        ...encodeOptions.toArguments(),
+        if (savePath != null) 'savePath': savePath,
+        if (deferEncode) 'deferEncode': true,
+        ...?changeTracking?.toArguments(),
+      },
+    );
+    if (result == null) return null;
+
+    if (result['changed'] == false) {
+      return PendingCapture.unchanged(
+        width: result['width'] as int,
+        height: result['height'] as int,
+        totalTiles: result['totalTiles'] as int? ?? 0,
+        perceptualHash: result['perceptualHash'] as int?,
+      );
+    }
+    final handle = result['handle'] as int;
+    final early = _early.remove(handle);
+    final Future<EncodeCompletion> completion;
+    if (early != null) {
+      completion = Future.value(early);
+    } else {
+      final completer = Completer<EncodeCompletion>();
+      _waiting[handle] = completer;
+      completion = completer.future;
+    }
+    return PendingCapture(
+      handle: handle,
+      width: result['width'] as int,
+      height: result['height'] as int,
+      completion: completion,
+      keyframe: result['keyframe'] as bool? ?? false,
+      patch: result.containsKey('patchX')
+          ? TilePatch(
+              x: result['patchX'] as int,
+              y: result['patchY'] as int,
+              width: result['patchWidth'] as int,
+              height: result['patchHeight'] as int,
+            )
+          : null,
+      dirtyTiles: result['dirtyTiles'] as int? ?? 0,
+      totalTiles: result['totalTiles'] as int? ?? 0,
+      perceptualHash: result['perceptualHash'] as int?,
+    );
+  }
+
+  /// 调用原生 transcodeWhenIdle，转码结束（或排队失败）时完成
+  Future<bool> transcode(String source, String target) async {
+    // 先登记再调用：通知按源文件路径匹配，不依赖回复的先后
+    final completer = Completer<bool>();
+    _transcodes[source] = completer;
+    try {
+      final queued = await _channel.invokeMethod<bool>('transcodeWhenIdle', {
+            'source': source,
+            'target': target,
+          }) ??
+          false;
+      if (!queued) {
+        _transcodes.remove(source)?.complete(false);
+      }
+    } catch (e) {
+      _transcodes.remove(source)?.complete(false);
+      rethrow;
+    }
+    return completer.future;
+  }
+
+  void _deliverShot(ScheduledShot shot) {
+    final listener = _schedules[shot.taskId];
+    if (listener == null) return;
+    final scheduleId = listener.scheduleId;
+    if (scheduleId == null) {
+      // startSchedule 还没回复：可能是这次的，也可能是被替换的计划迟到的
+      listener.early.add(shot);
+      return;
+    }
+    if (shot.scheduleId != scheduleId) return;
+    if (shot.last) _schedules.remove(shot.taskId);
+    listener.onShot(shot);
+  }
+
+  /// 原生端即时回放保存的回复（含 path 和 format）
+  static RecordingResult replayResult(Map<dynamic, dynamic> map) {
+    return RecordingResult.fromMap(
+      map['path'] as String,
+      map['format'] == 'gif' ? RecordingFormat.gif : RecordingFormat.apng,
+      map,
+    );
+  }
+
+  /// 调用原生 startInstantReplay，热键保存的结果交给 [onHotkeySave]
+  Future<bool> startReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  ) async {
+    final started = await _channel.invokeMethod<bool>(
+          'startInstantReplay',
+          request.toArguments(),
+        ) ??
+        false;
+    _replaySaved = started ? onHotkeySave : null;
+    return started;
+  }
+
+  Future<void> stopReplay() async {
+    _replaySaved = null;
+    await _channel.invokeMethod<bool>('stopInstantReplay');
+  }
+
+  /// 订阅时调用原生 startWindowTracking，先发出完整列表（[WindowListChange.reset]），
+  /// 之后是原生端推送的变化；取消订阅时调用 stopWindowTracking。
+  /// 原生端只有一个跟踪器，新的订阅接替之前的订阅
+  Stream<WindowListChange> watchWindows() {
+    late final StreamController<WindowListChange> controller;
+    controller = StreamController<WindowListChange>(
+      onListen: () async {
+        _windowChanges?.close();
+        _windowChanges = controller;
+        _earlyWindowChanges = [];
+        try {
+          final result = await _channel.invokeMethod<List<dynamic>>(
+            'startWindowTracking',
+          );
+          if (!identical(_windowChanges, controller)) return;
+          controller.add(
+            WindowListChange(
+              reset: true,
+              added: [
+                for (final window in result ?? const [])
+                  WindowInfo.fromMap(window as Map<dynamic, dynamic>),
+              ],
+            ),
+          );
+          final early = _earlyWindowChanges ?? const [];
+          _earlyWindowChanges = null;
+          early.forEach(controller.add);
+        } catch (e) {
+          if (!identical(_windowChanges, controller)) return;
+          _earlyWindowChanges = null;
+          controller.addError(e);
+        }
+      },
+      onCancel: () async {
+        if (!identical(_windowChanges, controller)) return;
+        _windowChanges = null;
+        _earlyWindowChanges = null;
+        await _channel.invokeMethod<void>('stopWindowTracking');
+      },
+    );
+    return controller.stream;
+  }
+
+  /// 调用原生 startSchedule，计划开始后返回 true
+  Future<bool> startSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  ) async {
+    // 先登记再调用：第一次触发可能早于回复
+    final listener = _ScheduleListener(onShot);
+    _schedules[schedule.taskId] = listener;
+    int? scheduleId;
+    try {
+      scheduleId = await _channel.invokeMethod<int>(
+        'startSchedule',
+        schedule.toArguments(),
+      );
+    } finally {
+      if (scheduleId == null &&
+          identical(_schedules[schedule.taskId], listener)) {
+        _schedules.remove(schedule.taskId);
+      }
+    }
+    if (scheduleId == null) return false;
+    // 等待回复期间已被停止或替换
+    if (!identical(_schedules[schedule.taskId], listener)) return true;
+    listener.scheduleId = scheduleId;
+    final early = List.of(listener.early);
+    listener.early.clear();
+    for (final shot in early) {
+      _deliverShot(shot);
+    }
+    return true;
+  }
+
+  Future<void> stopSchedule(String taskId) async {
+    _schedules.remove(taskId);
+    await _channel.invokeMethod<bool>('stopSchedule', {'taskId': taskId});
+  }
+
+  Future<void> resetChangeDetection(String key) async {
+    await _channel.invokeMethod<void>('resetChangeDetection', {
+      'changeKey': key,
+    });
+  }
+
+  Future<FramePreview?> preview(int handle, int? maxDimension) async {
+    final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+      'getFramePreview',
+      {'handle': handle, if (maxDimension != null) 'maxDimension': maxDimension},
+    );
+    if (result == null) return null;
+    return FramePreview(
+      width: result['width'] as int,
+      height: result['height'] as int,
+      pixels: result['pixels'] as Uint8List,
+    );
+  }
+
+  Future<bool> cancel(int handle) async {
+    return await _channel.invokeMethod<bool>('cancelEncode', {
+          'handle': handle,
+        }) ??
+        false;
+  }
+
+  Future<bool> encode(int handle) async {
+    return await _channel.invokeMethod<bool>('encodeFrame', {
+          'handle': handle,
+        }) ??
+        false;
+  }
+
+  Future<FrameTexture?> createTexture(int handle, int? maxDimension) async {
+    final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+      'createFrameTexture',
+      {'handle': handle, if (maxDimension != null) 'maxDimension': maxDimension},
+    );
+    if (result == null) return null;
+    return FrameTexture(
+      textureId: result['textureId'] as int,
+      width: result['width'] as int,
+      height: result['height'] as int,
+    );
+  }
+
+  Future<bool> disposeTexture(int textureId) async {
+    return await _channel.invokeMethod<bool>('disposeFrameTexture', {
+          'textureId': textureId,
+        }) ??
+        false;
+  }
+}
+
+/// [_EncodeCompletionRouter] 为一个循环任务登记的回调
+class _ScheduleListener {
+  _ScheduleListener(this.onShot);
+
+  final void Function(ScheduledShot shot) onShot;
+
+  /// startSchedule 回复的计划 ID，回复前为 null
+  int? scheduleId;
+
+  /// 回复前到达的通知
+  final List<ScheduledShot> early = [];
+}
+
 /// 截图平台接口抽象
 ///
 /// 定义了跨平台截图功能的统一接口
@@ -57,7 +400,7 @@ abstract class ScreenshotPlatformInterface {
     } else if (Platform.isMacOS) {
       return const MacOSScreenshotService();
     } else if (Platform.isLinux) {
-      return const LinuxScreenshotService();
+      return LinuxScreenshotService();
     } else {
       return const FallbackScreenshotService();
     }
@@ -66,9 +409,12 @@ abstract class ScreenshotPlatformInterface {
   /// 检查服务是否可用
   bool get isAvailable;
 
+  /// 设置原生端的编码格式和 JPEG 质量，之后的截图方法（包括 [beginCapture]）都按此编码
+  void updateEncodeOptions(EncodeOptions options);
+
   /// 捕获全屏截图
   ///
-  /// 返回截图的字节数据，如果失败则返回 null
+  /// 返回截图的字节数据（按 [updateEncodeOptions] 设置的格式编码），如果失败则返回 null
   Future<Uint8List?> captureFullScreen();
 
   /// 捕获指定区域截图
@@ -77,22 +423,60 @@ abstract class ScreenshotPlatformInterface {
   /// 返回截图的字节数据，如果失败则返回 null
   Future<Uint8List?> captureRegion(Rect rect);
 
+  /// 捕获原生区域选择窗口刚确认的区域
+  ///
+  /// 优先从选择窗口显示时冻结的画面裁剪，不会截到正在关闭的蒙版；
+  /// 冻结画面已超时或不可用时退回 [captureRegion]
+  /// [rect] 为 [getRegionSelectionResult] 返回的区域
+  Future<Uint8List?> captureSelectedRegion(Rect rect);
+
   /// 捕获指定窗口截图
   ///
   /// [windowId] 窗口 ID
   /// 返回截图的字节数据，如果失败则返回 null
   Future<Uint8List?> captureWindow(String windowId);
 
+  /// 一次调用捕获多个窗口
+  ///
+  /// 各窗口在原生端并行截取；[maxSize] 大于 0 时长边缩小到该尺寸作为缩略图。
+  /// 返回以窗口 ID 为键的结果，截取失败的窗口不在其中
+  Future<Map<String, WindowCapture>> captureWindows(
+    List<String> windowIds, {
+    int? maxSize,
+  });
+
   /// 获取所有可用窗口列表
   ///
   /// 返回窗口信息列表，如果平台不支持则返回空列表
   Future<List<WindowInfo>> getAvailableWindows();
 
+  /// 实时窗口列表
+  ///
+  /// 第一个事件是完整列表（[WindowListChange.reset]），之后原生端监听窗口事件，
+  /// 只推送新增、变化和消失的窗口，不再重新枚举。取消订阅时停止监听。
+  /// 平台不支持时为空流
+  Stream<WindowListChange> watchWindows();
+
   /// 获取主屏幕尺寸
   ///
   /// 返回主屏幕的矩形区域
   Future<Rect?> getPrimaryScreenSize();
 
+  /// 获取所有显示器
+  ///
+  /// 返回显示器列表，如果平台不支持则返回空列表
+  Future<List<MonitorInfo>> getMonitors();
+
+  /// 捕获整个虚拟桌面（所有显示器拼接成一张图）
+  ///
+  /// 各显示器在原生端并行截取；失败时返回 null
+  Future<VirtualDesktopCapture?> captureVirtualDesktop();
+
+  /// 分别捕获每个显示器
+  ///
+  /// 顺序与 [getMonitors] 相同；失败时返回空列表
+  Future<List<MonitorCapture>> captureMonitors();
+
   /// 显示原生区域截图窗口（桌面级）
   ///
   /// 返回 true 如果成功显示窗口
@@ -103,6 +487,102 @@ abstract class ScreenshotPlatformInterface {
   /// 返回 null 如果还未完成，返回 RegionSelectedEvent 如果已选择，
   /// 返回 null 的单次调用表示用户取消
   Future<RegionSelectedEvent?> getRegionSelectionResult();
+
+  /// 两阶段截图：像素进入内存后立即返回帧句柄和尺寸
+  ///
+  /// 编码（以及 [savePath] 不为空时的保存）在原生端后台进行，
+  /// 结束时 [PendingCapture.completion] 完成，UI 不必等待 PNG / JPEG 编码。
+  /// [deferEncode] 为 true 时帧先暂存不编码，直到 [encodeFrame]（保存）
+  /// 或 [cancelEncode]（放弃），预览用 [createFrameTexture]。
+  /// [encodeOptions] 只对本次截图生效，覆盖 [updateEncodeOptions] 的设置。
+  /// [changeTracking] 不为空时和同一键上一次保存的整帧按分块比较：
+  /// 未变化时返回 [PendingCapture.changed] 为 false 的结果，不编码也不保存；
+  /// 请求了分块增量且变化不大时只编码补丁（见 [PendingCapture.patch]）。
+  /// 平台不支持或捕获失败时返回 null，调用方应退回一次性的 capture 方法
+  Future<PendingCapture?> beginCapture(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions? encodeOptions,
+    ChangeTracking? changeTracking,
+  });
+
+  /// 获取编码完成前的原始帧预览
+  ///
+  /// [maxDimension] 为预览长边上限（原生端默认 1024）；帧已编码完时返回 null
+  Future<FramePreview?> getFramePreview(int handle, {int? maxDimension});
+
+  /// 取消帧的后台编码，对应的 completion 以 [EncodeStatus.cancelled] 完成
+  Future<bool> cancelEncode(int handle);
+
+  /// 开始编码 deferEncode 暂存的帧；帧不存在或已在编码时返回 false
+  Future<bool> encodeFrame(int handle);
+
+  /// 把编码完成前的原始帧注册为原生外部纹理
+  ///
+  /// 预览直接读原生内存，不经过 PNG 编码和解码。[maxDimension] 为纹理长边上限
+  /// （默认原尺寸）；帧已编码完或平台不支持时返回 null
+  Future<FrameTexture?> createFrameTexture(int handle, {int? maxDimension});
+
+  /// 释放 [createFrameTexture] 注册的纹理
+  Future<bool> disposeFrameTexture(int textureId);
+
+  /// 在原生端截图空闲时把 QOI 文件 [source] 转成 PNG 文件 [target]
+  ///
+  /// 转码在单独的后台线程上进行，有截图请求时推迟。成功后 [source] 被删除，
+  /// 返回 true；失败、平台不支持或应用退出前未转完时返回 false，[source] 保留
+  Future<bool> transcodeWhenIdle(String source, String target);
+
+  /// 丢弃 [key] 的变化检测参考帧（循环任务删除时），下一次截图保存整帧
+  Future<void> resetChangeDetection(String key);
+
+  /// 在原生端按固定节拍执行循环截图
+  ///
+  /// 计时、截图、编码和写文件都在原生线程上完成，每次触发调用一次 [onShot]
+  /// （在平台线程上）。同一任务已有计划时替换它。平台不支持或参数不被支持
+  /// 时返回 false，调用方改用 Dart 定时器
+  Future<bool> startRecurringSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  );
+
+  /// 停止 [taskId] 的原生计划，排队中的那次截图被取消
+  Future<void> stopRecurringSchedule(String taskId);
+
+  /// 开始区域录屏，同一时间只能有一段；平台不支持或无法创建文件时返回 false
+  Future<bool> startRecording(RecordingRequest request);
+
+  /// 停止录屏并写完文件；没有在录屏或写入失败（文件已删除）时返回 null
+  Future<RecordingResult?> stopRecording(RecordingRequest request);
+
+  /// 开始即时回放，已在运行时按新参数重新开始；平台不支持时返回 false
+  ///
+  /// 运行期间 saveReplay 热键由原生端直接保存（不经过 Dart），
+  /// 保存结果交给 [onHotkeySave]（失败时为 null）
+  Future<bool> startInstantReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  );
+
+  /// 停止即时回放并释放缓冲
+  Future<void> stopInstantReplay();
+
+  /// 把最近的画面写到 [path]（缺省时写到开始时指定的目录）；
+  /// 没有在运行、还没有画面或写入失败时返回 null
+  Future<RecordingResult?> saveInstantReplay({String? path});
+
+  /// 即时回放的运行开销；没有在运行时返回 null
+  Future<InstantReplayStats?> getInstantReplayStats();
+
+  /// 长截图：滚动并拼接，写完文件后返回；平台不支持或失败时返回 null
+  Future<ScrollCaptureResult?> captureScrolling(ScrollCaptureRequest request);
+
+  /// 取消排队中的截图请求
+  ///
+  /// 被取消的请求以 `CANCELLED` 错误结束（对应的截图方法返回 null）。
+  /// 原生端同时只排队少量请求，队列满时新请求以 `BUSY` 错误结束。
+  /// 返回受影响的请求数
+  Future<int> cancelPendingCaptures();
 }
 
 /// Windows 平台截图服务实现
@@ -113,18 +593,25 @@ class WindowsScreenshotService implements ScreenshotPlatformInterface {
 
   WindowsScreenshotService();
 
+  /// 随每个截图请求发送的编码参数
+  EncodeOptions _encodeOptions = const EncodeOptions();
+
+  @override
+  void updateEncodeOptions(EncodeOptions options) {
+    _encodeOptions = options;
+  }
+
   @override
   bool get isAvailable => Platform.isWindows;
 
   @override
   Future<Uint8List?> captureFullScreen() async {
     try {
-      final result = await _channel.invokeMethod('captureFullScreen');
-      if (result == null) return null;
-
-      // Convert List<int> to Uint8List
-      final List<int> dataList = List<int>.from(result);
-      return Uint8List.fromList(dataList);
+      // 原生端以 std::vector<uint8_t> 返回，解码后直接是 Uint8List，无需逐字节转换
+      return await _channel.invokeMethod<Uint8List>(
+        'captureFullScreen',
+        _encodeOptions.toArguments(),
+      );
     } catch (e) {
       debugPrint('Failed to capture full screen: $e');
       return null;
@@ -134,38 +621,77 @@ class WindowsScreenshotService implements ScreenshotPlatformInterface {
   @override
   Future<Uint8List?> captureRegion(Rect rect) async {
     try {
-      final result = await _channel.invokeMethod('captureRegion', {
+      return await _channel.invokeMethod<Uint8List>('captureRegion', {
         'x': rect.left.toInt(),
         'y': rect.top.toInt(),
         'width': rect.width.toInt(),
         'height': rect.height.toInt(),
+        ..._encodeOptions.toArguments(),
       });
-      if (result == null) return null;
-
-      final List<int> dataList = List<int>.from(result);
-      return Uint8List.fromList(dataList);
     } catch (e) {
       debugPrint('Failed to capture region: $e');
       return null;
     }
   }
 
+  @override
+  Future<Uint8List?> captureSelectedRegion(Rect rect) async {
+    try {
+      return await _channel.invokeMethod<Uint8List>('captureSelectedRegion', {
+        'x': rect.left.toInt(),
+        'y': rect.top.toInt(),
+        'width': rect.width.toInt(),
+        'height': rect.height.toInt(),
+        ..._encodeOptions.toArguments(),
+      });
+    } catch (e) {
+      debugPrint('Failed to capture selected region: $e');
+      return null;
+    }
+  }
+
   @override
   Future<Uint8List?> captureWindow(String windowId) async {
     try {
-      final result = await _channel.invokeMethod('captureWindow', {
+      return await _channel.invokeMethod<Uint8List>('captureWindow', {
         'windowId': windowId,
+        ..._encodeOptions.toArguments(),
       });
-      if (result == null) return null;
-
-      final List<int> dataList = List<int>.from(result);
-      return Uint8List.fromList(dataList);
     } catch (e) {
       debugPrint('Failed to capture window: $e');
       return null;
     }
   }
 
+  @override
+  Future<Map<String, WindowCapture>> captureWindows(
+    List<String> windowIds, {
+    int? maxSize,
+  }) async {
+    if (windowIds.isEmpty) return {};
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>(
+        'captureWindows',
+        {
+          'windowIds': windowIds,
+          if (maxSize != null) 'maxSize': maxSize,
+          ..._encodeOptions.toArguments(),
+        },
+      );
+      if (result == null) return {};
+      final captures = <String, WindowCapture>{};
+      for (final entry in result) {
+        if (entry == null) continue;
+        final capture = WindowCapture.fromMap(entry as Map<dynamic, dynamic>);
+        captures[capture.id] = capture;
+      }
+      return captures;
+    } catch (e) {
+      debugPrint('Failed to capture windows: $e');
+      return {};
+    }
+  }
+
   @override
   Future<List<WindowInfo>> getAvailableWindows() async {
     try {
@@ -178,11 +704,7 @@ class WindowsScreenshotService implements ScreenshotPlatformInterface {
         final Map<dynamic, dynamic> map = Map<dynamic, dynamic>.from(windowMap);
 
         // Parse icon data if present
-        Uint8List? iconBytes;
-        if (map['icon'] != null) {
-          final List<int> iconData = List<int>.from(map['icon']);
-          iconBytes = Uint8List.fromList(iconData);
-        }
+        final Uint8List? iconBytes = map['icon'] as Uint8List?;
 
         windows.add(
           WindowInfo(
@@ -206,6 +728,11 @@ class WindowsScreenshotService implements ScreenshotPlatformInterface {
     }
   }
 
+  @override
+  Stream<WindowListChange> watchWindows() {
+    return _EncodeCompletionRouter.of(_channel).watchWindows();
+  }
+
   @override
   Future<Rect?> getPrimaryScreenSize() async {
     // Windows API implementation
@@ -220,6 +747,67 @@ class WindowsScreenshotService implements ScreenshotPlatformInterface {
     }
   }
 
+  @override
+  Future<List<MonitorInfo>> getMonitors() async {
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>('getMonitors');
+      if (result == null) return [];
+      return result
+          .map((m) => MonitorInfo.fromMap(m as Map<dynamic, dynamic>))
+          .toList();
+    } catch (e) {
+      debugPrint('Failed to get monitors: $e');
+      return [];
+    }
+  }
+
+  @override
+  Future<VirtualDesktopCapture?> captureVirtualDesktop() async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'captureVirtualDesktop',
+        _encodeOptions.toArguments(),
+      );
+      if (result == null) return null;
+      return VirtualDesktopCapture(
+        bytes: result['bytes'] as Uint8List,
+        bounds: Rect.fromLTWH(
+          (result['x'] as int).toDouble(),
+          (result['y'] as int).toDouble(),
+          (result['width'] as int).toDouble(),
+          (result['height'] as int).toDouble(),
+        ),
+        monitors: (result['monitors'] as List<dynamic>)
+            .map((m) => MonitorInfo.fromMap(m as Map<dynamic, dynamic>))
+            .toList(),
+      );
+    } catch (e) {
+      debugPrint('Failed to capture virtual desktop: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<List<MonitorCapture>> captureMonitors() async {
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>(
+        'captureMonitors',
+        _encodeOptions.toArguments(),
+      );
+      if (result == null) return [];
+      return result.map((m) {
+        final map = m as Map<dynamic, dynamic>;
+        return MonitorCapture(
+          monitor: MonitorInfo.fromMap(map),
+          bytes: map['bytes'] as Uint8List,
+        );
+      }).toList();
+    } catch (e) {
+      debugPrint('Failed to capture monitors: $e');
+      return [];
+    }
+  }
+
   @override
   Future<bool> showNativeRegionCapture() async {
     try {
@@ -260,97 +848,598 @@ class WindowsScreenshotService implements ScreenshotPlatformInterface {
       return null;
     }
   }
-}
-
-/// macOS 平台截图服务实现
-class MacOSScreenshotService implements ScreenshotPlatformInterface {
-  const MacOSScreenshotService();
 
   @override
-  bool get isAvailable => Platform.isMacOS;
+  Future<PendingCapture?> beginCapture(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions? encodeOptions,
+    ChangeTracking? changeTracking,
+  }) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).begin(
+        request,
+        savePath: savePath,
+        deferEncode: deferEncode,
+        encodeOptions: encodeOptions ?? _encodeOptions,
+        changeTracking: changeTracking,
+      );
+    } catch (e) {
+      debugPrint('Failed to begin capture: $e');
+      return null;
+    }
+  }
 
   @override
-  Future<Uint8List?> captureFullScreen() async {
-    // TODO: 实现 macOS 全屏截图
-    // 可以使用 CGDisplayCreateImage 等 Cocoa API
-    throw UnimplementedError('macOS screenshot capture not yet implemented');
+  Future<FramePreview?> getFramePreview(int handle, {int? maxDimension}) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).preview(handle, maxDimension);
+    } catch (e) {
+      debugPrint('Failed to get frame preview: $e');
+      return null;
+    }
   }
 
   @override
-  Future<Uint8List?> captureRegion(Rect rect) async {
-    // TODO: 实现 macOS 区域截图
-    throw UnimplementedError('macOS region capture not yet implemented');
+  Future<bool> cancelEncode(int handle) async {
+    try {
+      return await _EncodeCompletionRouter.of(_channel).cancel(handle);
+    } catch (e) {
+      debugPrint('Failed to cancel encode: $e');
+      return false;
+    }
   }
 
   @override
-  Future<Uint8List?> captureWindow(String windowId) async {
-    // TODO: 实现 macOS 窗口截图
-    throw UnimplementedError('macOS window capture not yet implemented');
+  Future<bool> encodeFrame(int handle) async {
+    try {
+      return await _EncodeCompletionRouter.of(_channel).encode(handle);
+    } catch (e) {
+      debugPrint('Failed to encode frame: $e');
+      return false;
+    }
   }
 
   @override
-  Future<List<WindowInfo>> getAvailableWindows() async {
-    // TODO: 实现 macOS 窗口枚举
-    // 可以使用 CGWindowListCopyWindowInfo
-    return [];
+  Future<FrameTexture?> createFrameTexture(
+    int handle, {
+    int? maxDimension,
+  }) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).createTexture(handle, maxDimension);
+    } catch (e) {
+      debugPrint('Failed to create frame texture: $e');
+      return null;
+    }
   }
 
   @override
-  Future<Rect?> getPrimaryScreenSize() async {
-    // TODO: 实现 macOS 获取屏幕尺寸
-    return null;
+  Future<bool> disposeFrameTexture(int textureId) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).disposeTexture(textureId);
+    } catch (e) {
+      debugPrint('Failed to dispose frame texture: $e');
+      return false;
+    }
   }
 
   @override
-  Future<bool> showNativeRegionCapture() async {
-    throw UnimplementedError('macOS native window capture not yet implemented');
+  Future<bool> transcodeWhenIdle(String source, String target) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).transcode(source, target);
+    } catch (e) {
+      debugPrint('Failed to transcode $source: $e');
+      return false;
+    }
   }
 
   @override
-  Future<RegionSelectedEvent?> getRegionSelectionResult() async {
-    throw UnimplementedError('macOS native window capture not yet implemented');
+  Future<void> resetChangeDetection(String key) async {
+    try {
+      await _EncodeCompletionRouter.of(_channel).resetChangeDetection(key);
+    } catch (e) {
+      debugPrint('Failed to reset change detection: $e');
+    }
   }
-}
-
-/// Linux 平台截图服务实现
-class LinuxScreenshotService implements ScreenshotPlatformInterface {
-  const LinuxScreenshotService();
 
   @override
-  bool get isAvailable => Platform.isLinux;
+  Future<bool> startRecurringSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  ) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).startSchedule(schedule, onShot);
+    } catch (e) {
+      debugPrint('Failed to start native schedule: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<void> stopRecurringSchedule(String taskId) async {
+    try {
+      await _EncodeCompletionRouter.of(_channel).stopSchedule(taskId);
+    } catch (e) {
+      debugPrint('Failed to stop native schedule: $e');
+    }
+  }
+
+  @override
+  Future<bool> startRecording(RecordingRequest request) async {
+    try {
+      return await _channel.invokeMethod<bool>(
+            'startRecording',
+            request.toArguments(),
+          ) ??
+          false;
+    } catch (e) {
+      debugPrint('Failed to start recording: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<RecordingResult?> stopRecording(RecordingRequest request) async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'stopRecording',
+      );
+      if (result == null) return null;
+      return RecordingResult.fromMap(request.path, request.format, result);
+    } catch (e) {
+      debugPrint('Failed to stop recording: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<bool> startInstantReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  ) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).startReplay(request, onHotkeySave);
+    } catch (e) {
+      debugPrint('Failed to start instant replay: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<void> stopInstantReplay() async {
+    try {
+      await _EncodeCompletionRouter.of(_channel).stopReplay();
+    } catch (e) {
+      debugPrint('Failed to stop instant replay: $e');
+    }
+  }
+
+  @override
+  Future<RecordingResult?> saveInstantReplay({String? path}) async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'saveInstantReplay',
+        {if (path != null) 'path': path},
+      );
+      if (result == null) return null;
+      return _EncodeCompletionRouter.replayResult(result);
+    } catch (e) {
+      debugPrint('Failed to save instant replay: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<InstantReplayStats?> getInstantReplayStats() async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'getInstantReplayStats',
+      );
+      if (result == null) return null;
+      return InstantReplayStats.fromMap(result);
+    } catch (e) {
+      debugPrint('Failed to get instant replay stats: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<ScrollCaptureResult?> captureScrolling(
+    ScrollCaptureRequest request,
+  ) async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'captureScrolling',
+        request.toArguments(),
+      );
+      if (result == null) return null;
+      return ScrollCaptureResult.fromMap(request.path, result);
+    } catch (e) {
+      debugPrint('Failed to capture scrolling screenshot: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<int> cancelPendingCaptures() async {
+    try {
+      return await _channel.invokeMethod<int>('cancelPendingCaptures') ?? 0;
+    } catch (e) {
+      debugPrint('Failed to cancel pending captures: $e');
+      return 0;
+    }
+  }
+}
+
+/// macOS 平台截图服务实现
+class MacOSScreenshotService implements ScreenshotPlatformInterface {
+  const MacOSScreenshotService();
+
+  @override
+  bool get isAvailable => Platform.isMacOS;
+
+  @override
+  void updateEncodeOptions(EncodeOptions options) {}
 
   @override
   Future<Uint8List?> captureFullScreen() async {
-    // TODO: 实现 Linux 全屏截图
-    // X11: 使用 XGetImage
-    // Wayland: 使用 xdg-desktop-portal
-    throw UnimplementedError('Linux screenshot capture not yet implemented');
+    // TODO: 实现 macOS 全屏截图
+    // 可以使用 CGDisplayCreateImage 等 Cocoa API
+    throw UnimplementedError('macOS screenshot capture not yet implemented');
   }
 
   @override
   Future<Uint8List?> captureRegion(Rect rect) async {
-    // TODO: 实现 Linux 区域截图
-    throw UnimplementedError('Linux region capture not yet implemented');
+    // TODO: 实现 macOS 区域截图
+    throw UnimplementedError('macOS region capture not yet implemented');
+  }
+
+  @override
+  Future<Uint8List?> captureSelectedRegion(Rect rect) async {
+    throw UnimplementedError('macOS region capture not yet implemented');
   }
 
   @override
   Future<Uint8List?> captureWindow(String windowId) async {
-    // TODO: 实现 Linux 窗口截图
-    throw UnimplementedError('Linux window capture not yet implemented');
+    // TODO: 实现 macOS 窗口截图
+    throw UnimplementedError('macOS window capture not yet implemented');
+  }
+
+  @override
+  Future<Map<String, WindowCapture>> captureWindows(
+    List<String> windowIds, {
+    int? maxSize,
+  }) async {
+    // TODO: 实现 macOS 批量窗口截图
+    return {};
   }
 
   @override
   Future<List<WindowInfo>> getAvailableWindows() async {
-    // TODO: 实现 Linux 窗口枚举
+    // TODO: 实现 macOS 窗口枚举
+    // 可以使用 CGWindowListCopyWindowInfo
     return [];
   }
 
+  @override
+  Stream<WindowListChange> watchWindows() {
+    // TODO: 实现 macOS 窗口跟踪
+    return const Stream.empty();
+  }
+
+  @override
+  Future<Rect?> getPrimaryScreenSize() async {
+    // TODO: 实现 macOS 获取屏幕尺寸
+    return null;
+  }
+
+  @override
+  Future<List<MonitorInfo>> getMonitors() async {
+    // TODO: 实现 macOS 显示器枚举（CGGetActiveDisplayList）
+    return [];
+  }
+
+  @override
+  Future<VirtualDesktopCapture?> captureVirtualDesktop() async {
+    throw UnimplementedError('macOS screenshot capture not yet implemented');
+  }
+
+  @override
+  Future<List<MonitorCapture>> captureMonitors() async {
+    throw UnimplementedError('macOS screenshot capture not yet implemented');
+  }
+
+  @override
+  Future<bool> showNativeRegionCapture() async {
+    throw UnimplementedError('macOS native window capture not yet implemented');
+  }
+
+  @override
+  Future<RegionSelectedEvent?> getRegionSelectionResult() async {
+    throw UnimplementedError('macOS native window capture not yet implemented');
+  }
+
+  @override
+  Future<PendingCapture?> beginCapture(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions? encodeOptions,
+    ChangeTracking? changeTracking,
+  }) async => null;
+
+  @override
+  Future<FramePreview?> getFramePreview(int handle, {int? maxDimension}) async =>
+      null;
+
+  @override
+  Future<bool> cancelEncode(int handle) async => false;
+
+  @override
+  Future<bool> encodeFrame(int handle) async => false;
+
+  @override
+  Future<FrameTexture?> createFrameTexture(
+    int handle, {
+    int? maxDimension,
+  }) async => null;
+
+  @override
+  Future<bool> disposeFrameTexture(int textureId) async => false;
+
+  @override
+  Future<bool> transcodeWhenIdle(String source, String target) async => false;
+
+  @override
+  Future<void> resetChangeDetection(String key) async {}
+
+  @override
+  Future<bool> startRecurringSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  ) async => false;
+
+  @override
+  Future<void> stopRecurringSchedule(String taskId) async {}
+
+  @override
+  Future<bool> startRecording(RecordingRequest request) async => false;
+
+  @override
+  Future<RecordingResult?> stopRecording(RecordingRequest request) async =>
+      null;
+
+  @override
+  Future<bool> startInstantReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  ) async => false;
+
+  @override
+  Future<void> stopInstantReplay() async {}
+
+  @override
+  Future<RecordingResult?> saveInstantReplay({String? path}) async => null;
+
+  @override
+  Future<InstantReplayStats?> getInstantReplayStats() async => null;
+
+  @override
+  Future<ScrollCaptureResult?> captureScrolling(
+    ScrollCaptureRequest request,
+  ) async =>
+      null;
+
+  @override
+  Future<int> cancelPendingCaptures() async => 0;
+}
+
+/// Linux 平台截图服务实现
+class LinuxScreenshotService implements ScreenshotPlatformInterface {
+  // 与 Windows 共用通道名，原生端为 linux/runner/screenshot_channel.cc
+  static const MethodChannel _channel = MethodChannel(
+    'com.example.screenshot/screenshot',
+  );
+
+  LinuxScreenshotService();
+
+  /// 随每个截图请求发送的编码参数
+  EncodeOptions _encodeOptions = const EncodeOptions();
+
+  @override
+  void updateEncodeOptions(EncodeOptions options) {
+    _encodeOptions = options;
+  }
+
+  @override
+  bool get isAvailable => Platform.isLinux;
+
+  @override
+  Future<Uint8List?> captureFullScreen() async {
+    // X11: MIT-SHM（XShmGetImage）
+    // TODO: Wayland 需要 xdg-desktop-portal
+    try {
+      return await _channel.invokeMethod<Uint8List>(
+        'captureFullScreen',
+        _encodeOptions.toArguments(),
+      );
+    } catch (e) {
+      debugPrint('Failed to capture full screen: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<Uint8List?> captureRegion(Rect rect) async {
+    try {
+      return await _channel.invokeMethod<Uint8List>('captureRegion', {
+        'x': rect.left.toInt(),
+        'y': rect.top.toInt(),
+        'width': rect.width.toInt(),
+        'height': rect.height.toInt(),
+        ..._encodeOptions.toArguments(),
+      });
+    } catch (e) {
+      debugPrint('Failed to capture region: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<Uint8List?> captureSelectedRegion(Rect rect) {
+    // 没有原生选择窗口，也就没有冻结画面
+    return captureRegion(rect);
+  }
+
+  // X11: 有 XComposite 时截取窗口的离屏像素图（被遮挡也完整），否则截取屏幕上的区域
+  @override
+  Future<Uint8List?> captureWindow(String windowId) async {
+    try {
+      return await _channel.invokeMethod<Uint8List>('captureWindow', {
+        'windowId': windowId,
+        ..._encodeOptions.toArguments(),
+      });
+    } catch (e) {
+      debugPrint('Failed to capture window: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<Map<String, WindowCapture>> captureWindows(
+    List<String> windowIds, {
+    int? maxSize,
+  }) async {
+    if (windowIds.isEmpty) return {};
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>(
+        'captureWindows',
+        {
+          'windowIds': windowIds,
+          if (maxSize != null) 'maxSize': maxSize,
+          ..._encodeOptions.toArguments(),
+        },
+      );
+      if (result == null) return {};
+      final captures = <String, WindowCapture>{};
+      for (final entry in result) {
+        if (entry == null) continue;
+        final capture = WindowCapture.fromMap(entry as Map<dynamic, dynamic>);
+        captures[capture.id] = capture;
+      }
+      return captures;
+    } catch (e) {
+      debugPrint('Failed to capture windows: $e');
+      return {};
+    }
+  }
+
+  // X11: EWMH 的 _NET_CLIENT_LIST，图标来自 _NET_WM_ICON
+  @override
+  Future<List<WindowInfo>> getAvailableWindows() async {
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>(
+        'getAvailableWindows',
+      );
+      if (result == null) return [];
+      return result
+          .map((entry) => WindowInfo.fromMap(entry as Map<dynamic, dynamic>))
+          .toList();
+    } catch (e) {
+      debugPrint('Failed to get available windows: $e');
+      return [];
+    }
+  }
+
+  // X11: 初始列表来自 _NET_CLIENT_LIST，之后由 PropertyNotify 等事件增量更新
+  @override
+  Stream<WindowListChange> watchWindows() {
+    return _EncodeCompletionRouter.of(_channel).watchWindows();
+  }
+
   @override
   Future<Rect?> getPrimaryScreenSize() async {
     // TODO: 实现 Linux 获取屏幕尺寸
     return null;
   }
 
+  // X11: XRandR 枚举显示器，每个显示器一个 MIT-SHM 连接并行截取
+  @override
+  Future<List<MonitorInfo>> getMonitors() async {
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>('getMonitors');
+      if (result == null) return [];
+      return result
+          .map((m) => MonitorInfo.fromMap(m as Map<dynamic, dynamic>))
+          .toList();
+    } catch (e) {
+      debugPrint('Failed to get monitors: $e');
+      return [];
+    }
+  }
+
+  @override
+  Future<VirtualDesktopCapture?> captureVirtualDesktop() async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'captureVirtualDesktop',
+        _encodeOptions.toArguments(),
+      );
+      if (result == null) return null;
+      return VirtualDesktopCapture(
+        bytes: result['bytes'] as Uint8List,
+        bounds: Rect.fromLTWH(
+          (result['x'] as int).toDouble(),
+          (result['y'] as int).toDouble(),
+          (result['width'] as int).toDouble(),
+          (result['height'] as int).toDouble(),
+        ),
+        monitors: (result['monitors'] as List<dynamic>)
+            .map((m) => MonitorInfo.fromMap(m as Map<dynamic, dynamic>))
+            .toList(),
+      );
+    } catch (e) {
+      debugPrint('Failed to capture virtual desktop: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<List<MonitorCapture>> captureMonitors() async {
+    try {
+      final result = await _channel.invokeMethod<List<dynamic>>(
+        'captureMonitors',
+        _encodeOptions.toArguments(),
+      );
+      if (result == null) return [];
+      return result.map((m) {
+        final map = m as Map<dynamic, dynamic>;
+        return MonitorCapture(
+          monitor: MonitorInfo.fromMap(map),
+          bytes: map['bytes'] as Uint8List,
+        );
+      }).toList();
+    } catch (e) {
+      debugPrint('Failed to capture monitors: $e');
+      return [];
+    }
+  }
+
   @override
   Future<bool> showNativeRegionCapture() async {
     throw UnimplementedError('Linux native window capture not yet implemented');
@@ -360,6 +1449,232 @@ class LinuxScreenshotService implements ScreenshotPlatformInterface {
   Future<RegionSelectedEvent?> getRegionSelectionResult() async {
     throw UnimplementedError('Linux native window capture not yet implemented');
   }
+
+  @override
+  Future<PendingCapture?> beginCapture(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions? encodeOptions,
+    ChangeTracking? changeTracking,
+  }) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).begin(
+        request,
+        savePath: savePath,
+        deferEncode: deferEncode,
+        encodeOptions: encodeOptions ?? _encodeOptions,
+        changeTracking: changeTracking,
+      );
+    } catch (e) {
+      debugPrint('Failed to begin capture: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<FramePreview?> getFramePreview(int handle, {int? maxDimension}) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).preview(handle, maxDimension);
+    } catch (e) {
+      debugPrint('Failed to get frame preview: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<bool> cancelEncode(int handle) async {
+    try {
+      return await _EncodeCompletionRouter.of(_channel).cancel(handle);
+    } catch (e) {
+      debugPrint('Failed to cancel encode: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<bool> encodeFrame(int handle) async {
+    try {
+      return await _EncodeCompletionRouter.of(_channel).encode(handle);
+    } catch (e) {
+      debugPrint('Failed to encode frame: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<FrameTexture?> createFrameTexture(
+    int handle, {
+    int? maxDimension,
+  }) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).createTexture(handle, maxDimension);
+    } catch (e) {
+      debugPrint('Failed to create frame texture: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<bool> disposeFrameTexture(int textureId) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).disposeTexture(textureId);
+    } catch (e) {
+      debugPrint('Failed to dispose frame texture: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<bool> transcodeWhenIdle(String source, String target) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).transcode(source, target);
+    } catch (e) {
+      debugPrint('Failed to transcode $source: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<void> resetChangeDetection(String key) async {
+    try {
+      await _EncodeCompletionRouter.of(_channel).resetChangeDetection(key);
+    } catch (e) {
+      debugPrint('Failed to reset change detection: $e');
+    }
+  }
+
+  @override
+  Future<bool> startRecurringSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  ) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).startSchedule(schedule, onShot);
+    } catch (e) {
+      debugPrint('Failed to start native schedule: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<void> stopRecurringSchedule(String taskId) async {
+    try {
+      await _EncodeCompletionRouter.of(_channel).stopSchedule(taskId);
+    } catch (e) {
+      debugPrint('Failed to stop native schedule: $e');
+    }
+  }
+
+  @override
+  Future<bool> startRecording(RecordingRequest request) async {
+    try {
+      return await _channel.invokeMethod<bool>(
+            'startRecording',
+            request.toArguments(),
+          ) ??
+          false;
+    } catch (e) {
+      debugPrint('Failed to start recording: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<RecordingResult?> stopRecording(RecordingRequest request) async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'stopRecording',
+      );
+      if (result == null) return null;
+      return RecordingResult.fromMap(request.path, request.format, result);
+    } catch (e) {
+      debugPrint('Failed to stop recording: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<bool> startInstantReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  ) async {
+    try {
+      return await _EncodeCompletionRouter.of(
+        _channel,
+      ).startReplay(request, onHotkeySave);
+    } catch (e) {
+      debugPrint('Failed to start instant replay: $e');
+      return false;
+    }
+  }
+
+  @override
+  Future<void> stopInstantReplay() async {
+    try {
+      await _EncodeCompletionRouter.of(_channel).stopReplay();
+    } catch (e) {
+      debugPrint('Failed to stop instant replay: $e');
+    }
+  }
+
+  @override
+  Future<RecordingResult?> saveInstantReplay({String? path}) async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'saveInstantReplay',
+        {if (path != null) 'path': path},
+      );
+      if (result == null) return null;
+      return _EncodeCompletionRouter.replayResult(result);
+    } catch (e) {
+      debugPrint('Failed to save instant replay: $e');
+      return null;
+    }
+  }
+
+  @override
+  Future<InstantReplayStats?> getInstantReplayStats() async {
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'getInstantReplayStats',
+      );
+      if (result == null) return null;
+      return InstantReplayStats.fromMap(result);
+    } catch (e) {
+      debugPrint('Failed to get instant replay stats: $e');
+      return null;
+    }
+  }
+
+  /// Linux 端没有合成滚轮事件（需要 XTest），不支持长截图
+  @override
+  Future<ScrollCaptureResult?> captureScrolling(
+    ScrollCaptureRequest request,
+  ) async =>
+      null;
+
+  @override
+  Future<int> cancelPendingCaptures() async {
+    try {
+      return await _channel.invokeMethod<int>('cancelPendingCaptures') ?? 0;
+    } catch (e) {
+      debugPrint('Failed to cancel pending captures: $e');
+      return 0;
+    }
+  }
 }
 
 /// 降级处理服务（用于不支持的平台）
@@ -369,6 +1684,9 @@ class FallbackScreenshotService implements ScreenshotPlatformInterface {
   @override
   bool get isAvailable => false;
 
+  @override
+  void updateEncodeOptions(EncodeOptions options) {}
+
   @override
   Future<Uint8List?> captureFullScreen() async {
     throw UnsupportedError(
@@ -383,6 +1701,13 @@ class FallbackScreenshotService implements ScreenshotPlatformInterface {
     );
   }
 
+  @override
+  Future<Uint8List?> captureSelectedRegion(Rect rect) async {
+    throw UnsupportedError(
+      'Screenshot capture is not supported on this platform',
+    );
+  }
+
   @override
   Future<Uint8List?> captureWindow(String windowId) async {
     throw UnsupportedError(
@@ -390,16 +1715,48 @@ class FallbackScreenshotService implements ScreenshotPlatformInterface {
     );
   }
 
+  @override
+  Future<Map<String, WindowCapture>> captureWindows(
+    List<String> windowIds, {
+    int? maxSize,
+  }) async {
+    return {};
+  }
+
   @override
   Future<List<WindowInfo>> getAvailableWindows() async {
     return [];
   }
 
+  @override
+  Stream<WindowListChange> watchWindows() {
+    return const Stream.empty();
+  }
+
   @override
   Future<Rect?> getPrimaryScreenSize() async {
     return null;
   }
 
+  @override
+  Future<List<MonitorInfo>> getMonitors() async {
+    return [];
+  }
+
+  @override
+  Future<VirtualDesktopCapture?> captureVirtualDesktop() async {
+    throw UnsupportedError(
+      'Screenshot capture is not supported on this platform',
+    );
+  }
+
+  @override
+  Future<List<MonitorCapture>> captureMonitors() async {
+    throw UnsupportedError(
+      'Screenshot capture is not supported on this platform',
+    );
+  }
+
   @override
   Future<bool> showNativeRegionCapture() async {
     throw UnsupportedError(
@@ -413,4 +1770,78 @@ class FallbackScreenshotService implements ScreenshotPlatformInterface {
       'Native window capture is not supported on this platform',
     );
   }
+
+  @override
+  Future<PendingCapture?> beginCapture(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions? encodeOptions,
+    ChangeTracking? changeTracking,
+  }) async => null;
+
+  @override
+  Future<FramePreview?> getFramePreview(int handle, {int? maxDimension}) async =>
+      null;
+
+  @override
+  Future<bool> cancelEncode(int handle) async => false;
+
+  @override
+  Future<bool> encodeFrame(int handle) async => false;
+
+  @override
+  Future<FrameTexture?> createFrameTexture(
+    int handle, {
+    int? maxDimension,
+  }) async => null;
+
+  @override
+  Future<bool> disposeFrameTexture(int textureId) async => false;
+
+  @override
+  Future<bool> transcodeWhenIdle(String source, String target) async => false;
+
+  @override
+  Future<void> resetChangeDetection(String key) async {}
+
+  @override
+  Future<bool> startRecurringSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  ) async => false;
+
+  @override
+  Future<void> stopRecurringSchedule(String taskId) async {}
+
+  @override
+  Future<bool> startRecording(RecordingRequest request) async => false;
+
+  @override
+  Future<RecordingResult?> stopRecording(RecordingRequest request) async =>
+      null;
+
+  @override
+  Future<bool> startInstantReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  ) async => false;
+
+  @override
+  Future<void> stopInstantReplay() async {}
+
+  @override
+  Future<RecordingResult?> saveInstantReplay({String? path}) async => null;
+
+  @override
+  Future<InstantReplayStats?> getInstantReplayStats() async => null;
+
+  @override
+  Future<ScrollCaptureResult?> captureScrolling(
+    ScrollCaptureRequest request,
+  ) async =>
+      null;
+
+  @override
+  Future<int> cancelPendingCaptures() async => 0;
 }
@@ -1,8 +1,10 @@
 library;
 
 import 'dart:async';
+import 'dart:io';
 import 'dart:typed_data';
 import 'package:flutter/material.dart' hide TargetPlatform;
+import 'package:path/path.dart' as path;
 import '../../core/interfaces/i_plugin.dart';
 import '../../core/interfaces/i_platform_plugin.dart';
 import '../../core/models/plugin_models.dart';
@@ -38,6 +40,9 @@ class ScreenshotPlugin extends PlatformPluginBase {
   bool _isInitialized = false;
   bool _isScreenshotInProgress = false; // 截图操作进行中标志
   final List<ScreenshotRecord> _screenshots = [];
+  PendingCapture? _pendingCapture; // 已捕获、正在后台编码的截图
+  RecordingRequest? _activeRecording; // 正在进行的录屏
+  bool _instantReplayRunning = false; // 原生端即时回放是否在运行
   ss.ScreenshotSettings _settings = ss.ScreenshotSettings.defaultSettings();
 
   // 服务
@@ -47,6 +52,15 @@ class ScreenshotPlugin extends PlatformPluginBase {
   late HotkeyService _hotkeyService;
   late RecurringTaskManager _taskManager;
 
+  /// 已捕获、正在后台编码的截图（没有时为 null）
+  PendingCapture? get pendingCapture => _pendingCapture;
+
+  /// 是否正在录屏
+  bool get isRecording => _activeRecording != null;
+
+  /// 即时回放是否在运行
+  bool get isInstantReplayRunning => _instantReplayRunning;
+
   /// 获取文件管理器服务（用于外部访问）
   FileManagerService get fileManager => _fileManager;
 
@@ -171,14 +185,21 @@ class ScreenshotPlugin extends PlatformPluginBase {
         // 不抛出异常，允许插件以降级模式运行
       }
 
-      // 更新文件管理器的设置
+      // 更新文件管理器和截图服务的设置（原生端按设置的格式编码）
       _fileManager.updateSettings(_settings);
+      _screenshotService.updateSettings(_settings);
+
+      // 上次退出前没转完的快速存储截图，空闲时继续转成 PNG
+      unawaited(_resumePendingTranscodes());
 
       // 注册快捷键
       await _registerHotkeys();
 
       _isInitialized = true;
 
+      // 按设置开启即时回放
+      await _applyInstantReplay();
+
       await _context.platformServices.showNotification('$name 插件已成功初始化');
     } catch (e) {
       await _context.platformServices.showNotification('$name 插件初始化失败: $e');
@@ -192,6 +213,15 @@ class ScreenshotPlugin extends PlatformPluginBase {
       // 停止所有循环任务
       _taskManager.dispose();
 
+      // 正在录屏时写完文件
+      await stopRecording();
+
+      // 停止即时回放，释放内存中的画面
+      if (_instantReplayRunning) {
+        _instantReplayRunning = false;
+        await _screenshotService.stopInstantReplay();
+      }
+
       // 删除任务列表（任务只在单次会话中有效，不保存到下次启动）
       await _context.dataStorage.remove('recurring_tasks');
       debugPrint('ScreenshotPlugin: Cleared recurring tasks on dispose');
@@ -260,6 +290,27 @@ class ScreenshotPlugin extends PlatformPluginBase {
   /// 获取截图历史记录
   List<ScreenshotRecord> get screenshots => List.unmodifiable(_screenshots);
 
+  /// 在历史记录中查找与 [record] 相似的截图
+  ///
+  /// 按截图时记录的感知哈希比较，汉明距离不超过 [maxDistance] 的记录按距离
+  /// 从近到远返回（不含 [record] 本身）；没有感知哈希的记录不参与比较
+  List<ScreenshotRecord> findSimilarScreenshots(
+    ScreenshotRecord record, {
+    int maxDistance = 10,
+  }) {
+    final hash = record.perceptualHash;
+    if (hash == null) return [];
+    final matches = <(ScreenshotRecord, int)>[];
+    for (final other in _screenshots) {
+      final otherHash = other.perceptualHash;
+      if (other.id == record.id || otherHash == null) continue;
+      final distance = hammingDistance(hash, otherHash);
+      if (distance <= maxDistance) matches.add((other, distance));
+    }
+    matches.sort((a, b) => a.$2.compareTo(b.$2));
+    return [for (final match in matches) match.$1];
+  }
+
   /// 检查是否有活动的循环任务
   bool _hasActiveRecurringTasks() {
     return _taskManager.tasks.any((task) => task.status == TaskStatus.running);
@@ -285,6 +336,12 @@ class ScreenshotPlugin extends PlatformPluginBase {
     print('🔒 截图状态：已锁定（全屏截图）');
 
     try {
+      if (await _captureTwoPhase(
+        const CaptureRequest.fullScreen(),
+        ScreenshotType.fullScreen,
+      )) {
+        return;
+      }
       final bytes = await _screenshotService.captureFullScreen();
       if (bytes != null) {
         await _processScreenshot(bytes, ScreenshotType.fullScreen);
@@ -303,6 +360,12 @@ class ScreenshotPlugin extends PlatformPluginBase {
   /// 捕获区域截图
   Future<void> captureRegion(Rect region) async {
     print('📸 captureRegion: 开始捕获区域 $region');
+    if (await _captureTwoPhase(
+      CaptureRequest.region(region),
+      ScreenshotType.region,
+    )) {
+      return;
+    }
     final bytes = await _screenshotService.captureRegion(region);
     print('📸 captureRegion: 截图数据大小 = ${bytes?.length ?? 'null'}');
     if (bytes != null) {
@@ -314,6 +377,22 @@ class ScreenshotPlugin extends PlatformPluginBase {
     }
   }
 
+  /// 捕获原生区域选择窗口刚确认的区域
+  ///
+  /// 原生端直接从选择时冻结的画面裁剪，不再重新截屏
+  Future<void> captureSelectedRegion(Rect region) async {
+    if (await _captureTwoPhase(
+      CaptureRequest.selectedRegion(region),
+      ScreenshotType.region,
+    )) {
+      return;
+    }
+    final bytes = await _screenshotService.captureSelectedRegion(region);
+    if (bytes != null) {
+      await _processScreenshot(bytes, ScreenshotType.region);
+    }
+  }
+
   /// 捕获区域截图（返回字节数据）
   Future<Uint8List?> captureRegionBytes(Rect region) async {
     return await _screenshotService.captureRegion(region);
@@ -321,6 +400,12 @@ class ScreenshotPlugin extends PlatformPluginBase {
 
   /// 捕获窗口截图
   Future<void> captureWindow(String windowId) async {
+    if (await _captureTwoPhase(
+      CaptureRequest.window(windowId),
+      ScreenshotType.window,
+    )) {
+      return;
+    }
     final bytes = await _screenshotService.captureWindow(windowId);
     if (bytes != null) {
       await _processScreenshot(bytes, ScreenshotType.window);
@@ -332,6 +417,22 @@ class ScreenshotPlugin extends PlatformPluginBase {
     return await _screenshotService.getAvailableWindows();
   }
 
+  /// 实时窗口列表（窗口选择器），取消订阅时原生端停止监听
+  Stream<WindowListChange> watchWindows() {
+    return _screenshotService.watchWindows();
+  }
+
+  /// 一次获取多个窗口的缩略图（长边 [maxSize]），以窗口 ID 为键
+  Future<Map<String, WindowCapture>> captureWindowThumbnails(
+    List<String> windowIds, {
+    int maxSize = 240,
+  }) async {
+    return await _screenshotService.captureWindows(
+      windowIds,
+      maxSize: maxSize,
+    );
+  }
+
   /// 删除截图记录
   Future<void> deleteScreenshot(String screenshotId) async {
     final index = _screenshots.indexWhere((s) => s.id == screenshotId);
@@ -356,9 +457,18 @@ class ScreenshotPlugin extends PlatformPluginBase {
 
   /// 更新设置
   Future<void> updateSettings(ss.ScreenshotSettings newSettings) async {
+    final replayChanged =
+        !mapEquals(
+          _settings.instantReplay.toJson(),
+          newSettings.instantReplay.toJson(),
+        ) ||
+        _settings.savePath != newSettings.savePath;
     _settings = newSettings;
     _fileManager.updateSettings(newSettings);
     _screenshotService.updateSettings(newSettings);
+    if (replayChanged) {
+      await _applyInstantReplay();
+    }
     await _saveConfig();
     _onStateChanged?.call();
   }
@@ -376,6 +486,9 @@ class ScreenshotPlugin extends PlatformPluginBase {
     required int intervalSeconds,
     int? totalShots,
     String? saveDirectory,
+    bool fastStorage = false,
+    ChangeDetection changeDetection = ChangeDetection.off,
+    int? dedupDistance,
   }) {
     final task = _taskManager.createTask(
       name: name,
@@ -384,6 +497,9 @@ class ScreenshotPlugin extends PlatformPluginBase {
       intervalSeconds: intervalSeconds,
       totalShots: totalShots,
       saveDirectory: saveDirectory,
+      fastStorage: fastStorage,
+      changeDetection: changeDetection,
+      dedupDistance: dedupDistance,
     );
 
     // 保存到配置
@@ -408,6 +524,324 @@ class ScreenshotPlugin extends PlatformPluginBase {
   void deleteRecurringTask(String taskId) {
     _taskManager.deleteTask(taskId);
     _saveTasksConfig();
+    unawaited(_screenshotService.resetChangeDetection(taskId));
+  }
+
+  /// 执行循环任务的一次截图
+  ///
+  /// [RecurringScreenshotTask.fastStorage] 为 true 时原生端只写 QOI（编码比 PNG
+  /// 快一个数量级），截图空闲时再转成 PNG；[RecurringScreenshotTask.changeDetection]
+  /// 不为 off 时原生端按分块和上一次保存的整帧比较，画面未变化就不编码也不保存；
+  /// [RecurringScreenshotTask.dedupDistance] 不为 null 时帧先暂存，感知哈希与上一次
+  /// 保存的截图足够接近就放弃编码。平台不支持两阶段截图时按普通截图处理
+  Future<void> captureForRecurringTask(RecurringScreenshotTask task) async {
+    final windowId = task.windowId;
+    final isWindow = windowId != null && windowId.isNotEmpty;
+    final request = isWindow
+        ? CaptureRequest.window(windowId)
+        : const CaptureRequest.fullScreen();
+    final type = isWindow ? ScreenshotType.window : ScreenshotType.fullScreen;
+    switch (task.changeDetection) {
+      case ChangeDetection.dirtyTiles:
+        if (await _captureTileDelta(task, request)) return;
+      case ChangeDetection.skipUnchanged:
+        if (await _captureRecurring(
+          task,
+          request,
+          type,
+          changeTracking: ChangeTracking(task.id),
+        )) {
+          return;
+        }
+      case ChangeDetection.off:
+        if ((task.fastStorage || task.dedupDistance != null) &&
+            await _captureRecurring(task, request, type)) {
+          return;
+        }
+    }
+    if (isWindow) {
+      await captureWindow(windowId);
+    } else {
+      await captureFullScreen();
+    }
+  }
+
+  /// 循环截图的两阶段截图：原生端直接写文件，写完后加入历史记录
+  ///
+  /// 快速存储时原生端把 QOI 写到 PNG 目标路径旁边，转码完成后
+  /// 才加入历史记录，历史记录、剪贴板和预览都只见到 PNG。
+  /// 画面未变化（[changeTracking]）或近似重复时直接返回；平台不支持时返回 false
+  Future<bool> _captureRecurring(
+    RecurringScreenshotTask task,
+    CaptureRequest request,
+    ScreenshotType type, {
+    ChangeTracking? changeTracking,
+  }) async {
+    final fastStorage = task.fastStorage;
+    final targetPath = await _fileManager.createScreenshotPath(
+      format: fastStorage ? ss.ImageFormat.png : null,
+    );
+    final savePath = fastStorage
+        ? path.setExtension(targetPath, '.qoi')
+        : targetPath;
+    final pending = await _screenshotService.beginCapture(
+      request,
+      savePath: savePath,
+      encodeOptions: fastStorage
+          ? const EncodeOptions(format: ss.ImageFormat.qoi)
+          : null,
+      deferEncode: task.dedupDistance != null,
+      changeTracking: changeTracking,
+    );
+    if (pending == null) return false;
+    if (!pending.changed) {
+      debugPrint('ScreenshotPlugin: Screen unchanged, skipped saving');
+      return true;
+    }
+    if (!await _admitRecurringFrame(task, pending)) return true;
+
+    final completion = await pending.completion;
+    if (completion.path == null) {
+      debugPrint('ScreenshotPlugin: Recurring capture failed (${completion.status})');
+      return true;
+    }
+    final metadata = ScreenshotRecord.perceptualHashMetadata(
+      pending.perceptualHash,
+    );
+    if (fastStorage) {
+      // 不等待转码：下一次截图不受影响，转码本身也会让位给截图
+      unawaited(
+        _transcodeAndRecord(savePath, targetPath, type, metadata: metadata),
+      );
+    } else {
+      await _recordSavedScreenshot(targetPath, type, metadata: metadata);
+    }
+    return true;
+  }
+
+  /// 近似重复过滤：任务开启过滤时帧以 deferEncode 暂存，
+  /// 与上一次保存的截图过于相似就放弃，否则开始编码
+  Future<bool> _admitRecurringFrame(
+    RecurringScreenshotTask task,
+    PendingCapture pending,
+  ) async {
+    if (task.dedupDistance == null) return true;
+    if (!_taskManager.acceptFrame(task, pending.perceptualHash)) {
+      await _screenshotService.cancelEncode(pending.handle);
+      if (pending.keyframe) {
+        // 放弃的是新的关键帧，之后的补丁没有可依附的整帧
+        await _screenshotService.resetChangeDetection(task.id);
+      }
+      return false;
+    }
+    await _screenshotService.encodeFrame(pending.handle);
+    return true;
+  }
+
+  /// 分块增量截图：未变化时跳过；整帧（关键帧）和只含变化分块的透明补丁
+  /// 都以 PNG 写到任务的增量目录，并在 manifest.jsonl 记下补丁的位置
+  ///
+  /// 补丁总是相对于最近的关键帧，按 manifest 顺序把补丁贴到关键帧上即可还原
+  /// 每一次截图。增量目录不进入历史记录；平台不支持时返回 false
+  Future<bool> _captureTileDelta(
+    RecurringScreenshotTask task,
+    CaptureRequest request,
+  ) async {
+    final directory = await _fileManager.getDeltaDirectory(task.id);
+    final now = DateTime.now();
+    final filePath = path.join(directory, '${now.millisecondsSinceEpoch}.png');
+    final pending = await _screenshotService.beginCapture(
+      request,
+      savePath: filePath,
+      // 补丁靠 alpha 标出覆盖范围，快速存储和 JPEG 都不适用
+      encodeOptions: const EncodeOptions(format: ss.ImageFormat.png),
+      deferEncode: task.dedupDistance != null,
+      changeTracking: ChangeTracking(task.id, tileDelta: true),
+    );
+    if (pending == null) return false;
+    if (!pending.changed) return true;
+    if (!await _admitRecurringFrame(task, pending)) return true;
+
+    final completion = await pending.completion;
+    if (completion.path == null) {
+      debugPrint('ScreenshotPlugin: Tile delta capture failed (${completion.status})');
+      if (pending.keyframe) {
+        // 关键帧没写成功，之后的补丁没有可依附的整帧
+        await _screenshotService.resetChangeDetection(task.id);
+      }
+      return true;
+    }
+    final patch = pending.patch;
+    await _fileManager.appendDeltaManifest(directory, {
+      'file': path.basename(filePath),
+      'time': now.toIso8601String(),
+      'width': pending.width,
+      'height': pending.height,
+      'keyframe': patch == null,
+      if (patch != null) ...{
+        'x': patch.x,
+        'y': patch.y,
+        'patchWidth': patch.width,
+        'patchHeight': patch.height,
+      },
+      'dirtyTiles': pending.dirtyTiles,
+      'totalTiles': pending.totalTiles,
+      ...ScreenshotRecord.perceptualHashMetadata(pending.perceptualHash),
+    });
+    return true;
+  }
+
+  /// 把循环任务交给原生调度器，成功时返回 true
+  ///
+  /// 计时、截图、变化检测、近似重复过滤、编码和写文件都在原生线程上完成，
+  /// 间隔按固定节拍计算，不受 Dart 事件循环和单次截图耗时影响；每次触发
+  /// 通过 [onShot] 报告。平台不支持时返回 false，调用方改用 Dart 定时器
+  Future<bool> startNativeSchedule(
+    RecurringScreenshotTask task, {
+    required void Function(ScheduledShot shot) onShot,
+  }) async {
+    final totalShots = task.totalShots;
+    final remaining = totalShots == null
+        ? null
+        : totalShots - task.completedShots;
+    if (remaining != null && remaining <= 0) return false;
+
+    final windowId = task.windowId;
+    final request = windowId != null && windowId.isNotEmpty
+        ? CaptureRequest.window(windowId)
+        : const CaptureRequest.fullScreen();
+    final tileDelta = task.changeDetection == ChangeDetection.dirtyTiles;
+    final EncodeOptions encodeOptions;
+    if (tileDelta) {
+      // 补丁靠 alpha 标出覆盖范围，快速存储和 JPEG 都不适用
+      encodeOptions = const EncodeOptions(format: ss.ImageFormat.png);
+    } else if (task.fastStorage) {
+      encodeOptions = const EncodeOptions(format: ss.ImageFormat.qoi);
+    } else {
+      encodeOptions = EncodeOptions.fromSettings(_settings);
+    }
+    final schedule = RecurringSchedule(
+      taskId: task.id,
+      request: request,
+      interval: Duration(seconds: task.intervalSeconds),
+      totalShots: remaining,
+      directory: tileDelta
+          ? await _fileManager.getDeltaDirectory(task.id)
+          : await _fileManager.getScreenshotDirectory(),
+      // 增量目录里的文件名就是时间戳，manifest 按文件名引用
+      filePrefix: tileDelta ? '' : 'recurring_${task.id}_',
+      encodeOptions: encodeOptions,
+      changeTracking: task.changeDetection == ChangeDetection.off
+          ? null
+          : ChangeTracking(task.id, tileDelta: tileDelta),
+      dedupDistance: task.dedupDistance,
+    );
+    return _screenshotService.startRecurringSchedule(schedule, onShot);
+  }
+
+  /// 停止循环任务的原生计划
+  Future<void> stopNativeSchedule(String taskId) {
+    return _screenshotService.stopRecurringSchedule(taskId);
+  }
+
+  /// 处理原生调度的一次触发：已写好的文件加入历史记录或增量 manifest
+  Future<void> handleScheduledShot(
+    RecurringScreenshotTask task,
+    ScheduledShot shot,
+  ) async {
+    final filePath = shot.path;
+    if (shot.status != ScheduledShotStatus.saved || filePath == null) {
+      if (shot.status == ScheduledShotStatus.failed) {
+        debugPrint('ScreenshotPlugin: Scheduled capture ${shot.index} failed');
+      }
+      return;
+    }
+    final type = task.windowId != null && task.windowId!.isNotEmpty
+        ? ScreenshotType.window
+        : ScreenshotType.fullScreen;
+    final metadata = ScreenshotRecord.perceptualHashMetadata(
+      shot.perceptualHash,
+    );
+    if (task.changeDetection == ChangeDetection.dirtyTiles) {
+      final patch = shot.patch;
+      await _fileManager.appendDeltaManifest(path.dirname(filePath), {
+        'file': path.basename(filePath),
+        'time': (shot.time ?? DateTime.now()).toIso8601String(),
+        'width': shot.width,
+        'height': shot.height,
+        'keyframe': patch == null,
+        if (patch != null) ...{
+          'x': patch.x,
+          'y': patch.y,
+          'patchWidth': patch.width,
+          'patchHeight': patch.height,
+        },
+        'dirtyTiles': shot.dirtyTiles,
+        'totalTiles': shot.totalTiles,
+        ...metadata,
+      });
+    } else if (task.fastStorage) {
+      unawaited(
+        _transcodeAndRecord(
+          filePath,
+          path.setExtension(filePath, '.png'),
+          type,
+          metadata: metadata,
+        ),
+      );
+    } else {
+      await _recordSavedScreenshot(filePath, type, metadata: metadata);
+    }
+  }
+
+  /// 等待 QOI 转成 PNG，成功后加入历史记录（[type] 为 null 时只转码不记录）
+  Future<void> _transcodeAndRecord(
+    String qoiPath,
+    String pngPath,
+    ScreenshotType? type, {
+    Map<String, dynamic>? metadata,
+  }) async {
+    if (!await _screenshotService.transcodeWhenIdle(qoiPath, pngPath)) {
+      return;
+    }
+    if (type == null) return;
+    await _recordSavedScreenshot(pngPath, type, metadata: metadata);
+  }
+
+  /// 把原生端已写好的截图文件加入历史记录
+  Future<void> _recordSavedScreenshot(
+    String filePath,
+    ScreenshotType type, {
+    Map<String, dynamic>? metadata,
+  }) async {
+    if (!_isInitialized) return;
+
+    final record = ScreenshotRecord(
+      id: DateTime.now().millisecondsSinceEpoch.toString(),
+      filePath: filePath,
+      createdAt: DateTime.now(),
+      fileSize: await File(filePath).length(),
+      type: type,
+      metadata: metadata == null || metadata.isEmpty ? null : metadata,
+    );
+    _screenshots.insert(0, record);
+    if (_screenshots.length > _settings.maxHistoryCount) {
+      final removed = _screenshots.removeLast();
+      await _fileManager.deleteScreenshot(removed.filePath);
+    }
+    await _saveConfig();
+    _onStateChanged?.call();
+  }
+
+  /// 重新提交上次退出前没转完的 QOI 文件
+  ///
+  /// 截图类型没有保存，这些文件只转码，不补进历史记录
+  Future<void> _resumePendingTranscodes() async {
+    for (final qoiPath in await _fileManager.findPendingQoiFiles()) {
+      unawaited(
+        _transcodeAndRecord(qoiPath, path.setExtension(qoiPath, '.png'), null),
+      );
+    }
   }
 
   /// 保存任务配置
@@ -498,7 +932,7 @@ class ScreenshotPlugin extends PlatformPluginBase {
           final rect = result.toRect();
           print('📍 [$callId] 🔑 快捷键：开始捕获区域: $rect');
           try {
-            await captureRegion(rect);
+            await captureSelectedRegion(rect);
             print('📍 [$callId] 🔑 快捷键：✅ 区域捕获完成');
             // 成功完成，正常退出（会执行 finally）
             return;
@@ -525,8 +959,270 @@ class ScreenshotPlugin extends PlatformPluginBase {
     }
   }
 
+  /// 选择区域后开始录屏，成功开始时返回 true
+  ///
+  /// 区域选择与区域截图相同（原生选择窗口 + 轮询结果），之后原生端按 [fps]
+  /// 录制实时画面并边录边写文件，直到 [stopRecording]
+  Future<bool> recordSelectedRegion({
+    int fps = 10,
+    RecordingFormat format = RecordingFormat.gif,
+  }) async {
+    if (_activeRecording != null || _isScreenshotInProgress) return false;
+    _isScreenshotInProgress = true;
+    try {
+      // 先清理上一次的残留结果
+      await getRegionSelectionResult();
+      if (!await showNativeRegionCapture()) return false;
+
+      const maxPolls = 300; // 最多轮询 30 秒（每 100ms 一次）
+      for (var polls = 0; polls < maxPolls; polls++) {
+        await Future.delayed(const Duration(milliseconds: 100));
+        final result = await getRegionSelectionResult();
+        if (result == null) continue;
+        if (result.cancelled) return false;
+
+        final request = RecordingRequest(
+          region: result.toRect(),
+          fps: fps,
+          format: format,
+          path: await _fileManager.createRecordingPath(format),
+        );
+        if (!await _screenshotService.startRecording(request)) return false;
+        _activeRecording = request;
+        _onStateChanged?.call();
+        return true;
+      }
+      return false;
+    } finally {
+      _isScreenshotInProgress = false;
+    }
+  }
+
+  /// 停止录屏，写好的文件加入历史记录；没有在录屏或写入失败时返回 null
+  Future<RecordingResult?> stopRecording() async {
+    final request = _activeRecording;
+    if (request == null) return null;
+    _activeRecording = null;
+    final result = await _screenshotService.stopRecording(request);
+    if (result != null) {
+      await _recordSavedScreenshot(
+        result.path,
+        ScreenshotType.region,
+        metadata: {
+          'recording': result.format.name,
+          'frames': result.frames,
+          'durationMs': result.duration.inMilliseconds,
+        },
+      );
+    }
+    _onStateChanged?.call();
+    return result;
+  }
+
+  // ========== 长截图 ==========
+
+  /// 长截图：滚动 [windowId] 窗口，或先选择区域再滚动该区域，拼接成一张 PNG 加入历史记录
+  ///
+  /// 原生端负责截图、发送滚轮和拼接，整个过程在一次调用内完成；
+  /// 取消选择、平台不支持或失败时返回 null
+  Future<ScrollCaptureResult?> captureScrolling({String? windowId}) async {
+    if (_isScreenshotInProgress) return null;
+    _isScreenshotInProgress = true;
+    try {
+      CaptureRequest? target;
+      if (windowId != null) {
+        target = CaptureRequest.window(windowId);
+      } else {
+        await getRegionSelectionResult();
+        if (!await showNativeRegionCapture()) return null;
+        const maxPolls = 300; // 最多轮询 30 秒（每 100ms 一次）
+        for (var polls = 0; polls < maxPolls && target == null; polls++) {
+          await Future.delayed(const Duration(milliseconds: 100));
+          final result = await getRegionSelectionResult();
+          if (result == null) continue;
+          if (result.cancelled) return null;
+          // 滚动时画面在变，不能用选择时冻结的画面
+          target = CaptureRequest.region(result.toRect());
+        }
+        if (target == null) return null;
+      }
+
+      final request = ScrollCaptureRequest(
+        target: target,
+        path: await _fileManager.createScreenshotPath(
+          format: ss.ImageFormat.png,
+        ),
+      );
+      final result = await _screenshotService.captureScrolling(request);
+      if (result != null) {
+        await _recordSavedScreenshot(
+          result.path,
+          windowId != null ? ScreenshotType.window : ScreenshotType.region,
+          metadata: {
+            'scrolling': true,
+            'frames': result.frames,
+            'height': result.height,
+          },
+        );
+      }
+      return result;
+    } finally {
+      _isScreenshotInProgress = false;
+    }
+  }
+
+  // ========== 即时回放 ==========
+
+  /// 按设置开启或停止即时回放
+  ///
+  /// 采集主显示器，保存到截图目录；已在运行时原生端按新参数重新开始
+  /// （之前缓冲的画面丢弃）
+  Future<void> _applyInstantReplay() async {
+    final replay = _settings.instantReplay;
+    if (!replay.enabled) {
+      if (_instantReplayRunning) {
+        _instantReplayRunning = false;
+        await _screenshotService.stopInstantReplay();
+        _onStateChanged?.call();
+      }
+      return;
+    }
+
+    final monitors = await _screenshotService.getMonitors();
+    if (monitors.isEmpty) {
+      debugPrint('ScreenshotPlugin: No monitor for instant replay');
+      return;
+    }
+    final monitor = monitors.firstWhere(
+      (m) => m.primary,
+      orElse: () => monitors.first,
+    );
+    final request = InstantReplayRequest(
+      region: monitor.bounds,
+      fps: replay.fps,
+      duration: Duration(seconds: replay.seconds),
+      memoryLimitMb: replay.memoryLimitMb,
+      format: replay.format,
+      directory: await _fileManager.getScreenshotDirectory(),
+    );
+    _instantReplayRunning = await _screenshotService.startInstantReplay(
+      request,
+      _onInstantReplaySaved,
+    );
+    if (!_instantReplayRunning) {
+      debugPrint('ScreenshotPlugin: Instant replay not started');
+    }
+    _onStateChanged?.call();
+  }
+
+  /// 保存最近的画面，文件加入历史记录；没有在运行或写入失败时返回 null
+  Future<RecordingResult?> saveInstantReplay() async {
+    if (!_instantReplayRunning) return null;
+    final result = await _screenshotService.saveInstantReplay();
+    if (result != null) {
+      await _recordInstantReplay(result);
+    }
+    return result;
+  }
+
+  /// 即时回放的 CPU 和内存开销；没有在运行时返回 null
+  Future<InstantReplayStats?> getInstantReplayStats() async {
+    if (!_instantReplayRunning) return null;
+    return await _screenshotService.getInstantReplayStats();
+  }
+
+  /// 原生端响应 saveReplay 热键保存的回放
+  Future<void> _onInstantReplaySaved(RecordingResult? result) async {
+    if (result == null) {
+      await _context.platformServices.showNotification('即时回放保存失败');
+      return;
+    }
+    await _recordInstantReplay(result);
+    await _context.platformServices.showNotification('即时回放已保存');
+  }
+
+  Future<void> _recordInstantReplay(RecordingResult result) async {
+    await _recordSavedScreenshot(
+      result.path,
+      ScreenshotType.fullScreen,
+      metadata: {
+        'replay': result.format.name,
+        'frames': result.frames,
+        'durationMs': result.duration.inMilliseconds,
+      },
+    );
+    _onStateChanged?.call();
+  }
+
+  /// 获取正在后台编码的截图的预览（RGBA）
+  Future<FramePreview?> getPendingPreview({int? maxDimension}) async {
+    final pending = _pendingCapture;
+    if (pending == null) return null;
+    return await _screenshotService.getFramePreview(
+      pending.handle,
+      maxDimension: maxDimension,
+    );
+  }
+
+  /// 把截图帧注册为原生外部纹理，预览不经过 PNG 编码和解码
+  ///
+  /// 帧已编码完或平台不支持时返回 null；用完后调用 [disposeFrameTexture]
+  Future<FrameTexture?> createFrameTexture(
+    int handle, {
+    int? maxDimension,
+  }) async {
+    return await _screenshotService.createFrameTexture(
+      handle,
+      maxDimension: maxDimension,
+    );
+  }
+
+  /// 释放预览纹理
+  Future<void> disposeFrameTexture(int textureId) async {
+    await _screenshotService.disposeFrameTexture(textureId);
+  }
+
+  /// 两阶段截图：原生端拿到像素就返回，PNG / JPEG 编码在后台完成后再保存和记录
+  ///
+  /// 平台不支持时返回 false，调用方退回一次性的截图方法
+  Future<bool> _captureTwoPhase(
+    CaptureRequest request,
+    ScreenshotType type,
+  ) async {
+    final pending = await _screenshotService.beginCapture(request);
+    if (pending == null) return false;
+
+    // 像素已经在内存中：立即通知 UI，可以用 createFrameTexture 显示预览
+    _pendingCapture = pending;
+    _onStateChanged?.call();
+
+    final completion = await pending.completion;
+    if (identical(_pendingCapture, pending)) {
+      _pendingCapture = null;
+    }
+    if (completion.succeeded) {
+      await _processScreenshot(
+        completion.bytes!,
+        type,
+        metadata: ScreenshotRecord.perceptualHashMetadata(
+          pending.perceptualHash,
+        ),
+      );
+    } else {
+      _onStateChanged?.call();
+      if (completion.status == EncodeStatus.failed) {
+        await _context.platformServices.showNotification('截图编码失败');
+      }
+    }
+    return true;
+  }
+
   /// 处理截图
-  Future<void> _processScreenshot(Uint8List bytes, ScreenshotType type) async {
+  Future<void> _processScreenshot(
+    Uint8List bytes,
+    ScreenshotType type, {
+    Map<String, dynamic>? metadata,
+  }) async {
     try {
       print('📸 _processScreenshot: 开始处理截图, 大小: ${bytes.length} bytes');
 
@@ -543,6 +1239,7 @@ class ScreenshotPlugin extends PlatformPluginBase {
         createdAt: DateTime.now(),
         fileSize: bytes.length,
         type: type,
+        metadata: metadata == null || metadata.isEmpty ? null : metadata,
       );
 
       _screenshots.insert(0, record);
@@ -660,6 +1357,28 @@ class ScreenshotPlugin extends PlatformPluginBase {
       print('🔑 ${success ? "✅" : "❌"} 全屏截图快捷键注册${success ? "成功" : "失败"}');
     }
 
+    // 注册保存即时回放快捷键
+    if (shortcuts.containsKey('saveReplay')) {
+      print('🔑 注册保存即时回放快捷键: ${shortcuts['saveReplay']}');
+      final success = await _hotkeyService.registerHotkey(
+        'saveReplay',
+        shortcuts['saveReplay']!,
+        () async {
+          // 即时回放运行时 Windows 原生端直接保存（结果走 _onInstantReplaySaved），
+          // 不会调用到这里
+          if (!_instantReplayRunning) {
+            await _context.platformServices.showNotification('即时回放未开启');
+            return;
+          }
+          final result = await saveInstantReplay();
+          await _context.platformServices.showNotification(
+            result != null ? '即时回放已保存' : '即时回放保存失败',
+          );
+        },
+      );
+      print('🔑 ${success ? "✅" : "❌"} 保存即时回放快捷键注册${success ? "成功" : "失败"}');
+    }
+
     print('🔑 ========== 热键注册完成 ==========');
   }
 }
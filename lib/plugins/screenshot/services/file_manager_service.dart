@@ -1,5 +1,6 @@
 library;
 
+import 'dart:convert';
 import 'dart:io';
 import 'package:flutter/foundation.dart';
 import 'package:path_provider/path_provider.dart';
@@ -70,12 +71,18 @@ class FileManagerService {
   }
 
   /// 生成文件名
-  Future<String> _generateFilename({String? customFormat}) async {
-    final format = customFormat ?? _settings.filenameFormat;
+  ///
+  /// [format] 决定扩展名，默认使用设置中的图片格式
+  Future<String> _generateFilename({
+    String? customFormat,
+    ImageFormat? format,
+    String? fileExtension,
+  }) async {
+    final pattern = customFormat ?? _settings.filenameFormat;
     final now = DateTime.now();
 
     // 生成唯一的文件名
-    String filename = format
+    String filename = pattern
         .replaceAll('{timestamp}', now.millisecondsSinceEpoch.toString())
         .replaceAll('{date}', DateFormat('yyyy-MM-dd').format(now))
         .replaceAll('{time}', DateFormat('HH-mm-ss').format(now))
@@ -104,7 +111,8 @@ class FileManagerService {
     }
 
     // 添加扩展名
-    final extension = _settings.imageFormat.extension;
+    final extension =
+        fileExtension ?? (format ?? _settings.imageFormat).extension;
     if (!filename.endsWith('.$extension')) {
       filename = '$filename.$extension';
     }
@@ -166,6 +174,77 @@ class FileManagerService {
     }
   }
 
+  /// 截图保存目录（不存在时创建）
+  ///
+  /// 用于原生调度的循环截图：原生端自己按时间戳生成文件名
+  Future<String> getScreenshotDirectory() async {
+    final savePath = await _resolveSavePath();
+    await _ensureDirectoryExists(savePath);
+    return path.normalize(savePath);
+  }
+
+  /// 生成一个尚未使用的截图文件路径（只创建目录，不写入文件）
+  ///
+  /// 用于原生端直接写文件的截图，例如循环截图的 QOI 快速存储
+  Future<String> createScreenshotPath({ImageFormat? format}) async {
+    final savePath = await _resolveSavePath();
+    await _ensureDirectoryExists(savePath);
+    final filename = await _generateFilename(format: format);
+    return path.normalize(path.join(savePath, filename));
+  }
+
+  /// 生成一个尚未使用的录屏文件路径（文件名格式前加 `recording_`，只创建目录）
+  Future<String> createRecordingPath(RecordingFormat format) async {
+    final savePath = await _resolveSavePath();
+    await _ensureDirectoryExists(savePath);
+    final filename = await _generateFilename(
+      customFormat: 'recording_${_settings.filenameFormat}',
+      fileExtension: format.extension,
+    );
+    return path.normalize(path.join(savePath, filename));
+  }
+
+  /// 循环截图分块增量存储的目录（保存目录下的 `delta_<任务ID>`，不存在时创建）
+  ///
+  /// 目录中是整帧（关键帧）、只含变化分块的透明补丁和 manifest.jsonl。
+  /// 这些文件不进入历史记录，历史条数上限不会删掉补丁依附的关键帧
+  Future<String> getDeltaDirectory(String taskId) async {
+    final directory = path.join(await _resolveSavePath(), 'delta_$taskId');
+    await _ensureDirectoryExists(directory);
+    return path.normalize(directory);
+  }
+
+  /// 在增量目录的 manifest.jsonl 末尾追加一行
+  Future<void> appendDeltaManifest(
+    String directory,
+    Map<String, dynamic> entry,
+  ) async {
+    await File(path.join(directory, 'manifest.jsonl')).writeAsString(
+      '${jsonEncode(entry)}\n',
+      mode: FileMode.append,
+      flush: true,
+    );
+  }
+
+  /// 查找保存目录中尚未转成 PNG 的 QOI 文件（上次退出前没转完）
+  Future<List<String>> findPendingQoiFiles() async {
+    try {
+      final dir = Directory(await _resolveSavePath());
+      if (!await dir.exists()) return [];
+      final files = <String>[];
+      await for (final entity in dir.list()) {
+        if (entity is File &&
+            path.extension(entity.path).toLowerCase() == '.qoi') {
+          files.add(path.normalize(entity.path));
+        }
+      }
+      return files;
+    } catch (e) {
+      debugPrint('Failed to list pending QOI files: $e');
+      return [];
+    }
+  }
+
   /// 获取截图历史记录
   ///
   /// [startDate] 开始日期（可选）
@@ -3,6 +3,7 @@ library;
 import 'dart:async';
 import 'package:flutter/foundation.dart';
 import '../models/recurring_screenshot_task.dart';
+import '../models/screenshot_models.dart';
 import '../screenshot_plugin.dart';
 
 /// 循环截图任务管理器
@@ -19,6 +20,12 @@ class RecurringTaskManager {
   /// 任务定时器映射（任务ID -> 定时器）
   final Map<String, Timer> _timers = {};
 
+  /// 交给原生调度器的任务（平台不支持时改用 [_timers]）
+  final Set<String> _nativeScheduled = {};
+
+  /// 每个任务最近一次保存的截图的感知哈希（近似重复过滤用，任务ID -> 哈希）
+  final Map<String, int> _keptHashes = {};
+
   /// 任务状态变化回调
   VoidCallback? _onTasksChanged;
 
@@ -58,6 +65,9 @@ class RecurringTaskManager {
     required int intervalSeconds,
     int? totalShots,
     String? saveDirectory,
+    bool fastStorage = false,
+    ChangeDetection changeDetection = ChangeDetection.off,
+    int? dedupDistance,
   }) {
     final task = RecurringScreenshotTask(
       id: DateTime.now().millisecondsSinceEpoch.toString(),
@@ -67,6 +77,9 @@ class RecurringTaskManager {
       intervalSeconds: intervalSeconds,
       totalShots: totalShots,
       saveDirectory: saveDirectory,
+      fastStorage: fastStorage,
+      changeDetection: changeDetection,
+      dedupDistance: dedupDistance,
       status: TaskStatus.running,
       createdAt: DateTime.now(),
     );
@@ -80,10 +93,68 @@ class RecurringTaskManager {
   }
 
   /// 启动任务
+  ///
+  /// 优先交给原生调度器（固定节拍，不受 Dart 事件循环影响），
+  /// 平台不支持时使用 Dart 定时器
   void _startTask(RecurringScreenshotTask task) {
-    // 如果已有定时器，先取消
-    _timers[task.id]?.cancel();
+    // 如果已有定时器或原生计划，先停止
+    _stopTask(task.id);
+    unawaited(_startScheduled(task));
+  }
 
+  Future<void> _startScheduled(RecurringScreenshotTask task) async {
+    final started = await _plugin.startNativeSchedule(
+      task,
+      onShot: (shot) => _onScheduledShot(task.id, shot),
+    );
+    // 等待期间任务可能已被暂停、删除或重新启动
+    final current = _getTask(task.id);
+    if (current == null ||
+        current.status != TaskStatus.running ||
+        _timers.containsKey(task.id)) {
+      if (started) unawaited(_plugin.stopNativeSchedule(task.id));
+      return;
+    }
+    if (started) {
+      _nativeScheduled.add(task.id);
+      debugPrint('TaskManager: Started task ${task.id} on native scheduler');
+      return;
+    }
+    _startTimer(task);
+  }
+
+  /// 原生调度的一次触发
+  void _onScheduledShot(String taskId, ScheduledShot shot) {
+    final task = _getTask(taskId);
+    if (task == null || !_nativeScheduled.contains(taskId)) return;
+
+    // 调度落后时跳过的触发也计入进度，与固定节拍保持一致
+    var completed = task.completedShots + 1 + shot.missed;
+    final totalShots = task.totalShots;
+    if (totalShots != null && completed > totalShots) completed = totalShots;
+    final captured = shot.status != ScheduledShotStatus.skipped;
+    final updated = task.copyWith(
+      completedShots: completed,
+      lastShotTime: captured ? shot.time ?? DateTime.now() : null,
+    );
+    _updateTaskState(taskId, updated);
+    unawaited(
+      _plugin.handleScheduledShot(updated, shot).catchError((Object e) {
+        debugPrint('TaskManager: Error handling shot of task $taskId: $e');
+      }),
+    );
+
+    if (shot.last || updated.isCompleted) {
+      debugPrint(
+        'TaskManager: Task $taskId completed (${updated.completedShots}/${updated.totalShots})',
+      );
+      _stopTask(taskId);
+      _updateTaskState(taskId, updated.copyWith(status: TaskStatus.completed));
+    }
+  }
+
+  /// 使用 Dart 定时器执行任务
+  void _startTimer(RecurringScreenshotTask task) {
     final timer = Timer.periodic(Duration(seconds: task.intervalSeconds), (
       timer,
     ) async {
@@ -99,11 +170,7 @@ class RecurringTaskManager {
 
       // 执行截图
       try {
-        if (currentTask.windowId != null && currentTask.windowId!.isNotEmpty) {
-          await _plugin.captureWindow(currentTask.windowId!);
-        } else {
-          await _plugin.captureFullScreen();
-        }
+        await _plugin.captureForRecurringTask(currentTask);
 
         // 使用最新任务状态更新计数
         _updateTaskState(
@@ -167,12 +234,34 @@ class RecurringTaskManager {
   void _stopTask(String taskId) {
     _timers[taskId]?.cancel();
     _timers.remove(taskId);
+    if (_nativeScheduled.remove(taskId)) {
+      unawaited(_plugin.stopNativeSchedule(taskId));
+    }
     debugPrint('TaskManager: Stopped task $taskId');
   }
 
+  /// 判断任务这一次截图是否应当保存
+  ///
+  /// 与上一次保存的截图的感知哈希汉明距离不超过
+  /// [RecurringScreenshotTask.dedupDistance] 时视为近似重复，返回 false；
+  /// 返回 true 时记下 [hash]，之后的截图和它比较。
+  /// 任务没有开启过滤或平台没有提供哈希时总是返回 true
+  bool acceptFrame(RecurringScreenshotTask task, int? hash) {
+    final threshold = task.dedupDistance;
+    if (threshold == null || hash == null) return true;
+    final kept = _keptHashes[task.id];
+    if (kept != null && hammingDistance(kept, hash) <= threshold) {
+      debugPrint('TaskManager: Task ${task.id} skipped a near-duplicate frame');
+      return false;
+    }
+    _keptHashes[task.id] = hash;
+    return true;
+  }
+
   /// 删除任务
   void deleteTask(String taskId) {
     _stopTask(taskId);
+    _keptHashes.remove(taskId);
     _tasks.removeWhere((t) => t.id == taskId);
     _notifyChanged();
     debugPrint('TaskManager: Deleted task $taskId');
@@ -207,6 +296,10 @@ class RecurringTaskManager {
       timer.cancel();
     }
     _timers.clear();
+    for (final taskId in _nativeScheduled) {
+      unawaited(_plugin.stopNativeSchedule(taskId));
+    }
+    _nativeScheduled.clear();
 
     // 将所有运行中的任务改为暂停状态
     for (var i = 0; i < _tasks.length; i++) {
@@ -252,6 +345,7 @@ class RecurringTaskManager {
   void dispose() {
     stopAll();
     _tasks.clear();
+    _keptHashes.clear();
     _onTasksChanged = null;
     debugPrint('TaskManager: Disposed');
   }
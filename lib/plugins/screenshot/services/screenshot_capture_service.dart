@@ -210,6 +210,8 @@ class ScreenshotCaptureService {
     try {
       switch (_settings.imageFormat) {
         case ImageFormat.png:
+        // QOI 只由原生端写出，Flutter 兜底路径按 PNG 编码
+        case ImageFormat.qoi:
           // PNG 是无损格式，不使用质量设置
           final pngBytes = img.encodePng(image);
           return Uint8List.fromList(pngBytes);
@@ -4,6 +4,7 @@ import 'dart:typed_data';
 import 'package:flutter/foundation.dart';
 import 'package:flutter/widgets.dart';
 import '../models/screenshot_models.dart';
+import '../models/screenshot_settings.dart';
 import '../platform/screenshot_platform_interface.dart';
 import 'screenshot_capture_service.dart';
 
@@ -60,6 +61,19 @@ class ScreenshotService {
     return await _flutterCaptureService?.captureRegion(rect);
   }
 
+  /// 捕获原生区域选择窗口刚确认的区域（优先从冻结画面裁剪）
+  Future<Uint8List?> captureSelectedRegion(Rect rect) async {
+    if (!isAvailable) {
+      throw UnsupportedError('Screenshot is not supported on this platform');
+    }
+
+    if (_platformService.isAvailable) {
+      return await _platformService.captureSelectedRegion(rect);
+    }
+
+    return await _flutterCaptureService?.captureRegion(rect);
+  }
+
   /// 捕获指定窗口截图
   Future<Uint8List?> captureWindow(String windowId) async {
     if (!isAvailable) {
@@ -76,6 +90,17 @@ class ScreenshotService {
     );
   }
 
+  /// 一次捕获多个窗口（可缩小为缩略图）；平台不支持时返回空 map
+  Future<Map<String, WindowCapture>> captureWindows(
+    List<String> windowIds, {
+    int? maxSize,
+  }) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return {};
+    }
+    return await _platformService.captureWindows(windowIds, maxSize: maxSize);
+  }
+
   /// 获取所有可用窗口列表
   Future<List<WindowInfo>> getAvailableWindows() async {
     if (!isAvailable) {
@@ -85,6 +110,14 @@ class ScreenshotService {
     return await _platformService.getAvailableWindows();
   }
 
+  /// 实时窗口列表：先是完整列表，之后只有变化；平台不支持时为空流
+  Stream<WindowListChange> watchWindows() {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return const Stream.empty();
+    }
+    return _platformService.watchWindows();
+  }
+
   /// 获取主屏幕尺寸
   Future<Rect?> getPrimaryScreenSize() async {
     if (!isAvailable) {
@@ -100,6 +133,214 @@ class ScreenshotService {
     return await _flutterCaptureService?.getPrimaryScreenSize();
   }
 
+  /// 两阶段截图：像素进入内存后立即返回句柄，编码在后台完成
+  ///
+  /// 只有平台实现支持；返回 null 时调用方退回一次性的 capture 方法。
+  /// [encodeOptions] 只对本次截图生效（例如循环截图的 QOI 快速存储），
+  /// [changeTracking] 让原生端跳过未变化的帧或只编码变化的分块
+  Future<PendingCapture?> beginCapture(
+    CaptureRequest request, {
+    String? savePath,
+    bool deferEncode = false,
+    EncodeOptions? encodeOptions,
+    ChangeTracking? changeTracking,
+  }) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.beginCapture(
+      request,
+      savePath: savePath,
+      deferEncode: deferEncode,
+      encodeOptions: encodeOptions,
+      changeTracking: changeTracking,
+    );
+  }
+
+  /// 获取编码完成前的原始帧预览
+  Future<FramePreview?> getFramePreview(int handle, {int? maxDimension}) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.getFramePreview(
+      handle,
+      maxDimension: maxDimension,
+    );
+  }
+
+  /// 取消帧的后台编码
+  Future<bool> cancelEncode(int handle) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.cancelEncode(handle);
+  }
+
+  /// 开始编码暂存的帧（beginCapture 时 deferEncode 为 true）
+  Future<bool> encodeFrame(int handle) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.encodeFrame(handle);
+  }
+
+  /// 把编码完成前的原始帧注册为原生外部纹理
+  Future<FrameTexture?> createFrameTexture(
+    int handle, {
+    int? maxDimension,
+  }) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.createFrameTexture(
+      handle,
+      maxDimension: maxDimension,
+    );
+  }
+
+  /// 释放预览纹理
+  Future<bool> disposeFrameTexture(int textureId) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.disposeFrameTexture(textureId);
+  }
+
+  /// 空闲时把 QOI 文件转成 PNG，转码结束时完成；成功返回 true
+  Future<bool> transcodeWhenIdle(String source, String target) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.transcodeWhenIdle(source, target);
+  }
+
+  /// 丢弃循环任务的变化检测参考帧
+  Future<void> resetChangeDetection(String key) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return;
+    }
+    await _platformService.resetChangeDetection(key);
+  }
+
+  /// 在原生端开始循环截图计划；平台不支持时返回 false
+  Future<bool> startRecurringSchedule(
+    RecurringSchedule schedule,
+    void Function(ScheduledShot shot) onShot,
+  ) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.startRecurringSchedule(schedule, onShot);
+  }
+
+  /// 停止循环任务的原生计划
+  Future<void> stopRecurringSchedule(String taskId) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return;
+    }
+    await _platformService.stopRecurringSchedule(taskId);
+  }
+
+  /// 开始区域录屏；平台不支持时返回 false
+  Future<bool> startRecording(RecordingRequest request) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.startRecording(request);
+  }
+
+  /// 停止录屏，返回写好的文件；失败时返回 null
+  Future<RecordingResult?> stopRecording(RecordingRequest request) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.stopRecording(request);
+  }
+
+  /// 开始即时回放；平台不支持时返回 false
+  Future<bool> startInstantReplay(
+    InstantReplayRequest request,
+    void Function(RecordingResult? result) onHotkeySave,
+  ) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return false;
+    }
+    return await _platformService.startInstantReplay(request, onHotkeySave);
+  }
+
+  /// 停止即时回放并释放缓冲
+  Future<void> stopInstantReplay() async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return;
+    }
+    await _platformService.stopInstantReplay();
+  }
+
+  /// 保存最近的画面；没有在运行或失败时返回 null
+  Future<RecordingResult?> saveInstantReplay({String? path}) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.saveInstantReplay(path: path);
+  }
+
+  /// 即时回放的运行开销；没有在运行时返回 null
+  Future<InstantReplayStats?> getInstantReplayStats() async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.getInstantReplayStats();
+  }
+
+  /// 长截图（滚动拼接）；平台不支持或失败时返回 null
+  Future<ScrollCaptureResult?> captureScrolling(
+    ScrollCaptureRequest request,
+  ) async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.captureScrolling(request);
+  }
+
+  /// 获取所有显示器
+  Future<List<MonitorInfo>> getMonitors() async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return [];
+    }
+    return await _platformService.getMonitors();
+  }
+
+  /// 捕获整个虚拟桌面（所有显示器）
+  Future<VirtualDesktopCapture?> captureVirtualDesktop() async {
+    if (!isAvailable) {
+      throw UnsupportedError('Screenshot is not supported on this platform');
+    }
+    // 只有平台实现支持多显示器截图
+    if (!_platformService.isAvailable) {
+      return null;
+    }
+    return await _platformService.captureVirtualDesktop();
+  }
+
+  /// 分别捕获每个显示器
+  Future<List<MonitorCapture>> captureMonitors() async {
+    if (!isAvailable) {
+      throw UnsupportedError('Screenshot is not supported on this platform');
+    }
+    if (!_platformService.isAvailable) {
+      return [];
+    }
+    return await _platformService.captureMonitors();
+  }
+
+  /// 取消排队中的截图请求（例如插件关闭时），返回受影响的请求数
+  Future<int> cancelPendingCaptures() async {
+    if (!isAvailable || !_platformService.isAvailable) {
+      return 0;
+    }
+    return await _platformService.cancelPendingCaptures();
+  }
+
   /// 更新设置
   ///
   /// 将设置传递给平台服务（如果可用）和 Flutter 捕获服务
@@ -107,8 +348,12 @@ class ScreenshotService {
     // 更新 Flutter 捕获服务的设置
     _flutterCaptureService?.updateSettings(settings);
 
-    // 注意：平台服务的设置更新通过平台通道处理
-    // 这里不需要额外调用，因为平台实现会直接读取配置
+    // 原生端按设置的格式和质量编码，不在 Dart 中重新编码
+    if (settings is ScreenshotSettings) {
+      _platformService.updateEncodeOptions(
+        EncodeOptions.fromSettings(settings),
+      );
+    }
   }
 
   /// 设置 Flutter 截图捕获服务的 context
@@ -0,0 +1,75 @@
+library;
+
+import 'package:flutter/material.dart';
+import '../screenshot_plugin.dart';
+import '../models/screenshot_models.dart';
+
+/// 用原生外部纹理显示尚未编码的截图
+///
+/// 原始帧在原生端转成 RGBA 后注册为纹理，预览不经过 PNG 编码、
+/// 跨通道传输和解码；纹理随组件销毁释放。平台不支持时显示占位进度条。
+class FrameTexturePreview extends StatefulWidget {
+  final ScreenshotPlugin plugin;
+  final PendingCapture capture;
+
+  /// 纹理长边上限，null 表示原尺寸
+  final int? maxDimension;
+
+  const FrameTexturePreview({
+    super.key,
+    required this.plugin,
+    required this.capture,
+    this.maxDimension,
+  });
+
+  @override
+  State<FrameTexturePreview> createState() => _FrameTexturePreviewState();
+}
+
+class _FrameTexturePreviewState extends State<FrameTexturePreview> {
+  FrameTexture? _texture;
+
+  @override
+  void initState() {
+    super.initState();
+    _createTexture();
+  }
+
+  Future<void> _createTexture() async {
+    final texture = await widget.plugin.createFrameTexture(
+      widget.capture.handle,
+      maxDimension: widget.maxDimension,
+    );
+    if (texture == null) return;
+    // 纹理注册完成前组件已销毁：立即释放
+    if (!mounted) {
+      await widget.plugin.disposeFrameTexture(texture.textureId);
+      return;
+    }
+    setState(() {
+      _texture = texture;
+    });
+  }
+
+  @override
+  void dispose() {
+    final texture = _texture;
+    if (texture != null) {
+      widget.plugin.disposeFrameTexture(texture.textureId);
+    }
+    super.dispose();
+  }
+
+  @override
+  Widget build(BuildContext context) {
+    final texture = _texture;
+    final width = texture?.width ?? widget.capture.width;
+    final height = texture?.height ?? widget.capture.height;
+    return AspectRatio(
+      aspectRatio: height > 0 ? width / height : 16 / 9,
+      child: texture != null
+          ? Texture(textureId: texture.textureId)
+          : const Center(child: LinearProgressIndicator()),
+    );
+  }
+}
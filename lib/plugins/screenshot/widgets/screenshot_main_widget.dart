@@ -11,6 +11,7 @@ import '../services/clipboard_service.dart';
 import 'settings_screen.dart';
 import 'history_screen.dart';
 import 'window_capture_screen.dart';
+import 'frame_texture_preview.dart';
 
 /// 智能截图插件主界面
 class ScreenshotMainWidget extends StatefulWidget {
@@ -23,6 +24,9 @@ class ScreenshotMainWidget extends StatefulWidget {
 }
 
 class _ScreenshotMainWidgetState extends State<ScreenshotMainWidget> {
+  // 正在编码的截图预览纹理的长边上限
+  static const int _pendingPreviewDimension = 640;
+
   @override
   Widget build(BuildContext context) {
     final theme = Theme.of(context);
@@ -186,6 +190,30 @@ class _ScreenshotMainWidgetState extends State<ScreenshotMainWidget> {
                     onTap: widget.plugin.isAvailable ? _showWindowList : null,
                   ),
                 ),
+                const SizedBox(width: 12),
+                Expanded(
+                  child: _QuickActionTile(
+                    icon: widget.plugin.isRecording
+                        ? Icons.stop_circle
+                        : Icons.fiber_manual_record,
+                    title: widget.plugin.isRecording
+                        ? l10n.screenshot_main_stop_recording
+                        : l10n.screenshot_main_record_region,
+                    subtitle: '',
+                    onTap: widget.plugin.isAvailable ? _toggleRecording : null,
+                  ),
+                ),
+                const SizedBox(width: 12),
+                Expanded(
+                  child: _QuickActionTile(
+                    icon: Icons.unfold_more,
+                    title: l10n.screenshot_main_scrolling_capture,
+                    subtitle: '',
+                    onTap: widget.plugin.isAvailable
+                        ? _captureScrolling
+                        : null,
+                  ),
+                ),
               ],
             ),
           ],
@@ -236,6 +264,22 @@ class _ScreenshotMainWidgetState extends State<ScreenshotMainWidget> {
               ],
             ),
             const SizedBox(height: 16),
+            // 刚捕获、正在后台编码的截图：直接显示原生纹理
+            if (widget.plugin.pendingCapture != null)
+              Padding(
+                padding: const EdgeInsets.only(bottom: 16.0),
+                child: Center(
+                  child: ConstrainedBox(
+                    constraints: const BoxConstraints(maxHeight: 160),
+                    child: FrameTexturePreview(
+                      key: ValueKey(widget.plugin.pendingCapture!.handle),
+                      plugin: widget.plugin,
+                      capture: widget.plugin.pendingCapture!,
+                      maxDimension: _pendingPreviewDimension,
+                    ),
+                  ),
+                ),
+              ),
             if (screenshots.isEmpty)
               Center(
                 child: Padding(
@@ -363,6 +407,47 @@ class _ScreenshotMainWidgetState extends State<ScreenshotMainWidget> {
     }
   }
 
+  /// 开始或停止区域录屏
+  void _toggleRecording() async {
+    final l10n = AppLocalizations.of(context)!;
+    if (!widget.plugin.isRecording) {
+      await widget.plugin.recordSelectedRegion();
+      if (mounted) setState(() {});
+      return;
+    }
+    final result = await widget.plugin.stopRecording();
+    if (!mounted) return;
+    setState(() {});
+    ScaffoldMessenger.of(context).showSnackBar(
+      SnackBar(
+        content: Text(
+          result != null
+              ? l10n.screenshot_recording_saved
+              : l10n.screenshot_recording_failed,
+        ),
+        duration: const Duration(seconds: 2),
+      ),
+    );
+  }
+
+  /// 选择区域后滚动截取长图
+  void _captureScrolling() async {
+    final l10n = AppLocalizations.of(context)!;
+    final result = await widget.plugin.captureScrolling();
+    if (!mounted) return;
+    setState(() {});
+    ScaffoldMessenger.of(context).showSnackBar(
+      SnackBar(
+        content: Text(
+          result != null
+              ? l10n.screenshot_scrolling_saved
+              : l10n.screenshot_scrolling_failed,
+        ),
+        duration: const Duration(seconds: 2),
+      ),
+    );
+  }
+
   /// 开始区域截图
   void _startRegionCapture() async {
     debugPrint('===== 开始区域截图 =====');
@@ -422,7 +507,7 @@ class _ScreenshotMainWidgetState extends State<ScreenshotMainWidget> {
         // 用户选择了区域
         final rect = result.toRect();
         debugPrint('开始捕获区域: $rect');
-        await widget.plugin.captureRegion(rect);
+        await widget.plugin.captureSelectedRegion(rect);
         debugPrint('区域捕获完成');
         return;
       }
@@ -7,6 +7,7 @@ import '../../../../ui/widgets/json_editor_screen.dart';
 import '../../../../ui/screens/path_placeholders_info_screen.dart';
 import '../../../../core/services/json_validator.dart';
 import '../config/screenshot_config_defaults.dart';
+import '../models/screenshot_models.dart' show InstantReplayStats;
 import '../models/screenshot_settings.dart';
 import '../screenshot_plugin.dart';
 
@@ -25,6 +26,7 @@ class _ScreenshotSettingsScreenState extends State<ScreenshotSettingsScreen> {
   late TextEditingController _savePathController;
   late TextEditingController _filenameFormatController;
   late ScreenshotSettings _settings;
+  int _replayStatsRefresh = 0;
 
   @override
   void initState() {
@@ -108,6 +110,13 @@ class _ScreenshotSettingsScreenState extends State<ScreenshotSettingsScreen> {
         const SizedBox(height: 8),
         _buildPinSettingsTiles(l10n),
 
+        const SizedBox(height: 24),
+
+        // 即时回放设置
+        _buildSectionHeader(l10n.screenshot_settings_section_replay),
+        const SizedBox(height: 8),
+        _buildInstantReplayTiles(l10n),
+
         const SizedBox(height: 32),
 
         // JSON 编辑器入口
@@ -330,6 +339,65 @@ class _ScreenshotSettingsScreenState extends State<ScreenshotSettingsScreen> {
     );
   }
 
+  /// 构建即时回放设置
+  Widget _buildInstantReplayTiles(AppLocalizations l10n) {
+    final replay = _settings.instantReplay;
+    return Column(
+      children: [
+        SwitchListTile(
+          secondary: const Icon(Icons.history),
+          title: Text(
+            l10n.screenshot_instant_replay_enable,
+            overflow: TextOverflow.ellipsis,
+          ),
+          subtitle: Text(
+            l10n.screenshot_instant_replay_desc(replay.seconds),
+            overflow: TextOverflow.ellipsis,
+            maxLines: 2,
+          ),
+          value: replay.enabled,
+          onChanged: (value) async {
+            final newSettings = _settings.copyWith(
+              instantReplay: replay.copyWith(enabled: value),
+            );
+            await widget.plugin.updateSettings(newSettings);
+            if (mounted) {
+              setState(() {
+                _settings = newSettings;
+              });
+              _showSuccessMessage();
+            }
+          },
+          contentPadding: EdgeInsets.zero,
+        ),
+        if (widget.plugin.isInstantReplayRunning)
+          // 运行开销，点击刷新
+          FutureBuilder<InstantReplayStats?>(
+            key: ValueKey(_replayStatsRefresh),
+            future: widget.plugin.getInstantReplayStats(),
+            builder: (context, snapshot) {
+              final stats = snapshot.data;
+              return ListTile(
+                leading: const Icon(Icons.speed),
+                title: Text(
+                  stats == null
+                      ? '-'
+                      : l10n.screenshot_instant_replay_stats(
+                          stats.cpuPercent.toStringAsFixed(1),
+                          (stats.memoryBytes / (1024 * 1024)).toStringAsFixed(1),
+                        ),
+                  overflow: TextOverflow.ellipsis,
+                ),
+                trailing: const Icon(Icons.refresh),
+                onTap: () => setState(() => _replayStatsRefresh++),
+                contentPadding: EdgeInsets.zero,
+              );
+            },
+          ),
+      ],
+    );
+  }
+
   /// 选择保存路径
   void _selectSavePath() {
     showDialog(
@@ -497,6 +565,8 @@ class _ScreenshotSettingsScreenState extends State<ScreenshotSettingsScreen> {
         return 'PNG';
       case ImageFormat.jpeg:
         return 'JPEG';
+      case ImageFormat.qoi:
+        return 'QOI';
     }
   }
 
@@ -507,6 +577,8 @@ class _ScreenshotSettingsScreenState extends State<ScreenshotSettingsScreen> {
         return l10n.screenshot_shortcut_region;
       case 'fullScreenCapture':
         return l10n.screenshot_shortcut_fullscreen;
+      case 'saveReplay':
+        return l10n.screenshot_shortcut_save_replay;
       default:
         return action;
     }
@@ -963,7 +1035,8 @@ class _ImageFormatDialog extends StatelessWidget {
       title: Text(l10n.screenshot_settings_format_title),
       content: Column(
         mainAxisSize: MainAxisSize.min,
-        children: ImageFormat.values.map((format) {
+        // QOI 只用于循环截图的快速存储，不提供给用户选择
+        children: ImageFormat.values.where((format) => format != ImageFormat.qoi).map((format) {
           return RadioListTile<ImageFormat>(
             title: Text(_formatName(format)),
             subtitle: Text(_formatDescription(format, l10n)),
@@ -987,6 +1060,8 @@ class _ImageFormatDialog extends StatelessWidget {
         return 'PNG';
       case ImageFormat.jpeg:
         return 'JPEG';
+      case ImageFormat.qoi:
+        return 'QOI';
     }
   }
 
@@ -996,6 +1071,8 @@ class _ImageFormatDialog extends StatelessWidget {
         return 'Lossless';
       case ImageFormat.jpeg:
         return 'Lossy, smaller';
+      case ImageFormat.qoi:
+        return 'Lossless, fast';
     }
   }
 }
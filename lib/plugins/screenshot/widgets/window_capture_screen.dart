@@ -21,6 +21,15 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
   /// 可用窗口列表
   List<WindowInfo> _windows = [];
 
+  /// 窗口缩略图（窗口 ID -> 截图），列表出来后一次批量获取，新窗口出现时补取
+  Map<String, WindowCapture> _thumbnails = {};
+
+  /// 每次刷新列表加一，丢弃过期的缩略图结果
+  int _loadGeneration = 0;
+
+  /// 实时窗口列表的订阅，原生端推送变化，不再重新枚举
+  StreamSubscription<WindowListChange>? _windowSubscription;
+
   /// 是否正在加载
   bool _isLoading = true;
 
@@ -30,7 +39,7 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
   @override
   void initState() {
     super.initState();
-    _loadWindows();
+    _watchWindows();
     // 每秒刷新一次任务状态，实时显示进度
     _startPeriodicRefresh();
   }
@@ -38,6 +47,7 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
   @override
   void dispose() {
     _refreshTimer?.cancel();
+    _windowSubscription?.cancel();
     super.dispose();
   }
 
@@ -52,8 +62,50 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
     });
   }
 
-  /// 加载窗口列表
+  /// 订阅实时窗口列表；刷新按钮重新订阅（原生端重新枚举一次）
+  void _watchWindows() {
+    _windowSubscription?.cancel();
+    _loadGeneration++;
+    setState(() {
+      _isLoading = true;
+    });
+    var received = false;
+    _windowSubscription = widget.plugin.watchWindows().listen(
+      (change) {
+        received = true;
+        if (mounted) _applyWindowChange(change);
+      },
+      onError: (Object e) {
+        debugPrint('Failed to watch windows: $e');
+        if (mounted) _loadWindows();
+      },
+      // 平台不支持实时列表时是空流，退回一次性枚举
+      onDone: () {
+        if (!received && mounted) _loadWindows();
+      },
+    );
+  }
+
+  void _applyWindowChange(WindowListChange change) {
+    if (change.reset) {
+      _loadGeneration++;
+    }
+    setState(() {
+      _windows = change.applyTo(_windows);
+      if (change.reset) {
+        _thumbnails = {};
+      } else if (change.removed.isNotEmpty) {
+        _thumbnails = Map.of(_thumbnails)
+          ..removeWhere((id, _) => change.removed.contains(id));
+      }
+      _isLoading = false;
+    });
+    unawaited(_loadThumbnails(change.added, _loadGeneration));
+  }
+
+  /// 一次性加载窗口列表
   Future<void> _loadWindows() async {
+    final generation = ++_loadGeneration;
     setState(() {
       _isLoading = true;
     });
@@ -65,6 +117,7 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
           _windows = windows;
           _isLoading = false;
         });
+        unawaited(_loadThumbnails(windows, generation));
       }
     } catch (e) {
       if (mounted) {
@@ -150,6 +203,9 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
         intervalSeconds: result.intervalSeconds,
         totalShots: result.totalShots,
         saveDirectory: result.saveDirectory,
+        fastStorage: result.fastStorage,
+        changeDetection: result.changeDetection,
+        dedupDistance: result.dedupDistance,
       );
 
       // 手动刷新 UI
@@ -207,7 +263,7 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
                         ),
                         IconButton(
                           icon: const Icon(Icons.refresh),
-                          onPressed: _loadWindows,
+                          onPressed: _watchWindows,
                           tooltip: l10n.screenshot_refresh,
                         ),
                       ],
@@ -275,7 +331,7 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
                             itemBuilder: (context, index) {
                               final window = _windows[index];
                               return ListTile(
-                                leading: _buildWindowIcon(window),
+                                leading: _buildWindowLeading(window),
                                 title: Text(
                                   window.title,
                                   maxLines: 2,
@@ -405,6 +461,44 @@ class _WindowCaptureScreenState extends State<WindowCaptureScreen> {
     );
   }
 
+  /// 一次调用取回一批窗口的缩略图（原生端并行截取），合并到已有的缩略图中
+  Future<void> _loadThumbnails(List<WindowInfo> windows, int generation) async {
+    if (windows.isEmpty) return;
+    try {
+      final thumbnails = await widget.plugin.captureWindowThumbnails(
+        windows.map((w) => w.id).toList(),
+      );
+      if (mounted && generation == _loadGeneration) {
+        setState(() {
+          _thumbnails = {..._thumbnails, ...thumbnails};
+        });
+      }
+    } catch (e) {
+      debugPrint('Failed to load window thumbnails: $e');
+    }
+  }
+
+  /// 构建窗口缩略图，还没有取到或截取失败时显示图标
+  Widget _buildWindowLeading(WindowInfo window) {
+    final thumbnail = _thumbnails[window.id];
+    if (thumbnail == null) {
+      return _buildWindowIcon(window);
+    }
+    return ClipRRect(
+      borderRadius: BorderRadius.circular(4),
+      child: Image.memory(
+        thumbnail.bytes,
+        width: 64,
+        height: 40,
+        fit: BoxFit.contain,
+        gaplessPlayback: true,
+        errorBuilder: (context, error, stackTrace) {
+          return _buildWindowIcon(window);
+        },
+      ),
+    );
+  }
+
   /// 构建窗口图标
   Widget _buildWindowIcon(WindowInfo window) {
     if (window.icon != null && window.icon!.isNotEmpty) {
@@ -557,6 +651,9 @@ class _CreateTaskDialogState extends State<_CreateTaskDialog> {
 
   bool _isInfinite = false;
   bool _useDefaultDirectory = true;
+  bool _fastStorage = false;
+  ChangeDetection _changeDetection = ChangeDetection.off;
+  int? _dedupDistance;
 
   @override
   void initState() {
@@ -732,6 +829,81 @@ class _CreateTaskDialogState extends State<_CreateTaskDialog> {
                     suffixIcon: const Icon(Icons.folder_open),
                   ),
                 ),
+              const SizedBox(height: 8),
+              // 快速存储（高频截图时每次只写 QOI，空闲时转 PNG）
+              Row(
+                children: [
+                  Checkbox(
+                    value: _fastStorage,
+                    onChanged: (value) {
+                      setState(() {
+                        _fastStorage = value!;
+                      });
+                    },
+                  ),
+                  Flexible(child: Text(l10n.screenshot_fast_storage)),
+                ],
+              ),
+              const SizedBox(height: 8),
+              // 变化检测（画面没变时不保存，或只保存变化的分块）
+              DropdownButtonFormField<ChangeDetection>(
+                initialValue: _changeDetection,
+                decoration: InputDecoration(
+                  labelText: l10n.screenshot_change_detection,
+                  border: const OutlineInputBorder(),
+                ),
+                items: [
+                  DropdownMenuItem(
+                    value: ChangeDetection.off,
+                    child: Text(l10n.screenshot_change_detection_off),
+                  ),
+                  DropdownMenuItem(
+                    value: ChangeDetection.skipUnchanged,
+                    child: Text(l10n.screenshot_change_detection_skip),
+                  ),
+                  DropdownMenuItem(
+                    value: ChangeDetection.dirtyTiles,
+                    child: Text(l10n.screenshot_change_detection_tiles),
+                  ),
+                ],
+                onChanged: (value) {
+                  setState(() {
+                    _changeDetection = value!;
+                  });
+                },
+              ),
+              const SizedBox(height: 16),
+              // 近似重复过滤（感知哈希的汉明距离阈值）
+              DropdownButtonFormField<int?>(
+                initialValue: _dedupDistance,
+                decoration: InputDecoration(
+                  labelText: l10n.screenshot_dedup,
+                  border: const OutlineInputBorder(),
+                ),
+                items: [
+                  DropdownMenuItem(
+                    value: null,
+                    child: Text(l10n.screenshot_dedup_off),
+                  ),
+                  DropdownMenuItem(
+                    value: 2,
+                    child: Text(l10n.screenshot_dedup_strict),
+                  ),
+                  DropdownMenuItem(
+                    value: 5,
+                    child: Text(l10n.screenshot_dedup_normal),
+                  ),
+                  DropdownMenuItem(
+                    value: 10,
+                    child: Text(l10n.screenshot_dedup_loose),
+                  ),
+                ],
+                onChanged: (value) {
+                  setState(() {
+                    _dedupDistance = value;
+                  });
+                },
+              ),
             ],
           ),
         ),
@@ -776,6 +948,9 @@ class _CreateTaskDialogState extends State<_CreateTaskDialog> {
       intervalSeconds: intervalSeconds,
       totalShots: _isInfinite ? null : int.parse(_totalShotsController.text),
       saveDirectory: _useDefaultDirectory ? null : _directoryController.text,
+      fastStorage: _fastStorage,
+      changeDetection: _changeDetection,
+      dedupDistance: _dedupDistance,
       status: TaskStatus.running,
       createdAt: DateTime.now(),
     );
@@ -0,0 +1,50 @@
+#include "frame_texture.h"
+
+#include <utility>
+
+struct _FrameTexture {
+  FlPixelBufferTexture parent_instance;
+  // GObject 实例不会调用 C++ 构造函数，像素用指针持有
+  capture_core::FrameBuffer* pixels;
+};
+
+G_DEFINE_TYPE(FrameTexture, frame_texture, fl_pixel_buffer_texture_get_type())
+
+// 光栅线程调用；像素在纹理存活期间不变，直接借出
+static gboolean frame_texture_copy_pixels(FlPixelBufferTexture* texture,
+                                          const uint8_t** buffer,
+                                          uint32_t* width, uint32_t* height,
+                                          GError** error) {
+  FrameTexture* self = FRAME_TEXTURE(texture);
+  *buffer = self->pixels->data();
+  *width = static_cast<uint32_t>(self->pixels->width());
+  *height = static_cast<uint32_t>(self->pixels->height());
+  return TRUE;
+}
+
+static void frame_texture_finalize(GObject* object) {
+  FrameTexture* self = FRAME_TEXTURE(object);
+  delete self->pixels;
+  self->pixels = nullptr;
+  G_OBJECT_CLASS(frame_texture_parent_class)->finalize(object);
+}
+
+static void frame_texture_class_init(FrameTextureClass* klass) {
+  G_OBJECT_CLASS(klass)->finalize = frame_texture_finalize;
+  FL_PIXEL_BUFFER_TEXTURE_CLASS(klass)->copy_pixels = frame_texture_copy_pixels;
+}
+
+static void frame_texture_init(FrameTexture* self) {
+  self->pixels = nullptr;
+}
+
+FrameTexture* frame_texture_new(capture_core::FrameBuffer rgba) {
+  if (rgba.empty() || rgba.format() != capture_core::PixelFormat::kRgba8 ||
+      rgba.stride() != rgba.width() * 4) {
+    return nullptr;
+  }
+  FrameTexture* self =
+      FRAME_TEXTURE(g_object_new(frame_texture_get_type(), nullptr));
+  self->pixels = new capture_core::FrameBuffer(std::move(rgba));
+  return self;
+}
@@ -0,0 +1,20 @@
+#ifndef RUNNER_FRAME_TEXTURE_H_
+#define RUNNER_FRAME_TEXTURE_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+#include "capture_core/frame_buffer.h"
+
+// 截图预览用的外部纹理：持有一帧 kRgba8 像素（行间无填充），
+// 注册到 FlTextureRegistrar 后 Dart 端用 Texture(textureId) 直接显示，
+// 不再经过 PNG 编码、跨通道传输和解码。
+G_DECLARE_FINAL_TYPE(FrameTexture,
+                     frame_texture,
+                     FRAME,
+                     TEXTURE,
+                     FlPixelBufferTexture)
+
+// 取得 rgba 的所有权；格式不对或帧为空时返回 nullptr
+FrameTexture* frame_texture_new(capture_core::FrameBuffer rgba);
+
+#endif  // RUNNER_FRAME_TEXTURE_H_
@@ -0,0 +1,1718 @@
+#include "screenshot_channel.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "capture_core/batch_capture.h"
+#include "capture_core/capture_pipeline.h"
+#include "capture_core/capture_scheduler.h"
+#include "capture_core/encode_queue.h"
+#include "capture_core/idle_transcoder.h"
+#include "capture_core/job_queue.h"
+#include "capture_core/jpeg_encoder.h"
+#include "capture_core/monitor_info.h"
+#include "capture_core/multi_monitor_capture.h"
+#include "capture_core/perceptual_hash.h"
+#include "capture_core/pixel_convert.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/qoi_codec.h"
+#include "capture_core/replay_buffer.h"
+#include "capture_core/screen_recorder.h"
+#include "capture_core/tile_change_detector.h"
+#include "capture_core/window_list.h"
+#ifdef CAPTURE_CORE_HAS_X11
+#include "capture_core/x11_monitors.h"
+#include "capture_core/x11_shm_frame_source.h"
+#include "capture_core/x11_window_tracker.h"
+#include "capture_core/x11_windows.h"
+#endif
+#include "frame_texture.h"
+
+// Xlib 连接不是线程安全的，截图来源只在唯一的工作线程上使用
+// （多显示器截图时每个显示器有自己的连接，由线程池并行抓取）
+static constexpr int kCaptureWorkerCount = 1;
+// 最多排队的请求数，超出时回复 BUSY
+static constexpr size_t kMaxPendingCaptures = 4;
+// 两阶段截图的编码线程数（PngEncoder 自己在共享线程池上并行）和最多排队的帧数
+static constexpr int kEncodeWorkerCount = 1;
+static constexpr size_t kMaxPendingEncodes = 4;
+// 最近一次截图请求之后安静多久才开始把 QOI 转成 PNG
+static constexpr std::chrono::milliseconds kTranscodeIdleDelay(5000);
+// getFramePreview 默认的预览长边
+static constexpr int kDefaultPreviewDimension = 1024;
+
+struct ScheduledTask;
+
+struct _ScreenshotChannel {
+  FlMethodChannel* channel;
+#ifdef CAPTURE_CORE_HAS_X11
+  // 延迟创建，共享内存段在多次截图之间复用（仅工作线程访问）
+  std::unique_ptr<capture_core::X11ShmFrameSource> source;
+  // 每个显示器一个连接和共享内存段，显示器布局变化时重建（仅工作线程访问）
+  std::unique_ptr<capture_core::MultiMonitorCapture> monitors;
+  // 窗口选择器的实时窗口列表（startWindowTracking / stopWindowTracking，仅主线程启停），
+  // 有自己的 X11 连接和事件线程，变化通过 onWindowsChanged 推送
+  std::unique_ptr<capture_core::X11WindowTracker> window_tracker;
+#endif
+  // 同步截图用的编码器（仅工作线程访问），按请求的 format 选择
+  capture_core::PngEncoder encoder;
+  capture_core::JpegEncoder jpeg_encoder;
+  capture_core::QoiEncoder qoi_encoder;
+  // 两阶段截图的编码阶段：beginCapture 拿到像素就回复帧句柄，
+  // 编码（和可选的保存）完成后通过 onEncodeComplete 通知 Dart
+  std::unique_ptr<capture_core::EncodeQueue> encodes;
+  // 循环截图快速存储的 QOI 文件在截图空闲时转成 PNG（transcodeWhenIdle），
+  // 完成后通过 onTranscodeComplete 通知 Dart
+  std::unique_ptr<capture_core::IdleTranscoder> transcoder;
+  // 循环截图的分块变化检测，按任务 id（changeKey）保存参考帧的分块哈希
+  capture_core::ChangeTracker changes;
+  // 截图预览的外部纹理，按纹理 id 索引（工作线程注册，主线程注销）
+  FlTextureRegistrar* texture_registrar;
+  std::mutex textures_mutex;
+  std::unordered_map<int64_t, FlTexture*> textures;
+  // 循环截图的原生计划，按任务 id 登记（startSchedule / stopSchedule）
+  std::mutex schedules_mutex;
+  std::unordered_map<std::string, std::shared_ptr<ScheduledTask>> schedules;
+  // 区域录屏（startRecording / stopRecording，仅主线程访问），同一时间只有一段；
+  // 录屏器有自己的 X11 连接，采集和编码在它自己的线程上
+  std::shared_ptr<capture_core::ScreenRecorder> recorder;
+  // 即时回放（startInstantReplay / stopInstantReplay，仅主线程访问）：后台低帧率采集，
+  // 最近一段画面压缩在内存中；saveInstantReplay 在工作线程写文件，持有自己的引用
+  std::shared_ptr<capture_core::InstantReplay> replay;
+  std::string replay_directory;
+  capture_core::AnimationFormat replay_format = capture_core::AnimationFormat::kApng;
+  // 先停掉工作线程再释放来源和编码器
+  std::unique_ptr<capture_core::JobQueue> jobs;
+  // 最后声明，最先析构：调度线程向 jobs 提交截图，要在 jobs 之前停止
+  std::unique_ptr<capture_core::CaptureScheduler> scheduler;
+};
+
+// 工作线程的结果，通过 g_idle_add 交回主线程回复
+typedef struct {
+  FlMethodCall* method_call;
+  // 成功时的结果（持有引用）
+  FlValue* result;
+  // 为 nullptr 表示成功；指向静态字符串
+  const gchar* error_code;
+  const gchar* error_message;
+} CaptureCompletion;
+
+static gboolean complete_capture_cb(gpointer user_data) {
+  CaptureCompletion* completion = static_cast<CaptureCompletion*>(user_data);
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (completion->error_code != nullptr) {
+    response = FL_METHOD_RESPONSE(fl_method_error_response_new(
+        completion->error_code, completion->error_message, nullptr));
+  } else {
+    response = FL_METHOD_RESPONSE(
+        fl_method_success_response_new(completion->result));
+  }
+
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(completion->method_call, response, &error)) {
+    g_warning("Failed to send screenshot response: %s", error->message);
+  }
+  g_object_unref(completion->method_call);
+  g_clear_pointer(&completion->result, fl_value_unref);
+  delete completion;
+  return G_SOURCE_REMOVE;
+}
+
+// 在主线程上回复；可以从任意线程调用。result 的引用转交给回复
+static void post_completion(FlMethodCall* method_call, FlValue* result,
+                            const gchar* error_code,
+                            const gchar* error_message) {
+  CaptureCompletion* completion = new CaptureCompletion{
+      FL_METHOD_CALL(g_object_ref(method_call)), result, error_code,
+      error_message};
+  g_idle_add(complete_capture_cb, completion);
+}
+
+static void post_error(FlMethodCall* method_call, const gchar* error_code,
+                       const gchar* error_message) {
+  post_completion(method_call, nullptr, error_code, error_message);
+}
+
+// 编码、转码结束的通知，通过 g_idle_add 交回主线程推送给 Dart
+typedef struct {
+  FlMethodChannel* channel;
+  // 指向静态字符串
+  const gchar* method;
+  FlValue* args;
+} DartNotification;
+
+static gboolean notify_dart_cb(gpointer user_data) {
+  DartNotification* notification = static_cast<DartNotification*>(user_data);
+  fl_method_channel_invoke_method(notification->channel, notification->method,
+                                  notification->args, nullptr, nullptr, nullptr);
+  g_object_unref(notification->channel);
+  fl_value_unref(notification->args);
+  delete notification;
+  return G_SOURCE_REMOVE;
+}
+
+static FlValue* bytes_value(const std::vector<uint8_t>& bytes) {
+  return fl_value_new_uint8_list(bytes.data(), bytes.size());
+}
+
+// 显示器几何信息，与 Windows 端的字段一致
+static FlValue* monitor_value(const capture_core::MonitorInfo& monitor) {
+  FlValue* map = fl_value_new_map();
+  fl_value_set_string_take(map, "index", fl_value_new_int(monitor.index));
+  fl_value_set_string_take(map, "x", fl_value_new_int(monitor.bounds.x));
+  fl_value_set_string_take(map, "y", fl_value_new_int(monitor.bounds.y));
+  fl_value_set_string_take(map, "width", fl_value_new_int(monitor.bounds.width));
+  fl_value_set_string_take(map, "height", fl_value_new_int(monitor.bounds.height));
+  fl_value_set_string_take(map, "primary", fl_value_new_bool(monitor.primary));
+  fl_value_set_string_take(map, "name", fl_value_new_string(monitor.name.c_str()));
+  return map;
+}
+
+// 窗口 id 使用 X11 窗口的十六进制形式，与 xwininfo / xprop 一致
+static std::string window_id_string(uint64_t id) {
+  gchar buffer[32];
+  g_snprintf(buffer, sizeof(buffer), "0x%" G_GINT64_MODIFIER "x", static_cast<guint64>(id));
+  return buffer;
+}
+
+// 窗口信息，与 Windows 端 getAvailableWindows / startWindowTracking 的字段一致
+static FlValue* window_value(const capture_core::WindowRecord& window) {
+  FlValue* map = fl_value_new_map();
+  fl_value_set_string_take(map, "id", fl_value_new_string(window_id_string(window.id).c_str()));
+  fl_value_set_string_take(map, "title", fl_value_new_string(window.title.c_str()));
+  if (!window.app_name.empty()) {
+    fl_value_set_string_take(map, "appName", fl_value_new_string(window.app_name.c_str()));
+  }
+  if (!window.icon.empty()) {
+    fl_value_set_string_take(map, "icon", bytes_value(window.icon));
+  }
+  fl_value_set_string_take(map, "x", fl_value_new_int(window.bounds.x));
+  fl_value_set_string_take(map, "y", fl_value_new_int(window.bounds.y));
+  fl_value_set_string_take(map, "width", fl_value_new_int(window.bounds.width));
+  fl_value_set_string_take(map, "height", fl_value_new_int(window.bounds.height));
+  return map;
+}
+
+static FlValue* window_list_value(const std::vector<capture_core::WindowRecord>& windows) {
+  FlValue* list = fl_value_new_list();
+  for (const auto& window : windows) {
+    fl_value_append_take(list, window_value(window));
+  }
+  return list;
+}
+
+// window_id_string 的逆过程，也接受十进制
+static bool parse_window_id(FlValue* value, uint64_t* id) {
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_STRING) {
+    return false;
+  }
+  const gchar* text = fl_value_get_string(value);
+  gchar* end = nullptr;
+  guint64 parsed = g_ascii_strtoull(text, &end, 0);
+  if (end == text || *end != '\0' || parsed == 0) {
+    return false;
+  }
+  *id = parsed;
+  return true;
+}
+
+static FlValue* monitor_list_value(const std::vector<capture_core::MonitorInfo>& monitors) {
+  FlValue* list = fl_value_new_list();
+  for (const auto& monitor : monitors) {
+    fl_value_append_take(list, monitor_value(monitor));
+  }
+  return list;
+}
+
+static void respond_error(FlMethodCall* method_call, const gchar* code,
+                          const gchar* message) {
+  g_autoptr(FlMethodResponse) response =
+      FL_METHOD_RESPONSE(fl_method_error_response_new(code, message, nullptr));
+  g_autoptr(GError) error = nullptr;
+  if (!fl_method_call_respond(method_call, response, &error)) {
+    g_warning("Failed to send screenshot response: %s", error->message);
+  }
+}
+
+static bool read_int_arg(FlValue* args, const gchar* key, int* value) {
+  FlValue* v = fl_value_lookup_string(args, key);
+  if (v == nullptr || fl_value_get_type(v) != FL_VALUE_TYPE_INT) {
+    return false;
+  }
+  *value = static_cast<int>(fl_value_get_int(v));
+  return true;
+}
+
+// 读取编码格式参数：format 为 "png"（默认）、"jpeg" 或 "qoi"，quality 为 JPEG 质量 1-100
+static capture_core::EncodeOptions read_encode_options(FlValue* args) {
+  capture_core::EncodeOptions options;
+  if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    return options;
+  }
+  FlValue* format = fl_value_lookup_string(args, "format");
+  if (format != nullptr && fl_value_get_type(format) == FL_VALUE_TYPE_STRING) {
+    if (g_strcmp0(fl_value_get_string(format), "jpeg") == 0) {
+      options.format = capture_core::ImageFormat::kJpeg;
+    } else if (g_strcmp0(fl_value_get_string(format), "qoi") == 0) {
+      options.format = capture_core::ImageFormat::kQoi;
+    }
+  }
+  int quality = 0;
+  if (read_int_arg(args, "quality", &quality)) {
+    options.quality = CLAMP(quality, 1, 100);
+  }
+  return options;
+}
+
+// 工作线程：按 options 取同步截图用的编码器
+static capture_core::FrameEncoder* worker_encoder(ScreenshotChannel* self,
+                                                  const capture_core::EncodeOptions& options) {
+  if (options.format == capture_core::ImageFormat::kJpeg) {
+    self->jpeg_encoder.set_quality(options.quality);
+    return &self->jpeg_encoder;
+  }
+  if (options.format == capture_core::ImageFormat::kQoi) {
+    return &self->qoi_encoder;
+  }
+  return &self->encoder;
+}
+
+// 工作线程：捕获并编码；region 为空表示全屏
+static void run_capture(ScreenshotChannel* self, FlMethodCall* method_call,
+                        const capture_core::Rect& region,
+                        const capture_core::EncodeOptions& options,
+                        const capture_core::CancellationToken& token) {
+#ifdef CAPTURE_CORE_HAS_X11
+  if (!self->source) {
+    self->source.reset(new capture_core::X11ShmFrameSource());
+  }
+  if (!self->source->is_open()) {
+    post_error(method_call, "UNAVAILABLE", "Cannot open X11 display");
+    return;
+  }
+
+  capture_core::CapturePipeline pipeline(self->source.get(), worker_encoder(self, options));
+  std::vector<uint8_t> bytes;
+  bool ok = region.empty() ? pipeline.CaptureFull(&bytes)
+                           : pipeline.CaptureRegion(region, &bytes);
+  if (token.cancelled()) {
+    post_error(method_call, "CANCELLED", "Capture request was cancelled");
+  } else if (!ok) {
+    post_error(method_call, "CAPTURE_ERROR", "Failed to capture screen");
+  } else {
+    post_completion(method_call, bytes_value(bytes), nullptr, nullptr);
+  }
+#else
+  (void)self;
+  (void)region;
+  (void)options;
+  (void)token;
+  post_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+}
+
+// 编码线程（取消时为调用线程）：按需保存文件，再在主线程通知 Dart
+static void on_encode_complete(FlMethodChannel* channel, const std::string& save_path,
+                               capture_core::EncodeResult encoded) {
+  const gchar* status = "failed";
+  bool saved = false;
+  if (encoded.status == capture_core::EncodeStatus::kOk) {
+    status = "ok";
+    if (!save_path.empty()) {
+      g_autoptr(GError) error = nullptr;
+      saved = g_file_set_contents(save_path.c_str(),
+                                  reinterpret_cast<const gchar*>(encoded.bytes.data()),
+                                  static_cast<gssize>(encoded.bytes.size()), &error);
+      if (!saved) {
+        g_warning("Failed to save encoded frame: %s", error->message);
+        status = "failed";
+      }
+    }
+  } else if (encoded.status == capture_core::EncodeStatus::kCancelled) {
+    status = "cancelled";
+  }
+
+  FlValue* args = fl_value_new_map();
+  fl_value_set_string_take(args, "handle",
+                           fl_value_new_int(static_cast<int64_t>(encoded.handle)));
+  fl_value_set_string_take(args, "status", fl_value_new_string(status));
+  if (g_strcmp0(status, "ok") == 0) {
+    fl_value_set_string_take(args, "bytes", bytes_value(encoded.bytes));
+  }
+  if (saved) {
+    fl_value_set_string_take(args, "path", fl_value_new_string(save_path.c_str()));
+  }
+  g_idle_add(notify_dart_cb,
+             new DartNotification{FL_METHOD_CHANNEL(g_object_ref(channel)),
+                                  "onEncodeComplete", args});
+}
+
+// 转码线程（析构时为调用线程）：在主线程通知 Dart
+static void on_transcode_complete(FlMethodChannel* channel,
+                                  capture_core::TranscodeResult transcoded) {
+  const gchar* status = "failed";
+  if (transcoded.status == capture_core::TranscodeStatus::kOk) {
+    status = "ok";
+  } else if (transcoded.status == capture_core::TranscodeStatus::kCancelled) {
+    status = "cancelled";
+  } else {
+    g_warning("Failed to transcode %s", transcoded.source.c_str());
+  }
+
+  FlValue* args = fl_value_new_map();
+  fl_value_set_string_take(args, "source", fl_value_new_string(transcoded.source.c_str()));
+  fl_value_set_string_take(args, "target", fl_value_new_string(transcoded.target.c_str()));
+  fl_value_set_string_take(args, "status", fl_value_new_string(status));
+  g_idle_add(notify_dart_cb,
+             new DartNotification{FL_METHOD_CHANNEL(g_object_ref(channel)),
+                                  "onTranscodeComplete", args});
+}
+
+// 工作线程：两阶段截图的捕获阶段，像素进入内存后立即回复 {handle, width, height}
+// defer_encode 为 true 时帧先暂存不编码，预览走纹理，用户保存时再 encodeFrame；
+// change_key 非空时和同一循环任务上一次保存的帧按分块比较，未变化时不编码，
+// tile_delta 为 true 时变化不大的帧只保存脏分块补丁（带 alpha，JPEG 改为 PNG）
+static void run_begin_capture(ScreenshotChannel* self, FlMethodCall* method_call,
+                              const capture_core::Rect& region,
+                              const std::string& save_path, bool defer_encode,
+                              const capture_core::EncodeOptions& options,
+                              const std::string& change_key, bool tile_delta,
+                              const capture_core::CancellationToken& token) {
+#ifdef CAPTURE_CORE_HAS_X11
+  if (!self->source) {
+    self->source.reset(new capture_core::X11ShmFrameSource());
+  }
+  if (!self->source->is_open()) {
+    post_error(method_call, "UNAVAILABLE", "Cannot open X11 display");
+    return;
+  }
+
+  capture_core::CapturePipeline pipeline(self->source.get(), nullptr);
+  bool ok = pipeline.CaptureFrame(region.empty() ? self->source->GetBounds() : region);
+  if (token.cancelled()) {
+    post_error(method_call, "CANCELLED", "Capture request was cancelled");
+    return;
+  }
+  if (!ok) {
+    post_error(method_call, "CAPTURE_ERROR", "Failed to capture screen");
+    return;
+  }
+
+  // 帧指向共享内存段，Submit 会拷贝到编码阶段自己的缓冲，
+  // 之后共享内存段可以立即用于下一次截图
+  capture_core::FrameBuffer& frame = pipeline.frame();
+  const int width = frame.width();
+  const int height = frame.height();
+  FlValue* result = fl_value_new_map();
+  fl_value_set_string_take(result, "width", fl_value_new_int(width));
+  fl_value_set_string_take(result, "height", fl_value_new_int(height));
+  // 整帧的感知哈希，Dart 端用于近似重复过滤和相似截图查找
+  fl_value_set_string_take(
+      result, "perceptualHash",
+      fl_value_new_int(static_cast<int64_t>(capture_core::DifferenceHash(frame))));
+
+  capture_core::EncodeOptions encode_options = options;
+  if (!change_key.empty()) {
+    const capture_core::ChangeDecision change =
+        self->changes.Process(change_key, tile_delta, &frame);
+    fl_value_set_string_take(result, "dirtyTiles",
+                             fl_value_new_int(static_cast<int64_t>(change.dirty_tiles)));
+    fl_value_set_string_take(result, "totalTiles",
+                             fl_value_new_int(static_cast<int64_t>(change.total_tiles)));
+    if (change.action == capture_core::ChangeAction::kUnchanged) {
+      // 画面没有变化：不编码也不保存
+      fl_value_set_string_take(result, "changed", fl_value_new_bool(false));
+      post_completion(method_call, result, nullptr, nullptr);
+      return;
+    }
+    fl_value_set_string_take(result, "changed", fl_value_new_bool(true));
+    if (change.action == capture_core::ChangeAction::kPatch) {
+      const capture_core::Rect& bounds = change.patch_bounds;
+      fl_value_set_string_take(result, "patchX", fl_value_new_int(bounds.x));
+      fl_value_set_string_take(result, "patchY", fl_value_new_int(bounds.y));
+      fl_value_set_string_take(result, "patchWidth", fl_value_new_int(bounds.width));
+      fl_value_set_string_take(result, "patchHeight", fl_value_new_int(bounds.height));
+      if (encode_options.format == capture_core::ImageFormat::kJpeg) {
+        encode_options.format = capture_core::ImageFormat::kPng;
+      }
+    } else {
+      fl_value_set_string_take(result, "keyframe", fl_value_new_bool(true));
+    }
+  }
+
+  FlMethodChannel* channel = self->channel;
+  auto done = [channel, save_path](capture_core::EncodeResult encoded) {
+    on_encode_complete(channel, save_path, std::move(encoded));
+  };
+  capture_core::FrameHandle handle =
+      defer_encode ? self->encodes->Hold(std::move(frame), done, encode_options)
+                   : self->encodes->Submit(std::move(frame), done, encode_options);
+  if (handle == 0) {
+    fl_value_unref(result);
+    if (!change_key.empty()) {
+      // 丢掉的可能是新的参考帧，之后的补丁会没有可依附的整帧
+      self->changes.Forget(change_key);
+    }
+    post_error(method_call, "BUSY", "Too many pending encodes");
+    return;
+  }
+
+  fl_value_set_string_take(result, "handle", fl_value_new_int(static_cast<int64_t>(handle)));
+  post_completion(method_call, result, nullptr, nullptr);
+#else
+  (void)self;
+  (void)region;
+  (void)save_path;
+  (void)defer_encode;
+  (void)options;
+  (void)change_key;
+  (void)tile_delta;
+  (void)token;
+  post_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+}
+
+// 循环截图的原生计划（startSchedule 的参数和过滤状态）
+struct ScheduledTask {
+  std::string task_id;
+  capture_core::ScheduleId schedule_id = 0;
+  // 为空表示全屏
+  capture_core::Rect region;
+  // 非 0 时截取这个 X11 窗口（region 不使用）
+  uint64_t window = 0;
+#ifdef CAPTURE_CORE_HAS_X11
+  // 窗口的帧来源，第一次触发时打开，之后的触发复用（同样由 busy 串行化）
+  std::unique_ptr<capture_core::X11ShmFrameSource> window_source;
+#endif
+  // 文件写到 directory 下的 <file_prefix><毫秒时间戳>.<扩展名>
+  std::string directory;
+  std::string file_prefix;
+  capture_core::EncodeOptions options;
+  // 非空时按分块和上一次保存的整帧比较（ChangeTracker 的键）
+  std::string change_key;
+  bool tile_delta = false;
+  // 近似重复过滤的汉明距离阈值，负值表示不过滤
+  int dedup_distance = -1;
+  // 上一次保存的帧的感知哈希；同一计划同时只有一次触发在执行，
+  // 前后两次之间由 ScheduledShot::busy 的释放和获取保证可见性
+  bool has_kept_hash = false;
+  uint64_t kept_hash = 0;
+};
+
+// 编码格式对应的扩展名（与 Dart 端 ImageFormat.extension 一致）
+static const gchar* image_format_extension(capture_core::ImageFormat format) {
+  switch (format) {
+    case capture_core::ImageFormat::kJpeg:
+      return ".jpg";
+    case capture_core::ImageFormat::kQoi:
+      return ".qoi";
+    default:
+      return ".png";
+  }
+}
+
+static const gchar* skip_reason_name(capture_core::SkipReason reason) {
+  switch (reason) {
+    case capture_core::SkipReason::kBusy:
+      return "busy";
+    case capture_core::SkipReason::kQueueFull:
+      return "queueFull";
+    default:
+      return "cancelled";
+  }
+}
+
+// onScheduledShot 的公共字段
+static FlValue* scheduled_shot_event(const ScheduledTask& task,
+                                     const capture_core::ScheduledShot& shot) {
+  FlValue* event = fl_value_new_map();
+  fl_value_set_string_take(event, "taskId", fl_value_new_string(task.task_id.c_str()));
+  fl_value_set_string_take(event, "scheduleId",
+                           fl_value_new_int(static_cast<int64_t>(shot.schedule)));
+  fl_value_set_string_take(event, "index", fl_value_new_int(shot.index));
+  fl_value_set_string_take(event, "missed", fl_value_new_int(shot.missed));
+  fl_value_set_string_take(event, "last", fl_value_new_bool(shot.last));
+  fl_value_set_string_take(event, "latenessUs",
+                           fl_value_new_int(static_cast<int64_t>(shot.lateness.count())));
+  return event;
+}
+
+// 在主线程把一次触发的结果推送给 Dart（任意线程可调用），event 的引用转交给通知
+static void post_scheduled_shot(FlMethodChannel* channel, FlValue* event,
+                                const gchar* status) {
+  fl_value_set_string_take(event, "status", fl_value_new_string(status));
+  g_idle_add(notify_dart_cb,
+             new DartNotification{FL_METHOD_CHANNEL(g_object_ref(channel)),
+                                  "onScheduledShot", event});
+}
+
+// 计划结束（最后一次触发或被替换）后移除登记；id 不匹配时不做任何事
+static void end_scheduled_task(ScreenshotChannel* self, const std::string& task_id,
+                               capture_core::ScheduleId id) {
+  std::lock_guard<std::mutex> lock(self->schedules_mutex);
+  auto it = self->schedules.find(task_id);
+  if (it != self->schedules.end() && it->second->schedule_id == id) {
+    self->schedules.erase(it);
+  }
+}
+
+// 工作线程：循环计划的一次触发。截图、过滤近似重复和未变化的帧，提交编码，
+// 编码线程写完文件后通过 onScheduledShot 通知 Dart；整个过程不经过 Dart
+static void run_scheduled_shot(ScreenshotChannel* self,
+                               const std::shared_ptr<ScheduledTask>& task,
+                               capture_core::ScheduledShot shot,
+                               const capture_core::CancellationToken& token) {
+  if (shot.last) {
+    end_scheduled_task(self, task->task_id, shot.schedule);
+  }
+  FlValue* event = scheduled_shot_event(*task, shot);
+  if (token.cancelled()) {
+    fl_value_set_string_take(event, "reason", fl_value_new_string("cancelled"));
+    post_scheduled_shot(self->channel, event, "skipped");
+    return;
+  }
+#ifdef CAPTURE_CORE_HAS_X11
+  capture_core::X11ShmFrameSource* source = nullptr;
+  if (task->window != 0) {
+    if (!task->window_source) {
+      task->window_source = capture_core::X11ShmFrameSource::ForWindow(task->window);
+    }
+    source = task->window_source.get();
+  } else {
+    if (!self->source) {
+      self->source.reset(new capture_core::X11ShmFrameSource());
+    }
+    source = self->source.get();
+  }
+  const int64_t captured_at = g_get_real_time() / 1000;
+  capture_core::CapturePipeline pipeline(source, nullptr);
+  // 窗口被关闭后 GetBounds 为空，这一次记为失败
+  if (source == nullptr || !source->is_open() ||
+      !pipeline.CaptureFrame(task->region.empty() ? source->GetBounds() : task->region)) {
+    post_scheduled_shot(self->channel, event, "failed");
+    return;
+  }
+
+  capture_core::FrameBuffer& frame = pipeline.frame();
+  fl_value_set_string_take(event, "time", fl_value_new_int(captured_at));
+  fl_value_set_string_take(event, "width", fl_value_new_int(frame.width()));
+  fl_value_set_string_take(event, "height", fl_value_new_int(frame.height()));
+  const uint64_t hash = capture_core::DifferenceHash(frame);
+  fl_value_set_string_take(event, "perceptualHash",
+                           fl_value_new_int(static_cast<int64_t>(hash)));
+
+  // 近似重复在变化检测之前判断，被丢弃的帧不会成为参考帧
+  if (task->dedup_distance >= 0 && task->has_kept_hash &&
+      capture_core::HammingDistance(hash, task->kept_hash) <= task->dedup_distance) {
+    post_scheduled_shot(self->channel, event, "duplicate");
+    return;
+  }
+
+  capture_core::EncodeOptions options = task->options;
+  bool keyframe = false;
+  if (!task->change_key.empty()) {
+    const capture_core::ChangeDecision change =
+        self->changes.Process(task->change_key, task->tile_delta, &frame);
+    fl_value_set_string_take(event, "dirtyTiles",
+                             fl_value_new_int(static_cast<int64_t>(change.dirty_tiles)));
+    fl_value_set_string_take(event, "totalTiles",
+                             fl_value_new_int(static_cast<int64_t>(change.total_tiles)));
+    if (change.action == capture_core::ChangeAction::kUnchanged) {
+      fl_value_set_string_take(event, "changed", fl_value_new_bool(false));
+      post_scheduled_shot(self->channel, event, "unchanged");
+      return;
+    }
+    fl_value_set_string_take(event, "changed", fl_value_new_bool(true));
+    if (change.action == capture_core::ChangeAction::kPatch) {
+      const capture_core::Rect& bounds = change.patch_bounds;
+      fl_value_set_string_take(event, "patchX", fl_value_new_int(bounds.x));
+      fl_value_set_string_take(event, "patchY", fl_value_new_int(bounds.y));
+      fl_value_set_string_take(event, "patchWidth", fl_value_new_int(bounds.width));
+      fl_value_set_string_take(event, "patchHeight", fl_value_new_int(bounds.height));
+      if (options.format == capture_core::ImageFormat::kJpeg) {
+        options.format = capture_core::ImageFormat::kPng;
+      }
+    } else {
+      fl_value_set_string_take(event, "keyframe", fl_value_new_bool(true));
+      keyframe = true;
+    }
+  }
+
+  const std::string name = task->file_prefix + std::to_string(captured_at) +
+                           image_format_extension(options.format);
+  g_autofree gchar* path = g_build_filename(task->directory.c_str(), name.c_str(), nullptr);
+  // lambda 需要可拷贝，事件用 shared_ptr 持有；编码线程写完文件才释放 busy，
+  // 写盘跟不上时后面的触发被跳过，而不是越积越多
+  std::shared_ptr<FlValue> shared_event(event, fl_value_unref);
+  capture_core::ChangeTracker* changes = &self->changes;
+  FlMethodChannel* channel = self->channel;
+  auto done = [channel, changes, task, shared_event, file = std::string(path), keyframe, hash,
+               busy = shot.busy](capture_core::EncodeResult encoded) mutable {
+    FlValue* args = fl_value_ref(shared_event.get());
+    g_autoptr(GError) error = nullptr;
+    const bool saved =
+        encoded.status == capture_core::EncodeStatus::kOk &&
+        g_file_set_contents(file.c_str(), reinterpret_cast<const gchar*>(encoded.bytes.data()),
+                            static_cast<gssize>(encoded.bytes.size()), &error);
+    if (saved) {
+      fl_value_set_string_take(args, "path", fl_value_new_string(file.c_str()));
+      // 只有真正保存下来的帧才作为之后近似重复的参照（在释放 busy 之前写入）
+      if (task->dedup_distance >= 0) {
+        task->kept_hash = hash;
+        task->has_kept_hash = true;
+      }
+    } else {
+      g_warning("Scheduled capture was not saved to %s", file.c_str());
+      if (keyframe) {
+        // 参考帧没写成功，之后的补丁没有可依附的整帧
+        changes->Forget(task->change_key);
+      }
+    }
+    busy.reset();
+    post_scheduled_shot(channel, args, saved ? "saved" : "failed");
+  };
+  if (self->encodes->Submit(std::move(frame), done, options) == 0) {
+    g_warning("Encode queue is full, skipping scheduled capture");
+    if (!task->change_key.empty()) {
+      self->changes.Forget(task->change_key);
+    }
+    FlValue* skipped = scheduled_shot_event(*task, shot);
+    fl_value_set_string_take(skipped, "reason", fl_value_new_string("queueFull"));
+    post_scheduled_shot(self->channel, skipped, "skipped");
+  }
+#else
+  post_scheduled_shot(self->channel, event, "failed");
+#endif
+}
+
+// 工作线程：编码完成前的原始帧，转成 RGBA（长边不超过 max_dimension）
+static void run_frame_preview(ScreenshotChannel* self, FlMethodCall* method_call,
+                              capture_core::FrameHandle handle, int max_dimension) {
+  std::shared_ptr<const capture_core::FrameBuffer> frame = self->encodes->Peek(handle);
+  if (!frame) {
+    post_completion(method_call, fl_value_new_null(), nullptr, nullptr);
+    return;
+  }
+
+  capture_core::FrameBuffer preview;
+  capture_core::ConvertFramePreview(*frame, max_dimension, &preview);
+  FlValue* result = fl_value_new_map();
+  fl_value_set_string_take(result, "width", fl_value_new_int(preview.width()));
+  fl_value_set_string_take(result, "height", fl_value_new_int(preview.height()));
+  fl_value_set_string_take(result, "pixels",
+                           fl_value_new_uint8_list(preview.data(), preview.size_bytes()));
+  post_completion(method_call, result, nullptr, nullptr);
+}
+
+// 工作线程：把原始帧转成 RGBA 注册为外部纹理，回复 {textureId, width, height}；
+// max_dimension 为 0 时保持原尺寸，帧已编码完时回复 null
+static void run_create_texture(ScreenshotChannel* self, FlMethodCall* method_call,
+                               capture_core::FrameHandle handle, int max_dimension) {
+  std::shared_ptr<const capture_core::FrameBuffer> frame = self->encodes->Peek(handle);
+  if (!frame) {
+    post_completion(method_call, fl_value_new_null(), nullptr, nullptr);
+    return;
+  }
+  capture_core::FrameBuffer rgba;
+  capture_core::ConvertFramePreview(*frame, max_dimension, &rgba);
+  frame.reset();
+
+  const int width = rgba.width();
+  const int height = rgba.height();
+  FlTexture* texture = FL_TEXTURE(frame_texture_new(std::move(rgba)));
+  if (texture == nullptr ||
+      !fl_texture_registrar_register_texture(self->texture_registrar, texture)) {
+    if (texture != nullptr) {
+      g_object_unref(texture);
+    }
+    post_error(method_call, "TEXTURE_ERROR", "Failed to register frame texture");
+    return;
+  }
+  // 像素不会再变化，通知一次即可
+  fl_texture_registrar_mark_texture_frame_available(self->texture_registrar, texture);
+  const int64_t texture_id = fl_texture_get_id(texture);
+  {
+    std::lock_guard<std::mutex> lock(self->textures_mutex);
+    self->textures[texture_id] = texture;
+  }
+
+  FlValue* result = fl_value_new_map();
+  fl_value_set_string_take(result, "textureId", fl_value_new_int(texture_id));
+  fl_value_set_string_take(result, "width", fl_value_new_int(width));
+  fl_value_set_string_take(result, "height", fl_value_new_int(height));
+  post_completion(method_call, result, nullptr, nullptr);
+}
+
+// 注销并释放纹理；不存在时返回 false
+static bool dispose_texture(ScreenshotChannel* self, int64_t texture_id) {
+  FlTexture* texture = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(self->textures_mutex);
+    auto it = self->textures.find(texture_id);
+    if (it == self->textures.end()) {
+      return false;
+    }
+    texture = it->second;
+    self->textures.erase(it);
+  }
+  fl_texture_registrar_unregister_texture(self->texture_registrar, texture);
+  g_object_unref(texture);
+  return true;
+}
+
+enum class MonitorRequest {
+  kList,            // getMonitors
+  kVirtualDesktop,  // captureVirtualDesktop
+  kEachMonitor,     // captureMonitors
+};
+
+#ifdef CAPTURE_CORE_HAS_X11
+static bool same_layout(const std::vector<capture_core::MonitorInfo>& a,
+                        const std::vector<capture_core::MonitorInfo>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].bounds != b[i].bounds) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 按当前显示器布局准备 MultiMonitorCapture，布局没变时复用连接和共享内存段
+static capture_core::MultiMonitorCapture* ensure_monitors(ScreenshotChannel* self) {
+  std::vector<capture_core::MonitorInfo> layout = capture_core::EnumerateX11Monitors();
+  if (layout.empty()) {
+    self->monitors.reset();
+    return nullptr;
+  }
+  if (!self->monitors || !same_layout(self->monitors->monitors(), layout)) {
+    self->monitors.reset(new capture_core::MultiMonitorCapture(
+        layout, [](const capture_core::MonitorInfo& monitor) {
+          return std::unique_ptr<capture_core::FrameSource>(
+              new capture_core::X11ShmFrameSource(nullptr, monitor.bounds));
+        }));
+  }
+  return self->monitors.get();
+}
+#endif
+
+// 工作线程：枚举显示器，并按需并行抓取所有显示器
+static void run_monitor_request(ScreenshotChannel* self, FlMethodCall* method_call,
+                                MonitorRequest request,
+                                const capture_core::EncodeOptions& options,
+                                const capture_core::CancellationToken& token) {
+#ifdef CAPTURE_CORE_HAS_X11
+  capture_core::MultiMonitorCapture* capture = ensure_monitors(self);
+  if (capture == nullptr) {
+    post_error(method_call, "UNAVAILABLE", "Cannot open X11 display");
+    return;
+  }
+  const auto& monitors = capture->monitors();
+
+  if (request == MonitorRequest::kList) {
+    post_completion(method_call, monitor_list_value(monitors), nullptr, nullptr);
+    return;
+  }
+
+  capture_core::FrameEncoder* encoder = worker_encoder(self, options);
+  FlValue* result = nullptr;
+  if (request == MonitorRequest::kVirtualDesktop) {
+    capture_core::FrameBuffer frame;
+    std::vector<uint8_t> bytes;
+    if (capture->CaptureVirtualDesktop(&frame) && !token.cancelled() &&
+        encoder->Encode(frame, &bytes)) {
+      capture_core::Rect bounds = capture->virtual_bounds();
+      result = fl_value_new_map();
+      fl_value_set_string_take(result, "bytes", bytes_value(bytes));
+      fl_value_set_string_take(result, "x", fl_value_new_int(bounds.x));
+      fl_value_set_string_take(result, "y", fl_value_new_int(bounds.y));
+      fl_value_set_string_take(result, "width", fl_value_new_int(bounds.width));
+      fl_value_set_string_take(result, "height", fl_value_new_int(bounds.height));
+      fl_value_set_string_take(result, "monitors", monitor_list_value(monitors));
+    }
+  } else if (capture->CaptureEach()) {
+    result = fl_value_new_list();
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < monitors.size() && !token.cancelled(); i++) {
+      if (!encoder->Encode(capture->frame(i), &bytes)) {
+        g_clear_pointer(&result, fl_value_unref);
+        break;
+      }
+      FlValue* entry = monitor_value(monitors[i]);
+      fl_value_set_string_take(entry, "bytes", bytes_value(bytes));
+      fl_value_append_take(result, entry);
+    }
+  }
+
+  if (token.cancelled()) {
+    g_clear_pointer(&result, fl_value_unref);
+    post_error(method_call, "CANCELLED", "Capture request was cancelled");
+  } else if (result == nullptr) {
+    post_error(method_call, "CAPTURE_ERROR", "Failed to capture monitors");
+  } else {
+    post_completion(method_call, result, nullptr, nullptr);
+  }
+#else
+  (void)self;
+  (void)request;
+  (void)options;
+  (void)token;
+  post_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+}
+
+// 工作线程：截取单个窗口。有 XComposite 时从窗口的离屏像素图截取（被遮挡也完整），
+// 否则截取窗口在屏幕上的区域
+static void run_window_capture(ScreenshotChannel* self, FlMethodCall* method_call,
+                               uint64_t window, const capture_core::EncodeOptions& options,
+                               const capture_core::CancellationToken& token) {
+#ifdef CAPTURE_CORE_HAS_X11
+  std::unique_ptr<capture_core::X11ShmFrameSource> source =
+      capture_core::X11ShmFrameSource::ForWindow(window);
+  if (!source) {
+    post_error(method_call, "UNAVAILABLE", "Cannot open X11 display");
+    return;
+  }
+  capture_core::CapturePipeline pipeline(source.get(), worker_encoder(self, options));
+  std::vector<uint8_t> bytes;
+  bool ok = pipeline.CaptureFull(&bytes);
+  if (token.cancelled()) {
+    post_error(method_call, "CANCELLED", "Capture request was cancelled");
+  } else if (!ok) {
+    post_error(method_call, "CAPTURE_ERROR", "Failed to capture window");
+  } else {
+    post_completion(method_call, bytes_value(bytes), nullptr, nullptr);
+  }
+#else
+  (void)self;
+  (void)window;
+  (void)options;
+  (void)token;
+  post_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+}
+
+// 工作线程：窗口选择器的批量缩略图，每个窗口一个连接，在线程池上并行截取和编码；
+// 回复与 windows 顺序相同的列表，截取失败的窗口对应 null
+static void run_window_batch(FlMethodCall* method_call, const std::vector<uint64_t>& windows,
+                             int max_size, const capture_core::EncodeOptions& options,
+                             const capture_core::CancellationToken& token) {
+#ifdef CAPTURE_CORE_HAS_X11
+  std::vector<std::unique_ptr<capture_core::X11ShmFrameSource>> owned;
+  std::vector<capture_core::FrameSource*> sources;
+  for (uint64_t window : windows) {
+    owned.push_back(capture_core::X11ShmFrameSource::ForWindow(window));
+    sources.push_back(owned.back().get());
+  }
+  capture_core::BatchCaptureOptions batch_options;
+  batch_options.max_dimension = max_size;
+  batch_options.encode = options;
+  std::vector<capture_core::BatchCaptureItem> items =
+      capture_core::CaptureBatch(sources, batch_options);
+  if (token.cancelled()) {
+    post_error(method_call, "CANCELLED", "Capture request was cancelled");
+    return;
+  }
+
+  FlValue* result = fl_value_new_list();
+  for (size_t i = 0; i < items.size(); i++) {
+    const capture_core::BatchCaptureItem& item = items[i];
+    if (!item.ok) {
+      fl_value_append_take(result, fl_value_new_null());
+      continue;
+    }
+    FlValue* entry = fl_value_new_map();
+    fl_value_set_string_take(entry, "id",
+                             fl_value_new_string(window_id_string(windows[i]).c_str()));
+    fl_value_set_string_take(entry, "width", fl_value_new_int(item.width));
+    fl_value_set_string_take(entry, "height", fl_value_new_int(item.height));
+    fl_value_set_string_take(entry, "sourceWidth", fl_value_new_int(item.source_width));
+    fl_value_set_string_take(entry, "sourceHeight", fl_value_new_int(item.source_height));
+    fl_value_set_string_take(entry, "bytes", bytes_value(item.bytes));
+    fl_value_append_take(result, entry);
+  }
+  post_completion(method_call, result, nullptr, nullptr);
+#else
+  (void)windows;
+  (void)max_size;
+  (void)options;
+  (void)token;
+  post_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+}
+
+// 即时回放保存的文件：directory 下的 replay_<毫秒时间戳>.gif / .png
+static std::string replay_file_path(const std::string& directory,
+                                    capture_core::AnimationFormat format) {
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+  const std::string name =
+      "replay_" + std::to_string(now) +
+      (format == capture_core::AnimationFormat::kGif ? ".gif" : ".png");
+  g_autofree gchar* path = g_build_filename(directory.c_str(), name.c_str(), nullptr);
+  return path;
+}
+
+// stopRecording 的回复；文件写入失败时为 nullptr
+static FlValue* recording_stats_value(const capture_core::RecordingStats& stats) {
+  if (!stats.ok) {
+    return nullptr;
+  }
+  FlValue* map = fl_value_new_map();
+  fl_value_set_string_take(map, "frames", fl_value_new_int(stats.written));
+  fl_value_set_string_take(map, "merged", fl_value_new_int(stats.merged));
+  fl_value_set_string_take(map, "dropped", fl_value_new_int(stats.dropped));
+  fl_value_set_string_take(map, "durationMs", fl_value_new_int(stats.duration.count()));
+  fl_value_set_string_take(map, "bytes", fl_value_new_int(static_cast<int64_t>(stats.bytes)));
+  return map;
+}
+
+// getInstantReplayStats 的回复：时间以毫秒 / 微秒为单位，内存以字节为单位
+static FlValue* replay_stats_value(const capture_core::ReplayStats& stats) {
+  FlValue* map = fl_value_new_map();
+  fl_value_set_string_take(map, "captured", fl_value_new_int(stats.captured));
+  fl_value_set_string_take(map, "failedCaptures", fl_value_new_int(stats.failed_captures));
+  fl_value_set_string_take(map, "unchanged", fl_value_new_int(stats.unchanged));
+  fl_value_set_string_take(map, "evicted", fl_value_new_int(stats.evicted));
+  fl_value_set_string_take(map, "frames", fl_value_new_int(stats.frames));
+  fl_value_set_string_take(map, "keyframes", fl_value_new_int(stats.keyframes));
+  fl_value_set_string_take(map, "spanMs", fl_value_new_int(stats.span.count()));
+  fl_value_set_string_take(map, "bytes", fl_value_new_int(static_cast<int64_t>(stats.bytes)));
+  fl_value_set_string_take(map, "peakBytes",
+                           fl_value_new_int(static_cast<int64_t>(stats.peak_bytes)));
+  fl_value_set_string_take(map, "workingBytes",
+                           fl_value_new_int(static_cast<int64_t>(stats.working_bytes)));
+  fl_value_set_string_take(map, "uptimeMs", fl_value_new_int(stats.uptime.count()));
+  fl_value_set_string_take(map, "captureUs", fl_value_new_int(stats.capture_time.count()));
+  fl_value_set_string_take(map, "encodeUs", fl_value_new_int(stats.encode_time.count()));
+  fl_value_set_string_take(map, "cpuUs", fl_value_new_int(stats.cpu_time.count()));
+  return map;
+}
+
+// 在工作线程上执行 work，取消或队列已满时回复对应的错误
+static void submit_job(
+    ScreenshotChannel* self, FlMethodCall* method_call,
+    std::function<void(FlMethodCall*, const capture_core::CancellationToken&)> work) {
+  // lambda 各自持有一个引用，任务运行或取消后释放
+  std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)),
+                                     g_object_unref);
+  capture_core::JobId id = self->jobs->Submit(
+      [call, work](const capture_core::CancellationToken& token) {
+        work(call.get(), token);
+      },
+      [call]() {
+        post_error(call.get(), "CANCELLED", "Capture request was cancelled");
+      });
+  if (id == 0) {
+    respond_error(method_call, "BUSY", "Too many pending capture requests");
+  }
+}
+
+static void submit_capture(ScreenshotChannel* self, FlMethodCall* method_call,
+                           const capture_core::Rect& region,
+                           const capture_core::EncodeOptions& options) {
+  submit_job(self, method_call,
+             [self, region, options](FlMethodCall* call,
+                                     const capture_core::CancellationToken& token) {
+               run_capture(self, call, region, options, token);
+             });
+}
+
+static void submit_begin_capture(ScreenshotChannel* self, FlMethodCall* method_call,
+                                 const capture_core::Rect& region,
+                                 const std::string& save_path, bool defer_encode,
+                                 const capture_core::EncodeOptions& options,
+                                 const std::string& change_key, bool tile_delta) {
+  submit_job(self, method_call,
+             [self, region, save_path, defer_encode, options, change_key, tile_delta](
+                 FlMethodCall* call, const capture_core::CancellationToken& token) {
+               run_begin_capture(self, call, region, save_path, defer_encode, options,
+                                 change_key, tile_delta, token);
+             });
+}
+
+static void submit_monitor_request(ScreenshotChannel* self,
+                                   FlMethodCall* method_call,
+                                   MonitorRequest request,
+                                   const capture_core::EncodeOptions& options) {
+  submit_job(self, method_call,
+             [self, request, options](FlMethodCall* call,
+                                      const capture_core::CancellationToken& token) {
+               run_monitor_request(self, call, request, options, token);
+             });
+}
+
+static void method_call_cb(FlMethodChannel* channel, FlMethodCall* method_call,
+                           gpointer user_data) {
+  ScreenshotChannel* self = static_cast<ScreenshotChannel*>(user_data);
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+  // 所有截图方法都接受 format / quality
+  const capture_core::EncodeOptions encode_options = read_encode_options(args);
+  // 有截图活动时推迟后台的 QOI -> PNG 转码
+  if (g_strcmp0(method, "transcodeWhenIdle") != 0) {
+    self->transcoder->NotifyActivity();
+  }
+
+  if (g_strcmp0(method, "captureFullScreen") == 0) {
+    submit_capture(self, method_call, capture_core::Rect(), encode_options);
+  } else if (g_strcmp0(method, "captureRegion") == 0) {
+    int x = 0, y = 0, width = 0, height = 0;
+    if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP ||
+        !read_int_arg(args, "x", &x) || !read_int_arg(args, "y", &y) ||
+        !read_int_arg(args, "width", &width) ||
+        !read_int_arg(args, "height", &height) || width <= 0 || height <= 0) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Invalid arguments");
+      return;
+    }
+    submit_capture(self, method_call, capture_core::Rect(x, y, width, height), encode_options);
+  } else if (g_strcmp0(method, "beginCapture") == 0) {
+    // 两阶段截图；Linux 没有原生选择窗口，selectedRegion 等同于 region
+    FlValue* mode = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                        ? fl_value_lookup_string(args, "mode")
+                        : nullptr;
+    if (mode == nullptr || fl_value_get_type(mode) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing mode parameter");
+      return;
+    }
+    const gchar* mode_name = fl_value_get_string(mode);
+    capture_core::Rect region;
+    if (g_strcmp0(mode_name, "region") == 0 ||
+        g_strcmp0(mode_name, "selectedRegion") == 0) {
+      int x = 0, y = 0, width = 0, height = 0;
+      if (!read_int_arg(args, "x", &x) || !read_int_arg(args, "y", &y) ||
+          !read_int_arg(args, "width", &width) ||
+          !read_int_arg(args, "height", &height) || width <= 0 || height <= 0) {
+        respond_error(method_call, "INVALID_ARGUMENTS", "Invalid region");
+        return;
+      }
+      region = capture_core::Rect(x, y, width, height);
+    } else if (g_strcmp0(mode_name, "fullScreen") != 0) {
+      // 窗口截图走 captureWindow
+      respond_error(method_call, "UNSUPPORTED", "Capture mode not supported on Linux");
+      return;
+    }
+    FlValue* save_path = fl_value_lookup_string(args, "savePath");
+    FlValue* defer_encode = fl_value_lookup_string(args, "deferEncode");
+    FlValue* change_key = fl_value_lookup_string(args, "changeKey");
+    FlValue* tile_delta = fl_value_lookup_string(args, "tileDelta");
+    submit_begin_capture(
+        self, method_call, region,
+        save_path != nullptr && fl_value_get_type(save_path) == FL_VALUE_TYPE_STRING
+            ? fl_value_get_string(save_path)
+            : "",
+        defer_encode != nullptr && fl_value_get_type(defer_encode) == FL_VALUE_TYPE_BOOL &&
+            fl_value_get_bool(defer_encode),
+        encode_options,
+        change_key != nullptr && fl_value_get_type(change_key) == FL_VALUE_TYPE_STRING
+            ? fl_value_get_string(change_key)
+            : "",
+        tile_delta != nullptr && fl_value_get_type(tile_delta) == FL_VALUE_TYPE_BOOL &&
+            fl_value_get_bool(tile_delta));
+  } else if (g_strcmp0(method, "getFramePreview") == 0) {
+    FlValue* handle = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                          ? fl_value_lookup_string(args, "handle")
+                          : nullptr;
+    if (handle == nullptr || fl_value_get_type(handle) != FL_VALUE_TYPE_INT) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    int max_dimension = kDefaultPreviewDimension;
+    read_int_arg(args, "maxDimension", &max_dimension);
+    capture_core::FrameHandle frame_handle =
+        static_cast<capture_core::FrameHandle>(fl_value_get_int(handle));
+    submit_job(self, method_call,
+               [self, frame_handle, max_dimension](
+                   FlMethodCall* call, const capture_core::CancellationToken&) {
+                 run_frame_preview(self, call, frame_handle, max_dimension);
+               });
+  } else if (g_strcmp0(method, "createFrameTexture") == 0) {
+    FlValue* handle = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                          ? fl_value_lookup_string(args, "handle")
+                          : nullptr;
+    if (handle == nullptr || fl_value_get_type(handle) != FL_VALUE_TYPE_INT) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    int max_dimension = 0;
+    read_int_arg(args, "maxDimension", &max_dimension);
+    capture_core::FrameHandle frame_handle =
+        static_cast<capture_core::FrameHandle>(fl_value_get_int(handle));
+    submit_job(self, method_call,
+               [self, frame_handle, max_dimension](
+                   FlMethodCall* call, const capture_core::CancellationToken&) {
+                 run_create_texture(self, call, frame_handle, max_dimension);
+               });
+  } else if (g_strcmp0(method, "disposeFrameTexture") == 0) {
+    FlValue* texture_id = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                              ? fl_value_lookup_string(args, "textureId")
+                              : nullptr;
+    if (texture_id == nullptr || fl_value_get_type(texture_id) != FL_VALUE_TYPE_INT) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing textureId parameter");
+      return;
+    }
+    g_autoptr(FlValue) result =
+        fl_value_new_bool(dispose_texture(self, fl_value_get_int(texture_id)));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "encodeFrame") == 0) {
+    // 开始编码 deferEncode 暂存的帧，结果照常通过 onEncodeComplete 推送
+    FlValue* handle = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                          ? fl_value_lookup_string(args, "handle")
+                          : nullptr;
+    if (handle == nullptr || fl_value_get_type(handle) != FL_VALUE_TYPE_INT) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    g_autoptr(FlValue) result = fl_value_new_bool(self->encodes->Encode(
+        static_cast<capture_core::FrameHandle>(fl_value_get_int(handle))));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "cancelEncode") == 0) {
+    FlValue* handle = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                          ? fl_value_lookup_string(args, "handle")
+                          : nullptr;
+    if (handle == nullptr || fl_value_get_type(handle) != FL_VALUE_TYPE_INT) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    g_autoptr(FlValue) result = fl_value_new_bool(self->encodes->Cancel(
+        static_cast<capture_core::FrameHandle>(fl_value_get_int(handle))));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "getMonitors") == 0) {
+    submit_monitor_request(self, method_call, MonitorRequest::kList, encode_options);
+  } else if (g_strcmp0(method, "captureVirtualDesktop") == 0) {
+    submit_monitor_request(self, method_call, MonitorRequest::kVirtualDesktop, encode_options);
+  } else if (g_strcmp0(method, "captureMonitors") == 0) {
+    submit_monitor_request(self, method_call, MonitorRequest::kEachMonitor, encode_options);
+  } else if (g_strcmp0(method, "cancelPendingCaptures") == 0) {
+    // 两阶段截图尚未编码完的帧以 cancelled 状态通知
+    size_t cancelled = self->jobs->CancelAll() + self->encodes->CancelAll();
+    g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(cancelled));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "transcodeWhenIdle") == 0) {
+    // 循环截图的 QOI 文件在空闲时转成 PNG，完成后通过 onTranscodeComplete 通知
+    FlValue* source = nullptr;
+    FlValue* target = nullptr;
+    if (args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP) {
+      source = fl_value_lookup_string(args, "source");
+      target = fl_value_lookup_string(args, "target");
+    }
+    if (source == nullptr || fl_value_get_type(source) != FL_VALUE_TYPE_STRING ||
+        target == nullptr || fl_value_get_type(target) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing source or target");
+      return;
+    }
+    FlMethodChannel* notify_channel = self->channel;
+    bool queued = self->transcoder->Enqueue(
+        fl_value_get_string(source), fl_value_get_string(target),
+        [notify_channel](capture_core::TranscodeResult transcoded) {
+          on_transcode_complete(notify_channel, std::move(transcoded));
+        });
+    g_autoptr(FlValue) result = fl_value_new_bool(queued);
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "resetChangeDetection") == 0) {
+    // 丢弃循环任务的参考帧（任务删除或恢复时），下一次截图保存整帧
+    FlValue* change_key = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                              ? fl_value_lookup_string(args, "changeKey")
+                              : nullptr;
+    if (change_key == nullptr || fl_value_get_type(change_key) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing changeKey parameter");
+      return;
+    }
+    self->changes.Forget(fl_value_get_string(change_key));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "startSchedule") == 0) {
+    // 循环截图交给原生调度器：按 intervalMs 的固定节拍截图、编码、写文件，
+    // 每次触发（包括跳过）通过 onScheduledShot 推送；回复计划 id，同一 taskId 的旧计划被替换
+    if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    FlValue* task_id = fl_value_lookup_string(args, "taskId");
+    FlValue* directory = fl_value_lookup_string(args, "directory");
+    FlValue* mode = fl_value_lookup_string(args, "mode");
+    if (task_id == nullptr || fl_value_get_type(task_id) != FL_VALUE_TYPE_STRING ||
+        directory == nullptr || fl_value_get_type(directory) != FL_VALUE_TYPE_STRING ||
+        mode == nullptr || fl_value_get_type(mode) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing taskId, directory or mode");
+      return;
+    }
+    auto task = std::make_shared<ScheduledTask>();
+    task->task_id = fl_value_get_string(task_id);
+    task->directory = fl_value_get_string(directory);
+    const gchar* mode_name = fl_value_get_string(mode);
+    if (g_strcmp0(mode_name, "region") == 0 ||
+        g_strcmp0(mode_name, "selectedRegion") == 0) {
+      int x = 0, y = 0, width = 0, height = 0;
+      if (!read_int_arg(args, "x", &x) || !read_int_arg(args, "y", &y) ||
+          !read_int_arg(args, "width", &width) ||
+          !read_int_arg(args, "height", &height) || width <= 0 || height <= 0) {
+        respond_error(method_call, "INVALID_ARGUMENTS", "Invalid region");
+        return;
+      }
+      task->region = capture_core::Rect(x, y, width, height);
+    } else if (g_strcmp0(mode_name, "window") == 0) {
+      if (!parse_window_id(fl_value_lookup_string(args, "windowId"), &task->window)) {
+        respond_error(method_call, "INVALID_ARGUMENTS", "Missing windowId parameter");
+        return;
+      }
+    } else if (g_strcmp0(mode_name, "fullScreen") != 0) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Unknown capture mode");
+      return;
+    }
+    int interval_ms = 0, total_shots = 0, first_delay_ms = -1, dedup_distance = -1;
+    if (!read_int_arg(args, "intervalMs", &interval_ms) || interval_ms <= 0) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Invalid intervalMs");
+      return;
+    }
+    read_int_arg(args, "totalShots", &total_shots);
+    read_int_arg(args, "firstDelayMs", &first_delay_ms);
+    read_int_arg(args, "dedupDistance", &dedup_distance);
+    capture_core::CaptureScheduler::Options options;
+    options.interval = std::chrono::milliseconds(interval_ms);
+    options.total_shots = MAX(total_shots, 0);
+    options.first_delay = std::chrono::milliseconds(first_delay_ms);
+    FlValue* file_prefix = fl_value_lookup_string(args, "filePrefix");
+    if (file_prefix != nullptr && fl_value_get_type(file_prefix) == FL_VALUE_TYPE_STRING) {
+      task->file_prefix = fl_value_get_string(file_prefix);
+    }
+    task->options = encode_options;
+    FlValue* change_key = fl_value_lookup_string(args, "changeKey");
+    if (change_key != nullptr && fl_value_get_type(change_key) == FL_VALUE_TYPE_STRING) {
+      task->change_key = fl_value_get_string(change_key);
+    }
+    FlValue* tile_delta = fl_value_lookup_string(args, "tileDelta");
+    task->tile_delta = tile_delta != nullptr &&
+                       fl_value_get_type(tile_delta) == FL_VALUE_TYPE_BOOL &&
+                       fl_value_get_bool(tile_delta);
+    task->dedup_distance = CLAMP(dedup_distance, -1, 64);
+
+    std::shared_ptr<ScheduledTask> replaced;
+    capture_core::ScheduleId id = 0;
+    {
+      // 持有锁直到登记完成：第一次触发可能立即就是最后一次，end_scheduled_task 要能看到登记
+      std::lock_guard<std::mutex> lock(self->schedules_mutex);
+      auto it = self->schedules.find(task->task_id);
+      if (it != self->schedules.end()) {
+        replaced = it->second;
+        self->schedules.erase(it);
+      }
+      id = self->scheduler->Start(
+          options,
+          [self, task](capture_core::ScheduledShot shot,
+                       const capture_core::CancellationToken& token) {
+            run_scheduled_shot(self, task, std::move(shot), token);
+          },
+          [self, task](const capture_core::ScheduledShot& shot,
+                       capture_core::SkipReason reason) {
+            if (shot.last) {
+              end_scheduled_task(self, task->task_id, shot.schedule);
+            }
+            FlValue* event = scheduled_shot_event(*task, shot);
+            fl_value_set_string_take(event, "reason",
+                                     fl_value_new_string(skip_reason_name(reason)));
+            post_scheduled_shot(self->channel, event, "skipped");
+          });
+      if (id != 0) {
+        task->schedule_id = id;
+        self->schedules[task->task_id] = task;
+      }
+    }
+    // Stop 会同步取消排队中的触发，回调里要拿 schedules_mutex，必须在锁外调用
+    if (replaced) {
+      self->scheduler->Stop(replaced->schedule_id);
+    }
+    if (id == 0) {
+      respond_error(method_call, "SCHEDULE_ERROR", "Failed to start schedule");
+      return;
+    }
+    g_autoptr(FlValue) result = fl_value_new_int(static_cast<int64_t>(id));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "stopSchedule") == 0) {
+    // 停止循环任务的原生计划；排队中的触发取消，正在写的文件照常完成
+    FlValue* task_id = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                           ? fl_value_lookup_string(args, "taskId")
+                           : nullptr;
+    if (task_id == nullptr || fl_value_get_type(task_id) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing taskId parameter");
+      return;
+    }
+    std::shared_ptr<ScheduledTask> task;
+    {
+      std::lock_guard<std::mutex> lock(self->schedules_mutex);
+      auto it = self->schedules.find(fl_value_get_string(task_id));
+      if (it != self->schedules.end()) {
+        task = it->second;
+        self->schedules.erase(it);
+      }
+    }
+    g_autoptr(FlValue) result =
+        fl_value_new_bool(task && self->scheduler->Stop(task->schedule_id));
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "startRecording") == 0) {
+    // 区域录屏：按 fps 采集 x/y/width/height（屏幕坐标），边录边把 GIF 或 APNG 写到 path
+    if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    int x = 0, y = 0, width = 0, height = 0, fps = 10;
+    if (!read_int_arg(args, "x", &x) || !read_int_arg(args, "y", &y) ||
+        !read_int_arg(args, "width", &width) ||
+        !read_int_arg(args, "height", &height) || width <= 0 || height <= 0) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Invalid recording region");
+      return;
+    }
+    read_int_arg(args, "fps", &fps);
+    FlValue* path = fl_value_lookup_string(args, "path");
+    if (path == nullptr || fl_value_get_type(path) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing path parameter");
+      return;
+    }
+    FlValue* format = fl_value_lookup_string(args, "format");
+    capture_core::RecorderOptions options;
+    options.region = capture_core::Rect(x, y, width, height);
+    options.fps = CLAMP(fps, 1, capture_core::ScreenRecorder::kMaxFps);
+    options.format = format != nullptr && fl_value_get_type(format) == FL_VALUE_TYPE_STRING &&
+                             g_strcmp0(fl_value_get_string(format), "apng") == 0
+                         ? capture_core::AnimationFormat::kApng
+                         : capture_core::AnimationFormat::kGif;
+    options.path = fl_value_get_string(path);
+    if (self->recorder) {
+      respond_error(method_call, "RECORDING_ACTIVE", "A recording is already in progress");
+      return;
+    }
+#ifdef CAPTURE_CORE_HAS_X11
+    // 共享内存段只按录制区域分配
+    auto source = std::unique_ptr<capture_core::X11ShmFrameSource>(
+        new capture_core::X11ShmFrameSource(nullptr, options.region));
+    if (!source->is_open()) {
+      respond_error(method_call, "UNAVAILABLE", "Cannot open X11 display");
+      return;
+    }
+    std::unique_ptr<capture_core::ScreenRecorder> recorder(
+        new capture_core::ScreenRecorder(std::move(source)));
+    if (!recorder->Start(options)) {
+      respond_error(method_call, "RECORDING_ERROR", "Failed to start recording");
+      return;
+    }
+    self->recorder = std::move(recorder);
+    g_autoptr(FlValue) result = fl_value_new_bool(TRUE);
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+#else
+    respond_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+  } else if (g_strcmp0(method, "stopRecording") == 0) {
+    // 停止录屏：写完缓冲中的帧、关闭文件在工作线程完成，回复录制统计；
+    // 没有在录屏或文件写入失败时回复 null
+    if (!self->recorder) {
+      g_autoptr(FlMethodResponse) response =
+          FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+      fl_method_call_respond(method_call, response, nullptr);
+      return;
+    }
+    // 不经过 submit_job：录制不能因为排队被拒绝或取消而丢失（析构 ScreenRecorder
+    // 会删除写了一半的文件）。提交成功之前 self->recorder 保持不变，BUSY 时仍在录制、
+    // 可以再次停止；排队中被取消时在取消的线程上照常 Stop
+    std::shared_ptr<FlMethodCall> call(FL_METHOD_CALL(g_object_ref(method_call)),
+                                       g_object_unref);
+    std::shared_ptr<capture_core::ScreenRecorder> recorder = self->recorder;
+    auto finish = [call, recorder]() {
+      post_completion(call.get(), recording_stats_value(recorder->Stop()), nullptr, nullptr);
+    };
+    capture_core::JobId id = self->jobs->Submit(
+        [finish](const capture_core::CancellationToken&) { finish(); }, finish);
+    if (id == 0) {
+      respond_error(method_call, "BUSY", "Too many pending capture requests");
+      return;
+    }
+    self->recorder.reset();
+  } else if (g_strcmp0(method, "startInstantReplay") == 0) {
+    // 即时回放：按 fps 持续采集 x/y/width/height（通常是一个显示器），只保留最近 seconds 秒，
+    // 压缩帧不超过 memoryLimitMb；saveInstantReplay 缺省写到 directory。
+    // 已在运行时按新参数重新开始
+    if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    int x = 0, y = 0, width = 0, height = 0, fps = 2, seconds = 30, memory_limit_mb = 64;
+    if (!read_int_arg(args, "x", &x) || !read_int_arg(args, "y", &y) ||
+        !read_int_arg(args, "width", &width) ||
+        !read_int_arg(args, "height", &height) || width <= 0 || height <= 0) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Invalid replay region");
+      return;
+    }
+    read_int_arg(args, "fps", &fps);
+    read_int_arg(args, "seconds", &seconds);
+    read_int_arg(args, "memoryLimitMb", &memory_limit_mb);
+    FlValue* directory = fl_value_lookup_string(args, "directory");
+    if (directory == nullptr || fl_value_get_type(directory) != FL_VALUE_TYPE_STRING) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing directory parameter");
+      return;
+    }
+    FlValue* format = fl_value_lookup_string(args, "format");
+    capture_core::ReplayOptions options;
+    options.region = capture_core::Rect(x, y, width, height);
+    options.fps = CLAMP(fps, 1, capture_core::InstantReplay::kMaxFps);
+    options.duration = std::chrono::seconds(CLAMP(seconds, 1, 600));
+    options.memory_limit = static_cast<size_t>(CLAMP(memory_limit_mb, 8, 2048)) << 20;
+    self->replay.reset();
+#ifdef CAPTURE_CORE_HAS_X11
+    // 录屏一样用自己的连接，共享内存段只按采集范围分配
+    auto source = std::unique_ptr<capture_core::X11ShmFrameSource>(
+        new capture_core::X11ShmFrameSource(nullptr, options.region));
+    if (!source->is_open()) {
+      respond_error(method_call, "UNAVAILABLE", "Cannot open X11 display");
+      return;
+    }
+    auto replay = std::make_shared<capture_core::InstantReplay>(std::move(source));
+    if (!replay->Start(options)) {
+      respond_error(method_call, "REPLAY_ERROR", "Failed to start instant replay");
+      return;
+    }
+    self->replay = std::move(replay);
+    self->replay_directory = fl_value_get_string(directory);
+    self->replay_format = format != nullptr && fl_value_get_type(format) == FL_VALUE_TYPE_STRING &&
+                                  g_strcmp0(fl_value_get_string(format), "gif") == 0
+                              ? capture_core::AnimationFormat::kGif
+                              : capture_core::AnimationFormat::kApng;
+    g_autoptr(FlValue) result = fl_value_new_bool(TRUE);
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+#else
+    (void)format;
+    respond_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+  } else if (g_strcmp0(method, "stopInstantReplay") == 0) {
+    // 停止采集并释放缓冲；回复之前是否在运行
+    g_autoptr(FlValue) result = fl_value_new_bool(self->replay != nullptr);
+    self->replay.reset();
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "saveInstantReplay") == 0) {
+    // 把最近的画面写到 path（缺省时写到 startInstantReplay 的目录），在工作线程完成；
+    // 没有在运行、还没有画面或写入失败时回复 null
+    if (!self->replay) {
+      g_autoptr(FlMethodResponse) response =
+          FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+      fl_method_call_respond(method_call, response, nullptr);
+      return;
+    }
+    FlValue* path_value = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                              ? fl_value_lookup_string(args, "path")
+                              : nullptr;
+    const std::string path =
+        path_value != nullptr && fl_value_get_type(path_value) == FL_VALUE_TYPE_STRING
+            ? std::string(fl_value_get_string(path_value))
+            : replay_file_path(self->replay_directory, self->replay_format);
+    std::shared_ptr<capture_core::InstantReplay> replay = self->replay;
+    const capture_core::AnimationFormat format = self->replay_format;
+    submit_job(self, method_call,
+               [replay, format, path](FlMethodCall* call, const capture_core::CancellationToken&) {
+                 capture_core::ReplayExport exported;
+                 if (!replay->Save(format, path, &exported)) {
+                   post_completion(call, nullptr, nullptr, nullptr);
+                   return;
+                 }
+                 FlValue* result = fl_value_new_map();
+                 fl_value_set_string_take(result, "path", fl_value_new_string(path.c_str()));
+                 fl_value_set_string_take(
+                     result, "format",
+                     fl_value_new_string(format == capture_core::AnimationFormat::kGif ? "gif"
+                                                                                       : "apng"));
+                 fl_value_set_string_take(result, "frames", fl_value_new_int(exported.frames));
+                 fl_value_set_string_take(result, "durationMs",
+                                          fl_value_new_int(exported.duration.count()));
+                 fl_value_set_string_take(result, "bytes",
+                                          fl_value_new_int(static_cast<int64_t>(exported.bytes)));
+                 post_completion(call, result, nullptr, nullptr);
+               });
+  } else if (g_strcmp0(method, "getInstantReplayStats") == 0) {
+    // 空闲开销的观测：采集线程的 CPU 时间、压缩帧和工作缓冲的内存；没有在运行时回复 null
+    g_autoptr(FlValue) result =
+        self->replay ? replay_stats_value(self->replay->stats()) : nullptr;
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else if (g_strcmp0(method, "getAvailableWindows") == 0) {
+    // EWMH 的 _NET_CLIENT_LIST，最近映射的在前，图标取 _NET_WM_ICON 中最接近 32px 的一张
+    submit_job(self, method_call,
+               [](FlMethodCall* call, const capture_core::CancellationToken&) {
+#ifdef CAPTURE_CORE_HAS_X11
+                 post_completion(call, window_list_value(capture_core::EnumerateX11Windows()),
+                                 nullptr, nullptr);
+#else
+                 post_error(call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+               });
+  } else if (g_strcmp0(method, "captureWindow") == 0) {
+    uint64_t window = 0;
+    if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP ||
+        !parse_window_id(fl_value_lookup_string(args, "windowId"), &window)) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing windowId parameter");
+      return;
+    }
+    submit_job(self, method_call,
+               [self, window, encode_options](FlMethodCall* call,
+                                              const capture_core::CancellationToken& token) {
+                 run_window_capture(self, call, window, encode_options, token);
+               });
+  } else if (g_strcmp0(method, "captureWindows") == 0) {
+    FlValue* ids = args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP
+                       ? fl_value_lookup_string(args, "windowIds")
+                       : nullptr;
+    if (ids == nullptr || fl_value_get_type(ids) != FL_VALUE_TYPE_LIST) {
+      respond_error(method_call, "INVALID_ARGUMENTS", "Missing windowIds parameter");
+      return;
+    }
+    std::vector<uint64_t> windows;
+    for (size_t i = 0; i < fl_value_get_length(ids); i++) {
+      uint64_t window = 0;
+      if (!parse_window_id(fl_value_get_list_value(ids, i), &window)) {
+        respond_error(method_call, "INVALID_ARGUMENTS",
+                      "Invalid windowIds type, expected strings");
+        return;
+      }
+      windows.push_back(window);
+    }
+    int max_size = 0;
+    read_int_arg(args, "maxSize", &max_size);
+    max_size = CLAMP(max_size, 0, 16384);
+    submit_job(self, method_call,
+               [windows, max_size, encode_options](
+                   FlMethodCall* call, const capture_core::CancellationToken& token) {
+                 run_window_batch(call, windows, max_size, encode_options, token);
+               });
+  } else if (g_strcmp0(method, "startWindowTracking") == 0) {
+    // 回复初始列表；之后的变化在跟踪线程上合并，通过 onWindowsChanged 推送
+#ifdef CAPTURE_CORE_HAS_X11
+    if (!self->window_tracker) {
+      self->window_tracker.reset(new capture_core::X11WindowTracker());
+    }
+    if (!self->window_tracker->running()) {
+      FlMethodChannel* channel = self->channel;
+      if (!self->window_tracker->Start([channel](const capture_core::WindowListDiff& diff) {
+            FlValue* removed = fl_value_new_list();
+            for (uint64_t id : diff.removed) {
+              fl_value_append_take(removed, fl_value_new_string(window_id_string(id).c_str()));
+            }
+            FlValue* event = fl_value_new_map();
+            fl_value_set_string_take(event, "added", window_list_value(diff.added));
+            fl_value_set_string_take(event, "updated", window_list_value(diff.updated));
+            fl_value_set_string_take(event, "removed", removed);
+            g_idle_add(notify_dart_cb,
+                       new DartNotification{FL_METHOD_CHANNEL(g_object_ref(channel)),
+                                            "onWindowsChanged", event});
+          })) {
+        respond_error(method_call, "UNAVAILABLE", "Cannot open X display");
+        return;
+      }
+    }
+    g_autoptr(FlValue) result = window_list_value(self->window_tracker->Snapshot());
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(result));
+    fl_method_call_respond(method_call, response, nullptr);
+#else
+    respond_error(method_call, "UNAVAILABLE", "X11 capture is not available");
+#endif
+  } else if (g_strcmp0(method, "stopWindowTracking") == 0) {
+#ifdef CAPTURE_CORE_HAS_X11
+    if (self->window_tracker) {
+      self->window_tracker->Stop();
+    }
+#endif
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    fl_method_call_respond(method_call, response, nullptr);
+  } else {
+    g_autoptr(FlMethodResponse) response =
+        FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+    fl_method_call_respond(method_call, response, nullptr);
+  }
+}
+
+ScreenshotChannel* screenshot_channel_new(FlBinaryMessenger* messenger,
+                                          FlTextureRegistrar* texture_registrar) {
+  ScreenshotChannel* self = new ScreenshotChannel();
+  self->texture_registrar =
+      static_cast<FlTextureRegistrar*>(g_object_ref(texture_registrar));
+  self->encodes.reset(new capture_core::EncodeQueue(
+      []() {
+        return std::unique_ptr<capture_core::FrameEncoder>(new capture_core::PngEncoder());
+      },
+      kEncodeWorkerCount, kMaxPendingEncodes));
+  self->transcoder.reset(new capture_core::IdleTranscoder(kTranscodeIdleDelay));
+  self->jobs.reset(
+      new capture_core::JobQueue(kCaptureWorkerCount, kMaxPendingCaptures));
+  self->scheduler.reset(new capture_core::CaptureScheduler(self->jobs.get()));
+  g_autoptr(FlStandardMethodCodec) codec = fl_standard_method_codec_new();
+  self->channel = fl_method_channel_new(messenger,
+                                        "com.example.screenshot/screenshot",
+                                        FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(self->channel, method_call_cb, self,
+                                            nullptr);
+  return self;
+}
+
+void screenshot_channel_free(ScreenshotChannel* self) {
+  if (self == nullptr) {
+    return;
+  }
+  fl_method_channel_set_method_call_handler(self->channel, nullptr, nullptr,
+                                            nullptr);
+  // 先停止循环截图的调度线程（排队中的触发以 skipped 通知），它不再提交新的截图
+  self->scheduler.reset();
+  self->schedules.clear();
+  // 录到一半退出时放弃录制，不完整的文件被删除
+  self->recorder.reset();
+  self->replay.reset();
+#ifdef CAPTURE_CORE_HAS_X11
+  // 停止窗口跟踪线程，之后不再有 onWindowsChanged 通知
+  self->window_tracker.reset();
+#endif
+  // 取消排队的请求并等待正在运行的截图结束
+  self->jobs.reset();
+  // 截图任务已停止，不会再提交新帧；未编码完的帧以 cancelled 通知（通知持有通道引用）
+  self->encodes.reset();
+  // 尚未转码的 QOI 文件保留在磁盘上，Dart 下次启动时重新提交
+  self->transcoder.reset();
+  // 工作线程已停止，不会再注册新纹理
+  std::vector<int64_t> texture_ids;
+  for (const auto& entry : self->textures) {
+    texture_ids.push_back(entry.first);
+  }
+  for (int64_t texture_id : texture_ids) {
+    dispose_texture(self, texture_id);
+  }
+  g_clear_object(&self->texture_registrar);
+  g_clear_object(&self->channel);
+  delete self;
+}
@@ -0,0 +1,17 @@
+#ifndef RUNNER_SCREENSHOT_CHANNEL_H_
+#define RUNNER_SCREENSHOT_CHANNEL_H_
+
+#include <flutter_linux/flutter_linux.h>
+
+// com.example.screenshot/screenshot 通道的 Linux 实现。
+//
+// 截图走 capture_core 的 X11 MIT-SHM 来源，编码为 PNG 后以
+// Uint8List 返回给 Dart；两阶段截图的预览帧通过 texture_registrar 注册为外部纹理。
+typedef struct _ScreenshotChannel ScreenshotChannel;
+
+ScreenshotChannel* screenshot_channel_new(FlBinaryMessenger* messenger,
+                                          FlTextureRegistrar* texture_registrar);
+
+void screenshot_channel_free(ScreenshotChannel* self);
+
+#endif  // RUNNER_SCREENSHOT_CHANNEL_H_
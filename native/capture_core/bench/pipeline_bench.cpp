@@ -0,0 +1,489 @@
+// 截图流水线基准测试：合成来源 -> PNG 编码
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "capture_core/animation_writer.h"
+#include "capture_core/batch_capture.h"
+#include "capture_core/capture_pipeline.h"
+#include "capture_core/damage_tracker.h"
+#include "capture_core/jpeg_encoder.h"
+#include "capture_core/palette_quantizer.h"
+#include "capture_core/perceptual_hash.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/qoi_codec.h"
+#include "capture_core/replay_buffer.h"
+#include "capture_core/scroll_stitcher.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "capture_core/thread_pool.h"
+#include "capture_core/tile_change_detector.h"
+#include "capture_core/window_rect_index.h"
+
+namespace capture_core {
+namespace {
+
+void SetFrameArgs(benchmark::internal::Benchmark* bench) {
+    bench->Args({1920, 1080})->Args({3840, 2160})->Unit(benchmark::kMillisecond);
+}
+
+void BM_SyntheticCapture(benchmark::State& state) {
+    SyntheticFrameSource source(static_cast<int>(state.range(0)),
+                                static_cast<int>(state.range(1)),
+                                SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    for (auto _ : state) {
+        source.Capture(source.GetBounds(), &frame);
+        benchmark::DoNotOptimize(frame.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+}
+BENCHMARK(BM_SyntheticCapture)->Apply(SetFrameArgs);
+
+void BM_CaptureAndEncodePng(benchmark::State& state) {
+    SyntheticFrameSource source(static_cast<int>(state.range(0)),
+                                static_cast<int>(state.range(1)),
+                                SyntheticFrameSource::Pattern::kUi);
+    PngEncoder encoder;
+    CapturePipeline pipeline(&source, &encoder);
+    std::vector<uint8_t> png;
+    int64_t capture_us = 0;
+    int64_t encode_us = 0;
+    for (auto _ : state) {
+        pipeline.CaptureFull(&png);
+        capture_us += pipeline.last_timings().capture_us;
+        encode_us += pipeline.last_timings().encode_us;
+    }
+    state.counters["capture_ms"] = benchmark::Counter(
+        capture_us / 1000.0, benchmark::Counter::kAvgIterations);
+    state.counters["encode_ms"] = benchmark::Counter(
+        encode_us / 1000.0, benchmark::Counter::kAvgIterations);
+    state.counters["png_bytes"] = static_cast<double>(png.size());
+}
+BENCHMARK(BM_CaptureAndEncodePng)->Apply(SetFrameArgs);
+
+// 参数：宽、高、zlib 级别、工作线程数（不含调用线程）
+void BM_EncodePngParallel(benchmark::State& state) {
+    SyntheticFrameSource source(static_cast<int>(state.range(0)),
+                                static_cast<int>(state.range(1)),
+                                SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+
+    ThreadPool pool(static_cast<int>(state.range(3)));
+    PngEncoderOptions options;
+    options.compression_level = static_cast<int>(state.range(2));
+    options.pool = &pool;
+    PngEncoder encoder(options);
+    std::vector<uint8_t> png;
+    for (auto _ : state) {
+        encoder.Encode(frame, &png);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+    state.counters["png_bytes"] = static_cast<double>(png.size());
+    state.counters["bands"] = encoder.last_band_count();
+}
+BENCHMARK(BM_EncodePngParallel)
+    ->ArgsProduct({{3840}, {2160}, {1, 3, 6}, {0, 3, 7}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 4K 帧的 JPEG 与 PNG 对比：range(2) 选内容（0 = UI，1 = 照片），range(3) 为 0 时编 PNG、否则为 JPEG 质量
+void BM_EncodeJpegVsPng(benchmark::State& state) {
+    SyntheticFrameSource source(static_cast<int>(state.range(0)),
+                                static_cast<int>(state.range(1)),
+                                state.range(2) == 0 ? SyntheticFrameSource::Pattern::kUi
+                                                    : SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+
+    std::unique_ptr<FrameEncoder> encoder;
+    if (state.range(3) == 0) {
+        encoder.reset(new PngEncoder());
+    } else {
+        JpegEncoderOptions options;
+        options.quality = static_cast<int>(state.range(3));
+        encoder.reset(new JpegEncoder(options));
+    }
+    std::vector<uint8_t> bytes;
+    for (auto _ : state) {
+        encoder->Encode(frame, &bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+    state.counters["encoded_bytes"] = static_cast<double>(bytes.size());
+}
+BENCHMARK(BM_EncodeJpegVsPng)
+    ->ArgsProduct({{3840}, {2160}, {0, 1}, {0, 75, 90}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 4K 帧的 QOI 落盘编码（循环截图的快速存储格式）；range(2) 同上
+void BM_EncodeQoi(benchmark::State& state) {
+    SyntheticFrameSource source(static_cast<int>(state.range(0)),
+                                static_cast<int>(state.range(1)),
+                                state.range(2) == 0 ? SyntheticFrameSource::Pattern::kUi
+                                                    : SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+
+    QoiEncoder encoder;
+    std::vector<uint8_t> bytes;
+    for (auto _ : state) {
+        encoder.Encode(frame, &bytes);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+    state.counters["encoded_bytes"] = static_cast<double>(bytes.size());
+}
+BENCHMARK(BM_EncodeQoi)
+    ->ArgsProduct({{3840}, {2160}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 4K 帧的分块哈希比较（循环截图的变化检测），参考帧已建立、画面未变化
+void BM_TileChangeDetect(benchmark::State& state) {
+    SyntheticFrameSource source(3840, 2160, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+
+    TileChangeDetector detector(static_cast<int>(state.range(0)));
+    detector.Compare(frame);
+    detector.UpdateReference();
+    size_t dirty = 0;
+    for (auto _ : state) {
+        dirty = detector.Compare(frame).dirty_count;
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+    state.counters["dirty_tiles"] = static_cast<double>(dirty);
+}
+BENCHMARK(BM_TileChangeDetect)->Arg(32)->Arg(64)->Arg(128)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 4K 帧的感知哈希（循环截图的近似重复过滤，每次截图都计算）
+void BM_DifferenceHash(benchmark::State& state) {
+    SyntheticFrameSource source(3840, 2160, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+
+    uint64_t hash = 0;
+    for (auto _ : state) {
+        hash = DifferenceHash(frame);
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+}
+BENCHMARK(BM_DifferenceHash)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 1080p 帧的 GIF 调色板量化（统计 + 映射）；range(0) 为 0 时是 UI 画面（精确颜色），
+// 为 1 时是高熵画面（median cut）
+void BM_QuantizePalette(benchmark::State& state) {
+    SyntheticFrameSource source(1920, 1080,
+                                state.range(0) == 0 ? SyntheticFrameSource::Pattern::kUi
+                                                    : SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+
+    PaletteQuantizer quantizer;
+    Palette palette;
+    std::vector<uint8_t> indices(static_cast<size_t>(frame.width()) * frame.height());
+    for (auto _ : state) {
+        quantizer.Build(frame, frame.bounds(), nullptr, 255, &palette);
+        quantizer.Map(frame, frame.bounds(), nullptr, 255, indices.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(frame.size_bytes()));
+    state.counters["colors"] = static_cast<double>(palette.size);
+}
+BENCHMARK(BM_QuantizePalette)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 录屏的单帧开销：1080p UI 画面中方块移动，差分后写出一帧 GIF / APNG；
+// range(0) 为 AnimationFormat
+void BM_RecordAnimationFrame(benchmark::State& state) {
+    const auto format = static_cast<AnimationFormat>(state.range(0));
+    SyntheticFrameSource source(1920, 1080, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frames[2];
+    source.Capture(source.GetBounds(), &frames[0]);
+    source.Capture(source.GetBounds(), &frames[1]);
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "capture_core_bench_record").u8string();
+    auto writer = AnimationWriter::Create(format);
+    writer->Open(path);
+    int64_t index = 0;
+    for (auto _ : state) {
+        writer->AddFrame(frames[index & 1], std::chrono::milliseconds(index * 100));
+        index++;
+    }
+    state.counters["bytes_per_frame"] =
+        static_cast<double>(writer->bytes_written()) / static_cast<double>(index);
+    writer->Abort();
+}
+BENCHMARK(BM_RecordAnimationFrame)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 即时回放的单帧开销（不含采集本身）：4K UI 画面，range(0) 为 0 时画面静止（常开时的
+// 空闲成本，只有比较），为 1 时方块移动（差分帧）。bytes_per_frame 为平均每帧的压缩占用
+void BM_ReplayPush(benchmark::State& state) {
+    SyntheticFrameSource source(3840, 2160, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frames[2];
+    source.Capture(source.GetBounds(), &frames[0]);
+    source.Capture(source.GetBounds(), &frames[1]);
+
+    ReplayBuffer buffer(std::chrono::seconds(30), size_t(256) << 20);
+    auto time = ReplayBuffer::Clock::now();
+    int64_t index = 0;
+    for (auto _ : state) {
+        buffer.Push(frames[state.range(0) == 0 ? 0 : index & 1], time);
+        time += std::chrono::milliseconds(500);
+        index++;
+    }
+    const ReplayStats stats = buffer.stats();
+    state.counters["bytes_per_frame"] =
+        static_cast<double>(stats.bytes) / static_cast<double>(stats.frames + stats.unchanged);
+    state.counters["working_mb"] = static_cast<double>(stats.working_bytes) / (1 << 20);
+}
+BENCHMARK(BM_ReplayPush)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 长截图的单帧开销：1080p UI 页面每帧滚动 300 行，包括行哈希、找重叠和写出新露出的行
+// （PNG kFast）。每 16 帧换一个文件重新开始
+void BM_ScrollStitchFrame(benchmark::State& state) {
+    const int kSteps = 16;
+    const int kStep = 300;
+    SyntheticFrameSource source(1920, 1080 + kSteps * kStep, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer page;
+    source.Capture(source.GetBounds(), &page);
+
+    const std::string path =
+        (std::filesystem::temp_directory_path() / "capture_core_bench_scroll.png").u8string();
+    ScrollStitcher stitcher(ScrollStitchOptions(), PngEncoderOptions::ForEffort(PngEffort::kFast));
+    int step = kSteps;
+    for (auto _ : state) {
+        if (step == kSteps) {
+            state.PauseTiming();
+            stitcher.Finish();
+            stitcher.Open(path);
+            step = 0;
+            state.ResumeTiming();
+        }
+        FrameBuffer frame = page.View(Rect(0, step * kStep, 1920, 1080));
+        stitcher.AddFrame(frame);
+        step++;
+    }
+    stitcher.Abort();
+}
+BENCHMARK(BM_ScrollStitchFrame)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 窗口选择器一次取 12 个 1280x800 窗口的 320 像素 PNG 缩略图；
+// Arg(0) 是没有工作线程的池（逐个截取，相当于逐个调用 captureWindow），Arg(1) 是共享线程池
+void BM_CaptureWindowBatch(benchmark::State& state) {
+    const int kWindows = 12;
+    std::vector<std::unique_ptr<SyntheticFrameSource>> windows;
+    std::vector<FrameSource*> sources;
+    for (int i = 0; i < kWindows; i++) {
+        windows.push_back(std::make_unique<SyntheticFrameSource>(
+            1280, 800, SyntheticFrameSource::Pattern::kUi));
+        sources.push_back(windows.back().get());
+    }
+    ThreadPool serial(0);
+    BatchCaptureOptions options;
+    options.max_dimension = 320;
+    options.pool = state.range(0) ? ThreadPool::Shared() : &serial;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        std::vector<BatchCaptureItem> items = CaptureBatch(sources, options);
+        bytes = 0;
+        for (const BatchCaptureItem& item : items) {
+            bytes += item.bytes.size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.counters["thumbnail_kb"] = static_cast<double>(bytes) / kWindows / 1024;
+}
+BENCHMARK(BM_CaptureWindowBatch)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 区域选择蒙版的悬停检测：60 个窗口、每个 40 个子控件，在 4K 桌面上随机取点；
+// Arg(0) 按 z 序逐个比较所有矩形，Arg(1) 用 WindowRectIndex 只扫描一个格子
+void BM_WindowRectHitTest(benchmark::State& state) {
+    const Rect desktop(0, 0, 3840, 2160);
+    WindowRectIndex index(desktop);
+    std::mt19937 rng(1);
+    for (int window = 0; window < 60; window++) {
+        const int top = index.Add(window, Rect(static_cast<int>(rng() % 3000),
+                                               static_cast<int>(rng() % 1600),
+                                               400 + static_cast<int>(rng() % 1400),
+                                               300 + static_cast<int>(rng() % 900)));
+        if (top < 0) continue;
+        const Rect area = index.entry(top).rect;
+        for (int child = 0; child < 40; child++) {
+            index.Add(1000 + child,
+                      Rect(area.x + static_cast<int>(rng() % area.width),
+                           area.y + static_cast<int>(rng() % area.height),
+                           20 + static_cast<int>(rng() % 300), 20 + static_cast<int>(rng() % 120)),
+                      top);
+        }
+    }
+    std::vector<WindowRectEntry> entries;
+    for (size_t i = 0; i < index.size(); i++) {
+        entries.push_back(index.entry(static_cast<int>(i)));
+    }
+    std::vector<std::pair<int, int>> points;
+    for (int i = 0; i < 1024; i++) {
+        points.emplace_back(static_cast<int>(rng() % 3840), static_cast<int>(rng() % 2160));
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        const std::pair<int, int>& point = points[next++ & 1023];
+        int hit = -1;
+        if (state.range(0)) {
+            hit = index.DeepestAt(point.first, point.second);
+        } else {
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (entries[i].parent == hit &&
+                    entries[i].rect.Contains(point.first, point.second)) {
+                    hit = static_cast<int>(i);
+                }
+            }
+        }
+        benchmark::DoNotOptimize(hit);
+    }
+    state.counters["rects"] = static_cast<double>(entries.size());
+    state.counters["max_cell"] = static_cast<double>(index.max_cell_entries());
+}
+BENCHMARK(BM_WindowRectHitTest)->Arg(0)->Arg(1);
+
+// 区域选择蒙版一帧的状态（与 NativeScreenshotWindow 的元素尺寸一致）
+struct SelectorFrame {
+    Rect selection;
+    bool dashed = false;
+    bool selected = false;
+    int toolbar_hover = 0;
+    int mouse_x = 0;
+    int mouse_y = 0;
+};
+
+// 一段 60 Hz 的鼠标轨迹：在三个窗口之间悬停，框选，拖右下角调整大小，移到工具栏
+std::vector<SelectorFrame> RecordSelectorTrace() {
+    const Rect windows[] = {Rect(200, 150, 1600, 1000), Rect(1700, 300, 1800, 1400),
+                            Rect(500, 1300, 1000, 700)};
+    std::vector<SelectorFrame> trace;
+    auto lerp = [](int from, int to, int step, int steps) {
+        return from + (to - from) * step / steps;
+    };
+    for (int i = 0; i < 180; i++) {
+        SelectorFrame frame;
+        frame.mouse_x = lerp(300, 3400, i, 180);
+        frame.mouse_y = lerp(400, 1800, i, 180);
+        for (const Rect& window : windows) {
+            if (window.Contains(frame.mouse_x, frame.mouse_y)) {
+                frame.selection = window;
+                frame.dashed = true;
+                break;
+            }
+        }
+        trace.push_back(frame);
+    }
+    for (int i = 1; i <= 90; i++) {
+        SelectorFrame frame;
+        frame.mouse_x = lerp(600, 2400, i, 90);
+        frame.mouse_y = lerp(400, 1500, i, 90);
+        frame.selection = Rect(600, 400, frame.mouse_x - 600, frame.mouse_y - 400);
+        trace.push_back(frame);
+    }
+    for (int i = 0; i <= 60; i++) {
+        SelectorFrame frame;
+        frame.selected = true;
+        frame.mouse_x = lerp(2400, 2200, i, 60);
+        frame.mouse_y = lerp(1500, 1300, i, 60);
+        frame.selection = Rect(600, 400, frame.mouse_x - 600, frame.mouse_y - 400);
+        trace.push_back(frame);
+    }
+    for (int i = 0; i <= 40; i++) {
+        SelectorFrame frame;
+        frame.selected = true;
+        frame.selection = Rect(600, 400, 1600, 900);
+        frame.mouse_x = lerp(1900, 2170, i, 40);
+        frame.mouse_y = lerp(1200, 1320, i, 40);
+        if (frame.mouse_y >= 1304 && frame.mouse_x >= 2122) {
+            frame.toolbar_hover = frame.mouse_x >= 2156 ? 2 : 1;
+        }
+        trace.push_back(frame);
+    }
+    return trace;
+}
+
+void SetSelectorLayers(const SelectorFrame& frame, DamageTracker* tracker) {
+    const Rect& s = frame.selection;
+    tracker->SetHole(0, s);
+    if (!s.empty()) {
+        // 3px 边框
+        tracker->SetLayer(1, Rect(s.x - 2, s.y - 2, s.width + 4, 4), frame.dashed);
+        tracker->SetLayer(2, Rect(s.x - 2, s.bottom() - 2, s.width + 4, 4), frame.dashed);
+        tracker->SetLayer(3, Rect(s.x - 2, s.y - 2, 4, s.height + 4), frame.dashed);
+        tracker->SetLayer(4, Rect(s.right() - 2, s.y - 2, 4, s.height + 4), frame.dashed);
+    }
+    if (frame.selected) {
+        const int xs[] = {s.x, s.x + s.width / 2, s.right()};
+        const int ys[] = {s.y, s.y + s.height / 2, s.bottom()};
+        uint32_t id = 10;
+        for (int y : ys) {
+            for (int x : xs) {
+                if (x != xs[1] || y != ys[1]) {
+                    tracker->SetLayer(id++, Rect(x - 5, y - 5, 10, 10));
+                }
+            }
+        }
+        tracker->SetLayer(20, Rect(s.x - 160, s.y - 30, 160, 30),
+                          (static_cast<uint64_t>(s.width) << 32) | static_cast<uint32_t>(s.height));
+        tracker->SetLayer(21, Rect(s.right() - 90, s.bottom(), 90, 40), frame.toolbar_hover);
+    }
+    // 放大镜（含阴影和颜色值）跟随鼠标
+    tracker->SetLayer(30, Rect(frame.mouse_x + 18, frame.mouse_y + 18, 157, 194),
+                      (static_cast<uint64_t>(frame.mouse_x) << 32) |
+                          static_cast<uint32_t>(frame.mouse_y));
+}
+
+// 回放区域选择的鼠标轨迹，每帧把需要重画的部分从加暗的底图拷进常驻的后台缓冲；
+// Arg(0) 每帧整屏重画（原来的 InvalidateRect(NULL)），Arg(1) 只重画 DamageTracker 给出的矩形
+void BM_SelectorRepaintReplay(benchmark::State& state) {
+    const Rect desktop(0, 0, 3840, 2160);
+    const std::vector<SelectorFrame> trace = RecordSelectorTrace();
+    FrameBuffer dimmed(desktop.width, desktop.height, PixelFormat::kBgra8);
+    FrameBuffer back(desktop.width, desktop.height, PixelFormat::kBgra8);
+    std::memset(dimmed.data(), 0x40, dimmed.size_bytes());
+
+    DamageTracker tracker;
+    uint64_t pixels = 0;
+    uint64_t peak = 0;
+    for (auto _ : state) {
+        tracker.Reset(desktop);
+        pixels = 0;
+        peak = 0;
+        for (const SelectorFrame& frame : trace) {
+            SetSelectorLayers(frame, &tracker);
+            std::vector<Rect> damage = tracker.Commit();
+            if (state.range(0) == 0) {
+                damage.assign(1, desktop);
+            }
+            uint64_t touched = 0;
+            for (const Rect& rect : damage) {
+                for (int y = rect.y; y < rect.bottom(); y++) {
+                    std::memcpy(back.row(y) + rect.x * 4, dimmed.row(y) + rect.x * 4,
+                                static_cast<size_t>(rect.width) * 4);
+                }
+                touched += static_cast<uint64_t>(rect.width) * rect.height;
+            }
+            pixels += touched;
+            peak = std::max(peak, touched);
+        }
+        benchmark::DoNotOptimize(back.data());
+    }
+    state.counters["frames"] = static_cast<double>(trace.size());
+    state.counters["pixels_per_frame"] = static_cast<double>(pixels) / trace.size();
+    state.counters["peak_pixels"] = static_cast<double>(peak);
+}
+BENCHMARK(BM_SelectorRepaintReplay)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+}  // namespace
+}  // namespace capture_core
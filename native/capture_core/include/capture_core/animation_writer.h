@@ -0,0 +1,151 @@
+#ifndef CAPTURE_CORE_ANIMATION_WRITER_H_
+#define CAPTURE_CORE_ANIMATION_WRITER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/geometry.h"
+#include "capture_core/palette_quantizer.h"
+#include "capture_core/png_encoder.h"
+
+namespace capture_core {
+
+// 录屏输出的动画格式
+enum class AnimationFormat {
+    kGif,   // 每帧最多 255 色 + 透明色，兼容性最好
+    kApng,  // 无损，体积通常比 GIF 大
+};
+
+// 两帧之间像素不同的最小矩形（kBgrx8 忽略 X 通道）；
+// 尺寸或格式不同时返回 current 的整帧范围，完全相同时返回空矩形
+Rect ChangedBounds(const FrameBuffer& previous, const FrameBuffer& current);
+
+// 逐帧写入动画文件（录屏）
+//
+// 帧在写入时就落盘，内存中只保留上一次写出的帧（画布）和一帧待写的帧，
+// 长时间录制的内存占用不随时长增长。每一帧只编码和画布不同的最小矩形
+// （ChangedBounds），与上一帧完全相同的帧不写出，只延长上一帧的显示时间。
+// 一帧的显示时长要等到下一帧（或 Finish）才知道，所以帧总是延迟一帧写出。
+//
+// 所有帧的尺寸和像素格式必须与第一帧相同。路径为 UTF-8。
+// 一个实例不能被多个线程同时调用。
+class AnimationWriter {
+public:
+    // 没有 Finish 的文件不完整，析构时删除
+    virtual ~AnimationWriter();
+
+    AnimationWriter(const AnimationWriter&) = delete;
+    AnimationWriter& operator=(const AnimationWriter&) = delete;
+
+    static std::unique_ptr<AnimationWriter> Create(AnimationFormat format);
+
+    // 创建（覆盖）path，之后才能加入帧
+    bool Open(const std::string& path);
+
+    // 加入一帧，timestamp 为相对录制开始的时间，须单调不减；失败后文件不再可用
+    bool AddFrame(const FrameBuffer& frame, std::chrono::milliseconds timestamp);
+
+    // 写出最后一帧（显示到 end）和文件尾并关闭；一帧都没有时失败
+    bool Finish(std::chrono::milliseconds end);
+
+    // 放弃录制：关闭并删除文件
+    void Abort();
+
+    bool is_open() const { return out_.is_open(); }
+    const std::string& path() const { return path_; }
+    // 已写出的帧数和因与上一帧相同而合并掉的帧数
+    int64_t frames_written() const { return frames_written_; }
+    int64_t frames_merged() const { return frames_merged_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+
+protected:
+    AnimationWriter() = default;
+
+    // 写出一帧：frame 为整帧，只需编码 bounds 范围；previous 为上一次写出的整帧
+    // （第一帧为 nullptr，此时还要写文件头）。帧显示在 [start, end) 之间
+    virtual bool WriteFrame(const FrameBuffer& frame, const FrameBuffer* previous,
+                            const Rect& bounds, std::chrono::milliseconds start,
+                            std::chrono::milliseconds end) = 0;
+    // 写文件尾；frames 为写出的总帧数
+    virtual bool WriteTrailer(int64_t frames) = 0;
+
+    bool Write(const uint8_t* data, size_t size);
+    bool Write(const std::vector<uint8_t>& bytes) { return Write(bytes.data(), bytes.size()); }
+    // 回填已写出的内容（例如 APNG 的总帧数），不改变写入位置
+    bool Overwrite(uint64_t offset, const uint8_t* data, size_t size);
+    uint64_t position() const { return bytes_written_; }
+
+private:
+    bool WritePending(std::chrono::milliseconds end);
+
+    std::ofstream out_;
+    std::string path_;
+    // 上一次写出的帧和等待写出的帧，两者交替复用内存
+    FrameBuffer canvas_;
+    FrameBuffer pending_;
+    Rect pending_bounds_;
+    std::chrono::milliseconds pending_start_{0};
+    bool has_canvas_ = false;
+    bool has_pending_ = false;
+    bool failed_ = false;
+    int64_t frames_written_ = 0;
+    int64_t frames_merged_ = 0;
+    uint64_t bytes_written_ = 0;
+};
+
+// GIF89a：每帧一个局部调色板（PaletteQuantizer，最多 255 色），
+// 变化矩形内与上一帧相同的像素写成透明色，LZW 遇到大段透明时压缩得很好。
+// 帧不清除（disposal 1），无限循环。GIF 的延迟以 10 ms 为单位，按帧边界取整，
+// 误差不会累积；浏览器会把小于 20 ms 的延迟当成 100 ms，这里不写小于 20 ms 的延迟
+class GifWriter : public AnimationWriter {
+public:
+    GifWriter() = default;
+
+protected:
+    bool WriteFrame(const FrameBuffer& frame, const FrameBuffer* previous, const Rect& bounds,
+                    std::chrono::milliseconds start, std::chrono::milliseconds end) override;
+    bool WriteTrailer(int64_t frames) override;
+
+private:
+    PaletteQuantizer quantizer_;
+    Palette palette_;
+    std::vector<uint8_t> unchanged_;
+    std::vector<uint8_t> indices_;
+    std::vector<uint8_t> block_;
+    // LZW 字典（开放寻址：前缀码 << 8 | 字节 -> 码）和打包后的码流
+    std::vector<int32_t> lzw_keys_;
+    std::vector<uint16_t> lzw_codes_;
+    std::vector<uint8_t> lzw_;
+    // 已写出的延迟总和（10 ms 单位）
+    int64_t written_centiseconds_ = 0;
+};
+
+// APNG：帧用 PngEncoder（并行 deflate）编码后把 IDAT 改写成 fdAT，
+// 每帧只覆盖变化矩形（dispose_op NONE，blend_op SOURCE），无限循环。
+// acTL 的总帧数在 Finish 时回填，所以文件必须可以随机写
+class ApngWriter : public AnimationWriter {
+public:
+    explicit ApngWriter(const PngEncoderOptions& options = PngEncoderOptions());
+
+protected:
+    bool WriteFrame(const FrameBuffer& frame, const FrameBuffer* previous, const Rect& bounds,
+                    std::chrono::milliseconds start, std::chrono::milliseconds end) override;
+    bool WriteTrailer(int64_t frames) override;
+
+private:
+    PngEncoder encoder_;
+    std::vector<uint8_t> png_;
+    std::vector<uint8_t> chunks_;
+    uint32_t sequence_ = 0;
+    uint64_t actl_offset_ = 0;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_ANIMATION_WRITER_H_
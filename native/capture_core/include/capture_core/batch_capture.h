@@ -0,0 +1,41 @@
+#ifndef CAPTURE_CORE_BATCH_CAPTURE_H_
+#define CAPTURE_CORE_BATCH_CAPTURE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/frame_encoder.h"
+#include "capture_core/frame_source.h"
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+struct BatchCaptureOptions {
+    // 长边超过时缩小成缩略图（DownscaleFrame），0 表示保持原尺寸
+    int max_dimension = 0;
+    EncodeOptions encode;
+    // nullptr 表示 ThreadPool::Shared()
+    ThreadPool* pool = nullptr;
+};
+
+struct BatchCaptureItem {
+    bool ok = false;
+    // 来源截到的尺寸和缩小后（即编码的）尺寸
+    int source_width = 0;
+    int source_height = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> bytes;
+};
+
+// 批量截图：一次截取多个来源（例如窗口选择器里的所有窗口）
+//
+// 每个来源在线程池上独立完成 截取 GetBounds() -> 缩小 -> 编码，互不等待；
+// 结果与 sources 一一对应。某个来源为 nullptr、已经失效或编码失败只影响它自己那一项。
+// 来源在调用期间只被一个线程使用，不同来源之间不能共享连接或缓冲。
+std::vector<BatchCaptureItem> CaptureBatch(const std::vector<FrameSource*>& sources,
+                                           const BatchCaptureOptions& options);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_BATCH_CAPTURE_H_
@@ -0,0 +1,51 @@
+#ifndef CAPTURE_CORE_CAPTURE_PIPELINE_H_
+#define CAPTURE_CORE_CAPTURE_PIPELINE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_encoder.h"
+#include "capture_core/frame_source.h"
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 最近一次捕获各阶段的耗时（微秒）
+struct CaptureTimings {
+    int64_t capture_us = 0;
+    int64_t encode_us = 0;
+    size_t encoded_bytes = 0;
+};
+
+// 捕获流水线：FrameSource -> FrameBuffer -> FrameEncoder
+//
+// 所有平台的 captureFullScreen / captureRegion / captureWindow 都走这一条路径。
+// 帧缓冲在多次调用之间复用。
+class CapturePipeline {
+public:
+    CapturePipeline(FrameSource* source, FrameEncoder* encoder);
+
+    // 捕获来源的完整范围
+    bool CaptureFull(std::vector<uint8_t>* out);
+
+    // 捕获 region（屏幕坐标），会被裁剪到来源范围内
+    bool CaptureRegion(const Rect& region, std::vector<uint8_t>* out);
+
+    // 只捕获不编码，结果保存在 frame() 中
+    bool CaptureFrame(const Rect& region);
+
+    FrameBuffer& frame() { return frame_; }
+    const CaptureTimings& last_timings() const { return timings_; }
+
+private:
+    FrameSource* source_;
+    FrameEncoder* encoder_;
+    FrameBuffer frame_;
+    CaptureTimings timings_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_CAPTURE_PIPELINE_H_
@@ -0,0 +1,143 @@
+#ifndef CAPTURE_CORE_CAPTURE_SCHEDULER_H_
+#define CAPTURE_CORE_CAPTURE_SCHEDULER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "capture_core/job_queue.h"
+
+namespace capture_core {
+
+using ScheduleId = uint64_t;
+
+// 计划的一次触发
+struct ScheduledShot {
+    ScheduleId schedule = 0;
+    // 第几次触发，从 1 开始；调度落后时跳过的格点也计入
+    int64_t index = 0;
+    // 调度线程落后（系统休眠等）超过一个间隔时跳过的格点数
+    int64_t missed = 0;
+    // 达到 total_shots 的最后一次，之后计划自动结束
+    bool last = false;
+    // 计划时间：起点 + (index - 1) * interval，不会累积漂移
+    std::chrono::steady_clock::time_point deadline;
+    // 截图开始执行时相对 deadline 的延迟（跳过的触发为 0）
+    std::chrono::microseconds lateness{0};
+    // 持有期间这个计划视为忙碌，下一次触发会被跳过；
+    // 编码、写文件转到别的线程时把它一起带过去，全部释放后才算完成
+    std::shared_ptr<void> busy;
+};
+
+// 触发被跳过的原因
+enum class SkipReason {
+    kBusy,       // 上一次截图（含编码和写文件）还没结束
+    kQueueFull,  // 截图队列已满
+    kCancelled,  // 排队中被取消（Stop 或 JobQueue::CancelAll）
+};
+
+// 循环截图的原生调度器：一个专用线程上的时间轮，按固定节拍触发截图
+//
+// 截图提交到调用方的 JobQueue 上执行（与其他截图请求共用工作线程，
+// Xlib 连接等只在那里使用），调度线程只负责计时，不会被截图或编码拖慢。
+// 触发时间按起点 + n * interval 计算，单次延迟不会累积；等待时先在条件变量上
+// 睡到计划时间前 kSpinMargin，再让出时间片等到计划时间，负载下误差在毫秒级。
+//
+// 背压：同一计划的上一次截图（ScheduledShot::busy 仍被持有）没结束时跳过这一次，
+// 截图队列满时也跳过，不会无限排队。被跳过的触发通过 SkipFunction 报告。
+// ShotFunction 在 JobQueue 的工作线程上调用，SkipFunction 可能在任意线程调用。
+class CaptureScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ShotFunction = std::function<void(ScheduledShot shot, const CancellationToken& token)>;
+    using SkipFunction = std::function<void(const ScheduledShot& shot, SkipReason reason)>;
+
+    // 时间轮的格子数和每格时长（一圈约 1 秒，更远的触发多转几圈）
+    static constexpr size_t kWheelSlots = 1024;
+    static constexpr std::chrono::milliseconds kResolution{1};
+    // 条件变量提前醒来的余量，剩下的时间让出时间片等待
+    static constexpr std::chrono::microseconds kSpinMargin{1500};
+
+    struct Options {
+        std::chrono::milliseconds interval{1000};
+        // 总触发次数，0 表示无限
+        int64_t total_shots = 0;
+        // 第一次触发距 Start 的时间，负值表示等于 interval
+        std::chrono::milliseconds first_delay{-1};
+    };
+
+    explicit CaptureScheduler(JobQueue* jobs);
+    // 停止调度线程并取消排队中的截图；正在执行的截图由 JobQueue 的所有者等待
+    ~CaptureScheduler();
+
+    CaptureScheduler(const CaptureScheduler&) = delete;
+    CaptureScheduler& operator=(const CaptureScheduler&) = delete;
+
+    // 开始一个计划；interval 不为正时返回 0
+    ScheduleId Start(const Options& options, ShotFunction shot, SkipFunction skipped);
+
+    // 结束计划并取消它排队中的截图；计划不存在（或已完成）时返回 false
+    bool Stop(ScheduleId id);
+    void StopAll();
+
+    // 计划是否仍在调度（达到 total_shots 后自动结束）
+    bool active(ScheduleId id) const;
+    size_t size() const;
+
+private:
+    struct Schedule {
+        Options options;
+        ShotFunction shot;
+        SkipFunction skipped;
+        Clock::time_point origin;  // 第 1 次触发的计划时间
+        int64_t next_index = 1;
+        int64_t deadline_tick = 0;
+        std::shared_ptr<std::atomic<bool>> busy;
+        JobId last_job = 0;
+    };
+
+    struct Due {
+        ScheduleId id;
+        ScheduledShot shot;
+        ShotFunction run;
+        SkipFunction skipped;
+        std::shared_ptr<std::atomic<bool>> busy;
+    };
+
+    void Loop();
+    // 把 schedule 的下一次触发放进时间轮，调用方持有 mutex_
+    void Insert(ScheduleId id, Schedule* schedule);
+    // 处理到 now 为止到期的格子，调用方持有 mutex_
+    void Collect(Clock::time_point now, std::vector<Due>* due);
+    void Dispatch(Due due);
+    // 下一个有触发的格子，没有时返回一圈之后，调用方持有 mutex_
+    int64_t NextTick() const;
+    int64_t TickAt(Clock::time_point time) const;
+    Clock::time_point TimeOfTick(int64_t tick) const;
+
+    JobQueue* const jobs_;
+    const Clock::time_point epoch_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<ScheduleId, Schedule> schedules_;
+    // 每格保存到期的计划 id；Stop 不立即清理，轮到时跳过
+    std::vector<std::vector<ScheduleId>> wheel_;
+    // 下一个要处理的格子
+    int64_t current_tick_ = 0;
+    ScheduleId next_id_ = 1;
+    bool changed_ = false;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_CAPTURE_SCHEDULER_H_
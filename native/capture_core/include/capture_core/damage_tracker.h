@@ -0,0 +1,80 @@
+#ifndef CAPTURE_CORE_DAMAGE_TRACKER_H_
+#define CAPTURE_CORE_DAMAGE_TRACKER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+struct DamageStats {
+    uint64_t frames = 0;
+    uint64_t full_repaints = 0;
+    // 累计重画的像素数（各帧重画矩形的面积之和）
+    uint64_t repainted_pixels = 0;
+};
+
+// 区域选择蒙版的重画范围
+//
+// 蒙版是静态的底图（冻结背景加暗）上叠几个元素：选择框挖空的区域、边框、控制点、
+// 尺寸文字、工具栏和放大镜。每帧（每次鼠标事件）调用方按当前状态登记所有可见元素，
+// Commit 与上一帧比较：矩形或内容变化的元素新旧矩形都要重画，消失的元素重画旧矩形；
+// 挖空区域只有新旧矩形的对称差需要重画（拖动选择框的一条边时只是边附近的一条）。
+// 结果裁剪到 bounds 并拆成互不相交的矩形，矩形过多时合并浪费面积最少的两个；
+// 总面积超过 bounds 的一半时直接整屏重画。
+// 不是线程安全的，只在蒙版的窗口线程上使用。
+class DamageTracker {
+public:
+    // 最多返回的矩形数
+    static constexpr size_t kMaxRects = 16;
+
+    DamageTracker() = default;
+    explicit DamageTracker(const Rect& bounds) { Reset(bounds); }
+
+    // 换成新的画面（第一次显示或尺寸变化）：清空上一帧的元素，下一次 Commit 整屏重画
+    void Reset(const Rect& bounds);
+
+    // 本帧的一个元素，id 在帧之间标识同一个元素；content 是内容的版本
+    // （例如放大镜的鼠标位置、按钮的悬停状态），矩形不变但内容变化时也要重画
+    void SetLayer(uint32_t id, const Rect& rect, uint64_t content = 0);
+
+    // 本帧的一个挖空区域（与 SetLayer 共用 id 空间）：区域内外只是底图不同，
+    // 变化时只重画新旧矩形的对称差
+    void SetHole(uint32_t id, const Rect& rect);
+
+    // 下一次 Commit 整屏重画
+    void InvalidateAll() { full_ = true; }
+
+    // 结束本帧，返回需要重画的矩形（互不相交），并以本帧的元素作为下一帧的参照；
+    // 本帧没有登记的元素视为已经消失
+    std::vector<Rect> Commit();
+
+    const Rect& bounds() const { return bounds_; }
+    const DamageStats& stats() const { return stats_; }
+
+private:
+    struct Layer {
+        Rect rect;
+        uint64_t content = 0;
+        bool hole = false;
+    };
+
+    // 去掉已有矩形覆盖的部分后加入
+    void AddDamage(const Rect& rect);
+    // 合并浪费面积最少的两个矩形，直到不超过 kMaxRects 个
+    void Coalesce();
+
+    Rect bounds_;
+    bool full_ = false;
+    std::map<uint32_t, Layer> previous_;
+    std::map<uint32_t, Layer> current_;
+    std::vector<Rect> damage_;
+    DamageStats stats_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_DAMAGE_TRACKER_H_
@@ -0,0 +1,129 @@
+#ifndef CAPTURE_CORE_ENCODE_QUEUE_H_
+#define CAPTURE_CORE_ENCODE_QUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_encoder.h"
+#include "capture_core/job_queue.h"
+#include "capture_core/jpeg_encoder.h"
+#include "capture_core/qoi_codec.h"
+
+namespace capture_core {
+
+// 两阶段截图中帧的句柄，0 表示无效
+using FrameHandle = uint64_t;
+
+enum class EncodeStatus {
+    kOk,
+    kFailed,
+    kCancelled,
+};
+
+struct EncodeResult {
+    FrameHandle handle = 0;
+    EncodeStatus status = EncodeStatus::kFailed;
+    std::vector<uint8_t> bytes;
+};
+
+// 两阶段截图的编码阶段
+//
+// 像素进入内存后调用方立即 Submit 拿到句柄，把句柄和尺寸回复给 UI；
+// 编码在后台工作线程进行，结束（成功、失败或取消）后调用 done，每个句柄恰好一次。
+// done 通常在工作线程上执行；排队中的帧被取消时在调用 Cancel 的线程上执行。
+// 编码结束前可以用 Peek 取到原始帧做即时预览。
+//
+// 也可以先 Hold 住帧不编码：预览直接读原始像素，用户保存时再 Encode，
+// 放弃时 Cancel，done 同样恰好调用一次。
+class EncodeQueue {
+public:
+    using EncoderFactory = std::function<std::unique_ptr<FrameEncoder>()>;
+    using Completion = std::function<void(EncodeResult)>;
+
+    // 每个工作线程按需用 factory 创建一个 PNG 编码器（JPEG 编码器由队列自己创建），之后一直复用
+    EncodeQueue(EncoderFactory factory, int num_workers, size_t max_pending);
+    // 取消暂存和排队中的帧（done 收到 kCancelled），等待正在编码的帧结束
+    ~EncodeQueue();
+
+    EncodeQueue(const EncodeQueue&) = delete;
+    EncodeQueue& operator=(const EncodeQueue&) = delete;
+
+    // 取一块空闲的帧缓冲（已编码完的帧留下的内存），调用方填好后再 Submit，
+    // 稳态下连续截图不再分配整帧内存；没有空闲缓冲时返回空帧
+    FrameBuffer AcquireFrame();
+    // 把 AcquireFrame 取到、最后没有提交的帧还回来（例如被判定为重复的截图），
+    // 保留它的内存供下一次 AcquireFrame；没有分配过内存的帧直接丢弃
+    void ReleaseFrame(FrameBuffer frame);
+
+    // 提交一帧，按 options 选择的格式编码；队列已满时返回 0（不会调用 done）
+    // frame 是视图时（指向来源的 DIB / 共享内存）先拷贝，来源可以立即开始下一次捕获
+    FrameHandle Submit(FrameBuffer frame, Completion done,
+                       const EncodeOptions& options = EncodeOptions());
+
+    // 暂存一帧但不编码，直到 Encode 或 Cancel；暂存帧数达到 max_pending 时返回 0
+    FrameHandle Hold(FrameBuffer frame, Completion done,
+                     const EncodeOptions& options = EncodeOptions());
+    // 开始编码一个暂存帧；句柄不是暂存帧或编码队列已满时返回 false（帧仍然暂存）
+    bool Encode(FrameHandle handle);
+
+    // 编码结束前（包括暂存期间）返回该帧，之后返回 nullptr
+    std::shared_ptr<const FrameBuffer> Peek(FrameHandle handle) const;
+
+    // 取消指定帧；已经结束或不存在时返回 false
+    bool Cancel(FrameHandle handle);
+    // 取消所有尚未结束的帧，返回受影响的帧数
+    size_t CancelAll();
+
+    // 已提交或暂存、尚未结束的帧数
+    size_t in_flight() const;
+    // 暂存中、尚未开始编码的帧数
+    size_t held() const;
+
+private:
+    struct Entry {
+        std::shared_ptr<FrameBuffer> frame;
+        // 0 表示暂存中
+        JobId job = 0;
+        Completion done;
+        EncodeOptions options;
+    };
+
+    // 取得帧的所有权；视图帧拷贝进空闲缓冲，*copied 记录是否发生了拷贝
+    std::shared_ptr<FrameBuffer> Adopt(FrameBuffer frame, bool* copied);
+    // 把句柄交给工作线程，调用方持有 mutex_；队列已满时返回 0
+    JobId Schedule(FrameHandle handle, const Completion& done);
+    // 把不再使用的缓冲放回空闲列表（列表未满时），调用方持有 mutex_
+    void Recycle(std::shared_ptr<FrameBuffer> frame);
+    // 取消所有暂存帧，返回受影响的帧数
+    size_t CancelHeld();
+
+    void Run(FrameHandle handle, const CancellationToken& token, const Completion& done);
+    // 移除句柄，帧没有其他持有者时放回空闲列表
+    void Finish(FrameHandle handle);
+    std::unique_ptr<FrameEncoder> AcquireEncoder();
+    void ReleaseEncoder(std::unique_ptr<FrameEncoder> encoder);
+    std::unique_ptr<JpegEncoder> AcquireJpegEncoder();
+    void ReleaseJpegEncoder(std::unique_ptr<JpegEncoder> encoder);
+
+    const EncoderFactory factory_;
+    mutable std::mutex mutex_;
+    std::unordered_map<FrameHandle, Entry> entries_;
+    FrameHandle next_handle_ = 1;
+    size_t held_count_ = 0;
+    // 视图帧拷贝用的缓冲，编码结束后复用，稳态下不再分配
+    std::vector<std::shared_ptr<FrameBuffer>> idle_frames_;
+    std::vector<std::unique_ptr<FrameEncoder>> idle_encoders_;
+    std::vector<std::unique_ptr<JpegEncoder>> idle_jpeg_encoders_;
+    // 最后声明：析构时先停止工作线程，再释放上面的状态
+    JobQueue jobs_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_ENCODE_QUEUE_H_
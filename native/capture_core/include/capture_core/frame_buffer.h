@@ -0,0 +1,80 @@
+#ifndef CAPTURE_CORE_FRAME_BUFFER_H_
+#define CAPTURE_CORE_FRAME_BUFFER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 像素格式，按内存中的字节顺序命名，均为每像素 4 字节
+enum class PixelFormat {
+    kBgra8,  // B G R A，A 有效
+    kBgrx8,  // B G R X，X 未定义（BitBlt / XGetImage 的结果）
+    kRgba8,  // R G B A，Flutter 纹理和 PNG 使用的顺序
+};
+
+inline int BytesPerPixel(PixelFormat) { return 4; }
+
+// 像素缓冲区
+//
+// 既可以拥有自己的内存（Allocate），也可以包装外部内存（Wrap），
+// 例如 DIB Section 或共享内存段，这样后续阶段可以原地读取像素。
+// 只能移动不能拷贝，避免意外复制整帧数据。
+class FrameBuffer {
+public:
+    FrameBuffer();
+    FrameBuffer(int width, int height, PixelFormat format);
+    FrameBuffer(FrameBuffer&& other) noexcept;
+    FrameBuffer& operator=(FrameBuffer&& other) noexcept;
+    FrameBuffer(const FrameBuffer&) = delete;
+    FrameBuffer& operator=(const FrameBuffer&) = delete;
+
+    // 分配（或复用已有容量）width x height 的紧凑缓冲区
+    void Allocate(int width, int height, PixelFormat format);
+
+    // 包装外部内存，不获取所有权
+    void Wrap(uint8_t* data, int width, int height, int stride, PixelFormat format);
+
+    // 释放数据（保留已分配的容量以便复用）
+    void Reset();
+
+    // 返回 rect 区域的非拥有视图，rect 会被裁剪到帧范围内
+    FrameBuffer View(const Rect& rect);
+
+    // 拷贝另一帧（可以是视图）的像素到自己的内存
+    void CopyFrom(const FrameBuffer& other);
+
+    bool empty() const { return data_ == nullptr || width_ <= 0 || height_ <= 0; }
+    bool owns_memory() const { return owns_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int stride() const { return stride_; }
+    PixelFormat format() const { return format_; }
+    Rect bounds() const { return Rect(0, 0, width_, height_); }
+    size_t size_bytes() const { return static_cast<size_t>(stride_) * height_; }
+    size_t capacity_bytes() const { return storage_.capacity(); }
+
+    uint8_t* data() { return data_; }
+    const uint8_t* data() const { return data_; }
+    uint8_t* row(int y) { return data_ + static_cast<ptrdiff_t>(y) * stride_; }
+    const uint8_t* row(int y) const { return data_ + static_cast<ptrdiff_t>(y) * stride_; }
+
+    // 修改像素格式标记（不转换数据），用于格式转换后重新标注
+    void set_format(PixelFormat format) { format_ = format; }
+
+private:
+    std::vector<uint8_t> storage_;
+    uint8_t* data_;
+    int width_;
+    int height_;
+    int stride_;
+    PixelFormat format_;
+    bool owns_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_FRAME_BUFFER_H_
@@ -0,0 +1,36 @@
+#ifndef CAPTURE_CORE_FRAME_ENCODER_H_
+#define CAPTURE_CORE_FRAME_ENCODER_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+
+namespace capture_core {
+
+// 输出的文件格式
+enum class ImageFormat {
+    kPng,
+    kJpeg,
+    // 快速无损（QOI），供高频截图先落盘，之后再转成 PNG
+    kQoi,
+};
+
+// 单次编码的格式选择；quality 只对 JPEG 有效（1-100）
+struct EncodeOptions {
+    ImageFormat format = ImageFormat::kPng;
+    int quality = 90;
+};
+
+// 编码阶段接口：把一帧像素编码为文件格式的字节流
+class FrameEncoder {
+public:
+    virtual ~FrameEncoder() = default;
+
+    // 编码 frame 到 out（覆盖原有内容）；失败返回 false
+    virtual bool Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) = 0;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_FRAME_ENCODER_H_
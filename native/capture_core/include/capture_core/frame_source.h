@@ -0,0 +1,29 @@
+#ifndef CAPTURE_CORE_FRAME_SOURCE_H_
+#define CAPTURE_CORE_FRAME_SOURCE_H_
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 帧来源接口
+//
+// 每个平台后端（GDI、X11 等）以及测试用的合成后端都实现此接口，
+// 捕获流水线只依赖这个接口。
+class FrameSource {
+public:
+    virtual ~FrameSource() = default;
+
+    // 来源覆盖的范围（屏幕坐标）
+    virtual Rect GetBounds() = 0;
+
+    // 将 region（屏幕坐标）的像素写入 frame
+    // frame 的尺寸和格式由实现决定；失败返回 false
+    // 实现可以让 frame 直接指向自己持有的缓冲（FrameBuffer::Wrap），
+    // 此时内容只在下一次 Capture 或来源销毁之前有效
+    virtual bool Capture(const Rect& region, FrameBuffer* frame) = 0;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_FRAME_SOURCE_H_
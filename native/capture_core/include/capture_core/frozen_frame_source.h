@@ -0,0 +1,30 @@
+#ifndef CAPTURE_CORE_FROZEN_FRAME_SOURCE_H_
+#define CAPTURE_CORE_FROZEN_FRAME_SOURCE_H_
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_source.h"
+
+namespace capture_core {
+
+// 冻结帧来源
+//
+// 区域选择蒙版在显示前已经截下整个屏幕，选择完成后直接从这帧裁剪，
+// 不必在蒙版关闭后重新截屏（更快，也不会截到正在淡出的蒙版）。
+// 不拷贝也不拥有像素：frame 必须在来源使用期间保持有效。
+class FrozenFrameSource : public FrameSource {
+public:
+    // origin 为 frame 左上角的屏幕坐标
+    FrozenFrameSource(const FrameBuffer& frame, int origin_x, int origin_y);
+
+    Rect GetBounds() override;
+    bool Capture(const Rect& region, FrameBuffer* frame) override;
+
+private:
+    FrameBuffer frame_;
+    int origin_x_;
+    int origin_y_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_FROZEN_FRAME_SOURCE_H_
@@ -0,0 +1,45 @@
+#ifndef CAPTURE_CORE_GEOMETRY_H_
+#define CAPTURE_CORE_GEOMETRY_H_
+
+#include <vector>
+
+namespace capture_core {
+
+// 屏幕/帧坐标中的矩形（左上角 + 尺寸）
+struct Rect {
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+    Rect() = default;
+    Rect(int x_, int y_, int width_, int height_)
+        : x(x_), y(y_), width(width_), height(height_) {}
+
+    int right() const { return x + width; }
+    int bottom() const { return y + height; }
+    bool empty() const { return width <= 0 || height <= 0; }
+
+    bool Contains(int px, int py) const {
+        return px >= x && px < right() && py >= y && py < bottom();
+    }
+
+    bool operator==(const Rect& other) const {
+        return x == other.x && y == other.y &&
+               width == other.width && height == other.height;
+    }
+    bool operator!=(const Rect& other) const { return !(*this == other); }
+};
+
+// 两个矩形的交集，无交集时返回空矩形
+Rect IntersectRects(const Rect& a, const Rect& b);
+
+// 同时包含两个矩形的最小矩形（忽略空矩形）
+Rect UnionRects(const Rect& a, const Rect& b);
+
+// a 去掉与 b 重叠的部分，最多 4 个互不相交的矩形（上、下两条整行，中间左、右两块）
+std::vector<Rect> SubtractRects(const Rect& a, const Rect& b);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_GEOMETRY_H_
@@ -0,0 +1,87 @@
+#ifndef CAPTURE_CORE_IDLE_TRANSCODER_H_
+#define CAPTURE_CORE_IDLE_TRANSCODER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "capture_core/png_encoder.h"
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+enum class TranscodeStatus {
+    kOk,
+    kFailed,
+    kCancelled,
+};
+
+struct TranscodeResult {
+    std::string source;
+    std::string target;
+    TranscodeStatus status = TranscodeStatus::kFailed;
+};
+
+// 空闲时把 QOI 截图文件转成 PNG
+//
+// 高频循环截图先用 QoiEncoder 快速落盘，每张截图的成本不随 PNG 压缩而增加；
+// 转码在单独的后台线程上串行进行，只在最近一次 NotifyActivity 之后
+// 安静了 idle_delay 才开始下一个文件，不和截图争用 CPU 和共享线程池。
+// 已经开始的文件会转完（单线程 PNG 编码），之后再重新等待空闲。
+//
+// PNG 先写到 target + ".tmp" 再改名，成功后删除源文件；失败时源文件保留。
+// 路径为 UTF-8。done 在转码线程上调用；析构时尚未开始的文件以 kCancelled 通知，
+// 源文件保留，调用方下次启动时可以重新提交。
+class IdleTranscoder {
+public:
+    using Completion = std::function<void(TranscodeResult)>;
+
+    explicit IdleTranscoder(std::chrono::milliseconds idle_delay);
+    ~IdleTranscoder();
+
+    IdleTranscoder(const IdleTranscoder&) = delete;
+    IdleTranscoder& operator=(const IdleTranscoder&) = delete;
+
+    // 排队转码 source（QOI）到 target（PNG）；正在析构时返回 false（不会调用 done）
+    bool Enqueue(std::string source, std::string target, Completion done);
+
+    // 有截图活动时调用，推迟下一个文件的转码
+    void NotifyActivity();
+
+    // 排队中（尚未开始）的文件数
+    size_t pending() const;
+
+    // 单个文件的转码，供测试和同步调用；不检查空闲
+    static bool TranscodeFile(const std::string& source, const std::string& target,
+                              PngEncoder* encoder);
+
+private:
+    struct Job {
+        std::string source;
+        std::string target;
+        Completion done;
+    };
+
+    void WorkerLoop();
+
+    const std::chrono::milliseconds idle_delay_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> queue_;
+    std::chrono::steady_clock::time_point last_activity_;
+    bool stopping_ = false;
+    // 没有工作线程的线程池：PNG 编码在转码线程上串行执行
+    ThreadPool serial_pool_;
+    PngEncoder encoder_;
+    // 最后声明：构造完其他成员后才启动
+    std::thread worker_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_IDLE_TRANSCODER_H_
@@ -0,0 +1,86 @@
+#ifndef CAPTURE_CORE_JOB_QUEUE_H_
+#define CAPTURE_CORE_JOB_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace capture_core {
+
+// 任务的取消标记，任务可以在耗时步骤之间检查
+class CancellationToken {
+public:
+    CancellationToken() : flag_(std::make_shared<std::atomic<bool>>(false)) {}
+
+    bool cancelled() const { return flag_->load(std::memory_order_acquire); }
+    void Cancel() const { flag_->store(true, std::memory_order_release); }
+
+private:
+    std::shared_ptr<std::atomic<bool>> flag_;
+};
+
+using JobId = uint64_t;
+
+// 有界任务队列，供截图方法调用在平台线程之外执行
+//
+// 队列满时 Submit 立即失败（返回 0），调用方据此回复 BUSY，而不是无限堆积。
+// 尚未开始的任务被取消时不会运行，改为调用它的 on_cancelled；
+// 正在运行的任务只会收到取消标记，由任务自己决定何时放弃。
+// 两个回调都可能在工作线程上执行，完成结果需要由调用方转回平台线程。
+class JobQueue {
+public:
+    using RunFunction = std::function<void(const CancellationToken&)>;
+    using CancelFunction = std::function<void()>;
+
+    JobQueue(int num_workers, size_t max_pending);
+    // 取消所有排队任务，等待正在运行的任务结束
+    ~JobQueue();
+
+    JobQueue(const JobQueue&) = delete;
+    JobQueue& operator=(const JobQueue&) = delete;
+
+    // 队列已满时返回 0
+    JobId Submit(RunFunction run, CancelFunction on_cancelled);
+
+    // 取消指定任务；任务已结束或不存在时返回 false
+    bool Cancel(JobId id);
+    // 取消所有排队和正在运行的任务，返回受影响的任务数
+    size_t CancelAll();
+
+    // 排队中（尚未开始）的任务数
+    size_t pending() const;
+    // 正在运行的任务数
+    size_t running() const;
+    size_t max_pending() const { return max_pending_; }
+
+private:
+    struct Job {
+        JobId id;
+        RunFunction run;
+        CancelFunction on_cancelled;
+        CancellationToken token;
+    };
+
+    void WorkerLoop();
+
+    const size_t max_pending_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> queue_;
+    // 正在运行的任务的取消标记
+    std::vector<std::pair<JobId, CancellationToken>> running_;
+    JobId next_id_ = 1;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_JOB_QUEUE_H_
@@ -0,0 +1,66 @@
+#ifndef CAPTURE_CORE_JPEG_ENCODER_H_
+#define CAPTURE_CORE_JPEG_ENCODER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "capture_core/frame_encoder.h"
+
+namespace capture_core {
+
+class ThreadPool;
+
+// 色度抽样
+enum class JpegSubsampling {
+    k444,  // 不抽样，适合文字和细线条
+    k422,  // 水平减半
+    k420,  // 水平、垂直都减半，照片的常用设置
+};
+
+struct JpegEncoderOptions {
+    // 质量 1-100（libjpeg 的标准量化表缩放）
+    int quality = 90;
+    JpegSubsampling subsampling = JpegSubsampling::k420;
+    // 并行编码使用的线程池，nullptr 表示 ThreadPool::Shared()
+    ThreadPool* pool = nullptr;
+    // 每个条带的行数（向上取整到 MCU 高度），0 表示按线程数自动划分
+    int strip_rows = 0;
+};
+
+// 基于 libjpeg-turbo 的并行 baseline JPEG 编码器
+//
+// 图像按 MCU 行切成若干条带，每个条带在线程池上用独立的 jpeg_compress_struct
+// 编码成一段完整的 JPEG；DRI 设为一个条带的 MCU 数，于是每个条带恰好是一个
+// restart 区间（区间开始时 DC 预测清零，结束时按字节对齐），
+// 拼接时保留第一个条带的文件头（SOF 高度改为整幅），之后各条带的熵编码数据
+// 之间插入 RSTn 标记。输出与单线程设置同样 DRI 的编码结果逐字节相同。
+//
+// 使用标准 Huffman 表（不做 optimize_coding），各条带的表才能一致。
+// JPEG 不带 alpha：kBgra8 / kRgba8 的 alpha 通道被丢弃。
+// 一个实例不能被多个线程同时调用。
+class JpegEncoder : public FrameEncoder {
+public:
+    JpegEncoder();
+    explicit JpegEncoder(const JpegEncoderOptions& options);
+    ~JpegEncoder() override;
+
+    bool Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) override;
+
+    const JpegEncoderOptions& options() const { return options_; }
+    void set_quality(int quality) { options_.quality = quality; }
+    // 最近一次编码使用的条带数
+    int last_strip_count() const { return last_strip_count_; }
+
+private:
+    struct Strip;
+
+    JpegEncoderOptions options_;
+    // 跨调用复用的条带状态（含 jpeg_compress_struct 和输出缓冲）
+    std::vector<std::unique_ptr<Strip>> strips_;
+    int last_strip_count_ = 0;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_JPEG_ENCODER_H_
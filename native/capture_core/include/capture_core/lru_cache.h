@@ -0,0 +1,93 @@
+#ifndef CAPTURE_CORE_LRU_CACHE_H_
+#define CAPTURE_CORE_LRU_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace capture_core {
+
+struct LruCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+};
+
+// 按条数限制的最近最少使用缓存
+//
+// 链表按使用时间排序（表头最新），哈希表从键找到链表节点，查找、插入和淘汰都是 O(1)。
+// Find 命中时把条目移到表头；Put 超出容量时淘汰表尾。
+// 不是线程安全的，多个线程共用时由调用方加锁。
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    LruCache(const LruCache&) = delete;
+    LruCache& operator=(const LruCache&) = delete;
+
+    // 命中时返回值的指针（在下一次 Put / Erase / Clear 之前有效），否则返回 nullptr；
+    // 同时计入命中 / 未命中次数
+    Value* Find(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            stats_.misses++;
+            return nullptr;
+        }
+        stats_.hits++;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+
+    // 插入或替换，返回缓存中的值
+    Value& Put(const Key& key, Value value) {
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+        if (entries_.size() >= capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+            stats_.evictions++;
+        }
+        entries_.emplace_front(key, std::move(value));
+        index_[key] = entries_.begin();
+        return entries_.front().second;
+    }
+
+    bool Erase(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return false;
+        }
+        entries_.erase(it->second);
+        index_.erase(it);
+        return true;
+    }
+
+    void Clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    size_t size() const { return entries_.size(); }
+    size_t capacity() const { return capacity_; }
+    const LruCacheStats& stats() const { return stats_; }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator, Hash> index_;
+    LruCacheStats stats_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_LRU_CACHE_H_
@@ -0,0 +1,25 @@
+#ifndef CAPTURE_CORE_MONITOR_INFO_H_
+#define CAPTURE_CORE_MONITOR_INFO_H_
+
+#include <string>
+#include <vector>
+
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 一个显示器在虚拟桌面中的位置
+// Windows 来自 EnumDisplayMonitors，X11 来自 XRandR
+struct MonitorInfo {
+    int index = 0;
+    Rect bounds;  // 屏幕坐标，副屏可能为负
+    bool primary = false;
+    std::string name;
+};
+
+// 包含所有显示器的最小矩形
+Rect VirtualDesktopBounds(const std::vector<MonitorInfo>& monitors);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_MONITOR_INFO_H_
@@ -0,0 +1,54 @@
+#ifndef CAPTURE_CORE_MULTI_MONITOR_CAPTURE_H_
+#define CAPTURE_CORE_MULTI_MONITOR_CAPTURE_H_
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_source.h"
+#include "capture_core/monitor_info.h"
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+// 多显示器并行截图
+//
+// 每个显示器一个 FrameSource（由 factory 创建，实例之间不共享连接或缓冲），
+// 在线程池上同时抓取各显示器，再按需拼接成一整张虚拟桌面。
+// 来源在多次捕获之间复用；同一时刻每个来源只被一个线程使用。
+class MultiMonitorCapture {
+public:
+    using SourceFactory = std::function<std::unique_ptr<FrameSource>(const MonitorInfo&)>;
+
+    // pool 为 nullptr 时使用 ThreadPool::Shared()
+    MultiMonitorCapture(std::vector<MonitorInfo> monitors, const SourceFactory& factory,
+                        ThreadPool* pool = nullptr);
+
+    MultiMonitorCapture(const MultiMonitorCapture&) = delete;
+    MultiMonitorCapture& operator=(const MultiMonitorCapture&) = delete;
+
+    const std::vector<MonitorInfo>& monitors() const { return monitors_; }
+    Rect virtual_bounds() const { return VirtualDesktopBounds(monitors_); }
+
+    // 并行抓取每个显示器，结果在 frame(i) 中，与 monitors()[i] 对应
+    // 帧可能指向来源持有的缓冲，在下一次捕获或本对象销毁前有效
+    bool CaptureEach();
+    FrameBuffer& frame(size_t index) { return frames_[index]; }
+
+    // 并行抓取并拼接成虚拟桌面大小的 kBgrx8 帧，显示器之间的空隙填黑
+    // frame 已经是虚拟桌面大小时（例如包装了 DIB section）直接写入，否则重新分配
+    bool CaptureVirtualDesktop(FrameBuffer* frame);
+
+private:
+    bool CaptureMonitor(size_t index);
+
+    std::vector<MonitorInfo> monitors_;
+    std::vector<std::unique_ptr<FrameSource>> sources_;
+    std::vector<FrameBuffer> frames_;
+    ThreadPool* pool_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_MULTI_MONITOR_CAPTURE_H_
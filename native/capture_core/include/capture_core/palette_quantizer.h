@@ -0,0 +1,71 @@
+#ifndef CAPTURE_CORE_PALETTE_QUANTIZER_H_
+#define CAPTURE_CORE_PALETTE_QUANTIZER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 最多 256 色的调色板（R G B 顺序）
+struct Palette {
+    int size = 0;
+    uint8_t rgb[256 * 3] = {};
+};
+
+// 把一帧（或其中一个区域）量化到不超过 max_colors 色，用于 GIF
+//
+// 颜色数不超过 max_colors 时直接使用精确颜色（桌面 UI、文字的局部画面很常见），
+// 映射查 1024 项的开放寻址表；否则在 15 位（5-5-5）直方图上做 median cut，
+// 每个盒子的颜色取其中格子的加权平均，盒子划分本身就是 32768 项的查找表，
+// 映射每个像素只查一次表，不需要逐个比较调色板颜色。两条路径都缓存上一个像素，
+// UI 画面中的大段纯色只查一次。
+//
+// skip 非空时按 region 行优先，每个像素一个字节，非 0 的像素不参与统计，
+// Map 时写入 skip_index（GIF 的透明色，表示沿用上一帧）。
+// 一个实例不能被多个线程同时调用。
+class PaletteQuantizer {
+public:
+    static constexpr int kMaxColors = 256;
+
+    PaletteQuantizer();
+
+    // 统计 region 内的颜色并生成调色板；region 会被裁剪到帧范围内
+    void Build(const FrameBuffer& frame, const Rect& region, const uint8_t* skip,
+               int max_colors, Palette* palette);
+
+    // 按最近一次 Build 的结果把 region 内的像素映射为调色板下标，写入 out（按行紧凑）
+    void Map(const FrameBuffer& frame, const Rect& region, const uint8_t* skip,
+             uint8_t skip_index, uint8_t* out) const;
+
+    // 最近一次 Build 是否使用了精确颜色
+    bool exact() const { return exact_; }
+
+private:
+    // 精确颜色表的一项；key 为 0 表示空位（有效 key 带 1 << 24 标记）
+    struct ExactEntry {
+        uint32_t key;
+        uint8_t index;
+    };
+    static constexpr size_t kExactSlots = 1024;
+
+    bool BuildExact(const FrameBuffer& frame, const Rect& region, const uint8_t* skip,
+                    int max_colors, Palette* palette);
+    void BuildMedianCut(const FrameBuffer& frame, const Rect& region, const uint8_t* skip,
+                        int max_colors, Palette* palette);
+    int FindExact(uint32_t key) const;
+
+    bool exact_ = false;
+    std::vector<ExactEntry> exact_table_;
+    // 15 位直方图和 median cut 的结果（格子 -> 调色板下标）
+    std::vector<uint32_t> histogram_;
+    std::vector<uint8_t> lookup_;
+    std::vector<uint16_t> cells_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_PALETTE_QUANTIZER_H_
@@ -0,0 +1,26 @@
+#ifndef CAPTURE_CORE_PERCEPTUAL_HASH_H_
+#define CAPTURE_CORE_PERCEPTUAL_HASH_H_
+
+#include <cstdint>
+
+#include "capture_core/frame_buffer.h"
+
+namespace capture_core {
+
+class ThreadPool;
+
+// 64 位差值哈希（dHash），用于找出“看起来一样”的截图
+//
+// 帧按面积平均缩成 9x8 的灰度图，每行相邻两格比较亮度（左边更亮记 1），
+// 第 row 行第 col 次比较对应第 row * 8 + col 位。整体亮度偏移、缩放和
+// 光标闪烁、时钟跳动这类小范围变化几乎不影响结果，分块哈希则会把它们都算作变化。
+// 缩放的 8 行在线程池上并行（pool 为 nullptr 时使用 ThreadPool::Shared()）；
+// 空帧返回 0
+uint64_t DifferenceHash(const FrameBuffer& frame, ThreadPool* pool = nullptr);
+
+// 两个哈希不同的位数（0-64），越小越相似
+int HammingDistance(uint64_t a, uint64_t b);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_PERCEPTUAL_HASH_H_
@@ -0,0 +1,93 @@
+#ifndef CAPTURE_CORE_PIXEL_CONVERT_H_
+#define CAPTURE_CORE_PIXEL_CONVERT_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "capture_core/frame_buffer.h"
+
+namespace capture_core {
+
+// 像素格式转换内核
+//
+// 每个内核都有标量实现，另外按平台提供 SSE2 / AVX2 / NEON 版本，
+// 首次使用时按 CPU 特性选择最快的一组。下面的自由函数总是走选中的那一组；
+// GetPixelKernels 用于测试和基准测试直接对比各实现。
+enum class SimdLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+    kNeon,
+};
+
+struct PixelKernels {
+    // BGRA <-> RGBA（交换第 0、2 字节），src 和 dst 可以相同
+    void (*swap_red_blue)(const uint8_t* src, uint8_t* dst, size_t pixels);
+    // BGRX -> RGBA：交换红蓝并把 alpha 置为 0xFF，src 和 dst 可以相同
+    void (*swap_red_blue_opaque)(const uint8_t* src, uint8_t* dst, size_t pixels);
+    // 把每个像素的第 3 字节置为 0xFF（BitBlt 之后 alpha 未定义）
+    void (*force_opaque)(uint8_t* data, size_t pixels);
+    // BGRX -> 紧凑的 RGB（PNG 颜色类型 2）
+    void (*bgrx_to_rgb)(const uint8_t* src, uint8_t* dst, size_t pixels);
+    // 24 位 BGR -> 32 位 BGRA，alpha 为 0xFF
+    void (*bgr24_to_bgra)(const uint8_t* src, uint8_t* dst, size_t pixels);
+    // 一行 32 位像素的 64 位哈希，每个像素先与 mask 相与（kBgrx8 用 0x00FFFFFF 忽略 X 通道）。
+    // 像素轮流进入 8 条独立的 32 位乘法链，各实现的结果完全相同
+    uint64_t (*hash_row)(const uint8_t* src, size_t pixels, uint32_t mask);
+};
+
+// 当前 CPU 和构建支持的最高级别
+SimdLevel DetectSimdLevel();
+
+// 指定级别的内核；该级别在当前 CPU 或构建中不可用时返回 nullptr
+const PixelKernels* GetPixelKernels(SimdLevel level);
+
+// 运行时选中的内核
+const PixelKernels& ActivePixelKernels();
+
+const char* SimdLevelName(SimdLevel level);
+
+inline void SwapRedBlue(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    ActivePixelKernels().swap_red_blue(src, dst, pixels);
+}
+
+inline void SwapRedBlueOpaque(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    ActivePixelKernels().swap_red_blue_opaque(src, dst, pixels);
+}
+
+inline void ForceOpaque(uint8_t* data, size_t pixels) {
+    ActivePixelKernels().force_opaque(data, pixels);
+}
+
+inline void BgrxToRgb(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    ActivePixelKernels().bgrx_to_rgb(src, dst, pixels);
+}
+
+inline void Bgr24ToBgra(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    ActivePixelKernels().bgr24_to_bgra(src, dst, pixels);
+}
+
+inline uint64_t HashRow(const uint8_t* src, size_t pixels, uint32_t mask) {
+    return ActivePixelKernels().hash_row(src, pixels, mask);
+}
+
+// 按行拷贝并重排步长；flip_vertical 为 true 时上下翻转（自下而上的 DIB）
+void CopyRows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+              size_t row_bytes, int rows, bool flip_vertical);
+
+// 把 src 转换为 dst_format 写入 dst（紧凑步长）。
+// 转为 kBgra8 / kRgba8 时，kBgrx8 来源的 alpha 置为 0xFF。
+void ConvertFrame(const FrameBuffer& src, PixelFormat dst_format, FrameBuffer* dst);
+
+// 生成 kRgba8 预览：长边超过 max_dimension 时按整数步长最近邻抽样缩小（0 表示不缩放）。
+// 用于编码完成前的即时预览，不追求缩放质量。
+void ConvertFramePreview(const FrameBuffer& src, int max_dimension, FrameBuffer* dst);
+
+// 缩略图：长边超过 max_dimension 时按面积平均（盒式滤波）缩小到长边等于 max_dimension，
+// 保持原来的像素格式（0 或不超过上限时原样拷贝）。每个源像素只读一次，
+// 比 ConvertFramePreview 慢一些，但缩小后的文字和细线不会断裂闪烁。
+void DownscaleFrame(const FrameBuffer& src, int max_dimension, FrameBuffer* dst);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_PIXEL_CONVERT_H_
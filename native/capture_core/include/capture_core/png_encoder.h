@@ -0,0 +1,128 @@
+#ifndef CAPTURE_CORE_PNG_ENCODER_H_
+#define CAPTURE_CORE_PNG_ENCODER_H_
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "capture_core/frame_encoder.h"
+
+namespace capture_core {
+
+class ThreadPool;
+
+// 压缩力度预设
+enum class PngEffort {
+    kFastest,  // zlib 1，只用 Up 过滤器
+    kFast,     // zlib 3，在 None / Sub / Up 中选择
+    kDefault,  // zlib 6，五种过滤器启发式
+    kBest,     // zlib 9，五种过滤器启发式
+};
+
+struct PngEncoderOptions {
+    // zlib 压缩级别 0-9，同时决定过滤器选择（见 PngEffort）
+    int compression_level = 6;
+    // 并行编码使用的线程池，nullptr 表示 ThreadPool::Shared()
+    ThreadPool* pool = nullptr;
+    // 每个条带的行数，0 表示按线程数自动划分
+    int band_rows = 0;
+
+    static PngEncoderOptions ForEffort(PngEffort effort);
+};
+
+// 基于 zlib 的并行 PNG 编码器
+//
+// 图像按行切成若干条带，过滤和 deflate 都在线程池上并行执行（pigz 的做法）：
+// 每个条带是一段原始 deflate 流，以前一条带末尾 32KB 作为预设字典，
+// 用 Z_SYNC_FLUSH 结束在字节边界上，再按顺序拼接，Adler-32 用 adler32_combine 合并。
+// 每个条带写成一个 IDAT 块，输出仍是单个合法的 zlib 流。
+//
+// kBgrx8 输出 8 位 RGB（丢弃未定义的 X 通道），
+// kBgra8 / kRgba8 输出 8 位 RGBA。
+// 一个实例不能被多个线程同时调用。
+class PngEncoder : public FrameEncoder {
+public:
+    PngEncoder();
+    explicit PngEncoder(const PngEncoderOptions& options);
+    ~PngEncoder() override;
+
+    bool Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) override;
+
+    const PngEncoderOptions& options() const { return options_; }
+    // 最近一次编码使用的条带数
+    int last_band_count() const { return last_band_count_; }
+
+private:
+    struct Band;
+
+    PngEncoderOptions options_;
+    // 跨调用复用的过滤后扫描线缓冲和条带状态（含 z_stream）
+    std::vector<uint8_t> filtered_;
+    std::vector<std::unique_ptr<Band>> bands_;
+    int last_band_count_ = 0;
+};
+
+// 逐段写出的 PNG 文件：高度事先未知、可能非常高（长截图），内存与图像高度无关
+//
+// 每次 AddRows 的行按 PngEncoder 的方式切成条带并行过滤和 deflate，
+// 以流中之前的 32KB 作为预设字典接在同一个 zlib 流后面，压缩结果立即写成 IDAT 块；
+// 内存中只有这一段的过滤结果和字典。IHDR 的高度在 Finish 时回填，所以文件必须可以随机写。
+//
+// 所有行的宽度和像素格式必须与第一次 AddRows 相同（输出格式同 PngEncoder）。
+// 路径为 UTF-8。一个实例不能被多个线程同时调用。
+class PngStreamWriter {
+public:
+    PngStreamWriter();
+    explicit PngStreamWriter(const PngEncoderOptions& options);
+    // 没有 Finish 的文件不完整，析构时删除
+    ~PngStreamWriter();
+
+    PngStreamWriter(const PngStreamWriter&) = delete;
+    PngStreamWriter& operator=(const PngStreamWriter&) = delete;
+
+    // 创建（覆盖）path
+    bool Open(const std::string& path);
+
+    // 在图像底部追加 rows 的所有行；失败后文件不再可用
+    bool AddRows(const FrameBuffer& rows);
+
+    // 结束 zlib 流、写文件尾并回填高度；一行都没有时失败并删除文件
+    bool Finish();
+
+    // 关闭并删除文件
+    void Abort();
+
+    bool is_open() const { return out_.is_open(); }
+    int width() const { return width_; }
+    // 已写入的行数
+    int height() const { return height_; }
+    uint64_t bytes_written() const { return bytes_written_; }
+
+private:
+    struct Band;
+
+    bool Write(const std::vector<uint8_t>& bytes);
+
+    PngEncoderOptions options_;
+    std::ofstream out_;
+    std::string path_;
+    int width_ = 0;
+    int height_ = 0;
+    PixelFormat format_ = PixelFormat::kBgrx8;
+    bool failed_ = false;
+    uint64_t bytes_written_ = 0;
+    uint32_t adler_ = 1;
+    // 上一段的最后一行（已转换），作为下一段第一行的过滤参考
+    std::vector<uint8_t> last_row_;
+    // 前 dict_bytes_ 字节是流中之前的数据（字典），其后是这一段的过滤结果
+    std::vector<uint8_t> filtered_;
+    size_t dict_bytes_ = 0;
+    std::vector<std::unique_ptr<Band>> bands_;
+    std::vector<uint8_t> chunk_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_PNG_ENCODER_H_
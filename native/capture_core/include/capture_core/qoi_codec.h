@@ -0,0 +1,31 @@
+#ifndef CAPTURE_CORE_QOI_CODEC_H_
+#define CAPTURE_CORE_QOI_CODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/frame_encoder.h"
+
+namespace capture_core {
+
+// QOI（Quite OK Image）无损编码器
+//
+// 单遍扫描，每个像素只查一次 64 项哈希表，没有熵编码，
+// 速度接近内存带宽，压缩率介于未压缩和 PNG 之间。
+// 用于高频的循环截图：先快速落盘，空闲时再由 IdleTranscoder 转成 PNG。
+//
+// kBgrx8 输出 3 通道（丢弃未定义的 X 通道），kBgra8 / kRgba8 输出 4 通道。
+// 编码器没有跨调用的状态，可以被多个线程同时调用。
+class QoiEncoder : public FrameEncoder {
+public:
+    bool Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) override;
+};
+
+// 解码 QOI 到 kRgba8 帧（3 通道的图像 alpha 为 0xFF）；
+// 数据不完整或头部不合法时返回 false
+bool DecodeQoi(const uint8_t* data, size_t size, FrameBuffer* frame);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_QOI_CODEC_H_
@@ -0,0 +1,190 @@
+#ifndef CAPTURE_CORE_REPLAY_BUFFER_H_
+#define CAPTURE_CORE_REPLAY_BUFFER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "capture_core/animation_writer.h"
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_source.h"
+#include "capture_core/geometry.h"
+#include "capture_core/qoi_codec.h"
+
+namespace capture_core {
+
+struct ReplayStats {
+    // 采集到的帧和采集失败的次数（ReplayBuffer 单独使用时为 0）
+    int64_t captured = 0;
+    int64_t failed_captures = 0;
+    // 与上一帧相同、没有存储的帧；因超出时长或内存上限丢掉的帧
+    int64_t unchanged = 0;
+    int64_t evicted = 0;
+    // 缓冲中的帧（其中关键帧的个数）和覆盖的时长
+    int64_t frames = 0;
+    int64_t keyframes = 0;
+    std::chrono::milliseconds span{0};
+    // 压缩帧占用的字节数及其峰值；未压缩的工作缓冲（差分参考帧、采集缓冲）
+    size_t bytes = 0;
+    size_t peak_bytes = 0;
+    size_t working_bytes = 0;
+    // 运行时长、采集和压缩花费的时间、采集线程消耗的 CPU 时间
+    std::chrono::milliseconds uptime{0};
+    std::chrono::microseconds capture_time{0};
+    std::chrono::microseconds encode_time{0};
+    std::chrono::microseconds cpu_time{0};
+};
+
+struct ReplayExport {
+    int64_t frames = 0;
+    std::chrono::milliseconds duration{0};
+    uint64_t bytes = 0;
+};
+
+// 即时回放的压缩帧环：只保留最近 duration 的画面
+//
+// 每帧先和参考帧（上一次存储的帧）比较（ChangedBounds）：完全相同的帧不存储；
+// 否则只把变化矩形编码成 QOI（差分帧），每隔 keyframe_period 存一个整帧（关键帧）。
+// 关键帧和其后的差分帧组成一组，淘汰总是整组进行，所以缓冲最前面一定是关键帧。
+// 压缩帧的总字节数不会超过 memory_limit：放不下时先淘汰最旧的组，
+// 仍放不下就把这一帧改存为关键帧并淘汰之前所有的组；单个关键帧都放不下时不存储。
+// 帧尺寸或像素格式变化（分辨率切换）时清空缓冲重新开始。
+//
+// Push 不能被多个线程同时调用；Export 和 stats 可以在任何线程上与 Push 并发。
+class ReplayBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // keyframe_period 为 0 时取 duration / 4
+    ReplayBuffer(std::chrono::milliseconds duration, size_t memory_limit,
+                 std::chrono::milliseconds keyframe_period = std::chrono::milliseconds(0));
+
+    ReplayBuffer(const ReplayBuffer&) = delete;
+    ReplayBuffer& operator=(const ReplayBuffer&) = delete;
+
+    // 加入 time 时刻的一帧（time 须单调不减）；帧为空或单帧超出内存上限时返回 false
+    bool Push(const FrameBuffer& frame, Clock::time_point time);
+
+    // 把 end 之前 duration 内的画面写成动画文件（路径为 UTF-8）；缓冲为空或写入失败时返回 false
+    bool Export(AnimationFormat format, const std::string& path, Clock::time_point end,
+                ReplayExport* result) const;
+
+    ReplayStats stats() const;
+
+    std::chrono::milliseconds duration() const { return duration_; }
+    size_t memory_limit() const { return memory_limit_; }
+
+private:
+    struct Entry {
+        Clock::time_point time;
+        // 在整帧中的位置；关键帧为整帧
+        Rect bounds;
+        bool keyframe = false;
+        std::shared_ptr<const std::vector<uint8_t>> data;
+    };
+
+    // 从最前面淘汰一组（关键帧及其差分帧）
+    void EvictOldestGroup();
+    // 第二组关键帧的时间；只有一组时返回 false
+    bool SecondKeyframeTime(Clock::time_point* time) const;
+
+    const std::chrono::milliseconds duration_;
+    const size_t memory_limit_;
+    const std::chrono::milliseconds keyframe_period_;
+
+    // 只在 Push 中使用
+    QoiEncoder encoder_;
+    std::vector<uint8_t> scratch_;
+    FrameBuffer reference_;
+    bool has_reference_ = false;
+    Clock::time_point group_start_;
+
+    mutable std::mutex mutex_;
+    std::deque<Entry> entries_;
+    int width_ = 0;
+    int height_ = 0;
+    PixelFormat format_ = PixelFormat::kBgrx8;
+    Clock::time_point newest_;
+    size_t bytes_ = 0;
+    size_t peak_bytes_ = 0;
+    size_t working_bytes_ = 0;
+    int64_t keyframes_ = 0;
+    int64_t unchanged_ = 0;
+    int64_t evicted_ = 0;
+    std::chrono::microseconds encode_time_{0};
+};
+
+struct ReplayOptions {
+    // 采集范围（通常是一个显示器，屏幕坐标）
+    Rect region;
+    // 采集帧率，限制在 [1, InstantReplay::kMaxFps]
+    int fps = 2;
+    // 保留最近多长时间的画面
+    std::chrono::seconds duration{30};
+    // 压缩帧占用的上限（字节）
+    size_t memory_limit = size_t(64) << 20;
+};
+
+// 即时回放：后台按低帧率持续采集，随时把最近一段画面保存成动画
+//
+// 采集线程按起点 + n / fps 的固定节拍从 FrameSource 取帧，直接交给 ReplayBuffer 压缩存储；
+// 采集加压缩跟不上节拍时跳到下一个未来的节拍，不会排队。
+// 为了可以整天开着，stats 给出采集线程的忙碌时间和 CPU 时间以及全部内存占用。
+//
+// FrameSource 只在采集线程上使用。Start/Stop 不能被多个线程同时调用；
+// Save 和 stats 可以在任何线程上调用，Save 与 Stop 并发时使用停止前的缓冲。
+class InstantReplay {
+public:
+    static constexpr int kMaxFps = 10;
+
+    explicit InstantReplay(std::unique_ptr<FrameSource> source);
+    ~InstantReplay();
+
+    InstantReplay(const InstantReplay&) = delete;
+    InstantReplay& operator=(const InstantReplay&) = delete;
+
+    // 区域为空或已在运行时返回 false
+    bool Start(const ReplayOptions& options);
+
+    // 停止采集并释放缓冲
+    void Stop();
+
+    // 把最近 duration 的画面写成动画文件；没有在运行或还没有画面时返回 false
+    bool Save(AnimationFormat format, const std::string& path, ReplayExport* result) const;
+
+    ReplayStats stats() const;
+
+    bool running() const;
+
+private:
+    using Clock = ReplayBuffer::Clock;
+
+    void CaptureLoop(std::shared_ptr<ReplayBuffer> buffer);
+
+    std::unique_ptr<FrameSource> source_;
+    ReplayOptions options_;
+    Clock::time_point start_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::shared_ptr<ReplayBuffer> buffer_;
+    bool stopping_ = false;
+    int64_t captured_ = 0;
+    int64_t failed_captures_ = 0;
+    size_t capture_bytes_ = 0;
+    std::chrono::microseconds capture_time_{0};
+    std::chrono::microseconds cpu_time_{0};
+
+    std::thread thread_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_REPLAY_BUFFER_H_
@@ -0,0 +1,118 @@
+#ifndef CAPTURE_CORE_SCREEN_RECORDER_H_
+#define CAPTURE_CORE_SCREEN_RECORDER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "capture_core/animation_writer.h"
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_source.h"
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+struct RecorderOptions {
+    // 录制区域（屏幕坐标）
+    Rect region;
+    // 目标帧率，限制在 [1, kMaxFps]
+    int fps = 10;
+    AnimationFormat format = AnimationFormat::kGif;
+    // 输出文件（UTF-8），Start 时创建
+    std::string path;
+    // 采集和编码之间的帧缓冲个数（至少 2）；编码跟不上时丢帧而不是排队
+    size_t ring_size = 4;
+};
+
+struct RecordingStats {
+    // 采集到的帧、因缓冲环满而丢掉的帧、采集失败的次数
+    int64_t captured = 0;
+    int64_t dropped = 0;
+    int64_t failed_captures = 0;
+    // 写入文件的帧和与上一帧相同而合并的帧
+    int64_t written = 0;
+    int64_t merged = 0;
+    std::chrono::milliseconds duration{0};
+    uint64_t bytes = 0;
+    // 文件完整写出；失败时文件已被删除
+    bool ok = false;
+};
+
+// 区域录屏：按固定帧率采集，边录边写 GIF/APNG
+//
+// 采集线程按起点 + n / fps 的固定节拍从 FrameSource 取帧，放进预先分配的缓冲环；
+// 编码线程按顺序取出交给 AnimationWriter（逐帧差分、只编码变化矩形并立即落盘），
+// 再把缓冲还回环里。内存只有环中的几帧加上写入器的两帧，与录制时长无关。
+// 编码跟不上时采集到的帧直接丢弃（计入 dropped），节拍不受影响。
+//
+// FrameSource 只在采集线程上使用。Start/Stop 不能被多个线程同时调用。
+class ScreenRecorder {
+public:
+    static constexpr int kMaxFps = 50;
+
+    explicit ScreenRecorder(std::unique_ptr<FrameSource> source);
+    // 仍在录制时放弃录制并删除文件
+    ~ScreenRecorder();
+
+    ScreenRecorder(const ScreenRecorder&) = delete;
+    ScreenRecorder& operator=(const ScreenRecorder&) = delete;
+
+    // 打开输出文件并开始录制；区域为空、已在录制或文件无法创建时返回 false
+    bool Start(const RecorderOptions& options);
+
+    // 停止采集，写完缓冲中的帧并关闭文件；没有在录制时返回空的统计
+    RecordingStats Stop();
+
+    // 放弃录制：停止线程并删除文件
+    void Abort();
+
+    bool recording() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Slot {
+        FrameBuffer frame;
+        std::chrono::milliseconds timestamp{0};
+    };
+
+    void CaptureLoop();
+    void EncodeLoop();
+    // 停止两个线程；drain 为 true 时编码线程先写完排队的帧
+    void Join(bool drain);
+
+    std::unique_ptr<FrameSource> source_;
+    std::unique_ptr<AnimationWriter> writer_;
+    RecorderOptions options_;
+    Clock::time_point start_;
+    Clock::time_point stop_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable capture_cv_;
+    std::condition_variable encode_cv_;
+    // 缓冲环：free_ 里是空闲的缓冲，filled_ 里是等待编码的帧（按时间顺序）
+    std::vector<std::unique_ptr<Slot>> free_;
+    std::deque<std::unique_ptr<Slot>> filled_;
+    bool running_ = false;
+    bool stopping_ = false;
+    // 采集线程已退出，编码线程写完剩余的帧后退出
+    bool capture_done_ = false;
+    bool write_failed_ = false;
+    int64_t captured_ = 0;
+    int64_t dropped_ = 0;
+    int64_t failed_captures_ = 0;
+
+    std::thread capture_thread_;
+    std::thread encode_thread_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_SCREEN_RECORDER_H_
@@ -0,0 +1,125 @@
+#ifndef CAPTURE_CORE_SCROLL_STITCHER_H_
+#define CAPTURE_CORE_SCROLL_STITCHER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_source.h"
+#include "capture_core/geometry.h"
+#include "capture_core/job_queue.h"
+#include "capture_core/png_encoder.h"
+
+namespace capture_core {
+
+struct ScrollStitchOptions {
+    // 比较行时忽略的左右两侧列数（滚动条、窗口阴影），这些列的内容不影响匹配
+    int ignore_left = 0;
+    int ignore_right = 24;
+    // 两帧至少要有多少行滚动内容重叠；同时也是定位用的锚点窗口的行数
+    int min_overlap = 32;
+    // 重叠部分中相同的行至少占多少比例（容忍光标闪烁之类的小变化）
+    double min_match = 0.9;
+};
+
+enum class StitchResult {
+    kAppended,   // 找到重叠，新内容已写出（第一帧也返回它）
+    kUnchanged,  // 与上一帧相同：页面已经到底或没有滚动
+    kNoOverlap,  // 找不到可靠的重叠（滚过了一整屏或内容变了），这一帧被丢弃
+    kFailed,     // 尺寸或格式与第一帧不同，或写文件失败
+};
+
+struct ScrollStitchStats {
+    int frames = 0;
+    int appended = 0;
+    int unchanged = 0;
+    int no_overlap = 0;
+    // 输出图像的高度（Finish 之前是已经写出的行数）
+    int height = 0;
+    // 最后一次匹配时的固定页眉、页脚行数和滚动的行数
+    int header_rows = 0;
+    int footer_rows = 0;
+    int last_offset = 0;
+    uint64_t bytes = 0;
+};
+
+// 长截图拼接：把滚动过程中连续截取的帧拼成一张高图，逐段流式写入 PNG
+//
+// 每帧先用 HashRow 算出每一行（去掉 ignore 列）的哈希。与上一帧同一位置哈希相同的
+// 顶部、底部行视为固定的页眉和页脚（各不超过帧高的 1/3），中间是滚动区域。
+// 在当前帧滚动区域顶部取一个行内容不全相同的锚点窗口，用行哈希序列的滚动哈希
+// 在上一帧中找出所有候选位置，再逐行比较重叠部分的哈希，相同比例最高（并列时滚动
+// 距离最小）且达到 min_match 的候选就是滚动距离。
+//
+// 新露出的行立即交给 PngStreamWriter，页眉只写一次（来自第一帧），页脚在 Finish 时
+// 取最后一帧的。内存中只有上一帧、两帧的行哈希和编码一段的缓冲，与页面长度无关。
+// 一个实例不能被多个线程同时调用。
+class ScrollStitcher {
+public:
+    ScrollStitcher();
+    explicit ScrollStitcher(const ScrollStitchOptions& options,
+                            const PngEncoderOptions& png_options = PngEncoderOptions());
+
+    ScrollStitcher(const ScrollStitcher&) = delete;
+    ScrollStitcher& operator=(const ScrollStitcher&) = delete;
+
+    // 开始一张新的长图（路径为 UTF-8）
+    bool Open(const std::string& path);
+
+    // 加入滚动后的下一帧；帧只在调用期间被读取
+    StitchResult AddFrame(const FrameBuffer& frame);
+
+    // 写出最后一帧剩下的行（页脚）并结束文件；没有任何帧时失败
+    bool Finish();
+
+    // 放弃并删除文件
+    void Abort();
+
+    const ScrollStitchStats& stats() const { return stats_; }
+
+private:
+    void HashRows(const FrameBuffer& frame, std::vector<uint64_t>* hashes) const;
+    // 在滚动区域 [top, end) 中找出当前帧相对上一帧滚动的行数；找不到时返回 -1
+    int FindOffset(int top, int end) const;
+    bool Emit(int first_row, int row_count);
+
+    ScrollStitchOptions options_;
+    PngStreamWriter writer_;
+    // 上一帧（自己持有的拷贝）和它的行哈希；current_hashes_ 是正在处理的帧的
+    FrameBuffer previous_;
+    std::vector<uint64_t> previous_hashes_;
+    std::vector<uint64_t> current_hashes_;
+    // previous_ 中 [0, emitted_) 的行已经写出（或属于已写出的内容）
+    int emitted_ = 0;
+    bool paired_ = false;
+    ScrollStitchStats stats_;
+};
+
+struct ScrollCaptureOptions {
+    ScrollStitchOptions stitch;
+    PngEncoderOptions png = PngEncoderOptions::ForEffort(PngEffort::kFast);
+    // 最多截取的帧数和输出的最大高度，防止无限滚动的页面
+    int max_frames = 100;
+    int max_height = 30000;
+    // 连续多少帧没有变化认为已经到底
+    int unchanged_limit = 2;
+    // 每次滚动后等待页面重绘的时间
+    std::chrono::milliseconds settle{120};
+};
+
+// 滚动一步（例如发送鼠标滚轮）；返回 false 时停止截取
+using ScrollFunction = std::function<bool()>;
+
+// 长截图：反复截取 region、拼接、滚动，直到页面到底、找不到重叠或达到上限，
+// 然后写完 path。成功时 stats（可为 nullptr）是拼接的统计。
+// 每次滚动前和等待重绘期间检查 token，取消时删除文件并返回 false
+bool CaptureScrolling(FrameSource* source, const Rect& region, const std::string& path,
+                      const ScrollCaptureOptions& options, const ScrollFunction& scroll,
+                      const CancellationToken& token, ScrollStitchStats* stats);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_SCROLL_STITCHER_H_
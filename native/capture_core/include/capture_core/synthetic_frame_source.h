@@ -0,0 +1,41 @@
+#ifndef CAPTURE_CORE_SYNTHETIC_FRAME_SOURCE_H_
+#define CAPTURE_CORE_SYNTHETIC_FRAME_SOURCE_H_
+
+#include <cstdint>
+
+#include "capture_core/frame_source.h"
+
+namespace capture_core {
+
+// 内存中的合成帧来源
+//
+// 不依赖任何窗口系统，用于在 Linux CI 上测试和剖析整条流水线。
+// 每次 Capture 都会推进帧计数器，画面中的方块随之移动，模拟真实屏幕的局部变化。
+class SyntheticFrameSource : public FrameSource {
+public:
+    enum class Pattern {
+        kGradient,  // 平滑渐变
+        kUi,        // 大块纯色 + 细线条，类似桌面 UI
+        kNoise,     // 高熵噪声，类似照片
+    };
+
+    SyntheticFrameSource(int width, int height, Pattern pattern);
+
+    Rect GetBounds() override;
+    bool Capture(const Rect& region, FrameBuffer* frame) override;
+
+    // 已生成的帧数
+    uint64_t frame_count() const { return frame_count_; }
+
+private:
+    void FillRow(int y, int x0, int count, uint8_t* out) const;
+
+    int width_;
+    int height_;
+    Pattern pattern_;
+    uint64_t frame_count_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_SYNTHETIC_FRAME_SOURCE_H_
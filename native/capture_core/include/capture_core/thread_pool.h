@@ -0,0 +1,49 @@
+#ifndef CAPTURE_CORE_THREAD_POOL_H_
+#define CAPTURE_CORE_THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace capture_core {
+
+// 固定大小的工作线程池
+//
+// ParallelFor 时调用线程也参与执行，所以工作线程数为 0 时退化为串行，
+// 多个线程同时调用 ParallelFor（或嵌套调用）也不会死锁。
+class ThreadPool {
+public:
+    // num_threads 为工作线程数，不含调用线程
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int num_threads() const { return static_cast<int>(workers_.size()); }
+
+    // 异步执行一个任务
+    void Submit(std::function<void()> task);
+
+    // 并发执行 fn(0) ... fn(count - 1)，全部完成后返回
+    void ParallelFor(int count, const std::function<void(int)>& fn);
+
+    // 进程内共享的线程池，工作线程数为 CPU 核数 - 1
+    static ThreadPool* Shared();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_THREAD_POOL_H_
@@ -0,0 +1,146 @@
+#ifndef CAPTURE_CORE_TILE_CHANGE_DETECTOR_H_
+#define CAPTURE_CORE_TILE_CHANGE_DETECTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+class ThreadPool;
+
+// 分块比较的结果
+struct TileDiff {
+    int tile_size = 0;
+    int columns = 0;
+    int rows = 0;
+    // 帧尺寸（最后一列/行的分块可能不满 tile_size）
+    int frame_width = 0;
+    int frame_height = 0;
+    // 按行优先排列，非 0 表示该分块与参考帧不同
+    std::vector<uint8_t> dirty;
+    size_t dirty_count = 0;
+    // 没有参考帧，或尺寸、格式与参考帧不同：所有分块都算脏
+    bool full = false;
+
+    size_t tile_count() const { return dirty.size(); }
+    double dirty_ratio() const {
+        return dirty.empty() ? 0.0 : static_cast<double>(dirty_count) / dirty.size();
+    }
+    bool is_dirty(int column, int row) const { return dirty[row * columns + column] != 0; }
+
+    // 分块在帧中的矩形（裁到帧边界）
+    Rect TileRect(int column, int row) const;
+    // 包含所有脏分块的最小矩形，没有脏分块时为空
+    Rect DirtyBounds() const;
+};
+
+// 按固定大小分块哈希，和参考帧比较找出变化的分块
+//
+// 每个分块用 4 路 xxHash64 式的累加（每轮 32 字节，4 路相互独立，
+// 编译器可以交错执行乘法）逐行哈希，分块行在线程池上并行；
+// 4K 帧约 2000 个 64x64 分块，每帧只保留哈希，不保留像素。
+// kBgrx8 的 X 通道不参与哈希（GDI 不保证它的值）。
+//
+// Compare 不会改变参考帧，调用方决定这一帧存盘后再 UpdateReference：
+// 循环截图只在真正保存了整帧时更新参考帧，补丁总是相对于最近的整帧。
+// 一个实例不能被多个线程同时调用。
+class TileChangeDetector {
+public:
+    static constexpr int kDefaultTileSize = 64;
+
+    // pool 为 nullptr 时使用 ThreadPool::Shared()
+    explicit TileChangeDetector(int tile_size = kDefaultTileSize, ThreadPool* pool = nullptr);
+
+    // 计算 frame 的分块哈希并与参考帧比较；结果在下一次 Compare 之前有效
+    const TileDiff& Compare(const FrameBuffer& frame);
+
+    // 把最近一次 Compare 的帧设为参考帧
+    void UpdateReference();
+
+    // 丢弃参考帧，下一次 Compare 所有分块都算脏
+    void Reset();
+
+    bool has_reference() const { return has_reference_; }
+    int tile_size() const { return tile_size_; }
+
+private:
+    const int tile_size_;
+    ThreadPool* pool_;
+
+    TileDiff diff_;
+    std::vector<uint64_t> hashes_;
+    std::vector<uint64_t> reference_;
+    int reference_width_ = 0;
+    int reference_height_ = 0;
+    PixelFormat reference_format_ = PixelFormat::kBgra8;
+    PixelFormat last_format_ = PixelFormat::kBgra8;
+    bool has_reference_ = false;
+};
+
+// 把脏分块拷进 DirtyBounds 大小的 kBgra8 补丁：脏分块 alpha 为 0xFF，
+// 其余位置全 0（透明），补丁贴回参考帧的 bounds 位置即得到当前帧。
+// 补丁只用 alpha 表示覆盖范围，不保留源帧的 alpha。没有脏分块时返回 false
+bool ExtractDirtyTiles(const FrameBuffer& frame, const TileDiff& diff, FrameBuffer* patch,
+                       Rect* bounds);
+
+// 循环截图这一帧的存储方式
+enum class ChangeAction {
+    kUnchanged,  // 与参考帧相同，不保存
+    kFullFrame,  // 保存整帧，并成为新的参考帧
+    kPatch,      // 只保存脏分块补丁（frame 已替换为补丁）
+};
+
+struct ChangeDecision {
+    ChangeAction action = ChangeAction::kFullFrame;
+    // kPatch 时补丁在整帧中的位置
+    Rect patch_bounds;
+    size_t dirty_tiles = 0;
+    size_t total_tiles = 0;
+    // 整帧尺寸（kPatch 时 frame 已是补丁尺寸）
+    int frame_width = 0;
+    int frame_height = 0;
+};
+
+// 按 key（循环任务 id）保存各自的参考帧哈希，为每一帧决定存储方式
+//
+// allow_patch 为 false 时只区分“未变化 / 整帧”；为 true 时脏分块比例
+// 不超过 keyframe_ratio 的帧替换成补丁，超过时保存整帧作为新的参考帧。
+// 不同 key 可以在不同线程上同时处理；同一 key 的帧按调用顺序串行。
+class ChangeTracker {
+public:
+    static constexpr double kDefaultKeyframeRatio = 0.5;
+
+    explicit ChangeTracker(int tile_size = TileChangeDetector::kDefaultTileSize,
+                           double keyframe_ratio = kDefaultKeyframeRatio);
+
+    ChangeDecision Process(const std::string& key, bool allow_patch, FrameBuffer* frame);
+
+    // 丢弃 key 的参考帧（任务删除或重新开始时）
+    void Forget(const std::string& key);
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        explicit Entry(int tile_size) : detector(tile_size) {}
+        std::mutex mutex;
+        TileChangeDetector detector;
+    };
+
+    const int tile_size_;
+    const double keyframe_ratio_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_TILE_CHANGE_DETECTOR_H_
@@ -0,0 +1,23 @@
+#ifndef CAPTURE_CORE_WINDOW_ICON_H_
+#define CAPTURE_CORE_WINDOW_ICON_H_
+
+#include <cstddef>
+
+#include "capture_core/frame_buffer.h"
+
+namespace capture_core {
+
+// 从 _NET_WM_ICON 属性中选一张图标转成 kBgra8
+//
+// 属性是若干张图标依次排列：宽、高、宽 x 高个 ARGB 像素（非预乘，A 在最高字节），
+// 每一项是一个 32 位 CARDINAL，Xlib 以 unsigned long 数组返回（count 为项数）。
+// 选长边不小于 preferred_size 的最小一张，都更小时选最大的一张；
+// 比 preferred_size 大时按面积平均缩小到长边等于 preferred_size。
+// 像素直接按位拆成 BGRA 写入 icon，不经过任何图像编解码。
+// 没有有效的图标（尺寸为 0 或数据被截断）时返回 false。
+bool SelectNetWmIcon(const unsigned long* data, size_t count, int preferred_size,
+                     FrameBuffer* icon);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_WINDOW_ICON_H_
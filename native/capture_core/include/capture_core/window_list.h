@@ -0,0 +1,84 @@
+#ifndef CAPTURE_CORE_WINDOW_LIST_H_
+#define CAPTURE_CORE_WINDOW_LIST_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 窗口选择器里的一个顶层窗口
+struct WindowRecord {
+    // 平台窗口句柄（HWND / X11 Window）
+    uint64_t id = 0;
+    // UTF-8
+    std::string title;
+    std::string app_name;
+    // 屏幕坐标
+    Rect bounds;
+    // 编码好的图标（PNG），没有时为空
+    std::vector<uint8_t> icon;
+
+    bool operator==(const WindowRecord& other) const {
+        return id == other.id && title == other.title && app_name == other.app_name &&
+               bounds == other.bounds && icon == other.icon;
+    }
+    bool operator!=(const WindowRecord& other) const { return !(*this == other); }
+};
+
+// 两次 TakeDiff 之间窗口列表的变化
+struct WindowListDiff {
+    std::vector<WindowRecord> added;
+    std::vector<WindowRecord> updated;
+    std::vector<uint64_t> removed;
+
+    bool empty() const { return added.empty() && updated.empty() && removed.empty(); }
+};
+
+// 事件驱动的窗口列表
+//
+// 平台的窗口事件（创建、销毁、改名、移动）转成 Upsert / Remove，模型保存当前列表，
+// 并把变化按窗口合并成待推送的差异：一批事件里同一个窗口改了几次只报告最后的状态，
+// 出现后又消失的窗口不报告。与已有记录完全相同的 Upsert 不算变化。
+// 列表顺序：Reset 保持给定顺序（z 序），之后新出现的窗口排在最前。
+// 不是线程安全的，由平台的跟踪器加锁。
+class WindowListModel {
+public:
+    // 用完整的枚举结果替换当前列表（启动时或事件丢失后重新同步），差异照常累积
+    void Reset(std::vector<WindowRecord> windows);
+
+    // 窗口出现或属性变化；返回是否有变化
+    bool Upsert(WindowRecord window);
+
+    // 窗口消失或不再符合条件；返回是否原本在列表中
+    bool Remove(uint64_t id);
+
+    bool Contains(uint64_t id) const { return windows_.count(id) != 0; }
+    const WindowRecord* Find(uint64_t id) const;
+
+    // 取出并清空自上次以来的差异；removed 按 id 排序，added / updated 按列表顺序
+    WindowListDiff TakeDiff();
+    bool has_changes() const { return !pending_.empty(); }
+
+    // 当前列表（按列表顺序）
+    std::vector<WindowRecord> Snapshot() const;
+    size_t size() const { return order_.size(); }
+
+private:
+    // 相对上一次 TakeDiff 的状态
+    enum class Change { kAdded, kUpdated, kRemoved };
+
+    void MarkRemoved(uint64_t id);
+
+    std::unordered_map<uint64_t, WindowRecord> windows_;
+    std::vector<uint64_t> order_;
+    std::map<uint64_t, Change> pending_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_WINDOW_LIST_H_
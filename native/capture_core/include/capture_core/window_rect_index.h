@@ -0,0 +1,84 @@
+#ifndef CAPTURE_CORE_WINDOW_RECT_INDEX_H_
+#define CAPTURE_CORE_WINDOW_RECT_INDEX_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/geometry.h"
+
+namespace capture_core {
+
+// 快照里的一个窗口或子控件
+struct WindowRectEntry {
+    // 平台句柄（HWND / X11 Window）
+    uint64_t id = 0;
+    // 已裁剪到父元素以内
+    Rect rect;
+    // 父元素的下标，顶层窗口为 -1
+    int parent = -1;
+    // 0 为顶层窗口，子控件逐层加一
+    int depth = 0;
+};
+
+// 区域选择蒙版的悬停检测：打开蒙版时的窗口和子控件矩形快照
+//
+// 每次鼠标移动都用 WindowFromPoint 查询要跨进程调用，还会查到蒙版自己；
+// 改为打开蒙版时（与冻结背景同时）按 z 序记录一次所有可见窗口和子控件的矩形，
+// 之后的查询只在内存中进行。矩形按均匀网格分桶，每个格子按添加顺序保存与它相交的条目，
+// 查询只扫描点所在的一个格子。
+//
+// 添加顺序即 z 序：顶层窗口从上到下；子控件在父元素之后添加，同一父元素的子控件从上到下。
+// 查询先找点所在的最上层顶层窗口，再逐层进入包含该点的最上层子控件（Snipaste 式吸附到内部元素）。
+// 所有矩形裁剪到 bounds（蒙版覆盖的虚拟桌面）以内，屏幕外的窗口不占格子。
+// 不是线程安全的，只在蒙版的窗口线程上使用。
+class WindowRectIndex {
+public:
+    // 格子边长（像素）；矩形跨越的格子越多，每个格子里的条目越多
+    static constexpr int kDefaultCellSize = 128;
+    // 格子数上限，bounds 很大时相应加大格子
+    static constexpr int kMaxCells = 4096;
+    static constexpr int kMaxDepth = 1 << 16;
+
+    WindowRectIndex() = default;
+    explicit WindowRectIndex(const Rect& bounds, int cell_size = kDefaultCellSize);
+
+    // 删除所有条目并改为覆盖 bounds
+    void Reset(const Rect& bounds, int cell_size = kDefaultCellSize);
+
+    // 添加一个元素，返回它的下标；parent 为 -1 表示顶层窗口，否则必须是已添加的条目。
+    // 矩形裁剪到父元素（顶层窗口裁剪到 bounds）以内，裁剪后为空时不添加并返回 -1
+    int Add(uint64_t id, const Rect& rect, int parent = -1);
+
+    // 点所在的最上层顶层窗口，没有时返回 -1
+    int TopLevelAt(int x, int y) const;
+
+    // 点所在的最内层元素：顶层窗口里包含该点的最上层子控件，再逐层向下，
+    // 最多到 max_depth 层（0 表示只看顶层窗口）；没有顶层窗口时返回 -1
+    int DeepestAt(int x, int y, int max_depth = kMaxDepth) const;
+
+    const WindowRectEntry& entry(int index) const { return entries_[index]; }
+    size_t size() const { return entries_.size(); }
+    bool empty() const { return entries_.empty(); }
+
+    const Rect& bounds() const { return bounds_; }
+
+    // 条目最多的格子里的条目数，即一次查询最多扫描的条目数（统计用）
+    size_t max_cell_entries() const;
+
+private:
+    // 点所在的格子，点在 bounds 之外时返回 nullptr
+    const std::vector<int>* CellAt(int x, int y) const;
+
+    Rect bounds_;
+    int cell_size_ = kDefaultCellSize;
+    // columns_ x rows_ 个格子按行存放，每个格子的下标按添加顺序（即 z 序）排列
+    int columns_ = 0;
+    int rows_ = 0;
+    std::vector<std::vector<int>> cells_;
+    std::vector<WindowRectEntry> entries_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_WINDOW_RECT_INDEX_H_
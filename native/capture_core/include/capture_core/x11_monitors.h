@@ -0,0 +1,19 @@
+#ifndef CAPTURE_CORE_X11_MONITORS_H_
+#define CAPTURE_CORE_X11_MONITORS_H_
+
+#include <vector>
+
+#include "capture_core/monitor_info.h"
+
+namespace capture_core {
+
+// 枚举 X11 显示器
+//
+// 服务器支持 XRandR 1.5 时使用 XRRGetMonitors（Xinerama 合并的多屏也会列出），
+// 否则（或编译时没有 libXrandr）把整个根窗口当作一个主显示器。
+// display_name 为 nullptr 时使用 $DISPLAY；连接失败返回空列表。
+std::vector<MonitorInfo> EnumerateX11Monitors(const char* display_name = nullptr);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_X11_MONITORS_H_
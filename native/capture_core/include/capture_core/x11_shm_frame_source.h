@@ -0,0 +1,63 @@
+#ifndef CAPTURE_CORE_X11_SHM_FRAME_SOURCE_H_
+#define CAPTURE_CORE_X11_SHM_FRAME_SOURCE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "capture_core/frame_source.h"
+
+namespace capture_core {
+
+// X11 屏幕帧来源（MIT-SHM）
+//
+// 使用 XShmGetImage 把根窗口像素直接写入一个可复用的共享内存段，
+// 重复截图既不分配内存也不经过 X socket 传输像素。
+// 服务器不支持 MIT-SHM（例如远程显示）时退回 XGetImage。
+//
+// 共享内存段按整个屏幕分配一次（指定 capture_area 时按该区域分配，
+// 多显示器并行截图时每个显示器一个实例）。32 位显示下 Capture 得到的 frame
+// 直接指向共享内存段（不拥有内存），内容在下一次 Capture 或实例销毁前有效。
+//
+// Xlib 连接不是线程安全的，一个实例只能在一个线程上使用。
+// 不在头文件中引入 Xlib，避免 None / Status 等宏污染包含方。
+class X11ShmFrameSource : public FrameSource {
+public:
+    // display_name 为 nullptr 时使用 $DISPLAY
+    // capture_area 为空时共享内存段按整个屏幕分配
+    explicit X11ShmFrameSource(const char* display_name = nullptr,
+                               const Rect& capture_area = Rect());
+    ~X11ShmFrameSource() override;
+
+    // 单个窗口的帧来源（window 为 X11 窗口 id），GetBounds / Capture 使用窗口内坐标。
+    // 服务器支持 XComposite 时把窗口重定向到离屏像素图（CompositeRedirectAutomatic，
+    // 已有合成管理器时不影响显示），从像素图读取，被遮挡的部分也是窗口自己的内容；
+    // 否则按窗口在根窗口中的位置截取屏幕上可见的部分。
+    // 窗口被销毁或取消映射后 GetBounds 为空，Capture 失败
+    static std::unique_ptr<X11ShmFrameSource> ForWindow(uint64_t window,
+                                                        const char* display_name = nullptr);
+
+    X11ShmFrameSource(const X11ShmFrameSource&) = delete;
+    X11ShmFrameSource& operator=(const X11ShmFrameSource&) = delete;
+
+    // 是否成功连接到 X 服务器
+    bool is_open() const;
+    // 是否在使用 MIT-SHM 路径
+    bool using_shm() const;
+    // 窗口来源是否从 XComposite 离屏像素图读取
+    bool using_composite() const;
+    // 当前共享内存段大小和累计创建次数（用于验证复用）
+    size_t segment_size() const;
+    int segment_allocations() const;
+
+    Rect GetBounds() override;
+    bool Capture(const Rect& region, FrameBuffer* frame) override;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_X11_SHM_FRAME_SOURCE_H_
@@ -0,0 +1,54 @@
+#ifndef CAPTURE_CORE_X11_WINDOW_TRACKER_H_
+#define CAPTURE_CORE_X11_WINDOW_TRACKER_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "capture_core/window_list.h"
+
+namespace capture_core {
+
+// X11 顶层窗口跟踪（EWMH）
+//
+// 启动时读取根窗口的 _NET_CLIENT_LIST 建立列表，之后不再轮询：
+// 根窗口的 _NET_CLIENT_LIST 变化时只描述新增的窗口、移除消失的窗口；
+// 各窗口的标题、WM_CLASS、_NET_WM_STATE、_NET_WM_ICON 变化以及移动、映射 / 取消映射时
+// 只重新描述该窗口（图标只在窗口出现或 _NET_WM_ICON 变化时重新编码）。
+// 事件在后台线程上按 coalesce 间隔合并，一批事件产生一次回调（在后台线程上调用，
+// 回调里不能调用 Stop）。
+//
+// 列出的窗口和各字段与 EnumerateX11Windows 相同。
+// 需要支持 EWMH 的窗口管理器；没有时列表为空。
+// 跟踪器使用自己的 X 连接，不在头文件中引入 Xlib。
+class X11WindowTracker {
+public:
+    using Callback = std::function<void(const WindowListDiff&)>;
+
+    // display_name 为 nullptr 时使用 $DISPLAY
+    explicit X11WindowTracker(const char* display_name = nullptr);
+    ~X11WindowTracker();
+
+    X11WindowTracker(const X11WindowTracker&) = delete;
+    X11WindowTracker& operator=(const X11WindowTracker&) = delete;
+
+    // 连接显示并同步读取初始列表（不产生回调），然后开始监听；
+    // 连接失败或已经启动时返回 false
+    bool Start(Callback callback,
+               std::chrono::milliseconds coalesce = std::chrono::milliseconds(50));
+    // 停止监听并断开连接；回调不会再被调用。可以再次 Start
+    void Stop();
+    bool running() const;
+
+    // 当前列表（最近映射的窗口排在最前）
+    std::vector<WindowRecord> Snapshot() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_X11_WINDOW_TRACKER_H_
@@ -0,0 +1,24 @@
+#ifndef CAPTURE_CORE_X11_WINDOWS_H_
+#define CAPTURE_CORE_X11_WINDOWS_H_
+
+#include <vector>
+
+#include "capture_core/window_list.h"
+
+namespace capture_core {
+
+// 窗口选择器的图标尺寸（_NET_WM_ICON 按此选择和缩小后编码为 PNG）
+constexpr int kX11WindowIconSize = 32;
+
+// 枚举 X11 顶层窗口（EWMH）
+//
+// 列出根窗口 _NET_CLIENT_LIST 中可见、有标题、不小于 100x50、
+// 没有 _NET_WM_STATE_HIDDEN / SKIP_TASKBAR 的窗口，最近映射的在前。
+// 标题取 _NET_WM_NAME（没有时取 WM_NAME），应用名取 WM_CLASS 的类名，
+// 图标取 _NET_WM_ICON 编码成 PNG，与 Windows 端 getAvailableWindows 的字段一致。
+// 需要支持 EWMH 的窗口管理器；display_name 为 nullptr 时使用 $DISPLAY，连接失败返回空列表。
+std::vector<WindowRecord> EnumerateX11Windows(const char* display_name = nullptr);
+
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_X11_WINDOWS_H_
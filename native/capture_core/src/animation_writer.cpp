@@ -0,0 +1,199 @@
+#include "capture_core/animation_writer.h"
+
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+namespace capture_core {
+
+namespace {
+
+inline uint32_t Load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 比较时参与的位：kBgrx8 的第 4 字节未定义（小端序下是最高字节）
+inline uint32_t CompareMask(PixelFormat format) {
+    return format == PixelFormat::kBgrx8 ? 0x00FFFFFFu : 0xFFFFFFFFu;
+}
+
+bool RowsEqual(const uint8_t* a, const uint8_t* b, int width, uint32_t mask) {
+    if (std::memcmp(a, b, static_cast<size_t>(width) * 4) == 0) {
+        return true;
+    }
+    if (mask == 0xFFFFFFFFu) {
+        return false;
+    }
+    for (int x = 0; x < width; x++) {
+        if ((Load32(a + x * 4) ^ Load32(b + x * 4)) & mask) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+Rect ChangedBounds(const FrameBuffer& previous, const FrameBuffer& current) {
+    if (current.empty()) {
+        return Rect();
+    }
+    if (previous.empty() || previous.width() != current.width() ||
+        previous.height() != current.height() || previous.format() != current.format()) {
+        return current.bounds();
+    }
+    const int width = current.width();
+    const int height = current.height();
+    const uint32_t mask = CompareMask(current.format());
+
+    int top = 0;
+    while (top < height && RowsEqual(previous.row(top), current.row(top), width, mask)) {
+        top++;
+    }
+    if (top == height) {
+        return Rect();
+    }
+    int bottom = height - 1;
+    while (bottom > top && RowsEqual(previous.row(bottom), current.row(bottom), width, mask)) {
+        bottom--;
+    }
+
+    // 左右边界只需要在已知范围之外继续找
+    int left = width;
+    int right = -1;
+    for (int y = top; y <= bottom; y++) {
+        const uint8_t* a = previous.row(y);
+        const uint8_t* b = current.row(y);
+        if (RowsEqual(a, b, width, mask)) continue;
+        int x = 0;
+        while (x < left && ((Load32(a + x * 4) ^ Load32(b + x * 4)) & mask) == 0) x++;
+        left = x < left ? x : left;
+        x = width - 1;
+        while (x > right && ((Load32(a + x * 4) ^ Load32(b + x * 4)) & mask) == 0) x--;
+        right = x > right ? x : right;
+    }
+    return Rect(left, top, right - left + 1, bottom - top + 1);
+}
+
+std::unique_ptr<AnimationWriter> AnimationWriter::Create(AnimationFormat format) {
+    switch (format) {
+        case AnimationFormat::kGif:
+            return std::make_unique<GifWriter>();
+        case AnimationFormat::kApng:
+            return std::make_unique<ApngWriter>();
+    }
+    return nullptr;
+}
+
+AnimationWriter::~AnimationWriter() {
+    if (out_.is_open()) {
+        Abort();
+    }
+}
+
+bool AnimationWriter::Open(const std::string& path) {
+    if (out_.is_open() || path.empty()) {
+        return false;
+    }
+    out_.open(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        return false;
+    }
+    path_ = path;
+    has_canvas_ = false;
+    has_pending_ = false;
+    failed_ = false;
+    frames_written_ = 0;
+    frames_merged_ = 0;
+    bytes_written_ = 0;
+    return true;
+}
+
+bool AnimationWriter::AddFrame(const FrameBuffer& frame, std::chrono::milliseconds timestamp) {
+    if (!out_.is_open() || failed_ || frame.empty()) {
+        return false;
+    }
+    if (has_pending_) {
+        if (frame.width() != pending_.width() || frame.height() != pending_.height() ||
+            frame.format() != pending_.format()) {
+            return false;
+        }
+        const Rect changed = ChangedBounds(pending_, frame);
+        if (changed.empty()) {
+            frames_merged_++;
+            return true;
+        }
+        if (!WritePending(timestamp)) {
+            return false;
+        }
+        pending_bounds_ = changed;
+    } else {
+        pending_bounds_ = frame.bounds();
+    }
+    pending_.CopyFrom(frame);
+    pending_start_ = timestamp;
+    has_pending_ = true;
+    return true;
+}
+
+bool AnimationWriter::WritePending(std::chrono::milliseconds end) {
+    if (end < pending_start_) {
+        end = pending_start_;
+    }
+    if (!WriteFrame(pending_, has_canvas_ ? &canvas_ : nullptr, pending_bounds_,
+                    pending_start_, end)) {
+        failed_ = true;
+        return false;
+    }
+    // 写出的帧成为新的画布，旧画布的内存留给下一帧
+    std::swap(canvas_, pending_);
+    has_canvas_ = true;
+    has_pending_ = false;
+    frames_written_++;
+    return true;
+}
+
+bool AnimationWriter::Finish(std::chrono::milliseconds end) {
+    if (!out_.is_open()) {
+        return false;
+    }
+    bool ok = !failed_ && has_pending_ && WritePending(end) && WriteTrailer(frames_written_);
+    out_.close();
+    ok = ok && !out_.fail();
+    if (!ok) {
+        std::error_code error;
+        std::filesystem::remove(std::filesystem::u8path(path_), error);
+    }
+    return ok;
+}
+
+void AnimationWriter::Abort() {
+    if (!out_.is_open()) {
+        return;
+    }
+    out_.close();
+    std::error_code error;
+    std::filesystem::remove(std::filesystem::u8path(path_), error);
+}
+
+bool AnimationWriter::Write(const uint8_t* data, size_t size) {
+    out_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!out_) {
+        return false;
+    }
+    bytes_written_ += size;
+    return true;
+}
+
+bool AnimationWriter::Overwrite(uint64_t offset, const uint8_t* data, size_t size) {
+    if (offset + size > bytes_written_) {
+        return false;
+    }
+    out_.seekp(static_cast<std::streamoff>(offset));
+    out_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    out_.seekp(static_cast<std::streamoff>(bytes_written_));
+    return static_cast<bool>(out_);
+}
+
+}  // namespace capture_core
@@ -0,0 +1,155 @@
+#include "capture_core/animation_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+namespace capture_core {
+
+namespace {
+
+const uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+inline uint32_t ReadBe32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+void AppendBe32(std::vector<uint8_t>* out, uint32_t value) {
+    out->push_back(static_cast<uint8_t>(value >> 24));
+    out->push_back(static_cast<uint8_t>(value >> 16));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+void AppendBe16(std::vector<uint8_t>* out, uint32_t value) {
+    out->push_back(static_cast<uint8_t>(value >> 8));
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+// 追加一个块：prefix（fdAT 的序号）和 data 拼成块数据，CRC 覆盖类型和数据
+void AppendChunk(std::vector<uint8_t>* out, const char type[4], const uint8_t* prefix,
+                 size_t prefix_length, const uint8_t* data, size_t length) {
+    AppendBe32(out, static_cast<uint32_t>(prefix_length + length));
+    const size_t type_pos = out->size();
+    out->insert(out->end(), type, type + 4);
+    if (prefix_length > 0) out->insert(out->end(), prefix, prefix + prefix_length);
+    if (length > 0) out->insert(out->end(), data, data + length);
+    const uLong crc = crc32(0L, out->data() + type_pos,
+                            static_cast<uInt>(4 + prefix_length + length));
+    AppendBe32(out, static_cast<uint32_t>(crc));
+}
+
+void AppendChunk(std::vector<uint8_t>* out, const char type[4],
+                 const std::vector<uint8_t>& data) {
+    AppendChunk(out, type, nullptr, 0, data.data(), data.size());
+}
+
+std::vector<uint8_t> AnimationControl(uint32_t frames) {
+    std::vector<uint8_t> data;
+    AppendBe32(&data, frames);
+    AppendBe32(&data, 0);  // 无限循环
+    return data;
+}
+
+}  // namespace
+
+ApngWriter::ApngWriter(const PngEncoderOptions& options) : encoder_(options) {}
+
+bool ApngWriter::WriteFrame(const FrameBuffer& frame, const FrameBuffer* previous,
+                            const Rect& bounds, std::chrono::milliseconds start,
+                            std::chrono::milliseconds end) {
+    const bool first = previous == nullptr;
+    if (first) {
+        sequence_ = 0;
+        if (!encoder_.Encode(frame, &png_)) return false;
+    } else {
+        // 只编码变化矩形；frame 在这一帧写完之前不会改变
+        FrameBuffer view;
+        view.Wrap(const_cast<uint8_t*>(frame.row(bounds.y)) + static_cast<size_t>(bounds.x) * 4,
+                  bounds.width, bounds.height, frame.stride(), frame.format());
+        if (!encoder_.Encode(view, &png_)) return false;
+    }
+    if (png_.size() < sizeof(kPngSignature) ||
+        std::memcmp(png_.data(), kPngSignature, sizeof(kPngSignature)) != 0) {
+        return false;
+    }
+
+    chunks_.clear();
+    size_t offset = sizeof(kPngSignature);
+    if (first) {
+        chunks_.insert(chunks_.end(), kPngSignature, kPngSignature + sizeof(kPngSignature));
+    }
+
+    // 帧控制：位置、尺寸、显示时长（超过 65535 ms 时改用 1/100 秒）
+    std::vector<uint8_t> control;
+    AppendBe32(&control, sequence_++);
+    AppendBe32(&control, static_cast<uint32_t>(bounds.width));
+    AppendBe32(&control, static_cast<uint32_t>(bounds.height));
+    AppendBe32(&control, static_cast<uint32_t>(bounds.x));
+    AppendBe32(&control, static_cast<uint32_t>(bounds.y));
+    const int64_t ms = std::max<int64_t>((end - start).count(), 1);
+    if (ms <= 0xFFFF) {
+        AppendBe16(&control, static_cast<uint32_t>(ms));
+        AppendBe16(&control, 1000);
+    } else {
+        AppendBe16(&control, static_cast<uint32_t>(std::min<int64_t>(ms / 10, 0xFFFF)));
+        AppendBe16(&control, 100);
+    }
+    control.push_back(0);  // dispose_op NONE
+    control.push_back(0);  // blend_op SOURCE
+
+    bool wrote_control = false;
+    while (offset + 12 <= png_.size()) {
+        const uint32_t length = ReadBe32(png_.data() + offset);
+        const char* type = reinterpret_cast<const char*>(png_.data() + offset + 4);
+        const uint8_t* data = png_.data() + offset + 8;
+        if (offset + 12 + length > png_.size()) return false;
+        offset += 12 + length;
+
+        if (std::memcmp(type, "IHDR", 4) == 0) {
+            if (first) {
+                // IHDR 原样保留，其后是 acTL（总帧数在 Finish 时回填）
+                chunks_.insert(chunks_.end(), png_.data() + offset - 12 - length,
+                               png_.data() + offset);
+                actl_offset_ = position() + chunks_.size();
+                AppendChunk(&chunks_, "acTL", AnimationControl(0));
+            }
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            if (!wrote_control) {
+                AppendChunk(&chunks_, "fcTL", control);
+                wrote_control = true;
+            }
+            if (first) {
+                // 第一帧就是默认图像，IDAT 原样保留
+                chunks_.insert(chunks_.end(), png_.data() + offset - 12 - length,
+                               png_.data() + offset);
+            } else {
+                uint8_t sequence[4];
+                sequence[0] = static_cast<uint8_t>(sequence_ >> 24);
+                sequence[1] = static_cast<uint8_t>(sequence_ >> 16);
+                sequence[2] = static_cast<uint8_t>(sequence_ >> 8);
+                sequence[3] = static_cast<uint8_t>(sequence_);
+                sequence_++;
+                AppendChunk(&chunks_, "fdAT", sequence, sizeof(sequence), data, length);
+            }
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+    }
+    return wrote_control && Write(chunks_);
+}
+
+bool ApngWriter::WriteTrailer(int64_t frames) {
+    chunks_.clear();
+    AppendChunk(&chunks_, "IEND", std::vector<uint8_t>());
+    if (!Write(chunks_)) {
+        return false;
+    }
+    chunks_.clear();
+    AppendChunk(&chunks_, "acTL", AnimationControl(static_cast<uint32_t>(frames)));
+    return Overwrite(actl_offset_, chunks_.data(), chunks_.size());
+}
+
+}  // namespace capture_core
@@ -0,0 +1,71 @@
+#include "capture_core/batch_capture.h"
+
+#include <algorithm>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/jpeg_encoder.h"
+#include "capture_core/pixel_convert.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/qoi_codec.h"
+
+namespace capture_core {
+
+namespace {
+
+// 每个工作线程每种格式一个编码器，压缩状态在批次之间复用
+FrameEncoder& WorkerEncoder(const EncodeOptions& options) {
+    thread_local PngEncoder png;
+    thread_local JpegEncoder jpeg;
+    thread_local QoiEncoder qoi;
+    if (options.format == ImageFormat::kJpeg) {
+        jpeg.set_quality(options.quality);
+        return jpeg;
+    }
+    if (options.format == ImageFormat::kQoi) {
+        return qoi;
+    }
+    return png;
+}
+
+void CaptureOne(FrameSource* source, const BatchCaptureOptions& options,
+                BatchCaptureItem* item) {
+    if (source == nullptr) {
+        return;
+    }
+    const Rect bounds = source->GetBounds();
+    FrameBuffer frame;
+    if (bounds.empty() || !source->Capture(bounds, &frame) || frame.empty()) {
+        return;
+    }
+    item->source_width = frame.width();
+    item->source_height = frame.height();
+
+    // 帧可能指向来源持有的缓冲，不缩小时直接编码，不多拷贝一次
+    FrameBuffer thumbnail;
+    const FrameBuffer* encoded = &frame;
+    if (options.max_dimension > 0 &&
+        std::max(frame.width(), frame.height()) > options.max_dimension) {
+        DownscaleFrame(frame, options.max_dimension, &thumbnail);
+        encoded = &thumbnail;
+    }
+    item->width = encoded->width();
+    item->height = encoded->height();
+    item->ok = WorkerEncoder(options.encode).Encode(*encoded, &item->bytes);
+    if (!item->ok) {
+        item->bytes.clear();
+    }
+}
+
+}  // namespace
+
+std::vector<BatchCaptureItem> CaptureBatch(const std::vector<FrameSource*>& sources,
+                                           const BatchCaptureOptions& options) {
+    std::vector<BatchCaptureItem> items(sources.size());
+    ThreadPool* pool = options.pool ? options.pool : ThreadPool::Shared();
+    pool->ParallelFor(static_cast<int>(sources.size()), [&](int i) {
+        CaptureOne(sources[i], options, &items[i]);
+    });
+    return items;
+}
+
+}  // namespace capture_core
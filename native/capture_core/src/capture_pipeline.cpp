@@ -0,0 +1,56 @@
+#include "capture_core/capture_pipeline.h"
+
+#include <chrono>
+
+namespace capture_core {
+
+namespace {
+
+int64_t ElapsedMicros(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+}  // namespace
+
+CapturePipeline::CapturePipeline(FrameSource* source, FrameEncoder* encoder)
+    : source_(source), encoder_(encoder) {}
+
+bool CapturePipeline::CaptureFull(std::vector<uint8_t>* out) {
+    if (source_ == nullptr) {
+        return false;
+    }
+    return CaptureRegion(source_->GetBounds(), out);
+}
+
+bool CapturePipeline::CaptureRegion(const Rect& region, std::vector<uint8_t>* out) {
+    if (!CaptureFrame(region) || encoder_ == nullptr) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = encoder_->Encode(frame_, out);
+    timings_.encode_us = ElapsedMicros(start);
+    timings_.encoded_bytes = ok ? out->size() : 0;
+    return ok;
+}
+
+bool CapturePipeline::CaptureFrame(const Rect& region) {
+    timings_ = CaptureTimings();
+    if (source_ == nullptr) {
+        return false;
+    }
+
+    Rect clipped = IntersectRects(region, source_->GetBounds());
+    if (clipped.empty()) {
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    bool ok = source_->Capture(clipped, &frame_);
+    timings_.capture_us = ElapsedMicros(start);
+    return ok && !frame_.empty();
+}
+
+}  // namespace capture_core
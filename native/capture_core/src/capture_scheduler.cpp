@@ -0,0 +1,253 @@
+#include "capture_core/capture_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace capture_core {
+
+CaptureScheduler::CaptureScheduler(JobQueue* jobs)
+    : jobs_(jobs), epoch_(Clock::now()), wheel_(kWheelSlots) {
+    thread_ = std::thread([this] { Loop(); });
+}
+
+CaptureScheduler::~CaptureScheduler() {
+    StopAll();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+}
+
+ScheduleId CaptureScheduler::Start(const Options& options, ShotFunction shot,
+                                   SkipFunction skipped) {
+    if (options.interval.count() <= 0 || !shot) {
+        return 0;
+    }
+    ScheduleId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        Schedule& schedule = schedules_[id];
+        schedule.options = options;
+        schedule.shot = std::move(shot);
+        schedule.skipped = std::move(skipped);
+        schedule.origin = Clock::now() + (options.first_delay.count() < 0 ? options.interval
+                                                                          : options.first_delay);
+        schedule.busy = std::make_shared<std::atomic<bool>>(false);
+        Insert(id, &schedule);
+        changed_ = true;
+    }
+    cv_.notify_one();
+    return id;
+}
+
+bool CaptureScheduler::Stop(ScheduleId id) {
+    JobId job = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = schedules_.find(id);
+        if (it == schedules_.end()) {
+            return false;
+        }
+        job = it->second.last_job;
+        // 时间轮里的条目轮到时再清理
+        schedules_.erase(it);
+    }
+    // 已经开始或结束的截图 Cancel 只设置取消标记或直接返回 false
+    if (job != 0) {
+        jobs_->Cancel(job);
+    }
+    return true;
+}
+
+void CaptureScheduler::StopAll() {
+    std::vector<ScheduleId> ids;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : schedules_) {
+            ids.push_back(entry.first);
+        }
+    }
+    for (ScheduleId id : ids) {
+        Stop(id);
+    }
+}
+
+bool CaptureScheduler::active(ScheduleId id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return schedules_.count(id) != 0;
+}
+
+size_t CaptureScheduler::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return schedules_.size();
+}
+
+int64_t CaptureScheduler::TickAt(Clock::time_point time) const {
+    return static_cast<int64_t>((time - epoch_) / kResolution);
+}
+
+CaptureScheduler::Clock::time_point CaptureScheduler::TimeOfTick(int64_t tick) const {
+    return epoch_ + tick * kResolution;
+}
+
+void CaptureScheduler::Insert(ScheduleId id, Schedule* schedule) {
+    const Clock::time_point deadline =
+        schedule->origin + (schedule->next_index - 1) * schedule->options.interval;
+    // 向上取整到格子，保证不会早于计划时间触发
+    int64_t tick = static_cast<int64_t>(
+        (deadline - epoch_ + kResolution - Clock::duration(1)) / kResolution);
+    tick = std::max(tick, current_tick_);
+    schedule->deadline_tick = tick;
+    wheel_[static_cast<size_t>(tick) % kWheelSlots].push_back(id);
+}
+
+void CaptureScheduler::Collect(Clock::time_point now, std::vector<Due>* due) {
+    const int64_t now_tick = TickAt(now);
+    if (now_tick < current_tick_) {
+        return;
+    }
+    // 落后超过一圈（系统休眠）时每个格子只需要看一遍
+    const int64_t last_tick = std::min(now_tick, current_tick_ + static_cast<int64_t>(kWheelSlots) - 1);
+    for (int64_t tick = current_tick_; tick <= last_tick; tick++) {
+        std::vector<ScheduleId>& slot = wheel_[static_cast<size_t>(tick) % kWheelSlots];
+        for (size_t i = 0; i < slot.size();) {
+            auto it = schedules_.find(slot[i]);
+            if (it != schedules_.end() && it->second.deadline_tick > now_tick) {
+                // 之后几圈才到期
+                i++;
+                continue;
+            }
+            const ScheduleId id = slot[i];
+            slot[i] = slot.back();
+            slot.pop_back();
+            if (it == schedules_.end()) {
+                continue;
+            }
+
+            Schedule& schedule = it->second;
+            const Options& options = schedule.options;
+            ScheduledShot shot;
+            shot.schedule = id;
+            shot.index = schedule.next_index;
+            shot.deadline = schedule.origin + (shot.index - 1) * options.interval;
+            // 落后超过一个间隔时只补最近的一次，跳过的格点计入 missed
+            if (now - shot.deadline >= options.interval) {
+                int64_t missed = static_cast<int64_t>((now - shot.deadline) / options.interval);
+                if (options.total_shots > 0) {
+                    missed = std::min(missed, options.total_shots - shot.index);
+                }
+                shot.missed = missed;
+                shot.index += missed;
+                shot.deadline += missed * options.interval;
+            }
+            shot.last = options.total_shots > 0 && shot.index >= options.total_shots;
+            due->push_back(Due{id, shot, schedule.shot, schedule.skipped, schedule.busy});
+
+            if (shot.last) {
+                schedules_.erase(it);
+            } else {
+                schedule.next_index = shot.index + 1;
+                Insert(id, &schedule);
+            }
+        }
+    }
+    current_tick_ = now_tick + 1;
+}
+
+int64_t CaptureScheduler::NextTick() const {
+    for (int64_t tick = current_tick_; tick < current_tick_ + static_cast<int64_t>(kWheelSlots);
+         tick++) {
+        for (ScheduleId id : wheel_[static_cast<size_t>(tick) % kWheelSlots]) {
+            auto it = schedules_.find(id);
+            if (it != schedules_.end() && it->second.deadline_tick <= tick) {
+                return tick;
+            }
+        }
+    }
+    return -1;
+}
+
+void CaptureScheduler::Dispatch(Due due) {
+    ScheduledShot skipped_shot = due.shot;
+    bool expected = false;
+    if (!due.busy->compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+        if (due.skipped) due.skipped(skipped_shot, SkipReason::kBusy);
+        return;
+    }
+
+    std::shared_ptr<std::atomic<bool>> busy = due.busy;
+    due.shot.busy = std::shared_ptr<void>(busy.get(), [busy](void*) {
+        busy->store(false, std::memory_order_release);
+    });
+    SkipFunction skipped = due.skipped;
+    const JobId job = jobs_->Submit(
+        [run = std::move(due.run), shot = std::move(due.shot)](
+            const CancellationToken& token) mutable {
+            shot.lateness =
+                std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - shot.deadline);
+            run(std::move(shot), token);
+        },
+        [skipped, skipped_shot]() {
+            if (skipped) skipped(skipped_shot, SkipReason::kCancelled);
+        });
+    if (job == 0) {
+        // 提交失败的闭包已经销毁，busy 随之释放
+        if (skipped) skipped(skipped_shot, SkipReason::kQueueFull);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = schedules_.find(due.id);
+        if (it != schedules_.end()) {
+            it->second.last_job = job;
+            return;
+        }
+    }
+    // 计划在提交期间被停止（Stop 看不到这次的 job），这里补上取消；
+    // 最后一次的计划在 Collect 中已经删除，不能取消
+    if (!skipped_shot.last) {
+        jobs_->Cancel(job);
+    }
+}
+
+void CaptureScheduler::Loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        std::vector<Due> due;
+        Collect(Clock::now(), &due);
+        if (!due.empty()) {
+            // 提交截图和跳过回调都在锁外，回调里可以调用 Stop
+            lock.unlock();
+            for (Due& entry : due) {
+                Dispatch(std::move(entry));
+            }
+            lock.lock();
+            continue;
+        }
+
+        const int64_t next = NextTick();
+        changed_ = false;
+        if (next < 0) {
+            // 一圈之内没有触发：睡一圈（或直到有新计划）
+            cv_.wait_until(lock, TimeOfTick(current_tick_ + static_cast<int64_t>(kWheelSlots)),
+                           [this] { return stopping_ || changed_; });
+            continue;
+        }
+        const Clock::time_point wake = TimeOfTick(next);
+        if (cv_.wait_until(lock, wake - kSpinMargin, [this] { return stopping_ || changed_; })) {
+            continue;
+        }
+        // 条件变量的唤醒精度受系统定时器影响，最后一小段让出时间片等待
+        lock.unlock();
+        while (Clock::now() < wake) {
+            std::this_thread::yield();
+        }
+        lock.lock();
+    }
+}
+
+}  // namespace capture_core
@@ -0,0 +1,155 @@
+#include "capture_core/damage_tracker.h"
+
+#include <limits>
+#include <utility>
+
+namespace capture_core {
+namespace {
+
+int64_t Area(const Rect& rect) {
+    return rect.empty() ? 0 : static_cast<int64_t>(rect.width) * rect.height;
+}
+
+}  // namespace
+
+void DamageTracker::Reset(const Rect& bounds) {
+    bounds_ = bounds;
+    previous_.clear();
+    current_.clear();
+    full_ = true;
+}
+
+void DamageTracker::SetLayer(uint32_t id, const Rect& rect, uint64_t content) {
+    Layer& layer = current_[id];
+    layer.rect = rect.empty() ? Rect() : rect;
+    layer.content = content;
+    layer.hole = false;
+}
+
+void DamageTracker::SetHole(uint32_t id, const Rect& rect) {
+    Layer& layer = current_[id];
+    layer.rect = rect.empty() ? Rect() : rect;
+    layer.content = 0;
+    layer.hole = true;
+}
+
+void DamageTracker::AddDamage(const Rect& rect) {
+    std::vector<Rect> pieces;
+    const Rect clipped = IntersectRects(rect, bounds_);
+    if (!clipped.empty()) {
+        pieces.push_back(clipped);
+    }
+    // 去掉已经要重画的部分，保持互不相交
+    for (const Rect& existing : damage_) {
+        if (pieces.empty()) {
+            return;
+        }
+        std::vector<Rect> remaining;
+        for (const Rect& piece : pieces) {
+            for (const Rect& rest : SubtractRects(piece, existing)) {
+                remaining.push_back(rest);
+            }
+        }
+        pieces.swap(remaining);
+    }
+    damage_.insert(damage_.end(), pieces.begin(), pieces.end());
+}
+
+void DamageTracker::Coalesce() {
+    // 每次合并后从其余矩形中去掉被合并矩形覆盖的部分，数量可能反弹，轮数有上限
+    for (size_t round = 0; damage_.size() > kMaxRects; round++) {
+        if (round >= kMaxRects * 4) {
+            Rect all;
+            for (const Rect& rect : damage_) {
+                all = UnionRects(all, rect);
+            }
+            damage_.assign(1, all);
+            return;
+        }
+        size_t best_a = 0;
+        size_t best_b = 1;
+        int64_t best_waste = std::numeric_limits<int64_t>::max();
+        for (size_t a = 0; a < damage_.size(); a++) {
+            for (size_t b = a + 1; b < damage_.size(); b++) {
+                const int64_t waste = Area(UnionRects(damage_[a], damage_[b])) -
+                                      Area(damage_[a]) - Area(damage_[b]);
+                if (waste < best_waste) {
+                    best_waste = waste;
+                    best_a = a;
+                    best_b = b;
+                }
+            }
+        }
+        const Rect merged = UnionRects(damage_[best_a], damage_[best_b]);
+        std::vector<Rect> rest;
+        for (size_t i = 0; i < damage_.size(); i++) {
+            if (i == best_a || i == best_b) {
+                continue;
+            }
+            for (const Rect& piece : SubtractRects(damage_[i], merged)) {
+                rest.push_back(piece);
+            }
+        }
+        rest.push_back(merged);
+        damage_.swap(rest);
+    }
+}
+
+std::vector<Rect> DamageTracker::Commit() {
+    damage_.clear();
+    bool full = full_;
+    if (!full) {
+        auto changed = [this](const Layer* before, const Layer* after) {
+            if (before == nullptr || after == nullptr) {
+                AddDamage((before != nullptr ? before : after)->rect);
+            } else if (before->hole && after->hole) {
+                if (before->rect != after->rect) {
+                    for (const Rect& piece : SubtractRects(before->rect, after->rect)) {
+                        AddDamage(piece);
+                    }
+                    for (const Rect& piece : SubtractRects(after->rect, before->rect)) {
+                        AddDamage(piece);
+                    }
+                }
+            } else if (before->rect != after->rect || before->content != after->content ||
+                       before->hole != after->hole) {
+                AddDamage(before->rect);
+                AddDamage(after->rect);
+            }
+        };
+        for (const auto& entry : previous_) {
+            auto it = current_.find(entry.first);
+            changed(&entry.second, it == current_.end() ? nullptr : &it->second);
+        }
+        for (const auto& entry : current_) {
+            if (previous_.count(entry.first) == 0) {
+                changed(nullptr, &entry.second);
+            }
+        }
+        Coalesce();
+
+        int64_t area = 0;
+        for (const Rect& rect : damage_) {
+            area += Area(rect);
+        }
+        full = area * 2 > Area(bounds_);
+    }
+    if (full) {
+        damage_.clear();
+        if (!bounds_.empty()) {
+            damage_.push_back(bounds_);
+        }
+        stats_.full_repaints++;
+    }
+
+    stats_.frames++;
+    for (const Rect& rect : damage_) {
+        stats_.repainted_pixels += static_cast<uint64_t>(Area(rect));
+    }
+    previous_.swap(current_);
+    current_.clear();
+    full_ = false;
+    return damage_;
+}
+
+}  // namespace capture_core
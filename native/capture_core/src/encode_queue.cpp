@@ -0,0 +1,312 @@
+#include "capture_core/encode_queue.h"
+
+#include <utility>
+
+namespace capture_core {
+
+EncodeQueue::EncodeQueue(EncoderFactory factory, int num_workers, size_t max_pending)
+    : factory_(std::move(factory)), jobs_(num_workers, max_pending) {}
+
+EncodeQueue::~EncodeQueue() {
+    // 暂存帧不在 jobs_ 里，需要单独通知；排队中的帧由 jobs_ 析构时取消
+    CancelHeld();
+}
+
+std::shared_ptr<FrameBuffer> EncodeQueue::Adopt(FrameBuffer frame, bool* copied) {
+    *copied = !frame.owns_memory();
+    if (!*copied) {
+        return std::make_shared<FrameBuffer>(std::move(frame));
+    }
+    std::shared_ptr<FrameBuffer> owned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_frames_.empty()) {
+            owned = std::move(idle_frames_.back());
+            idle_frames_.pop_back();
+        }
+    }
+    if (!owned) {
+        owned = std::make_shared<FrameBuffer>();
+    }
+    owned->CopyFrom(frame);
+    return owned;
+}
+
+JobId EncodeQueue::Schedule(FrameHandle handle, const Completion& done) {
+    // JobQueue::Submit 不会回调，持锁调用可以保证任务开始前条目已经就绪
+    return jobs_.Submit(
+        [this, handle, done](const CancellationToken& token) { Run(handle, token, done); },
+        [this, handle, done]() {
+            Finish(handle);
+            EncodeResult result;
+            result.handle = handle;
+            result.status = EncodeStatus::kCancelled;
+            done(std::move(result));
+        });
+}
+
+void EncodeQueue::Recycle(std::shared_ptr<FrameBuffer> frame) {
+    if (frame && idle_frames_.size() < jobs_.max_pending()) {
+        frame->Reset();
+        idle_frames_.push_back(std::move(frame));
+    }
+}
+
+FrameHandle EncodeQueue::Submit(FrameBuffer frame, Completion done,
+                                const EncodeOptions& options) {
+    if (frame.empty()) {
+        return 0;
+    }
+
+    bool copied = false;
+    std::shared_ptr<FrameBuffer> owned = Adopt(std::move(frame), &copied);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    FrameHandle handle = next_handle_++;
+    JobId job = Schedule(handle, done);
+    if (job == 0) {
+        if (copied) {
+            Recycle(std::move(owned));
+        }
+        return 0;
+    }
+    entries_[handle] = Entry{std::move(owned), job, nullptr, options};
+    return handle;
+}
+
+FrameHandle EncodeQueue::Hold(FrameBuffer frame, Completion done,
+                              const EncodeOptions& options) {
+    if (frame.empty()) {
+        return 0;
+    }
+    {
+        // 先检查上限，满了就不必拷贝
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (held_count_ >= jobs_.max_pending()) {
+            return 0;
+        }
+    }
+
+    bool copied = false;
+    std::shared_ptr<FrameBuffer> owned = Adopt(std::move(frame), &copied);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (held_count_ >= jobs_.max_pending()) {
+        if (copied) {
+            Recycle(std::move(owned));
+        }
+        return 0;
+    }
+    FrameHandle handle = next_handle_++;
+    entries_[handle] = Entry{std::move(owned), 0, std::move(done), options};
+    held_count_++;
+    return handle;
+}
+
+bool EncodeQueue::Encode(FrameHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(handle);
+    if (it == entries_.end() || it->second.job != 0) {
+        return false;
+    }
+    JobId job = Schedule(handle, it->second.done);
+    if (job == 0) {
+        return false;
+    }
+    it->second.job = job;
+    it->second.done = nullptr;
+    held_count_--;
+    return true;
+}
+
+FrameBuffer EncodeQueue::AcquireFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_frames_.empty()) {
+        return FrameBuffer();
+    }
+    FrameBuffer frame = std::move(*idle_frames_.back());
+    idle_frames_.pop_back();
+    return frame;
+}
+
+void EncodeQueue::ReleaseFrame(FrameBuffer frame) {
+    if (frame.capacity_bytes() == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Recycle(std::make_shared<FrameBuffer>(std::move(frame)));
+}
+
+std::shared_ptr<const FrameBuffer> EncodeQueue::Peek(FrameHandle handle) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(handle);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+    return it->second.frame;
+}
+
+bool EncodeQueue::Cancel(FrameHandle handle) {
+    JobId job;
+    Completion done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(handle);
+        if (it == entries_.end()) {
+            return false;
+        }
+        job = it->second.job;
+        if (job == 0) {
+            // 暂存帧：直接移除，done 在锁外调用
+            done = std::move(it->second.done);
+            std::shared_ptr<FrameBuffer> frame = std::move(it->second.frame);
+            entries_.erase(it);
+            held_count_--;
+            if (frame.use_count() == 1) {
+                Recycle(std::move(frame));
+            }
+        }
+    }
+    if (job == 0) {
+        EncodeResult result;
+        result.handle = handle;
+        result.status = EncodeStatus::kCancelled;
+        if (done) {
+            done(std::move(result));
+        }
+        return true;
+    }
+    // 排队中的任务会同步调用 on_cancelled（它要加锁），不能持锁调用
+    return jobs_.Cancel(job);
+}
+
+size_t EncodeQueue::CancelAll() {
+    return CancelHeld() + jobs_.CancelAll();
+}
+
+size_t EncodeQueue::CancelHeld() {
+    std::vector<FrameHandle> handles;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : entries_) {
+            if (entry.second.job == 0) {
+                handles.push_back(entry.first);
+            }
+        }
+    }
+    size_t cancelled = 0;
+    for (FrameHandle handle : handles) {
+        if (Cancel(handle)) {
+            cancelled++;
+        }
+    }
+    return cancelled;
+}
+
+size_t EncodeQueue::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t EncodeQueue::held() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_count_;
+}
+
+void EncodeQueue::Run(FrameHandle handle, const CancellationToken& token,
+                      const Completion& done) {
+    std::shared_ptr<FrameBuffer> frame;
+    EncodeOptions options;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(handle);
+        if (it != entries_.end()) {
+            frame = it->second.frame;
+            options = it->second.options;
+        }
+    }
+
+    EncodeResult result;
+    result.handle = handle;
+    bool ok = false;
+    if (frame && !token.cancelled()) {
+        if (options.format == ImageFormat::kJpeg) {
+            std::unique_ptr<JpegEncoder> encoder = AcquireJpegEncoder();
+            encoder->set_quality(options.quality);
+            ok = encoder->Encode(*frame, &result.bytes);
+            ReleaseJpegEncoder(std::move(encoder));
+        } else if (options.format == ImageFormat::kQoi) {
+            // QoiEncoder 没有状态，不需要复用
+            ok = QoiEncoder().Encode(*frame, &result.bytes);
+        } else {
+            std::unique_ptr<FrameEncoder> encoder = AcquireEncoder();
+            ok = encoder && encoder->Encode(*frame, &result.bytes);
+            ReleaseEncoder(std::move(encoder));
+        }
+    }
+    frame.reset();
+
+    if (token.cancelled()) {
+        result.status = EncodeStatus::kCancelled;
+        result.bytes.clear();
+    } else {
+        result.status = ok ? EncodeStatus::kOk : EncodeStatus::kFailed;
+    }
+
+    // 先移除句柄再通知：done 被调用时 Peek 已经返回 nullptr
+    Finish(handle);
+    done(std::move(result));
+}
+
+void EncodeQueue::Finish(FrameHandle handle) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(handle);
+    if (it == entries_.end()) {
+        return;
+    }
+    std::shared_ptr<FrameBuffer> frame = std::move(it->second.frame);
+    entries_.erase(it);
+    // 条目已移除，Peek 不会再增加引用；没有预览持有者时缓冲可以复用
+    if (frame.use_count() == 1) {
+        Recycle(std::move(frame));
+    }
+}
+
+std::unique_ptr<FrameEncoder> EncodeQueue::AcquireEncoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_encoders_.empty()) {
+            std::unique_ptr<FrameEncoder> encoder = std::move(idle_encoders_.back());
+            idle_encoders_.pop_back();
+            return encoder;
+        }
+    }
+    return factory_ ? factory_() : nullptr;
+}
+
+void EncodeQueue::ReleaseEncoder(std::unique_ptr<FrameEncoder> encoder) {
+    if (!encoder) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_encoders_.push_back(std::move(encoder));
+}
+
+std::unique_ptr<JpegEncoder> EncodeQueue::AcquireJpegEncoder() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_jpeg_encoders_.empty()) {
+            std::unique_ptr<JpegEncoder> encoder = std::move(idle_jpeg_encoders_.back());
+            idle_jpeg_encoders_.pop_back();
+            return encoder;
+        }
+    }
+    return std::unique_ptr<JpegEncoder>(new JpegEncoder());
+}
+
+void EncodeQueue::ReleaseJpegEncoder(std::unique_ptr<JpegEncoder> encoder) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_jpeg_encoders_.push_back(std::move(encoder));
+}
+
+}  // namespace capture_core
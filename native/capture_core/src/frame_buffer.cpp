@@ -0,0 +1,100 @@
+#include "capture_core/frame_buffer.h"
+
+#include <cstring>
+#include <utility>
+
+namespace capture_core {
+
+FrameBuffer::FrameBuffer()
+    : data_(nullptr), width_(0), height_(0), stride_(0),
+      format_(PixelFormat::kBgra8), owns_(false) {}
+
+FrameBuffer::FrameBuffer(int width, int height, PixelFormat format)
+    : FrameBuffer() {
+    Allocate(width, height, format);
+}
+
+FrameBuffer::FrameBuffer(FrameBuffer&& other) noexcept
+    : storage_(std::move(other.storage_)),
+      data_(other.data_), width_(other.width_), height_(other.height_),
+      stride_(other.stride_), format_(other.format_), owns_(other.owns_) {
+    other.data_ = nullptr;
+    other.width_ = other.height_ = other.stride_ = 0;
+    other.owns_ = false;
+}
+
+FrameBuffer& FrameBuffer::operator=(FrameBuffer&& other) noexcept {
+    if (this != &other) {
+        storage_ = std::move(other.storage_);
+        data_ = other.data_;
+        width_ = other.width_;
+        height_ = other.height_;
+        stride_ = other.stride_;
+        format_ = other.format_;
+        owns_ = other.owns_;
+        other.data_ = nullptr;
+        other.width_ = other.height_ = other.stride_ = 0;
+        other.owns_ = false;
+    }
+    return *this;
+}
+
+void FrameBuffer::Allocate(int width, int height, PixelFormat format) {
+    if (width <= 0 || height <= 0) {
+        Reset();
+        return;
+    }
+    stride_ = width * BytesPerPixel(format);
+    // resize 不会缩小容量，尺寸不变或变小时没有新的分配
+    storage_.resize(static_cast<size_t>(stride_) * height);
+    data_ = storage_.data();
+    width_ = width;
+    height_ = height;
+    format_ = format;
+    owns_ = true;
+}
+
+void FrameBuffer::Wrap(uint8_t* data, int width, int height, int stride,
+                       PixelFormat format) {
+    data_ = data;
+    width_ = width;
+    height_ = height;
+    stride_ = stride;
+    format_ = format;
+    owns_ = false;
+}
+
+void FrameBuffer::Reset() {
+    data_ = nullptr;
+    width_ = height_ = stride_ = 0;
+    owns_ = false;
+}
+
+FrameBuffer FrameBuffer::View(const Rect& rect) {
+    FrameBuffer view;
+    Rect clipped = IntersectRects(rect, bounds());
+    if (clipped.empty() || data_ == nullptr) {
+        return view;
+    }
+    uint8_t* origin = row(clipped.y) + clipped.x * BytesPerPixel(format_);
+    view.Wrap(origin, clipped.width, clipped.height, stride_, format_);
+    return view;
+}
+
+void FrameBuffer::CopyFrom(const FrameBuffer& other) {
+    if (other.empty()) {
+        Reset();
+        return;
+    }
+    Allocate(other.width(), other.height(), other.format());
+    size_t row_bytes = static_cast<size_t>(other.width()) * BytesPerPixel(other.format());
+    if (other.stride() == stride_) {
+        std::memcpy(data_, other.data(), row_bytes * height_);
+        return;
+    }
+    for (int y = 0; y < height_; y++) {
+        std::memcpy(row(y), other.row(y), row_bytes);
+    }
+}
+
+}  // namespace capture_core
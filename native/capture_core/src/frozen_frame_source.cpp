@@ -0,0 +1,28 @@
+#include "capture_core/frozen_frame_source.h"
+
+namespace capture_core {
+
+FrozenFrameSource::FrozenFrameSource(const FrameBuffer& frame, int origin_x, int origin_y)
+    : origin_x_(origin_x), origin_y_(origin_y) {
+    // 保存一个视图，像素仍由调用方持有
+    frame_.Wrap(const_cast<uint8_t*>(frame.data()), frame.width(), frame.height(),
+                frame.stride(), frame.format());
+}
+
+Rect FrozenFrameSource::GetBounds() {
+    if (frame_.empty()) {
+        return Rect();
+    }
+    return Rect(origin_x_, origin_y_, frame_.width(), frame_.height());
+}
+
+bool FrozenFrameSource::Capture(const Rect& region, FrameBuffer* frame) {
+    if (frame == nullptr) {
+        return false;
+    }
+    Rect local(region.x - origin_x_, region.y - origin_y_, region.width, region.height);
+    *frame = frame_.View(local);
+    return !frame->empty();
+}
+
+}  // namespace capture_core
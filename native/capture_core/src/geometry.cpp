@@ -0,0 +1,54 @@
+#include "capture_core/geometry.h"
+
+#include <algorithm>
+
+namespace capture_core {
+
+Rect IntersectRects(const Rect& a, const Rect& b) {
+    int left = std::max(a.x, b.x);
+    int top = std::max(a.y, b.y);
+    int right = std::min(a.right(), b.right());
+    int bottom = std::min(a.bottom(), b.bottom());
+    if (right <= left || bottom <= top) {
+        return Rect();
+    }
+    return Rect(left, top, right - left, bottom - top);
+}
+
+Rect UnionRects(const Rect& a, const Rect& b) {
+    if (a.empty()) return b;
+    if (b.empty()) return a;
+    int left = std::min(a.x, b.x);
+    int top = std::min(a.y, b.y);
+    int right = std::max(a.right(), b.right());
+    int bottom = std::max(a.bottom(), b.bottom());
+    return Rect(left, top, right - left, bottom - top);
+}
+
+std::vector<Rect> SubtractRects(const Rect& a, const Rect& b) {
+    std::vector<Rect> pieces;
+    if (a.empty()) {
+        return pieces;
+    }
+    const Rect overlap = IntersectRects(a, b);
+    if (overlap.empty()) {
+        pieces.push_back(a);
+        return pieces;
+    }
+    if (overlap.y > a.y) {
+        pieces.emplace_back(a.x, a.y, a.width, overlap.y - a.y);
+    }
+    if (overlap.bottom() < a.bottom()) {
+        pieces.emplace_back(a.x, overlap.bottom(), a.width, a.bottom() - overlap.bottom());
+    }
+    if (overlap.x > a.x) {
+        pieces.emplace_back(a.x, overlap.y, overlap.x - a.x, overlap.height);
+    }
+    if (overlap.right() < a.right()) {
+        pieces.emplace_back(overlap.right(), overlap.y, a.right() - overlap.right(),
+                            overlap.height);
+    }
+    return pieces;
+}
+
+}  // namespace capture_core
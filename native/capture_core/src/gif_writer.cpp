@@ -0,0 +1,216 @@
+#include "capture_core/animation_writer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace capture_core {
+
+namespace {
+
+constexpr int kMaxCodeSize = 12;
+constexpr int kMaxCode = (1 << kMaxCodeSize) - 1;
+// 字典最多 4096 项，8192 个槽位保证探测很短
+constexpr int kHashBits = 13;
+constexpr size_t kHashSlots = size_t(1) << kHashBits;
+
+void AppendLe16(std::vector<uint8_t>* out, int value) {
+    out->push_back(static_cast<uint8_t>(value));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+}
+
+inline bool SamePixel(const uint8_t* a, const uint8_t* b, bool ignore_x) {
+    return a[0] == b[0] && a[1] == b[1] && a[2] == b[2] && (ignore_x || a[3] == b[3]);
+}
+
+inline size_t HashEntry(int32_t key) {
+    return static_cast<size_t>((static_cast<uint32_t>(key) * 2654435761u) >> (32 - kHashBits));
+}
+
+// 按 LSB 优先把变长码打包成字节
+class BitPacker {
+public:
+    explicit BitPacker(std::vector<uint8_t>* out) : out_(out) {}
+
+    void Put(int code, int size) {
+        bits_ |= static_cast<uint32_t>(code) << count_;
+        count_ += size;
+        while (count_ >= 8) {
+            out_->push_back(static_cast<uint8_t>(bits_));
+            bits_ >>= 8;
+            count_ -= 8;
+        }
+    }
+
+    void Flush() {
+        if (count_ > 0) {
+            out_->push_back(static_cast<uint8_t>(bits_));
+        }
+        bits_ = 0;
+        count_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>* out_;
+    uint32_t bits_ = 0;
+    int count_ = 0;
+};
+
+// GIF 变体的 LZW：码长从 min_code_size + 1 增长到 12 位，字典满时写清除码重新开始。
+// 码长增长的时机与解码器一致：解码器总比编码器少一项字典，
+// 所以编码器在刚加入的项达到 1 << code_size 时增长
+void LzwEncode(const uint8_t* data, size_t count, int min_code_size,
+               std::vector<int32_t>* keys, std::vector<uint16_t>* codes,
+               std::vector<uint8_t>* out) {
+    const int clear_code = 1 << min_code_size;
+    const int end_code = clear_code + 1;
+    keys->assign(kHashSlots, -1);
+    codes->resize(kHashSlots);
+    out->clear();
+    BitPacker packer(out);
+
+    int code_size = min_code_size + 1;
+    int next_code = end_code + 1;
+    packer.Put(clear_code, code_size);
+    if (count == 0) {
+        packer.Put(end_code, code_size);
+        packer.Flush();
+        return;
+    }
+
+    int prefix = data[0];
+    for (size_t i = 1; i < count; i++) {
+        const int value = data[i];
+        const int32_t key = (prefix << 8) | value;
+        size_t slot = HashEntry(key);
+        while ((*keys)[slot] != -1 && (*keys)[slot] != key) {
+            slot = (slot + 1) & (kHashSlots - 1);
+        }
+        if ((*keys)[slot] == key) {
+            prefix = (*codes)[slot];
+            continue;
+        }
+
+        packer.Put(prefix, code_size);
+        const int entry = next_code++;
+        (*keys)[slot] = key;
+        (*codes)[slot] = static_cast<uint16_t>(entry);
+        if (entry >= (1 << code_size)) {
+            code_size++;
+        }
+        if (entry == kMaxCode) {
+            packer.Put(clear_code, code_size);
+            std::fill(keys->begin(), keys->end(), -1);
+            code_size = min_code_size + 1;
+            next_code = end_code + 1;
+        }
+        prefix = value;
+    }
+    packer.Put(prefix, code_size);
+    // 解码器读到最后一个码时补上它落后的那一项字典，码长可能随之增长
+    if (next_code == (1 << code_size) && code_size < kMaxCodeSize) {
+        code_size++;
+    }
+    packer.Put(end_code, code_size);
+    packer.Flush();
+}
+
+}  // namespace
+
+bool GifWriter::WriteFrame(const FrameBuffer& frame, const FrameBuffer* previous,
+                           const Rect& bounds, std::chrono::milliseconds,
+                           std::chrono::milliseconds end) {
+    if (frame.width() > 0xFFFF || frame.height() > 0xFFFF) {
+        return false;
+    }
+    block_.clear();
+    if (previous == nullptr) {
+        // 文件头、逻辑屏幕（没有全局调色板）和无限循环的 NETSCAPE2.0 扩展
+        static const uint8_t kSignature[6] = {'G', 'I', 'F', '8', '9', 'a'};
+        block_.insert(block_.end(), kSignature, kSignature + 6);
+        AppendLe16(&block_, frame.width());
+        AppendLe16(&block_, frame.height());
+        block_.push_back(0);
+        block_.push_back(0);
+        block_.push_back(0);
+        static const uint8_t kLoop[19] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A', 'P',
+                                          'E',  '2',  '.',  '0', 0x03, 0x01, 0x00, 0x00, 0x00};
+        block_.insert(block_.end(), kLoop, kLoop + sizeof(kLoop));
+        written_centiseconds_ = 0;
+    }
+
+    // 变化矩形内与上一帧相同的像素写成透明色，沿用画布上的像素
+    const size_t pixels = static_cast<size_t>(bounds.width) * bounds.height;
+    const uint8_t* skip = nullptr;
+    if (previous != nullptr) {
+        const bool ignore_x = frame.format() == PixelFormat::kBgrx8;
+        unchanged_.resize(pixels);
+        bool any = false;
+        for (int y = 0; y < bounds.height; y++) {
+            const uint8_t* a = previous->row(bounds.y + y) + static_cast<size_t>(bounds.x) * 4;
+            const uint8_t* b = frame.row(bounds.y + y) + static_cast<size_t>(bounds.x) * 4;
+            uint8_t* mask = unchanged_.data() + static_cast<size_t>(y) * bounds.width;
+            for (int x = 0; x < bounds.width; x++, a += 4, b += 4) {
+                mask[x] = SamePixel(a, b, ignore_x) ? 1 : 0;
+                any |= mask[x] != 0;
+            }
+        }
+        skip = any ? unchanged_.data() : nullptr;
+    }
+    const bool transparent = skip != nullptr;
+    quantizer_.Build(frame, bounds, skip, transparent ? 255 : 256, &palette_);
+    const int transparent_index = palette_.size;
+    const int colors = palette_.size + (transparent ? 1 : 0);
+    int table_bits = 1;
+    while ((1 << table_bits) < colors) {
+        table_bits++;
+    }
+
+    // 按帧边界取整到 10 ms，之前的取整误差由这一帧吸收
+    int64_t delay = (end.count() + 5) / 10 - written_centiseconds_;
+    delay = std::min<int64_t>(std::max<int64_t>(delay, 2), 0xFFFF);
+    written_centiseconds_ += delay;
+
+    // 图形控制扩展：不清除（disposal 1）、延迟、透明色
+    block_.push_back(0x21);
+    block_.push_back(0xF9);
+    block_.push_back(0x04);
+    block_.push_back(static_cast<uint8_t>((1 << 2) | (transparent ? 1 : 0)));
+    AppendLe16(&block_, static_cast<int>(delay));
+    block_.push_back(static_cast<uint8_t>(transparent ? transparent_index : 0));
+    block_.push_back(0x00);
+
+    // 图像描述符和局部调色板
+    block_.push_back(0x2C);
+    AppendLe16(&block_, bounds.x);
+    AppendLe16(&block_, bounds.y);
+    AppendLe16(&block_, bounds.width);
+    AppendLe16(&block_, bounds.height);
+    block_.push_back(static_cast<uint8_t>(0x80 | (table_bits - 1)));
+    const size_t table_bytes = (size_t(1) << table_bits) * 3;
+    const size_t table_pos = block_.size();
+    block_.resize(table_pos + table_bytes, 0);
+    std::memcpy(block_.data() + table_pos, palette_.rgb, static_cast<size_t>(palette_.size) * 3);
+
+    indices_.resize(pixels);
+    quantizer_.Map(frame, bounds, skip, static_cast<uint8_t>(transparent_index), indices_.data());
+    const int min_code_size = std::max(table_bits, 2);
+    LzwEncode(indices_.data(), pixels, min_code_size, &lzw_keys_, &lzw_codes_, &lzw_);
+
+    // 码流按最多 255 字节的子块写出，0 长度块结束
+    block_.push_back(static_cast<uint8_t>(min_code_size));
+    block_.reserve(block_.size() + lzw_.size() + lzw_.size() / 255 + 2);
+    for (size_t offset = 0; offset < lzw_.size(); offset += 255) {
+        const size_t length = std::min<size_t>(255, lzw_.size() - offset);
+        block_.push_back(static_cast<uint8_t>(length));
+        block_.insert(block_.end(), lzw_.begin() + offset, lzw_.begin() + offset + length);
+    }
+    block_.push_back(0x00);
+    return Write(block_);
+}
+
+bool GifWriter::WriteTrailer(int64_t) {
+    const uint8_t trailer = 0x3B;
+    return Write(&trailer, 1);
+}
+
+}  // namespace capture_core
@@ -0,0 +1,147 @@
+#include "capture_core/idle_transcoder.h"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/qoi_codec.h"
+
+namespace capture_core {
+
+namespace {
+
+PngEncoderOptions SerialOptions(ThreadPool* pool) {
+    PngEncoderOptions options;
+    options.pool = pool;
+    return options;
+}
+
+bool ReadWholeFile(const std::filesystem::path& path, std::vector<uint8_t>* bytes) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    bytes->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !in.bad();
+}
+
+bool WriteWholeFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out.write(reinterpret_cast<const char*>(bytes.data()),
+              static_cast<std::streamsize>(bytes.size()));
+    out.close();
+    return !out.fail();
+}
+
+}  // namespace
+
+IdleTranscoder::IdleTranscoder(std::chrono::milliseconds idle_delay)
+    : idle_delay_(idle_delay),
+      last_activity_(std::chrono::steady_clock::now()),
+      serial_pool_(0),
+      encoder_(SerialOptions(&serial_pool_)),
+      worker_([this] { WorkerLoop(); }) {}
+
+IdleTranscoder::~IdleTranscoder() {
+    std::deque<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        cancelled.swap(queue_);
+    }
+    cv_.notify_all();
+    worker_.join();
+    for (Job& job : cancelled) {
+        if (job.done) {
+            job.done(TranscodeResult{std::move(job.source), std::move(job.target),
+                                     TranscodeStatus::kCancelled});
+        }
+    }
+}
+
+bool IdleTranscoder::Enqueue(std::string source, std::string target, Completion done) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return false;
+        }
+        queue_.push_back(Job{std::move(source), std::move(target), std::move(done)});
+    }
+    cv_.notify_one();
+    return true;
+}
+
+void IdleTranscoder::NotifyActivity() {
+    // 不需要唤醒转码线程：它醒来时会按新的时间重新等待
+    std::lock_guard<std::mutex> lock(mutex_);
+    last_activity_ = std::chrono::steady_clock::now();
+}
+
+size_t IdleTranscoder::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+void IdleTranscoder::WorkerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        const auto idle_at = last_activity_ + idle_delay_;
+        if (std::chrono::steady_clock::now() < idle_at) {
+            cv_.wait_until(lock, idle_at, [this] { return stopping_; });
+            continue;
+        }
+
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        lock.unlock();
+
+        bool ok = TranscodeFile(job.source, job.target, &encoder_);
+        if (job.done) {
+            job.done(TranscodeResult{std::move(job.source), std::move(job.target),
+                                     ok ? TranscodeStatus::kOk : TranscodeStatus::kFailed});
+        }
+
+        lock.lock();
+    }
+}
+
+bool IdleTranscoder::TranscodeFile(const std::string& source, const std::string& target,
+                                   PngEncoder* encoder) {
+    const std::filesystem::path source_path = std::filesystem::u8path(source);
+    const std::filesystem::path target_path = std::filesystem::u8path(target);
+    std::filesystem::path temp_path = target_path;
+    temp_path += ".tmp";
+
+    std::vector<uint8_t> bytes;
+    FrameBuffer frame;
+    if (!ReadWholeFile(source_path, &bytes) || !DecodeQoi(bytes.data(), bytes.size(), &frame)) {
+        return false;
+    }
+    if (!encoder->Encode(frame, &bytes) || !WriteWholeFile(temp_path, bytes)) {
+        std::error_code ignored;
+        std::filesystem::remove(temp_path, ignored);
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, target_path, error);
+    if (error) {
+        std::filesystem::remove(temp_path, error);
+        return false;
+    }
+    std::filesystem::remove(source_path, error);
+    return true;
+}
+
+}  // namespace capture_core
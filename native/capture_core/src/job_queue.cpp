@@ -0,0 +1,123 @@
+#include "capture_core/job_queue.h"
+
+#include <algorithm>
+
+namespace capture_core {
+
+JobQueue::JobQueue(int num_workers, size_t max_pending) : max_pending_(max_pending) {
+    for (int i = 0; i < num_workers; i++) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+JobQueue::~JobQueue() {
+    std::deque<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        cancelled.swap(queue_);
+        for (auto& running : running_) {
+            running.second.Cancel();
+        }
+    }
+    cv_.notify_all();
+    for (Job& job : cancelled) {
+        job.token.Cancel();
+        if (job.on_cancelled) job.on_cancelled();
+    }
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+JobId JobQueue::Submit(RunFunction run, CancelFunction on_cancelled) {
+    JobId id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ || queue_.size() >= max_pending_) {
+            return 0;
+        }
+        id = next_id_++;
+        queue_.push_back(Job{id, std::move(run), std::move(on_cancelled), CancellationToken()});
+    }
+    cv_.notify_one();
+    return id;
+}
+
+bool JobQueue::Cancel(JobId id) {
+    Job cancelled;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto queued = std::find_if(queue_.begin(), queue_.end(),
+                                   [id](const Job& job) { return job.id == id; });
+        if (queued == queue_.end()) {
+            for (auto& running : running_) {
+                if (running.first == id) {
+                    running.second.Cancel();
+                    return true;
+                }
+            }
+            return false;
+        }
+        cancelled = std::move(*queued);
+        queue_.erase(queued);
+    }
+    // 回调可能再次调用队列，放在锁外执行
+    cancelled.token.Cancel();
+    if (cancelled.on_cancelled) cancelled.on_cancelled();
+    return true;
+}
+
+size_t JobQueue::CancelAll() {
+    std::deque<Job> cancelled;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled.swap(queue_);
+        for (auto& running : running_) {
+            running.second.Cancel();
+        }
+        count = cancelled.size() + running_.size();
+    }
+    for (Job& job : cancelled) {
+        job.token.Cancel();
+        if (job.on_cancelled) job.on_cancelled();
+    }
+    return count;
+}
+
+size_t JobQueue::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+size_t JobQueue::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_.size();
+}
+
+void JobQueue::WorkerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            job = std::move(queue_.front());
+            queue_.pop_front();
+            running_.emplace_back(job.id, job.token);
+        }
+
+        job.run(job.token);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_.erase(std::find_if(running_.begin(), running_.end(),
+                                    [&job](const std::pair<JobId, CancellationToken>& running) {
+                                        return running.first == job.id;
+                                    }));
+    }
+}
+
+}  // namespace capture_core
@@ -0,0 +1,304 @@
+#include "capture_core/jpeg_encoder.h"
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstddef>
+#include <cstdio>
+
+#include <jpeglib.h>
+
+#include "capture_core/pixel_convert.h"
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+namespace {
+
+// 自动划分时每个条带至少的像素数，太小的条带文件头和 RST 标记的开销不划算
+const size_t kMinStripPixels = 64 * 1024;
+// 一次交给 jpeg_write_scanlines 的行数（一个 4:2:0 MCU 行）
+const int kRowsPerWrite = 16;
+// DRI 字段只有 16 位
+const unsigned kMaxRestartInterval = 65535;
+// 输出缓冲的初始大小，不够时按倍数扩展
+const size_t kInitialOutputBytes = 64 * 1024;
+
+// libjpeg 默认的 error_exit 会结束进程，改为 longjmp 回到编码入口
+struct ErrorManager {
+    jpeg_error_mgr pub;
+    jmp_buf jump;
+};
+
+void ErrorExit(j_common_ptr cinfo) {
+    ErrorManager* error = reinterpret_cast<ErrorManager*>(cinfo->err);
+    longjmp(error->jump, 1);
+}
+
+void SilenceMessage(j_common_ptr) {}
+
+// 写入 std::vector 的目标管理器，缓冲在多次编码之间复用
+struct VectorDestination {
+    jpeg_destination_mgr pub;
+    std::vector<uint8_t>* buffer;
+    size_t used;
+};
+
+void InitDestination(j_compress_ptr cinfo) {
+    VectorDestination* dest = reinterpret_cast<VectorDestination*>(cinfo->dest);
+    if (dest->buffer->size() < kInitialOutputBytes) {
+        dest->buffer->resize(kInitialOutputBytes);
+    }
+    dest->pub.next_output_byte = dest->buffer->data();
+    dest->pub.free_in_buffer = dest->buffer->size();
+    dest->used = 0;
+}
+
+// libjpeg 只在整个缓冲写满时调用
+boolean EmptyOutputBuffer(j_compress_ptr cinfo) {
+    VectorDestination* dest = reinterpret_cast<VectorDestination*>(cinfo->dest);
+    const size_t used = dest->buffer->size();
+    dest->buffer->resize(used * 2);
+    dest->pub.next_output_byte = dest->buffer->data() + used;
+    dest->pub.free_in_buffer = dest->buffer->size() - used;
+    return TRUE;
+}
+
+void TermDestination(j_compress_ptr cinfo) {
+    VectorDestination* dest = reinterpret_cast<VectorDestination*>(cinfo->dest);
+    dest->used = dest->buffer->size() - dest->pub.free_in_buffer;
+}
+
+// 找到 SOS 段之后（熵编码数据开始）的位置，sof 返回 SOF 段的位置
+bool FindScanData(const uint8_t* data, size_t size, size_t* scan_start, size_t* sof) {
+    if (size < 4 || data[0] != 0xFF || data[1] != 0xD8) {
+        return false;
+    }
+    size_t pos = 2;
+    while (pos + 4 <= size) {
+        if (data[pos] != 0xFF) {
+            return false;
+        }
+        const uint8_t marker = data[pos + 1];
+        const size_t length = (static_cast<size_t>(data[pos + 2]) << 8) | data[pos + 3];
+        if (marker == 0xC0 || marker == 0xC1) {
+            *sof = pos;
+        }
+        if (marker == 0xDA) {
+            *scan_start = pos + 2 + length;
+            return *scan_start <= size;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+#ifndef JCS_EXTENSIONS
+// 非 libjpeg-turbo：先把一行转换成 RGB
+void ConvertRowToRgb(const uint8_t* src, int width, PixelFormat format, uint8_t* dst) {
+    if (format == PixelFormat::kRgba8) {
+        for (int x = 0; x < width; x++) {
+            dst[3 * x] = src[4 * x];
+            dst[3 * x + 1] = src[4 * x + 1];
+            dst[3 * x + 2] = src[4 * x + 2];
+        }
+    } else {
+        BgrxToRgb(src, dst, static_cast<size_t>(width));
+    }
+}
+#endif
+
+}  // namespace
+
+// 一个条带的编码状态，jpeg_compress_struct 在多次编码之间复用
+struct JpegEncoder::Strip {
+    int first_row = 0;
+    int row_count = 0;
+    jpeg_compress_struct cinfo;
+    ErrorManager error;
+    VectorDestination dest;
+    bool ready = false;
+    std::vector<uint8_t> encoded;
+    // 无 JCS_EXTENSIONS 时的 RGB 行暂存
+    std::vector<uint8_t> rgb_rows;
+    size_t scan_start = 0;
+    size_t sof = 0;
+    bool ok = false;
+
+    ~Strip() {
+        if (ready) {
+            jpeg_destroy_compress(&cinfo);
+        }
+    }
+
+    bool Init() {
+        if (ready) {
+            return true;
+        }
+        cinfo.err = jpeg_std_error(&error.pub);
+        error.pub.error_exit = ErrorExit;
+        error.pub.output_message = SilenceMessage;
+        if (setjmp(error.jump)) {
+            return false;
+        }
+        jpeg_create_compress(&cinfo);
+        dest.pub.init_destination = InitDestination;
+        dest.pub.empty_output_buffer = EmptyOutputBuffer;
+        dest.pub.term_destination = TermDestination;
+        dest.buffer = &encoded;
+        dest.used = 0;
+        cinfo.dest = &dest.pub;
+        ready = true;
+        return true;
+    }
+
+    // 把 frame 的 [first_row, first_row + row_count) 编码成一段完整的 JPEG
+    bool Compress(const FrameBuffer& frame, const JpegEncoderOptions& options,
+                  unsigned restart_interval, bool write_jfif) {
+        if (setjmp(error.jump)) {
+            jpeg_abort_compress(&cinfo);
+            return false;
+        }
+        Configure(frame, options, restart_interval, write_jfif);
+        jpeg_start_compress(&cinfo, TRUE);
+        WriteRows(frame);
+        jpeg_finish_compress(&cinfo);
+        return FindScanData(encoded.data(), dest.used, &scan_start, &sof) && dest.used >= 2 &&
+               encoded[dest.used - 2] == 0xFF && encoded[dest.used - 1] == 0xD9;
+    }
+
+    void Configure(const FrameBuffer& frame, const JpegEncoderOptions& options,
+                   unsigned restart_interval, bool write_jfif) {
+        cinfo.image_width = static_cast<JDIMENSION>(frame.width());
+        cinfo.image_height = static_cast<JDIMENSION>(row_count);
+#ifdef JCS_EXTENSIONS
+        // libjpeg-turbo 直接读 4 字节像素，X / alpha 通道被忽略
+        cinfo.input_components = 4;
+        cinfo.in_color_space =
+            frame.format() == PixelFormat::kRgba8 ? JCS_EXT_RGBX : JCS_EXT_BGRX;
+#else
+        cinfo.input_components = 3;
+        cinfo.in_color_space = JCS_RGB;
+#endif
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, std::min(100, std::max(1, options.quality)), TRUE);
+        cinfo.optimize_coding = FALSE;
+        cinfo.comp_info[0].h_samp_factor = options.subsampling == JpegSubsampling::k444 ? 1 : 2;
+        cinfo.comp_info[0].v_samp_factor = options.subsampling == JpegSubsampling::k420 ? 2 : 1;
+        for (int c = 1; c < 3; c++) {
+            cinfo.comp_info[c].h_samp_factor = 1;
+            cinfo.comp_info[c].v_samp_factor = 1;
+        }
+        cinfo.restart_interval = restart_interval;
+        cinfo.write_JFIF_header = write_jfif ? TRUE : FALSE;
+    }
+
+    void WriteRows(const FrameBuffer& frame) {
+        JSAMPROW rows[kRowsPerWrite];
+#ifndef JCS_EXTENSIONS
+        const size_t rgb_stride = static_cast<size_t>(frame.width()) * 3;
+        rgb_rows.resize(rgb_stride * kRowsPerWrite);
+#endif
+        while (cinfo.next_scanline < cinfo.image_height) {
+            const int y = static_cast<int>(cinfo.next_scanline);
+            const int count = std::min(kRowsPerWrite, row_count - y);
+            for (int i = 0; i < count; i++) {
+#ifdef JCS_EXTENSIONS
+                rows[i] = const_cast<JSAMPROW>(frame.row(first_row + y + i));
+#else
+                uint8_t* rgb = rgb_rows.data() + rgb_stride * i;
+                ConvertRowToRgb(frame.row(first_row + y + i), frame.width(), frame.format(), rgb);
+                rows[i] = rgb;
+#endif
+            }
+            jpeg_write_scanlines(&cinfo, rows, static_cast<JDIMENSION>(count));
+        }
+    }
+};
+
+JpegEncoder::JpegEncoder() : JpegEncoder(JpegEncoderOptions()) {}
+
+JpegEncoder::JpegEncoder(const JpegEncoderOptions& options) : options_(options) {}
+
+JpegEncoder::~JpegEncoder() = default;
+
+bool JpegEncoder::Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) {
+    if (frame.empty() || out == nullptr) {
+        return false;
+    }
+
+    const int width = frame.width();
+    const int height = frame.height();
+    const int mcu_width = options_.subsampling == JpegSubsampling::k444 ? 8 : 16;
+    const int mcu_height = options_.subsampling == JpegSubsampling::k420 ? 16 : 8;
+    const unsigned mcus_per_row = static_cast<unsigned>((width + mcu_width - 1) / mcu_width);
+    ThreadPool* pool = options_.pool ? options_.pool : ThreadPool::Shared();
+
+    // 划分条带：默认每个线程（含调用线程）两个，便于负载均衡；条带必须是整 MCU 行
+    int strip_rows = options_.strip_rows;
+    if (strip_rows <= 0) {
+        int target_strips = (pool->num_threads() + 1) * 2;
+        strip_rows = (height + target_strips - 1) / target_strips;
+        int min_rows = static_cast<int>((kMinStripPixels + width - 1) / width);
+        strip_rows = std::max(strip_rows, min_rows);
+    }
+    strip_rows = (strip_rows + mcu_height - 1) / mcu_height * mcu_height;
+    const int max_mcu_rows = static_cast<int>(kMaxRestartInterval / mcus_per_row);
+    strip_rows = std::max(mcu_height, std::min(strip_rows, max_mcu_rows * mcu_height));
+    int strip_count = (height + strip_rows - 1) / strip_rows;
+    if (max_mcu_rows == 0) {
+        strip_count = 1;
+        strip_rows = height;
+    }
+    // 单个条带不需要 restart 标记
+    const unsigned restart_interval =
+        strip_count > 1 ? static_cast<unsigned>(strip_rows / mcu_height) * mcus_per_row : 0;
+
+    while (static_cast<int>(strips_.size()) < strip_count) {
+        strips_.emplace_back(new Strip());
+    }
+    for (int i = 0; i < strip_count; i++) {
+        strips_[i]->first_row = i * strip_rows;
+        strips_[i]->row_count = std::min(strip_rows, height - i * strip_rows);
+    }
+    last_strip_count_ = strip_count;
+
+    pool->ParallelFor(strip_count, [&](int index) {
+        Strip& strip = *strips_[index];
+        strip.ok = strip.Init() && strip.Compress(frame, options_, restart_interval, index == 0);
+    });
+
+    size_t total = 0;
+    for (int i = 0; i < strip_count; i++) {
+        const Strip& strip = *strips_[i];
+        if (!strip.ok) {
+            return false;
+        }
+        total += strip.dest.used - strip.scan_start + 2;
+    }
+
+    const Strip& first = *strips_[0];
+    out->clear();
+    out->reserve(first.scan_start + total + 2);
+    out->insert(out->end(), first.encoded.begin(),
+                first.encoded.begin() + static_cast<ptrdiff_t>(first.scan_start));
+    // SOF：长度(2) 精度(1) 高度(2) 宽度(2)，高度改为整幅
+    (*out)[first.sof + 5] = static_cast<uint8_t>(height >> 8);
+    (*out)[first.sof + 6] = static_cast<uint8_t>(height);
+
+    for (int i = 0; i < strip_count; i++) {
+        const Strip& strip = *strips_[i];
+        if (i > 0) {
+            out->push_back(0xFF);
+            out->push_back(static_cast<uint8_t>(0xD0 + ((i - 1) & 7)));
+        }
+        // 去掉 EOI，熵编码数据已按字节对齐（填充 1）
+        out->insert(out->end(),
+                    strip.encoded.begin() + static_cast<ptrdiff_t>(strip.scan_start),
+                    strip.encoded.begin() + static_cast<ptrdiff_t>(strip.dest.used - 2));
+    }
+    out->push_back(0xFF);
+    out->push_back(0xD9);
+    return true;
+}
+
+}  // namespace capture_core
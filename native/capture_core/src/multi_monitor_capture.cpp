@@ -0,0 +1,100 @@
+#include "capture_core/multi_monitor_capture.h"
+
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+#include "capture_core/pixel_convert.h"
+
+namespace capture_core {
+
+Rect VirtualDesktopBounds(const std::vector<MonitorInfo>& monitors) {
+    Rect bounds;
+    for (const MonitorInfo& monitor : monitors) {
+        bounds = UnionRects(bounds, monitor.bounds);
+    }
+    return bounds;
+}
+
+MultiMonitorCapture::MultiMonitorCapture(std::vector<MonitorInfo> monitors,
+                                         const SourceFactory& factory, ThreadPool* pool)
+    : monitors_(std::move(monitors)), pool_(pool ? pool : ThreadPool::Shared()) {
+    sources_.reserve(monitors_.size());
+    for (const MonitorInfo& monitor : monitors_) {
+        sources_.push_back(factory ? factory(monitor) : nullptr);
+    }
+    frames_.resize(monitors_.size());
+}
+
+bool MultiMonitorCapture::CaptureMonitor(size_t index) {
+    FrameSource* source = sources_[index].get();
+    if (source == nullptr) {
+        return false;
+    }
+    // 显示器被拔掉或分辨率变化后，来源范围可能已经不包含原来的矩形
+    Rect region = IntersectRects(monitors_[index].bounds, source->GetBounds());
+    return !region.empty() && source->Capture(region, &frames_[index]) &&
+           !frames_[index].empty();
+}
+
+bool MultiMonitorCapture::CaptureEach() {
+    if (monitors_.empty()) {
+        return false;
+    }
+    std::atomic<bool> ok(true);
+    pool_->ParallelFor(static_cast<int>(monitors_.size()), [&](int i) {
+        if (!CaptureMonitor(static_cast<size_t>(i))) {
+            ok = false;
+        }
+    });
+    return ok;
+}
+
+bool MultiMonitorCapture::CaptureVirtualDesktop(FrameBuffer* frame) {
+    Rect desktop = virtual_bounds();
+    if (frame == nullptr || desktop.empty()) {
+        return false;
+    }
+    if (frame->width() != desktop.width || frame->height() != desktop.height) {
+        frame->Allocate(desktop.width, desktop.height, PixelFormat::kBgrx8);
+    }
+    frame->set_format(PixelFormat::kBgrx8);
+
+    // 显示器没有铺满虚拟桌面（大小不一或错位排列）时，空隙填黑
+    long long covered = 0;
+    for (const MonitorInfo& monitor : monitors_) {
+        covered += static_cast<long long>(monitor.bounds.width) * monitor.bounds.height;
+    }
+    if (covered < static_cast<long long>(desktop.width) * desktop.height) {
+        for (int y = 0; y < frame->height(); y++) {
+            std::memset(frame->row(y), 0, static_cast<size_t>(frame->width()) * 4);
+        }
+    }
+
+    // 抓取后立即拷进各自的位置，拷贝也并行进行
+    std::atomic<bool> ok(true);
+    pool_->ParallelFor(static_cast<int>(monitors_.size()), [&](int i) {
+        size_t index = static_cast<size_t>(i);
+        if (!CaptureMonitor(index)) {
+            ok = false;
+            return;
+        }
+        const FrameBuffer& src = frames_[index];
+        if (src.format() == PixelFormat::kRgba8) {
+            // 平台来源都输出 BGR 顺序，不在这里做通道转换
+            ok = false;
+            return;
+        }
+        const Rect& bounds = monitors_[index].bounds;
+        FrameBuffer dst = frame->View(Rect(bounds.x - desktop.x, bounds.y - desktop.y,
+                                           src.width(), src.height()));
+        if (dst.empty()) {
+            return;
+        }
+        CopyRows(src.data(), src.stride(), dst.data(), dst.stride(),
+                 static_cast<size_t>(dst.width()) * 4, dst.height(), false);
+    });
+    return ok;
+}
+
+}  // namespace capture_core
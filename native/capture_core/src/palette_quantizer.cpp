@@ -0,0 +1,249 @@
+#include "capture_core/palette_quantizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace capture_core {
+
+namespace {
+
+constexpr int kCells = 1 << 15;
+constexpr uint32_t kKeyMark = 1u << 24;
+
+// 像素的 R G B 打包为 0x00BBGGRR
+inline uint32_t ReadRgb(const uint8_t* p, bool bgr) {
+    const uint32_t r = bgr ? p[2] : p[0];
+    const uint32_t b = bgr ? p[0] : p[2];
+    return r | (static_cast<uint32_t>(p[1]) << 8) | (b << 16);
+}
+
+// 15 位直方图的格子：R G B 各取高 5 位
+inline int CellOf(uint32_t rgb) {
+    return static_cast<int>(((rgb >> 3) & 0x1F) << 10 | ((rgb >> 11) & 0x1F) << 5 |
+                            ((rgb >> 19) & 0x1F));
+}
+
+inline int CellChannel(int cell, int channel) {
+    return (cell >> (10 - channel * 5)) & 0x1F;
+}
+
+// 5 位还原到 8 位（高位复制到低位，31 -> 255）
+inline uint32_t Expand5(int v) {
+    return static_cast<uint32_t>((v << 3) | (v >> 2));
+}
+
+inline size_t HashKey(uint32_t key) {
+    return static_cast<size_t>((key * 2654435761u) >> 22);
+}
+
+// median cut 的盒子：cells_[begin, end) 及其各通道范围
+struct Box {
+    int begin = 0;
+    int end = 0;
+    uint64_t count = 0;
+    int lo[3] = {31, 31, 31};
+    int hi[3] = {0, 0, 0};
+
+    int LongestAxis() const {
+        int axis = 0;
+        for (int c = 1; c < 3; c++) {
+            if (hi[c] - lo[c] > hi[axis] - lo[axis]) axis = c;
+        }
+        return axis;
+    }
+};
+
+void ShrinkBox(const std::vector<uint16_t>& cells, const std::vector<uint32_t>& histogram,
+               Box* box) {
+    box->count = 0;
+    for (int c = 0; c < 3; c++) {
+        box->lo[c] = 31;
+        box->hi[c] = 0;
+    }
+    for (int i = box->begin; i < box->end; i++) {
+        const int cell = cells[i];
+        box->count += histogram[cell];
+        for (int c = 0; c < 3; c++) {
+            const int v = CellChannel(cell, c);
+            box->lo[c] = std::min(box->lo[c], v);
+            box->hi[c] = std::max(box->hi[c], v);
+        }
+    }
+}
+
+}  // namespace
+
+PaletteQuantizer::PaletteQuantizer()
+    : exact_table_(kExactSlots), histogram_(kCells), lookup_(kCells) {}
+
+void PaletteQuantizer::Build(const FrameBuffer& frame, const Rect& region, const uint8_t* skip,
+                             int max_colors, Palette* palette) {
+    max_colors = std::min(std::max(max_colors, 1), kMaxColors);
+    palette->size = 0;
+    const Rect area = IntersectRects(region, frame.bounds());
+    if (frame.empty() || area.empty()) {
+        exact_ = true;
+        return;
+    }
+    exact_ = BuildExact(frame, area, skip, max_colors, palette);
+    if (!exact_) {
+        BuildMedianCut(frame, area, skip, max_colors, palette);
+    }
+}
+
+int PaletteQuantizer::FindExact(uint32_t key) const {
+    for (size_t slot = HashKey(key);; slot = (slot + 1) & (kExactSlots - 1)) {
+        const ExactEntry& entry = exact_table_[slot];
+        if (entry.key == key) return entry.index;
+        if (entry.key == 0) return -1;
+    }
+}
+
+bool PaletteQuantizer::BuildExact(const FrameBuffer& frame, const Rect& region,
+                                  const uint8_t* skip, int max_colors, Palette* palette) {
+    std::fill(exact_table_.begin(), exact_table_.end(), ExactEntry{0, 0});
+    const bool bgr = frame.format() != PixelFormat::kRgba8;
+    int count = 0;
+    uint32_t last = 0;
+    for (int y = 0; y < region.height; y++) {
+        const uint8_t* src = frame.row(region.y + y) + static_cast<size_t>(region.x) * 4;
+        const uint8_t* row_skip = skip ? skip + static_cast<size_t>(y) * region.width : nullptr;
+        for (int x = 0; x < region.width; x++, src += 4) {
+            if (row_skip && row_skip[x]) continue;
+            const uint32_t key = ReadRgb(src, bgr) | kKeyMark;
+            if (key == last) continue;
+            last = key;
+            size_t slot = HashKey(key);
+            while (exact_table_[slot].key != 0 && exact_table_[slot].key != key) {
+                slot = (slot + 1) & (kExactSlots - 1);
+            }
+            if (exact_table_[slot].key == key) continue;
+            if (count == max_colors) {
+                return false;
+            }
+            exact_table_[slot] = ExactEntry{key, static_cast<uint8_t>(count)};
+            palette->rgb[count * 3] = static_cast<uint8_t>(key);
+            palette->rgb[count * 3 + 1] = static_cast<uint8_t>(key >> 8);
+            palette->rgb[count * 3 + 2] = static_cast<uint8_t>(key >> 16);
+            count++;
+        }
+    }
+    palette->size = count;
+    return true;
+}
+
+void PaletteQuantizer::BuildMedianCut(const FrameBuffer& frame, const Rect& region,
+                                      const uint8_t* skip, int max_colors, Palette* palette) {
+    std::fill(histogram_.begin(), histogram_.end(), 0u);
+    const bool bgr = frame.format() != PixelFormat::kRgba8;
+    for (int y = 0; y < region.height; y++) {
+        const uint8_t* src = frame.row(region.y + y) + static_cast<size_t>(region.x) * 4;
+        const uint8_t* row_skip = skip ? skip + static_cast<size_t>(y) * region.width : nullptr;
+        for (int x = 0; x < region.width; x++, src += 4) {
+            if (row_skip && row_skip[x]) continue;
+            histogram_[CellOf(ReadRgb(src, bgr))]++;
+        }
+    }
+    cells_.clear();
+    for (int cell = 0; cell < kCells; cell++) {
+        if (histogram_[cell] != 0) cells_.push_back(static_cast<uint16_t>(cell));
+    }
+
+    std::vector<Box> boxes(1);
+    boxes[0].begin = 0;
+    boxes[0].end = static_cast<int>(cells_.size());
+    ShrinkBox(cells_, histogram_, &boxes[0]);
+    while (static_cast<int>(boxes.size()) < max_colors) {
+        // 优先切分像素多、跨度大的盒子
+        int best = -1;
+        uint64_t best_score = 0;
+        for (size_t i = 0; i < boxes.size(); i++) {
+            const Box& box = boxes[i];
+            if (box.end - box.begin < 2) continue;
+            const int axis = box.LongestAxis();
+            const uint64_t score = box.count * static_cast<uint64_t>(box.hi[axis] - box.lo[axis]);
+            if (best < 0 || score > best_score) {
+                best = static_cast<int>(i);
+                best_score = score;
+            }
+        }
+        if (best < 0) break;
+
+        Box& box = boxes[best];
+        const int axis = box.LongestAxis();
+        std::sort(cells_.begin() + box.begin, cells_.begin() + box.end,
+                  [axis](uint16_t a, uint16_t b) {
+                      const int va = CellChannel(a, axis);
+                      const int vb = CellChannel(b, axis);
+                      return va != vb ? va < vb : a < b;
+                  });
+        // 按像素数（不是格子数）取中位
+        uint64_t accumulated = 0;
+        int split = box.begin + 1;
+        for (int i = box.begin; i < box.end - 1; i++) {
+            accumulated += histogram_[cells_[i]];
+            split = i + 1;
+            if (accumulated * 2 >= box.count) break;
+        }
+        Box upper;
+        upper.begin = split;
+        upper.end = box.end;
+        box.end = split;
+        ShrinkBox(cells_, histogram_, &box);
+        ShrinkBox(cells_, histogram_, &upper);
+        boxes.push_back(upper);
+    }
+
+    for (size_t i = 0; i < boxes.size(); i++) {
+        const Box& box = boxes[i];
+        uint64_t sum[3] = {0, 0, 0};
+        for (int j = box.begin; j < box.end; j++) {
+            const int cell = cells_[j];
+            const uint64_t weight = histogram_[cell];
+            for (int c = 0; c < 3; c++) {
+                sum[c] += weight * Expand5(CellChannel(cell, c));
+            }
+            lookup_[cell] = static_cast<uint8_t>(i);
+        }
+        for (int c = 0; c < 3; c++) {
+            palette->rgb[i * 3 + c] =
+                static_cast<uint8_t>(box.count ? (sum[c] + box.count / 2) / box.count : 0);
+        }
+    }
+    palette->size = cells_.empty() ? 0 : static_cast<int>(boxes.size());
+}
+
+void PaletteQuantizer::Map(const FrameBuffer& frame, const Rect& region, const uint8_t* skip,
+                           uint8_t skip_index, uint8_t* out) const {
+    const Rect area = IntersectRects(region, frame.bounds());
+    if (frame.empty() || area.empty()) {
+        return;
+    }
+    const bool bgr = frame.format() != PixelFormat::kRgba8;
+    uint32_t last = 0;
+    uint8_t last_index = 0;
+    for (int y = 0; y < area.height; y++) {
+        const uint8_t* src = frame.row(area.y + y) + static_cast<size_t>(area.x) * 4;
+        const uint8_t* row_skip = skip ? skip + static_cast<size_t>(y) * area.width : nullptr;
+        uint8_t* dst = out + static_cast<size_t>(y) * area.width;
+        for (int x = 0; x < area.width; x++, src += 4) {
+            if (row_skip && row_skip[x]) {
+                dst[x] = skip_index;
+                continue;
+            }
+            const uint32_t key = ReadRgb(src, bgr) | kKeyMark;
+            if (key != last) {
+                last = key;
+                if (exact_) {
+                    const int index = FindExact(key);
+                    last_index = static_cast<uint8_t>(index < 0 ? 0 : index);
+                } else {
+                    last_index = lookup_[CellOf(key)];
+                }
+            }
+            dst[x] = last_index;
+        }
+    }
+}
+
+}  // namespace capture_core
@@ -0,0 +1,94 @@
+#include "capture_core/perceptual_hash.h"
+
+#include <algorithm>
+
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+namespace {
+
+constexpr int kGridWidth = 9;
+constexpr int kGridHeight = 8;
+
+// 第 index 格在 [0, extent) 上的范围，格子不足一个像素时至少取一个像素
+inline void CellRange(int index, int cells, int extent, int* begin, int* end) {
+    *begin = static_cast<int>(static_cast<int64_t>(index) * extent / cells);
+    *end = std::max(*begin + 1, static_cast<int>(static_cast<int64_t>(index + 1) * extent / cells));
+    *begin = std::min(*begin, extent - 1);
+}
+
+}  // namespace
+
+uint64_t DifferenceHash(const FrameBuffer& frame, ThreadPool* pool) {
+    if (frame.empty()) {
+        return 0;
+    }
+    if (!pool) {
+        pool = ThreadPool::Shared();
+    }
+
+    // BT.601 亮度的 8 位定点系数；kRgba8 的 R、B 位置与 BGR 相反
+    const bool rgba = frame.format() == PixelFormat::kRgba8;
+    const uint32_t weight0 = rgba ? 77 : 29;
+    const uint32_t weight2 = rgba ? 29 : 77;
+    const int width = frame.width();
+    const int height = frame.height();
+
+    // 每格的平均亮度（乘以 256）
+    uint64_t cells[kGridHeight][kGridWidth];
+    pool->ParallelFor(kGridHeight, [&](int cell_row) {
+        int y0, y1;
+        CellRange(cell_row, kGridHeight, height, &y0, &y1);
+        int x_begin[kGridWidth];
+        int x_end[kGridWidth];
+        for (int c = 0; c < kGridWidth; c++) {
+            CellRange(c, kGridWidth, width, &x_begin[c], &x_end[c]);
+        }
+        // 按通道分别累加（只有加法，编译器可以向量化），最后再加权
+        uint64_t sums[kGridWidth][3] = {};
+        for (int y = y0; y < y1; y++) {
+            const uint8_t* row = frame.row(y);
+            for (int c = 0; c < kGridWidth; c++) {
+                const uint8_t* p = row + static_cast<size_t>(x_begin[c]) * 4;
+                const int count = x_end[c] - x_begin[c];
+                uint32_t s0 = 0, s1 = 0, s2 = 0;
+                for (int i = 0; i < count; i++) {
+                    s0 += p[4 * i];
+                    s1 += p[4 * i + 1];
+                    s2 += p[4 * i + 2];
+                }
+                sums[c][0] += s0;
+                sums[c][1] += s1;
+                sums[c][2] += s2;
+            }
+        }
+        for (int c = 0; c < kGridWidth; c++) {
+            const uint64_t area = static_cast<uint64_t>(y1 - y0) * (x_end[c] - x_begin[c]);
+            cells[cell_row][c] =
+                (sums[c][0] * weight0 + sums[c][1] * 150u + sums[c][2] * weight2) / area;
+        }
+    });
+
+    uint64_t hash = 0;
+    for (int row = 0; row < kGridHeight; row++) {
+        for (int col = 0; col < kGridWidth - 1; col++) {
+            if (cells[row][col] > cells[row][col + 1]) {
+                hash |= uint64_t{1} << (row * 8 + col);
+            }
+        }
+    }
+    return hash;
+}
+
+int HammingDistance(uint64_t a, uint64_t b) {
+    uint64_t v = a ^ b;
+    int count = 0;
+    while (v) {
+        v &= v - 1;
+        count++;
+    }
+    return count;
+}
+
+}  // namespace capture_core
@@ -0,0 +1,277 @@
+#include "capture_core/pixel_convert.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "pixel_convert_internal.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CAPTURE_CORE_X86 1
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+namespace capture_core {
+
+namespace internal {
+
+void SwapRedBlueScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++, src += 4, dst += 4) {
+        uint8_t b = src[0];
+        uint8_t g = src[1];
+        uint8_t r = src[2];
+        uint8_t a = src[3];
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+        dst[3] = a;
+    }
+}
+
+void SwapRedBlueOpaqueScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++, src += 4, dst += 4) {
+        uint8_t b = src[0];
+        uint8_t g = src[1];
+        uint8_t r = src[2];
+        dst[0] = r;
+        dst[1] = g;
+        dst[2] = b;
+        dst[3] = 0xFF;
+    }
+}
+
+void ForceOpaqueScalar(uint8_t* data, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++) {
+        data[i * 4 + 3] = 0xFF;
+    }
+}
+
+void BgrxToRgbScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++, src += 4, dst += 3) {
+        dst[0] = src[2];
+        dst[1] = src[1];
+        dst[2] = src[0];
+    }
+}
+
+void Bgr24ToBgraScalar(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    for (size_t i = 0; i < pixels; i++, src += 3, dst += 4) {
+        dst[0] = src[0];
+        dst[1] = src[1];
+        dst[2] = src[2];
+        dst[3] = 0xFF;
+    }
+}
+
+uint64_t HashRowScalar(const uint8_t* src, size_t pixels, uint32_t mask) {
+    uint32_t lanes[kRowHashLanes] = {};
+    HashRowLanes(src, pixels, mask, lanes);
+    return FinishRowHash(lanes, pixels);
+}
+
+}  // namespace internal
+
+namespace {
+
+const PixelKernels kScalarKernels = {
+    internal::SwapRedBlueScalar,
+    internal::SwapRedBlueOpaqueScalar,
+    internal::ForceOpaqueScalar,
+    internal::BgrxToRgbScalar,
+    internal::Bgr24ToBgraScalar,
+    internal::HashRowScalar,
+};
+
+#if defined(CAPTURE_CORE_X86)
+// AVX2 需要 CPU 支持，并且操作系统保存 YMM 寄存器（XCR0 的第 1、2 位）
+bool CpuSupportsAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+}  // namespace
+
+SimdLevel DetectSimdLevel() {
+#if defined(CAPTURE_CORE_X86)
+    if (internal::Avx2PixelKernels() != nullptr && CpuSupportsAvx2()) {
+        return SimdLevel::kAvx2;
+    }
+    if (internal::Sse2PixelKernels() != nullptr) {
+        return SimdLevel::kSse2;
+    }
+#endif
+    if (internal::NeonPixelKernels() != nullptr) {
+        return SimdLevel::kNeon;
+    }
+    return SimdLevel::kScalar;
+}
+
+const PixelKernels* GetPixelKernels(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kScalar:
+            return &kScalarKernels;
+        case SimdLevel::kSse2:
+            return internal::Sse2PixelKernels();
+        case SimdLevel::kAvx2:
+#if defined(CAPTURE_CORE_X86)
+            return CpuSupportsAvx2() ? internal::Avx2PixelKernels() : nullptr;
+#else
+            return nullptr;
+#endif
+        case SimdLevel::kNeon:
+            return internal::NeonPixelKernels();
+    }
+    return nullptr;
+}
+
+const PixelKernels& ActivePixelKernels() {
+    static const PixelKernels* kernels = GetPixelKernels(DetectSimdLevel());
+    return *kernels;
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::kScalar: return "scalar";
+        case SimdLevel::kSse2: return "sse2";
+        case SimdLevel::kAvx2: return "avx2";
+        case SimdLevel::kNeon: return "neon";
+    }
+    return "unknown";
+}
+
+void CopyRows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+              size_t row_bytes, int rows, bool flip_vertical) {
+    if (!flip_vertical && src_stride == row_bytes && dst_stride == row_bytes) {
+        std::memcpy(dst, src, row_bytes * rows);
+        return;
+    }
+    for (int y = 0; y < rows; y++) {
+        int src_row = flip_vertical ? rows - 1 - y : y;
+        std::memcpy(dst + dst_stride * y, src + src_stride * src_row, row_bytes);
+    }
+}
+
+void ConvertFrame(const FrameBuffer& src, PixelFormat dst_format, FrameBuffer* dst) {
+    if (src.empty()) {
+        dst->Reset();
+        return;
+    }
+    dst->Allocate(src.width(), src.height(), dst_format);
+
+    const PixelFormat src_format = src.format();
+    const bool src_rgb_order = src_format == PixelFormat::kRgba8;
+    const bool dst_rgb_order = dst_format == PixelFormat::kRgba8;
+    // 来源 alpha 未定义、目标需要 alpha 时置为不透明
+    const bool force_opaque = src_format == PixelFormat::kBgrx8 && dst_format != PixelFormat::kBgrx8;
+    const size_t pixels = static_cast<size_t>(src.width());
+    const PixelKernels& kernels = ActivePixelKernels();
+
+    if (src_rgb_order == dst_rgb_order) {
+        CopyRows(src.data(), src.stride(), dst->data(), dst->stride(), pixels * 4,
+                 src.height(), false);
+        if (force_opaque) {
+            kernels.force_opaque(dst->data(), pixels * src.height());
+        }
+        return;
+    }
+    for (int y = 0; y < src.height(); y++) {
+        if (force_opaque) {
+            kernels.swap_red_blue_opaque(src.row(y), dst->row(y), pixels);
+        } else {
+            kernels.swap_red_blue(src.row(y), dst->row(y), pixels);
+        }
+    }
+}
+
+void ConvertFramePreview(const FrameBuffer& src, int max_dimension, FrameBuffer* dst) {
+    const int longest = std::max(src.width(), src.height());
+    if (src.empty() || max_dimension <= 0 || longest <= max_dimension) {
+        ConvertFrame(src, PixelFormat::kRgba8, dst);
+        return;
+    }
+
+    const int step = (longest + max_dimension - 1) / max_dimension;
+    const int width = (src.width() + step - 1) / step;
+    const int height = (src.height() + step - 1) / step;
+    dst->Allocate(width, height, PixelFormat::kRgba8);
+
+    const PixelFormat src_format = src.format();
+    const PixelKernels& kernels = ActivePixelKernels();
+    for (int y = 0; y < height; y++) {
+        const uint8_t* in = src.row(y * step);
+        uint8_t* out = dst->row(y);
+        for (int x = 0; x < width; x++) {
+            std::memcpy(out + 4 * x, in + 4 * static_cast<size_t>(x) * step, 4);
+        }
+        // 抽样后的行原地转换通道顺序
+        if (src_format == PixelFormat::kBgrx8) {
+            kernels.swap_red_blue_opaque(out, out, width);
+        } else if (src_format == PixelFormat::kBgra8) {
+            kernels.swap_red_blue(out, out, width);
+        }
+    }
+}
+
+void DownscaleFrame(const FrameBuffer& src, int max_dimension, FrameBuffer* dst) {
+    const int longest = std::max(src.width(), src.height());
+    if (src.empty() || max_dimension <= 0 || longest <= max_dimension) {
+        dst->CopyFrom(src);
+        return;
+    }
+
+    const int width = std::max(
+        1, static_cast<int>(static_cast<int64_t>(src.width()) * max_dimension / longest));
+    const int height = std::max(
+        1, static_cast<int>(static_cast<int64_t>(src.height()) * max_dimension / longest));
+    dst->Allocate(width, height, src.format());
+
+    // 目标第 x 列覆盖源列 [columns[x], columns[x + 1])，行同理
+    std::vector<int> columns(static_cast<size_t>(width) + 1);
+    for (int x = 0; x <= width; x++) {
+        columns[x] = static_cast<int>(static_cast<int64_t>(x) * src.width() / width);
+    }
+    std::vector<uint64_t> sums(static_cast<size_t>(width) * 4);
+    for (int y = 0; y < height; y++) {
+        const int y0 = static_cast<int>(static_cast<int64_t>(y) * src.height() / height);
+        const int y1 = static_cast<int>(static_cast<int64_t>(y + 1) * src.height() / height);
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int sy = y0; sy < y1; sy++) {
+            const uint8_t* in = src.row(sy);
+            uint64_t* sum = sums.data();
+            for (int x = 0; x < width; x++, sum += 4) {
+                for (int sx = columns[x]; sx < columns[x + 1]; sx++) {
+                    const uint8_t* p = in + 4 * static_cast<size_t>(sx);
+                    sum[0] += p[0];
+                    sum[1] += p[1];
+                    sum[2] += p[2];
+                    sum[3] += p[3];
+                }
+            }
+        }
+        uint8_t* out = dst->row(y);
+        for (int x = 0; x < width; x++) {
+            const uint64_t count = static_cast<uint64_t>(y1 - y0) * (columns[x + 1] - columns[x]);
+            for (int c = 0; c < 4; c++) {
+                out[4 * x + c] = static_cast<uint8_t>((sums[4 * x + c] + count / 2) / count);
+            }
+        }
+    }
+}
+
+}  // namespace capture_core
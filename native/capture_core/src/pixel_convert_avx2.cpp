@@ -0,0 +1,129 @@
+// AVX2 内核：GCC / Clang 下这个文件单独以 -mavx2 编译（见 CMakeLists.txt），
+// 只在运行时检测到 AVX2 后才会被调用。
+#include "pixel_convert_internal.h"
+
+#if defined(__AVX2__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define CAPTURE_CORE_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace capture_core {
+namespace internal {
+
+#if defined(CAPTURE_CORE_HAS_AVX2_KERNELS)
+
+namespace {
+
+// 每 128 位通道内的字节重排表（两个通道相同）
+inline __m256i LaneShuffle(char b0, char b1, char b2, char b3, char b4, char b5, char b6,
+                           char b7, char b8, char b9, char b10, char b11, char b12,
+                           char b13, char b14, char b15) {
+    return _mm256_setr_epi8(b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12, b13, b14,
+                            b15, b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12, b13,
+                            b14, b15);
+}
+
+void SwapRedBlueAvx2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m256i shuffle = LaneShuffle(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4),
+                            _mm256_shuffle_epi8(v, shuffle));
+    }
+    SwapRedBlueScalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void SwapRedBlueOpaqueAvx2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m256i shuffle = LaneShuffle(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4),
+                            _mm256_or_si256(_mm256_shuffle_epi8(v, shuffle), alpha));
+    }
+    SwapRedBlueOpaqueScalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void ForceOpaqueAvx2(uint8_t* data, size_t pixels) {
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(data + i * 4);
+        _mm256_storeu_si256(p, _mm256_or_si256(_mm256_loadu_si256(p), alpha));
+    }
+    ForceOpaqueScalar(data + i * 4, pixels - i);
+}
+
+// 8 个 BGRX 像素 -> 24 字节 RGB：通道内先压到前 12 字节，再跨通道拼接
+void BgrxToRgbAvx2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m256i shuffle = LaneShuffle(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, shuffle), compact);
+        uint8_t* out = dst + i * 3;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(v));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out + 16), _mm256_extracti128_si256(v, 1));
+    }
+    BgrxToRgbScalar(src + i * 4, dst + i * 3, pixels - i);
+}
+
+// 8 个 BGR 像素（24 字节）-> 32 字节 BGRA。一次读取 32 字节，
+// 所以循环条件保证还剩至少 11 个像素（33 字节），不会越界读
+void Bgr24ToBgraAvx2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m256i spread = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+    const __m256i shuffle = LaneShuffle(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 11 <= pixels; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 3));
+        v = _mm256_shuffle_epi8(_mm256_permutevar8x32_epi32(v, spread), shuffle);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_or_si256(v, alpha));
+    }
+    Bgr24ToBgraScalar(src + i * 3, dst + i * 4, pixels - i);
+}
+
+// 8 条链正好是一个寄存器，每次处理 8 个像素
+uint64_t HashRowAvx2(const uint8_t* src, size_t pixels, uint32_t mask) {
+    const __m256i mask8 = _mm256_set1_epi32(static_cast<int>(mask));
+    const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(kRowHashMultiplier));
+    __m256i h = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        h = _mm256_mullo_epi32(_mm256_xor_si256(h, _mm256_and_si256(v, mask8)), multiplier);
+    }
+    uint32_t lanes[kRowHashLanes];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), h);
+    HashRowLanes(src + i * 4, pixels - i, mask, lanes);
+    return FinishRowHash(lanes, pixels);
+}
+
+const PixelKernels kAvx2Kernels = {
+    SwapRedBlueAvx2,
+    SwapRedBlueOpaqueAvx2,
+    ForceOpaqueAvx2,
+    BgrxToRgbAvx2,
+    Bgr24ToBgraAvx2,
+    HashRowAvx2,
+};
+
+}  // namespace
+
+const PixelKernels* Avx2PixelKernels() {
+    return &kAvx2Kernels;
+}
+
+#else
+
+const PixelKernels* Avx2PixelKernels() {
+    return nullptr;
+}
+
+#endif
+
+}  // namespace internal
+}  // namespace capture_core
@@ -0,0 +1,52 @@
+#ifndef CAPTURE_CORE_PIXEL_CONVERT_INTERNAL_H_
+#define CAPTURE_CORE_PIXEL_CONVERT_INTERNAL_H_
+
+#include "capture_core/pixel_convert.h"
+
+namespace capture_core {
+namespace internal {
+
+// 标量实现，SIMD 版本用它处理尾部像素和没有向量化的内核
+void SwapRedBlueScalar(const uint8_t* src, uint8_t* dst, size_t pixels);
+void SwapRedBlueOpaqueScalar(const uint8_t* src, uint8_t* dst, size_t pixels);
+void ForceOpaqueScalar(uint8_t* data, size_t pixels);
+void BgrxToRgbScalar(const uint8_t* src, uint8_t* dst, size_t pixels);
+void Bgr24ToBgraScalar(const uint8_t* src, uint8_t* dst, size_t pixels);
+uint64_t HashRowScalar(const uint8_t* src, size_t pixels, uint32_t mask);
+
+// 行哈希的 8 条乘法链：像素 i 进入第 i % 8 条，h = (h ^ (p & mask)) * kRowHashMultiplier
+constexpr size_t kRowHashLanes = 8;
+constexpr uint32_t kRowHashMultiplier = 0x9E3779B1u;
+
+// 从第 0 条链开始把 pixels 个像素并入 lanes（SIMD 版本处理尾部像素）
+inline void HashRowLanes(const uint8_t* src, size_t pixels, uint32_t mask,
+                         uint32_t lanes[kRowHashLanes]) {
+    for (size_t i = 0; i < pixels; i++, src += 4) {
+        const uint32_t p = static_cast<uint32_t>(src[0]) | static_cast<uint32_t>(src[1]) << 8 |
+                           static_cast<uint32_t>(src[2]) << 16 |
+                           static_cast<uint32_t>(src[3]) << 24;
+        uint32_t& h = lanes[i % kRowHashLanes];
+        h = (h ^ (p & mask)) * kRowHashMultiplier;
+    }
+}
+
+// 把 8 条链和像素数合成 64 位哈希
+inline uint64_t FinishRowHash(const uint32_t lanes[kRowHashLanes], size_t pixels) {
+    uint64_t hash = 0xCBF29CE484222325ull ^ pixels;
+    for (size_t i = 0; i < kRowHashLanes; i++) {
+        const uint32_t lane = lanes[i] ^ (lanes[i] >> 15);
+        hash = (hash ^ lane) * 0x100000001B3ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+// 各指令集的内核表；目标架构不匹配时返回 nullptr
+const PixelKernels* Sse2PixelKernels();
+const PixelKernels* Avx2PixelKernels();
+const PixelKernels* NeonPixelKernels();
+
+}  // namespace internal
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_PIXEL_CONVERT_INTERNAL_H_
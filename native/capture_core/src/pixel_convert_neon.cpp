@@ -0,0 +1,121 @@
+// NEON 内核：AArch64 上 NEON 总是可用，不需要运行时检测
+#include "pixel_convert_internal.h"
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CAPTURE_CORE_HAS_NEON_KERNELS 1
+#include <arm_neon.h>
+#endif
+
+namespace capture_core {
+namespace internal {
+
+#if defined(CAPTURE_CORE_HAS_NEON_KERNELS)
+
+namespace {
+
+void SwapRedBlueNeon(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16_t b = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = b;
+        vst4q_u8(dst + i * 4, v);
+    }
+    SwapRedBlueScalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void SwapRedBlueOpaqueNeon(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16_t b = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = b;
+        v.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(dst + i * 4, v);
+    }
+    SwapRedBlueOpaqueScalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void ForceOpaqueNeon(uint8_t* data, size_t pixels) {
+    const uint32x4_t alpha = vdupq_n_u32(0xFF000000u);
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        uint32_t* p = reinterpret_cast<uint32_t*>(data + i * 4);
+        vst1q_u32(p, vorrq_u32(vld1q_u32(p), alpha));
+    }
+    ForceOpaqueScalar(data + i * 4, pixels - i);
+}
+
+void BgrxToRgbNeon(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16x3_t rgb;
+        rgb.val[0] = v.val[2];
+        rgb.val[1] = v.val[1];
+        rgb.val[2] = v.val[0];
+        vst3q_u8(dst + i * 3, rgb);
+    }
+    BgrxToRgbScalar(src + i * 4, dst + i * 3, pixels - i);
+}
+
+void Bgr24ToBgraNeon(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        uint8x16x3_t bgr = vld3q_u8(src + i * 3);
+        uint8x16x4_t v;
+        v.val[0] = bgr.val[0];
+        v.val[1] = bgr.val[1];
+        v.val[2] = bgr.val[2];
+        v.val[3] = vdupq_n_u8(0xFF);
+        vst4q_u8(dst + i * 4, v);
+    }
+    Bgr24ToBgraScalar(src + i * 3, dst + i * 4, pixels - i);
+}
+
+// 8 条链分成两个寄存器，每次处理 8 个像素
+uint64_t HashRowNeon(const uint8_t* src, size_t pixels, uint32_t mask) {
+    const uint32x4_t mask4 = vdupq_n_u32(mask);
+    uint32x4_t low = vdupq_n_u32(0);
+    uint32x4_t high = vdupq_n_u32(0);
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        const uint32_t* p = reinterpret_cast<const uint32_t*>(src + i * 4);
+        low = vmulq_n_u32(veorq_u32(low, vandq_u32(vld1q_u32(p), mask4)), kRowHashMultiplier);
+        high = vmulq_n_u32(veorq_u32(high, vandq_u32(vld1q_u32(p + 4), mask4)),
+                           kRowHashMultiplier);
+    }
+    uint32_t lanes[kRowHashLanes];
+    vst1q_u32(lanes, low);
+    vst1q_u32(lanes + 4, high);
+    HashRowLanes(src + i * 4, pixels - i, mask, lanes);
+    return FinishRowHash(lanes, pixels);
+}
+
+const PixelKernels kNeonKernels = {
+    SwapRedBlueNeon,
+    SwapRedBlueOpaqueNeon,
+    ForceOpaqueNeon,
+    BgrxToRgbNeon,
+    Bgr24ToBgraNeon,
+    HashRowNeon,
+};
+
+}  // namespace
+
+const PixelKernels* NeonPixelKernels() {
+    return &kNeonKernels;
+}
+
+#else
+
+const PixelKernels* NeonPixelKernels() {
+    return nullptr;
+}
+
+#endif
+
+}  // namespace internal
+}  // namespace capture_core
@@ -0,0 +1,109 @@
+// SSE2 内核：x86 / x86-64 的基线指令集，不需要单独的编译选项。
+// SSE2 没有字节重排指令（pshufb），打包/展开 24 位的内核沿用标量实现。
+#include "pixel_convert_internal.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CAPTURE_CORE_HAS_SSE2_KERNELS 1
+#include <emmintrin.h>
+#endif
+
+namespace capture_core {
+namespace internal {
+
+#if defined(CAPTURE_CORE_HAS_SSE2_KERNELS)
+
+namespace {
+
+// 每个 32 位像素 [B G R A]：保留 G、A，把 B、R 所在的 16 位字对调
+inline __m128i SwapRedBlue4(__m128i v) {
+    const __m128i ga_mask = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+    __m128i ga = _mm_and_si128(v, ga_mask);
+    __m128i rb = _mm_andnot_si128(ga_mask, v);
+    rb = _mm_shufflelo_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1));
+    rb = _mm_shufflehi_epi16(rb, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(ga, rb);
+}
+
+void SwapRedBlueSse2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), SwapRedBlue4(v));
+    }
+    SwapRedBlueScalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void SwapRedBlueOpaqueSse2(const uint8_t* src, uint8_t* dst, size_t pixels) {
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4),
+                         _mm_or_si128(SwapRedBlue4(v), alpha));
+    }
+    SwapRedBlueOpaqueScalar(src + i * 4, dst + i * 4, pixels - i);
+}
+
+void ForceOpaqueSse2(uint8_t* data, size_t pixels) {
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+    size_t i = 0;
+    for (; i + 4 <= pixels; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(data + i * 4);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_loadu_si128(p), alpha));
+    }
+    ForceOpaqueScalar(data + i * 4, pixels - i);
+}
+
+// SSE2 没有 32 位低位乘法（pmulld 是 SSE4.1），用两次 pmuludq 拼出来
+inline __m128i MulLo32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// 8 条链分成两个寄存器，每次处理 8 个像素
+uint64_t HashRowSse2(const uint8_t* src, size_t pixels, uint32_t mask) {
+    const __m128i mask4 = _mm_set1_epi32(static_cast<int>(mask));
+    const __m128i multiplier = _mm_set1_epi32(static_cast<int>(kRowHashMultiplier));
+    __m128i low = _mm_setzero_si128();
+    __m128i high = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i * 4);
+        low = MulLo32(_mm_xor_si128(low, _mm_and_si128(_mm_loadu_si128(p), mask4)), multiplier);
+        high = MulLo32(_mm_xor_si128(high, _mm_and_si128(_mm_loadu_si128(p + 1), mask4)),
+                       multiplier);
+    }
+    uint32_t lanes[kRowHashLanes];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes + 4), high);
+    HashRowLanes(src + i * 4, pixels - i, mask, lanes);
+    return FinishRowHash(lanes, pixels);
+}
+
+const PixelKernels kSse2Kernels = {
+    SwapRedBlueSse2,
+    SwapRedBlueOpaqueSse2,
+    ForceOpaqueSse2,
+    BgrxToRgbScalar,
+    Bgr24ToBgraScalar,
+    HashRowSse2,
+};
+
+}  // namespace
+
+const PixelKernels* Sse2PixelKernels() {
+    return &kSse2Kernels;
+}
+
+#else
+
+const PixelKernels* Sse2PixelKernels() {
+    return nullptr;
+}
+
+#endif
+
+}  // namespace internal
+}  // namespace capture_core
@@ -0,0 +1,556 @@
+#include "capture_core/png_encoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#include <zlib.h>
+
+#include "capture_core/pixel_convert.h"
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+namespace {
+
+const uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+void AppendU32(std::vector<uint8_t>* out, uint32_t value) {
+    out->push_back(static_cast<uint8_t>(value >> 24));
+    out->push_back(static_cast<uint8_t>(value >> 16));
+    out->push_back(static_cast<uint8_t>(value >> 8));
+    out->push_back(static_cast<uint8_t>(value));
+}
+
+// 写入块头，返回类型字段的位置；块数据直接追加到 out 后调用 EndChunk
+size_t BeginChunk(std::vector<uint8_t>* out, const char type[4]) {
+    AppendU32(out, 0);
+    size_t type_pos = out->size();
+    out->insert(out->end(), type, type + 4);
+    return type_pos;
+}
+
+// 回填长度并追加 CRC
+void EndChunk(std::vector<uint8_t>* out, size_t type_pos) {
+    size_t length = out->size() - type_pos - 4;
+    uint8_t* length_field = out->data() + type_pos - 4;
+    length_field[0] = static_cast<uint8_t>(length >> 24);
+    length_field[1] = static_cast<uint8_t>(length >> 16);
+    length_field[2] = static_cast<uint8_t>(length >> 8);
+    length_field[3] = static_cast<uint8_t>(length);
+    uLong crc = crc32(0L, out->data() + type_pos, static_cast<uInt>(length + 4));
+    AppendU32(out, static_cast<uint32_t>(crc));
+}
+
+void AppendChunk(std::vector<uint8_t>* out, const char type[4],
+                 const uint8_t* data, size_t length) {
+    size_t type_pos = BeginChunk(out, type);
+    if (length > 0) {
+        out->insert(out->end(), data, data + length);
+    }
+    EndChunk(out, type_pos);
+}
+
+// 把一行像素转换成 PNG 的 RGB / RGBA 字节序
+void ConvertRow(const uint8_t* src, int width, PixelFormat format, uint8_t* dst) {
+    switch (format) {
+        case PixelFormat::kBgrx8:
+            BgrxToRgb(src, dst, static_cast<size_t>(width));
+            break;
+        case PixelFormat::kBgra8:
+            SwapRedBlue(src, dst, static_cast<size_t>(width));
+            break;
+        case PixelFormat::kRgba8:
+            std::memcpy(dst, src, static_cast<size_t>(width) * 4);
+            break;
+    }
+}
+
+inline uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+// 对一行应用指定过滤器，返回过滤结果的“绝对值和”（用于启发式选择）
+uint64_t FilterRow(int filter, const uint8_t* cur, const uint8_t* prev,
+                   size_t length, int bpp, uint8_t* out) {
+    uint64_t cost = 0;
+    for (size_t i = 0; i < length; i++) {
+        uint8_t a = i >= static_cast<size_t>(bpp) ? cur[i - bpp] : 0;
+        uint8_t b = prev ? prev[i] : 0;
+        uint8_t c = (prev && i >= static_cast<size_t>(bpp)) ? prev[i - bpp] : 0;
+        uint8_t v;
+        switch (filter) {
+            case 1: v = static_cast<uint8_t>(cur[i] - a); break;
+            case 2: v = static_cast<uint8_t>(cur[i] - b); break;
+            case 3: v = static_cast<uint8_t>(cur[i] - ((a + b) >> 1)); break;
+            case 4: v = static_cast<uint8_t>(cur[i] - Paeth(a, b, c)); break;
+            default: v = cur[i]; break;
+        }
+        out[i] = v;
+        cost += v < 128 ? v : 256 - v;
+    }
+    return cost;
+}
+
+// 过滤一行：level 0 不过滤，1 只用 Up，2-3 在 None/Sub/Up 中选，4+ 尝试全部五种
+void FilterBestRow(int level, const uint8_t* cur, const uint8_t* prev, size_t row_bytes,
+                   int bpp, uint8_t* dst, uint8_t* candidate) {
+    if (level <= 0) {
+        dst[0] = 0;
+        std::memcpy(dst + 1, cur, row_bytes);
+        return;
+    }
+    if (level == 1) {
+        dst[0] = 2;
+        FilterRow(2, cur, prev, row_bytes, bpp, dst + 1);
+        return;
+    }
+    const int last_filter = level <= 3 ? 2 : 4;
+    int best_filter = 0;
+    uint64_t best_cost = FilterRow(0, cur, prev, row_bytes, bpp, dst + 1);
+    for (int filter = 1; filter <= last_filter; filter++) {
+        uint64_t cost = FilterRow(filter, cur, prev, row_bytes, bpp, candidate);
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_filter = filter;
+            std::memcpy(dst + 1, candidate, row_bytes);
+        }
+    }
+    dst[0] = static_cast<uint8_t>(best_filter);
+}
+
+const size_t kDeflateWindow = 32768;
+
+// 自动划分时每个条带至少的字节数，太小的条带字典开销和同步块会拖累压缩率
+const size_t kMinBandBytes = 256 * 1024;
+
+// 一个条带的编码状态，z_stream 在多次编码之间复用（deflateReset）
+struct DeflateBand {
+    int first_row = 0;
+    int row_count = 0;
+    z_stream stream;
+    bool stream_ready = false;
+    int stream_level = -1;
+    std::vector<uint8_t> deflated;
+    // 过滤阶段的三行暂存（当前行、上一行、候选过滤结果）和条带之前的一行
+    std::vector<uint8_t> rows;
+    std::vector<uint8_t> previous;
+    uLong adler = 1;
+    bool ok = false;
+
+    ~DeflateBand() {
+        if (stream_ready) {
+            deflateEnd(&stream);
+        }
+    }
+
+    bool ResetStream(int level) {
+        if (stream_ready && stream_level == level) {
+            return deflateReset(&stream) == Z_OK;
+        }
+        if (stream_ready) {
+            deflateEnd(&stream);
+            stream_ready = false;
+        }
+        std::memset(&stream, 0, sizeof(stream));
+        // 负的 windowBits 表示原始 deflate：zlib 头和 Adler-32 由拼接阶段统一写
+        if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8,
+                         level == 0 ? Z_DEFAULT_STRATEGY : Z_FILTERED) != Z_OK) {
+            return false;
+        }
+        stream_ready = true;
+        stream_level = level;
+        return true;
+    }
+
+    // 过滤 frame 中本条带的行，写到 filtered（每行 row_bytes + 1 字节）。
+    // previous 为条带第一行的上一行（已转换成 PNG 字节序），没有时为 nullptr
+    void Filter(const FrameBuffer& frame, const uint8_t* previous, int level, int bpp,
+                uint8_t* filtered) {
+        const size_t row_bytes = static_cast<size_t>(frame.width()) * bpp;
+        rows.resize(row_bytes * 3);
+        uint8_t* cur = rows.data();
+        uint8_t* spare = rows.data() + row_bytes;
+        uint8_t* candidate = rows.data() + row_bytes * 2;
+        const uint8_t* prev = previous;
+        for (int y = first_row; y < first_row + row_count; y++) {
+            ConvertRow(frame.row(y), frame.width(), frame.format(), cur);
+            FilterBestRow(level, cur, prev, row_bytes, bpp,
+                          filtered + (row_bytes + 1) * (y - first_row), candidate);
+            // 交换当前行和上一行缓冲
+            prev = cur;
+            std::swap(cur, spare);
+        }
+    }
+
+    // deflate input 的 length 字节，之前的 dict 字节（紧挨在 input 前面）作为预设字典；
+    // last 为 true 时以 Z_FINISH 结束，否则以 Z_SYNC_FLUSH 结束在字节边界上
+    bool Deflate(int level, const uint8_t* input, size_t length, size_t dict, bool last) {
+        ok = false;
+        if (!ResetStream(level)) {
+            return false;
+        }
+        if (dict > 0 &&
+            deflateSetDictionary(&stream, input - dict, static_cast<uInt>(dict)) != Z_OK) {
+            return false;
+        }
+        deflated.resize(deflateBound(&stream, static_cast<uLong>(length)) + 16);
+        stream.next_in = const_cast<Bytef*>(input);
+        stream.avail_in = static_cast<uInt>(length);
+        stream.next_out = deflated.data();
+        stream.avail_out = static_cast<uInt>(deflated.size());
+        int ret = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+        if (ret != (last ? Z_STREAM_END : Z_OK) || stream.avail_in != 0) {
+            return false;
+        }
+        deflated.resize(deflated.size() - stream.avail_out);
+        adler = adler32(1L, input, static_cast<uInt>(length));
+        ok = true;
+        return true;
+    }
+};
+
+// IHDR 的 13 字节数据
+void WriteHeader(int width, int height, bool has_alpha, uint8_t ihdr[13]) {
+    ihdr[0] = static_cast<uint8_t>(width >> 24);
+    ihdr[1] = static_cast<uint8_t>(width >> 16);
+    ihdr[2] = static_cast<uint8_t>(width >> 8);
+    ihdr[3] = static_cast<uint8_t>(width);
+    ihdr[4] = static_cast<uint8_t>(height >> 24);
+    ihdr[5] = static_cast<uint8_t>(height >> 16);
+    ihdr[6] = static_cast<uint8_t>(height >> 8);
+    ihdr[7] = static_cast<uint8_t>(height);
+    ihdr[8] = 8;                      // 位深
+    ihdr[9] = has_alpha ? 6 : 2;      // 颜色类型：RGBA / RGB
+    ihdr[10] = 0;                     // 压缩方法
+    ihdr[11] = 0;                     // 过滤方法
+    ihdr[12] = 0;                     // 不隔行
+}
+
+// zlib 头：CM=8、32KB 窗口，FLEVEL 按压缩级别，FCHECK 使头部是 31 的倍数
+void ZlibHeader(int level, uint8_t header[2]) {
+    const uint8_t cmf = 0x78;
+    const int flevel = level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3));
+    uint8_t flg = static_cast<uint8_t>(flevel << 6);
+    flg = static_cast<uint8_t>(flg + 31 - (cmf * 256 + flg) % 31);
+    header[0] = cmf;
+    header[1] = flg;
+}
+
+// 划分条带的行数：默认每个线程（含调用线程）两个，便于负载均衡
+int AutoBandRows(int band_rows, int height, size_t filtered_row, ThreadPool* pool) {
+    if (band_rows > 0) {
+        return band_rows;
+    }
+    int target_bands = (pool->num_threads() + 1) * 2;
+    band_rows = (height + target_bands - 1) / target_bands;
+    int min_rows = static_cast<int>((kMinBandBytes + filtered_row - 1) / filtered_row);
+    return std::max(band_rows, min_rows);
+}
+
+}  // namespace
+
+struct PngEncoder::Band : DeflateBand {};
+
+PngEncoderOptions PngEncoderOptions::ForEffort(PngEffort effort) {
+    PngEncoderOptions options;
+    switch (effort) {
+        case PngEffort::kFastest: options.compression_level = 1; break;
+        case PngEffort::kFast: options.compression_level = 3; break;
+        case PngEffort::kDefault: options.compression_level = 6; break;
+        case PngEffort::kBest: options.compression_level = 9; break;
+    }
+    return options;
+}
+
+PngEncoder::PngEncoder() : PngEncoder(PngEncoderOptions()) {}
+
+PngEncoder::PngEncoder(const PngEncoderOptions& options) : options_(options) {}
+
+PngEncoder::~PngEncoder() = default;
+
+bool PngEncoder::Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) {
+    if (frame.empty() || out == nullptr) {
+        return false;
+    }
+
+    const int width = frame.width();
+    const int height = frame.height();
+    const bool has_alpha = frame.format() != PixelFormat::kBgrx8;
+    const int bpp = has_alpha ? 4 : 3;
+    const size_t row_bytes = static_cast<size_t>(width) * bpp;
+    const size_t filtered_row = row_bytes + 1;
+    const int level = std::min(9, std::max(0, options_.compression_level));
+    ThreadPool* pool = options_.pool ? options_.pool : ThreadPool::Shared();
+
+    const int band_rows = AutoBandRows(options_.band_rows, height, filtered_row, pool);
+    const int band_count = (height + band_rows - 1) / band_rows;
+    while (static_cast<int>(bands_.size()) < band_count) {
+        bands_.emplace_back(new Band());
+    }
+    for (int i = 0; i < band_count; i++) {
+        bands_[i]->first_row = i * band_rows;
+        bands_[i]->row_count = std::min(band_rows, height - i * band_rows);
+    }
+    last_band_count_ = band_count;
+
+    // 第一阶段：并行过滤。条带首行的 Up/Avg/Paeth 需要上一条带的最后一行，
+    // 这里重新转换一次该行，不依赖其他条带的结果。
+    filtered_.resize(filtered_row * height);
+    pool->ParallelFor(band_count, [&](int index) {
+        Band& band = *bands_[index];
+        uint8_t* previous = nullptr;
+        if (band.first_row > 0) {
+            band.previous.resize(row_bytes);
+            ConvertRow(frame.row(band.first_row - 1), width, frame.format(),
+                       band.previous.data());
+            previous = band.previous.data();
+        }
+        band.Filter(frame, previous, level, bpp, filtered_.data() + filtered_row * band.first_row);
+    });
+
+    // 第二阶段：并行 deflate。前一条带末尾 32KB 作为预设字典，
+    // 非末尾条带以 Z_SYNC_FLUSH 结束（字节对齐、不设 BFINAL），可直接拼接。
+    pool->ParallelFor(band_count, [&](int index) {
+        Band& band = *bands_[index];
+        const size_t offset = filtered_row * band.first_row;
+        band.Deflate(level, filtered_.data() + offset, filtered_row * band.row_count,
+                     std::min(offset, kDeflateWindow), index == band_count - 1);
+    });
+
+    size_t total = 0;
+    uLong adler = 1;
+    for (int i = 0; i < band_count; i++) {
+        const Band& band = *bands_[i];
+        if (!band.ok) {
+            return false;
+        }
+        total += band.deflated.size();
+        adler = i == 0 ? band.adler
+                       : adler32_combine(adler, band.adler,
+                                         static_cast<z_off_t>(filtered_row * band.row_count));
+    }
+
+    out->clear();
+    out->reserve(total + band_count * 12 + 64);
+    out->insert(out->end(), kPngSignature, kPngSignature + 8);
+
+    uint8_t ihdr[13];
+    WriteHeader(width, height, has_alpha, ihdr);
+    AppendChunk(out, "IHDR", ihdr, sizeof(ihdr));
+
+    uint8_t zlib_header[2];
+    ZlibHeader(level, zlib_header);
+    for (int i = 0; i < band_count; i++) {
+        const Band& band = *bands_[i];
+        size_t type_pos = BeginChunk(out, "IDAT");
+        if (i == 0) {
+            out->insert(out->end(), zlib_header, zlib_header + 2);
+        }
+        out->insert(out->end(), band.deflated.begin(), band.deflated.end());
+        if (i == band_count - 1) {
+            AppendU32(out, static_cast<uint32_t>(adler));
+        }
+        EndChunk(out, type_pos);
+    }
+    AppendChunk(out, "IEND", nullptr, 0);
+    return true;
+}
+
+struct PngStreamWriter::Band : DeflateBand {};
+
+PngStreamWriter::PngStreamWriter() : PngStreamWriter(PngEncoderOptions()) {}
+
+PngStreamWriter::PngStreamWriter(const PngEncoderOptions& options) : options_(options) {}
+
+PngStreamWriter::~PngStreamWriter() {
+    if (out_.is_open()) {
+        Abort();
+    }
+}
+
+bool PngStreamWriter::Open(const std::string& path) {
+    if (out_.is_open() || path.empty()) {
+        return false;
+    }
+    out_.open(std::filesystem::u8path(path), std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        return false;
+    }
+    path_ = path;
+    width_ = 0;
+    height_ = 0;
+    failed_ = false;
+    bytes_written_ = 0;
+    adler_ = 1;
+    last_row_.clear();
+    dict_bytes_ = 0;
+    return true;
+}
+
+bool PngStreamWriter::AddRows(const FrameBuffer& rows) {
+    if (!out_.is_open() || failed_ || rows.empty()) {
+        return false;
+    }
+    const bool has_alpha = rows.format() != PixelFormat::kBgrx8;
+    const int bpp = has_alpha ? 4 : 3;
+    const int level = std::min(9, std::max(0, options_.compression_level));
+    if (height_ == 0) {
+        // 第一段：写文件头，高度先写 0
+        width_ = rows.width();
+        format_ = rows.format();
+        chunk_.clear();
+        chunk_.insert(chunk_.end(), kPngSignature, kPngSignature + 8);
+        uint8_t ihdr[13];
+        WriteHeader(width_, 0, has_alpha, ihdr);
+        AppendChunk(&chunk_, "IHDR", ihdr, sizeof(ihdr));
+        if (!Write(chunk_)) {
+            failed_ = true;
+            return false;
+        }
+    } else if (rows.width() != width_ || rows.format() != format_) {
+        return false;
+    }
+
+    const size_t row_bytes = static_cast<size_t>(width_) * bpp;
+    const size_t filtered_row = row_bytes + 1;
+    const int count = rows.height();
+    ThreadPool* pool = options_.pool ? options_.pool : ThreadPool::Shared();
+    const int band_rows = AutoBandRows(options_.band_rows, count, filtered_row, pool);
+    const int band_count = (count + band_rows - 1) / band_rows;
+    while (static_cast<int>(bands_.size()) < band_count) {
+        bands_.emplace_back(new Band());
+    }
+    for (int i = 0; i < band_count; i++) {
+        bands_[i]->first_row = i * band_rows;
+        bands_[i]->row_count = std::min(band_rows, count - i * band_rows);
+    }
+
+    // 过滤：第一个条带的参考行是上一段的最后一行
+    filtered_.resize(dict_bytes_ + filtered_row * count);
+    uint8_t* filtered = filtered_.data() + dict_bytes_;
+    pool->ParallelFor(band_count, [&](int index) {
+        Band& band = *bands_[index];
+        const uint8_t* previous = last_row_.empty() ? nullptr : last_row_.data();
+        if (band.first_row > 0) {
+            band.previous.resize(row_bytes);
+            ConvertRow(rows.row(band.first_row - 1), width_, format_, band.previous.data());
+            previous = band.previous.data();
+        }
+        band.Filter(rows, previous, level, bpp, filtered + filtered_row * band.first_row);
+    });
+
+    // deflate：每个条带以之前的 32KB（可能来自上一段）作为字典，都以 Z_SYNC_FLUSH 结束
+    pool->ParallelFor(band_count, [&](int index) {
+        Band& band = *bands_[index];
+        const size_t offset = dict_bytes_ + filtered_row * band.first_row;
+        band.Deflate(level, filtered_.data() + offset, filtered_row * band.row_count,
+                     std::min(offset, kDeflateWindow), false);
+    });
+
+    for (int i = 0; i < band_count; i++) {
+        const Band& band = *bands_[i];
+        if (!band.ok) {
+            failed_ = true;
+            return false;
+        }
+        chunk_.clear();
+        size_t type_pos = BeginChunk(&chunk_, "IDAT");
+        if (height_ == 0 && i == 0) {
+            uint8_t zlib_header[2];
+            ZlibHeader(level, zlib_header);
+            chunk_.insert(chunk_.end(), zlib_header, zlib_header + 2);
+        }
+        chunk_.insert(chunk_.end(), band.deflated.begin(), band.deflated.end());
+        EndChunk(&chunk_, type_pos);
+        if (!Write(chunk_)) {
+            failed_ = true;
+            return false;
+        }
+        adler_ = static_cast<uint32_t>(adler32_combine(
+            adler_, band.adler, static_cast<z_off_t>(filtered_row * band.row_count)));
+    }
+
+    // 留下最后一行和流末尾的字典给下一段
+    last_row_.resize(row_bytes);
+    ConvertRow(rows.row(count - 1), width_, format_, last_row_.data());
+    const size_t total = filtered_.size();
+    const size_t keep = std::min(total, kDeflateWindow);
+    std::memmove(filtered_.data(), filtered_.data() + total - keep, keep);
+    dict_bytes_ = keep;
+    height_ += count;
+    return true;
+}
+
+bool PngStreamWriter::Finish() {
+    if (!out_.is_open()) {
+        return false;
+    }
+    bool ok = !failed_ && height_ > 0;
+    if (ok) {
+        // 空的最后一个块（BFINAL）和 Adler-32 结束 zlib 流
+        if (bands_.empty()) {
+            bands_.emplace_back(new Band());
+        }
+        Band& band = *bands_[0];
+        const int level = std::min(9, std::max(0, options_.compression_level));
+        ok = band.Deflate(level, filtered_.data() + dict_bytes_, 0, 0, true);
+        if (ok) {
+            chunk_.clear();
+            size_t type_pos = BeginChunk(&chunk_, "IDAT");
+            chunk_.insert(chunk_.end(), band.deflated.begin(), band.deflated.end());
+            AppendU32(&chunk_, adler_);
+            EndChunk(&chunk_, type_pos);
+            AppendChunk(&chunk_, "IEND", nullptr, 0);
+            ok = Write(chunk_);
+        }
+    }
+    if (ok) {
+        // 回填 IHDR（签名 8 字节 + 长度 4 字节之后）
+        chunk_.clear();
+        uint8_t ihdr[13];
+        WriteHeader(width_, height_, format_ != PixelFormat::kBgrx8, ihdr);
+        AppendChunk(&chunk_, "IHDR", ihdr, sizeof(ihdr));
+        out_.seekp(8);
+        out_.write(reinterpret_cast<const char*>(chunk_.data()),
+                   static_cast<std::streamsize>(chunk_.size()));
+        ok = static_cast<bool>(out_);
+    }
+    out_.close();
+    ok = ok && !out_.fail();
+    if (!ok) {
+        std::error_code error;
+        std::filesystem::remove(std::filesystem::u8path(path_), error);
+    }
+    return ok;
+}
+
+void PngStreamWriter::Abort() {
+    if (!out_.is_open()) {
+        return;
+    }
+    out_.close();
+    std::error_code error;
+    std::filesystem::remove(std::filesystem::u8path(path_), error);
+}
+
+bool PngStreamWriter::Write(const std::vector<uint8_t>& bytes) {
+    out_.write(reinterpret_cast<const char*>(bytes.data()),
+               static_cast<std::streamsize>(bytes.size()));
+    if (!out_) {
+        return false;
+    }
+    bytes_written_ += bytes.size();
+    return true;
+}
+
+}  // namespace capture_core
@@ -0,0 +1,223 @@
+#include "capture_core/qoi_codec.h"
+
+#include <cstring>
+
+namespace capture_core {
+
+namespace {
+
+constexpr uint8_t kOpIndex = 0x00;
+constexpr uint8_t kOpDiff = 0x40;
+constexpr uint8_t kOpLuma = 0x80;
+constexpr uint8_t kOpRun = 0xC0;
+constexpr uint8_t kOpRgb = 0xFE;
+constexpr uint8_t kOpRgba = 0xFF;
+constexpr uint8_t kMask2 = 0xC0;
+
+constexpr size_t kHeaderSize = 14;
+constexpr uint8_t kPadding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+// 与参考实现相同的像素数上限，防止恶意头部导致巨大分配
+constexpr uint64_t kMaxPixels = 400000000;
+
+struct Rgba {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    uint8_t a;
+};
+
+inline uint32_t Pack(const Rgba& px) {
+    uint32_t v;
+    std::memcpy(&v, &px, sizeof(v));
+    return v;
+}
+
+inline int Hash(const Rgba& px) {
+    return (px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11) & 63;
+}
+
+inline void WriteBe32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v >> 24);
+    p[1] = static_cast<uint8_t>(v >> 16);
+    p[2] = static_cast<uint8_t>(v >> 8);
+    p[3] = static_cast<uint8_t>(v);
+}
+
+inline uint32_t ReadBe32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+}  // namespace
+
+bool QoiEncoder::Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) {
+    if (frame.empty()) {
+        return false;
+    }
+    const int width = frame.width();
+    const int height = frame.height();
+    const bool bgr = frame.format() != PixelFormat::kRgba8;
+    const bool has_alpha = frame.format() != PixelFormat::kBgrx8;
+    const int channels = has_alpha ? 4 : 3;
+
+    // 最坏情况每像素 channels + 1 字节；先按上限分配，结束时截断
+    const size_t max_size = kHeaderSize +
+                            static_cast<size_t>(width) * height * (channels + 1) +
+                            sizeof(kPadding);
+    out->resize(max_size);
+    uint8_t* bytes = out->data();
+    size_t p = 0;
+
+    std::memcpy(bytes, "qoif", 4);
+    WriteBe32(bytes + 4, static_cast<uint32_t>(width));
+    WriteBe32(bytes + 8, static_cast<uint32_t>(height));
+    bytes[12] = static_cast<uint8_t>(channels);
+    bytes[13] = 0;  // sRGB，线性 alpha
+    p = kHeaderSize;
+
+    Rgba index[64];
+    std::memset(index, 0, sizeof(index));
+    Rgba prev = {0, 0, 0, 255};
+    int run = 0;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t* src = frame.row(y);
+        const bool last_row = y == height - 1;
+        for (int x = 0; x < width; x++, src += 4) {
+            Rgba px;
+            px.r = bgr ? src[2] : src[0];
+            px.g = src[1];
+            px.b = bgr ? src[0] : src[2];
+            px.a = has_alpha ? src[3] : 255;
+
+            if (Pack(px) == Pack(prev)) {
+                run++;
+                // 行程跨行延续，只在满 62 或到达最后一个像素时写出
+                if (run == 62 || (last_row && x == width - 1)) {
+                    bytes[p++] = static_cast<uint8_t>(kOpRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                bytes[p++] = static_cast<uint8_t>(kOpRun | (run - 1));
+                run = 0;
+            }
+
+            const int hash = Hash(px);
+            if (Pack(index[hash]) == Pack(px)) {
+                bytes[p++] = static_cast<uint8_t>(kOpIndex | hash);
+            } else {
+                index[hash] = px;
+                if (px.a == prev.a) {
+                    // 差值按 8 位回绕计算
+                    const int8_t dr = static_cast<int8_t>(px.r - prev.r);
+                    const int8_t dg = static_cast<int8_t>(px.g - prev.g);
+                    const int8_t db = static_cast<int8_t>(px.b - prev.b);
+                    const int8_t dr_dg = static_cast<int8_t>(dr - dg);
+                    const int8_t db_dg = static_cast<int8_t>(db - dg);
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                        bytes[p++] = static_cast<uint8_t>(kOpDiff | (dr + 2) << 4 |
+                                                          (dg + 2) << 2 | (db + 2));
+                    } else if (dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 &&
+                               db_dg > -9 && db_dg < 8) {
+                        bytes[p++] = static_cast<uint8_t>(kOpLuma | (dg + 32));
+                        bytes[p++] = static_cast<uint8_t>((dr_dg + 8) << 4 | (db_dg + 8));
+                    } else {
+                        bytes[p++] = kOpRgb;
+                        bytes[p++] = px.r;
+                        bytes[p++] = px.g;
+                        bytes[p++] = px.b;
+                    }
+                } else {
+                    bytes[p++] = kOpRgba;
+                    bytes[p++] = px.r;
+                    bytes[p++] = px.g;
+                    bytes[p++] = px.b;
+                    bytes[p++] = px.a;
+                }
+            }
+            prev = px;
+        }
+    }
+
+    std::memcpy(bytes + p, kPadding, sizeof(kPadding));
+    p += sizeof(kPadding);
+    out->resize(p);
+    return true;
+}
+
+bool DecodeQoi(const uint8_t* data, size_t size, FrameBuffer* frame) {
+    if (size < kHeaderSize + sizeof(kPadding) || std::memcmp(data, "qoif", 4) != 0) {
+        return false;
+    }
+    const uint32_t width = ReadBe32(data + 4);
+    const uint32_t height = ReadBe32(data + 8);
+    const uint8_t channels = data[12];
+    if (width == 0 || height == 0 || width > 0x7FFFFFFF / 4 || height > 0x7FFFFFFF ||
+        static_cast<uint64_t>(width) * height > kMaxPixels ||
+        (channels != 3 && channels != 4)) {
+        return false;
+    }
+
+    frame->Allocate(static_cast<int>(width), static_cast<int>(height), PixelFormat::kRgba8);
+
+    Rgba index[64];
+    std::memset(index, 0, sizeof(index));
+    Rgba px = {0, 0, 0, 255};
+    int run = 0;
+    // 填充字节不属于数据块
+    const size_t end = size - sizeof(kPadding);
+    size_t p = kHeaderSize;
+
+    for (uint32_t y = 0; y < height; y++) {
+        uint8_t* dst = frame->row(static_cast<int>(y));
+        for (uint32_t x = 0; x < width; x++, dst += 4) {
+            if (run > 0) {
+                run--;
+            } else {
+                if (p >= end) {
+                    return false;
+                }
+                const uint8_t b1 = data[p++];
+                if (b1 == kOpRgb) {
+                    if (end - p < 3) return false;
+                    px.r = data[p];
+                    px.g = data[p + 1];
+                    px.b = data[p + 2];
+                    p += 3;
+                } else if (b1 == kOpRgba) {
+                    if (end - p < 4) return false;
+                    px.r = data[p];
+                    px.g = data[p + 1];
+                    px.b = data[p + 2];
+                    px.a = data[p + 3];
+                    p += 4;
+                } else if ((b1 & kMask2) == kOpIndex) {
+                    px = index[b1];
+                } else if ((b1 & kMask2) == kOpDiff) {
+                    px.r = static_cast<uint8_t>(px.r + ((b1 >> 4) & 0x03) - 2);
+                    px.g = static_cast<uint8_t>(px.g + ((b1 >> 2) & 0x03) - 2);
+                    px.b = static_cast<uint8_t>(px.b + (b1 & 0x03) - 2);
+                } else if ((b1 & kMask2) == kOpLuma) {
+                    if (p >= end) return false;
+                    const uint8_t b2 = data[p++];
+                    const int dg = (b1 & 0x3F) - 32;
+                    px.r = static_cast<uint8_t>(px.r + dg - 8 + ((b2 >> 4) & 0x0F));
+                    px.g = static_cast<uint8_t>(px.g + dg);
+                    px.b = static_cast<uint8_t>(px.b + dg - 8 + (b2 & 0x0F));
+                } else {
+                    run = b1 & 0x3F;
+                }
+                index[Hash(px)] = px;
+            }
+            dst[0] = px.r;
+            dst[1] = px.g;
+            dst[2] = px.b;
+            dst[3] = channels == 4 ? px.a : 255;
+        }
+    }
+    return true;
+}
+
+}  // namespace capture_core
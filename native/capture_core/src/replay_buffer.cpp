@@ -0,0 +1,413 @@
+#include "capture_core/replay_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "capture_core/pixel_convert.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace capture_core {
+
+namespace {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// 当前线程消耗的 CPU 时间（用户态 + 内核态）；取不到时返回 0
+microseconds ThreadCpuTime() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return microseconds(0);
+    }
+    const uint64_t kernel_ticks =
+        (uint64_t(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t user_ticks = (uint64_t(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    // FILETIME 以 100 ns 为单位
+    return microseconds(static_cast<int64_t>((kernel_ticks + user_ticks) / 10));
+#else
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return microseconds(0);
+    }
+    return microseconds(int64_t(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000);
+#endif
+}
+
+// 把 src 的 rect 范围拷贝到同尺寸的 dst 的相同位置
+void CopyRect(const FrameBuffer& src, const Rect& rect, FrameBuffer* dst) {
+    const size_t offset = static_cast<size_t>(rect.x) * 4;
+    const size_t bytes = static_cast<size_t>(rect.width) * 4;
+    for (int y = rect.y; y < rect.bottom(); y++) {
+        std::memcpy(dst->row(y) + offset, src.row(y) + offset, bytes);
+    }
+}
+
+// 把 DecodeQoi 解出的 kRgba8 块贴到 canvas 的 rect 位置，转换成 canvas 的像素顺序
+void Paste(const FrameBuffer& block, const Rect& rect, FrameBuffer* canvas) {
+    const size_t offset = static_cast<size_t>(rect.x) * 4;
+    for (int y = 0; y < rect.height; y++) {
+        uint8_t* dst = canvas->row(rect.y + y) + offset;
+        if (canvas->format() == PixelFormat::kRgba8) {
+            std::memcpy(dst, block.row(y), static_cast<size_t>(rect.width) * 4);
+        } else {
+            SwapRedBlue(block.row(y), dst, static_cast<size_t>(rect.width));
+        }
+    }
+}
+
+}  // namespace
+
+ReplayBuffer::ReplayBuffer(milliseconds duration, size_t memory_limit,
+                           milliseconds keyframe_period)
+    : duration_(std::max(duration, milliseconds(1))),
+      memory_limit_(memory_limit),
+      keyframe_period_(keyframe_period.count() > 0 ? keyframe_period
+                                                   : std::max(duration_ / 4, milliseconds(1))) {}
+
+bool ReplayBuffer::Push(const FrameBuffer& frame, Clock::time_point time) {
+    if (frame.empty()) {
+        return false;
+    }
+    const Clock::time_point started = Clock::now();
+    const bool restart = !has_reference_ || reference_.width() != frame.width() ||
+                         reference_.height() != frame.height() ||
+                         reference_.format() != frame.format();
+    Rect bounds = restart ? frame.bounds() : ChangedBounds(reference_, frame);
+
+    if (bounds.empty()) {
+        // 画面没有变化：不存储，导出时上一帧自然延续到下一次变化
+        std::lock_guard<std::mutex> lock(mutex_);
+        newest_ = time;
+        unchanged_++;
+        encode_time_ += duration_cast<microseconds>(Clock::now() - started);
+        return true;
+    }
+
+    if (restart) {
+        // 第一帧、分辨率变化或上一个关键帧没能存下：之前的差分都不能再用
+        std::lock_guard<std::mutex> lock(mutex_);
+        evicted_ += static_cast<int64_t>(entries_.size());
+        entries_.clear();
+        bytes_ = 0;
+        keyframes_ = 0;
+        width_ = frame.width();
+        height_ = frame.height();
+        format_ = frame.format();
+    }
+
+    bool keyframe = restart || time - group_start_ >= keyframe_period_;
+    if (!keyframe) {
+        // 只编码变化矩形；frame 在 Push 返回之前不会改变
+        const FrameBuffer view = const_cast<FrameBuffer&>(frame).View(bounds);
+        if (!encoder_.Encode(view, &scratch_)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 放不下时先淘汰更旧的组；当前组还要用来还原这一帧，不能淘汰
+        while (bytes_ + scratch_.size() > memory_limit_ && keyframes_ > 1) {
+            EvictOldestGroup();
+        }
+        keyframe = bytes_ + scratch_.size() > memory_limit_;
+    }
+    if (keyframe) {
+        bounds = frame.bounds();
+        if (!encoder_.Encode(frame, &scratch_)) {
+            return false;
+        }
+    }
+
+    // 编码器按最坏情况分配输出，存储时拷贝成紧凑的数据
+    auto data = std::make_shared<const std::vector<uint8_t>>(scratch_.begin(), scratch_.end());
+    bool stored = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (keyframe) {
+            // 关键帧开始新的一组，之前的组都可以淘汰
+            while (bytes_ + data->size() > memory_limit_ && !entries_.empty()) {
+                EvictOldestGroup();
+            }
+        }
+        stored = bytes_ + data->size() <= memory_limit_;
+        if (stored) {
+            bytes_ += data->size();
+            peak_bytes_ = std::max(peak_bytes_, bytes_);
+            if (keyframe) keyframes_++;
+            entries_.push_back(Entry{time, bounds, keyframe, std::move(data)});
+        } else {
+            evicted_++;
+        }
+        newest_ = time;
+
+        // 第二组开始的时刻已经在保留时长之外：第一组不再需要
+        Clock::time_point second;
+        while (SecondKeyframeTime(&second) && second <= time - duration_) {
+            EvictOldestGroup();
+        }
+    }
+
+    if (!stored) {
+        has_reference_ = false;
+    } else if (keyframe) {
+        reference_.CopyFrom(frame);
+        has_reference_ = true;
+        group_start_ = time;
+    } else {
+        CopyRect(frame, bounds, &reference_);
+    }
+    // 编码器按最坏情况分配输出：关键帧或大面积变化之后不把整帧大小的缓冲一直留着
+    if (scratch_.capacity() > reference_.size_bytes() / 4) {
+        std::vector<uint8_t>().swap(scratch_);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    working_bytes_ = reference_.capacity_bytes() + scratch_.capacity();
+    encode_time_ += duration_cast<microseconds>(Clock::now() - started);
+    return stored;
+}
+
+bool ReplayBuffer::Export(AnimationFormat format, const std::string& path, Clock::time_point end,
+                          ReplayExport* result) const {
+    // 在锁内只复制条目（压缩数据是共享的），解码和写文件不阻塞采集
+    std::vector<Entry> entries;
+    int width = 0;
+    int height = 0;
+    PixelFormat pixel_format = PixelFormat::kBgrx8;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries.assign(entries_.begin(), entries_.end());
+        width = width_;
+        height = height_;
+        pixel_format = format_;
+        end = std::max(end, newest_);
+    }
+    if (entries.empty()) {
+        return false;
+    }
+
+    std::unique_ptr<AnimationWriter> writer = AnimationWriter::Create(format);
+    if (writer == nullptr || !writer->Open(path)) {
+        return false;
+    }
+
+    // 缓冲按组淘汰，最前面可能比 duration 更早：早于 cutoff 的帧只用来还原画面
+    const Clock::time_point cutoff = std::max(entries.front().time, end - duration_);
+    FrameBuffer canvas(width, height, pixel_format);
+    FrameBuffer block;
+    // canvas 中有 cutoff 之前的画面还没写出
+    bool pending = false;
+    for (const Entry& entry : entries) {
+        if (pending && entry.time > cutoff) {
+            if (!writer->AddFrame(canvas, milliseconds(0))) return false;
+            pending = false;
+        }
+        if (!DecodeQoi(entry.data->data(), entry.data->size(), &block) ||
+            block.width() != entry.bounds.width || block.height() != entry.bounds.height) {
+            writer->Abort();
+            return false;
+        }
+        Paste(block, entry.bounds, &canvas);
+        if (entry.time <= cutoff) {
+            pending = true;
+            continue;
+        }
+        if (!writer->AddFrame(canvas, duration_cast<milliseconds>(entry.time - cutoff))) {
+            return false;
+        }
+    }
+    if (pending && !writer->AddFrame(canvas, milliseconds(0))) {
+        return false;
+    }
+
+    const milliseconds length = duration_cast<milliseconds>(end - cutoff);
+    if (!writer->Finish(length)) {
+        writer->Abort();
+        return false;
+    }
+    if (result != nullptr) {
+        result->frames = writer->frames_written();
+        result->duration = length;
+        result->bytes = writer->bytes_written();
+    }
+    return true;
+}
+
+ReplayStats ReplayBuffer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ReplayStats stats;
+    stats.unchanged = unchanged_;
+    stats.evicted = evicted_;
+    stats.frames = static_cast<int64_t>(entries_.size());
+    stats.keyframes = keyframes_;
+    if (!entries_.empty()) {
+        stats.span = duration_cast<milliseconds>(newest_ - entries_.front().time);
+    }
+    stats.bytes = bytes_;
+    stats.peak_bytes = peak_bytes_;
+    stats.working_bytes = working_bytes_;
+    stats.encode_time = encode_time_;
+    return stats;
+}
+
+void ReplayBuffer::EvictOldestGroup() {
+    do {
+        bytes_ -= entries_.front().data->size();
+        if (entries_.front().keyframe) keyframes_--;
+        entries_.pop_front();
+        evicted_++;
+    } while (!entries_.empty() && !entries_.front().keyframe);
+}
+
+bool ReplayBuffer::SecondKeyframeTime(Clock::time_point* time) const {
+    for (size_t i = 1; i < entries_.size(); i++) {
+        if (entries_[i].keyframe) {
+            *time = entries_[i].time;
+            return true;
+        }
+    }
+    return false;
+}
+
+InstantReplay::InstantReplay(std::unique_ptr<FrameSource> source) : source_(std::move(source)) {}
+
+InstantReplay::~InstantReplay() {
+    Stop();
+}
+
+bool InstantReplay::Start(const ReplayOptions& options) {
+    if (source_ == nullptr || options.region.empty() || running()) {
+        return false;
+    }
+    options_ = options;
+    options_.fps = std::min(std::max(options.fps, 1), kMaxFps);
+    options_.duration = std::max(options.duration, std::chrono::seconds(1));
+    auto buffer = std::make_shared<ReplayBuffer>(
+        duration_cast<milliseconds>(options_.duration), options_.memory_limit);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer_ = buffer;
+        stopping_ = false;
+        captured_ = 0;
+        failed_captures_ = 0;
+        capture_bytes_ = 0;
+        capture_time_ = microseconds(0);
+        cpu_time_ = microseconds(0);
+        start_ = Clock::now();
+    }
+    thread_ = std::thread([this, buffer] { CaptureLoop(buffer); });
+    return true;
+}
+
+void InstantReplay::Stop() {
+    if (!running()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // 正在进行的 Save 持有自己的引用，写完后才释放
+    buffer_.reset();
+    capture_bytes_ = 0;
+}
+
+bool InstantReplay::Save(AnimationFormat format, const std::string& path,
+                         ReplayExport* result) const {
+    std::shared_ptr<ReplayBuffer> buffer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer = buffer_;
+    }
+    return buffer != nullptr && buffer->Export(format, path, Clock::now(), result);
+}
+
+ReplayStats InstantReplay::stats() const {
+    std::shared_ptr<ReplayBuffer> buffer;
+    ReplayStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer = buffer_;
+        stats.captured = captured_;
+        stats.failed_captures = failed_captures_;
+        stats.working_bytes = capture_bytes_;
+        stats.capture_time = capture_time_;
+        stats.cpu_time = cpu_time_;
+        if (buffer != nullptr) {
+            stats.uptime = duration_cast<milliseconds>(Clock::now() - start_);
+        }
+    }
+    if (buffer != nullptr) {
+        const ReplayStats stored = buffer->stats();
+        stats.unchanged = stored.unchanged;
+        stats.evicted = stored.evicted;
+        stats.frames = stored.frames;
+        stats.keyframes = stored.keyframes;
+        stats.span = stored.span;
+        stats.bytes = stored.bytes;
+        stats.peak_bytes = stored.peak_bytes;
+        stats.working_bytes += stored.working_bytes;
+        stats.encode_time = stored.encode_time;
+    }
+    return stats;
+}
+
+bool InstantReplay::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return buffer_ != nullptr;
+}
+
+void InstantReplay::CaptureLoop(std::shared_ptr<ReplayBuffer> buffer) {
+    const auto period = duration_cast<Clock::duration>(std::chrono::seconds(1)) / options_.fps;
+    const microseconds cpu_start = ThreadCpuTime();
+    FrameBuffer frame;
+    int64_t tick = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        const Clock::time_point due = start_ + period * tick;
+        if (cv_.wait_until(lock, due, [this] { return stopping_; })) {
+            break;
+        }
+
+        lock.unlock();
+        const Clock::time_point now = Clock::now();
+        const bool ok = source_->Capture(options_.region, &frame) && !frame.empty();
+        const Clock::time_point captured = Clock::now();
+        if (ok) {
+            // 来源可能包装自己的缓冲：Push 在返回前就把需要的像素复制走了
+            buffer->Push(frame, now);
+        }
+        const microseconds cpu = ThreadCpuTime() - cpu_start;
+        lock.lock();
+
+        if (ok) {
+            captured_++;
+        } else {
+            failed_captures_++;
+        }
+        capture_time_ += duration_cast<microseconds>(captured - now);
+        cpu_time_ = cpu;
+        capture_bytes_ = frame.capacity_bytes();
+
+        // 采集加压缩超过一个周期时跳到下一个未来的节拍
+        const int64_t elapsed = (Clock::now() - start_) / period;
+        tick = std::max(tick + 1, elapsed + 1);
+    }
+}
+
+}  // namespace capture_core
@@ -0,0 +1,178 @@
+#include "capture_core/screen_recorder.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace capture_core {
+
+ScreenRecorder::ScreenRecorder(std::unique_ptr<FrameSource> source)
+    : source_(std::move(source)) {}
+
+ScreenRecorder::~ScreenRecorder() {
+    Abort();
+}
+
+bool ScreenRecorder::Start(const RecorderOptions& options) {
+    if (source_ == nullptr || options.region.empty() || recording()) {
+        return false;
+    }
+    std::unique_ptr<AnimationWriter> writer = AnimationWriter::Create(options.format);
+    if (writer == nullptr || !writer->Open(options.path)) {
+        return false;
+    }
+    writer_ = std::move(writer);
+    options_ = options;
+    options_.fps = std::min(std::max(options.fps, 1), kMaxFps);
+    options_.ring_size = std::max<size_t>(options.ring_size, 2);
+
+    free_.clear();
+    filled_.clear();
+    for (size_t i = 0; i < options_.ring_size; i++) {
+        free_.push_back(std::make_unique<Slot>());
+    }
+    running_ = true;
+    stopping_ = false;
+    capture_done_ = false;
+    write_failed_ = false;
+    captured_ = 0;
+    dropped_ = 0;
+    failed_captures_ = 0;
+    start_ = Clock::now();
+    stop_ = start_;
+    capture_thread_ = std::thread([this] { CaptureLoop(); });
+    encode_thread_ = std::thread([this] { EncodeLoop(); });
+    return true;
+}
+
+RecordingStats ScreenRecorder::Stop() {
+    RecordingStats stats;
+    if (!recording()) {
+        return stats;
+    }
+    Join(true);
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(stop_ - start_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.captured = captured_;
+        stats.dropped = dropped_;
+        stats.failed_captures = failed_captures_;
+        stats.ok = !write_failed_;
+    }
+    stats.ok = stats.ok && writer_->Finish(duration);
+    if (!stats.ok) {
+        writer_->Abort();
+    }
+    stats.written = writer_->frames_written();
+    stats.merged = writer_->frames_merged();
+    stats.bytes = stats.ok ? writer_->bytes_written() : 0;
+    stats.duration = duration;
+    writer_.reset();
+    return stats;
+}
+
+void ScreenRecorder::Abort() {
+    if (!recording()) {
+        return;
+    }
+    Join(false);
+    writer_->Abort();
+    writer_.reset();
+}
+
+bool ScreenRecorder::recording() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_;
+}
+
+void ScreenRecorder::Join(bool drain) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    capture_cv_.notify_all();
+    capture_thread_.join();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = Clock::now();
+        capture_done_ = true;
+        if (!drain) {
+            filled_.clear();
+        }
+    }
+    encode_cv_.notify_all();
+    encode_thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    running_ = false;
+    free_.clear();
+    filled_.clear();
+}
+
+void ScreenRecorder::CaptureLoop() {
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(1)) /
+                        options_.fps;
+    FrameBuffer scratch;
+    int64_t tick = 0;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        const Clock::time_point due = start_ + period * tick;
+        if (capture_cv_.wait_until(lock, due, [this] { return stopping_; })) {
+            break;
+        }
+
+        lock.unlock();
+        const Clock::time_point now = Clock::now();
+        const bool ok = source_->Capture(options_.region, &scratch) && !scratch.empty();
+        const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_);
+        lock.lock();
+
+        if (!ok) {
+            failed_captures_++;
+        } else if (free_.empty()) {
+            // 编码跟不上：丢掉这一帧，不让采集排队
+            dropped_++;
+        } else {
+            std::unique_ptr<Slot> slot = std::move(free_.back());
+            free_.pop_back();
+            lock.unlock();
+            if (scratch.owns_memory()) {
+                // 来源写进了 scratch 自己的内存：交换，缓冲的旧内存留给下一次采集
+                std::swap(slot->frame, scratch);
+            } else {
+                // 来源包装的是自己的缓冲，下一次采集前必须复制出来
+                slot->frame.CopyFrom(scratch);
+            }
+            slot->timestamp = timestamp;
+            lock.lock();
+            captured_++;
+            filled_.push_back(std::move(slot));
+            encode_cv_.notify_one();
+        }
+
+        // 落后超过一个周期（系统休眠、采集过慢）时跳到下一个未来的节拍
+        const int64_t elapsed = (Clock::now() - start_) / period;
+        tick = std::max(tick + 1, elapsed + 1);
+    }
+}
+
+void ScreenRecorder::EncodeLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        encode_cv_.wait(lock, [this] { return !filled_.empty() || capture_done_; });
+        if (filled_.empty()) {
+            // 采集线程已经退出，排队的帧也写完了
+            break;
+        }
+        std::unique_ptr<Slot> slot = std::move(filled_.front());
+        filled_.pop_front();
+        const bool skip = write_failed_;
+        lock.unlock();
+        const bool ok = skip || writer_->AddFrame(slot->frame, slot->timestamp);
+        lock.lock();
+        if (!ok) {
+            write_failed_ = true;
+        }
+        free_.push_back(std::move(slot));
+    }
+}
+
+}  // namespace capture_core
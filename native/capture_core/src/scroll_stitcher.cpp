@@ -0,0 +1,288 @@
+#include "capture_core/scroll_stitcher.h"
+
+#include <algorithm>
+#include <thread>
+
+#include "capture_core/pixel_convert.h"
+
+namespace capture_core {
+
+namespace {
+
+// 行哈希序列的多项式滚动哈希（模 2^64）
+const uint64_t kSequenceBase = 0x100000001B3ull;
+
+// 等待 duration，期间每隔一小段检查取消；取消时返回 false
+bool SleepUnlessCancelled(std::chrono::milliseconds duration, const CancellationToken& token) {
+    constexpr std::chrono::milliseconds kSlice(10);
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+    while (!token.cancelled()) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+            kSlice, deadline - now));
+    }
+    return false;
+}
+
+}  // namespace
+
+ScrollStitcher::ScrollStitcher() : ScrollStitcher(ScrollStitchOptions()) {}
+
+ScrollStitcher::ScrollStitcher(const ScrollStitchOptions& options,
+                               const PngEncoderOptions& png_options)
+    : options_(options), writer_(png_options) {}
+
+bool ScrollStitcher::Open(const std::string& path) {
+    if (!writer_.Open(path)) {
+        return false;
+    }
+    previous_.Reset();
+    previous_hashes_.clear();
+    current_hashes_.clear();
+    emitted_ = 0;
+    paired_ = false;
+    stats_ = ScrollStitchStats();
+    return true;
+}
+
+void ScrollStitcher::HashRows(const FrameBuffer& frame, std::vector<uint64_t>* hashes) const {
+    int left = std::max(0, options_.ignore_left);
+    int right = std::max(0, options_.ignore_right);
+    if (left + right >= frame.width()) {
+        // 帧太窄时比较整行
+        left = 0;
+        right = 0;
+    }
+    const size_t pixels = static_cast<size_t>(frame.width() - left - right);
+    const uint32_t mask = frame.format() == PixelFormat::kBgrx8 ? 0x00FFFFFFu : 0xFFFFFFFFu;
+    hashes->resize(static_cast<size_t>(frame.height()));
+    for (int y = 0; y < frame.height(); y++) {
+        (*hashes)[y] = HashRow(frame.row(y) + static_cast<size_t>(left) * 4, pixels, mask);
+    }
+}
+
+int ScrollStitcher::FindOffset(int top, int end) const {
+    const std::vector<uint64_t>& previous = previous_hashes_;
+    const std::vector<uint64_t>& current = current_hashes_;
+    const int window = std::max(2, options_.min_overlap);
+    if (end - top < window) {
+        return -1;
+    }
+
+    // 锚点：滚动区域顶部第一个行内容不全相同的窗口，空白行组成的窗口到处都能匹配。
+    // 锚点越靠上能识别的滚动距离越大，所以把第一处变化放在窗口中间即可
+    int anchor = top;
+    for (int y = top; y + 1 < end; y++) {
+        if (current[y] != current[y + 1]) {
+            anchor = std::max(top, y - window / 2);
+            break;
+        }
+    }
+    if (anchor + window > end) {
+        anchor = top;
+    }
+
+    uint64_t power = 1;
+    uint64_t target = 0;
+    uint64_t rolling = 0;
+    for (int i = 0; i < window; i++) {
+        if (i > 0) power *= kSequenceBase;
+        target = target * kSequenceBase + current[anchor + i];
+        rolling = rolling * kSequenceBase + previous[anchor + i];
+    }
+
+    // 上一帧中与锚点窗口哈希相同的位置 p 对应滚动 p - anchor 行，逐个核对整个重叠部分
+    int best_offset = -1;
+    double best_ratio = 0;
+    for (int p = anchor; p + window <= end; p++) {
+        if (p > anchor) {
+            rolling = (rolling - previous[p - 1] * power) * kSequenceBase + previous[p + window - 1];
+        }
+        if (rolling != target) {
+            continue;
+        }
+        const int offset = p - anchor;
+        const int overlap = end - top - offset;
+        if (overlap < window) {
+            break;
+        }
+        int matches = 0;
+        for (int y = top; y < end - offset; y++) {
+            matches += current[y] == previous[y + offset];
+        }
+        const double ratio = static_cast<double>(matches) / overlap;
+        if (ratio > best_ratio) {
+            best_ratio = ratio;
+            best_offset = offset;
+        }
+    }
+    return best_ratio >= options_.min_match ? best_offset : -1;
+}
+
+bool ScrollStitcher::Emit(int first_row, int row_count) {
+    if (row_count <= 0) {
+        return true;
+    }
+    if (!writer_.AddRows(previous_.View(Rect(0, first_row, previous_.width(), row_count)))) {
+        return false;
+    }
+    stats_.height = writer_.height();
+    stats_.bytes = writer_.bytes_written();
+    return true;
+}
+
+StitchResult ScrollStitcher::AddFrame(const FrameBuffer& frame) {
+    if (!writer_.is_open() || frame.empty()) {
+        return StitchResult::kFailed;
+    }
+    if (previous_.empty()) {
+        previous_.CopyFrom(frame);
+        HashRows(previous_, &previous_hashes_);
+        stats_.frames++;
+        stats_.appended++;
+        return StitchResult::kAppended;
+    }
+    if (frame.width() != previous_.width() || frame.height() != previous_.height() ||
+        frame.format() != previous_.format()) {
+        return StitchResult::kFailed;
+    }
+    stats_.frames++;
+    HashRows(frame, &current_hashes_);
+
+    // 同一位置哈希相同的顶部和底部行是固定的页眉和页脚
+    const int height = frame.height();
+    const int limit = height / 3;
+    int top = 0;
+    while (top < height && current_hashes_[top] == previous_hashes_[top]) {
+        top++;
+    }
+    if (top == height) {
+        stats_.unchanged++;
+        return StitchResult::kUnchanged;
+    }
+    top = std::min(top, limit);
+    int bottom = 0;
+    while (bottom < limit &&
+           current_hashes_[height - 1 - bottom] == previous_hashes_[height - 1 - bottom]) {
+        bottom++;
+    }
+    const int end = height - bottom;
+
+    const int offset = FindOffset(top, end);
+    if (offset < 0) {
+        stats_.no_overlap++;
+        return StitchResult::kNoOverlap;
+    }
+    if (offset == 0) {
+        stats_.unchanged++;
+        return StitchResult::kUnchanged;
+    }
+    stats_.header_rows = top;
+    stats_.footer_rows = bottom;
+    stats_.last_offset = offset;
+
+    if (!paired_) {
+        // 第一帧的页眉和滚动内容（页脚留到最后）
+        if (!Emit(0, end)) {
+            return StitchResult::kFailed;
+        }
+        emitted_ = end;
+        paired_ = true;
+    }
+    previous_.CopyFrom(frame);
+    previous_hashes_.swap(current_hashes_);
+    // 上一帧写到的位置在这一帧中上移了 offset 行，其后到页脚之前是新露出的内容
+    const int first = std::max(0, emitted_ - offset);
+    if (!Emit(first, end - first)) {
+        return StitchResult::kFailed;
+    }
+    emitted_ = std::max(first, end);
+    stats_.appended++;
+    return StitchResult::kAppended;
+}
+
+bool ScrollStitcher::Finish() {
+    if (previous_.empty()) {
+        writer_.Abort();
+        return false;
+    }
+    // 最后一帧剩下的行，包括页脚
+    bool ok = Emit(emitted_, previous_.height() - emitted_) && writer_.Finish();
+    if (!ok) {
+        writer_.Abort();
+    }
+    stats_.height = writer_.height();
+    stats_.bytes = writer_.bytes_written();
+    previous_.Reset();
+    return ok;
+}
+
+void ScrollStitcher::Abort() {
+    writer_.Abort();
+    previous_.Reset();
+}
+
+bool CaptureScrolling(FrameSource* source, const Rect& region, const std::string& path,
+                      const ScrollCaptureOptions& options, const ScrollFunction& scroll,
+                      const CancellationToken& token, ScrollStitchStats* stats) {
+    if (source == nullptr || region.empty()) {
+        return false;
+    }
+    ScrollStitcher stitcher(options.stitch, options.png);
+    if (!stitcher.Open(path)) {
+        return false;
+    }
+    FrameBuffer frame;
+    int unchanged = 0;
+    for (int i = 0; i < std::max(1, options.max_frames); i++) {
+        if (i > 0) {
+            if (token.cancelled()) {
+                stitcher.Abort();
+                return false;
+            }
+            if (!scroll || !scroll()) {
+                break;
+            }
+            if (!SleepUnlessCancelled(options.settle, token)) {
+                stitcher.Abort();
+                return false;
+            }
+        }
+        if (!source->Capture(region, &frame) || frame.empty()) {
+            stitcher.Abort();
+            return false;
+        }
+        const StitchResult result = stitcher.AddFrame(frame);
+        if (result == StitchResult::kFailed) {
+            stitcher.Abort();
+            return false;
+        }
+        // 滚过了一整屏或页面内容变了：到此为止，保留已经拼好的部分
+        if (result == StitchResult::kNoOverlap) {
+            break;
+        }
+        if (result == StitchResult::kUnchanged) {
+            if (++unchanged >= std::max(1, options.unchanged_limit)) {
+                break;
+            }
+        } else {
+            unchanged = 0;
+        }
+        // 已写出的行加上最后一帧最多剩下的一整帧
+        if (stitcher.stats().height + frame.height() > options.max_height) {
+            break;
+        }
+    }
+    if (!stitcher.Finish()) {
+        return false;
+    }
+    if (stats != nullptr) {
+        *stats = stitcher.stats();
+    }
+    return true;
+}
+
+}  // namespace capture_core
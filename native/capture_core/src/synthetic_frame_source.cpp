@@ -0,0 +1,95 @@
+#include "capture_core/synthetic_frame_source.h"
+
+#include <cstring>
+
+namespace capture_core {
+
+namespace {
+
+// 低成本整数哈希，用于生成确定性的噪声
+inline uint32_t HashCoord(uint32_t x, uint32_t y, uint32_t seed) {
+    uint32_t h = x * 0x9E3779B1u ^ (y + seed) * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0xC2B2AE3Du;
+    h ^= h >> 13;
+    return h;
+}
+
+// 移动方块的边长
+const int kBoxSize = 64;
+
+}  // namespace
+
+SyntheticFrameSource::SyntheticFrameSource(int width, int height, Pattern pattern)
+    : width_(width), height_(height), pattern_(pattern), frame_count_(0) {}
+
+Rect SyntheticFrameSource::GetBounds() {
+    return Rect(0, 0, width_, height_);
+}
+
+bool SyntheticFrameSource::Capture(const Rect& region, FrameBuffer* frame) {
+    Rect clipped = IntersectRects(region, GetBounds());
+    if (clipped.empty() || frame == nullptr) {
+        return false;
+    }
+
+    frame->Allocate(clipped.width, clipped.height, PixelFormat::kBgrx8);
+    for (int y = 0; y < clipped.height; y++) {
+        FillRow(clipped.y + y, clipped.x, clipped.width, frame->row(y));
+    }
+    frame_count_++;
+    return true;
+}
+
+void SyntheticFrameSource::FillRow(int y, int x0, int count, uint8_t* out) const {
+    // 方块沿对角线移动，每帧 8 像素
+    int travel = width_ > kBoxSize ? width_ - kBoxSize : 1;
+    int box_x = static_cast<int>((frame_count_ * 8) % static_cast<uint64_t>(travel));
+    int box_y = height_ > kBoxSize ? box_x % (height_ - kBoxSize) : 0;
+    bool row_in_box = y >= box_y && y < box_y + kBoxSize;
+
+    for (int i = 0; i < count; i++) {
+        int x = x0 + i;
+        uint8_t b, g, r;
+        switch (pattern_) {
+            case Pattern::kGradient:
+                b = static_cast<uint8_t>((x * 255) / (width_ > 1 ? width_ - 1 : 1));
+                g = static_cast<uint8_t>((y * 255) / (height_ > 1 ? height_ - 1 : 1));
+                r = static_cast<uint8_t>((x + y) & 0xFF);
+                break;
+            case Pattern::kUi: {
+                // 窗口式色块 + 每 16 行一条“文字”细线
+                int panel = (x / 240 + y / 180) % 3;
+                b = panel == 0 ? 0xF3 : (panel == 1 ? 0xFF : 0x2B);
+                g = panel == 0 ? 0xF3 : (panel == 1 ? 0xFF : 0x2B);
+                r = panel == 0 ? 0xF3 : (panel == 1 ? 0xFF : 0x2B);
+                if ((y % 16) == 8 && (x % 240) > 12 && (x % 240) < 200 &&
+                    (HashCoord(x / 6, y / 16, 7) & 3) != 0) {
+                    b = g = r = 0x20;
+                }
+                break;
+            }
+            case Pattern::kNoise:
+            default: {
+                // 平滑底色 + 随机扰动，接近照片的统计特性
+                uint32_t h = HashCoord(static_cast<uint32_t>(x), static_cast<uint32_t>(y), 1);
+                b = static_cast<uint8_t>(((x >> 2) + (h & 0x3F)) & 0xFF);
+                g = static_cast<uint8_t>(((y >> 2) + ((h >> 8) & 0x3F)) & 0xFF);
+                r = static_cast<uint8_t>((((x + y) >> 3) + ((h >> 16) & 0x3F)) & 0xFF);
+                break;
+            }
+        }
+        if (row_in_box && x >= box_x && x < box_x + kBoxSize) {
+            b = 0x20;
+            g = 0x40;
+            r = 0xE0;
+        }
+        out[0] = b;
+        out[1] = g;
+        out[2] = r;
+        out[3] = 0;  // 与 BitBlt 一样，X 通道未定义
+        out += 4;
+    }
+}
+
+}  // namespace capture_core
@@ -0,0 +1,110 @@
+#include "capture_core/thread_pool.h"
+
+#include <atomic>
+#include <memory>
+
+namespace capture_core {
+
+ThreadPool::ThreadPool(int num_threads) {
+    for (int i = 0; i < num_threads; i++) {
+        workers_.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    if (workers_.empty()) {
+        task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+void ThreadPool::ParallelFor(int count, const std::function<void(int)>& fn) {
+    if (count <= 0) {
+        return;
+    }
+    if (count == 1 || workers_.empty()) {
+        for (int i = 0; i < count; i++) {
+            fn(i);
+        }
+        return;
+    }
+
+    // 调用方和辅助任务从同一个计数器领取下标。
+    // 辅助任务可能在 ParallelFor 返回后才开始运行，此时领不到下标，
+    // 不会再访问 fn，所以共享状态用 shared_ptr 保活即可。
+    struct State {
+        std::atomic<int> next{0};
+        int remaining = 0;
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = count;
+    const std::function<void(int)>* body = &fn;
+
+    auto run = [state, body, count] {
+        int finished = 0;
+        for (int i = state->next.fetch_add(1); i < count; i = state->next.fetch_add(1)) {
+            (*body)(i);
+            finished++;
+        }
+        if (finished > 0) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->remaining -= finished;
+            if (state->remaining == 0) {
+                state->done.notify_all();
+            }
+        }
+    };
+
+    int helpers = count - 1 < num_threads() ? count - 1 : num_threads();
+    for (int i = 0; i < helpers; i++) {
+        Submit(run);
+    }
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->done.wait(lock, [&state] { return state->remaining == 0; });
+}
+
+ThreadPool* ThreadPool::Shared() {
+    static ThreadPool pool([] {
+        int cores = static_cast<int>(std::thread::hardware_concurrency());
+        return cores > 1 ? cores - 1 : 0;
+    }());
+    return &pool;
+}
+
+void ThreadPool::WorkerLoop() {
+    for (;;) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+}  // namespace capture_core
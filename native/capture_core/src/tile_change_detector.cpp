@@ -0,0 +1,274 @@
+#include "capture_core/tile_change_detector.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "capture_core/pixel_convert.h"
+#include "capture_core/thread_pool.h"
+
+namespace capture_core {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr uint64_t kPrime5 = 2870177450012600261ULL;
+
+// kBgrx8 每个 64 位字里两个像素的 X 字节（小端）
+constexpr uint64_t kIgnoreXMask = 0xFF000000FF000000ULL;
+
+inline uint64_t Rotl(uint64_t v, int bits) { return (v << bits) | (v >> (64 - bits)); }
+
+inline uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = Rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t Merge(uint64_t acc, uint64_t value) {
+    acc ^= Round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 一个分块的 4 路累加状态
+struct TileHashState {
+    uint64_t lanes[4];
+    uint64_t length;
+
+    void Init() {
+        lanes[0] = kPrime1 + kPrime2;
+        lanes[1] = kPrime2;
+        lanes[2] = 0;
+        lanes[3] = 0 - kPrime1;
+        length = 0;
+    }
+
+    // 累加分块的一行（bytes 为 4 的倍数）
+    void Update(const uint8_t* p, size_t bytes, uint64_t mask) {
+        length += bytes;
+        size_t i = 0;
+        for (; i + 32 <= bytes; i += 32) {
+            lanes[0] = Round(lanes[0], Load64(p + i) | mask);
+            lanes[1] = Round(lanes[1], Load64(p + i + 8) | mask);
+            lanes[2] = Round(lanes[2], Load64(p + i + 16) | mask);
+            lanes[3] = Round(lanes[3], Load64(p + i + 24) | mask);
+        }
+        // 不满 32 字节的行尾（分块最后一列不满 tile_size 时）
+        int lane = 0;
+        for (; i + 8 <= bytes; i += 8, lane++) {
+            lanes[lane] = Round(lanes[lane], Load64(p + i) | mask);
+        }
+        if (i < bytes) {
+            uint32_t v;
+            std::memcpy(&v, p + i, sizeof(v));
+            lanes[lane] = Round(lanes[lane], static_cast<uint64_t>(v | static_cast<uint32_t>(mask)));
+        }
+    }
+
+    uint64_t Finish() const {
+        uint64_t h = Rotl(lanes[0], 1) + Rotl(lanes[1], 7) + Rotl(lanes[2], 12) +
+                     Rotl(lanes[3], 18);
+        for (uint64_t lane : lanes) {
+            h = Merge(h, lane);
+        }
+        h += length * kPrime5;
+        h ^= h >> 33;
+        h *= kPrime2;
+        h ^= h >> 29;
+        h *= kPrime3;
+        h ^= h >> 32;
+        return h;
+    }
+};
+
+}  // namespace
+
+Rect TileDiff::TileRect(int column, int row) const {
+    const int x = column * tile_size;
+    const int y = row * tile_size;
+    return Rect(x, y, std::min(tile_size, frame_width - x), std::min(tile_size, frame_height - y));
+}
+
+Rect TileDiff::DirtyBounds() const {
+    Rect bounds;
+    for (int row = 0; row < rows; row++) {
+        for (int column = 0; column < columns; column++) {
+            if (is_dirty(column, row)) {
+                bounds = UnionRects(bounds, TileRect(column, row));
+            }
+        }
+    }
+    return bounds;
+}
+
+TileChangeDetector::TileChangeDetector(int tile_size, ThreadPool* pool)
+    : tile_size_(std::max(tile_size, 8)), pool_(pool ? pool : ThreadPool::Shared()) {}
+
+const TileDiff& TileChangeDetector::Compare(const FrameBuffer& frame) {
+    diff_.tile_size = tile_size_;
+    diff_.frame_width = frame.empty() ? 0 : frame.width();
+    diff_.frame_height = frame.empty() ? 0 : frame.height();
+    diff_.columns = (diff_.frame_width + tile_size_ - 1) / tile_size_;
+    diff_.rows = (diff_.frame_height + tile_size_ - 1) / tile_size_;
+    const size_t count = static_cast<size_t>(diff_.columns) * diff_.rows;
+    diff_.dirty.assign(count, 0);
+    diff_.dirty_count = 0;
+    diff_.full = false;
+    hashes_.resize(count);
+    if (count == 0) {
+        return diff_;
+    }
+
+    const int columns = diff_.columns;
+    const int width = diff_.frame_width;
+    const int height = diff_.frame_height;
+    const uint64_t mask = frame.format() == PixelFormat::kBgrx8 ? kIgnoreXMask : 0;
+    pool_->ParallelFor(diff_.rows, [&](int tile_row) {
+        std::vector<TileHashState> states(static_cast<size_t>(columns));
+        for (TileHashState& state : states) {
+            state.Init();
+        }
+        const int y_end = std::min(height, (tile_row + 1) * tile_size_);
+        for (int y = tile_row * tile_size_; y < y_end; y++) {
+            const uint8_t* row = frame.row(y);
+            for (int column = 0; column < columns; column++) {
+                const int x = column * tile_size_;
+                const int tile_width = std::min(tile_size_, width - x);
+                states[column].Update(row + static_cast<size_t>(x) * 4,
+                                      static_cast<size_t>(tile_width) * 4, mask);
+            }
+        }
+        uint64_t* out = hashes_.data() + static_cast<size_t>(tile_row) * columns;
+        for (int column = 0; column < columns; column++) {
+            out[column] = states[column].Finish();
+        }
+    });
+
+    last_format_ = frame.format();
+    diff_.full = !has_reference_ || reference_width_ != width || reference_height_ != height ||
+                 reference_format_ != frame.format();
+    for (size_t i = 0; i < count; i++) {
+        if (diff_.full || hashes_[i] != reference_[i]) {
+            diff_.dirty[i] = 1;
+            diff_.dirty_count++;
+        }
+    }
+    return diff_;
+}
+
+void TileChangeDetector::UpdateReference() {
+    if (diff_.tile_count() == 0) {
+        return;
+    }
+    reference_.assign(hashes_.begin(), hashes_.end());
+    reference_width_ = diff_.frame_width;
+    reference_height_ = diff_.frame_height;
+    reference_format_ = last_format_;
+    has_reference_ = true;
+}
+
+void TileChangeDetector::Reset() {
+    reference_.clear();
+    has_reference_ = false;
+}
+
+bool ExtractDirtyTiles(const FrameBuffer& frame, const TileDiff& diff, FrameBuffer* patch,
+                       Rect* bounds) {
+    if (frame.empty() || frame.width() != diff.frame_width ||
+        frame.height() != diff.frame_height) {
+        return false;
+    }
+    const Rect dirty_bounds = diff.DirtyBounds();
+    if (dirty_bounds.empty()) {
+        return false;
+    }
+
+    patch->Allocate(dirty_bounds.width, dirty_bounds.height, PixelFormat::kBgra8);
+    for (int y = 0; y < dirty_bounds.height; y++) {
+        std::memset(patch->row(y), 0, static_cast<size_t>(dirty_bounds.width) * 4);
+    }
+    for (int row = 0; row < diff.rows; row++) {
+        for (int column = 0; column < diff.columns; column++) {
+            if (!diff.is_dirty(column, row)) {
+                continue;
+            }
+            const Rect tile = diff.TileRect(column, row);
+            for (int y = tile.y; y < tile.bottom(); y++) {
+                const uint8_t* src = frame.row(y) + static_cast<size_t>(tile.x) * 4;
+                uint8_t* dst = patch->row(y - dirty_bounds.y) +
+                               static_cast<size_t>(tile.x - dirty_bounds.x) * 4;
+                if (frame.format() == PixelFormat::kRgba8) {
+                    SwapRedBlueOpaque(src, dst, static_cast<size_t>(tile.width));
+                } else {
+                    std::memcpy(dst, src, static_cast<size_t>(tile.width) * 4);
+                    ForceOpaque(dst, static_cast<size_t>(tile.width));
+                }
+            }
+        }
+    }
+    *bounds = dirty_bounds;
+    return true;
+}
+
+ChangeTracker::ChangeTracker(int tile_size, double keyframe_ratio)
+    : tile_size_(tile_size), keyframe_ratio_(keyframe_ratio) {}
+
+ChangeDecision ChangeTracker::Process(const std::string& key, bool allow_patch,
+                                      FrameBuffer* frame) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::shared_ptr<Entry>& slot = entries_[key];
+        if (!slot) {
+            slot = std::make_shared<Entry>(tile_size_);
+        }
+        entry = slot;
+    }
+
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    const TileDiff& diff = entry->detector.Compare(*frame);
+    ChangeDecision decision;
+    decision.dirty_tiles = diff.dirty_count;
+    decision.total_tiles = diff.tile_count();
+    decision.frame_width = diff.frame_width;
+    decision.frame_height = diff.frame_height;
+
+    if (!diff.full && diff.dirty_count == 0) {
+        decision.action = ChangeAction::kUnchanged;
+        return decision;
+    }
+    if (allow_patch && !diff.full && diff.dirty_ratio() <= keyframe_ratio_) {
+        FrameBuffer patch;
+        Rect bounds;
+        if (ExtractDirtyTiles(*frame, diff, &patch, &bounds)) {
+            *frame = std::move(patch);
+            decision.action = ChangeAction::kPatch;
+            decision.patch_bounds = bounds;
+            return decision;
+        }
+    }
+    entry->detector.UpdateReference();
+    decision.action = ChangeAction::kFullFrame;
+    return decision;
+}
+
+void ChangeTracker::Forget(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(key);
+}
+
+size_t ChangeTracker::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+}  // namespace capture_core
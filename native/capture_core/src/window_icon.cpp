@@ -0,0 +1,72 @@
+#include "capture_core/window_icon.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "capture_core/pixel_convert.h"
+
+namespace capture_core {
+
+namespace {
+
+// 防止损坏的属性里的尺寸相乘溢出
+constexpr unsigned long kMaxIconDimension = 1024;
+
+}  // namespace
+
+bool SelectNetWmIcon(const unsigned long* data, size_t count, int preferred_size,
+                     FrameBuffer* icon) {
+    const unsigned long* best = nullptr;
+    int best_width = 0;
+    int best_height = 0;
+    size_t offset = 0;
+    while (offset + 2 <= count) {
+        const unsigned long width = data[offset] & 0xFFFFFFFFu;
+        const unsigned long height = data[offset + 1] & 0xFFFFFFFFu;
+        if (width == 0 || height == 0 || width > kMaxIconDimension ||
+            height > kMaxIconDimension || width * height > count - offset - 2) {
+            break;
+        }
+        const int w = static_cast<int>(width);
+        const int h = static_cast<int>(height);
+        const int longest = std::max(w, h);
+        const int best_longest = std::max(best_width, best_height);
+        // 足够大的里面越小越好，都不够大时越大越好
+        const bool better =
+            best == nullptr ||
+            (longest >= preferred_size
+                 ? best_longest < preferred_size || longest < best_longest
+                 : best_longest < preferred_size && longest > best_longest);
+        if (better) {
+            best = data + offset + 2;
+            best_width = w;
+            best_height = h;
+        }
+        offset += 2 + width * height;
+    }
+    if (best == nullptr) {
+        return false;
+    }
+
+    FrameBuffer full;
+    const bool shrink = preferred_size > 0 && std::max(best_width, best_height) > preferred_size;
+    FrameBuffer* target = shrink ? &full : icon;
+    target->Allocate(best_width, best_height, PixelFormat::kBgra8);
+    const unsigned long* pixel = best;
+    for (int y = 0; y < best_height; y++) {
+        uint8_t* out = target->row(y);
+        for (int x = 0; x < best_width; x++, out += 4) {
+            const unsigned long argb = *pixel++;
+            out[0] = static_cast<uint8_t>(argb);
+            out[1] = static_cast<uint8_t>(argb >> 8);
+            out[2] = static_cast<uint8_t>(argb >> 16);
+            out[3] = static_cast<uint8_t>(argb >> 24);
+        }
+    }
+    if (shrink) {
+        DownscaleFrame(full, preferred_size, icon);
+    }
+    return true;
+}
+
+}  // namespace capture_core
@@ -0,0 +1,115 @@
+#include "capture_core/window_list.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+namespace capture_core {
+
+void WindowListModel::Reset(std::vector<WindowRecord> windows) {
+    std::unordered_set<uint64_t> present;
+    for (const WindowRecord& window : windows) {
+        present.insert(window.id);
+    }
+    for (uint64_t id : order_) {
+        if (present.count(id) == 0) {
+            windows_.erase(id);
+            MarkRemoved(id);
+        }
+    }
+
+    order_.clear();
+    for (WindowRecord& window : windows) {
+        const uint64_t id = window.id;
+        if (std::find(order_.begin(), order_.end(), id) != order_.end()) {
+            continue;  // 枚举结果里重复的窗口
+        }
+        order_.push_back(id);
+        Upsert(std::move(window));
+    }
+}
+
+bool WindowListModel::Upsert(WindowRecord window) {
+    const uint64_t id = window.id;
+    auto it = windows_.find(id);
+    if (it != windows_.end()) {
+        if (it->second == window) {
+            return false;
+        }
+        it->second = std::move(window);
+        // 新增后又变化仍然是新增
+        pending_.emplace(id, Change::kUpdated);
+        return true;
+    }
+
+    windows_.emplace(id, std::move(window));
+    if (std::find(order_.begin(), order_.end(), id) == order_.end()) {
+        order_.insert(order_.begin(), id);
+    }
+    auto pending = pending_.find(id);
+    if (pending == pending_.end()) {
+        pending_.emplace(id, Change::kAdded);
+    } else if (pending->second == Change::kRemoved) {
+        // 消失后又出现（例如隐藏再显示）：对上一次推送的列表来说是更新
+        pending->second = Change::kUpdated;
+    }
+    return true;
+}
+
+bool WindowListModel::Remove(uint64_t id) {
+    if (windows_.erase(id) == 0) {
+        return false;
+    }
+    order_.erase(std::remove(order_.begin(), order_.end(), id), order_.end());
+    MarkRemoved(id);
+    return true;
+}
+
+void WindowListModel::MarkRemoved(uint64_t id) {
+    auto pending = pending_.find(id);
+    if (pending != pending_.end() && pending->second == Change::kAdded) {
+        // 还没推送过就消失了
+        pending_.erase(pending);
+        return;
+    }
+    pending_[id] = Change::kRemoved;
+}
+
+const WindowRecord* WindowListModel::Find(uint64_t id) const {
+    auto it = windows_.find(id);
+    return it == windows_.end() ? nullptr : &it->second;
+}
+
+WindowListDiff WindowListModel::TakeDiff() {
+    WindowListDiff diff;
+    for (const auto& entry : pending_) {
+        if (entry.second == Change::kRemoved) {
+            diff.removed.push_back(entry.first);
+        }
+    }
+    for (uint64_t id : order_) {
+        auto pending = pending_.find(id);
+        if (pending == pending_.end()) {
+            continue;
+        }
+        const WindowRecord& window = windows_.at(id);
+        if (pending->second == Change::kAdded) {
+            diff.added.push_back(window);
+        } else if (pending->second == Change::kUpdated) {
+            diff.updated.push_back(window);
+        }
+    }
+    pending_.clear();
+    return diff;
+}
+
+std::vector<WindowRecord> WindowListModel::Snapshot() const {
+    std::vector<WindowRecord> windows;
+    windows.reserve(order_.size());
+    for (uint64_t id : order_) {
+        windows.push_back(windows_.at(id));
+    }
+    return windows;
+}
+
+}  // namespace capture_core
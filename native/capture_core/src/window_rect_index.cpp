@@ -0,0 +1,102 @@
+#include "capture_core/window_rect_index.h"
+
+#include <algorithm>
+
+namespace capture_core {
+
+WindowRectIndex::WindowRectIndex(const Rect& bounds, int cell_size) {
+    Reset(bounds, cell_size);
+}
+
+void WindowRectIndex::Reset(const Rect& bounds, int cell_size) {
+    entries_.clear();
+    cells_.clear();
+    bounds_ = bounds.empty() ? Rect() : bounds;
+    cell_size_ = std::max(cell_size, 1);
+    columns_ = 0;
+    rows_ = 0;
+    if (bounds_.empty()) {
+        return;
+    }
+    for (;;) {
+        columns_ = (bounds_.width + cell_size_ - 1) / cell_size_;
+        rows_ = (bounds_.height + cell_size_ - 1) / cell_size_;
+        if (static_cast<int64_t>(columns_) * rows_ <= kMaxCells) {
+            break;
+        }
+        cell_size_ *= 2;
+    }
+    cells_.resize(static_cast<size_t>(columns_) * rows_);
+}
+
+int WindowRectIndex::Add(uint64_t id, const Rect& rect, int parent) {
+    if (parent >= static_cast<int>(entries_.size())) {
+        return -1;
+    }
+    WindowRectEntry entry;
+    entry.id = id;
+    entry.parent = parent < 0 ? -1 : parent;
+    entry.depth = parent < 0 ? 0 : entries_[parent].depth + 1;
+    entry.rect = IntersectRects(rect, parent < 0 ? bounds_ : entries_[parent].rect);
+    if (entry.rect.empty()) {
+        return -1;
+    }
+
+    const int index = static_cast<int>(entries_.size());
+    entries_.push_back(entry);
+    // 裁剪后一定在 bounds 以内
+    const int first_column = (entry.rect.x - bounds_.x) / cell_size_;
+    const int last_column = (entry.rect.right() - 1 - bounds_.x) / cell_size_;
+    const int first_row = (entry.rect.y - bounds_.y) / cell_size_;
+    const int last_row = (entry.rect.bottom() - 1 - bounds_.y) / cell_size_;
+    for (int row = first_row; row <= last_row; row++) {
+        for (int column = first_column; column <= last_column; column++) {
+            cells_[static_cast<size_t>(row) * columns_ + column].push_back(index);
+        }
+    }
+    return index;
+}
+
+const std::vector<int>* WindowRectIndex::CellAt(int x, int y) const {
+    if (!bounds_.Contains(x, y)) {
+        return nullptr;
+    }
+    const int column = (x - bounds_.x) / cell_size_;
+    const int row = (y - bounds_.y) / cell_size_;
+    return &cells_[static_cast<size_t>(row) * columns_ + column];
+}
+
+int WindowRectIndex::TopLevelAt(int x, int y) const {
+    return DeepestAt(x, y, 0);
+}
+
+int WindowRectIndex::DeepestAt(int x, int y, int max_depth) const {
+    const std::vector<int>* cell = CellAt(x, y);
+    if (cell == nullptr) {
+        return -1;
+    }
+    // 格子里的下标按添加顺序排列，子控件总在父元素之后：
+    // 一遍扫描先遇到最上层的顶层窗口，之后只接受当前元素的子控件，同一层里先遇到的在上面
+    int current = -1;
+    for (int index : *cell) {
+        const WindowRectEntry& entry = entries_[index];
+        if (entry.parent != current || !entry.rect.Contains(x, y)) {
+            continue;
+        }
+        current = index;
+        if (entry.depth >= max_depth) {
+            break;
+        }
+    }
+    return current;
+}
+
+size_t WindowRectIndex::max_cell_entries() const {
+    size_t most = 0;
+    for (const std::vector<int>& cell : cells_) {
+        most = std::max(most, cell.size());
+    }
+    return most;
+}
+
+}  // namespace capture_core
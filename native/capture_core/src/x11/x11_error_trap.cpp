@@ -0,0 +1,37 @@
+#include "x11_error_trap.h"
+
+namespace capture_core {
+namespace internal {
+
+namespace {
+
+std::mutex g_x_error_mutex;
+bool g_x_error = false;
+
+int RecordXError(Display*, XErrorEvent*) {
+    g_x_error = true;
+    return 0;
+}
+
+}  // namespace
+
+ScopedXErrorTrap::ScopedXErrorTrap(Display* display)
+    : display_(display), lock_(g_x_error_mutex) {
+    g_x_error = false;
+    old_handler_ = XSetErrorHandler(RecordXError);
+}
+
+ScopedXErrorTrap::~ScopedXErrorTrap() {
+    XSync(display_, False);
+    XSetErrorHandler(old_handler_);
+}
+
+bool ScopedXErrorTrap::Sync() {
+    XSync(display_, False);
+    const bool failed = g_x_error;
+    g_x_error = false;
+    return failed;
+}
+
+}  // namespace internal
+}  // namespace capture_core
@@ -0,0 +1,36 @@
+#ifndef CAPTURE_CORE_X11_ERROR_TRAP_H_
+#define CAPTURE_CORE_X11_ERROR_TRAP_H_
+
+#include <mutex>
+
+#include <X11/Xlib.h>
+
+namespace capture_core {
+namespace internal {
+
+// 在作用域内捕获 X 协议错误，而不是让默认处理器结束进程
+// （例如 XShmAttach 在远程显示上返回 BadAccess，查询属性时窗口已经销毁）。
+// 错误处理器是进程全局的，所有连接的捕获过程共用一把锁串行执行，
+// 所以作用域内只应有短暂的请求，不能等待事件。
+class ScopedXErrorTrap {
+public:
+    explicit ScopedXErrorTrap(Display* display);
+    // 同步后恢复原来的处理器
+    ~ScopedXErrorTrap();
+
+    ScopedXErrorTrap(const ScopedXErrorTrap&) = delete;
+    ScopedXErrorTrap& operator=(const ScopedXErrorTrap&) = delete;
+
+    // 等服务器处理完已发出的请求，返回此前是否出现过错误，并清除标记
+    bool Sync();
+
+private:
+    Display* display_;
+    std::unique_lock<std::mutex> lock_;
+    XErrorHandler old_handler_;
+};
+
+}  // namespace internal
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_X11_ERROR_TRAP_H_
@@ -0,0 +1,78 @@
+#include "capture_core/x11_monitors.h"
+
+#include <X11/Xlib.h>
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+#include <X11/extensions/Xrandr.h>
+#endif
+
+namespace capture_core {
+
+namespace {
+
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+void AppendRandrMonitors(Display* display, Window root, std::vector<MonitorInfo>* monitors) {
+    int event_base = 0;
+    int error_base = 0;
+    int major = 0;
+    int minor = 0;
+    if (!XRRQueryExtension(display, &event_base, &error_base) ||
+        !XRRQueryVersion(display, &major, &minor) ||
+        major < 1 || (major == 1 && minor < 5)) {
+        return;
+    }
+
+    int count = 0;
+    XRRMonitorInfo* infos = XRRGetMonitors(display, root, True, &count);
+    if (infos == nullptr) {
+        return;
+    }
+    for (int i = 0; i < count; i++) {
+        MonitorInfo monitor;
+        monitor.index = static_cast<int>(monitors->size());
+        monitor.bounds = Rect(infos[i].x, infos[i].y, infos[i].width, infos[i].height);
+        monitor.primary = infos[i].primary != False;
+        if (infos[i].name != 0) {
+            char* name = XGetAtomName(display, infos[i].name);
+            if (name != nullptr) {
+                monitor.name = name;
+                XFree(name);
+            }
+        }
+        if (!monitor.bounds.empty()) {
+            monitors->push_back(monitor);
+        }
+    }
+    XRRFreeMonitors(infos);
+}
+#endif
+
+}  // namespace
+
+std::vector<MonitorInfo> EnumerateX11Monitors(const char* display_name) {
+    std::vector<MonitorInfo> monitors;
+    Display* display = XOpenDisplay(display_name);
+    if (display == nullptr) {
+        return monitors;
+    }
+    Window root = DefaultRootWindow(display);
+
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+    AppendRandrMonitors(display, root, &monitors);
+#endif
+
+    if (monitors.empty()) {
+        XWindowAttributes attributes;
+        if (XGetWindowAttributes(display, root, &attributes)) {
+            MonitorInfo monitor;
+            monitor.bounds = Rect(0, 0, attributes.width, attributes.height);
+            monitor.primary = true;
+            monitor.name = "default";
+            monitors.push_back(monitor);
+        }
+    }
+
+    XCloseDisplay(display);
+    return monitors;
+}
+
+}  // namespace capture_core
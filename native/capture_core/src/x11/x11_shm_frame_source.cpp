@@ -0,0 +1,407 @@
+#include "capture_core/x11_shm_frame_source.h"
+
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+#include <cstring>
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+#ifdef CAPTURE_CORE_HAS_XCOMPOSITE
+#include <X11/extensions/Xcomposite.h>
+#endif
+
+#include "x11_error_trap.h"
+
+namespace capture_core {
+
+namespace {
+
+// 把 mask 对应的分量归一化到 8 位
+inline uint8_t ExtractChannel(unsigned long pixel, unsigned long mask) {
+    if (mask == 0) return 0;
+    int shift = 0;
+    while (((mask >> shift) & 1) == 0) shift++;
+    unsigned long value = (pixel & mask) >> shift;
+    unsigned long max = mask >> shift;
+    return static_cast<uint8_t>((value * 255) / max);
+}
+
+}  // namespace
+
+struct X11ShmFrameSource::Impl {
+    Display* display = nullptr;
+    Window root = 0;
+    Visual* visual = nullptr;
+    int depth = 0;
+
+    bool shm_available = false;
+    Rect capture_area;
+    XShmSegmentInfo shm_info = {};
+    size_t segment_size = 0;
+    int segment_allocations = 0;
+
+    // 当前尺寸和深度对应的 XImage 头，指向共享内存段
+    XImage* shm_image = nullptr;
+
+    // 窗口来源（ForWindow）；0 表示整个屏幕
+    Window window = 0;
+    bool composite = false;
+    // 窗口当前的离屏像素图，窗口尺寸变化后重新获取
+    Pixmap pixmap = 0;
+    int pixmap_width = 0;
+    int pixmap_height = 0;
+
+    ~Impl() {
+        DestroyShmImage();
+        ReleaseSegment();
+        if (display) {
+            ReleaseWindow();
+            XCloseDisplay(display);
+        }
+    }
+
+    void FreePixmap() {
+        if (pixmap != 0) {
+            XFreePixmap(display, pixmap);
+            pixmap = 0;
+        }
+    }
+
+    void ReleaseWindow() {
+#ifdef CAPTURE_CORE_HAS_XCOMPOSITE
+        if (composite) {
+            // 窗口可能已经销毁
+            internal::ScopedXErrorTrap trap(display);
+            FreePixmap();
+            XCompositeUnredirectWindow(display, window, CompositeRedirectAutomatic);
+        }
+#endif
+    }
+
+    void DestroyShmImage() {
+        if (shm_image) {
+            // 数据属于共享内存段，不能让 XDestroyImage 释放
+            shm_image->data = nullptr;
+            XDestroyImage(shm_image);
+            shm_image = nullptr;
+        }
+    }
+
+    void ReleaseSegment() {
+        if (segment_size == 0) return;
+        XShmDetach(display, &shm_info);
+        XSync(display, False);
+        shmdt(shm_info.shmaddr);
+        shm_info = {};
+        segment_size = 0;
+    }
+
+    // 确保共享内存段至少有 bytes 字节；只在需要变大时重新创建
+    bool EnsureSegment(size_t bytes) {
+        if (segment_size >= bytes) return true;
+
+        DestroyShmImage();
+        ReleaseSegment();
+
+        int id = shmget(IPC_PRIVATE, bytes, IPC_CREAT | 0600);
+        if (id < 0) return false;
+        void* addr = shmat(id, nullptr, 0);
+        // 立即标记删除，进程退出或 detach 后系统自动回收
+        shmctl(id, IPC_RMID, nullptr);
+        if (addr == reinterpret_cast<void*>(-1)) return false;
+
+        shm_info.shmid = id;
+        shm_info.shmaddr = static_cast<char*>(addr);
+        shm_info.readOnly = False;
+
+        // XShmAttach 失败时通过错误处理器报告（例如远程显示返回 BadAccess）
+        bool failed;
+        {
+            internal::ScopedXErrorTrap trap(display);
+            Bool attached = XShmAttach(display, &shm_info);
+            failed = trap.Sync() || !attached;
+        }
+        if (failed) {
+            shmdt(addr);
+            shm_info = {};
+            return false;
+        }
+
+        segment_size = bytes;
+        segment_allocations++;
+        return true;
+    }
+
+    // 共享内存段按 area（整个屏幕、capture_area 或窗口）分配，之后的区域都落在同一段内；
+    // 常见的 32 位格式直接让 frame 指向共享内存段，不再拷贝。
+    // 窗口来源的 drawable 随时可能失效，trap_errors 时在错误捕获内读取
+    bool CaptureShm(Drawable drawable, Visual* image_visual, int image_depth, const Rect& region,
+                    const Rect& area, bool trap_errors, FrameBuffer* frame) {
+        size_t bytes = static_cast<size_t>(area.width) * area.height * 4;
+        size_t region_bytes = static_cast<size_t>(region.width) * region.height * 4;
+        if (!EnsureSegment(bytes > region_bytes ? bytes : region_bytes)) {
+            return false;
+        }
+        if (!shm_image || shm_image->width != region.width ||
+            shm_image->height != region.height || shm_image->depth != image_depth) {
+            DestroyShmImage();
+            shm_image = XShmCreateImage(display, image_visual, image_depth, ZPixmap, nullptr,
+                                        &shm_info, region.width, region.height);
+            if (!shm_image) return false;
+            shm_image->data = shm_info.shmaddr;
+        }
+        if (trap_errors) {
+            internal::ScopedXErrorTrap trap(display);
+            Bool got = XShmGetImage(display, drawable, shm_image, region.x, region.y, AllPlanes);
+            if (trap.Sync() || !got) return false;
+        } else if (!XShmGetImage(display, drawable, shm_image, region.x, region.y, AllPlanes)) {
+            return false;
+        }
+        if (IsBgrx(shm_image)) {
+            frame->Wrap(reinterpret_cast<uint8_t*>(shm_image->data), shm_image->width,
+                        shm_image->height, shm_image->bytes_per_line, PixelFormat::kBgrx8);
+            return true;
+        }
+        return CopyImage(shm_image, frame);
+    }
+
+    bool CaptureGetImage(Drawable drawable, const Rect& region, bool trap_errors,
+                         FrameBuffer* frame) {
+        XImage* image = nullptr;
+        if (trap_errors) {
+            internal::ScopedXErrorTrap trap(display);
+            image = XGetImage(display, drawable, region.x, region.y, region.width,
+                              region.height, AllPlanes, ZPixmap);
+            if (trap.Sync() && image) {
+                XDestroyImage(image);
+                image = nullptr;
+            }
+        } else {
+            image = XGetImage(display, drawable, region.x, region.y, region.width,
+                              region.height, AllPlanes, ZPixmap);
+        }
+        if (!image) return false;
+        bool ok = CopyImage(image, frame);
+        XDestroyImage(image);
+        return ok;
+    }
+
+    Rect ScreenBounds() {
+        XWindowAttributes attributes;
+        if (!XGetWindowAttributes(display, root, &attributes)) {
+            return Rect();
+        }
+        return Rect(0, 0, attributes.width, attributes.height);
+    }
+
+    // 窗口的属性和在根窗口中的位置；窗口已销毁或没有映射时返回 false
+    bool QueryWindow(XWindowAttributes* attributes, int* root_x, int* root_y) {
+        internal::ScopedXErrorTrap trap(display);
+        if (!XGetWindowAttributes(display, window, attributes) ||
+            attributes->map_state != IsViewable) {
+            return false;
+        }
+        Window child = 0;
+        XTranslateCoordinates(display, window, root, 0, 0, root_x, root_y, &child);
+        return !trap.Sync();
+    }
+
+    // 从 drawable 的 region 读取；MIT-SHM 段附加失败时之后都走 XGetImage
+    bool Grab(Drawable drawable, Visual* image_visual, int image_depth, const Rect& region,
+              const Rect& area, bool trap_errors, FrameBuffer* frame) {
+        if (shm_available) {
+            if (CaptureShm(drawable, image_visual, image_depth, region, area, trap_errors,
+                           frame)) {
+                return true;
+            }
+            // 窗口在读取时失效不代表 MIT-SHM 不可用
+            if (trap_errors && segment_size != 0) {
+                return false;
+            }
+            // 附加失败（如远程显示），之后都走 XGetImage
+            DestroyShmImage();
+            ReleaseSegment();
+            shm_available = false;
+        }
+        return CaptureGetImage(drawable, region, trap_errors, frame);
+    }
+
+    bool CaptureWindow(const Rect& region, FrameBuffer* frame) {
+        XWindowAttributes attributes;
+        int root_x = 0;
+        int root_y = 0;
+        if (!QueryWindow(&attributes, &root_x, &root_y)) {
+            FreePixmap();
+            return false;
+        }
+        const Rect bounds(0, 0, attributes.width, attributes.height);
+        const Rect clipped = IntersectRects(region, bounds);
+        if (clipped.empty()) {
+            return false;
+        }
+
+#ifdef CAPTURE_CORE_HAS_XCOMPOSITE
+        if (composite) {
+            // 窗口尺寸变化后旧的像素图不再跟随窗口
+            if (pixmap == 0 || pixmap_width != attributes.width ||
+                pixmap_height != attributes.height) {
+                internal::ScopedXErrorTrap trap(display);
+                FreePixmap();
+                pixmap = XCompositeNameWindowPixmap(display, window);
+                if (trap.Sync()) {
+                    pixmap = 0;
+                }
+                pixmap_width = attributes.width;
+                pixmap_height = attributes.height;
+            }
+            // 获取失败（例如窗口刚取消映射）时这次退回屏幕截取，下次重试
+            if (pixmap != 0) {
+                return Grab(pixmap, attributes.visual, attributes.depth, clipped, bounds, true,
+                            frame);
+            }
+            pixmap_width = 0;
+            pixmap_height = 0;
+        }
+#endif
+
+        // 没有 XComposite：截取屏幕上窗口可见的部分
+        const Rect on_screen = IntersectRects(
+            Rect(root_x + clipped.x, root_y + clipped.y, clipped.width, clipped.height),
+            ScreenBounds());
+        if (on_screen.empty()) {
+            return false;
+        }
+        return Grab(root, visual, depth, on_screen, bounds, true, frame);
+    }
+
+    // 内存布局就是 kBgrx8 的 32 位 TrueColor
+    static bool IsBgrx(const XImage* image) {
+        return image->bits_per_pixel == 32 && image->byte_order == LSBFirst &&
+               image->red_mask == 0xFF0000 && image->green_mask == 0xFF00 &&
+               image->blue_mask == 0xFF;
+    }
+
+    // 把 XImage 拷贝成 kBgrx8；常见的 32 位 TrueColor 直接逐行拷贝
+    static bool CopyImage(XImage* image, FrameBuffer* frame) {
+        frame->Allocate(image->width, image->height, PixelFormat::kBgrx8);
+        const size_t row_bytes = static_cast<size_t>(image->width) * 4;
+
+        if (IsBgrx(image)) {
+            for (int y = 0; y < image->height; y++) {
+                std::memcpy(frame->row(y), image->data + static_cast<size_t>(y) * image->bytes_per_line,
+                            row_bytes);
+            }
+            return true;
+        }
+
+        // 其他视觉类型（如 16 位）走逐像素的慢路径
+        for (int y = 0; y < image->height; y++) {
+            uint8_t* out = frame->row(y);
+            for (int x = 0; x < image->width; x++, out += 4) {
+                unsigned long pixel = XGetPixel(image, x, y);
+                out[0] = ExtractChannel(pixel, image->blue_mask);
+                out[1] = ExtractChannel(pixel, image->green_mask);
+                out[2] = ExtractChannel(pixel, image->red_mask);
+                out[3] = 0;
+            }
+        }
+        return true;
+    }
+};
+
+X11ShmFrameSource::X11ShmFrameSource(const char* display_name, const Rect& capture_area)
+    : impl_(new Impl) {
+    impl_->capture_area = capture_area;
+    impl_->display = XOpenDisplay(display_name);
+    if (!impl_->display) {
+        return;
+    }
+    int screen = DefaultScreen(impl_->display);
+    impl_->root = RootWindow(impl_->display, screen);
+    impl_->visual = DefaultVisual(impl_->display, screen);
+    impl_->depth = DefaultDepth(impl_->display, screen);
+    impl_->shm_available = XShmQueryExtension(impl_->display) == True;
+}
+
+std::unique_ptr<X11ShmFrameSource> X11ShmFrameSource::ForWindow(uint64_t window,
+                                                                const char* display_name) {
+    std::unique_ptr<X11ShmFrameSource> source(new X11ShmFrameSource(display_name));
+    Impl* impl = source->impl_.get();
+    if (!impl->display) {
+        return source;
+    }
+    impl->window = static_cast<Window>(window);
+#ifdef CAPTURE_CORE_HAS_XCOMPOSITE
+    // NameWindowPixmap 需要 Composite 0.2
+    int event_base = 0;
+    int error_base = 0;
+    int major = 0;
+    int minor = 2;
+    if (XCompositeQueryExtension(impl->display, &event_base, &error_base) &&
+        XCompositeQueryVersion(impl->display, &major, &minor) &&
+        (major > 0 || minor >= 2)) {
+        internal::ScopedXErrorTrap trap(impl->display);
+        XCompositeRedirectWindow(impl->display, impl->window, CompositeRedirectAutomatic);
+        impl->composite = !trap.Sync();
+    }
+#endif
+    return source;
+}
+
+X11ShmFrameSource::~X11ShmFrameSource() = default;
+
+bool X11ShmFrameSource::is_open() const {
+    return impl_->display != nullptr;
+}
+
+bool X11ShmFrameSource::using_shm() const {
+    return impl_->shm_available;
+}
+
+bool X11ShmFrameSource::using_composite() const {
+    return impl_->composite;
+}
+
+size_t X11ShmFrameSource::segment_size() const {
+    return impl_->segment_size;
+}
+
+int X11ShmFrameSource::segment_allocations() const {
+    return impl_->segment_allocations;
+}
+
+Rect X11ShmFrameSource::GetBounds() {
+    if (!impl_->display) {
+        return Rect();
+    }
+    if (impl_->window != 0) {
+        XWindowAttributes attributes;
+        int root_x = 0;
+        int root_y = 0;
+        if (!impl_->QueryWindow(&attributes, &root_x, &root_y)) {
+            return Rect();
+        }
+        return Rect(0, 0, attributes.width, attributes.height);
+    }
+    return impl_->ScreenBounds();
+}
+
+bool X11ShmFrameSource::Capture(const Rect& region, FrameBuffer* frame) {
+    if (!impl_->display || frame == nullptr) {
+        return false;
+    }
+    if (impl_->window != 0) {
+        return impl_->CaptureWindow(region, frame);
+    }
+    Rect screen = impl_->ScreenBounds();
+    Rect clipped = IntersectRects(region, screen);
+    if (clipped.empty()) {
+        return false;
+    }
+    const Rect& area = impl_->capture_area.empty() ? screen : impl_->capture_area;
+    return impl_->Grab(impl_->root, impl_->visual, impl_->depth, clipped, area, false, frame);
+}
+
+}  // namespace capture_core
@@ -0,0 +1,38 @@
+#ifndef CAPTURE_CORE_X11_WINDOW_DESCRIBE_H_
+#define CAPTURE_CORE_X11_WINDOW_DESCRIBE_H_
+
+#include <vector>
+
+#include <X11/Xlib.h>
+
+#include "capture_core/window_list.h"
+
+namespace capture_core {
+namespace internal {
+
+// 描述窗口用到的 EWMH 原子
+struct X11WindowAtoms {
+    explicit X11WindowAtoms(Display* display);
+
+    Atom net_client_list;
+    Atom net_wm_name;
+    Atom net_wm_icon;
+    Atom net_wm_state;
+    Atom state_hidden;
+    Atom state_skip_taskbar;
+    Atom utf8_string;
+};
+
+// 根窗口的 _NET_CLIENT_LIST，最近映射的在前
+std::vector<Window> ReadClientList(Display* display, Window root, const X11WindowAtoms& atoms);
+
+// 描述一个顶层窗口（过滤规则见 EnumerateX11Windows）。窗口已销毁或不符合条件时返回 false。
+// read_icon 为 false 时不读取 _NET_WM_ICON，record->icon 保持不变。
+// 请求都在 ScopedXErrorTrap 内进行，窗口随时被销毁也不会触发默认错误处理器
+bool DescribeX11Window(Display* display, Window root, const X11WindowAtoms& atoms,
+                       Window window, bool read_icon, WindowRecord* record);
+
+}  // namespace internal
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_X11_WINDOW_DESCRIBE_H_
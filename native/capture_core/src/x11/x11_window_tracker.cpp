@@ -0,0 +1,290 @@
+#include "capture_core/x11_window_tracker.h"
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+
+#include "x11_error_trap.h"
+#include "x11_window_describe.h"
+
+namespace capture_core {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+}  // namespace
+
+struct X11WindowTracker::Impl {
+    std::string display_name;
+    bool has_display_name = false;
+
+    Display* display = nullptr;
+    Window root = 0;
+    std::unique_ptr<internal::X11WindowAtoms> atoms;
+
+    Callback callback;
+    std::chrono::milliseconds coalesce{0};
+    std::thread thread;
+    int wake_pipe[2] = {-1, -1};
+    std::atomic<bool> running{false};
+
+    // 只在跟踪线程上访问（启动前在调用线程上）
+    // _NET_CLIENT_LIST 里的全部窗口（包括不符合条件的，它们的事件仍要监听）
+    std::unordered_set<Window> clients;
+    bool list_dirty = false;
+    std::vector<Window> dirty_windows;
+    std::unordered_set<Window> icon_dirty;
+    Clock::time_point dirty_since;
+
+    mutable std::mutex mutex;
+    WindowListModel model;
+
+    bool Open() {
+        display = XOpenDisplay(has_display_name ? display_name.c_str() : nullptr);
+        if (display == nullptr) return false;
+        root = DefaultRootWindow(display);
+        atoms.reset(new internal::X11WindowAtoms(display));
+        return true;
+    }
+
+    void Close() {
+        if (display != nullptr) {
+            XCloseDisplay(display);
+            display = nullptr;
+        }
+        for (int& fd : wake_pipe) {
+            if (fd >= 0) close(fd);
+            fd = -1;
+        }
+        atoms.reset();
+        clients.clear();
+        dirty_windows.clear();
+        icon_dirty.clear();
+        list_dirty = false;
+    }
+
+    // 窗口可能随时被销毁，请求都在错误捕获内进行
+    void Watch(Window window) {
+        internal::ScopedXErrorTrap trap(display);
+        XSelectInput(display, window, PropertyChangeMask | StructureNotifyMask);
+    }
+
+    std::vector<Window> ReadClientList() {
+        return internal::ReadClientList(display, root, *atoms);
+    }
+
+    // 图标只在窗口第一次出现或 _NET_WM_ICON 变化时读取和编码，移动、改名时沿用已有的
+    bool Describe(Window window, WindowRecord* record) {
+        bool read_icon = true;
+        if (icon_dirty.erase(window) == 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (const WindowRecord* existing = model.Find(window)) {
+                record->icon = existing->icon;
+                read_icon = false;
+            }
+        }
+        return internal::DescribeX11Window(display, root, *atoms, window, read_icon, record);
+    }
+
+    // 启动时同步读取，差异丢弃（调用方通过 Snapshot 取初始列表）
+    void LoadInitialList() {
+        std::vector<WindowRecord> records;
+        for (Window window : ReadClientList()) {
+            clients.insert(window);
+            Watch(window);
+            WindowRecord record;
+            if (Describe(window, &record)) {
+                records.push_back(std::move(record));
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        model.Reset(std::move(records));
+        model.TakeDiff();
+    }
+
+    void MarkDirty(Window window) {
+        if (clients.count(window) == 0) return;
+        if (!list_dirty && dirty_windows.empty()) dirty_since = Clock::now();
+        if (std::find(dirty_windows.begin(), dirty_windows.end(), window) == dirty_windows.end()) {
+            dirty_windows.push_back(window);
+        }
+    }
+
+    void HandleEvent(const XEvent& event) {
+        switch (event.type) {
+            case PropertyNotify: {
+                const XPropertyEvent& property = event.xproperty;
+                if (property.window == root) {
+                    if (property.atom == atoms->net_client_list) {
+                        if (!list_dirty && dirty_windows.empty()) dirty_since = Clock::now();
+                        list_dirty = true;
+                    }
+                } else if (property.atom == atoms->net_wm_icon) {
+                    if (clients.count(property.window) != 0) icon_dirty.insert(property.window);
+                    MarkDirty(property.window);
+                } else if (property.atom == atoms->net_wm_name || property.atom == XA_WM_NAME ||
+                           property.atom == XA_WM_CLASS || property.atom == atoms->net_wm_state) {
+                    MarkDirty(property.window);
+                }
+                break;
+            }
+            case ConfigureNotify:
+                MarkDirty(event.xconfigure.window);
+                break;
+            case MapNotify:
+                MarkDirty(event.xmap.window);
+                break;
+            case UnmapNotify:
+                MarkDirty(event.xunmap.window);
+                break;
+            case DestroyNotify:
+                MarkDirty(event.xdestroywindow.window);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // 处理一批合并后的事件，有变化时回调
+    void Flush() {
+        std::vector<WindowRecord> described;
+        std::vector<Window> gone;
+        if (list_dirty) {
+            std::vector<Window> list = ReadClientList();
+            std::unordered_set<Window> current(list.begin(), list.end());
+            for (Window window : clients) {
+                if (current.count(window) == 0) gone.push_back(window);
+            }
+            // 倒序处理新窗口，Upsert 逐个插到最前后保持列表顺序
+            for (auto it = list.rbegin(); it != list.rend(); ++it) {
+                if (clients.count(*it) == 0) {
+                    Watch(*it);
+                    dirty_windows.push_back(*it);
+                }
+            }
+            clients = std::move(current);
+            list_dirty = false;
+        }
+        for (Window window : dirty_windows) {
+            WindowRecord record;
+            if (clients.count(window) != 0 && Describe(window, &record)) {
+                described.push_back(std::move(record));
+            } else {
+                gone.push_back(window);
+            }
+        }
+        dirty_windows.clear();
+
+        WindowListDiff diff;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (Window window : gone) {
+                model.Remove(window);
+            }
+            for (WindowRecord& record : described) {
+                model.Upsert(std::move(record));
+            }
+            diff = model.TakeDiff();
+        }
+        if (!diff.empty() && callback) {
+            callback(diff);
+        }
+    }
+
+    void Run() {
+        const int x_fd = ConnectionNumber(display);
+        while (true) {
+            // XPending 同时把缓冲的请求发出去
+            while (XPending(display) > 0) {
+                XEvent event;
+                XNextEvent(display, &event);
+                HandleEvent(event);
+            }
+
+            int timeout_ms = -1;
+            if (list_dirty || !dirty_windows.empty()) {
+                auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    dirty_since + coalesce - Clock::now());
+                if (remaining.count() <= 0) {
+                    Flush();
+                    continue;
+                }
+                timeout_ms = static_cast<int>(remaining.count());
+            }
+
+            pollfd fds[2] = {{x_fd, POLLIN, 0}, {wake_pipe[0], POLLIN, 0}};
+            if (poll(fds, 2, timeout_ms) < 0 && errno != EINTR) {
+                return;
+            }
+            if (fds[1].revents != 0) {
+                return;
+            }
+        }
+    }
+};
+
+X11WindowTracker::X11WindowTracker(const char* display_name) : impl_(new Impl()) {
+    if (display_name != nullptr) {
+        impl_->display_name = display_name;
+        impl_->has_display_name = true;
+    }
+}
+
+X11WindowTracker::~X11WindowTracker() { Stop(); }
+
+bool X11WindowTracker::Start(Callback callback, std::chrono::milliseconds coalesce) {
+    if (impl_->running || !impl_->Open()) {
+        return false;
+    }
+    if (pipe(impl_->wake_pipe) != 0) {
+        impl_->Close();
+        return false;
+    }
+    impl_->callback = std::move(callback);
+    impl_->coalesce = coalesce;
+
+    // 先监听根窗口再读列表，读取期间的变化不会丢
+    XSelectInput(impl_->display, impl_->root, PropertyChangeMask);
+    impl_->LoadInitialList();
+
+    impl_->running = true;
+    impl_->thread = std::thread([this] { impl_->Run(); });
+    return true;
+}
+
+void X11WindowTracker::Stop() {
+    if (!impl_->running) {
+        return;
+    }
+    const char wake = 1;
+    ssize_t written = write(impl_->wake_pipe[1], &wake, 1);
+    (void)written;
+    impl_->thread.join();
+    impl_->running = false;
+    impl_->Close();
+    impl_->callback = nullptr;
+
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->model = WindowListModel();
+}
+
+bool X11WindowTracker::running() const { return impl_->running; }
+
+std::vector<WindowRecord> X11WindowTracker::Snapshot() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->model.Snapshot();
+}
+
+}  // namespace capture_core
@@ -0,0 +1,179 @@
+#include "capture_core/x11_windows.h"
+
+#include <string>
+#include <utility>
+
+#include <X11/Xatom.h>
+#include <X11/Xutil.h>
+
+#include "capture_core/png_encoder.h"
+#include "capture_core/window_icon.h"
+#include "x11_error_trap.h"
+#include "x11_window_describe.h"
+
+namespace capture_core {
+
+namespace {
+
+// 太小的窗口（工具提示、拖放图标）不出现在选择器里
+constexpr int kMinWindowWidth = 100;
+constexpr int kMinWindowHeight = 50;
+
+// 32 位格式的属性（窗口、原子、CARDINAL 列表），Xlib 以 long 数组返回
+std::vector<unsigned long> ReadLongProperty(Display* display, Window window, Atom property,
+                                            Atom type, long max_items) {
+    std::vector<unsigned long> values;
+    Atom actual_type = 0;
+    int actual_format = 0;
+    unsigned long count = 0;
+    unsigned long bytes_after = 0;
+    unsigned char* data = nullptr;
+    if (XGetWindowProperty(display, window, property, 0, max_items, False, type, &actual_type,
+                           &actual_format, &count, &bytes_after, &data) == Success &&
+        data != nullptr) {
+        if (actual_type == type && actual_format == 32) {
+            const unsigned long* longs = reinterpret_cast<const unsigned long*>(data);
+            values.assign(longs, longs + count);
+        }
+        XFree(data);
+    }
+    return values;
+}
+
+std::string ReadUtf8Property(Display* display, Window window, Atom property, Atom utf8_string) {
+    std::string text;
+    Atom actual_type = 0;
+    int actual_format = 0;
+    unsigned long count = 0;
+    unsigned long bytes_after = 0;
+    unsigned char* data = nullptr;
+    if (XGetWindowProperty(display, window, property, 0, 4096, False, utf8_string, &actual_type,
+                           &actual_format, &count, &bytes_after, &data) == Success &&
+        data != nullptr) {
+        if (actual_type == utf8_string && actual_format == 8) {
+            text.assign(reinterpret_cast<const char*>(data), count);
+        }
+        XFree(data);
+    }
+    return text;
+}
+
+// 旧客户端只设置 WM_NAME（可能是 COMPOUND_TEXT），转成 UTF-8
+std::string ReadWmName(Display* display, Window window) {
+    std::string text;
+    XTextProperty property;
+    if (XGetWMName(display, window, &property) == 0 || property.value == nullptr) {
+        return text;
+    }
+    char** list = nullptr;
+    int count = 0;
+    if (Xutf8TextPropertyToTextList(display, &property, &list, &count) >= Success &&
+        list != nullptr) {
+        if (count > 0 && list[0] != nullptr) {
+            text = list[0];
+        }
+        XFreeStringList(list);
+    }
+    XFree(property.value);
+    return text;
+}
+
+// _NET_WM_ICON 选一张缩成 kX11WindowIconSize 后直接编码成 PNG；
+// 属性常带 16 到 256 的多种尺寸，最多读 1M 项（约 4 张 512x512）
+std::vector<uint8_t> ReadIcon(Display* display, Window window, const internal::X11WindowAtoms& atoms) {
+    std::vector<uint8_t> png;
+    std::vector<unsigned long> data =
+        ReadLongProperty(display, window, atoms.net_wm_icon, XA_CARDINAL, 1 << 20);
+    FrameBuffer icon;
+    if (!data.empty() && SelectNetWmIcon(data.data(), data.size(), kX11WindowIconSize, &icon)) {
+        thread_local PngEncoder encoder;
+        if (!encoder.Encode(icon, &png)) {
+            png.clear();
+        }
+    }
+    return png;
+}
+
+}  // namespace
+
+namespace internal {
+
+X11WindowAtoms::X11WindowAtoms(Display* display)
+    : net_client_list(XInternAtom(display, "_NET_CLIENT_LIST", False)),
+      net_wm_name(XInternAtom(display, "_NET_WM_NAME", False)),
+      net_wm_icon(XInternAtom(display, "_NET_WM_ICON", False)),
+      net_wm_state(XInternAtom(display, "_NET_WM_STATE", False)),
+      state_hidden(XInternAtom(display, "_NET_WM_STATE_HIDDEN", False)),
+      state_skip_taskbar(XInternAtom(display, "_NET_WM_STATE_SKIP_TASKBAR", False)),
+      utf8_string(XInternAtom(display, "UTF8_STRING", False)) {}
+
+std::vector<Window> ReadClientList(Display* display, Window root, const X11WindowAtoms& atoms) {
+    std::vector<unsigned long> values =
+        ReadLongProperty(display, root, atoms.net_client_list, XA_WINDOW, 1 << 16);
+    // _NET_CLIENT_LIST 按映射顺序排列，反过来让最近的窗口在前
+    return std::vector<Window>(values.rbegin(), values.rend());
+}
+
+bool DescribeX11Window(Display* display, Window root, const X11WindowAtoms& atoms,
+                       Window window, bool read_icon, WindowRecord* record) {
+    ScopedXErrorTrap trap(display);
+    XWindowAttributes attributes;
+    if (XGetWindowAttributes(display, window, &attributes) == 0 ||
+        attributes.map_state != IsViewable || attributes.width < kMinWindowWidth ||
+        attributes.height < kMinWindowHeight) {
+        return false;
+    }
+    for (unsigned long state :
+         ReadLongProperty(display, window, atoms.net_wm_state, XA_ATOM, 64)) {
+        if (state == atoms.state_hidden || state == atoms.state_skip_taskbar) return false;
+    }
+
+    record->id = window;
+    record->title = ReadUtf8Property(display, window, atoms.net_wm_name, atoms.utf8_string);
+    if (record->title.empty()) {
+        record->title = ReadWmName(display, window);
+    }
+    if (record->title.empty()) return false;
+
+    record->app_name.clear();
+    XClassHint class_hint;
+    if (XGetClassHint(display, window, &class_hint) != 0) {
+        if (class_hint.res_class != nullptr) record->app_name = class_hint.res_class;
+        XFree(class_hint.res_name);
+        XFree(class_hint.res_class);
+    }
+
+    // 被窗口管理器重新设置父窗口后，attributes 的 x / y 相对于边框窗口
+    int x = 0;
+    int y = 0;
+    Window child = 0;
+    XTranslateCoordinates(display, window, root, 0, 0, &x, &y, &child);
+    record->bounds = Rect(x, y, attributes.width, attributes.height);
+
+    if (read_icon) {
+        record->icon = ReadIcon(display, window, atoms);
+    }
+    return !trap.Sync();
+}
+
+}  // namespace internal
+
+std::vector<WindowRecord> EnumerateX11Windows(const char* display_name) {
+    std::vector<WindowRecord> windows;
+    Display* display = XOpenDisplay(display_name);
+    if (display == nullptr) {
+        return windows;
+    }
+    const Window root = DefaultRootWindow(display);
+    const internal::X11WindowAtoms atoms(display);
+    for (Window window : internal::ReadClientList(display, root, atoms)) {
+        WindowRecord record;
+        if (internal::DescribeX11Window(display, root, atoms, window, true, &record)) {
+            windows.push_back(std::move(record));
+        }
+    }
+    XCloseDisplay(display);
+    return windows;
+}
+
+}  // namespace capture_core
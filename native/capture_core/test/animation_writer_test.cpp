@@ -0,0 +1,455 @@
+#include "capture_core/animation_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+namespace fs = std::filesystem;
+using std::chrono::milliseconds;
+
+// 测试用的 GIF 解码结果：每一帧合成后的整幅 RGB 画面
+struct DecodedGif {
+    int width = 0;
+    int height = 0;
+    bool loops = false;
+    std::vector<std::vector<uint8_t>> frames;  // RGB
+    std::vector<int> delays;                   // 10 ms 单位
+    std::vector<Rect> rects;
+};
+
+// 标准 GIF LZW 解码
+bool LzwDecode(const std::vector<uint8_t>& data, int min_code_size, size_t expected,
+               std::vector<uint8_t>* out) {
+    const int clear_code = 1 << min_code_size;
+    const int end_code = clear_code + 1;
+    std::vector<std::vector<uint8_t>> table;
+    auto reset = [&] {
+        table.assign(clear_code + 2, {});
+        for (int i = 0; i < clear_code; i++) table[i] = {static_cast<uint8_t>(i)};
+    };
+    reset();
+    int code_size = min_code_size + 1;
+    uint32_t bits = 0;
+    int count = 0;
+    size_t pos = 0;
+    int previous = -1;
+    out->clear();
+    for (;;) {
+        while (count < code_size) {
+            if (pos >= data.size()) return false;
+            bits |= uint32_t(data[pos++]) << count;
+            count += 8;
+        }
+        const int code = static_cast<int>(bits & ((1u << code_size) - 1));
+        bits >>= code_size;
+        count -= code_size;
+        if (code == clear_code) {
+            reset();
+            code_size = min_code_size + 1;
+            previous = -1;
+            continue;
+        }
+        if (code == end_code) break;
+        std::vector<uint8_t> entry;
+        if (code < static_cast<int>(table.size())) {
+            entry = table[code];
+            if (previous >= 0) {
+                std::vector<uint8_t> added = table[previous];
+                added.push_back(entry[0]);
+                table.push_back(added);
+            }
+        } else if (code == static_cast<int>(table.size()) && previous >= 0) {
+            entry = table[previous];
+            entry.push_back(table[previous][0]);
+            table.push_back(entry);
+        } else {
+            return false;
+        }
+        out->insert(out->end(), entry.begin(), entry.end());
+        previous = code;
+        if (static_cast<int>(table.size()) == (1 << code_size) && code_size < 12) {
+            code_size++;
+        }
+    }
+    return out->size() == expected;
+}
+
+bool DecodeGif(const std::vector<uint8_t>& gif, DecodedGif* decoded) {
+    if (gif.size() < 13 || std::memcmp(gif.data(), "GIF89a", 6) != 0) return false;
+    decoded->width = gif[6] | (gif[7] << 8);
+    decoded->height = gif[8] | (gif[9] << 8);
+    if (gif[10] & 0x80) return false;  // 写入器不用全局调色板
+    std::vector<uint8_t> canvas(static_cast<size_t>(decoded->width) * decoded->height * 3, 0);
+    size_t pos = 13;
+    int delay = 0;
+    int transparent = -1;
+    while (pos < gif.size()) {
+        const uint8_t kind = gif[pos++];
+        if (kind == 0x3B) return true;
+        if (kind == 0x21) {
+            const uint8_t label = gif[pos++];
+            if (label == 0xF9) {
+                delay = gif[pos + 2] | (gif[pos + 3] << 8);
+                transparent = (gif[pos + 1] & 1) ? gif[pos + 4] : -1;
+            } else if (label == 0xFF) {
+                decoded->loops = std::memcmp(&gif[pos + 1], "NETSCAPE2.0", 11) == 0;
+            }
+            while (gif[pos] != 0) pos += gif[pos] + 1;
+            pos++;
+            continue;
+        }
+        if (kind != 0x2C) return false;
+        const Rect rect(gif[pos] | (gif[pos + 1] << 8), gif[pos + 2] | (gif[pos + 3] << 8),
+                        gif[pos + 4] | (gif[pos + 5] << 8), gif[pos + 6] | (gif[pos + 7] << 8));
+        const uint8_t flags = gif[pos + 8];
+        pos += 9;
+        if (!(flags & 0x80)) return false;
+        const size_t table_size = size_t(1) << ((flags & 7) + 1);
+        const uint8_t* table = &gif[pos];
+        pos += table_size * 3;
+        const int min_code_size = gif[pos++];
+        std::vector<uint8_t> data;
+        while (gif[pos] != 0) {
+            data.insert(data.end(), gif.begin() + pos + 1, gif.begin() + pos + 1 + gif[pos]);
+            pos += gif[pos] + 1;
+        }
+        pos++;
+        std::vector<uint8_t> indices;
+        if (!LzwDecode(data, min_code_size, static_cast<size_t>(rect.width) * rect.height,
+                       &indices)) {
+            return false;
+        }
+        for (int y = 0; y < rect.height; y++) {
+            for (int x = 0; x < rect.width; x++) {
+                const int index = indices[static_cast<size_t>(y) * rect.width + x];
+                if (index == transparent) continue;
+                uint8_t* p = &canvas[(static_cast<size_t>(rect.y + y) * decoded->width +
+                                      rect.x + x) * 3];
+                std::memcpy(p, table + index * 3, 3);
+            }
+        }
+        decoded->frames.push_back(canvas);
+        decoded->delays.push_back(delay);
+        decoded->rects.push_back(rect);
+    }
+    return false;
+}
+
+uint32_t ReadBe32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+void AppendBe32(std::vector<uint8_t>* out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out->push_back(static_cast<uint8_t>(value >> shift));
+}
+
+void AppendChunk(std::vector<uint8_t>* out, const char* type, const uint8_t* data, size_t size) {
+    AppendBe32(out, static_cast<uint32_t>(size));
+    const size_t start = out->size();
+    out->insert(out->end(), type, type + 4);
+    out->insert(out->end(), data, data + size);
+    AppendBe32(out, static_cast<uint32_t>(crc32(0, out->data() + start,
+                                                static_cast<uInt>(size + 4))));
+}
+
+struct ApngFrame {
+    Rect rect;
+    int delay_num = 0;
+    int delay_den = 0;
+    testing::DecodedPng image;
+};
+
+struct DecodedApng {
+    uint32_t num_frames = 0;
+    uint32_t num_plays = 0;
+    std::vector<ApngFrame> frames;
+};
+
+// 解析 APNG：校验 CRC 和序号，把每一帧的数据拼成独立的 PNG 再解码
+bool DecodeApng(const std::vector<uint8_t>& apng, DecodedApng* decoded) {
+    static const uint8_t kSig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (apng.size() < 8 || std::memcmp(apng.data(), kSig, 8) != 0) return false;
+    std::vector<uint8_t> ihdr;
+    std::vector<uint8_t> data;
+    uint32_t expected_sequence = 0;
+    bool seen_iend = false;
+    auto flush = [&]() -> bool {
+        if (decoded->frames.empty() || data.empty()) return true;
+        ApngFrame& frame = decoded->frames.back();
+        std::vector<uint8_t> png(kSig, kSig + 8);
+        std::vector<uint8_t> header = ihdr;
+        header.resize(8);
+        std::vector<uint8_t> size;
+        AppendBe32(&size, static_cast<uint32_t>(frame.rect.width));
+        AppendBe32(&size, static_cast<uint32_t>(frame.rect.height));
+        std::memcpy(header.data(), size.data(), 8);
+        header.insert(header.end(), ihdr.begin() + 8, ihdr.end());
+        AppendChunk(&png, "IHDR", header.data(), header.size());
+        AppendChunk(&png, "IDAT", data.data(), data.size());
+        AppendChunk(&png, "IEND", nullptr, 0);
+        data.clear();
+        return testing::DecodePng(png, &frame.image);
+    };
+    size_t pos = 8;
+    while (pos + 12 <= apng.size()) {
+        const uint32_t length = ReadBe32(&apng[pos]);
+        const std::string type(reinterpret_cast<const char*>(&apng[pos + 4]), 4);
+        const uint8_t* body = &apng[pos + 8];
+        if (pos + 12 + length > apng.size()) return false;
+        if (ReadBe32(body + length) != crc32(0, &apng[pos + 4], length + 4)) return false;
+        pos += 12 + length;
+        if (type == "IHDR") {
+            ihdr.assign(body, body + length);
+        } else if (type == "acTL") {
+            decoded->num_frames = ReadBe32(body);
+            decoded->num_plays = ReadBe32(body + 4);
+        } else if (type == "fcTL") {
+            if (!flush() || ReadBe32(body) != expected_sequence++) return false;
+            ApngFrame frame;
+            frame.rect = Rect(static_cast<int>(ReadBe32(body + 12)),
+                              static_cast<int>(ReadBe32(body + 16)),
+                              static_cast<int>(ReadBe32(body + 4)),
+                              static_cast<int>(ReadBe32(body + 8)));
+            frame.delay_num = (body[20] << 8) | body[21];
+            frame.delay_den = (body[22] << 8) | body[23];
+            decoded->frames.push_back(frame);
+        } else if (type == "IDAT") {
+            data.insert(data.end(), body, body + length);
+        } else if (type == "fdAT") {
+            if (ReadBe32(body) != expected_sequence++) return false;
+            data.insert(data.end(), body + 4, body + length);
+        } else if (type == "IEND") {
+            seen_iend = true;
+            break;
+        }
+    }
+    return seen_iend && flush();
+}
+
+class AnimationWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::path(::testing::TempDir()) /
+               ("animation_writer_" +
+                std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+
+        // 移动方块的 UI 画面：连续几帧只有方块附近变化
+        SyntheticFrameSource source(160, 96, SyntheticFrameSource::Pattern::kUi);
+        for (int i = 0; i < 3; i++) {
+            frames_.emplace_back();
+            source.Capture(source.GetBounds(), &frames_.back());
+        }
+    }
+
+    void TearDown() override { fs::remove_all(dir_); }
+
+    std::string PathFor(const std::string& name) const { return (dir_ / name).u8string(); }
+
+    std::vector<uint8_t> ReadFile(const std::string& path) const {
+        std::ifstream in(fs::u8path(path), std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                    std::istreambuf_iterator<char>());
+    }
+
+    static void ExpectRgbEquals(const FrameBuffer& frame, const std::vector<uint8_t>& rgb) {
+        for (int y = 0; y < frame.height(); y++) {
+            for (int x = 0; x < frame.width(); x++) {
+                uint8_t expected[4];
+                testing::FramePixelRgba(frame, x, y, expected);
+                const uint8_t* actual = &rgb[(static_cast<size_t>(y) * frame.width() + x) * 3];
+                ASSERT_EQ(std::memcmp(expected, actual, 3), 0) << x << "," << y;
+            }
+        }
+    }
+
+    fs::path dir_;
+    std::vector<FrameBuffer> frames_;
+};
+
+TEST(ChangedBoundsTest, FindsMinimalRectangle) {
+    FrameBuffer a(40, 30, PixelFormat::kBgra8);
+    std::memset(a.data(), 0x40, a.size_bytes());
+    FrameBuffer b;
+    b.CopyFrom(a);
+    EXPECT_TRUE(ChangedBounds(a, b).empty());
+
+    b.row(7)[4 * 12] = 0x41;
+    b.row(20)[4 * 3 + 3] = 0x00;
+    EXPECT_EQ(ChangedBounds(a, b), Rect(3, 7, 10, 14));
+
+    FrameBuffer c(41, 30, PixelFormat::kBgra8);
+    EXPECT_EQ(ChangedBounds(a, c), c.bounds());
+}
+
+TEST(ChangedBoundsTest, IgnoresXChannelOfBgrx) {
+    FrameBuffer a(16, 16, PixelFormat::kBgrx8);
+    std::memset(a.data(), 0x10, a.size_bytes());
+    FrameBuffer b;
+    b.CopyFrom(a);
+    b.row(4)[4 * 4 + 3] = 0xFF;
+    EXPECT_TRUE(ChangedBounds(a, b).empty());
+    b.row(4)[4 * 4 + 1] = 0xFF;
+    EXPECT_EQ(ChangedBounds(a, b), Rect(4, 4, 1, 1));
+}
+
+TEST_F(AnimationWriterTest, GifFramesDecodeToOriginalPixels) {
+    const std::string path = PathFor("out.gif");
+    auto writer = AnimationWriter::Create(AnimationFormat::kGif);
+    ASSERT_TRUE(writer->Open(path));
+    ASSERT_TRUE(writer->AddFrame(frames_[0], milliseconds(0)));
+    ASSERT_TRUE(writer->AddFrame(frames_[1], milliseconds(104)));
+    ASSERT_TRUE(writer->AddFrame(frames_[2], milliseconds(198)));
+    ASSERT_TRUE(writer->Finish(milliseconds(300)));
+    EXPECT_EQ(writer->frames_written(), 3);
+    EXPECT_EQ(writer->bytes_written(), fs::file_size(fs::u8path(path)));
+
+    DecodedGif gif;
+    ASSERT_TRUE(DecodeGif(ReadFile(path), &gif));
+    EXPECT_TRUE(gif.loops);
+    EXPECT_EQ(gif.width, 160);
+    EXPECT_EQ(gif.height, 96);
+    ASSERT_EQ(gif.frames.size(), 3u);
+    for (size_t i = 0; i < 3; i++) {
+        ExpectRgbEquals(frames_[i], gif.frames[i]);
+    }
+    // 按帧边界取整：10、20、30（厘秒）
+    EXPECT_EQ(gif.delays, std::vector<int>({10, 10, 10}));
+    // 后续帧只写变化矩形
+    EXPECT_EQ(gif.rects[0], Rect(0, 0, 160, 96));
+    EXPECT_EQ(gif.rects[1], ChangedBounds(frames_[0], frames_[1]));
+    EXPECT_LT(gif.rects[1].width * gif.rects[1].height, 160 * 96);
+}
+
+TEST_F(AnimationWriterTest, GifQuantizesPhotoLikeFrames) {
+    SyntheticFrameSource source(128, 80, SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer first;
+    FrameBuffer second;
+    source.Capture(source.GetBounds(), &first);
+    source.Capture(source.GetBounds(), &second);
+
+    const std::string path = PathFor("noise.gif");
+    GifWriter writer;
+    ASSERT_TRUE(writer.Open(path));
+    ASSERT_TRUE(writer.AddFrame(first, milliseconds(0)));
+    ASSERT_TRUE(writer.AddFrame(second, milliseconds(15)));
+    ASSERT_TRUE(writer.Finish(milliseconds(2000)));
+
+    DecodedGif gif;
+    ASSERT_TRUE(DecodeGif(ReadFile(path), &gif));
+    ASSERT_EQ(gif.frames.size(), 2u);
+    // 小于 20 ms 的延迟被抬到 20 ms，误差由下一帧吸收
+    EXPECT_EQ(gif.delays, std::vector<int>({2, 198}));
+    uint64_t error = 0;
+    for (int y = 0; y < second.height(); y++) {
+        for (int x = 0; x < second.width(); x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(second, x, y, expected);
+            const uint8_t* actual = &gif.frames[1][(static_cast<size_t>(y) * 128 + x) * 3];
+            for (int c = 0; c < 3; c++) error += std::abs(int(expected[c]) - int(actual[c]));
+        }
+    }
+    EXPECT_LT(double(error) / (3.0 * 128 * 80), 12.0);
+}
+
+TEST_F(AnimationWriterTest, ApngFramesDecodeToOriginalPixels) {
+    const std::string path = PathFor("out.png");
+    auto writer = AnimationWriter::Create(AnimationFormat::kApng);
+    ASSERT_TRUE(writer->Open(path));
+    ASSERT_TRUE(writer->AddFrame(frames_[0], milliseconds(0)));
+    ASSERT_TRUE(writer->AddFrame(frames_[1], milliseconds(100)));
+    ASSERT_TRUE(writer->AddFrame(frames_[2], milliseconds(250)));
+    ASSERT_TRUE(writer->Finish(milliseconds(70250)));
+
+    DecodedApng apng;
+    ASSERT_TRUE(DecodeApng(ReadFile(path), &apng));
+    EXPECT_EQ(apng.num_frames, 3u);
+    EXPECT_EQ(apng.num_plays, 0u);
+    ASSERT_EQ(apng.frames.size(), 3u);
+    EXPECT_EQ(apng.frames[0].rect, frames_[0].bounds());
+    EXPECT_EQ(apng.frames[0].delay_num, 100);
+    EXPECT_EQ(apng.frames[0].delay_den, 1000);
+    EXPECT_EQ(apng.frames[1].delay_num, 150);
+    // 超过 65535 ms 的延迟改用 1/100 秒
+    EXPECT_EQ(apng.frames[2].delay_num, 7000);
+    EXPECT_EQ(apng.frames[2].delay_den, 100);
+
+    // 把每帧的矩形贴回画布，与原始帧逐像素比较
+    std::vector<uint8_t> canvas(160 * 96 * 3, 0);
+    for (size_t i = 0; i < 3; i++) {
+        const ApngFrame& frame = apng.frames[i];
+        if (i > 0) EXPECT_EQ(frame.rect, ChangedBounds(frames_[i - 1], frames_[i]));
+        ASSERT_EQ(frame.image.width, frame.rect.width);
+        ASSERT_EQ(frame.image.height, frame.rect.height);
+        for (int y = 0; y < frame.rect.height; y++) {
+            for (int x = 0; x < frame.rect.width; x++) {
+                const uint8_t* src = &frame.image.rgba[(static_cast<size_t>(y) * frame.rect.width + x) * 4];
+                std::memcpy(&canvas[(static_cast<size_t>(frame.rect.y + y) * 160 + frame.rect.x + x) * 3],
+                            src, 3);
+            }
+        }
+        ExpectRgbEquals(frames_[i], canvas);
+    }
+}
+
+TEST_F(AnimationWriterTest, IdenticalFramesAreMerged) {
+    const std::string path = PathFor("merged.gif");
+    GifWriter writer;
+    ASSERT_TRUE(writer.Open(path));
+    ASSERT_TRUE(writer.AddFrame(frames_[0], milliseconds(0)));
+    ASSERT_TRUE(writer.AddFrame(frames_[0], milliseconds(100)));
+    ASSERT_TRUE(writer.AddFrame(frames_[0], milliseconds(200)));
+    ASSERT_TRUE(writer.AddFrame(frames_[1], milliseconds(300)));
+    ASSERT_TRUE(writer.Finish(milliseconds(400)));
+    EXPECT_EQ(writer.frames_written(), 2);
+    EXPECT_EQ(writer.frames_merged(), 2);
+
+    DecodedGif gif;
+    ASSERT_TRUE(DecodeGif(ReadFile(path), &gif));
+    EXPECT_EQ(gif.delays, std::vector<int>({30, 10}));
+}
+
+TEST_F(AnimationWriterTest, UnfinishedOrEmptyRecordingLeavesNoFile) {
+    const std::string empty = PathFor("empty.gif");
+    {
+        GifWriter writer;
+        ASSERT_TRUE(writer.Open(empty));
+        EXPECT_FALSE(writer.Finish(milliseconds(100)));
+    }
+    EXPECT_FALSE(fs::exists(fs::u8path(empty)));
+
+    const std::string abandoned = PathFor("abandoned.png");
+    {
+        ApngWriter writer;
+        ASSERT_TRUE(writer.Open(abandoned));
+        ASSERT_TRUE(writer.AddFrame(frames_[0], milliseconds(0)));
+        ASSERT_TRUE(writer.AddFrame(frames_[1], milliseconds(100)));
+    }
+    EXPECT_FALSE(fs::exists(fs::u8path(abandoned)));
+}
+
+TEST_F(AnimationWriterTest, RejectsFramesOfDifferentSize) {
+    GifWriter writer;
+    ASSERT_TRUE(writer.Open(PathFor("size.gif")));
+    ASSERT_TRUE(writer.AddFrame(frames_[0], milliseconds(0)));
+    FrameBuffer other(20, 20, PixelFormat::kBgrx8);
+    EXPECT_FALSE(writer.AddFrame(other, milliseconds(100)));
+    writer.Abort();
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,143 @@
+#include "capture_core/batch_capture.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+#include "capture_core/pixel_convert.h"
+#include "capture_core/qoi_codec.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+// 已经关闭的窗口：范围还在，但截不到
+class ClosedWindowSource : public FrameSource {
+public:
+    Rect GetBounds() override { return Rect(0, 0, 200, 100); }
+    bool Capture(const Rect&, FrameBuffer*) override { return false; }
+};
+
+// 等到所有来源都进入 Capture 才返回，用来验证截取是并行的
+class RendezvousSource : public SyntheticFrameSource {
+public:
+    struct Rendezvous {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int arrived = 0;
+        int expected = 0;
+    };
+
+    explicit RendezvousSource(Rendezvous* rendezvous)
+        : SyntheticFrameSource(64, 48, Pattern::kUi), rendezvous_(rendezvous) {}
+
+    bool Capture(const Rect& region, FrameBuffer* frame) override {
+        std::unique_lock<std::mutex> lock(rendezvous_->mutex);
+        rendezvous_->arrived++;
+        rendezvous_->cv.notify_all();
+        bool all = rendezvous_->cv.wait_for(lock, std::chrono::seconds(5), [&] {
+            return rendezvous_->arrived >= rendezvous_->expected;
+        });
+        lock.unlock();
+        return all && SyntheticFrameSource::Capture(region, frame);
+    }
+
+private:
+    Rendezvous* rendezvous_;
+};
+
+TEST(BatchCaptureTest, CapturesEachSourceAndDownscalesLargeOnes) {
+    const SyntheticFrameSource::Pattern patterns[3] = {SyntheticFrameSource::Pattern::kUi,
+                                                       SyntheticFrameSource::Pattern::kNoise,
+                                                       SyntheticFrameSource::Pattern::kGradient};
+    SyntheticFrameSource wide(640, 360, patterns[0]);
+    SyntheticFrameSource tall(90, 300, patterns[1]);
+    SyntheticFrameSource small(100, 40, patterns[2]);
+    ThreadPool pool(2);
+    BatchCaptureOptions options;
+    options.max_dimension = 160;
+    options.encode.format = ImageFormat::kQoi;
+    options.pool = &pool;
+
+    std::vector<FrameSource*> sources = {&wide, &tall, &small};
+    std::vector<BatchCaptureItem> items = CaptureBatch(sources, options);
+    ASSERT_EQ(items.size(), 3u);
+
+    const int expected[3][2] = {{160, 90}, {48, 160}, {100, 40}};
+    for (size_t i = 0; i < items.size(); i++) {
+        const BatchCaptureItem& item = items[i];
+        ASSERT_TRUE(item.ok) << i;
+        const Rect bounds = sources[i]->GetBounds();
+        EXPECT_EQ(item.source_width, bounds.width);
+        EXPECT_EQ(item.source_height, bounds.height);
+        EXPECT_EQ(item.width, expected[i][0]);
+        EXPECT_EQ(item.height, expected[i][1]);
+
+        // 编码的就是第一帧经 DownscaleFrame 缩小的结果（合成来源每帧都在变化）
+        SyntheticFrameSource reference(bounds.width, bounds.height, patterns[i]);
+        FrameBuffer frame;
+        FrameBuffer thumbnail;
+        ASSERT_TRUE(reference.Capture(bounds, &frame));
+        DownscaleFrame(frame, options.max_dimension, &thumbnail);
+        FrameBuffer decoded;
+        ASSERT_TRUE(DecodeQoi(item.bytes.data(), item.bytes.size(), &decoded));
+        ASSERT_EQ(decoded.width(), item.width);
+        ASSERT_EQ(decoded.height(), item.height);
+        for (int y = 0; y < decoded.height(); y++) {
+            for (int x = 0; x < decoded.width(); x++) {
+                uint8_t expected_rgba[4];
+                testing::FramePixelRgba(thumbnail, x, y, expected_rgba);
+                ASSERT_EQ(0, std::memcmp(decoded.row(y) + 4 * x, expected_rgba, 3))
+                    << i << " at " << x << "," << y;
+            }
+        }
+    }
+}
+
+TEST(BatchCaptureTest, FailuresOnlyAffectTheirOwnItem) {
+    SyntheticFrameSource window(300, 200, SyntheticFrameSource::Pattern::kUi);
+    ClosedWindowSource closed;
+    BatchCaptureOptions options;
+    std::vector<BatchCaptureItem> items = CaptureBatch({&closed, nullptr, &window}, options);
+    ASSERT_EQ(items.size(), 3u);
+    EXPECT_FALSE(items[0].ok);
+    EXPECT_TRUE(items[0].bytes.empty());
+    EXPECT_FALSE(items[1].ok);
+    ASSERT_TRUE(items[2].ok);
+
+    // 默认 PNG，不缩小
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(items[2].bytes, &png));
+    EXPECT_EQ(png.width, 300);
+    EXPECT_EQ(png.height, 200);
+    EXPECT_EQ(items[2].width, 300);
+
+    EXPECT_TRUE(CaptureBatch({}, options).empty());
+}
+
+TEST(BatchCaptureTest, SourcesAreCapturedConcurrently) {
+    RendezvousSource::Rendezvous rendezvous;
+    rendezvous.expected = 3;
+    RendezvousSource a(&rendezvous);
+    RendezvousSource b(&rendezvous);
+    RendezvousSource c(&rendezvous);
+
+    // 调用线程 + 2 个工作线程，刚好每个来源一个线程
+    ThreadPool pool(2);
+    BatchCaptureOptions options;
+    options.max_dimension = 32;
+    options.pool = &pool;
+    for (const BatchCaptureItem& item : CaptureBatch({&a, &b, &c}, options)) {
+        EXPECT_TRUE(item.ok);
+        EXPECT_EQ(item.width, 32);
+        EXPECT_EQ(item.height, 24);
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
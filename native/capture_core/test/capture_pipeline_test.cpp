@@ -0,0 +1,53 @@
+#include "capture_core/capture_pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include "capture_core/png_encoder.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+TEST(CapturePipelineTest, FullCaptureProducesDecodablePng) {
+    SyntheticFrameSource source(320, 200, SyntheticFrameSource::Pattern::kGradient);
+    PngEncoder encoder;
+    CapturePipeline pipeline(&source, &encoder);
+
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(pipeline.CaptureFull(&png));
+    EXPECT_EQ(pipeline.last_timings().encoded_bytes, png.size());
+
+    testing::DecodedPng decoded;
+    ASSERT_TRUE(testing::DecodePng(png, &decoded));
+    EXPECT_EQ(decoded.width, 320);
+    EXPECT_EQ(decoded.height, 200);
+}
+
+TEST(CapturePipelineTest, RegionIsClippedToSourceBounds) {
+    SyntheticFrameSource source(100, 100, SyntheticFrameSource::Pattern::kUi);
+    PngEncoder encoder;
+    CapturePipeline pipeline(&source, &encoder);
+
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(pipeline.CaptureRegion(Rect(80, 90, 50, 50), &png));
+    EXPECT_EQ(pipeline.frame().width(), 20);
+    EXPECT_EQ(pipeline.frame().height(), 10);
+
+    EXPECT_FALSE(pipeline.CaptureRegion(Rect(200, 200, 10, 10), &png));
+}
+
+TEST(CapturePipelineTest, FrameBufferIsReusedAcrossCaptures) {
+    SyntheticFrameSource source(64, 64, SyntheticFrameSource::Pattern::kNoise);
+    PngEncoder encoder;
+    CapturePipeline pipeline(&source, &encoder);
+
+    ASSERT_TRUE(pipeline.CaptureFrame(source.GetBounds()));
+    const uint8_t* data = pipeline.frame().data();
+    ASSERT_TRUE(pipeline.CaptureFrame(source.GetBounds()));
+    EXPECT_EQ(pipeline.frame().data(), data);
+    EXPECT_EQ(source.frame_count(), 2u);
+}
+
+}  // namespace
+}  // namespace capture_core
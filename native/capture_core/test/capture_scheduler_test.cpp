@@ -0,0 +1,224 @@
+#include "capture_core/capture_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace capture_core {
+namespace {
+
+using Clock = CaptureScheduler::Clock;
+using std::chrono::milliseconds;
+
+// 记录触发和跳过，供测试等待和检查
+struct Recorder {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<ScheduledShot> shots;
+    std::vector<Clock::time_point> started;
+    std::vector<std::pair<int64_t, SkipReason>> skipped;
+    // 负载下落后超过一个间隔时合并掉的格点
+    int64_t missed = 0;
+
+    CaptureScheduler::ShotFunction Shot() {
+        return [this](ScheduledShot shot, const CancellationToken&) {
+            const Clock::time_point now = Clock::now();
+            std::lock_guard<std::mutex> lock(mutex);
+            shot.busy.reset();
+            missed += shot.missed;
+            shots.push_back(shot);
+            started.push_back(now);
+            cv.notify_all();
+        };
+    }
+
+    CaptureScheduler::SkipFunction Skip() {
+        return [this](const ScheduledShot& shot, SkipReason reason) {
+            std::lock_guard<std::mutex> lock(mutex);
+            missed += shot.missed;
+            skipped.emplace_back(shot.index, reason);
+            cv.notify_all();
+        };
+    }
+
+    // 等到触发、跳过和合并掉的格点数达到 count
+    bool WaitFor(size_t count, milliseconds timeout = milliseconds(5000)) {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cv.wait_for(lock, timeout, [&] {
+            return shots.size() + skipped.size() + static_cast<size_t>(missed) >= count;
+        });
+    }
+};
+
+CaptureScheduler::Options Every(int interval_ms, int64_t total) {
+    CaptureScheduler::Options options;
+    options.interval = milliseconds(interval_ms);
+    options.total_shots = total;
+    return options;
+}
+
+TEST(CaptureSchedulerTest, FiresOnAFixedGridWithoutDrift) {
+    JobQueue jobs(1, 4);
+    CaptureScheduler scheduler(&jobs);
+    Recorder recorder;
+    const Clock::time_point start = Clock::now();
+    const ScheduleId id = scheduler.Start(Every(20, 10), recorder.Shot(), recorder.Skip());
+    ASSERT_NE(id, 0u);
+    ASSERT_TRUE(recorder.WaitFor(10));
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    ASSERT_EQ(recorder.shots.size(), 10u);
+    EXPECT_TRUE(recorder.skipped.empty());
+    for (size_t i = 0; i < recorder.shots.size(); i++) {
+        const ScheduledShot& shot = recorder.shots[i];
+        EXPECT_EQ(shot.index, static_cast<int64_t>(i + 1));
+        EXPECT_EQ(shot.last, i == 9);
+        EXPECT_GE(shot.lateness.count(), 0);
+        // 计划时间是起点加整数个间隔，不随每次的延迟漂移
+        EXPECT_EQ(shot.deadline - recorder.shots[0].deadline, static_cast<int>(i) * milliseconds(20));
+        EXPECT_GE(recorder.started[i], shot.deadline);
+    }
+    // 最后一次相对 Start 的时间误差远小于一个间隔（留足余量给繁忙的 CI 机器）
+    const auto last = std::chrono::duration_cast<milliseconds>(recorder.started[9] - start);
+    EXPECT_GE(last.count(), 200);
+    EXPECT_LT(last.count(), 200 + 15);
+    EXPECT_FALSE(scheduler.active(id));
+    EXPECT_EQ(scheduler.size(), 0u);
+}
+
+TEST(CaptureSchedulerTest, FirstDelayMovesTheGridOrigin) {
+    JobQueue jobs(1, 4);
+    CaptureScheduler scheduler(&jobs);
+    Recorder recorder;
+    CaptureScheduler::Options options = Every(1000, 2);
+    options.first_delay = milliseconds(0);
+    const Clock::time_point start = Clock::now();
+    scheduler.Start(options, recorder.Shot(), recorder.Skip());
+    ASSERT_TRUE(recorder.WaitFor(1));
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    EXPECT_LT(recorder.started[0] - start, milliseconds(15));
+}
+
+TEST(CaptureSchedulerTest, SkipsWhileThePreviousShotIsBusy) {
+    JobQueue jobs(1, 4);
+    CaptureScheduler scheduler(&jobs);
+    Recorder recorder;
+    std::vector<std::thread> finishers;
+    std::mutex finishers_mutex;
+    // 截图本身很快，但把 busy 交给另一个线程 35ms 后才释放（模拟编码和写文件）
+    auto shot = [&](ScheduledShot shot, const CancellationToken& token) {
+        std::shared_ptr<void> busy = shot.busy;
+        recorder.Shot()(shot, token);
+        std::lock_guard<std::mutex> lock(finishers_mutex);
+        finishers.emplace_back([busy]() mutable {
+            std::this_thread::sleep_for(milliseconds(35));
+            busy.reset();
+        });
+    };
+    scheduler.Start(Every(10, 12), shot, recorder.Skip());
+    ASSERT_TRUE(recorder.WaitFor(12));
+    {
+        std::lock_guard<std::mutex> lock(finishers_mutex);
+        for (std::thread& finisher : finishers) finisher.join();
+    }
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    EXPECT_EQ(recorder.shots.size() + recorder.skipped.size() + recorder.missed, 12u);
+    EXPECT_GE(recorder.skipped.size() + recorder.missed, 6u);
+    EXPECT_LE(recorder.shots.size(), 5u);
+    for (const auto& skip : recorder.skipped) {
+        EXPECT_EQ(skip.second, SkipReason::kBusy);
+    }
+    // 第一次总是真正触发（可能合并了之前落后的格点）
+    EXPECT_EQ(recorder.shots[0].index - recorder.shots[0].missed, 1);
+}
+
+TEST(CaptureSchedulerTest, ReportsQueueFullAsSkipped) {
+    // 没有工作线程：第一次截图一直排队，占满容量为 1 的队列
+    JobQueue jobs(0, 1);
+    Recorder recorder;
+    {
+        CaptureScheduler scheduler(&jobs);
+        scheduler.Start(Every(5, 0), recorder.Shot(), recorder.Skip());
+        scheduler.Start(Every(5, 0), recorder.Shot(), recorder.Skip());
+        ASSERT_TRUE(recorder.WaitFor(4));
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        EXPECT_TRUE(recorder.shots.empty());
+        bool queue_full = false;
+        for (const auto& skip : recorder.skipped) {
+            queue_full |= skip.second == SkipReason::kQueueFull;
+        }
+        EXPECT_TRUE(queue_full);
+    }
+    // 析构时 StopAll 取消了排队中的截图
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    EXPECT_EQ(jobs.pending(), 0u);
+    bool cancelled = false;
+    for (const auto& skip : recorder.skipped) {
+        cancelled |= skip.second == SkipReason::kCancelled;
+    }
+    EXPECT_TRUE(cancelled);
+}
+
+TEST(CaptureSchedulerTest, StopCancelsQueuedShotAndEndsTheSchedule) {
+    JobQueue jobs(0, 4);
+    CaptureScheduler scheduler(&jobs);
+    Recorder recorder;
+    const ScheduleId id = scheduler.Start(Every(5, 0), recorder.Shot(), recorder.Skip());
+    const Clock::time_point give_up = Clock::now() + milliseconds(5000);
+    while (jobs.pending() == 0 && Clock::now() < give_up) {
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    ASSERT_EQ(jobs.pending(), 1u);
+
+    EXPECT_TRUE(scheduler.Stop(id));
+    EXPECT_FALSE(scheduler.Stop(id));
+    EXPECT_FALSE(scheduler.active(id));
+    EXPECT_EQ(jobs.pending(), 0u);
+
+    // 停止之后不再触发，也不再报告跳过
+    std::this_thread::sleep_for(milliseconds(30));
+    size_t skipped;
+    {
+        std::lock_guard<std::mutex> lock(recorder.mutex);
+        EXPECT_TRUE(recorder.shots.empty());
+        ASSERT_FALSE(recorder.skipped.empty());
+        EXPECT_EQ(recorder.skipped.back().second, SkipReason::kCancelled);
+        skipped = recorder.skipped.size();
+    }
+    std::this_thread::sleep_for(milliseconds(20));
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    EXPECT_EQ(recorder.skipped.size(), skipped);
+}
+
+TEST(CaptureSchedulerTest, LongIntervalsWrapAroundTheWheel) {
+    JobQueue jobs(1, 4);
+    CaptureScheduler scheduler(&jobs);
+    Recorder recorder;
+    // 1.3 秒超过时间轮一圈，需要多转一圈才触发
+    const Clock::time_point start = Clock::now();
+    scheduler.Start(Every(1300, 1), recorder.Shot(), recorder.Skip());
+    ASSERT_TRUE(recorder.WaitFor(1));
+
+    std::lock_guard<std::mutex> lock(recorder.mutex);
+    const auto elapsed = std::chrono::duration_cast<milliseconds>(recorder.started[0] - start);
+    EXPECT_GE(elapsed.count(), 1300);
+    EXPECT_LT(elapsed.count(), 1300 + 15);
+    EXPECT_TRUE(recorder.shots[0].last);
+}
+
+TEST(CaptureSchedulerTest, RejectsNonPositiveInterval) {
+    JobQueue jobs(1, 4);
+    CaptureScheduler scheduler(&jobs);
+    Recorder recorder;
+    EXPECT_EQ(scheduler.Start(Every(0, 1), recorder.Shot(), recorder.Skip()), 0u);
+    EXPECT_EQ(scheduler.size(), 0u);
+}
+
+}  // namespace
+}  // namespace capture_core
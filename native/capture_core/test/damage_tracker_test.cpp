@@ -0,0 +1,139 @@
+#include "capture_core/damage_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace capture_core {
+namespace {
+
+int64_t TotalArea(const std::vector<Rect>& rects) {
+    int64_t area = 0;
+    for (const Rect& rect : rects) {
+        area += static_cast<int64_t>(rect.width) * rect.height;
+    }
+    return area;
+}
+
+bool Covers(const std::vector<Rect>& rects, int x, int y) {
+    for (const Rect& rect : rects) {
+        if (rect.Contains(x, y)) return true;
+    }
+    return false;
+}
+
+bool Disjoint(const std::vector<Rect>& rects) {
+    for (size_t a = 0; a < rects.size(); a++) {
+        for (size_t b = a + 1; b < rects.size(); b++) {
+            if (!IntersectRects(rects[a], rects[b]).empty()) return false;
+        }
+    }
+    return true;
+}
+
+TEST(SubtractRectsTest, LeavesTheUncoveredPieces) {
+    const Rect a(0, 0, 100, 100);
+    EXPECT_EQ(SubtractRects(a, Rect(200, 0, 10, 10)), std::vector<Rect>{a});
+    EXPECT_TRUE(SubtractRects(a, Rect(-10, -10, 200, 200)).empty());
+    std::vector<Rect> ring = SubtractRects(a, Rect(10, 20, 30, 40));
+    EXPECT_EQ(ring, (std::vector<Rect>{Rect(0, 0, 100, 20), Rect(0, 60, 100, 40),
+                                       Rect(0, 20, 10, 40), Rect(40, 20, 60, 40)}));
+    EXPECT_EQ(TotalArea(ring), 100 * 100 - 30 * 40);
+    EXPECT_EQ(SubtractRects(a, Rect(50, -10, 100, 200)), std::vector<Rect>{Rect(0, 0, 50, 100)});
+}
+
+TEST(DamageTrackerTest, FirstFrameRepaintsEverything) {
+    DamageTracker tracker(Rect(0, 0, 1920, 1080));
+    tracker.SetLayer(1, Rect(10, 10, 100, 100));
+    EXPECT_EQ(tracker.Commit(), std::vector<Rect>{Rect(0, 0, 1920, 1080)});
+    // 没有变化
+    tracker.SetLayer(1, Rect(10, 10, 100, 100));
+    EXPECT_TRUE(tracker.Commit().empty());
+    tracker.InvalidateAll();
+    tracker.SetLayer(1, Rect(10, 10, 100, 100));
+    EXPECT_EQ(tracker.Commit().size(), 1u);
+    EXPECT_EQ(tracker.stats().frames, 3u);
+    EXPECT_EQ(tracker.stats().full_repaints, 2u);
+}
+
+TEST(DamageTrackerTest, MovedChangedAndRemovedLayers) {
+    DamageTracker tracker(Rect(0, 0, 1920, 1080));
+    tracker.SetLayer(1, Rect(100, 100, 150, 190), 7);
+    tracker.SetLayer(2, Rect(500, 500, 90, 40), 0);
+    tracker.SetLayer(3, Rect(800, 100, 10, 10));
+    tracker.Commit();
+
+    // 放大镜移动 5px：新旧两块合起来，重叠部分只算一次
+    tracker.SetLayer(1, Rect(105, 100, 150, 190), 8);
+    // 工具栏只换了悬停状态
+    tracker.SetLayer(2, Rect(500, 500, 90, 40), 1);
+    // 3 消失
+    std::vector<Rect> damage = tracker.Commit();
+    EXPECT_TRUE(Disjoint(damage));
+    EXPECT_EQ(TotalArea(damage), 155 * 190 + 90 * 40 + 10 * 10);
+    EXPECT_TRUE(Covers(damage, 102, 150));
+    EXPECT_TRUE(Covers(damage, 252, 150));
+    EXPECT_TRUE(Covers(damage, 805, 105));
+    EXPECT_FALSE(Covers(damage, 400, 400));
+
+    // 内容不变、矩形不变的元素不重画
+    tracker.SetLayer(1, Rect(105, 100, 150, 190), 8);
+    tracker.SetLayer(2, Rect(500, 500, 90, 40), 1);
+    EXPECT_TRUE(tracker.Commit().empty());
+}
+
+TEST(DamageTrackerTest, HoleRepaintsOnlyTheSymmetricDifference) {
+    DamageTracker tracker(Rect(0, 0, 3840, 2160));
+    tracker.SetHole(1, Rect(400, 300, 1200, 800));
+    tracker.Commit();
+
+    // 拖动右边 20px
+    tracker.SetHole(1, Rect(400, 300, 1220, 800));
+    std::vector<Rect> damage = tracker.Commit();
+    EXPECT_EQ(damage, std::vector<Rect>{Rect(1600, 300, 20, 800)});
+
+    // 整体移动：只有两条 L 形
+    tracker.SetHole(1, Rect(410, 305, 1220, 800));
+    damage = tracker.Commit();
+    EXPECT_TRUE(Disjoint(damage));
+    EXPECT_EQ(TotalArea(damage), 2 * (1220 * 800 - 1210 * 795));
+    EXPECT_FALSE(Covers(damage, 1000, 700));
+
+    // 选择框消失：整个挖空区域重画
+    damage = tracker.Commit();
+    EXPECT_EQ(TotalArea(damage), 1220 * 800);
+}
+
+TEST(DamageTrackerTest, ClipsToBoundsAndFallsBackToFullRepaint) {
+    DamageTracker tracker(Rect(0, 0, 1000, 1000));
+    tracker.Commit();
+    tracker.SetLayer(1, Rect(-50, -50, 100, 100));
+    EXPECT_EQ(tracker.Commit(), std::vector<Rect>{Rect(0, 0, 50, 50)});
+    tracker.SetLayer(1, Rect(0, 0, 900, 900));
+    EXPECT_EQ(tracker.Commit(), std::vector<Rect>{Rect(0, 0, 1000, 1000)});
+    EXPECT_EQ(tracker.stats().full_repaints, 2u);
+}
+
+TEST(DamageTrackerTest, CoalescesManyRectsAndKeepsCoverage) {
+    DamageTracker tracker(Rect(0, 0, 3840, 2160));
+    tracker.Commit();
+    std::mt19937 rng(3);
+    std::vector<Rect> layers;
+    for (uint32_t id = 0; id < 40; id++) {
+        layers.emplace_back(static_cast<int>(rng() % 3800), static_cast<int>(rng() % 2100),
+                            5 + static_cast<int>(rng() % 60), 5 + static_cast<int>(rng() % 60));
+        tracker.SetLayer(id, layers.back());
+    }
+    std::vector<Rect> damage = tracker.Commit();
+    EXPECT_LE(damage.size(), DamageTracker::kMaxRects);
+    EXPECT_TRUE(Disjoint(damage));
+    for (const Rect& layer : layers) {
+        EXPECT_TRUE(Covers(damage, layer.x, layer.y));
+        EXPECT_TRUE(Covers(damage, layer.right() - 1, layer.bottom() - 1));
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
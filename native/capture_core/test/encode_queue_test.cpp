@@ -0,0 +1,336 @@
+#include "capture_core/encode_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "capture_core/png_encoder.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+// 第一次 Encode 时阻塞，直到 release 被设置，用来占住唯一的工作线程
+class BlockingEncoder : public FrameEncoder {
+public:
+    BlockingEncoder(std::promise<void>* started, std::shared_future<void> release)
+        : started_(started), release_(release) {}
+
+    bool Encode(const FrameBuffer& frame, std::vector<uint8_t>* out) override {
+        if (started_ != nullptr) {
+            started_->set_value();
+            started_ = nullptr;
+            release_.wait();
+        }
+        return png_.Encode(frame, out);
+    }
+
+private:
+    std::promise<void>* started_;
+    std::shared_future<void> release_;
+    PngEncoder png_;
+};
+
+FrameBuffer SolidFrame(int width, int height, uint8_t b, uint8_t g, uint8_t r) {
+    FrameBuffer frame(width, height, PixelFormat::kBgrx8);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t* p = frame.row(y) + 4 * x;
+            p[0] = b;
+            p[1] = g;
+            p[2] = r;
+            p[3] = 0;
+        }
+    }
+    return frame;
+}
+
+EncodeQueue::EncoderFactory PngFactory() {
+    return [] { return std::unique_ptr<FrameEncoder>(new PngEncoder()); };
+}
+
+TEST(EncodeQueueTest, EncodesInBackgroundAndReportsCompletion) {
+    EncodeQueue queue(PngFactory(), 1, 4);
+    std::promise<EncodeResult> done;
+    FrameHandle handle = queue.Submit(SolidFrame(64, 32, 10, 20, 30),
+                                      [&](EncodeResult result) { done.set_value(std::move(result)); });
+    ASSERT_NE(handle, 0u);
+
+    EncodeResult result = done.get_future().get();
+    EXPECT_EQ(result.handle, handle);
+    ASSERT_EQ(result.status, EncodeStatus::kOk);
+
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(result.bytes, &png));
+    EXPECT_EQ(png.width, 64);
+    EXPECT_EQ(png.height, 32);
+    EXPECT_EQ(png.rgba[0], 30);
+    EXPECT_EQ(png.rgba[1], 20);
+    EXPECT_EQ(png.rgba[2], 10);
+    EXPECT_EQ(queue.in_flight(), 0u);
+}
+
+TEST(EncodeQueueTest, EncodesJpegWhenRequested) {
+    EncodeQueue queue(PngFactory(), 1, 4);
+    std::promise<EncodeResult> done;
+    EncodeOptions options;
+    options.format = ImageFormat::kJpeg;
+    options.quality = 80;
+    FrameHandle handle = queue.Submit(SolidFrame(64, 32, 10, 20, 30),
+                                      [&](EncodeResult result) { done.set_value(std::move(result)); },
+                                      options);
+    ASSERT_NE(handle, 0u);
+
+    EncodeResult result = done.get_future().get();
+    ASSERT_EQ(result.status, EncodeStatus::kOk);
+    ASSERT_GE(result.bytes.size(), 2u);
+    EXPECT_EQ(result.bytes[0], 0xFF);
+    EXPECT_EQ(result.bytes[1], 0xD8);
+}
+
+TEST(EncodeQueueTest, EncodesQoiWhenRequested) {
+    EncodeQueue queue(PngFactory(), 1, 4);
+    std::promise<EncodeResult> done;
+    EncodeOptions options;
+    options.format = ImageFormat::kQoi;
+    FrameHandle handle = queue.Submit(SolidFrame(64, 32, 10, 20, 30),
+                                      [&](EncodeResult result) { done.set_value(std::move(result)); },
+                                      options);
+    ASSERT_NE(handle, 0u);
+
+    EncodeResult result = done.get_future().get();
+    ASSERT_EQ(result.status, EncodeStatus::kOk);
+    FrameBuffer decoded;
+    ASSERT_TRUE(DecodeQoi(result.bytes.data(), result.bytes.size(), &decoded));
+    EXPECT_EQ(decoded.width(), 64);
+    EXPECT_EQ(decoded.height(), 32);
+}
+
+TEST(EncodeQueueTest, PeekReturnsRawFrameUntilEncoded) {
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    EncodeQueue queue(
+        [&] { return std::unique_ptr<FrameEncoder>(new BlockingEncoder(&started, release_future)); },
+        1, 4);
+
+    std::promise<EncodeResult> done;
+    FrameHandle handle = queue.Submit(SolidFrame(16, 8, 1, 2, 3),
+                                      [&](EncodeResult result) { done.set_value(std::move(result)); });
+    ASSERT_NE(handle, 0u);
+    started.get_future().wait();
+
+    // 编码进行中：原始帧仍可用于预览
+    std::shared_ptr<const FrameBuffer> preview = queue.Peek(handle);
+    ASSERT_NE(preview, nullptr);
+    EXPECT_EQ(preview->width(), 16);
+    EXPECT_EQ(preview->height(), 8);
+    EXPECT_EQ(preview->row(0)[2], 3);
+    EXPECT_EQ(queue.in_flight(), 1u);
+    preview.reset();
+
+    release.set_value();
+    EXPECT_EQ(done.get_future().get().status, EncodeStatus::kOk);
+    EXPECT_EQ(queue.Peek(handle), nullptr);
+    EXPECT_EQ(queue.Peek(0), nullptr);
+}
+
+TEST(EncodeQueueTest, ViewFramesAreCopiedSoTheSourceCanBeReused) {
+    FrameBuffer source = SolidFrame(32, 16, 0, 0, 200);
+    FrameBuffer view = source.View(source.bounds());
+    ASSERT_FALSE(view.owns_memory());
+
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    EncodeQueue queue(
+        [&] { return std::unique_ptr<FrameEncoder>(new BlockingEncoder(&started, release_future)); },
+        1, 4);
+    std::promise<EncodeResult> done;
+    ASSERT_NE(queue.Submit(std::move(view),
+                           [&](EncodeResult result) { done.set_value(std::move(result)); }),
+              0u);
+    started.get_future().wait();
+
+    // 来源缓冲被下一次捕获覆盖，不影响已提交的帧
+    source = SolidFrame(32, 16, 200, 0, 0);
+    release.set_value();
+
+    EncodeResult result = done.get_future().get();
+    ASSERT_EQ(result.status, EncodeStatus::kOk);
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(result.bytes, &png));
+    EXPECT_EQ(png.rgba[0], 200);
+    EXPECT_EQ(png.rgba[2], 0);
+}
+
+TEST(EncodeQueueTest, AcquireFrameReusesEncodedFrameMemory) {
+    EncodeQueue queue(PngFactory(), 1, 4);
+    EXPECT_EQ(queue.AcquireFrame().capacity_bytes(), 0u);
+
+    std::promise<void> done;
+    ASSERT_NE(queue.Submit(SolidFrame(64, 64, 0, 0, 0), [&](EncodeResult) { done.set_value(); }),
+              0u);
+    done.get_future().wait();
+
+    FrameBuffer reused = queue.AcquireFrame();
+    EXPECT_TRUE(reused.empty());
+    EXPECT_GE(reused.capacity_bytes(), 64u * 64u * 4u);
+    EXPECT_EQ(queue.AcquireFrame().capacity_bytes(), 0u);
+
+    // 没有提交的帧还回来之后同样可以再取到
+    queue.ReleaseFrame(std::move(reused));
+    EXPECT_GE(queue.AcquireFrame().capacity_bytes(), 64u * 64u * 4u);
+    queue.ReleaseFrame(FrameBuffer());
+    EXPECT_EQ(queue.AcquireFrame().capacity_bytes(), 0u);
+}
+
+TEST(EncodeQueueTest, CancelledPendingFrameReportsCancelled) {
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    EncodeQueue queue(
+        [&] { return std::unique_ptr<FrameEncoder>(new BlockingEncoder(&started, release_future)); },
+        1, 4);
+
+    std::promise<EncodeResult> first;
+    queue.Submit(SolidFrame(8, 8, 0, 0, 0),
+                 [&](EncodeResult result) { first.set_value(std::move(result)); });
+    started.get_future().wait();
+
+    std::promise<EncodeResult> second;
+    FrameHandle pending = queue.Submit(
+        SolidFrame(8, 8, 0, 0, 0), [&](EncodeResult result) { second.set_value(std::move(result)); });
+    ASSERT_NE(pending, 0u);
+    EXPECT_TRUE(queue.Cancel(pending));
+
+    EncodeResult cancelled = second.get_future().get();
+    EXPECT_EQ(cancelled.handle, pending);
+    EXPECT_EQ(cancelled.status, EncodeStatus::kCancelled);
+    EXPECT_TRUE(cancelled.bytes.empty());
+    EXPECT_EQ(queue.Peek(pending), nullptr);
+    EXPECT_FALSE(queue.Cancel(pending));
+
+    release.set_value();
+    EXPECT_EQ(first.get_future().get().status, EncodeStatus::kOk);
+}
+
+TEST(EncodeQueueTest, RejectsWhenFullWithoutCallingDone) {
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    EncodeQueue queue(
+        [&] { return std::unique_ptr<FrameEncoder>(new BlockingEncoder(&started, release_future)); },
+        1, 1);
+
+    std::atomic<int> completions(0);
+    auto count = [&](EncodeResult) { ++completions; };
+    ASSERT_NE(queue.Submit(SolidFrame(8, 8, 0, 0, 0), count), 0u);
+    started.get_future().wait();
+    ASSERT_NE(queue.Submit(SolidFrame(8, 8, 0, 0, 0), count), 0u);
+    EXPECT_EQ(queue.Submit(SolidFrame(8, 8, 0, 0, 0), count), 0u);
+    EXPECT_EQ(queue.Submit(FrameBuffer(), count), 0u);
+    EXPECT_EQ(queue.in_flight(), 2u);
+
+    release.set_value();
+    while (completions.load() < 2) {
+        std::this_thread::yield();
+    }
+    EXPECT_EQ(queue.in_flight(), 0u);
+}
+
+TEST(EncodeQueueTest, DestructorCancelsPendingFrames) {
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> release_future = release.get_future().share();
+    std::atomic<int> ok(0);
+    std::atomic<int> cancelled(0);
+    std::thread releaser;
+    auto count = [&](EncodeResult result) {
+        if (result.status == EncodeStatus::kOk) ++ok;
+        if (result.status == EncodeStatus::kCancelled) ++cancelled;
+    };
+    {
+        EncodeQueue queue(
+            [&] { return std::unique_ptr<FrameEncoder>(new BlockingEncoder(&started, release_future)); },
+            1, 4);
+        queue.Submit(SolidFrame(8, 8, 0, 0, 0), count);
+        started.get_future().wait();
+        queue.Submit(SolidFrame(8, 8, 0, 0, 0), count);
+        queue.Submit(SolidFrame(8, 8, 0, 0, 0), count);
+        // 析构会取消正在编码的帧，放行后它以 kCancelled 结束
+        releaser = std::thread([&] { release.set_value(); });
+    }
+    releaser.join();
+    EXPECT_EQ(ok.load() + cancelled.load(), 3);
+    EXPECT_GE(cancelled.load(), 2);
+}
+
+TEST(EncodeQueueTest, HeldFrameIsNotEncodedUntilRequested) {
+    EncodeQueue queue(PngFactory(), 1, 4);
+    std::promise<EncodeResult> done;
+    FrameHandle handle = queue.Hold(SolidFrame(16, 8, 1, 2, 3),
+                                    [&](EncodeResult result) { done.set_value(std::move(result)); });
+    ASSERT_NE(handle, 0u);
+    EXPECT_EQ(queue.held(), 1u);
+    EXPECT_EQ(queue.in_flight(), 1u);
+
+    // 暂存期间预览直接读原始像素
+    std::shared_ptr<const FrameBuffer> preview = queue.Peek(handle);
+    ASSERT_NE(preview, nullptr);
+    EXPECT_EQ(preview->row(0)[2], 3);
+    preview.reset();
+
+    EXPECT_FALSE(queue.Encode(handle + 1));
+    ASSERT_TRUE(queue.Encode(handle));
+    EXPECT_FALSE(queue.Encode(handle));
+    EXPECT_EQ(queue.held(), 0u);
+
+    EncodeResult result = done.get_future().get();
+    EXPECT_EQ(result.handle, handle);
+    ASSERT_EQ(result.status, EncodeStatus::kOk);
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(result.bytes, &png));
+    EXPECT_EQ(png.width, 16);
+    EXPECT_EQ(png.rgba[0], 3);
+}
+
+TEST(EncodeQueueTest, CancelledHeldFrameReportsCancelledAndLimitsHolds) {
+    EncodeQueue queue(PngFactory(), 1, 2);
+    std::atomic<int> cancelled(0);
+    auto count = [&](EncodeResult result) {
+        if (result.status == EncodeStatus::kCancelled) ++cancelled;
+    };
+    FrameHandle first = queue.Hold(SolidFrame(8, 8, 0, 0, 0), count);
+    FrameHandle second = queue.Hold(SolidFrame(8, 8, 0, 0, 0), count);
+    ASSERT_NE(first, 0u);
+    ASSERT_NE(second, 0u);
+    EXPECT_EQ(queue.Hold(SolidFrame(8, 8, 0, 0, 0), count), 0u);
+
+    // 暂存帧取消时同步通知
+    EXPECT_TRUE(queue.Cancel(first));
+    EXPECT_EQ(cancelled.load(), 1);
+    EXPECT_EQ(queue.Peek(first), nullptr);
+    EXPECT_FALSE(queue.Encode(first));
+    EXPECT_NE(queue.Hold(SolidFrame(8, 8, 0, 0, 0), count), 0u);
+
+    EXPECT_EQ(queue.CancelAll(), 2u);
+    EXPECT_EQ(cancelled.load(), 3);
+    EXPECT_EQ(queue.in_flight(), 0u);
+}
+
+TEST(EncodeQueueTest, DestructorCancelsHeldFrames) {
+    std::atomic<int> cancelled(0);
+    {
+        EncodeQueue queue(PngFactory(), 1, 4);
+        queue.Hold(SolidFrame(8, 8, 0, 0, 0), [&](EncodeResult result) {
+            if (result.status == EncodeStatus::kCancelled) ++cancelled;
+        });
+    }
+    EXPECT_EQ(cancelled.load(), 1);
+}
+
+}  // namespace
+}  // namespace capture_core
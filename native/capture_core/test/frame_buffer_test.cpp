@@ -0,0 +1,69 @@
+#include "capture_core/frame_buffer.h"
+
+#include <gtest/gtest.h>
+
+namespace capture_core {
+namespace {
+
+TEST(FrameBufferTest, AllocateReusesCapacity) {
+    FrameBuffer frame(64, 32, PixelFormat::kBgrx8);
+    EXPECT_EQ(frame.stride(), 64 * 4);
+    EXPECT_EQ(frame.size_bytes(), 64u * 4 * 32);
+    EXPECT_TRUE(frame.owns_memory());
+
+    const uint8_t* before = frame.data();
+    frame.Allocate(32, 32, PixelFormat::kBgra8);
+    EXPECT_EQ(frame.data(), before);
+    EXPECT_EQ(frame.width(), 32);
+    EXPECT_EQ(frame.format(), PixelFormat::kBgra8);
+}
+
+TEST(FrameBufferTest, ViewIsClippedAndShared) {
+    FrameBuffer frame(10, 10, PixelFormat::kRgba8);
+    frame.row(5)[4 * 5] = 0xAB;
+
+    FrameBuffer view = frame.View(Rect(5, 5, 20, 20));
+    ASSERT_FALSE(view.empty());
+    EXPECT_FALSE(view.owns_memory());
+    EXPECT_EQ(view.width(), 5);
+    EXPECT_EQ(view.height(), 5);
+    EXPECT_EQ(view.stride(), frame.stride());
+    EXPECT_EQ(view.row(0)[0], 0xAB);
+
+    EXPECT_TRUE(frame.View(Rect(20, 20, 5, 5)).empty());
+}
+
+TEST(FrameBufferTest, CopyFromViewCompactsStride) {
+    FrameBuffer frame(8, 8, PixelFormat::kBgrx8);
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8 * 4; x++) {
+            frame.row(y)[x] = static_cast<uint8_t>(y * 32 + x);
+        }
+    }
+    FrameBuffer view = frame.View(Rect(2, 3, 4, 2));
+    FrameBuffer copy;
+    copy.CopyFrom(view);
+    EXPECT_TRUE(copy.owns_memory());
+    EXPECT_EQ(copy.stride(), 4 * 4);
+    EXPECT_EQ(copy.row(1)[0], frame.row(4)[2 * 4]);
+}
+
+TEST(FrameBufferTest, MoveTransfersOwnership) {
+    FrameBuffer frame(4, 4, PixelFormat::kBgra8);
+    uint8_t* data = frame.data();
+    FrameBuffer moved(std::move(frame));
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_TRUE(frame.empty());
+}
+
+TEST(GeometryTest, IntersectAndUnion) {
+    Rect a(0, 0, 10, 10);
+    Rect b(5, 5, 10, 10);
+    EXPECT_EQ(IntersectRects(a, b), Rect(5, 5, 5, 5));
+    EXPECT_EQ(UnionRects(a, b), Rect(0, 0, 15, 15));
+    EXPECT_TRUE(IntersectRects(a, Rect(10, 0, 5, 5)).empty());
+    EXPECT_EQ(UnionRects(Rect(), b), b);
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,69 @@
+#include "capture_core/frozen_frame_source.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "capture_core/capture_pipeline.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+TEST(FrozenFrameSourceTest, BoundsAreOffsetByOrigin) {
+    FrameBuffer frozen(200, 100, PixelFormat::kBgrx8);
+    FrozenFrameSource source(frozen, -50, 20);
+    EXPECT_EQ(source.GetBounds(), Rect(-50, 20, 200, 100));
+
+    FrameBuffer empty;
+    FrozenFrameSource none(empty, 0, 0);
+    EXPECT_TRUE(none.GetBounds().empty());
+}
+
+TEST(FrozenFrameSourceTest, CaptureIsAViewIntoTheFrozenFrame) {
+    FrameBuffer frozen(100, 80, PixelFormat::kBgrx8);
+    frozen.row(30)[4 * 20] = 0x5A;
+    FrozenFrameSource source(frozen, 10, 10);
+
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(Rect(30, 40, 16, 8), &frame));
+    EXPECT_FALSE(frame.owns_memory());
+    EXPECT_EQ(frame.width(), 16);
+    EXPECT_EQ(frame.height(), 8);
+    EXPECT_EQ(frame.data(), frozen.row(30) + 4 * 20);
+    EXPECT_EQ(frame.row(0)[0], 0x5A);
+
+    EXPECT_FALSE(source.Capture(Rect(500, 500, 10, 10), &frame));
+}
+
+TEST(FrozenFrameSourceTest, CropMatchesLiveRegionCapture) {
+    SyntheticFrameSource live(160, 120, SyntheticFrameSource::Pattern::kUi);
+    CapturePipeline live_pipeline(&live, nullptr);
+    ASSERT_TRUE(live_pipeline.CaptureFrame(live.GetBounds()));
+    FrameBuffer frozen;
+    frozen.CopyFrom(live_pipeline.frame());
+
+    PngEncoder encoder;
+    FrozenFrameSource source(frozen, 0, 0);
+    CapturePipeline pipeline(&source, &encoder);
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(pipeline.CaptureRegion(Rect(40, 30, 64, 48), &png));
+
+    testing::DecodedPng decoded;
+    ASSERT_TRUE(testing::DecodePng(png, &decoded));
+    ASSERT_EQ(decoded.width, 64);
+    ASSERT_EQ(decoded.height, 48);
+    for (int y = 0; y < 48; y++) {
+        for (int x = 0; x < 64; x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(frozen, 40 + x, 30 + y, expected);
+            const uint8_t* px = &decoded.rgba[(static_cast<size_t>(y) * 64 + x) * 4];
+            ASSERT_EQ(0, memcmp(px, expected, 4)) << "at " << x << "," << y;
+        }
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
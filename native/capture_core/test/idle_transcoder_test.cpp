@@ -0,0 +1,147 @@
+#include "capture_core/idle_transcoder.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iterator>
+#include <thread>
+
+#include "capture_core/qoi_codec.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+namespace fs = std::filesystem;
+
+class IdleTranscoderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::path(::testing::TempDir()) /
+               ("idle_transcoder_" +
+                std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+
+        SyntheticFrameSource source(97, 61, SyntheticFrameSource::Pattern::kUi);
+        source.Capture(source.GetBounds(), &frame_);
+    }
+
+    void TearDown() override { fs::remove_all(dir_); }
+
+    // 写一个 QOI 文件，返回 UTF-8 路径
+    std::string WriteQoi(const std::string& name) {
+        std::vector<uint8_t> qoi;
+        EXPECT_TRUE(QoiEncoder().Encode(frame_, &qoi));
+        fs::path path = dir_ / name;
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(qoi.data()), static_cast<std::streamsize>(qoi.size()));
+        return path.u8string();
+    }
+
+    std::string PathFor(const std::string& name) const { return (dir_ / name).u8string(); }
+
+    std::vector<uint8_t> ReadFile(const std::string& path) const {
+        std::ifstream in(fs::u8path(path), std::ios::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                    std::istreambuf_iterator<char>());
+    }
+
+    fs::path dir_;
+    FrameBuffer frame_;
+};
+
+TEST_F(IdleTranscoderTest, ConvertsQoiToPngAndRemovesSource) {
+    const std::string source = WriteQoi("shot.qoi");
+    const std::string target = PathFor("shot.png");
+
+    IdleTranscoder transcoder(std::chrono::milliseconds(0));
+    std::promise<TranscodeResult> done;
+    ASSERT_TRUE(transcoder.Enqueue(source, target,
+                                   [&](TranscodeResult result) { done.set_value(std::move(result)); }));
+
+    TranscodeResult result = done.get_future().get();
+    EXPECT_EQ(result.status, TranscodeStatus::kOk);
+    EXPECT_EQ(result.source, source);
+    EXPECT_EQ(result.target, target);
+    EXPECT_FALSE(fs::exists(fs::u8path(source)));
+    EXPECT_FALSE(fs::exists(fs::u8path(target + ".tmp")));
+
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(ReadFile(target), &png));
+    ASSERT_EQ(png.width, frame_.width());
+    ASSERT_EQ(png.height, frame_.height());
+    for (int y = 0; y < frame_.height(); y++) {
+        for (int x = 0; x < frame_.width(); x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(frame_, x, y, expected);
+            const uint8_t* actual = png.rgba.data() + 4 * (y * png.width + x);
+            ASSERT_EQ(actual[0], expected[0]);
+            ASSERT_EQ(actual[1], expected[1]);
+            ASSERT_EQ(actual[2], expected[2]);
+        }
+    }
+}
+
+TEST_F(IdleTranscoderTest, ActivityPostponesTranscode) {
+    const std::string source = WriteQoi("busy.qoi");
+    IdleTranscoder transcoder(std::chrono::milliseconds(200));
+    std::atomic<bool> finished(false);
+    std::promise<void> done;
+    transcoder.Enqueue(source, PathFor("busy.png"), [&](TranscodeResult) {
+        finished = true;
+        done.set_value();
+    });
+
+    // 持续有截图活动时不转码
+    for (int i = 0; i < 8; i++) {
+        transcoder.NotifyActivity();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_FALSE(finished.load());
+    EXPECT_EQ(transcoder.pending(), 1u);
+
+    done.get_future().wait();
+    EXPECT_TRUE(fs::exists(fs::u8path(PathFor("busy.png"))));
+}
+
+TEST_F(IdleTranscoderTest, MissingOrCorruptSourceReportsFailed) {
+    std::string corrupt = PathFor("corrupt.qoi");
+    std::ofstream(fs::u8path(corrupt), std::ios::binary) << "qoif-not-really";
+
+    IdleTranscoder transcoder(std::chrono::milliseconds(0));
+    std::promise<TranscodeResult> missing;
+    std::promise<TranscodeResult> broken;
+    transcoder.Enqueue(PathFor("missing.qoi"), PathFor("missing.png"),
+                       [&](TranscodeResult result) { missing.set_value(std::move(result)); });
+    transcoder.Enqueue(corrupt, PathFor("corrupt.png"),
+                       [&](TranscodeResult result) { broken.set_value(std::move(result)); });
+
+    EXPECT_EQ(missing.get_future().get().status, TranscodeStatus::kFailed);
+    EXPECT_EQ(broken.get_future().get().status, TranscodeStatus::kFailed);
+    // 失败时源文件保留，也不留下半个 PNG
+    EXPECT_TRUE(fs::exists(fs::u8path(corrupt)));
+    EXPECT_FALSE(fs::exists(fs::u8path(PathFor("corrupt.png"))));
+    EXPECT_FALSE(fs::exists(fs::u8path(PathFor("corrupt.png.tmp"))));
+}
+
+TEST_F(IdleTranscoderTest, DestructorCancelsPendingFilesAndKeepsSources) {
+    const std::string source = WriteQoi("later.qoi");
+    std::atomic<int> cancelled(0);
+    {
+        IdleTranscoder transcoder(std::chrono::hours(1));
+        transcoder.Enqueue(source, PathFor("later.png"), [&](TranscodeResult result) {
+            if (result.status == TranscodeStatus::kCancelled) ++cancelled;
+        });
+    }
+    EXPECT_EQ(cancelled.load(), 1);
+    EXPECT_TRUE(fs::exists(fs::u8path(source)));
+    EXPECT_FALSE(fs::exists(fs::u8path(PathFor("later.png"))));
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,131 @@
+#include "capture_core/job_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+
+#include <gtest/gtest.h>
+
+namespace capture_core {
+namespace {
+
+// 占住唯一的工作线程，直到 release 被设置
+struct Blocker {
+    std::promise<void> started;
+    std::promise<void> release;
+
+    JobQueue::RunFunction Run() {
+        return [this](const CancellationToken&) {
+            started.set_value();
+            release.get_future().wait();
+        };
+    }
+};
+
+TEST(JobQueueTest, RunsSubmittedJobs) {
+    JobQueue queue(2, 8);
+    std::atomic<int> done(0);
+    std::promise<void> all_done;
+    for (int i = 0; i < 5; i++) {
+        ASSERT_NE(queue.Submit(
+                      [&](const CancellationToken&) {
+                          if (++done == 5) all_done.set_value();
+                      },
+                      nullptr),
+                  0u);
+    }
+    all_done.get_future().wait();
+    EXPECT_EQ(done.load(), 5);
+}
+
+TEST(JobQueueTest, RejectsWhenFull) {
+    JobQueue queue(1, 2);
+    Blocker blocker;
+    ASSERT_NE(queue.Submit(blocker.Run(), nullptr), 0u);
+    blocker.started.get_future().wait();
+
+    EXPECT_NE(queue.Submit([](const CancellationToken&) {}, nullptr), 0u);
+    EXPECT_NE(queue.Submit([](const CancellationToken&) {}, nullptr), 0u);
+    EXPECT_EQ(queue.Submit([](const CancellationToken&) {}, nullptr), 0u);
+    EXPECT_EQ(queue.pending(), 2u);
+    blocker.release.set_value();
+}
+
+TEST(JobQueueTest, CancelledPendingJobNeverRuns) {
+    JobQueue queue(1, 4);
+    Blocker blocker;
+    queue.Submit(blocker.Run(), nullptr);
+    blocker.started.get_future().wait();
+
+    bool ran = false;
+    bool cancelled = false;
+    JobId id = queue.Submit([&](const CancellationToken&) { ran = true; },
+                            [&] { cancelled = true; });
+    ASSERT_NE(id, 0u);
+    EXPECT_TRUE(queue.Cancel(id));
+    EXPECT_TRUE(cancelled);
+    EXPECT_FALSE(queue.Cancel(id));
+
+    blocker.release.set_value();
+    // 析构时等待工作线程退出
+}
+
+TEST(JobQueueTest, RunningJobObservesCancellation) {
+    JobQueue queue(1, 4);
+    std::promise<void> started;
+    std::promise<bool> observed;
+    JobId id = queue.Submit(
+        [&](const CancellationToken& token) {
+            started.set_value();
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+            while (!token.cancelled() && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+            observed.set_value(token.cancelled());
+        },
+        nullptr);
+    started.get_future().wait();
+    EXPECT_TRUE(queue.Cancel(id));
+    EXPECT_TRUE(observed.get_future().get());
+}
+
+TEST(JobQueueTest, CancelAllCountsQueuedAndRunningJobs) {
+    std::atomic<int> cancelled(0);
+    Blocker blocker;
+    JobQueue queue(1, 4);
+    queue.Submit(blocker.Run(), nullptr);
+    blocker.started.get_future().wait();
+    for (int i = 0; i < 3; i++) {
+        queue.Submit([](const CancellationToken&) { FAIL() << "should not run"; },
+                     [&] { cancelled++; });
+    }
+    EXPECT_EQ(queue.CancelAll(), 4u);
+    EXPECT_EQ(cancelled.load(), 3);
+    EXPECT_EQ(queue.pending(), 0u);
+    EXPECT_EQ(queue.running(), 1u);
+    blocker.release.set_value();
+}
+
+TEST(JobQueueTest, DestructorCancelsPendingAndSignalsRunningJobs) {
+    std::atomic<int> cancelled(0);
+    std::promise<void> started;
+    {
+        JobQueue queue(1, 4);
+        // 正在运行的任务一直等到收到取消标记
+        queue.Submit(
+            [&](const CancellationToken& token) {
+                started.set_value();
+                while (!token.cancelled()) std::this_thread::yield();
+            },
+            nullptr);
+        started.get_future().wait();
+        for (int i = 0; i < 2; i++) {
+            queue.Submit([](const CancellationToken&) { FAIL() << "should not run"; },
+                         [&] { cancelled++; });
+        }
+    }
+    EXPECT_EQ(cancelled.load(), 2);
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,195 @@
+#include "capture_core/jpeg_encoder.h"
+
+#include <gtest/gtest.h>
+
+#include <csetjmp>
+#include <cstdio>
+#include <cstdlib>
+
+#include <jpeglib.h>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "capture_core/thread_pool.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+struct DecodedJpeg {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> rgb;
+};
+
+struct DecodeError {
+    jpeg_error_mgr pub;
+    jmp_buf jump;
+};
+
+void DecodeErrorExit(j_common_ptr cinfo) {
+    longjmp(reinterpret_cast<DecodeError*>(cinfo->err)->jump, 1);
+}
+
+// 用 libjpeg 解码成 RGB；失败返回 false
+bool DecodeJpeg(const std::vector<uint8_t>& jpeg, DecodedJpeg* decoded) {
+    jpeg_decompress_struct cinfo;
+    DecodeError error;
+    cinfo.err = jpeg_std_error(&error.pub);
+    error.pub.error_exit = DecodeErrorExit;
+    if (setjmp(error.jump)) {
+        jpeg_destroy_decompress(&cinfo);
+        return false;
+    }
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, const_cast<unsigned char*>(jpeg.data()),
+                 static_cast<unsigned long>(jpeg.size()));
+    jpeg_read_header(&cinfo, TRUE);
+    cinfo.out_color_space = JCS_RGB;
+    jpeg_start_decompress(&cinfo);
+    decoded->width = static_cast<int>(cinfo.output_width);
+    decoded->height = static_cast<int>(cinfo.output_height);
+    decoded->rgb.resize(static_cast<size_t>(decoded->width) * decoded->height * 3);
+    while (cinfo.output_scanline < cinfo.output_height) {
+        JSAMPROW row = decoded->rgb.data() +
+                       static_cast<size_t>(cinfo.output_scanline) * decoded->width * 3;
+        jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+    return true;
+}
+
+int CountRestartMarkers(const std::vector<uint8_t>& jpeg) {
+    int count = 0;
+    for (size_t i = 0; i + 1 < jpeg.size(); i++) {
+        if (jpeg[i] == 0xFF && jpeg[i + 1] >= 0xD0 && jpeg[i + 1] <= 0xD7) {
+            count++;
+        }
+    }
+    return count;
+}
+
+TEST(JpegEncoderTest, EncodesDecodableJpegCloseToSource) {
+    FrameBuffer frame(37, 21, PixelFormat::kBgrx8);
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < frame.width(); x++) {
+            uint8_t* p = frame.row(y) + 4 * x;
+            p[0] = 40;
+            p[1] = 120;
+            p[2] = 200;
+            p[3] = 0;
+        }
+    }
+    JpegEncoder encoder;
+    std::vector<uint8_t> jpeg;
+    ASSERT_TRUE(encoder.Encode(frame, &jpeg));
+    ASSERT_GE(jpeg.size(), 4u);
+    EXPECT_EQ(jpeg[0], 0xFF);
+    EXPECT_EQ(jpeg[1], 0xD8);
+    EXPECT_EQ(jpeg[jpeg.size() - 2], 0xFF);
+    EXPECT_EQ(jpeg[jpeg.size() - 1], 0xD9);
+
+    DecodedJpeg decoded;
+    ASSERT_TRUE(DecodeJpeg(jpeg, &decoded));
+    EXPECT_EQ(decoded.width, 37);
+    EXPECT_EQ(decoded.height, 21);
+    EXPECT_NEAR(decoded.rgb[0], 200, 4);
+    EXPECT_NEAR(decoded.rgb[1], 120, 4);
+    EXPECT_NEAR(decoded.rgb[2], 40, 4);
+}
+
+class JpegStripTest : public ::testing::TestWithParam<JpegSubsampling> {};
+
+TEST_P(JpegStripTest, ParallelStripsDecodeIdenticallyToOneStrip) {
+    FrameBuffer frame = testing::SyntheticFrame(333, 250, SyntheticFrameSource::Pattern::kNoise);
+    ThreadPool pool(3);
+
+    JpegEncoderOptions options;
+    options.subsampling = GetParam();
+    options.pool = &pool;
+    options.strip_rows = 10000;
+    JpegEncoder single(options);
+    std::vector<uint8_t> single_jpeg;
+    ASSERT_TRUE(single.Encode(frame, &single_jpeg));
+    EXPECT_EQ(single.last_strip_count(), 1);
+    EXPECT_EQ(CountRestartMarkers(single_jpeg), 0);
+
+    // 条带行数不是 MCU 高度的倍数时向上取整
+    options.strip_rows = 20;
+    JpegEncoder striped(options);
+    std::vector<uint8_t> striped_jpeg;
+    ASSERT_TRUE(striped.Encode(frame, &striped_jpeg));
+    EXPECT_GE(striped.last_strip_count(), 8);
+    EXPECT_EQ(CountRestartMarkers(striped_jpeg), striped.last_strip_count() - 1);
+
+    // restart 区间不影响 DCT 系数，解码结果逐像素相同
+    DecodedJpeg a;
+    DecodedJpeg b;
+    ASSERT_TRUE(DecodeJpeg(single_jpeg, &a));
+    ASSERT_TRUE(DecodeJpeg(striped_jpeg, &b));
+    EXPECT_EQ(b.width, 333);
+    EXPECT_EQ(b.height, 250);
+    EXPECT_EQ(a.rgb, b.rgb);
+
+    // 编码器复用条带状态，再编码一次结果不变
+    std::vector<uint8_t> again;
+    ASSERT_TRUE(striped.Encode(frame, &again));
+    EXPECT_EQ(again, striped_jpeg);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllSubsampling, JpegStripTest,
+                         ::testing::Values(JpegSubsampling::k444, JpegSubsampling::k422,
+                                           JpegSubsampling::k420));
+
+TEST(JpegEncoderTest, LowerQualityProducesSmallerFiles) {
+    FrameBuffer frame = testing::SyntheticFrame(256, 256, SyntheticFrameSource::Pattern::kNoise);
+    JpegEncoderOptions options;
+    options.quality = 95;
+    JpegEncoder encoder(options);
+    std::vector<uint8_t> high;
+    ASSERT_TRUE(encoder.Encode(frame, &high));
+    encoder.set_quality(40);
+    std::vector<uint8_t> low;
+    ASSERT_TRUE(encoder.Encode(frame, &low));
+    EXPECT_LT(low.size(), high.size());
+}
+
+TEST(JpegEncoderTest, AlphaChannelIsIgnoredForEveryFormat) {
+    FrameBuffer bgrx = testing::SyntheticFrame(64, 48, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer bgra(64, 48, PixelFormat::kBgra8);
+    FrameBuffer rgba(64, 48, PixelFormat::kRgba8);
+    for (int y = 0; y < 48; y++) {
+        for (int x = 0; x < 64; x++) {
+            const uint8_t* s = bgrx.row(y) + 4 * x;
+            uint8_t* a = bgra.row(y) + 4 * x;
+            uint8_t* r = rgba.row(y) + 4 * x;
+            a[0] = s[0];
+            a[1] = s[1];
+            a[2] = s[2];
+            a[3] = static_cast<uint8_t>(x * 4);
+            r[0] = s[2];
+            r[1] = s[1];
+            r[2] = s[0];
+            r[3] = static_cast<uint8_t>(y * 5);
+        }
+    }
+
+    JpegEncoder encoder;
+    std::vector<uint8_t> from_bgrx;
+    std::vector<uint8_t> from_bgra;
+    std::vector<uint8_t> from_rgba;
+    ASSERT_TRUE(encoder.Encode(bgrx, &from_bgrx));
+    ASSERT_TRUE(encoder.Encode(bgra, &from_bgra));
+    ASSERT_TRUE(encoder.Encode(rgba, &from_rgba));
+    EXPECT_EQ(from_bgrx, from_bgra);
+    EXPECT_EQ(from_bgrx, from_rgba);
+}
+
+TEST(JpegEncoderTest, RejectsEmptyFrame) {
+    JpegEncoder encoder;
+    std::vector<uint8_t> jpeg;
+    EXPECT_FALSE(encoder.Encode(FrameBuffer(), &jpeg));
+}
+
+}  // namespace
+}  // namespace capture_core
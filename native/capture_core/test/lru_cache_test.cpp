@@ -0,0 +1,59 @@
+#include "capture_core/lru_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace capture_core {
+namespace {
+
+TEST(LruCacheTest, EvictsTheLeastRecentlyUsedEntry) {
+    LruCache<std::string, int> cache(2);
+    cache.Put("a", 1);
+    cache.Put("b", 2);
+    // 访问 a 之后 b 成为最久未使用
+    ASSERT_NE(cache.Find("a"), nullptr);
+    cache.Put("c", 3);
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.Find("b"), nullptr);
+    ASSERT_NE(cache.Find("a"), nullptr);
+    EXPECT_EQ(*cache.Find("c"), 3);
+    EXPECT_EQ(cache.stats().evictions, 1u);
+}
+
+TEST(LruCacheTest, CountsHitsAndMisses) {
+    LruCache<int, std::vector<int>> cache(4);
+    EXPECT_EQ(cache.Find(1), nullptr);
+    cache.Put(1, {1, 2, 3});
+    ASSERT_NE(cache.Find(1), nullptr);
+    EXPECT_EQ(cache.Find(1)->size(), 3u);
+    EXPECT_EQ(cache.Find(2), nullptr);
+
+    EXPECT_EQ(cache.stats().hits, 2u);
+    EXPECT_EQ(cache.stats().misses, 2u);
+    EXPECT_EQ(cache.stats().evictions, 0u);
+}
+
+TEST(LruCacheTest, PutReplacesAndRefreshesExistingKey) {
+    LruCache<int, std::string> cache(2);
+    cache.Put(1, "one");
+    cache.Put(2, "two");
+    // 替换 1 也算一次使用，之后淘汰的是 2
+    EXPECT_EQ(cache.Put(1, "uno"), "uno");
+    cache.Put(3, "three");
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(*cache.Find(1), "uno");
+    EXPECT_EQ(cache.Find(2), nullptr);
+
+    EXPECT_TRUE(cache.Erase(1));
+    EXPECT_FALSE(cache.Erase(1));
+    EXPECT_EQ(cache.size(), 1u);
+    cache.Clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.Find(3), nullptr);
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,187 @@
+#include "capture_core/multi_monitor_capture.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace capture_core {
+namespace {
+
+// 按绝对屏幕坐标着色的桌面，副屏可以在负坐标
+class DesktopPatternSource : public FrameSource {
+public:
+    explicit DesktopPatternSource(const Rect& desktop) : desktop_(desktop) {}
+
+    static uint8_t Channel(int x, int y, int c) {
+        return static_cast<uint8_t>((x * 7 + y * 13 + c * 61) & 0xFF);
+    }
+
+    Rect GetBounds() override { return desktop_; }
+
+    bool Capture(const Rect& region, FrameBuffer* frame) override {
+        Rect clipped = IntersectRects(region, desktop_);
+        if (clipped.empty()) return false;
+        frame->Allocate(clipped.width, clipped.height, PixelFormat::kBgrx8);
+        for (int y = 0; y < clipped.height; y++) {
+            uint8_t* out = frame->row(y);
+            for (int x = 0; x < clipped.width; x++, out += 4) {
+                for (int c = 0; c < 3; c++) {
+                    out[c] = Channel(clipped.x + x, clipped.y + y, c);
+                }
+                out[3] = 0;
+            }
+        }
+        return true;
+    }
+
+private:
+    Rect desktop_;
+};
+
+// 等到所有显示器都进入 Capture 才返回，用来验证抓取是并行的
+class RendezvousSource : public DesktopPatternSource {
+public:
+    struct Rendezvous {
+        std::mutex mutex;
+        std::condition_variable cv;
+        int arrived = 0;
+        int expected = 0;
+    };
+
+    RendezvousSource(const Rect& desktop, Rendezvous* rendezvous)
+        : DesktopPatternSource(desktop), rendezvous_(rendezvous) {}
+
+    bool Capture(const Rect& region, FrameBuffer* frame) override {
+        std::unique_lock<std::mutex> lock(rendezvous_->mutex);
+        rendezvous_->arrived++;
+        rendezvous_->cv.notify_all();
+        bool all = rendezvous_->cv.wait_for(lock, std::chrono::seconds(5), [&] {
+            return rendezvous_->arrived >= rendezvous_->expected;
+        });
+        lock.unlock();
+        return all && DesktopPatternSource::Capture(region, frame);
+    }
+
+private:
+    Rendezvous* rendezvous_;
+};
+
+std::vector<MonitorInfo> ThreeMonitors() {
+    // 左侧竖屏在负坐标，主屏居中，右侧小屏顶端对齐，下方留有空隙
+    std::vector<MonitorInfo> monitors(3);
+    monitors[0].index = 0;
+    monitors[0].bounds = Rect(-60, -20, 60, 100);
+    monitors[1].index = 1;
+    monitors[1].bounds = Rect(0, 0, 120, 80);
+    monitors[1].primary = true;
+    monitors[2].index = 2;
+    monitors[2].bounds = Rect(120, 0, 64, 48);
+    return monitors;
+}
+
+TEST(MultiMonitorCaptureTest, VirtualDesktopBoundsCoverAllMonitors) {
+    EXPECT_EQ(VirtualDesktopBounds(ThreeMonitors()), Rect(-60, -20, 244, 100));
+    EXPECT_TRUE(VirtualDesktopBounds({}).empty());
+}
+
+TEST(MultiMonitorCaptureTest, CaptureEachReturnsPerMonitorFrames) {
+    std::vector<MonitorInfo> monitors = ThreeMonitors();
+    Rect desktop = VirtualDesktopBounds(monitors);
+    ThreadPool pool(2);
+    MultiMonitorCapture capture(
+        monitors,
+        [&](const MonitorInfo&) { return std::make_unique<DesktopPatternSource>(desktop); },
+        &pool);
+
+    ASSERT_TRUE(capture.CaptureEach());
+    for (size_t i = 0; i < monitors.size(); i++) {
+        const Rect& bounds = monitors[i].bounds;
+        FrameBuffer& frame = capture.frame(i);
+        ASSERT_EQ(frame.width(), bounds.width);
+        ASSERT_EQ(frame.height(), bounds.height);
+        EXPECT_EQ(frame.row(3)[4 * 5 + 1], DesktopPatternSource::Channel(bounds.x + 5, bounds.y + 3, 1));
+    }
+}
+
+TEST(MultiMonitorCaptureTest, VirtualDesktopIsStitchedWithBlackGaps) {
+    std::vector<MonitorInfo> monitors = ThreeMonitors();
+    Rect desktop = VirtualDesktopBounds(monitors);
+    ThreadPool pool(2);
+    MultiMonitorCapture capture(
+        monitors,
+        [&](const MonitorInfo&) { return std::make_unique<DesktopPatternSource>(desktop); },
+        &pool);
+
+    FrameBuffer frame;
+    ASSERT_TRUE(capture.CaptureVirtualDesktop(&frame));
+    ASSERT_EQ(frame.width(), desktop.width);
+    ASSERT_EQ(frame.height(), desktop.height);
+
+    for (int y = 0; y < desktop.height; y++) {
+        for (int x = 0; x < desktop.width; x++) {
+            int sx = desktop.x + x;
+            int sy = desktop.y + y;
+            bool on_monitor = false;
+            for (const MonitorInfo& monitor : monitors) {
+                on_monitor = on_monitor || monitor.bounds.Contains(sx, sy);
+            }
+            const uint8_t* px = frame.row(y) + 4 * x;
+            for (int c = 0; c < 3; c++) {
+                uint8_t expected = on_monitor ? DesktopPatternSource::Channel(sx, sy, c) : 0;
+                ASSERT_EQ(px[c], expected) << "at " << sx << "," << sy;
+            }
+        }
+    }
+}
+
+TEST(MultiMonitorCaptureTest, WritesIntoPresizedExternalBuffer) {
+    std::vector<MonitorInfo> monitors = ThreeMonitors();
+    Rect desktop = VirtualDesktopBounds(monitors);
+    MultiMonitorCapture capture(
+        monitors,
+        [&](const MonitorInfo&) { return std::make_unique<DesktopPatternSource>(desktop); });
+
+    // 模拟 DIB section：步长比宽度大
+    const int stride = desktop.width * 4 + 64;
+    std::vector<uint8_t> external(static_cast<size_t>(stride) * desktop.height, 0xCC);
+    FrameBuffer frame;
+    frame.Wrap(external.data(), desktop.width, desktop.height, stride, PixelFormat::kBgrx8);
+
+    ASSERT_TRUE(capture.CaptureVirtualDesktop(&frame));
+    EXPECT_EQ(frame.data(), external.data());
+    EXPECT_FALSE(frame.owns_memory());
+    // 主屏 (0, 0) 在虚拟桌面中的偏移是 (60, 20)
+    EXPECT_EQ(frame.row(20)[4 * 60], DesktopPatternSource::Channel(0, 0, 0));
+}
+
+TEST(MultiMonitorCaptureTest, MonitorsAreCapturedConcurrently) {
+    std::vector<MonitorInfo> monitors = ThreeMonitors();
+    Rect desktop = VirtualDesktopBounds(monitors);
+    RendezvousSource::Rendezvous rendezvous;
+    rendezvous.expected = static_cast<int>(monitors.size());
+
+    // 调用线程 + 2 个工作线程，刚好每个显示器一个线程
+    ThreadPool pool(2);
+    MultiMonitorCapture capture(
+        monitors,
+        [&](const MonitorInfo&) {
+            return std::make_unique<RendezvousSource>(desktop, &rendezvous);
+        },
+        &pool);
+    EXPECT_TRUE(capture.CaptureEach());
+}
+
+TEST(MultiMonitorCaptureTest, FailsWhenAMonitorCannotBeCaptured) {
+    std::vector<MonitorInfo> monitors = ThreeMonitors();
+    // 来源只覆盖主屏，副屏已经不存在
+    MultiMonitorCapture capture(monitors, [&](const MonitorInfo&) {
+        return std::make_unique<DesktopPatternSource>(monitors[1].bounds);
+    });
+    FrameBuffer frame;
+    EXPECT_FALSE(capture.CaptureVirtualDesktop(&frame));
+}
+
+}  // namespace
+}  // namespace capture_core
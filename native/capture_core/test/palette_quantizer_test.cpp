@@ -0,0 +1,130 @@
+#include "capture_core/palette_quantizer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <set>
+#include <vector>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+uint32_t PixelRgb(const FrameBuffer& frame, int x, int y) {
+    const uint8_t* p = frame.row(y) + 4 * x;
+    return uint32_t(p[2]) | (uint32_t(p[1]) << 8) | (uint32_t(p[0]) << 16);
+}
+
+uint32_t PaletteRgb(const Palette& palette, int index) {
+    return uint32_t(palette.rgb[index * 3]) | (uint32_t(palette.rgb[index * 3 + 1]) << 8) |
+           (uint32_t(palette.rgb[index * 3 + 2]) << 16);
+}
+
+TEST(PaletteQuantizerTest, FewColorsAreExact) {
+    FrameBuffer frame = testing::SyntheticFrame(300, 200, SyntheticFrameSource::Pattern::kUi);
+    std::set<uint32_t> colors;
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < frame.width(); x++) colors.insert(PixelRgb(frame, x, y));
+    }
+    ASSERT_LE(colors.size(), 256u);
+
+    PaletteQuantizer quantizer;
+    Palette palette;
+    quantizer.Build(frame, frame.bounds(), nullptr, 256, &palette);
+    EXPECT_TRUE(quantizer.exact());
+    EXPECT_EQ(palette.size, static_cast<int>(colors.size()));
+
+    std::vector<uint8_t> indices(static_cast<size_t>(frame.width()) * frame.height());
+    quantizer.Map(frame, frame.bounds(), nullptr, 0, indices.data());
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < frame.width(); x++) {
+            const int index = indices[static_cast<size_t>(y) * frame.width() + x];
+            ASSERT_LT(index, palette.size);
+            ASSERT_EQ(PaletteRgb(palette, index), PixelRgb(frame, x, y)) << x << "," << y;
+        }
+    }
+}
+
+TEST(PaletteQuantizerTest, ManyColorsUseMedianCutWithinLimit) {
+    FrameBuffer frame = testing::SyntheticFrame(256, 192, SyntheticFrameSource::Pattern::kNoise);
+    PaletteQuantizer quantizer;
+    Palette palette;
+    quantizer.Build(frame, frame.bounds(), nullptr, 255, &palette);
+    EXPECT_FALSE(quantizer.exact());
+    EXPECT_GT(palette.size, 200);
+    EXPECT_LE(palette.size, 255);
+
+    // 每个像素映射到的颜色与原色的平均误差很小
+    std::vector<uint8_t> indices(static_cast<size_t>(frame.width()) * frame.height());
+    quantizer.Map(frame, frame.bounds(), nullptr, 0, indices.data());
+    uint64_t error = 0;
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < frame.width(); x++) {
+            const int index = indices[static_cast<size_t>(y) * frame.width() + x];
+            ASSERT_LT(index, palette.size);
+            const uint32_t a = PaletteRgb(palette, index);
+            const uint32_t b = PixelRgb(frame, x, y);
+            for (int shift = 0; shift < 24; shift += 8) {
+                error += std::abs(int((a >> shift) & 0xFF) - int((b >> shift) & 0xFF));
+            }
+        }
+    }
+    const double mean = double(error) / (3.0 * frame.width() * frame.height());
+    EXPECT_LT(mean, 12.0);
+}
+
+TEST(PaletteQuantizerTest, SkippedPixelsAreExcludedAndMappedToSkipIndex) {
+    FrameBuffer frame = testing::SyntheticFrame(64, 32, SyntheticFrameSource::Pattern::kUi);
+    // 左半边涂成一种右半边没有的颜色，再把左半边全部跳过
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < 32; x++) {
+            uint8_t* p = frame.row(y) + 4 * x;
+            p[0] = 0x11;
+            p[1] = 0x22;
+            p[2] = 0x33;
+        }
+    }
+    const Rect region(0, 0, 64, 32);
+    std::vector<uint8_t> skip(64 * 32, 0);
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 32; x++) skip[y * 64 + x] = 1;
+    }
+
+    PaletteQuantizer quantizer;
+    Palette palette;
+    quantizer.Build(frame, region, skip.data(), 255, &palette);
+    ASSERT_TRUE(quantizer.exact());
+    for (int i = 0; i < palette.size; i++) {
+        EXPECT_NE(PaletteRgb(palette, i), 0x112233u);
+    }
+
+    std::vector<uint8_t> indices(64 * 32);
+    quantizer.Map(frame, region, skip.data(), 255, indices.data());
+    for (int y = 0; y < 32; y++) {
+        EXPECT_EQ(indices[y * 64 + 5], 255);
+        EXPECT_EQ(PaletteRgb(palette, indices[y * 64 + 40]), PixelRgb(frame, 40, y));
+    }
+}
+
+TEST(PaletteQuantizerTest, SubRegionIsMappedCompactly) {
+    FrameBuffer frame = testing::SyntheticFrame(120, 80, SyntheticFrameSource::Pattern::kGradient);
+    const Rect region(30, 20, 17, 9);
+    PaletteQuantizer quantizer;
+    Palette palette;
+    quantizer.Build(frame, region, nullptr, 256, &palette);
+    ASSERT_TRUE(quantizer.exact());
+
+    std::vector<uint8_t> indices(static_cast<size_t>(region.width) * region.height);
+    quantizer.Map(frame, region, nullptr, 0, indices.data());
+    for (int y = 0; y < region.height; y++) {
+        for (int x = 0; x < region.width; x++) {
+            EXPECT_EQ(PaletteRgb(palette, indices[y * region.width + x]),
+                      PixelRgb(frame, region.x + x, region.y + y));
+        }
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
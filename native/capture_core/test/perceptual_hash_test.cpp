@@ -0,0 +1,109 @@
+#include "capture_core/perceptual_hash.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "capture_core/pixel_convert.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "capture_core/thread_pool.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+FrameBuffer Copy(const FrameBuffer& frame) {
+    FrameBuffer copy;
+    copy.CopyFrom(frame);
+    return copy;
+}
+
+void FillRect(FrameBuffer* frame, int x, int y, int width, int height, uint8_t value) {
+    for (int row = y; row < y + height; row++) {
+        uint8_t* p = frame->row(row) + 4 * x;
+        for (int col = 0; col < width; col++, p += 4) {
+            p[0] = value;
+            p[1] = value;
+            p[2] = value;
+        }
+    }
+}
+
+TEST(PerceptualHashTest, HammingDistanceCountsDifferingBits) {
+    EXPECT_EQ(HammingDistance(0, 0), 0);
+    EXPECT_EQ(HammingDistance(0, ~uint64_t{0}), 64);
+    EXPECT_EQ(HammingDistance(0x0F, 0xF0), 8);
+    EXPECT_EQ(HammingDistance(uint64_t{1} << 63, 0), 1);
+}
+
+TEST(PerceptualHashTest, EmptyFrameHashesToZero) {
+    EXPECT_EQ(DifferenceHash(FrameBuffer()), 0u);
+}
+
+TEST(PerceptualHashTest, SmallChangesKeepTheHashClose) {
+    FrameBuffer frame = testing::SyntheticFrame(1280, 720, SyntheticFrameSource::Pattern::kUi);
+    const uint64_t hash = DifferenceHash(frame);
+
+    // 闪烁的光标和跳动的时钟
+    FrameBuffer cursor = Copy(frame);
+    FillRect(&cursor, 600, 300, 2, 18, 0x00);
+    FillRect(&cursor, 1180, 700, 60, 14, 0xFF);
+    EXPECT_LE(HammingDistance(hash, DifferenceHash(cursor)), 2);
+
+    // 整体变暗、降低对比度不改变相邻格子的明暗关系
+    FrameBuffer dimmed = Copy(frame);
+    for (int y = 0; y < dimmed.height(); y++) {
+        uint8_t* p = dimmed.row(y);
+        for (int x = 0; x < dimmed.width() * 4; x++) {
+            p[x] = static_cast<uint8_t>(p[x] * 3 / 4 + 32);
+        }
+    }
+    EXPECT_LE(HammingDistance(hash, DifferenceHash(dimmed)), 4);
+}
+
+TEST(PerceptualHashTest, DifferentContentIsFarApart) {
+    const uint64_t ui =
+        DifferenceHash(testing::SyntheticFrame(1280, 720, SyntheticFrameSource::Pattern::kUi));
+    const uint64_t photo = DifferenceHash(
+        testing::SyntheticFrame(1280, 720, SyntheticFrameSource::Pattern::kGradient));
+    EXPECT_GT(HammingDistance(ui, photo), 10);
+
+    // 窗口换成另一块内容
+    FrameBuffer frame = testing::SyntheticFrame(1280, 720, SyntheticFrameSource::Pattern::kUi);
+    FillRect(&frame, 0, 0, 640, 720, 0xFF);
+    FillRect(&frame, 0, 0, 160, 720, 0x00);
+    EXPECT_GT(HammingDistance(ui, DifferenceHash(frame)), 10);
+}
+
+TEST(PerceptualHashTest, IndependentOfChannelOrderAndScale) {
+    FrameBuffer frame = testing::SyntheticFrame(1280, 720, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer rgba;
+    rgba.Allocate(frame.width(), frame.height(), PixelFormat::kRgba8);
+    for (int y = 0; y < frame.height(); y++) {
+        SwapRedBlueOpaque(frame.row(y), rgba.row(y), static_cast<size_t>(frame.width()));
+    }
+    EXPECT_EQ(DifferenceHash(frame), DifferenceHash(rgba));
+
+    // 同一画面的一半尺寸
+    FrameBuffer half;
+    half.Allocate(frame.width() / 2, frame.height() / 2, PixelFormat::kBgrx8);
+    for (int y = 0; y < half.height(); y++) {
+        for (int x = 0; x < half.width(); x++) {
+            std::copy_n(frame.row(2 * y) + 8 * x, 4, half.row(y) + 4 * x);
+        }
+    }
+    EXPECT_LE(HammingDistance(DifferenceHash(frame), DifferenceHash(half)), 6);
+}
+
+TEST(PerceptualHashTest, TinyFramesAndSerialPoolAgree) {
+    FrameBuffer tiny = testing::SyntheticFrame(5, 3, SyntheticFrameSource::Pattern::kGradient);
+    ThreadPool serial(0);
+    EXPECT_EQ(DifferenceHash(tiny, &serial), DifferenceHash(tiny));
+
+    FrameBuffer frame = testing::SyntheticFrame(1001, 333, SyntheticFrameSource::Pattern::kUi);
+    ThreadPool parallel(4);
+    EXPECT_EQ(DifferenceHash(frame, &serial), DifferenceHash(frame, &parallel));
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,246 @@
+#include "capture_core/pixel_convert.h"
+
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace capture_core {
+namespace {
+
+const SimdLevel kAllLevels[] = {SimdLevel::kSse2, SimdLevel::kAvx2, SimdLevel::kNeon};
+
+// 覆盖向量宽度的整数倍、尾部和很短的输入
+const size_t kPixelCounts[] = {0, 1, 3, 4, 7, 8, 11, 15, 16, 17, 33, 64, 1001};
+
+std::vector<uint8_t> RandomBytes(size_t length, uint32_t seed) {
+    std::vector<uint8_t> bytes(length);
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bytes[i] = static_cast<uint8_t>(seed >> 24);
+    }
+    return bytes;
+}
+
+class PixelConvertTest : public ::testing::TestWithParam<SimdLevel> {
+protected:
+    void SetUp() override {
+        kernels_ = GetPixelKernels(GetParam());
+        if (kernels_ == nullptr) {
+            GTEST_SKIP() << SimdLevelName(GetParam()) << " not available";
+        }
+        scalar_ = GetPixelKernels(SimdLevel::kScalar);
+    }
+
+    // 比较 4 字节/像素 -> out_bpp 字节/像素的内核；输出末尾留哨兵检查越界写
+    template <typename Kernel>
+    void ExpectMatchesScalar(Kernel simd, Kernel scalar, int in_bpp, int out_bpp) {
+        for (size_t pixels : kPixelCounts) {
+            std::vector<uint8_t> src = RandomBytes(pixels * in_bpp, static_cast<uint32_t>(pixels));
+            std::vector<uint8_t> expected(pixels * out_bpp + 8, 0xAB);
+            std::vector<uint8_t> actual(pixels * out_bpp + 8, 0xAB);
+            scalar(src.data(), expected.data(), pixels);
+            simd(src.data(), actual.data(), pixels);
+            ASSERT_EQ(expected, actual) << pixels << " pixels";
+        }
+    }
+
+    const PixelKernels* kernels_ = nullptr;
+    const PixelKernels* scalar_ = nullptr;
+};
+
+TEST_P(PixelConvertTest, SwapRedBlueMatchesScalar) {
+    ExpectMatchesScalar(kernels_->swap_red_blue, scalar_->swap_red_blue, 4, 4);
+}
+
+TEST_P(PixelConvertTest, SwapRedBlueOpaqueMatchesScalar) {
+    ExpectMatchesScalar(kernels_->swap_red_blue_opaque, scalar_->swap_red_blue_opaque, 4, 4);
+}
+
+TEST_P(PixelConvertTest, BgrxToRgbMatchesScalar) {
+    ExpectMatchesScalar(kernels_->bgrx_to_rgb, scalar_->bgrx_to_rgb, 4, 3);
+}
+
+TEST_P(PixelConvertTest, Bgr24ToBgraMatchesScalar) {
+    ExpectMatchesScalar(kernels_->bgr24_to_bgra, scalar_->bgr24_to_bgra, 3, 4);
+}
+
+TEST_P(PixelConvertTest, ForceOpaqueMatchesScalar) {
+    for (size_t pixels : kPixelCounts) {
+        std::vector<uint8_t> expected = RandomBytes(pixels * 4 + 8, 7);
+        std::vector<uint8_t> actual = expected;
+        scalar_->force_opaque(expected.data(), pixels);
+        kernels_->force_opaque(actual.data(), pixels);
+        ASSERT_EQ(expected, actual) << pixels << " pixels";
+    }
+}
+
+TEST_P(PixelConvertTest, HashRowMatchesScalar) {
+    for (size_t pixels : kPixelCounts) {
+        const std::vector<uint8_t> src = RandomBytes(pixels * 4, static_cast<uint32_t>(pixels));
+        for (uint32_t mask : {0xFFFFFFFFu, 0x00FFFFFFu}) {
+            ASSERT_EQ(scalar_->hash_row(src.data(), pixels, mask),
+                      kernels_->hash_row(src.data(), pixels, mask))
+                << pixels << " pixels";
+        }
+    }
+}
+
+TEST_P(PixelConvertTest, SwapRedBlueInPlace) {
+    std::vector<uint8_t> expected = RandomBytes(37 * 4, 11);
+    std::vector<uint8_t> actual = expected;
+    scalar_->swap_red_blue(expected.data(), expected.data(), 37);
+    kernels_->swap_red_blue(actual.data(), actual.data(), 37);
+    EXPECT_EQ(expected, actual);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllLevels, PixelConvertTest, ::testing::ValuesIn(kAllLevels),
+                         [](const ::testing::TestParamInfo<SimdLevel>& info) {
+                             return std::string(SimdLevelName(info.param));
+                         });
+
+TEST(PixelConvertScalarTest, SwapsChannels) {
+    const uint8_t bgra[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    uint8_t out[8];
+    GetPixelKernels(SimdLevel::kScalar)->swap_red_blue(bgra, out, 2);
+    const uint8_t rgba[8] = {3, 2, 1, 4, 7, 6, 5, 8};
+    EXPECT_EQ(0, std::memcmp(out, rgba, 8));
+
+    uint8_t rgb[6];
+    GetPixelKernels(SimdLevel::kScalar)->bgrx_to_rgb(bgra, rgb, 2);
+    const uint8_t expected_rgb[6] = {3, 2, 1, 7, 6, 5};
+    EXPECT_EQ(0, std::memcmp(rgb, expected_rgb, 6));
+}
+
+TEST(PixelConvertScalarTest, HashRowIgnoresMaskedBytesOnly) {
+    std::vector<uint8_t> row = RandomBytes(21 * 4, 5);
+    const uint64_t hash = HashRow(row.data(), 21, 0x00FFFFFFu);
+    row[13 * 4 + 3] ^= 0x55;  // X 通道
+    EXPECT_EQ(HashRow(row.data(), 21, 0x00FFFFFFu), hash);
+    EXPECT_NE(HashRow(row.data(), 21, 0xFFFFFFFFu), HashRow(row.data(), 20, 0xFFFFFFFFu));
+    row[13 * 4 + 1] ^= 0x01;
+    EXPECT_NE(HashRow(row.data(), 21, 0x00FFFFFFu), hash);
+
+    // 同一条链上相邻两次（第 3、11 个像素）交换也会改变哈希
+    std::vector<uint8_t> swapped = row;
+    std::memcpy(swapped.data() + 3 * 4, row.data() + 11 * 4, 4);
+    std::memcpy(swapped.data() + 11 * 4, row.data() + 3 * 4, 4);
+    EXPECT_NE(HashRow(swapped.data(), 21, 0xFFFFFFFFu), HashRow(row.data(), 21, 0xFFFFFFFFu));
+}
+
+TEST(PixelConvertScalarTest, DetectedLevelIsAvailable) {
+    EXPECT_NE(GetPixelKernels(DetectSimdLevel()), nullptr);
+}
+
+TEST(CopyRowsTest, FlipsAndRepacksStride) {
+    // 3 行，每行 5 字节有效数据，来源步长 8（DIB 的 4 字节对齐）
+    std::vector<uint8_t> src(3 * 8);
+    for (size_t i = 0; i < src.size(); i++) src[i] = static_cast<uint8_t>(i);
+    std::vector<uint8_t> dst(3 * 5);
+    CopyRows(src.data(), 8, dst.data(), 5, 5, 3, true);
+    const uint8_t expected[15] = {16, 17, 18, 19, 20, 8, 9, 10, 11, 12, 0, 1, 2, 3, 4};
+    EXPECT_EQ(0, std::memcmp(dst.data(), expected, 15));
+}
+
+TEST(ConvertFrameTest, BgrxToRgbaForcesAlphaAndHonoursStride) {
+    FrameBuffer source(40, 6, PixelFormat::kBgrx8);
+    for (int y = 0; y < source.height(); y++) {
+        for (int x = 0; x < source.width(); x++) {
+            uint8_t* p = source.row(y) + x * 4;
+            p[0] = static_cast<uint8_t>(x);
+            p[1] = static_cast<uint8_t>(y);
+            p[2] = static_cast<uint8_t>(x + y);
+            p[3] = 0;
+        }
+    }
+    FrameBuffer view = source.View(Rect(3, 1, 30, 4));
+
+    FrameBuffer converted;
+    ConvertFrame(view, PixelFormat::kRgba8, &converted);
+    ASSERT_EQ(converted.width(), 30);
+    ASSERT_EQ(converted.height(), 4);
+    EXPECT_EQ(converted.format(), PixelFormat::kRgba8);
+    for (int y = 0; y < converted.height(); y++) {
+        for (int x = 0; x < converted.width(); x++) {
+            const uint8_t* p = converted.row(y) + x * 4;
+            ASSERT_EQ(p[0], static_cast<uint8_t>(x + 3 + y + 1));
+            ASSERT_EQ(p[1], static_cast<uint8_t>(y + 1));
+            ASSERT_EQ(p[2], static_cast<uint8_t>(x + 3));
+            ASSERT_EQ(p[3], 0xFF);
+        }
+    }
+}
+
+TEST(ConvertFramePreviewTest, SubsamplesLongEdgeToMaxDimension) {
+    FrameBuffer source(100, 30, PixelFormat::kBgrx8);
+    for (int y = 0; y < source.height(); y++) {
+        for (int x = 0; x < source.width(); x++) {
+            uint8_t* p = source.row(y) + x * 4;
+            p[0] = static_cast<uint8_t>(x);
+            p[1] = static_cast<uint8_t>(y);
+            p[2] = 7;
+            p[3] = 0;
+        }
+    }
+
+    // 长边 100 -> 步长 3 -> 34 x 10
+    FrameBuffer preview;
+    ConvertFramePreview(source, 40, &preview);
+    ASSERT_EQ(preview.width(), 34);
+    ASSERT_EQ(preview.height(), 10);
+    EXPECT_EQ(preview.format(), PixelFormat::kRgba8);
+    for (int y = 0; y < preview.height(); y++) {
+        for (int x = 0; x < preview.width(); x++) {
+            const uint8_t* p = preview.row(y) + x * 4;
+            ASSERT_EQ(p[0], 7);
+            ASSERT_EQ(p[1], static_cast<uint8_t>(y * 3));
+            ASSERT_EQ(p[2], static_cast<uint8_t>(x * 3));
+            ASSERT_EQ(p[3], 0xFF);
+        }
+    }
+
+    // 不超过上限时与 ConvertFrame 相同
+    ConvertFramePreview(source, 0, &preview);
+    EXPECT_EQ(preview.width(), 100);
+    EXPECT_EQ(preview.height(), 30);
+    EXPECT_EQ(preview.row(29)[4 * 99 + 2], 99);
+}
+
+TEST(DownscaleFrameTest, AveragesEachBoxAndKeepsFormat) {
+    // 6 x 3 -> 长边 4：列按 [0,1) [1,3) [3,4) [4,6) 分组，行按 [0,1) [1,3)
+    FrameBuffer source(6, 3, PixelFormat::kBgra8);
+    for (int y = 0; y < source.height(); y++) {
+        for (int x = 0; x < source.width(); x++) {
+            uint8_t* p = source.row(y) + x * 4;
+            p[0] = static_cast<uint8_t>(x * 10);
+            p[1] = static_cast<uint8_t>(y * 40);
+            p[2] = 200;
+            p[3] = x < 3 ? 0 : 255;
+        }
+    }
+
+    FrameBuffer thumbnail;
+    DownscaleFrame(source, 4, &thumbnail);
+    ASSERT_EQ(thumbnail.width(), 4);
+    ASSERT_EQ(thumbnail.height(), 2);
+    EXPECT_EQ(thumbnail.format(), PixelFormat::kBgra8);
+    const uint8_t expected_b[4] = {0, 15, 30, 45};
+    const uint8_t expected_a[4] = {0, 0, 255, 255};
+    for (int x = 0; x < 4; x++) {
+        const uint8_t* top = thumbnail.row(0) + x * 4;
+        const uint8_t* bottom = thumbnail.row(1) + x * 4;
+        EXPECT_EQ(top[0], expected_b[x]);
+        EXPECT_EQ(top[1], 0);
+        EXPECT_EQ(bottom[1], 60);
+        EXPECT_EQ(bottom[2], 200);
+        EXPECT_EQ(top[3], expected_a[x]);
+    }
+
+    // 不超过上限时原样拷贝
+    DownscaleFrame(source, 6, &thumbnail);
+    EXPECT_EQ(thumbnail.width(), 6);
+    EXPECT_EQ(thumbnail.row(2)[4 * 5], 50);
+}
+
+}  // namespace
+}  // namespace capture_core
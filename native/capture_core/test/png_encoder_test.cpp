@@ -0,0 +1,246 @@
+#include "capture_core/png_encoder.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include <gtest/gtest.h>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "capture_core/thread_pool.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+namespace fs = std::filesystem;
+
+std::vector<uint8_t> ReadFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+}
+
+fs::path TempPath(const std::string& name) {
+    return fs::path(::testing::TempDir()) / ("png_stream_" + name);
+}
+
+void ExpectMatchesFrame(const FrameBuffer& frame, const testing::DecodedPng& png) {
+    ASSERT_EQ(png.width, frame.width());
+    ASSERT_EQ(png.height, frame.height());
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < frame.width(); x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(frame, x, y, expected);
+            const uint8_t* actual = &png.rgba[(static_cast<size_t>(y) * png.width + x) * 4];
+            ASSERT_EQ(0, std::memcmp(expected, actual, 4)) << "pixel " << x << "," << y;
+        }
+    }
+}
+
+TEST(PngEncoderTest, BgrxEncodesAsOpaqueRgb) {
+    SyntheticFrameSource source(97, 61, SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    PngEncoder encoder;
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(encoder.Encode(frame, &png));
+
+    testing::DecodedPng decoded;
+    ASSERT_TRUE(testing::DecodePng(png, &decoded));
+    EXPECT_EQ(decoded.color_type, 2);
+    ExpectMatchesFrame(frame, decoded);
+}
+
+TEST(PngEncoderTest, BgraKeepsAlpha) {
+    FrameBuffer frame(16, 9, PixelFormat::kBgra8);
+    for (int y = 0; y < frame.height(); y++) {
+        for (int x = 0; x < frame.width(); x++) {
+            uint8_t* p = frame.row(y) + x * 4;
+            p[0] = static_cast<uint8_t>(x * 10);
+            p[1] = static_cast<uint8_t>(y * 20);
+            p[2] = 0x7F;
+            p[3] = static_cast<uint8_t>(x * 16);
+        }
+    }
+
+    PngEncoder encoder(PngEncoderOptions{0});
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(encoder.Encode(frame, &png));
+
+    testing::DecodedPng decoded;
+    ASSERT_TRUE(testing::DecodePng(png, &decoded));
+    EXPECT_EQ(decoded.color_type, 6);
+    ExpectMatchesFrame(frame, decoded);
+}
+
+TEST(PngEncoderTest, EncodesStridedView) {
+    SyntheticFrameSource source(128, 64, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+    FrameBuffer view = frame.View(Rect(17, 9, 50, 40));
+
+    PngEncoder encoder;
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(encoder.Encode(view, &png));
+
+    testing::DecodedPng decoded;
+    ASSERT_TRUE(testing::DecodePng(png, &decoded));
+    ExpectMatchesFrame(view, decoded);
+}
+
+TEST(PngEncoderTest, ParallelBandsProduceOneValidStream) {
+    SyntheticFrameSource source(203, 157, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    ThreadPool pool(3);
+    for (int level : {0, 1, 3, 6, 9}) {
+        PngEncoderOptions options;
+        options.compression_level = level;
+        options.pool = &pool;
+        options.band_rows = 10;
+        PngEncoder encoder(options);
+        std::vector<uint8_t> png;
+        ASSERT_TRUE(encoder.Encode(frame, &png)) << "level " << level;
+        EXPECT_EQ(encoder.last_band_count(), 16);
+
+        // 解码时 inflate 会校验拼接后的 Adler-32
+        testing::DecodedPng decoded;
+        ASSERT_TRUE(testing::DecodePng(png, &decoded)) << "level " << level;
+        ExpectMatchesFrame(frame, decoded);
+    }
+}
+
+TEST(PngEncoderTest, BandedOutputMatchesSingleBandSize) {
+    SyntheticFrameSource source(640, 480, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    ThreadPool pool(2);
+    PngEncoderOptions single;
+    single.pool = &pool;
+    single.band_rows = frame.height();
+    PngEncoderOptions banded = single;
+    banded.band_rows = 60;
+
+    std::vector<uint8_t> single_png;
+    std::vector<uint8_t> banded_png;
+    PngEncoder single_encoder(single);
+    PngEncoder banded_encoder(banded);
+    ASSERT_TRUE(single_encoder.Encode(frame, &single_png));
+    ASSERT_TRUE(banded_encoder.Encode(frame, &banded_png));
+    EXPECT_EQ(single_encoder.last_band_count(), 1);
+    EXPECT_EQ(banded_encoder.last_band_count(), 8);
+
+    // 有字典衔接时，分条带只多出每个条带的同步块和 IDAT 块头
+    EXPECT_LT(banded_png.size(), single_png.size() * 102 / 100 + 8 * 32);
+}
+
+TEST(PngEncoderTest, EncoderIsReusableAcrossSizes) {
+    PngEncoderOptions options = PngEncoderOptions::ForEffort(PngEffort::kFast);
+    options.band_rows = 7;
+    PngEncoder encoder(options);
+    for (int size : {50, 13, 90}) {
+        SyntheticFrameSource source(size, size, SyntheticFrameSource::Pattern::kNoise);
+        FrameBuffer frame;
+        ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+        std::vector<uint8_t> png;
+        ASSERT_TRUE(encoder.Encode(frame, &png));
+        testing::DecodedPng decoded;
+        ASSERT_TRUE(testing::DecodePng(png, &decoded));
+        ExpectMatchesFrame(frame, decoded);
+    }
+}
+
+TEST(PngEncoderTest, RejectsEmptyFrame) {
+    PngEncoder encoder;
+    std::vector<uint8_t> png;
+    EXPECT_FALSE(encoder.Encode(FrameBuffer(), &png));
+}
+
+TEST(PngStreamWriterTest, RowsAddedInPiecesDecodeAsOneImage) {
+    SyntheticFrameSource source(151, 233, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    ThreadPool pool(3);
+    for (int level : {0, 1, 6}) {
+        PngEncoderOptions options;
+        options.compression_level = level;
+        options.pool = &pool;
+        options.band_rows = 9;
+        const fs::path path = TempPath("pieces.png");
+        PngStreamWriter writer(options);
+        ASSERT_TRUE(writer.Open(path.u8string()));
+        // 长短不一的几段，包括单行
+        int y = 0;
+        for (int rows : {1, 40, 7, 100, 85}) {
+            FrameBuffer piece = frame.View(Rect(0, y, frame.width(), rows));
+            ASSERT_TRUE(writer.AddRows(piece)) << "level " << level;
+            y += rows;
+        }
+        ASSERT_EQ(y, frame.height());
+        EXPECT_EQ(writer.height(), frame.height());
+        ASSERT_TRUE(writer.Finish());
+        EXPECT_EQ(writer.bytes_written(), fs::file_size(path));
+
+        testing::DecodedPng decoded;
+        ASSERT_TRUE(testing::DecodePng(ReadFile(path), &decoded)) << "level " << level;
+        ExpectMatchesFrame(frame, decoded);
+        fs::remove(path);
+    }
+}
+
+TEST(PngStreamWriterTest, KeepsAlphaAndRejectsMismatchedRows) {
+    SyntheticFrameSource source(64, 48, SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+    FrameBuffer bgra(frame.width(), frame.height(), PixelFormat::kBgra8);
+    for (int y = 0; y < frame.height(); y++) {
+        std::memcpy(bgra.row(y), frame.row(y), static_cast<size_t>(frame.width()) * 4);
+        for (int x = 0; x < frame.width(); x++) bgra.row(y)[x * 4 + 3] = static_cast<uint8_t>(x * 4);
+    }
+
+    const fs::path path = TempPath("alpha.png");
+    PngStreamWriter writer;
+    ASSERT_TRUE(writer.Open(path.u8string()));
+    ASSERT_TRUE(writer.AddRows(bgra.View(Rect(0, 0, 64, 20))));
+    EXPECT_FALSE(writer.AddRows(frame.View(Rect(0, 20, 64, 28))));  // 格式不同
+    EXPECT_FALSE(writer.AddRows(bgra.View(Rect(0, 20, 32, 28))));   // 宽度不同
+    ASSERT_TRUE(writer.AddRows(bgra.View(Rect(0, 20, 64, 28))));
+    ASSERT_TRUE(writer.Finish());
+
+    testing::DecodedPng decoded;
+    ASSERT_TRUE(testing::DecodePng(ReadFile(path), &decoded));
+    EXPECT_EQ(decoded.color_type, 6);
+    ExpectMatchesFrame(bgra, decoded);
+    fs::remove(path);
+}
+
+TEST(PngStreamWriterTest, UnfinishedOrEmptyFileIsRemoved) {
+    SyntheticFrameSource source(32, 32, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    const fs::path path = TempPath("aborted.png");
+    {
+        PngStreamWriter writer;
+        ASSERT_TRUE(writer.Open(path.u8string()));
+        ASSERT_TRUE(writer.AddRows(frame));
+        EXPECT_TRUE(fs::exists(path));
+    }
+    EXPECT_FALSE(fs::exists(path));
+
+    PngStreamWriter writer;
+    ASSERT_TRUE(writer.Open(path.u8string()));
+    EXPECT_FALSE(writer.Finish());
+    EXPECT_FALSE(writer.is_open());
+    EXPECT_FALSE(fs::exists(path));
+    EXPECT_FALSE(writer.AddRows(frame));
+}
+
+}  // namespace
+}  // namespace capture_core
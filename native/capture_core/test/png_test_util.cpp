@@ -0,0 +1,130 @@
+#include "png_test_util.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include <zlib.h>
+
+namespace capture_core {
+namespace testing {
+
+namespace {
+
+uint32_t ReadU32(const uint8_t* p) {
+    return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) |
+           (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+}
+
+uint8_t Paeth(uint8_t a, uint8_t b, uint8_t c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+}  // namespace
+
+bool DecodePng(const std::vector<uint8_t>& png, DecodedPng* decoded) {
+    static const uint8_t kSig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    if (png.size() < 8 || std::memcmp(png.data(), kSig, 8) != 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> idat;
+    int bit_depth = 0;
+    bool seen_iend = false;
+    size_t pos = 8;
+    while (pos + 12 <= png.size()) {
+        uint32_t length = ReadU32(&png[pos]);
+        if (pos + 12 + length > png.size()) return false;
+        std::string type(reinterpret_cast<const char*>(&png[pos + 4]), 4);
+        const uint8_t* data = &png[pos + 8];
+        uLong crc = crc32(0L, &png[pos + 4], length + 4);
+        if (crc != ReadU32(&png[pos + 8 + length])) return false;
+
+        if (type == "IHDR") {
+            decoded->width = static_cast<int>(ReadU32(data));
+            decoded->height = static_cast<int>(ReadU32(data + 4));
+            bit_depth = data[8];
+            decoded->color_type = data[9];
+            if (data[12] != 0) return false;  // 不支持隔行
+        } else if (type == "IDAT") {
+            idat.insert(idat.end(), data, data + length);
+        } else if (type == "IEND") {
+            seen_iend = true;
+            break;
+        }
+        pos += 12 + length;
+    }
+    if (!seen_iend || bit_depth != 8 ||
+        (decoded->color_type != 2 && decoded->color_type != 6)) {
+        return false;
+    }
+
+    const int bpp = decoded->color_type == 6 ? 4 : 3;
+    const size_t row_bytes = static_cast<size_t>(decoded->width) * bpp;
+    std::vector<uint8_t> raw((row_bytes + 1) * decoded->height);
+    uLongf raw_size = static_cast<uLongf>(raw.size());
+    if (uncompress(raw.data(), &raw_size, idat.data(), static_cast<uLong>(idat.size())) != Z_OK ||
+        raw_size != raw.size()) {
+        return false;
+    }
+
+    std::vector<uint8_t> pixels(row_bytes * decoded->height);
+    for (int y = 0; y < decoded->height; y++) {
+        const uint8_t* src = &raw[(row_bytes + 1) * y];
+        uint8_t filter = src[0];
+        src++;
+        uint8_t* cur = &pixels[row_bytes * y];
+        const uint8_t* prev = y > 0 ? &pixels[row_bytes * (y - 1)] : nullptr;
+        for (size_t i = 0; i < row_bytes; i++) {
+            uint8_t a = i >= static_cast<size_t>(bpp) ? cur[i - bpp] : 0;
+            uint8_t b = prev ? prev[i] : 0;
+            uint8_t c = (prev && i >= static_cast<size_t>(bpp)) ? prev[i - bpp] : 0;
+            switch (filter) {
+                case 0: cur[i] = src[i]; break;
+                case 1: cur[i] = static_cast<uint8_t>(src[i] + a); break;
+                case 2: cur[i] = static_cast<uint8_t>(src[i] + b); break;
+                case 3: cur[i] = static_cast<uint8_t>(src[i] + ((a + b) >> 1)); break;
+                case 4: cur[i] = static_cast<uint8_t>(src[i] + Paeth(a, b, c)); break;
+                default: return false;
+            }
+        }
+    }
+
+    decoded->rgba.resize(static_cast<size_t>(decoded->width) * decoded->height * 4);
+    for (size_t i = 0, n = static_cast<size_t>(decoded->width) * decoded->height; i < n; i++) {
+        decoded->rgba[i * 4 + 0] = pixels[i * bpp + 0];
+        decoded->rgba[i * 4 + 1] = pixels[i * bpp + 1];
+        decoded->rgba[i * 4 + 2] = pixels[i * bpp + 2];
+        decoded->rgba[i * 4 + 3] = bpp == 4 ? pixels[i * bpp + 3] : 0xFF;
+    }
+    return true;
+}
+
+FrameBuffer SyntheticFrame(int width, int height, SyntheticFrameSource::Pattern pattern) {
+    SyntheticFrameSource source(width, height, pattern);
+    FrameBuffer frame;
+    source.Capture(source.GetBounds(), &frame);
+    return frame;
+}
+
+void FramePixelRgba(const FrameBuffer& frame, int x, int y, uint8_t rgba[4]) {
+    const uint8_t* p = frame.row(y) + x * 4;
+    switch (frame.format()) {
+        case PixelFormat::kRgba8:
+            std::memcpy(rgba, p, 4);
+            break;
+        case PixelFormat::kBgra8:
+            rgba[0] = p[2]; rgba[1] = p[1]; rgba[2] = p[0]; rgba[3] = p[3];
+            break;
+        case PixelFormat::kBgrx8:
+            rgba[0] = p[2]; rgba[1] = p[1]; rgba[2] = p[0]; rgba[3] = 0xFF;
+            break;
+    }
+}
+
+}  // namespace testing
+}  // namespace capture_core
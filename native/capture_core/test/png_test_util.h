@@ -0,0 +1,33 @@
+#ifndef CAPTURE_CORE_TEST_PNG_TEST_UTIL_H_
+#define CAPTURE_CORE_TEST_PNG_TEST_UTIL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/synthetic_frame_source.h"
+
+namespace capture_core {
+namespace testing {
+
+// 测试用的最小 PNG 解码结果（统一展开为 RGBA）
+struct DecodedPng {
+    int width = 0;
+    int height = 0;
+    int color_type = 0;
+    std::vector<uint8_t> rgba;
+};
+
+// 解码 8 位 RGB / RGBA、非隔行的 PNG，校验所有 CRC；失败返回 false
+bool DecodePng(const std::vector<uint8_t>& png, DecodedPng* decoded);
+
+// 读取帧中 (x, y) 像素并转换成 RGBA（X 通道视为 0xFF）
+void FramePixelRgba(const FrameBuffer& frame, int x, int y, uint8_t rgba[4]);
+
+// SyntheticFrameSource 生成的整帧（BGRX）
+FrameBuffer SyntheticFrame(int width, int height, SyntheticFrameSource::Pattern pattern);
+
+}  // namespace testing
+}  // namespace capture_core
+
+#endif  // CAPTURE_CORE_TEST_PNG_TEST_UTIL_H_
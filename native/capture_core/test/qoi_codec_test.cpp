@@ -0,0 +1,106 @@
+#include "capture_core/qoi_codec.h"
+
+#include <gtest/gtest.h>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+void ExpectSamePixels(const FrameBuffer& original, const FrameBuffer& decoded) {
+    ASSERT_EQ(decoded.width(), original.width());
+    ASSERT_EQ(decoded.height(), original.height());
+    ASSERT_EQ(decoded.format(), PixelFormat::kRgba8);
+    for (int y = 0; y < original.height(); y++) {
+        for (int x = 0; x < original.width(); x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(original, x, y, expected);
+            const uint8_t* actual = decoded.row(y) + 4 * x;
+            ASSERT_EQ(actual[0], expected[0]) << x << "," << y;
+            ASSERT_EQ(actual[1], expected[1]) << x << "," << y;
+            ASSERT_EQ(actual[2], expected[2]) << x << "," << y;
+            ASSERT_EQ(actual[3], expected[3]) << x << "," << y;
+        }
+    }
+}
+
+class QoiRoundTripTest : public ::testing::TestWithParam<SyntheticFrameSource::Pattern> {};
+
+TEST_P(QoiRoundTripTest, DecodesToIdenticalPixels) {
+    FrameBuffer frame = testing::SyntheticFrame(301, 77, GetParam());
+    std::vector<uint8_t> qoi;
+    ASSERT_TRUE(QoiEncoder().Encode(frame, &qoi));
+    ASSERT_GE(qoi.size(), 22u);
+    EXPECT_EQ(std::string(qoi.begin(), qoi.begin() + 4), "qoif");
+    EXPECT_EQ(qoi[12], 3);
+
+    FrameBuffer decoded;
+    ASSERT_TRUE(DecodeQoi(qoi.data(), qoi.size(), &decoded));
+    ExpectSamePixels(frame, decoded);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllPatterns, QoiRoundTripTest,
+                         ::testing::Values(SyntheticFrameSource::Pattern::kGradient,
+                                           SyntheticFrameSource::Pattern::kUi,
+                                           SyntheticFrameSource::Pattern::kNoise));
+
+TEST(QoiCodecTest, KeepsAlphaForFormatsWithAlpha) {
+    FrameBuffer frame(40, 30, PixelFormat::kBgra8);
+    for (int y = 0; y < 30; y++) {
+        for (int x = 0; x < 40; x++) {
+            uint8_t* p = frame.row(y) + 4 * x;
+            p[0] = static_cast<uint8_t>(x * 6);
+            p[1] = static_cast<uint8_t>(y * 8);
+            p[2] = static_cast<uint8_t>(x + y);
+            p[3] = static_cast<uint8_t>(x < 20 ? 255 : y * 7);
+        }
+    }
+    std::vector<uint8_t> qoi;
+    ASSERT_TRUE(QoiEncoder().Encode(frame, &qoi));
+    EXPECT_EQ(qoi[12], 4);
+
+    FrameBuffer decoded;
+    ASSERT_TRUE(DecodeQoi(qoi.data(), qoi.size(), &decoded));
+    ExpectSamePixels(frame, decoded);
+}
+
+TEST(QoiCodecTest, SolidFrameCompressesToRuns) {
+    FrameBuffer frame(256, 256, PixelFormat::kBgrx8);
+    for (int y = 0; y < 256; y++) {
+        for (int x = 0; x < 256; x++) {
+            uint8_t* p = frame.row(y) + 4 * x;
+            p[0] = 0x20;
+            p[1] = 0x40;
+            p[2] = 0x60;
+            p[3] = 0;
+        }
+    }
+    std::vector<uint8_t> qoi;
+    ASSERT_TRUE(QoiEncoder().Encode(frame, &qoi));
+    // 头部 + 1 个 RGB + ceil(65535 / 62) 个行程 + 结尾
+    EXPECT_EQ(qoi.size(), 14u + 4u + 1058u + 8u);
+}
+
+TEST(QoiCodecTest, RejectsTruncatedAndInvalidData) {
+    FrameBuffer frame = testing::SyntheticFrame(64, 64, SyntheticFrameSource::Pattern::kNoise);
+    std::vector<uint8_t> qoi;
+    ASSERT_TRUE(QoiEncoder().Encode(frame, &qoi));
+
+    FrameBuffer decoded;
+    EXPECT_FALSE(DecodeQoi(qoi.data(), qoi.size() / 2, &decoded));
+    EXPECT_FALSE(DecodeQoi(qoi.data(), 10, &decoded));
+
+    std::vector<uint8_t> bad_magic = qoi;
+    bad_magic[0] = 'x';
+    EXPECT_FALSE(DecodeQoi(bad_magic.data(), bad_magic.size(), &decoded));
+
+    std::vector<uint8_t> bad_channels = qoi;
+    bad_channels[12] = 5;
+    EXPECT_FALSE(DecodeQoi(bad_channels.data(), bad_channels.size(), &decoded));
+
+    EXPECT_FALSE(QoiEncoder().Encode(FrameBuffer(), &qoi));
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,235 @@
+#include "capture_core/replay_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+namespace fs = std::filesystem;
+using std::chrono::milliseconds;
+using Clock = ReplayBuffer::Clock;
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream in(fs::u8path(path), std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+}
+
+class ReplayBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::path(::testing::TempDir()) /
+               ("replay_buffer_" +
+                std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override { fs::remove_all(dir_); }
+
+    std::string PathFor(const std::string& name) const { return (dir_ / name).u8string(); }
+
+    fs::path dir_;
+};
+
+TEST_F(ReplayBufferTest, UnchangedFramesAreNotStored) {
+    SyntheticFrameSource source(160, 100, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    ReplayBuffer buffer(milliseconds(10000), size_t(1) << 20);
+    const Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(buffer.Push(frame, t0 + milliseconds(100 * i)));
+    }
+    const ReplayStats stats = buffer.stats();
+    EXPECT_EQ(stats.frames, 1);
+    EXPECT_EQ(stats.keyframes, 1);
+    EXPECT_EQ(stats.unchanged, 4);
+    EXPECT_EQ(stats.span.count(), 400);
+    EXPECT_GE(stats.working_bytes, frame.size_bytes());
+}
+
+TEST_F(ReplayBufferTest, DeltaFramesStoreOnlyTheChangedRect) {
+    SyntheticFrameSource source(640, 400, SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+
+    ReplayBuffer buffer(milliseconds(10000), size_t(16) << 20);
+    const Clock::time_point t0 = Clock::now();
+    ASSERT_TRUE(buffer.Push(frame, t0));
+    const size_t keyframe_bytes = buffer.stats().bytes;
+
+    // 只改动一个 20x10 的区域
+    for (int y = 50; y < 60; y++) {
+        for (int x = 100; x < 120; x++) frame.row(y)[x * 4] ^= 0xFF;
+    }
+    ASSERT_TRUE(buffer.Push(frame, t0 + milliseconds(100)));
+    const ReplayStats stats = buffer.stats();
+    EXPECT_EQ(stats.frames, 2);
+    EXPECT_EQ(stats.keyframes, 1);
+    EXPECT_LT(stats.bytes - keyframe_bytes, 20u * 10u * 4u + 64u);
+}
+
+TEST_F(ReplayBufferTest, ExportReconstructsFramesFromDeltas) {
+    SyntheticFrameSource source(200, 120, SyntheticFrameSource::Pattern::kUi);
+    std::vector<FrameBuffer> frames(5);
+    ReplayBuffer buffer(milliseconds(500), size_t(8) << 20, milliseconds(60000));
+    const Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(source.Capture(source.GetBounds(), &frames[i]));
+        ASSERT_TRUE(buffer.Push(frames[i], t0 + std::chrono::seconds(i)));
+    }
+    ASSERT_EQ(buffer.stats().keyframes, 1);
+
+    // 只保留 500 ms：第 4 帧（关键帧 + 3 个差分帧还原）显示在开头，第 5 帧在 500 ms 处
+    const std::string path = PathFor("replay.png");
+    ReplayExport result;
+    ASSERT_TRUE(buffer.Export(AnimationFormat::kApng, path, t0 + std::chrono::seconds(4),
+                              &result));
+    EXPECT_EQ(result.frames, 2);
+    EXPECT_EQ(result.duration.count(), 500);
+    EXPECT_EQ(result.bytes, fs::file_size(fs::u8path(path)));
+
+    // APNG 的默认图像就是第一帧
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(ReadFile(path), &png));
+    ASSERT_EQ(png.width, 200);
+    ASSERT_EQ(png.height, 120);
+    for (int y = 0; y < png.height; y++) {
+        for (int x = 0; x < png.width; x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(frames[3], x, y, expected);
+            const uint8_t* actual = &png.rgba[(static_cast<size_t>(y) * png.width + x) * 4];
+            ASSERT_EQ(0, std::memcmp(expected, actual, 3)) << x << "," << y;
+        }
+    }
+}
+
+TEST_F(ReplayBufferTest, TimeWindowEvictsWholeGroups) {
+    SyntheticFrameSource source(96, 64, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ReplayBuffer buffer(milliseconds(1000), size_t(8) << 20, milliseconds(250));
+    const Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < 30; i++) {
+        ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+        ASSERT_TRUE(buffer.Push(frame, t0 + milliseconds(100 * i)));
+        const ReplayStats stats = buffer.stats();
+        // 保留的时长至少是 duration（开头不足时除外），最多多出一组
+        EXPECT_GE(stats.span.count(), std::min<int64_t>(100 * i, 1000));
+        EXPECT_LT(stats.span.count(), 1000 + 250 + 100);
+    }
+    const ReplayStats stats = buffer.stats();
+    EXPECT_GT(stats.evicted, 0);
+    EXPECT_EQ(stats.frames + stats.evicted, 30);
+    EXPECT_GE(stats.keyframes, 4);
+}
+
+TEST_F(ReplayBufferTest, MemoryLimitIsNeverExceeded) {
+    SyntheticFrameSource source(160, 96, SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+    ReplayBuffer probe(milliseconds(1000), size_t(1) << 20);
+    ASSERT_TRUE(probe.Push(frame, Clock::now()));
+    const size_t keyframe_bytes = probe.stats().bytes;
+
+    // 能放下两个多关键帧；时长和关键帧间隔都不会触发淘汰
+    const size_t limit = keyframe_bytes * 5 / 2;
+    ReplayBuffer buffer(milliseconds(60000), limit, milliseconds(60000));
+    const Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < 40; i++) {
+        ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+        EXPECT_TRUE(buffer.Push(frame, t0 + milliseconds(100 * i)));
+        EXPECT_LE(buffer.stats().bytes, limit);
+    }
+    const ReplayStats stats = buffer.stats();
+    EXPECT_LE(stats.peak_bytes, limit);
+    EXPECT_GT(stats.evicted, 0);
+    EXPECT_GE(stats.keyframes, 1);
+    EXPECT_TRUE(buffer.Export(AnimationFormat::kGif, PathFor("capped.gif"),
+                              t0 + milliseconds(4000), nullptr));
+}
+
+TEST_F(ReplayBufferTest, FrameLargerThanLimitIsDropped) {
+    SyntheticFrameSource source(160, 96, SyntheticFrameSource::Pattern::kNoise);
+    FrameBuffer frame;
+    ASSERT_TRUE(source.Capture(source.GetBounds(), &frame));
+    ReplayBuffer buffer(milliseconds(1000), 256);
+    EXPECT_FALSE(buffer.Push(frame, Clock::now()));
+    const ReplayStats stats = buffer.stats();
+    EXPECT_EQ(stats.frames, 0);
+    EXPECT_EQ(stats.bytes, 0u);
+    EXPECT_FALSE(buffer.Export(AnimationFormat::kGif, PathFor("empty.gif"), Clock::now(),
+                               nullptr));
+    EXPECT_FALSE(fs::exists(fs::u8path(PathFor("empty.gif"))));
+}
+
+TEST_F(ReplayBufferTest, ResolutionChangeStartsOver) {
+    SyntheticFrameSource small(128, 96, SyntheticFrameSource::Pattern::kUi);
+    SyntheticFrameSource large(160, 120, SyntheticFrameSource::Pattern::kUi);
+    FrameBuffer frame;
+    ReplayBuffer buffer(milliseconds(10000), size_t(1) << 20);
+    const Clock::time_point t0 = Clock::now();
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(small.Capture(small.GetBounds(), &frame));
+        ASSERT_TRUE(buffer.Push(frame, t0 + milliseconds(100 * i)));
+    }
+    ASSERT_TRUE(large.Capture(large.GetBounds(), &frame));
+    ASSERT_TRUE(buffer.Push(frame, t0 + milliseconds(300)));
+    const ReplayStats stats = buffer.stats();
+    EXPECT_EQ(stats.frames, 1);
+    EXPECT_EQ(stats.keyframes, 1);
+    EXPECT_EQ(stats.evicted, 3);
+    EXPECT_TRUE(buffer.Export(AnimationFormat::kGif, PathFor("resized.gif"),
+                              t0 + milliseconds(400), nullptr));
+}
+
+TEST_F(ReplayBufferTest, InstantReplayCapturesAndSaves) {
+    InstantReplay replay(std::make_unique<SyntheticFrameSource>(
+        160, 100, SyntheticFrameSource::Pattern::kUi));
+    ReplayOptions options;
+    EXPECT_FALSE(replay.Start(options));  // 区域为空
+
+    options.region = Rect(0, 0, 160, 100);
+    options.fps = InstantReplay::kMaxFps;
+    options.duration = std::chrono::seconds(5);
+    ASSERT_TRUE(replay.Start(options));
+    EXPECT_TRUE(replay.running());
+    EXPECT_FALSE(replay.Start(options));
+    std::this_thread::sleep_for(milliseconds(350));
+
+    const ReplayStats stats = replay.stats();
+    EXPECT_GE(stats.captured, 2);
+    EXPECT_EQ(stats.failed_captures, 0);
+    EXPECT_EQ(stats.frames + stats.unchanged + stats.evicted, stats.captured);
+    EXPECT_GE(stats.uptime.count(), 350);
+    EXPECT_GT(stats.bytes, 0u);
+    EXPECT_GT(stats.working_bytes, 0u);
+    EXPECT_LE(stats.encode_time, stats.uptime);
+
+    const std::string path = PathFor("replay.gif");
+    ReplayExport result;
+    ASSERT_TRUE(replay.Save(AnimationFormat::kGif, path, &result));
+    EXPECT_GE(result.frames, 2);
+    EXPECT_GE(result.duration.count(), 300);
+    EXPECT_EQ(result.bytes, fs::file_size(fs::u8path(path)));
+
+    replay.Stop();
+    EXPECT_FALSE(replay.running());
+    EXPECT_FALSE(replay.Save(AnimationFormat::kGif, PathFor("stopped.gif"), nullptr));
+    EXPECT_EQ(replay.stats().bytes, 0u);
+}
+
+}  // namespace
+}  // namespace capture_core
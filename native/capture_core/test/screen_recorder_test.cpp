@@ -0,0 +1,146 @@
+#include "capture_core/screen_recorder.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include "capture_core/synthetic_frame_source.h"
+
+namespace capture_core {
+namespace {
+
+namespace fs = std::filesystem;
+
+// 包装合成来源，可以让采集变慢或失败
+class SlowFrameSource : public FrameSource {
+public:
+    SlowFrameSource(int width, int height, std::chrono::milliseconds delay)
+        : inner_(width, height, SyntheticFrameSource::Pattern::kUi), delay_(delay) {}
+
+    Rect GetBounds() override { return inner_.GetBounds(); }
+
+    bool Capture(const Rect& region, FrameBuffer* frame) override {
+        calls_++;
+        std::this_thread::sleep_for(delay_);
+        return inner_.Capture(region, frame);
+    }
+
+    std::atomic<int> calls_{0};
+
+private:
+    SyntheticFrameSource inner_;
+    std::chrono::milliseconds delay_;
+};
+
+class ScreenRecorderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::path(::testing::TempDir()) /
+               ("screen_recorder_" +
+                std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override { fs::remove_all(dir_); }
+
+    std::string PathFor(const std::string& name) const { return (dir_ / name).u8string(); }
+
+    fs::path dir_;
+};
+
+TEST_F(ScreenRecorderTest, RecordsFramesAtTargetRate) {
+    ScreenRecorder recorder(std::make_unique<SyntheticFrameSource>(
+        200, 120, SyntheticFrameSource::Pattern::kUi));
+    RecorderOptions options;
+    options.region = Rect(10, 10, 160, 96);
+    options.fps = 20;
+    options.format = AnimationFormat::kGif;
+    options.path = PathFor("clip.gif");
+    ASSERT_TRUE(recorder.Start(options));
+    EXPECT_TRUE(recorder.recording());
+    EXPECT_FALSE(recorder.Start(options));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const RecordingStats stats = recorder.Stop();
+    EXPECT_FALSE(recorder.recording());
+
+    EXPECT_TRUE(stats.ok);
+    // 300 ms、20 fps 约 7 帧；调度抖动下留出余量
+    EXPECT_GE(stats.captured, 3);
+    EXPECT_LE(stats.captured, 8);
+    EXPECT_EQ(stats.written + stats.merged, stats.captured);
+    EXPECT_GE(stats.duration.count(), 300);
+    EXPECT_GT(stats.bytes, 0u);
+    EXPECT_EQ(stats.bytes, fs::file_size(fs::u8path(options.path)));
+}
+
+TEST_F(ScreenRecorderTest, ApngRecordingProducesFile) {
+    ScreenRecorder recorder(std::make_unique<SyntheticFrameSource>(
+        96, 64, SyntheticFrameSource::Pattern::kGradient));
+    RecorderOptions options;
+    options.region = Rect(0, 0, 96, 64);
+    options.fps = 25;
+    options.format = AnimationFormat::kApng;
+    options.path = PathFor("clip.png");
+    ASSERT_TRUE(recorder.Start(options));
+    std::this_thread::sleep_for(std::chrono::milliseconds(120));
+    const RecordingStats stats = recorder.Stop();
+    EXPECT_TRUE(stats.ok);
+    EXPECT_GE(stats.written, 1);
+    EXPECT_TRUE(fs::exists(fs::u8path(options.path)));
+}
+
+TEST_F(ScreenRecorderTest, RejectsInvalidOptions) {
+    ScreenRecorder recorder(std::make_unique<SyntheticFrameSource>(
+        64, 64, SyntheticFrameSource::Pattern::kUi));
+    RecorderOptions options;
+    options.path = PathFor("empty.gif");
+    EXPECT_FALSE(recorder.Start(options));  // 区域为空
+
+    options.region = Rect(0, 0, 32, 32);
+    options.path = (dir_ / "missing" / "clip.gif").u8string();
+    EXPECT_FALSE(recorder.Start(options));  // 目录不存在
+    EXPECT_FALSE(recorder.recording());
+
+    const RecordingStats stats = recorder.Stop();
+    EXPECT_FALSE(stats.ok);
+    EXPECT_EQ(stats.captured, 0);
+}
+
+TEST_F(ScreenRecorderTest, SlowCaptureSkipsTicksInsteadOfQueueing) {
+    auto source = std::make_unique<SlowFrameSource>(64, 64, std::chrono::milliseconds(60));
+    SlowFrameSource* raw = source.get();
+    ScreenRecorder recorder(std::move(source));
+    RecorderOptions options;
+    options.region = Rect(0, 0, 64, 64);
+    options.fps = 50;
+    options.path = PathFor("slow.gif");
+    ASSERT_TRUE(recorder.Start(options));
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    const RecordingStats stats = recorder.Stop();
+    EXPECT_TRUE(stats.ok);
+    // 每次采集 60 ms：300 ms 内最多 6 次，而不是补上错过的 15 个节拍
+    EXPECT_LE(raw->calls_.load(), 7);
+    EXPECT_EQ(stats.captured, raw->calls_.load());
+}
+
+TEST_F(ScreenRecorderTest, AbortDeletesFile) {
+    const std::string path = PathFor("aborted.gif");
+    {
+        ScreenRecorder recorder(std::make_unique<SyntheticFrameSource>(
+            64, 64, SyntheticFrameSource::Pattern::kUi));
+        RecorderOptions options;
+        options.region = Rect(0, 0, 64, 64);
+        options.path = path;
+        ASSERT_TRUE(recorder.Start(options));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_TRUE(fs::exists(fs::u8path(path)));
+    }
+    EXPECT_FALSE(fs::exists(fs::u8path(path)));
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,243 @@
+#include "capture_core/scroll_stitcher.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+namespace fs = std::filesystem;
+
+const int kHeaderRows = 24;
+const int kFooterRows = 16;
+const int kScrollbar = 12;
+
+std::vector<uint8_t> ReadFile(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in),
+                                std::istreambuf_iterator<char>());
+}
+
+void Fill(FrameBuffer* frame, int y, int rows, uint8_t value) {
+    for (int i = y; i < y + rows; i++) {
+        std::memset(frame->row(i), value, static_cast<size_t>(frame->width()) * 4);
+    }
+}
+
+// 模拟一个可滚动的窗口：固定的页眉和页脚，中间显示长页面的一段，右侧滚动条随位置变化
+class ScrollingPage : public FrameSource {
+public:
+    ScrollingPage(int width, int page_height, int view_height,
+                  SyntheticFrameSource::Pattern pattern)
+        : view_height_(view_height) {
+        SyntheticFrameSource source(width, page_height, pattern);
+        source.Capture(source.GetBounds(), &page_);
+        Fill(&page_, 0, 1, 0x55);  // 页面第一行与页眉区分开
+    }
+
+    Rect GetBounds() override { return Rect(0, 0, page_.width(), view_height_); }
+
+    bool Capture(const Rect&, FrameBuffer* frame) override {
+        const int width = page_.width();
+        frame->Allocate(width, view_height_, PixelFormat::kBgrx8);
+        Fill(frame, 0, kHeaderRows, 0xC0);
+        std::memset(frame->row(kHeaderRows / 2), 0x10, static_cast<size_t>(width) * 2);
+        const int content = content_rows();
+        for (int y = 0; y < content; y++) {
+            std::memcpy(frame->row(kHeaderRows + y), page_.row(offset_ + y),
+                        static_cast<size_t>(width) * 4);
+        }
+        Fill(frame, kHeaderRows + content, kFooterRows, 0x80);
+        // 滚动条的滑块位置随 offset 变化，比较时必须忽略
+        const int thumb = kHeaderRows + offset_ * (content - 20) / std::max(1, max_offset());
+        for (int y = kHeaderRows; y < kHeaderRows + content; y++) {
+            const uint8_t value = y >= thumb && y < thumb + 20 ? 0x60 : 0xE0;
+            std::memset(frame->row(y) + (width - kScrollbar) * 4, value, kScrollbar * 4);
+        }
+        return true;
+    }
+
+    bool Scroll(int rows) {
+        offset_ = std::min(offset_ + rows, max_offset());
+        return true;
+    }
+
+    int content_rows() const { return view_height_ - kHeaderRows - kFooterRows; }
+    int max_offset() const { return page_.height() - content_rows(); }
+    const FrameBuffer& page() const { return page_; }
+
+private:
+    FrameBuffer page_;
+    int view_height_;
+    int offset_ = 0;
+};
+
+// 拼接结果应该是页眉 + 整个页面 + 页脚（不比较滚动条）
+void ExpectStitchedPage(const ScrollingPage& page, const fs::path& path) {
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(ReadFile(path), &png));
+    const FrameBuffer& content = page.page();
+    ASSERT_EQ(png.width, content.width());
+    ASSERT_EQ(png.height, kHeaderRows + content.height() + kFooterRows);
+    for (int y = 0; y < content.height(); y++) {
+        for (int x = 0; x < content.width() - kScrollbar; x++) {
+            uint8_t expected[4];
+            testing::FramePixelRgba(content, x, y, expected);
+            const uint8_t* actual =
+                &png.rgba[(static_cast<size_t>(y + kHeaderRows) * png.width + x) * 4];
+            ASSERT_EQ(0, std::memcmp(expected, actual, 3)) << x << "," << y;
+        }
+    }
+    EXPECT_EQ(png.rgba[0], 0xC0);
+    EXPECT_EQ(png.rgba[static_cast<size_t>(png.height - 1) * png.width * 4], 0x80);
+}
+
+class ScrollStitcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = fs::path(::testing::TempDir()) /
+                ("scroll_" +
+                 std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()) +
+                 ".png");
+    }
+
+    void TearDown() override { fs::remove(path_); }
+
+    fs::path path_;
+};
+
+TEST_F(ScrollStitcherTest, StitchesScrolledFramesIntoTheWholePage) {
+    for (auto pattern : {SyntheticFrameSource::Pattern::kUi, SyntheticFrameSource::Pattern::kNoise}) {
+        ScrollingPage page(320, 1500, 360, pattern);
+        ScrollStitcher stitcher;
+        ASSERT_TRUE(stitcher.Open(path_.u8string()));
+        FrameBuffer frame;
+        int frames = 0;
+        for (;;) {
+            ASSERT_TRUE(page.Capture(page.GetBounds(), &frame));
+            const StitchResult result = stitcher.AddFrame(frame);
+            if (result == StitchResult::kUnchanged) break;
+            ASSERT_EQ(result, StitchResult::kAppended) << "frame " << frames;
+            frames++;
+            page.Scroll(137);
+        }
+        const ScrollStitchStats& stats = stitcher.stats();
+        EXPECT_EQ(stats.header_rows, kHeaderRows);
+        EXPECT_EQ(stats.footer_rows, kFooterRows);
+        EXPECT_EQ(stats.unchanged, 1);
+        ASSERT_TRUE(stitcher.Finish());
+        EXPECT_EQ(stitcher.stats().height, kHeaderRows + 1500 + kFooterRows);
+        EXPECT_EQ(stitcher.stats().bytes, fs::file_size(path_));
+        ExpectStitchedPage(page, path_);
+    }
+}
+
+TEST_F(ScrollStitcherTest, ScrollingPastAWholeScreenHasNoOverlap) {
+    ScrollingPage page(200, 1200, 240, SyntheticFrameSource::Pattern::kNoise);
+    ScrollStitcher stitcher;
+    ASSERT_TRUE(stitcher.Open(path_.u8string()));
+    FrameBuffer frame;
+    ASSERT_TRUE(page.Capture(page.GetBounds(), &frame));
+    ASSERT_EQ(stitcher.AddFrame(frame), StitchResult::kAppended);
+    page.Scroll(page.content_rows() + 10);
+    ASSERT_TRUE(page.Capture(page.GetBounds(), &frame));
+    EXPECT_EQ(stitcher.AddFrame(frame), StitchResult::kNoOverlap);
+    EXPECT_EQ(stitcher.stats().no_overlap, 1);
+
+    // 丢弃的帧不影响结果：只有第一帧
+    ASSERT_TRUE(stitcher.Finish());
+    testing::DecodedPng png;
+    ASSERT_TRUE(testing::DecodePng(ReadFile(path_), &png));
+    EXPECT_EQ(png.height, 240);
+}
+
+TEST_F(ScrollStitcherTest, RejectsFramesOfADifferentSize) {
+    ScrollStitcher stitcher;
+    EXPECT_EQ(stitcher.AddFrame(FrameBuffer(10, 10, PixelFormat::kBgrx8)), StitchResult::kFailed);
+    ASSERT_TRUE(stitcher.Open(path_.u8string()));
+    ASSERT_EQ(stitcher.AddFrame(FrameBuffer(100, 80, PixelFormat::kBgrx8)),
+              StitchResult::kAppended);
+    EXPECT_EQ(stitcher.AddFrame(FrameBuffer(100, 81, PixelFormat::kBgrx8)), StitchResult::kFailed);
+    EXPECT_EQ(stitcher.AddFrame(FrameBuffer(100, 80, PixelFormat::kBgra8)), StitchResult::kFailed);
+    stitcher.Abort();
+    EXPECT_FALSE(fs::exists(path_));
+    EXPECT_FALSE(stitcher.Finish());
+}
+
+TEST_F(ScrollStitcherTest, CaptureScrollingStopsAtTheEndOfThePage) {
+    ScrollingPage page(256, 900, 300, SyntheticFrameSource::Pattern::kUi);
+    ScrollCaptureOptions options;
+    options.settle = std::chrono::milliseconds(0);
+    options.unchanged_limit = 2;
+    int scrolls = 0;
+    ScrollStitchStats stats;
+    ASSERT_TRUE(CaptureScrolling(&page, page.GetBounds(), path_.u8string(), options,
+                                 [&] { scrolls++; return page.Scroll(200); },
+                                 CancellationToken(), &stats));
+    // 900 - 260 = 640 行需要 4 次滚动，之后两帧没有变化
+    EXPECT_EQ(scrolls, 6);
+    EXPECT_EQ(stats.frames, 7);
+    EXPECT_EQ(stats.unchanged, 2);
+    ExpectStitchedPage(page, path_);
+}
+
+TEST_F(ScrollStitcherTest, CaptureScrollingRespectsMaxHeight) {
+    ScrollingPage page(256, 3000, 300, SyntheticFrameSource::Pattern::kNoise);
+    ScrollCaptureOptions options;
+    options.settle = std::chrono::milliseconds(0);
+    options.max_height = 1000;
+    ScrollStitchStats stats;
+    ASSERT_TRUE(CaptureScrolling(&page, page.GetBounds(), path_.u8string(), options,
+                                 [&] { return page.Scroll(200); }, CancellationToken(), &stats));
+    EXPECT_LE(stats.height, 1000);
+    EXPECT_GT(stats.height, 1000 - 300);
+    EXPECT_EQ(stats.bytes, fs::file_size(path_));
+}
+
+TEST_F(ScrollStitcherTest, CaptureScrollingStopsWhenCancelled) {
+    ScrollingPage page(256, 3000, 300, SyntheticFrameSource::Pattern::kNoise);
+    ScrollCaptureOptions options;
+    options.settle = std::chrono::milliseconds(0);
+    CancellationToken token;
+    int scrolls = 0;
+    EXPECT_FALSE(CaptureScrolling(&page, page.GetBounds(), path_.u8string(), options,
+                                  [&] {
+                                      if (++scrolls == 2) token.Cancel();
+                                      return page.Scroll(200);
+                                  },
+                                  token, nullptr));
+    // 取消后不再滚动，写了一半的文件被删除
+    EXPECT_EQ(scrolls, 2);
+    EXPECT_FALSE(fs::exists(path_));
+}
+
+TEST_F(ScrollStitcherTest, CaptureScrollingCancelInterruptsTheSettleWait) {
+    ScrollingPage page(256, 3000, 300, SyntheticFrameSource::Pattern::kNoise);
+    ScrollCaptureOptions options;
+    options.settle = std::chrono::seconds(30);
+    CancellationToken token;
+    std::thread canceller([token] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        token.Cancel();
+    });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(CaptureScrolling(&page, page.GetBounds(), path_.u8string(), options,
+                                  [&] { return page.Scroll(200); }, token, nullptr));
+    canceller.join();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_FALSE(fs::exists(path_));
+}
+
+}  // namespace
+}  // namespace capture_core
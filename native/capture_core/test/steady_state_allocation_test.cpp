@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#include "capture_core/capture_pipeline.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/synthetic_frame_source.h"
+#include "capture_core/thread_pool.h"
+
+// 替换全局 operator new，统计打开开关期间的大块分配（整个测试程序生效）
+namespace {
+
+const size_t kLargeAllocationBytes = 64 * 1024;
+
+std::atomic<bool> g_counting(false);
+std::atomic<int> g_large_allocations(0);
+
+}  // namespace
+
+void* operator new(size_t size) {
+    if (size >= kLargeAllocationBytes && g_counting.load(std::memory_order_relaxed)) {
+        g_large_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    std::free(p);
+}
+
+namespace capture_core {
+namespace {
+
+class LargeAllocationCounter {
+public:
+    LargeAllocationCounter() {
+        g_large_allocations = 0;
+        g_counting = true;
+    }
+    ~LargeAllocationCounter() { g_counting = false; }
+
+    int count() const { return g_large_allocations.load(); }
+};
+
+// 定时截图（例如每秒一次）稳定后每次调用都应只复用已有的缓冲
+TEST(SteadyStateAllocationTest, RepeatedCaptureAndEncodeDoesNotAllocate) {
+    SyntheticFrameSource source(1920, 1080, SyntheticFrameSource::Pattern::kUi);
+    ThreadPool pool(2);
+    PngEncoderOptions options;
+    options.pool = &pool;
+    PngEncoder encoder(options);
+    CapturePipeline pipeline(&source, &encoder);
+
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(pipeline.CaptureFull(&png));
+    ASSERT_TRUE(pipeline.CaptureFull(&png));
+
+    LargeAllocationCounter counter;
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TRUE(pipeline.CaptureFull(&png));
+    }
+    EXPECT_EQ(counter.count(), 0);
+}
+
+TEST(SteadyStateAllocationTest, SmallerRegionReusesBuffers) {
+    SyntheticFrameSource source(1280, 720, SyntheticFrameSource::Pattern::kGradient);
+    PngEncoder encoder;
+    CapturePipeline pipeline(&source, &encoder);
+
+    std::vector<uint8_t> png;
+    ASSERT_TRUE(pipeline.CaptureFull(&png));
+    ASSERT_TRUE(pipeline.CaptureFull(&png));
+
+    LargeAllocationCounter counter;
+    ASSERT_TRUE(pipeline.CaptureRegion(Rect(100, 100, 640, 360), &png));
+    EXPECT_EQ(counter.count(), 0);
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,32 @@
+#include "capture_core/thread_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace capture_core {
+namespace {
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+    for (int threads : {0, 1, 4}) {
+        ThreadPool pool(threads);
+        std::vector<std::atomic<int>> hits(1000);
+        pool.ParallelFor(static_cast<int>(hits.size()), [&](int i) { hits[i]++; });
+        for (const auto& hit : hits) {
+            ASSERT_EQ(hit.load(), 1) << threads << " threads";
+        }
+    }
+}
+
+TEST(ThreadPoolTest, NestedAndConcurrentCallsComplete) {
+    ThreadPool pool(2);
+    std::atomic<int> total(0);
+    pool.ParallelFor(8, [&](int) {
+        pool.ParallelFor(8, [&](int) { total++; });
+    });
+    EXPECT_EQ(total.load(), 64);
+}
+
+}  // namespace
+}  // namespace capture_core
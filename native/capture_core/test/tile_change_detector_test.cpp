@@ -0,0 +1,225 @@
+#include "capture_core/tile_change_detector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "capture_core/synthetic_frame_source.h"
+#include "capture_core/thread_pool.h"
+#include "png_test_util.h"
+
+namespace capture_core {
+namespace {
+
+FrameBuffer Copy(const FrameBuffer& frame) {
+    FrameBuffer copy;
+    copy.CopyFrom(frame);
+    return copy;
+}
+
+void SetPixel(FrameBuffer* frame, int x, int y, uint8_t value) {
+    uint8_t* p = frame->row(y) + 4 * x;
+    p[0] = value;
+    p[1] = value;
+    p[2] = value;
+}
+
+TEST(TileChangeDetectorTest, FirstFrameIsFullAndIdenticalFrameIsClean) {
+    FrameBuffer frame = testing::SyntheticFrame(320, 200, SyntheticFrameSource::Pattern::kUi);
+    TileChangeDetector detector(64);
+    const TileDiff& first = detector.Compare(frame);
+    EXPECT_TRUE(first.full);
+    EXPECT_EQ(first.columns, 5);
+    EXPECT_EQ(first.rows, 4);
+    EXPECT_EQ(first.dirty_count, first.tile_count());
+
+    detector.UpdateReference();
+    const TileDiff& second = detector.Compare(frame);
+    EXPECT_FALSE(second.full);
+    EXPECT_EQ(second.dirty_count, 0u);
+    EXPECT_TRUE(second.DirtyBounds().empty());
+}
+
+TEST(TileChangeDetectorTest, SinglePixelChangeMarksOnlyItsTile) {
+    FrameBuffer frame = testing::SyntheticFrame(320, 200, SyntheticFrameSource::Pattern::kUi);
+    TileChangeDetector detector(64);
+    detector.Compare(frame);
+    detector.UpdateReference();
+
+    FrameBuffer changed = Copy(frame);
+    SetPixel(&changed, 130, 70, static_cast<uint8_t>(changed.row(70)[4 * 130] ^ 0x01));
+    const TileDiff& diff = detector.Compare(changed);
+    EXPECT_EQ(diff.dirty_count, 1u);
+    EXPECT_TRUE(diff.is_dirty(2, 1));
+    EXPECT_EQ(diff.DirtyBounds(), Rect(128, 64, 64, 64));
+}
+
+TEST(TileChangeDetectorTest, EdgeTilesAreClippedToTheFrame) {
+    FrameBuffer frame = testing::SyntheticFrame(301, 77, SyntheticFrameSource::Pattern::kUi);
+    TileChangeDetector detector(64);
+    detector.Compare(frame);
+    detector.UpdateReference();
+
+    FrameBuffer changed = Copy(frame);
+    SetPixel(&changed, 300, 76, 0x5A);
+    const TileDiff& diff = detector.Compare(changed);
+    EXPECT_EQ(diff.columns, 5);
+    EXPECT_EQ(diff.rows, 2);
+    EXPECT_EQ(diff.dirty_count, 1u);
+    EXPECT_EQ(diff.DirtyBounds(), Rect(256, 64, 45, 13));
+}
+
+TEST(TileChangeDetectorTest, IgnoresXChannelButNotAlpha) {
+    FrameBuffer frame = testing::SyntheticFrame(128, 64, SyntheticFrameSource::Pattern::kUi);
+    TileChangeDetector detector(64);
+    detector.Compare(frame);
+    detector.UpdateReference();
+
+    FrameBuffer changed = Copy(frame);
+    changed.row(10)[4 * 10 + 3] ^= 0xFF;
+    EXPECT_EQ(detector.Compare(changed).dirty_count, 0u);
+
+    // 带 alpha 的格式：alpha 变化算作变化（格式变化本身会让所有分块变脏）
+    FrameBuffer bgra = testing::SyntheticFrame(128, 64, SyntheticFrameSource::Pattern::kUi);
+    bgra.set_format(PixelFormat::kBgra8);
+    TileChangeDetector alpha_detector(64);
+    alpha_detector.Compare(bgra);
+    alpha_detector.UpdateReference();
+    bgra.row(10)[4 * 10 + 3] ^= 0xFF;
+    EXPECT_EQ(alpha_detector.Compare(bgra).dirty_count, 1u);
+}
+
+TEST(TileChangeDetectorTest, SizeChangeIsFull) {
+    TileChangeDetector detector(64);
+    detector.Compare(testing::SyntheticFrame(320, 200, SyntheticFrameSource::Pattern::kUi));
+    detector.UpdateReference();
+    const TileDiff& diff =
+        detector.Compare(testing::SyntheticFrame(320, 199, SyntheticFrameSource::Pattern::kUi));
+    EXPECT_TRUE(diff.full);
+    EXPECT_EQ(diff.dirty_count, diff.tile_count());
+}
+
+TEST(TileChangeDetectorTest, SerialAndParallelHashingAgree) {
+    FrameBuffer frame = testing::SyntheticFrame(1000, 700, SyntheticFrameSource::Pattern::kUi);
+    ThreadPool serial(0);
+    ThreadPool parallel(4);
+    TileChangeDetector a(64, &serial);
+    TileChangeDetector b(64, &parallel);
+    a.Compare(frame);
+    a.UpdateReference();
+    b.Compare(frame);
+    b.UpdateReference();
+
+    FrameBuffer changed = Copy(frame);
+    for (int i = 0; i < 20; i++) {
+        SetPixel(&changed, (i * 97) % 1000, (i * 61) % 700, static_cast<uint8_t>(i * 13));
+    }
+    const TileDiff& da = a.Compare(changed);
+    const TileDiff& db = b.Compare(changed);
+    EXPECT_EQ(da.dirty, db.dirty);
+    EXPECT_GT(da.dirty_count, 0u);
+}
+
+TEST(TileChangeDetectorTest, PatchOverReferenceReproducesFrame) {
+    FrameBuffer reference = testing::SyntheticFrame(301, 190, SyntheticFrameSource::Pattern::kUi);
+    TileChangeDetector detector(32);
+    detector.Compare(reference);
+    detector.UpdateReference();
+
+    FrameBuffer current = Copy(reference);
+    for (int y = 40; y < 70; y++) {
+        for (int x = 100; x < 180; x++) {
+            SetPixel(&current, x, y, static_cast<uint8_t>(x + y));
+        }
+    }
+    SetPixel(&current, 300, 189, 0x11);
+    const TileDiff& diff = detector.Compare(current);
+
+    FrameBuffer patch;
+    Rect bounds;
+    ASSERT_TRUE(ExtractDirtyTiles(current, diff, &patch, &bounds));
+    EXPECT_EQ(patch.format(), PixelFormat::kBgra8);
+    EXPECT_EQ(patch.width(), bounds.width);
+    EXPECT_EQ(patch.height(), bounds.height);
+
+    // 补丁的不透明像素贴回参考帧
+    for (int y = 0; y < reference.height(); y++) {
+        for (int x = 0; x < reference.width(); x++) {
+            const uint8_t* expected = current.row(y) + 4 * x;
+            const uint8_t* actual = reference.row(y) + 4 * x;
+            if (bounds.Contains(x, y)) {
+                const uint8_t* p = patch.row(y - bounds.y) + 4 * (x - bounds.x);
+                if (p[3] == 0xFF) {
+                    actual = p;
+                } else {
+                    ASSERT_EQ(std::memcmp(p, "\0\0\0\0", 4), 0);
+                }
+            }
+            ASSERT_EQ(std::memcmp(actual, expected, 3), 0) << x << "," << y;
+        }
+    }
+}
+
+TEST(ChangeTrackerTest, DecidesBetweenUnchangedPatchAndFullFrame) {
+    ChangeTracker tracker(64, 0.5);
+    FrameBuffer base = testing::SyntheticFrame(640, 384, SyntheticFrameSource::Pattern::kUi);
+
+    FrameBuffer frame = Copy(base);
+    ChangeDecision first = tracker.Process("task", true, &frame);
+    EXPECT_EQ(first.action, ChangeAction::kFullFrame);
+    EXPECT_EQ(first.total_tiles, 60u);
+
+    frame = Copy(base);
+    EXPECT_EQ(tracker.Process("task", true, &frame).action, ChangeAction::kUnchanged);
+
+    // 小范围变化：帧替换成补丁
+    frame = Copy(base);
+    SetPixel(&frame, 5, 5, 0x42);
+    ChangeDecision small = tracker.Process("task", true, &frame);
+    EXPECT_EQ(small.action, ChangeAction::kPatch);
+    EXPECT_EQ(small.patch_bounds, Rect(0, 0, 64, 64));
+    EXPECT_EQ(small.frame_width, 640);
+    EXPECT_EQ(frame.width(), 64);
+    EXPECT_EQ(frame.height(), 64);
+
+    // 补丁不更新参考帧：下一次仍然相对于整帧
+    frame = Copy(base);
+    EXPECT_EQ(tracker.Process("task", true, &frame).action, ChangeAction::kUnchanged);
+
+    // 大范围变化：保存整帧，并成为新的参考帧
+    FrameBuffer other = testing::SyntheticFrame(640, 384, SyntheticFrameSource::Pattern::kUi);
+    for (int y = 0; y < 384; y++) {
+        for (int x = 0; x < 640; x++) {
+            SetPixel(&other, x, y, static_cast<uint8_t>(x ^ y));
+        }
+    }
+    frame = Copy(other);
+    EXPECT_EQ(tracker.Process("task", true, &frame).action, ChangeAction::kFullFrame);
+    EXPECT_EQ(frame.width(), 640);
+    frame = Copy(other);
+    EXPECT_EQ(tracker.Process("task", true, &frame).action, ChangeAction::kUnchanged);
+}
+
+TEST(ChangeTrackerTest, KeysAreIndependentAndForgettable) {
+    ChangeTracker tracker;
+    FrameBuffer base = testing::SyntheticFrame(256, 128, SyntheticFrameSource::Pattern::kUi);
+
+    FrameBuffer frame = Copy(base);
+    tracker.Process("a", false, &frame);
+    frame = Copy(base);
+    EXPECT_EQ(tracker.Process("b", false, &frame).action, ChangeAction::kFullFrame);
+    EXPECT_EQ(tracker.size(), 2u);
+
+    // 不允许补丁时，变化的帧总是整帧
+    frame = Copy(base);
+    SetPixel(&frame, 1, 1, 0x42);
+    EXPECT_EQ(tracker.Process("a", false, &frame).action, ChangeAction::kFullFrame);
+
+    tracker.Forget("b");
+    EXPECT_EQ(tracker.size(), 1u);
+    frame = Copy(base);
+    EXPECT_EQ(tracker.Process("b", false, &frame).action, ChangeAction::kFullFrame);
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,72 @@
+#include "capture_core/window_icon.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace capture_core {
+namespace {
+
+// 追加一张纯色图标
+void AppendIcon(std::vector<unsigned long>* data, int width, int height, unsigned long argb) {
+    data->push_back(static_cast<unsigned long>(width));
+    data->push_back(static_cast<unsigned long>(height));
+    data->insert(data->end(), static_cast<size_t>(width) * height, argb);
+}
+
+TEST(WindowIconTest, ConvertsArgbToBgra) {
+    std::vector<unsigned long> data = {2, 1, 0x80112233u, 0xFF445566u};
+    FrameBuffer icon;
+    ASSERT_TRUE(SelectNetWmIcon(data.data(), data.size(), 32, &icon));
+    ASSERT_EQ(icon.width(), 2);
+    ASSERT_EQ(icon.height(), 1);
+    EXPECT_EQ(icon.format(), PixelFormat::kBgra8);
+    const uint8_t* p = icon.row(0);
+    EXPECT_EQ(p[0], 0x33);
+    EXPECT_EQ(p[1], 0x22);
+    EXPECT_EQ(p[2], 0x11);
+    EXPECT_EQ(p[3], 0x80);
+    EXPECT_EQ(p[4], 0x66);
+    EXPECT_EQ(p[7], 0xFF);
+}
+
+TEST(WindowIconTest, PicksSmallestIconNotBelowPreferredSize) {
+    std::vector<unsigned long> data;
+    AppendIcon(&data, 16, 16, 0xFF000010u);
+    AppendIcon(&data, 64, 64, 0xFF000040u);
+    AppendIcon(&data, 32, 32, 0xFF000020u);
+    AppendIcon(&data, 128, 128, 0xFF000080u);
+
+    FrameBuffer icon;
+    ASSERT_TRUE(SelectNetWmIcon(data.data(), data.size(), 24, &icon));
+    EXPECT_EQ(icon.width(), 24);  // 32 缩小到 24
+    EXPECT_EQ(icon.row(0)[0], 0x20);
+
+    ASSERT_TRUE(SelectNetWmIcon(data.data(), data.size(), 64, &icon));
+    EXPECT_EQ(icon.width(), 64);
+    EXPECT_EQ(icon.row(0)[0], 0x40);
+
+    // 都比期望的小时取最大的，不放大
+    ASSERT_TRUE(SelectNetWmIcon(data.data(), data.size(), 256, &icon));
+    EXPECT_EQ(icon.width(), 128);
+    EXPECT_EQ(icon.row(0)[0], 0x80);
+}
+
+TEST(WindowIconTest, RejectsTruncatedData) {
+    std::vector<unsigned long> data;
+    AppendIcon(&data, 8, 8, 0xFF0000FFu);
+    FrameBuffer icon;
+    EXPECT_FALSE(SelectNetWmIcon(data.data(), data.size() - 1, 32, &icon));
+    EXPECT_FALSE(SelectNetWmIcon(data.data(), 1, 32, &icon));
+
+    // 后面被截断的图标忽略，前面完整的仍然可用
+    std::vector<unsigned long> partial = data;
+    partial.push_back(64);
+    partial.push_back(64);
+    partial.push_back(0);
+    ASSERT_TRUE(SelectNetWmIcon(partial.data(), partial.size(), 32, &icon));
+    EXPECT_EQ(icon.width(), 8);
+}
+
+}  // namespace
+}  // namespace capture_core
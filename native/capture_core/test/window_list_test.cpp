@@ -0,0 +1,98 @@
+#include "capture_core/window_list.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace capture_core {
+namespace {
+
+WindowRecord Window(uint64_t id, const std::string& title, int x = 0) {
+    WindowRecord window;
+    window.id = id;
+    window.title = title;
+    window.app_name = "app";
+    window.bounds = Rect(x, 0, 800, 600);
+    return window;
+}
+
+std::vector<uint64_t> Ids(const std::vector<WindowRecord>& windows) {
+    std::vector<uint64_t> ids;
+    for (const WindowRecord& window : windows) {
+        ids.push_back(window.id);
+    }
+    return ids;
+}
+
+TEST(WindowListModelTest, ResetReportsTheInitialListAndLaterDifferences) {
+    WindowListModel model;
+    model.Reset({Window(3, "c"), Window(1, "a"), Window(2, "b")});
+    WindowListDiff diff = model.TakeDiff();
+    EXPECT_EQ(Ids(diff.added), (std::vector<uint64_t>{3, 1, 2}));
+    EXPECT_TRUE(diff.updated.empty());
+    EXPECT_TRUE(diff.removed.empty());
+    EXPECT_FALSE(model.has_changes());
+
+    // 重新同步：1 改名，2 消失，4 出现，3 不变
+    model.Reset({Window(4, "d"), Window(3, "c"), Window(1, "a2")});
+    diff = model.TakeDiff();
+    EXPECT_EQ(Ids(diff.added), (std::vector<uint64_t>{4}));
+    EXPECT_EQ(Ids(diff.updated), (std::vector<uint64_t>{1}));
+    EXPECT_EQ(diff.updated[0].title, "a2");
+    EXPECT_EQ(diff.removed, (std::vector<uint64_t>{2}));
+    EXPECT_EQ(Ids(model.Snapshot()), (std::vector<uint64_t>{4, 3, 1}));
+}
+
+TEST(WindowListModelTest, CoalescesEventsPerWindow) {
+    WindowListModel model;
+    model.Reset({Window(1, "a"), Window(2, "b")});
+    model.TakeDiff();
+
+    // 同一个窗口多次移动只报告最后的位置；相同的内容不算变化
+    EXPECT_TRUE(model.Upsert(Window(1, "a", 10)));
+    EXPECT_TRUE(model.Upsert(Window(1, "a", 20)));
+    EXPECT_FALSE(model.Upsert(Window(1, "a", 20)));
+    // 出现后又消失的窗口不报告
+    EXPECT_TRUE(model.Upsert(Window(5, "tooltip")));
+    EXPECT_TRUE(model.Remove(5));
+    // 消失后又出现是更新
+    EXPECT_TRUE(model.Remove(2));
+    EXPECT_TRUE(model.Upsert(Window(2, "b again")));
+    // 新窗口之后再改名仍是新增
+    EXPECT_TRUE(model.Upsert(Window(6, "new")));
+    EXPECT_TRUE(model.Upsert(Window(6, "renamed")));
+    EXPECT_FALSE(model.Remove(42));
+
+    WindowListDiff diff = model.TakeDiff();
+    ASSERT_EQ(diff.added.size(), 1u);
+    EXPECT_EQ(diff.added[0].title, "renamed");
+    EXPECT_EQ(Ids(diff.updated), (std::vector<uint64_t>{2, 1}));
+    EXPECT_EQ(diff.updated[1].bounds.x, 20);
+    EXPECT_TRUE(diff.removed.empty());
+    // 新出现的窗口排在最前
+    EXPECT_EQ(Ids(model.Snapshot()), (std::vector<uint64_t>{6, 2, 1}));
+    EXPECT_TRUE(model.TakeDiff().empty());
+}
+
+TEST(WindowListModelTest, RemovesPreviouslyReportedWindows) {
+    WindowListModel model;
+    model.Upsert(Window(7, "x"));
+    model.Upsert(Window(8, "y"));
+    model.TakeDiff();
+
+    model.Upsert(Window(7, "x2"));
+    EXPECT_TRUE(model.Remove(7));
+    EXPECT_TRUE(model.Remove(8));
+    EXPECT_FALSE(model.Contains(7));
+    EXPECT_EQ(model.Find(8), nullptr);
+
+    WindowListDiff diff = model.TakeDiff();
+    EXPECT_TRUE(diff.added.empty());
+    EXPECT_TRUE(diff.updated.empty());
+    EXPECT_EQ(diff.removed, (std::vector<uint64_t>{7, 8}));
+    EXPECT_EQ(model.size(), 0u);
+}
+
+}  // namespace
+}  // namespace capture_core
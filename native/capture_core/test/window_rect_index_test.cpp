@@ -0,0 +1,109 @@
+#include "capture_core/window_rect_index.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+namespace capture_core {
+namespace {
+
+TEST(WindowRectIndexTest, TopmostWindowWinsAndChildrenAreFollowed) {
+    WindowRectIndex index(Rect(0, 0, 1920, 1080), 64);
+    // 从上到下：对话框压在编辑器上
+    const int dialog = index.Add(1, Rect(600, 300, 400, 300));
+    const int editor = index.Add(2, Rect(100, 100, 1200, 800));
+    const int toolbar = index.Add(3, Rect(100, 100, 1200, 40), editor);
+    const int button = index.Add(4, Rect(110, 105, 30, 30), toolbar);
+    const int text = index.Add(5, Rect(100, 140, 1200, 760), editor);
+    const int ok = index.Add(6, Rect(880, 540, 100, 40), dialog);
+
+    EXPECT_EQ(index.TopLevelAt(120, 110), editor);
+    EXPECT_EQ(index.DeepestAt(120, 110), button);
+    EXPECT_EQ(index.DeepestAt(120, 110, 1), toolbar);
+    EXPECT_EQ(index.DeepestAt(300, 110), toolbar);
+    EXPECT_EQ(index.DeepestAt(300, 500), text);
+    // 对话框遮住的部分属于对话框，不会落到编辑器的子控件上
+    EXPECT_EQ(index.DeepestAt(700, 400), dialog);
+    EXPECT_EQ(index.DeepestAt(900, 550), ok);
+    EXPECT_EQ(index.entry(button).depth, 2);
+    EXPECT_EQ(index.entry(ok).id, 6u);
+    // 桌面空白处和 bounds 以外
+    EXPECT_EQ(index.DeepestAt(1500, 1000), -1);
+    EXPECT_EQ(index.DeepestAt(-5, 10), -1);
+}
+
+TEST(WindowRectIndexTest, ClipsToParentAndBounds) {
+    WindowRectIndex index(Rect(-1920, 0, 3840, 1080));
+    // 跨两个显示器并超出下边缘的窗口
+    const int window = index.Add(1, Rect(-200, 900, 400, 400));
+    EXPECT_EQ(index.entry(window).rect, Rect(-200, 900, 400, 180));
+    // 子控件超出父窗口的部分被裁掉，完全在外面的不添加
+    const int child = index.Add(2, Rect(150, 950, 200, 50), window);
+    EXPECT_EQ(index.entry(child).rect, Rect(150, 950, 50, 50));
+    EXPECT_EQ(index.Add(3, Rect(300, 950, 20, 20), window), -1);
+    EXPECT_EQ(index.Add(4, Rect(5000, 0, 100, 100)), -1);
+    // 还不存在的父元素
+    EXPECT_EQ(index.Add(5, Rect(0, 0, 10, 10), 42), -1);
+    EXPECT_EQ(index.size(), 2u);
+
+    EXPECT_EQ(index.DeepestAt(180, 960), child);
+    EXPECT_EQ(index.DeepestAt(250, 960), -1);
+    EXPECT_EQ(index.DeepestAt(-150, 1000), window);
+
+    index.Reset(Rect(0, 0, 100, 100));
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.DeepestAt(-150, 1000), -1);
+    EXPECT_EQ(WindowRectIndex().Add(1, Rect(0, 0, 10, 10)), -1);
+}
+
+// 直接按 z 序逐个比较的参考实现
+int LinearDeepestAt(const std::vector<WindowRectEntry>& entries, int x, int y) {
+    int current = -1;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].parent == current && entries[i].rect.Contains(x, y)) {
+            current = static_cast<int>(i);
+        }
+    }
+    return current;
+}
+
+TEST(WindowRectIndexTest, MatchesLinearScan) {
+    const Rect desktop(0, 0, 2560, 1440);
+    WindowRectIndex index(desktop, 100);
+    std::vector<WindowRectEntry> entries;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(-200, 2600);
+    std::uniform_int_distribution<int> size(20, 1200);
+    for (int window = 0; window < 40; window++) {
+        const int top = index.Add(window, Rect(coord(rng), coord(rng), size(rng), size(rng)));
+        if (top < 0) continue;
+        // 每个窗口几层子控件，兄弟之间可能重叠
+        std::vector<int> parents = {top};
+        for (int child = 0; child < 12; child++) {
+            const int parent = parents[rng() % parents.size()];
+            const Rect& area = index.entry(parent).rect;
+            const int added = index.Add(
+                1000 + child, Rect(area.x + static_cast<int>(rng() % (area.width + 1)) - 10,
+                                   area.y + static_cast<int>(rng() % (area.height + 1)) - 10,
+                                   1 + static_cast<int>(rng() % 300),
+                                   1 + static_cast<int>(rng() % 200)),
+                parent);
+            if (added >= 0) parents.push_back(added);
+        }
+    }
+    for (size_t i = 0; i < index.size(); i++) {
+        entries.push_back(index.entry(static_cast<int>(i)));
+    }
+    ASSERT_GT(entries.size(), 100u);
+
+    std::uniform_int_distribution<int> px(-10, 2570);
+    for (int i = 0; i < 20000; i++) {
+        const int x = px(rng);
+        const int y = px(rng) % 1450;
+        ASSERT_EQ(index.DeepestAt(x, y), LinearDeepestAt(entries, x, y)) << x << "," << y;
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,130 @@
+#include "capture_core/x11_monitors.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <X11/Xlib.h>
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+#include <X11/extensions/Xrandr.h>
+#endif
+
+#include "capture_core/multi_monitor_capture.h"
+#include "capture_core/x11_shm_frame_source.h"
+
+namespace capture_core {
+namespace {
+
+// 需要真实或虚拟（Xvfb）显示，没有 $DISPLAY 时跳过
+//
+// 设置 CAPTURE_CORE_SPLIT_MONITORS=N 时（ctest 的 xvfb 用例），
+// 用 XRRSetMonitor 把根窗口横向切成 N 个显示器，模拟多屏工作站
+class X11MonitorsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (std::getenv("DISPLAY") == nullptr) {
+            GTEST_SKIP() << "DISPLAY is not set";
+        }
+        display_ = XOpenDisplay(nullptr);
+        if (display_ == nullptr) {
+            GTEST_SKIP() << "cannot open X display";
+        }
+        const char* split = std::getenv("CAPTURE_CORE_SPLIT_MONITORS");
+        if (split != nullptr) {
+            split_count_ = std::atoi(split);
+            SplitRoot();
+        }
+    }
+
+    void TearDown() override {
+        if (display_ == nullptr) {
+            return;
+        }
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+        for (int i = 0; i < split_count_; i++) {
+            XRRDeleteMonitor(display_, DefaultRootWindow(display_), MonitorAtom(i));
+        }
+        XSync(display_, False);
+#endif
+        XCloseDisplay(display_);
+    }
+
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+    Atom MonitorAtom(int i) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "CAPTURE-CORE-%d", i);
+        return XInternAtom(display_, name, False);
+    }
+#endif
+
+    void SplitRoot() {
+#if defined(CAPTURE_CORE_HAS_XRANDR)
+        XWindowAttributes attributes;
+        XGetWindowAttributes(display_, DefaultRootWindow(display_), &attributes);
+        int width = attributes.width / split_count_;
+        for (int i = 0; i < split_count_; i++) {
+            XRRMonitorInfo info = {};
+            info.name = MonitorAtom(i);
+            info.primary = i == 0 ? True : False;
+            info.x = i * width;
+            info.y = 0;
+            info.width = width;
+            info.height = attributes.height;
+            info.mwidth = width / 4;
+            info.mheight = attributes.height / 4;
+            XRRSetMonitor(display_, DefaultRootWindow(display_), &info);
+        }
+        XSync(display_, False);
+#else
+        split_count_ = 0;
+#endif
+    }
+
+    Display* display_ = nullptr;
+    int split_count_ = 0;
+};
+
+TEST_F(X11MonitorsTest, EnumeratesAtLeastOneMonitor) {
+    std::vector<MonitorInfo> monitors = EnumerateX11Monitors();
+    ASSERT_FALSE(monitors.empty());
+    for (size_t i = 0; i < monitors.size(); i++) {
+        EXPECT_EQ(monitors[i].index, static_cast<int>(i));
+        EXPECT_FALSE(monitors[i].bounds.empty());
+    }
+    if (split_count_ > 0) {
+        EXPECT_EQ(monitors.size(), static_cast<size_t>(split_count_));
+    }
+}
+
+TEST_F(X11MonitorsTest, CapturesVirtualDesktopWithOneConnectionPerMonitor) {
+    std::vector<MonitorInfo> monitors = EnumerateX11Monitors();
+    ASSERT_FALSE(monitors.empty());
+    Rect desktop = VirtualDesktopBounds(monitors);
+
+    std::vector<X11ShmFrameSource*> sources;
+    MultiMonitorCapture capture(monitors, [&](const MonitorInfo& monitor) {
+        auto source = std::make_unique<X11ShmFrameSource>(nullptr, monitor.bounds);
+        sources.push_back(source.get());
+        return source;
+    });
+
+    FrameBuffer frame;
+    ASSERT_TRUE(capture.CaptureVirtualDesktop(&frame));
+    EXPECT_EQ(frame.width(), desktop.width);
+    EXPECT_EQ(frame.height(), desktop.height);
+
+    // 每个连接的共享内存段只按自己的显示器分配
+    for (size_t i = 0; i < sources.size(); i++) {
+        if (sources[i]->using_shm()) {
+            const Rect& bounds = monitors[i].bounds;
+            EXPECT_EQ(sources[i]->segment_size(),
+                      static_cast<size_t>(bounds.width) * bounds.height * 4);
+        }
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
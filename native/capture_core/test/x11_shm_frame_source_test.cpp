@@ -0,0 +1,169 @@
+#include "capture_core/x11_shm_frame_source.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <memory>
+
+#include <X11/Xlib.h>
+
+namespace capture_core {
+namespace {
+
+// 需要真实或虚拟（Xvfb）显示，没有 $DISPLAY 时跳过
+class X11ShmFrameSourceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (std::getenv("DISPLAY") == nullptr) {
+            GTEST_SKIP() << "DISPLAY is not set";
+        }
+        source_.reset(new X11ShmFrameSource());
+        if (!source_->is_open()) {
+            GTEST_SKIP() << "cannot open X display";
+        }
+    }
+
+    std::unique_ptr<X11ShmFrameSource> source_;
+};
+
+TEST_F(X11ShmFrameSourceTest, CapturesFullScreen) {
+    Rect bounds = source_->GetBounds();
+    ASSERT_FALSE(bounds.empty());
+
+    FrameBuffer frame;
+    ASSERT_TRUE(source_->Capture(bounds, &frame));
+    EXPECT_EQ(frame.width(), bounds.width);
+    EXPECT_EQ(frame.height(), bounds.height);
+    EXPECT_EQ(frame.format(), PixelFormat::kBgrx8);
+}
+
+TEST_F(X11ShmFrameSourceTest, RegionIsClippedAndSegmentReused) {
+    Rect bounds = source_->GetBounds();
+    FrameBuffer frame;
+    ASSERT_TRUE(source_->Capture(bounds, &frame));
+    int allocations = source_->segment_allocations();
+
+    ASSERT_TRUE(source_->Capture(Rect(bounds.width - 10, bounds.height - 20, 100, 100), &frame));
+    EXPECT_EQ(frame.width(), 10);
+    EXPECT_EQ(frame.height(), 20);
+    ASSERT_TRUE(source_->Capture(Rect(0, 0, 64, 64), &frame));
+
+    // 较小的区域复用全屏时创建的共享内存段
+    EXPECT_EQ(source_->segment_allocations(), allocations);
+    EXPECT_FALSE(source_->Capture(Rect(bounds.width, 0, 10, 10), &frame));
+}
+
+TEST_F(X11ShmFrameSourceTest, FramePointsIntoSegment) {
+    if (!source_->using_shm()) {
+        GTEST_SKIP() << "MIT-SHM is not available";
+    }
+    Rect bounds = source_->GetBounds();
+    FrameBuffer frame;
+    ASSERT_TRUE(source_->Capture(bounds, &frame));
+    if (frame.owns_memory()) {
+        GTEST_SKIP() << "non 32-bit visual is converted";
+    }
+    const uint8_t* data = frame.data();
+
+    // 重复截图落在同一块共享内存里，既不分配也不拷贝
+    ASSERT_TRUE(source_->Capture(Rect(0, 0, 32, 32), &frame));
+    EXPECT_EQ(frame.data(), data);
+    ASSERT_TRUE(source_->Capture(bounds, &frame));
+    EXPECT_EQ(frame.data(), data);
+    EXPECT_EQ(source_->segment_allocations(), 1);
+}
+
+TEST_F(X11ShmFrameSourceTest, ReadsWindowPixels) {
+    Display* display = XOpenDisplay(nullptr);
+    ASSERT_NE(display, nullptr);
+    int screen = DefaultScreen(display);
+    int depth = DefaultDepth(display, screen);
+
+    // 纯色、不受窗口管理器装饰的窗口
+    XSetWindowAttributes attributes = {};
+    attributes.override_redirect = True;
+    attributes.background_pixel = 0x3366CC;
+    Window window = XCreateWindow(display, RootWindow(display, screen), 20, 30, 64, 48, 0,
+                                  CopyFromParent, InputOutput, CopyFromParent,
+                                  CWOverrideRedirect | CWBackPixel, &attributes);
+    XMapRaised(display, window);
+    XClearWindow(display, window);
+    XSync(display, False);
+
+    FrameBuffer frame;
+    bool captured = source_->Capture(Rect(30, 40, 16, 16), &frame);
+
+    XDestroyWindow(display, window);
+    XCloseDisplay(display);
+
+    ASSERT_TRUE(captured);
+    if (depth < 24) {
+        GTEST_SKIP() << "non TrueColor display";
+    }
+    const uint8_t* pixel = frame.row(8) + 8 * 4;
+    EXPECT_EQ(pixel[0], 0xCC);
+    EXPECT_EQ(pixel[1], 0x66);
+    EXPECT_EQ(pixel[2], 0x33);
+}
+
+Window CreateSolidWindow(Display* display, int x, int y, unsigned long color) {
+    XSetWindowAttributes attributes = {};
+    attributes.override_redirect = True;
+    attributes.background_pixel = color;
+    return XCreateWindow(display, DefaultRootWindow(display), x, y, 64, 48, 0, CopyFromParent,
+                         InputOutput, CopyFromParent, CWOverrideRedirect | CWBackPixel,
+                         &attributes);
+}
+
+TEST_F(X11ShmFrameSourceTest, CapturesSingleWindow) {
+    Display* display = XOpenDisplay(nullptr);
+    ASSERT_NE(display, nullptr);
+    const int depth = DefaultDepth(display, DefaultScreen(display));
+    Window window = CreateSolidWindow(display, 20, 30, 0x3366CC);
+    XSync(display, False);
+
+    // 映射前就重定向，窗口内容画进离屏像素图
+    std::unique_ptr<X11ShmFrameSource> source = X11ShmFrameSource::ForWindow(window);
+    ASSERT_TRUE(source->is_open());
+    XMapRaised(display, window);
+    XClearWindow(display, window);
+    // 另一个窗口盖住它的右半边
+    Window cover = CreateSolidWindow(display, 52, 30, 0x00FF00);
+    XMapRaised(display, cover);
+    XClearWindow(display, cover);
+    XSync(display, False);
+
+    EXPECT_EQ(source->GetBounds(), Rect(0, 0, 64, 48));
+    FrameBuffer frame;
+    bool captured = source->Capture(Rect(0, 0, 64, 48), &frame);
+    const bool composite = source->using_composite();
+
+    XDestroyWindow(display, cover);
+    XDestroyWindow(display, window);
+    XSync(display, False);
+    // 窗口销毁后截图失败而不是结束进程
+    FrameBuffer after;
+    EXPECT_TRUE(source->GetBounds().empty());
+    EXPECT_FALSE(source->Capture(Rect(0, 0, 64, 48), &after));
+    XCloseDisplay(display);
+
+    ASSERT_TRUE(captured);
+    EXPECT_EQ(frame.width(), 64);
+    EXPECT_EQ(frame.height(), 48);
+    if (depth < 24) {
+        GTEST_SKIP() << "non TrueColor display";
+    }
+    EXPECT_EQ(frame.row(24)[8 * 4 + 0], 0xCC);
+    EXPECT_EQ(frame.row(24)[8 * 4 + 2], 0x33);
+    // 被遮住的部分：离屏像素图里仍是窗口自己的内容，屏幕截取时是上面的窗口
+    const uint8_t* covered = frame.row(24) + 48 * 4;
+    if (composite) {
+        EXPECT_EQ(covered[0], 0xCC);
+        EXPECT_EQ(covered[1], 0x66);
+    } else {
+        EXPECT_EQ(covered[1], 0xFF);
+    }
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,195 @@
+#include "capture_core/x11_window_tracker.h"
+#include "capture_core/x11_windows.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+
+namespace capture_core {
+namespace {
+
+// 需要真实或虚拟（Xvfb）显示，没有 $DISPLAY 时跳过。
+// 测试自己充当窗口管理器：创建并映射窗口，维护根窗口的 _NET_CLIENT_LIST
+class X11WindowTrackerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        if (std::getenv("DISPLAY") == nullptr) {
+            GTEST_SKIP() << "DISPLAY is not set";
+        }
+        display_ = XOpenDisplay(nullptr);
+        if (display_ == nullptr) {
+            GTEST_SKIP() << "cannot open X display";
+        }
+        root_ = DefaultRootWindow(display_);
+        client_list_ = XInternAtom(display_, "_NET_CLIENT_LIST", False);
+        wm_name_ = XInternAtom(display_, "_NET_WM_NAME", False);
+        utf8_string_ = XInternAtom(display_, "UTF8_STRING", False);
+    }
+
+    void TearDown() override {
+        if (display_ == nullptr) return;
+        tracker_.Stop();
+        XDeleteProperty(display_, root_, client_list_);
+        for (Window window : windows_) {
+            XDestroyWindow(display_, window);
+        }
+        XCloseDisplay(display_);
+    }
+
+    Window CreateWindow(const std::string& title, int x, int y) {
+        Window window = XCreateSimpleWindow(display_, root_, x, y, 320, 200, 0, 0, 0);
+        SetTitle(window, title);
+        XMapWindow(display_, window);
+        windows_.push_back(window);
+        PublishClientList();
+        return window;
+    }
+
+    void DestroyWindow(Window window) {
+        XDestroyWindow(display_, window);
+        windows_.erase(std::remove(windows_.begin(), windows_.end(), window), windows_.end());
+        PublishClientList();
+    }
+
+    void SetTitle(Window window, const std::string& title) {
+        XChangeProperty(display_, window, wm_name_, utf8_string_, 8, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(title.data()),
+                        static_cast<int>(title.size()));
+        XSync(display_, False);
+    }
+
+    void PublishClientList() {
+        std::vector<unsigned long> list(windows_.begin(), windows_.end());
+        XChangeProperty(display_, root_, client_list_, XA_WINDOW, 32, PropModeReplace,
+                        reinterpret_cast<const unsigned char*>(list.data()),
+                        static_cast<int>(list.size()));
+        XSync(display_, False);
+    }
+
+    void StartTracker() {
+        ASSERT_TRUE(tracker_.Start(
+            [this](const WindowListDiff& diff) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                diffs_.push_back(diff);
+                cv_.notify_all();
+            },
+            std::chrono::milliseconds(20)));
+    }
+
+    // 等待下一批差异
+    WindowListDiff NextDiff() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool arrived = cv_.wait_for(lock, std::chrono::seconds(5), [this] { return !diffs_.empty(); });
+        EXPECT_TRUE(arrived) << "no window list change reported";
+        if (!arrived) return WindowListDiff();
+        WindowListDiff diff = diffs_.front();
+        diffs_.erase(diffs_.begin());
+        return diff;
+    }
+
+    Display* display_ = nullptr;
+    Window root_ = 0;
+    Atom client_list_ = 0;
+    Atom wm_name_ = 0;
+    Atom utf8_string_ = 0;
+    std::vector<Window> windows_;
+
+    X11WindowTracker tracker_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<WindowListDiff> diffs_;
+};
+
+TEST_F(X11WindowTrackerTest, InitialSnapshotListsClientWindows) {
+    Window first = CreateWindow("first", 10, 20);
+    Window second = CreateWindow("second", 400, 20);
+    StartTracker();
+
+    std::vector<WindowRecord> windows = tracker_.Snapshot();
+    ASSERT_EQ(windows.size(), 2u);
+    // 最近映射的在前
+    EXPECT_EQ(windows[0].id, second);
+    EXPECT_EQ(windows[0].title, "second");
+    EXPECT_EQ(windows[1].id, first);
+    EXPECT_EQ(windows[1].bounds, Rect(10, 20, 320, 200));
+}
+
+TEST_F(X11WindowTrackerTest, ReportsAddedUpdatedAndRemovedWindows) {
+    Window first = CreateWindow("first", 10, 20);
+    StartTracker();
+    ASSERT_EQ(tracker_.Snapshot().size(), 1u);
+
+    SetTitle(first, "renamed");
+    WindowListDiff diff = NextDiff();
+    ASSERT_EQ(diff.updated.size(), 1u);
+    EXPECT_EQ(diff.updated[0].id, first);
+    EXPECT_EQ(diff.updated[0].title, "renamed");
+    EXPECT_TRUE(diff.added.empty());
+
+    Window second = CreateWindow("second", 400, 20);
+    diff = NextDiff();
+    ASSERT_EQ(diff.added.size(), 1u);
+    EXPECT_EQ(diff.added[0].id, second);
+
+    DestroyWindow(first);
+    diff = NextDiff();
+    EXPECT_EQ(diff.removed, (std::vector<uint64_t>{first}));
+    ASSERT_EQ(tracker_.Snapshot().size(), 1u);
+    EXPECT_EQ(tracker_.Snapshot()[0].id, second);
+}
+
+TEST_F(X11WindowTrackerTest, UnmappedWindowsAreRemoved) {
+    Window window = CreateWindow("window", 10, 20);
+    StartTracker();
+    ASSERT_EQ(tracker_.Snapshot().size(), 1u);
+
+    XUnmapWindow(display_, window);
+    XSync(display_, False);
+    WindowListDiff diff = NextDiff();
+    EXPECT_EQ(diff.removed, (std::vector<uint64_t>{window}));
+
+    XMapWindow(display_, window);
+    XSync(display_, False);
+    diff = NextDiff();
+    ASSERT_EQ(diff.added.size(), 1u);
+    EXPECT_EQ(diff.added[0].title, "window");
+}
+
+TEST_F(X11WindowTrackerTest, EnumeratesWindowsWithIcons) {
+    Window plain = CreateWindow("plain", 10, 20);
+    Window with_icon = CreateWindow("with icon", 400, 20);
+    // 两张图标：16x16 和 48x48，应选 48 的缩小到 32
+    std::vector<unsigned long> icon;
+    for (int size : {16, 48}) {
+        icon.push_back(size);
+        icon.push_back(size);
+        icon.insert(icon.end(), static_cast<size_t>(size * size), 0xFF336699ul);
+    }
+    XChangeProperty(display_, with_icon, XInternAtom(display_, "_NET_WM_ICON", False),
+                    XA_CARDINAL, 32, PropModeReplace,
+                    reinterpret_cast<const unsigned char*>(icon.data()),
+                    static_cast<int>(icon.size()));
+    XSync(display_, False);
+
+    std::vector<WindowRecord> windows = EnumerateX11Windows();
+    ASSERT_EQ(windows.size(), 2u);
+    EXPECT_EQ(windows[0].id, with_icon);
+    EXPECT_EQ(windows[0].title, "with icon");
+    ASSERT_GT(windows[0].icon.size(), 8u);
+    EXPECT_EQ(windows[0].icon[1], 'P');
+    EXPECT_EQ(windows[1].id, plain);
+    EXPECT_TRUE(windows[1].icon.empty());
+}
+
+}  // namespace
+}  // namespace capture_core
@@ -0,0 +1,270 @@
+import 'dart:async';
+
+import 'package:flutter_test/flutter_test.dart';
+import 'package:plugin_platform/plugins/screenshot/models/recurring_screenshot_task.dart';
+import 'package:plugin_platform/plugins/screenshot/models/screenshot_models.dart';
+import 'package:plugin_platform/plugins/screenshot/screenshot_plugin.dart';
+import 'package:plugin_platform/plugins/screenshot/services/recurring_task_manager.dart';
+
+/// 只记录调用的插件：RecurringTaskManager 通过这四个方法驱动截图
+class FakeScreenshotPlugin extends ScreenshotPlugin {
+  /// 原生调度器是否可用（false 时任务改用 Dart 定时器）
+  bool nativeAvailable = true;
+
+  /// 设置后 startNativeSchedule 按顺序等待这些答复
+  final List<Completer<bool>> pendingStarts = [];
+
+  final List<String> startCalls = [];
+  final List<String> stopCalls = [];
+  final List<ScheduledShot> handledShots = [];
+  int captureCalls = 0;
+
+  void Function(ScheduledShot shot)? _onShot;
+
+  /// 模拟原生调度器报告一次触发
+  void emit(ScheduledShot shot) => _onShot!(shot);
+
+  @override
+  Future<bool> startNativeSchedule(
+    RecurringScreenshotTask task, {
+    required void Function(ScheduledShot shot) onShot,
+  }) async {
+    startCalls.add(task.id);
+    _onShot = onShot;
+    if (pendingStarts.isNotEmpty) {
+      return pendingStarts.removeAt(0).future;
+    }
+    return nativeAvailable;
+  }
+
+  @override
+  Future<void> stopNativeSchedule(String taskId) async {
+    stopCalls.add(taskId);
+  }
+
+  @override
+  Future<void> handleScheduledShot(
+    RecurringScreenshotTask task,
+    ScheduledShot shot,
+  ) async {
+    handledShots.add(shot);
+  }
+
+  @override
+  Future<void> captureForRecurringTask(RecurringScreenshotTask task) async {
+    captureCalls++;
+  }
+}
+
+ScheduledShot _shot(
+  String taskId,
+  int index, {
+  ScheduledShotStatus status = ScheduledShotStatus.saved,
+  int missed = 0,
+  DateTime? time,
+}) {
+  return ScheduledShot(
+    taskId: taskId,
+    scheduleId: 1,
+    index: index,
+    status: status,
+    missed: missed,
+    time: time,
+  );
+}
+
+void main() {
+  late FakeScreenshotPlugin plugin;
+  late RecurringTaskManager manager;
+
+  setUp(() {
+    plugin = FakeScreenshotPlugin();
+    manager = RecurringTaskManager(plugin: plugin);
+  });
+
+  tearDown(() {
+    manager.dispose();
+  });
+
+  RecurringScreenshotTask task(String id) => manager.tasks.firstWhere(
+    (t) => t.id == id,
+  );
+
+  group('native schedule', () {
+    test('progress counts missed ticks and clamps to totalShots', () async {
+      final created = manager.createTask(
+        name: 'progress',
+        intervalSeconds: 1,
+        totalShots: 5,
+      );
+      await pumpEventQueue();
+      final id = created.id;
+
+      final firstTime = DateTime(2026, 1, 1, 12);
+      plugin.emit(_shot(id, 1, time: firstTime));
+      expect(task(id).completedShots, 1);
+      expect(task(id).lastShotTime, firstTime);
+
+      // 跳过的触发计入进度，但不算作截图时间
+      plugin.emit(
+        _shot(id, 4, status: ScheduledShotStatus.skipped, missed: 2),
+      );
+      expect(task(id).completedShots, 4);
+      expect(task(id).lastShotTime, firstTime);
+      expect(task(id).status, TaskStatus.running);
+      expect(plugin.stopCalls, isEmpty);
+
+      plugin.emit(_shot(id, 8, missed: 3));
+      expect(task(id).completedShots, 5);
+      expect(task(id).status, TaskStatus.completed);
+      expect(plugin.stopCalls, [id]);
+      expect(plugin.handledShots, hasLength(3));
+
+      // 停止后迟到的触发被忽略
+      plugin.emit(_shot(id, 9));
+      expect(task(id).completedShots, 5);
+      expect(plugin.handledShots, hasLength(3));
+    });
+
+    test('pause, resume and delete stop the native schedule', () async {
+      final id = manager
+          .createTask(name: 'lifecycle', intervalSeconds: 1)
+          .id;
+      await pumpEventQueue();
+      expect(plugin.startCalls, [id]);
+
+      manager.pauseTask(id);
+      expect(plugin.stopCalls, [id]);
+      expect(task(id).status, TaskStatus.paused);
+
+      manager.resumeTask(id);
+      await pumpEventQueue();
+      expect(plugin.startCalls, [id, id]);
+
+      manager.deleteTask(id);
+      expect(plugin.stopCalls, [id, id]);
+      expect(manager.tasks, isEmpty);
+    });
+
+    test('pausing while the start is pending stops the late schedule', () async {
+      final reply = Completer<bool>();
+      plugin.pendingStarts.add(reply);
+      final id = manager.createTask(name: 'late', intervalSeconds: 1).id;
+      await pumpEventQueue();
+
+      manager.pauseTask(id);
+      expect(plugin.stopCalls, isEmpty);
+
+      reply.complete(true);
+      await pumpEventQueue();
+      expect(plugin.stopCalls, [id]);
+
+      plugin.emit(_shot(id, 1));
+      expect(task(id).completedShots, 0);
+    });
+
+    test('resuming while the first start is pending keeps one schedule', () async {
+      final first = Completer<bool>();
+      final second = Completer<bool>();
+      plugin.pendingStarts.addAll([first, second]);
+      final id = manager.createTask(name: 'resume', intervalSeconds: 1).id;
+      await pumpEventQueue();
+
+      manager.pauseTask(id);
+      manager.resumeTask(id);
+      await pumpEventQueue();
+      expect(plugin.startCalls, [id, id]);
+
+      // 原生端的第二个计划替换了第一个，两次答复都不能停止它
+      first.complete(true);
+      await pumpEventQueue();
+      expect(plugin.stopCalls, isEmpty);
+
+      second.complete(true);
+      await pumpEventQueue();
+      expect(plugin.stopCalls, isEmpty);
+
+      plugin.emit(_shot(id, 1));
+      expect(task(id).completedShots, 1);
+      expect(plugin.captureCalls, 0);
+    });
+  });
+
+  testWidgets('falls back to the Dart timer without a native scheduler', (
+    tester,
+  ) async {
+    plugin.nativeAvailable = false;
+    final id = manager
+        .createTask(name: 'timer', intervalSeconds: 1, totalShots: 2)
+        .id;
+    await tester.pump();
+    expect(plugin.startCalls, [id]);
+    expect(plugin.captureCalls, 0);
+
+    await tester.pump(const Duration(seconds: 1));
+    expect(plugin.captureCalls, 1);
+    expect(task(id).completedShots, 1);
+
+    await tester.pump(const Duration(seconds: 1));
+    expect(plugin.captureCalls, 2);
+    expect(task(id).status, TaskStatus.completed);
+
+    await tester.pump(const Duration(seconds: 1));
+    expect(plugin.captureCalls, 2);
+    // 定时器任务从未交给原生调度器
+    expect(plugin.stopCalls, isEmpty);
+  });
+
+  group('acceptFrame', () {
+    RecurringScreenshotTask dedupTask({int? dedupDistance}) {
+      return RecurringScreenshotTask(
+        id: 'dedup',
+        name: 'dedup',
+        intervalSeconds: 1,
+        dedupDistance: dedupDistance,
+        status: TaskStatus.running,
+        createdAt: DateTime(2026),
+      );
+    }
+
+    test('always accepts without a threshold or a hash', () {
+      final noFilter = dedupTask();
+      expect(manager.acceptFrame(noFilter, 0), isTrue);
+      expect(manager.acceptFrame(noFilter, 0), isTrue);
+
+      final filtered = dedupTask(dedupDistance: 4);
+      expect(manager.acceptFrame(filtered, null), isTrue);
+      expect(manager.acceptFrame(filtered, null), isTrue);
+    });
+
+    test('rejects near duplicates of the last kept hash', () {
+      final filtered = dedupTask(dedupDistance: 4);
+
+      expect(manager.acceptFrame(filtered, 0x00), isTrue);
+      // 距离 3：近似重复
+      expect(manager.acceptFrame(filtered, 0x07), isFalse);
+      // 距离 4 仍在阈值内
+      expect(manager.acceptFrame(filtered, 0x0F), isFalse);
+      // 距离 8：保存，并成为新的参照
+      expect(manager.acceptFrame(filtered, 0xFF), isTrue);
+      expect(manager.acceptFrame(filtered, 0xFE), isFalse);
+    });
+
+    test('records the hash only for accepted frames', () {
+      final filtered = dedupTask(dedupDistance: 4);
+
+      expect(manager.acceptFrame(filtered, 0x00), isTrue);
+      expect(manager.acceptFrame(filtered, 0x07), isFalse);
+      // 与 0x07 只差 3，但与保留的 0x00 差 6
+      expect(manager.acceptFrame(filtered, 0x3F), isTrue);
+    });
+
+    test('deleting the task forgets its kept hash', () {
+      final filtered = dedupTask(dedupDistance: 4);
+
+      expect(manager.acceptFrame(filtered, 0x00), isTrue);
+      manager.deleteTask(filtered.id);
+      expect(manager.acceptFrame(filtered, 0x01), isTrue);
+    });
+  });
+}
@@ -0,0 +1,107 @@
+import 'dart:typed_data';
+import 'dart:ui' show Rect;
+
+import 'package:flutter/services.dart';
+import 'package:flutter_test/flutter_test.dart';
+import 'package:plugin_platform/plugins/screenshot/platform/screenshot_platform_interface.dart';
+
+/// WindowsScreenshotService 的通道载荷
+///
+/// 原生端以 std::vector<uint8_t> 返回图片和图标，经 StandardMethodCodec 解码后
+/// 直接是 Uint8List；这里用模拟的 MethodChannel 回复，检查服务原样交出字节。
+void main() {
+  TestWidgetsFlutterBinding.ensureInitialized();
+
+  const channel = MethodChannel('com.example.screenshot/screenshot');
+  final messenger =
+      TestDefaultBinaryMessengerBinding.instance.defaultBinaryMessenger;
+
+  final png = Uint8List.fromList([
+    0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, //
+  ]);
+  final icon = Uint8List.fromList(List<int>.generate(64, (i) => i * 3 & 0xFF));
+
+  late List<MethodCall> calls;
+  late WindowsScreenshotService service;
+
+  void reply(Object? Function(MethodCall call) handler) {
+    messenger.setMockMethodCallHandler(channel, (call) async {
+      calls.add(call);
+      return handler(call);
+    });
+  }
+
+  setUp(() {
+    calls = [];
+    service = WindowsScreenshotService();
+  });
+
+  tearDown(() {
+    messenger.setMockMethodCallHandler(channel, null);
+  });
+
+  test('captureFullScreen returns the reply bytes as Uint8List', () async {
+    reply((_) => png);
+
+    final bytes = await service.captureFullScreen();
+
+    expect(bytes, isA<Uint8List>());
+    expect(bytes, equals(png));
+    expect(calls.single.method, 'captureFullScreen');
+    expect(calls.single.arguments, {'format': 'png', 'quality': 90});
+  });
+
+  test('captureRegion sends the region and returns Uint8List', () async {
+    reply((_) => png);
+
+    final bytes = await service.captureRegion(
+      const Rect.fromLTWH(10, 20, 300, 200),
+    );
+
+    expect(bytes, isA<Uint8List>());
+    expect(bytes, equals(png));
+    expect(calls.single.method, 'captureRegion');
+    expect(calls.single.arguments, {
+      'x': 10,
+      'y': 20,
+      'width': 300,
+      'height': 200,
+      'format': 'png',
+      'quality': 90,
+    });
+  });
+
+  test('null reply yields null', () async {
+    reply((_) => null);
+
+    expect(await service.captureFullScreen(), isNull);
+    expect(
+      await service.captureRegion(const Rect.fromLTWH(0, 0, 1, 1)),
+      isNull,
+    );
+  });
+
+  test('getAvailableWindows keeps icons as Uint8List', () async {
+    reply(
+      (_) => [
+        {
+          'id': '0x1a2b',
+          'title': 'Editor',
+          'appName': 'code.exe',
+          'icon': icon,
+        },
+        {'id': '0x3c4d', 'title': 'Terminal', 'appName': null, 'icon': null},
+      ],
+    );
+
+    final windows = await service.getAvailableWindows();
+
+    expect(windows, hasLength(2));
+    expect(windows[0].id, '0x1a2b');
+    expect(windows[0].appName, 'code.exe');
+    expect(windows[0].icon, isA<Uint8List>());
+    expect(windows[0].icon, equals(icon));
+    expect(windows[1].title, 'Terminal');
+    expect(windows[1].icon, isNull);
+  });
+}
@@ -0,0 +1,117 @@
+// Pooled DIB sections for GDI captures
+#include "dib_section_pool.h"
+
+#include <algorithm>
+
+using capture_core::Rect;
+
+std::unique_ptr<DibSection> DibSection::Create(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return nullptr;
+    }
+
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;  // Negative for top-down DIB
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    std::unique_ptr<DibSection> section(new DibSection());
+    section->dc_ = CreateCompatibleDC(NULL);
+    if (section->dc_ == NULL) {
+        return nullptr;
+    }
+    void* bits = nullptr;
+    section->bitmap_ = CreateDIBSection(section->dc_, &bmi, DIB_RGB_COLORS, &bits, NULL, 0);
+    if (section->bitmap_ == NULL || bits == nullptr) {
+        return nullptr;
+    }
+    section->old_bitmap_ = SelectObject(section->dc_, section->bitmap_);
+    section->bits_ = static_cast<uint8_t*>(bits);
+    section->width_ = width;
+    section->height_ = height;
+    return section;
+}
+
+DibSection::~DibSection() {
+    if (dc_ != NULL && old_bitmap_ != NULL) {
+        SelectObject(dc_, old_bitmap_);
+    }
+    if (bitmap_ != NULL) {
+        DeleteObject(bitmap_);
+    }
+    if (dc_ != NULL) {
+        DeleteDC(dc_);
+    }
+}
+
+DibSectionPool& DibSectionPool::Shared() {
+    static DibSectionPool pool;
+    return pool;
+}
+
+std::unique_ptr<DibSection> DibSectionPool::Acquire(const Rect& region) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 选能容纳区域的最小缓冲，大缓冲留给全屏截图
+        auto best = idle_.end();
+        for (auto it = idle_.begin(); it != idle_.end(); ++it) {
+            if ((*it)->Fits(region.width, region.height) &&
+                (best == idle_.end() || (*it)->size_bytes() < (*best)->size_bytes())) {
+                best = it;
+            }
+        }
+        if (best != idle_.end()) {
+            std::unique_ptr<DibSection> section = std::move(*best);
+            idle_.erase(best);
+            return section;
+        }
+    }
+
+    // 没有合适的缓冲时按区域所在显示器的大小创建
+    RECT rect = {region.x, region.y, region.x + region.width, region.y + region.height};
+    int width = region.width;
+    int height = region.height;
+    MONITORINFO info = {};
+    info.cbSize = sizeof(info);
+    if (GetMonitorInfo(MonitorFromRect(&rect, MONITOR_DEFAULTTONEAREST), &info)) {
+        width = (std::max)(width, static_cast<int>(info.rcMonitor.right - info.rcMonitor.left));
+        height = (std::max)(height, static_cast<int>(info.rcMonitor.bottom - info.rcMonitor.top));
+    }
+
+    std::unique_ptr<DibSection> section = DibSection::Create(width, height);
+    if (section) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        allocations_++;
+    }
+    return section;
+}
+
+void DibSectionPool::Release(std::unique_ptr<DibSection> section) {
+    if (!section) {
+        return;
+    }
+    std::unique_ptr<DibSection> evicted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(std::move(section));
+        if (idle_.size() > kMaxIdle) {
+            // 超出上限时丢弃最小的缓冲
+            auto smallest = std::min_element(
+                idle_.begin(), idle_.end(),
+                [](const std::unique_ptr<DibSection>& a, const std::unique_ptr<DibSection>& b) {
+                    return a->size_bytes() < b->size_bytes();
+                });
+            evicted = std::move(*smallest);
+            idle_.erase(smallest);
+        }
+    }
+    // 在锁外删除 GDI 对象
+}
+
+int DibSectionPool::allocations() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return allocations_;
+}
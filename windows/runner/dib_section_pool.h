@@ -0,0 +1,72 @@
+#ifndef RUNNER_DIB_SECTION_POOL_H_
+#define RUNNER_DIB_SECTION_POOL_H_
+
+#include <windows.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "capture_core/geometry.h"
+
+// 自上而下的 32 位 DIB section，常驻选入一个内存 DC
+// BitBlt / PrintWindow 直接写进 bits()，编码器原地读取，不需要 GetDIBits
+class DibSection {
+public:
+    // 失败返回 nullptr
+    static std::unique_ptr<DibSection> Create(int width, int height);
+    ~DibSection();
+
+    DibSection(const DibSection&) = delete;
+    DibSection& operator=(const DibSection&) = delete;
+
+    HDC dc() const { return dc_; }
+    uint8_t* bits() const { return bits_; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int stride() const { return width_ * 4; }
+    size_t size_bytes() const { return static_cast<size_t>(stride()) * height_; }
+
+    bool Fits(int width, int height) const { return width <= width_ && height <= height_; }
+
+private:
+    DibSection() = default;
+
+    HDC dc_ = NULL;
+    HBITMAP bitmap_ = NULL;
+    HGDIOBJ old_bitmap_ = NULL;
+    uint8_t* bits_ = nullptr;
+    int width_ = 0;
+    int height_ = 0;
+};
+
+// 截图缓冲池
+//
+// 新建的 DIB section 按目标区域所在显示器的大小分配，
+// 之后同一显示器上的全屏、区域和窗口截图都复用它。
+// 工作线程（以及多显示器截图的各个显示器）可以同时借出不同的缓冲；
+// 归还后最多保留 kMaxIdle 个。
+class DibSectionPool {
+public:
+    // 覆盖两个截图工作线程，以及多显示器截图时每个显示器各借一个（三屏工作站），
+    // 定时截图稳定后不再创建新的位图
+    static constexpr size_t kMaxIdle = 4;
+
+    static DibSectionPool& Shared();
+
+    // 借出一个至少能容纳 region 的缓冲
+    std::unique_ptr<DibSection> Acquire(const capture_core::Rect& region);
+    void Release(std::unique_ptr<DibSection> section);
+
+    // 累计创建的 DIB section 数（用于确认复用）
+    int allocations() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<DibSection>> idle_;
+    int allocations_ = 0;
+};
+
+#endif  // RUNNER_DIB_SECTION_POOL_H_
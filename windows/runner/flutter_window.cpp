@@ -7,6 +7,7 @@
 #include <flutter/standard_method_codec.h>
 #include <fstream>
 #include <windowsx.h>  // 用于 GET_X_LPARAM 和 GET_Y_LPARAM
+#include <mmsystem.h>  // timeBeginPeriod / timeEndPeriod
 
 // GDI+ 需要 min/max 宏，确保它们可用
 #ifndef min
@@ -27,6 +28,21 @@ using namespace Gdiplus;
 static ULONG_PTR gdiplusToken = 0;
 static bool gdiplusInitialized = false;
 
+// 工作线程通知平台线程执行 platform_tasks_ 的消息
+static constexpr UINT kRunPlatformTasksMessage = WM_APP + 1;
+
+// 截图工作线程数和最多排队的请求数；超出时回复 BUSY
+static constexpr int kCaptureWorkerCount = 2;
+static constexpr size_t kMaxPendingCaptures = 4;
+
+// 两阶段截图的编码线程数（PngEncoder 自己在共享线程池上并行）和最多排队的帧数
+static constexpr int kEncodeWorkerCount = 1;
+static constexpr size_t kMaxPendingEncodes = 4;
+// 最近一次截图请求之后安静多久才开始把 QOI 转成 PNG
+static constexpr std::chrono::milliseconds kTranscodeIdleDelay(5000);
+// getFramePreview 默认的预览长边
+static constexpr int kDefaultPreviewDimension = 1024;
+
 // 文件日志函数
 static void LogToFile(const char* message) {
   static std::ofstream logFile;
@@ -91,7 +107,17 @@ static void ShutdownGDIPlus() {
 #include "flutter/generated_plugin_registrant.h"
 #include "screenshot_plugin.h"
 #include "native_screenshot_window.h"
+#include "frozen_frame_store.h"
+#include "frame_texture_registry.h"
+#include "gdi_frame_source.h"
+#include "monitor_capture.h"
 #include "hotkey_manager.h"
+#include "window_tracker.h"
+
+#include "capture_core/perceptual_hash.h"
+#include "capture_core/pixel_convert.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/scroll_stitcher.h"
 
 // 互斥锁保护区域选择结果
 static SRWLOCK g_regionSelectionLock = SRWLOCK_INIT;
@@ -125,6 +151,14 @@ bool FlutterWindow::OnCreate() {
   // Initialize GDI+ for screenshot functionality
   InitializeGDIPlus();
 
+  capture_jobs_ = std::make_unique<capture_core::JobQueue>(kCaptureWorkerCount,
+                                                           kMaxPendingCaptures);
+  encode_queue_ = std::make_unique<capture_core::EncodeQueue>(
+      []() { return std::unique_ptr<capture_core::FrameEncoder>(new capture_core::PngEncoder()); },
+      kEncodeWorkerCount, kMaxPendingEncodes);
+  transcoder_ = std::make_unique<capture_core::IdleTranscoder>(kTranscodeIdleDelay);
+  scheduler_ = std::make_unique<capture_core::CaptureScheduler>(capture_jobs_.get());
+
   RECT frame = GetClientArea();
 
   // The size here must match the window dimensions to avoid unnecessary surface
@@ -137,6 +171,9 @@ bool FlutterWindow::OnCreate() {
   }
   RegisterPlugins(flutter_controller_->engine());
 
+  frame_textures_ = std::make_unique<FrameTextureRegistry>(
+      flutter_controller_->engine()->texture_registrar());
+
   // Register screenshot event channel for region selection feedback
   RegisterScreenshotEventChannel();
 
@@ -144,12 +181,12 @@ bool FlutterWindow::OnCreate() {
   RegisterHotkeyEventChannel();
 
   // Register screenshot method channel
-  auto screenshot_channel =
+  screenshot_method_channel_ =
       std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
           flutter_controller_->engine()->messenger(), "com.example.screenshot/screenshot",
           &flutter::StandardMethodCodec::GetInstance());
 
-  screenshot_channel->SetMethodCallHandler(
+  screenshot_method_channel_->SetMethodCallHandler(
       [this](const auto& call, auto result) {
         HandleScreenshotMethodCall(call, std::move(result));
       });
@@ -208,6 +245,41 @@ bool FlutterWindow::OnCreate() {
 }
 
 void FlutterWindow::OnDestroy() {
+  // 先停止循环截图的调度线程（排队中的触发以 skipped 通知），它不再提交新的截图
+  scheduler_ = nullptr;
+  // 录到一半退出时放弃录制，不完整的文件被删除
+  recorder_ = nullptr;
+  // 停止即时回放的采集；正在保存的回放持有自己的引用
+  instant_replay_ = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(scheduled_tasks_mutex_);
+    scheduled_tasks_.clear();
+    recording_ = false;
+    UpdateTimerResolution();
+  }
+  // 再停止截图任务，并在引擎销毁前回复所有已完成/已取消的请求
+  if (capture_jobs_) {
+    capture_jobs_->CancelAll();
+    // 工作线程可能正在向本线程的窗口发送消息（GetWindowText / PrintWindow），
+    // 等待期间继续处理跨线程发送的消息，否则 join 会死锁
+    MSG msg;
+    while (capture_jobs_->running() > 0) {
+      MsgWaitForMultipleObjects(0, nullptr, FALSE, 10, QS_SENDMESSAGE);
+      PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+    }
+    capture_jobs_ = nullptr;
+  }
+  // 窗口跟踪线程可能正在向本窗口发送 WM_GETICON，Stop 等待时会处理
+  window_tracker_ = nullptr;
+  // 截图任务已停止，不会再提交新帧；取消排队的编码并等待正在编码的帧
+  encode_queue_ = nullptr;
+  // 尚未转码的 QOI 文件保留在磁盘上，Dart 下次启动时重新提交
+  transcoder_ = nullptr;
+  RunPlatformTasks();
+  FrozenFrameStore::Shared().Clear();
+  // 预览纹理要在引擎之前注销
+  frame_textures_ = nullptr;
+
   if (flutter_controller_) {
     flutter_controller_ = nullptr;
   }
@@ -287,6 +359,9 @@ FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
     case WM_FONTCHANGE:
       flutter_controller_->engine()->ReloadSystemFonts();
       break;
+    case kRunPlatformTasksMessage:
+      RunPlatformTasks();
+      return 0;
     case WM_HOTKEY:
       if (hotkey_manager_) {
         hotkey_manager_->HandleHotkeyMessage(wparam, lparam);
@@ -303,21 +378,627 @@ void FlutterWindow::RegisterScreenshotEventChannel() {
   // 使用全局变量 g_screenshot_event_sink 存储事件 sink（通过 MethodChannel 反向调用）
 }
 
+void FlutterWindow::PostToPlatformThread(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(platform_tasks_mutex_);
+    platform_tasks_.push_back(std::move(task));
+  }
+  PostMessage(GetHandle(), kRunPlatformTasksMessage, 0, 0);
+}
+
+void FlutterWindow::RunPlatformTasks() {
+  std::deque<std::function<void()>> tasks;
+  {
+    std::lock_guard<std::mutex> lock(platform_tasks_mutex_);
+    tasks.swap(platform_tasks_);
+  }
+  for (auto& task : tasks) {
+    task();
+  }
+}
+
+// 显示器信息转成 Dart 端的 map（键名与 Linux 实现一致）
+static flutter::EncodableMap MonitorToEncodable(const capture_core::MonitorInfo& monitor) {
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("index")] = flutter::EncodableValue(monitor.index);
+  map[flutter::EncodableValue("x")] = flutter::EncodableValue(monitor.bounds.x);
+  map[flutter::EncodableValue("y")] = flutter::EncodableValue(monitor.bounds.y);
+  map[flutter::EncodableValue("width")] = flutter::EncodableValue(monitor.bounds.width);
+  map[flutter::EncodableValue("height")] = flutter::EncodableValue(monitor.bounds.height);
+  map[flutter::EncodableValue("primary")] = flutter::EncodableValue(monitor.primary);
+  map[flutter::EncodableValue("name")] = flutter::EncodableValue(monitor.name);
+  return map;
+}
+
+static flutter::EncodableList MonitorListToEncodable(
+    const std::vector<capture_core::MonitorInfo>& monitors) {
+  flutter::EncodableList list;
+  for (const auto& monitor : monitors) {
+    list.push_back(flutter::EncodableValue(MonitorToEncodable(monitor)));
+  }
+  return list;
+}
+
+// 窗口跟踪的记录转成 Dart 端的 map（与 getAvailableWindows 相同的键，另带屏幕坐标）
+static flutter::EncodableValue WindowRecordToEncodable(const capture_core::WindowRecord& window) {
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("id")] = flutter::EncodableValue(WindowTracker::FormatId(window.id));
+  map[flutter::EncodableValue("title")] = flutter::EncodableValue(window.title);
+  if (!window.app_name.empty()) {
+    map[flutter::EncodableValue("appName")] = flutter::EncodableValue(window.app_name);
+  }
+  if (!window.icon.empty()) {
+    map[flutter::EncodableValue("icon")] = flutter::EncodableValue(window.icon);
+  }
+  map[flutter::EncodableValue("x")] = flutter::EncodableValue(window.bounds.x);
+  map[flutter::EncodableValue("y")] = flutter::EncodableValue(window.bounds.y);
+  map[flutter::EncodableValue("width")] = flutter::EncodableValue(window.bounds.width);
+  map[flutter::EncodableValue("height")] = flutter::EncodableValue(window.bounds.height);
+  return flutter::EncodableValue(map);
+}
+
+static flutter::EncodableList WindowRecordsToEncodable(
+    const std::vector<capture_core::WindowRecord>& windows) {
+  flutter::EncodableList list;
+  for (const auto& window : windows) {
+    list.push_back(WindowRecordToEncodable(window));
+  }
+  return list;
+}
+
+// 读取整数参数（Dart int 按大小编码为 int32 或 int64）
+static bool ReadIntArgument(const flutter::EncodableMap& arguments, const char* key,
+                            int64_t* value) {
+  auto it = arguments.find(flutter::EncodableValue(key));
+  if (it == arguments.end()) {
+    return false;
+  }
+  if (const auto* v32 = std::get_if<int32_t>(&it->second)) {
+    *value = *v32;
+    return true;
+  }
+  if (const auto* v64 = std::get_if<int64_t>(&it->second)) {
+    *value = *v64;
+    return true;
+  }
+  return false;
+}
+
+// 读取编码格式参数：format 为 "png"（默认）、"jpeg" 或 "qoi"，quality 为 JPEG 质量 1-100；
+// 参数缺失或无法识别时使用 PNG
+static capture_core::EncodeOptions ReadEncodeOptions(const flutter::EncodableValue* arguments) {
+  capture_core::EncodeOptions options;
+  const auto* map = arguments ? std::get_if<flutter::EncodableMap>(arguments) : nullptr;
+  if (!map) {
+    return options;
+  }
+  auto format_it = map->find(flutter::EncodableValue("format"));
+  if (format_it != map->end()) {
+    if (const auto* format = std::get_if<std::string>(&format_it->second)) {
+      if (*format == "jpeg") {
+        options.format = capture_core::ImageFormat::kJpeg;
+      } else if (*format == "qoi") {
+        options.format = capture_core::ImageFormat::kQoi;
+      }
+    }
+  }
+  int64_t quality = 0;
+  if (ReadIntArgument(*map, "quality", &quality)) {
+    options.quality = static_cast<int>(std::clamp<int64_t>(quality, 1, 100));
+  }
+  return options;
+}
+
+// 把编码结果写到 Dart 指定的路径（UTF-8）
+static bool WriteBytesToFile(const std::string& path, const std::vector<uint8_t>& bytes) {
+  int wideLength = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+  if (wideLength <= 1) {
+    return false;
+  }
+  std::wstring widePath(wideLength - 1, L'\0');
+  MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], wideLength);
+
+  HANDLE file = CreateFileW(widePath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  DWORD written = 0;
+  BOOL ok = WriteFile(file, bytes.data(), static_cast<DWORD>(bytes.size()), &written, nullptr);
+  CloseHandle(file);
+  return ok && written == bytes.size();
+}
+
+// 读取字符串参数，缺失或类型不对时返回空串
+static std::string ReadStringArgument(const flutter::EncodableMap& arguments, const char* key) {
+  auto it = arguments.find(flutter::EncodableValue(key));
+  if (it != arguments.end()) {
+    if (const auto* value = std::get_if<std::string>(&it->second)) {
+      return *value;
+    }
+  }
+  return std::string();
+}
+
+// 读取布尔参数，缺失或类型不对时返回 false
+static bool ReadBoolArgument(const flutter::EncodableMap& arguments, const char* key) {
+  auto it = arguments.find(flutter::EncodableValue(key));
+  if (it != arguments.end()) {
+    if (const auto* value = std::get_if<bool>(&it->second)) {
+      return *value;
+    }
+  }
+  return false;
+}
+
+// 即时回放运行时由原生端处理的热键（Dart 按同名 actionId 注册）
+static const char kSaveReplayAction[] = "saveReplay";
+
+// 即时回放保存的文件：directory 下的 replay_<毫秒时间戳>.gif / .png
+static std::string ReplayFilePath(const std::string& directory,
+                                  capture_core::AnimationFormat format) {
+  const int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  return directory + "\\replay_" + std::to_string(now) +
+         (format == capture_core::AnimationFormat::kGif ? ".gif" : ".png");
+}
+
+// saveInstantReplay 的回复和 onReplaySaved 的参数
+static flutter::EncodableMap ReplayExportToEncodable(const std::string& path,
+                                                     capture_core::AnimationFormat format,
+                                                     const capture_core::ReplayExport& exported) {
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("path")] = flutter::EncodableValue(path);
+  map[flutter::EncodableValue("format")] = flutter::EncodableValue(
+      std::string(format == capture_core::AnimationFormat::kGif ? "gif" : "apng"));
+  map[flutter::EncodableValue("frames")] = flutter::EncodableValue(exported.frames);
+  map[flutter::EncodableValue("durationMs")] =
+      flutter::EncodableValue(static_cast<int64_t>(exported.duration.count()));
+  map[flutter::EncodableValue("bytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(exported.bytes));
+  return map;
+}
+
+// stopRecording 的回复；文件写入失败时为 null
+static flutter::EncodableValue RecordingStatsToEncodable(const capture_core::RecordingStats& stats) {
+  if (!stats.ok) {
+    return flutter::EncodableValue();
+  }
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("frames")] = flutter::EncodableValue(stats.written);
+  map[flutter::EncodableValue("merged")] = flutter::EncodableValue(stats.merged);
+  map[flutter::EncodableValue("dropped")] = flutter::EncodableValue(stats.dropped);
+  map[flutter::EncodableValue("durationMs")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.duration.count()));
+  map[flutter::EncodableValue("bytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.bytes));
+  return flutter::EncodableValue(map);
+}
+
+// getInstantReplayStats 的回复：时间以毫秒 / 微秒为单位，内存以字节为单位
+static flutter::EncodableMap ReplayStatsToEncodable(const capture_core::ReplayStats& stats) {
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("captured")] = flutter::EncodableValue(stats.captured);
+  map[flutter::EncodableValue("failedCaptures")] = flutter::EncodableValue(stats.failed_captures);
+  map[flutter::EncodableValue("unchanged")] = flutter::EncodableValue(stats.unchanged);
+  map[flutter::EncodableValue("evicted")] = flutter::EncodableValue(stats.evicted);
+  map[flutter::EncodableValue("frames")] = flutter::EncodableValue(stats.frames);
+  map[flutter::EncodableValue("keyframes")] = flutter::EncodableValue(stats.keyframes);
+  map[flutter::EncodableValue("spanMs")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.span.count()));
+  map[flutter::EncodableValue("bytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.bytes));
+  map[flutter::EncodableValue("peakBytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.peak_bytes));
+  map[flutter::EncodableValue("workingBytes")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.working_bytes));
+  map[flutter::EncodableValue("uptimeMs")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.uptime.count()));
+  map[flutter::EncodableValue("captureUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.capture_time.count()));
+  map[flutter::EncodableValue("encodeUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.encode_time.count()));
+  map[flutter::EncodableValue("cpuUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(stats.cpu_time.count()));
+  return map;
+}
+
+// beginCapture / startSchedule 的截图目标
+struct CaptureTarget {
+  std::string mode;  // fullScreen / region / selectedRegion / window
+  int x = 0;
+  int y = 0;
+  int width = 0;
+  int height = 0;
+  HWND hwnd = NULL;
+};
+
+// 解析 mode 和它需要的参数（区域或 windowId），失败时返回错误信息
+static const char* ReadCaptureTarget(const flutter::EncodableMap& arguments,
+                                     CaptureTarget* target) {
+  target->mode = ReadStringArgument(arguments, "mode");
+  if (target->mode.empty()) {
+    return "Missing mode parameter";
+  }
+  if (target->mode == "region" || target->mode == "selectedRegion") {
+    int64_t x = 0, y = 0, width = 0, height = 0;
+    if (!ReadIntArgument(arguments, "x", &x) || !ReadIntArgument(arguments, "y", &y) ||
+        !ReadIntArgument(arguments, "width", &width) ||
+        !ReadIntArgument(arguments, "height", &height) || width <= 0 || height <= 0) {
+      return "Invalid region";
+    }
+    target->x = static_cast<int>(x);
+    target->y = static_cast<int>(y);
+    target->width = static_cast<int>(width);
+    target->height = static_cast<int>(height);
+  } else if (target->mode == "window") {
+    const std::string windowId = ReadStringArgument(arguments, "windowId");
+    if (windowId.empty()) {
+      return "Missing windowId parameter";
+    }
+    target->hwnd = HwndFromString(windowId);
+  } else if (target->mode != "fullScreen") {
+    return "Unknown capture mode";
+  }
+  return nullptr;
+}
+
+// 按截图目标捕获一帧（工作线程）
+static bool CaptureTargetFrame(const CaptureTarget& target, capture_core::FrameBuffer* frame) {
+  if (target.mode == "fullScreen") {
+    return CaptureFullScreenFrame(frame);
+  } else if (target.mode == "region") {
+    return CaptureRegionFrame(target.x, target.y, target.width, target.height, frame);
+  } else if (target.mode == "selectedRegion") {
+    return CaptureSelectedRegionFrame(target.x, target.y, target.width, target.height, frame);
+  }
+  return CaptureWindowFrame(target.hwnd, frame);
+}
+
+// 把变化检测的结论写进回复：dirtyTiles / totalTiles / changed，以及补丁位置或 keyframe；
+// 补丁靠 alpha 标出覆盖范围，JPEG 改为 PNG
+static void WriteChangeDecision(const capture_core::ChangeDecision& change,
+                                flutter::EncodableMap* map,
+                                capture_core::EncodeOptions* options) {
+  (*map)[flutter::EncodableValue("dirtyTiles")] =
+      flutter::EncodableValue(static_cast<int64_t>(change.dirty_tiles));
+  (*map)[flutter::EncodableValue("totalTiles")] =
+      flutter::EncodableValue(static_cast<int64_t>(change.total_tiles));
+  if (change.action == capture_core::ChangeAction::kUnchanged) {
+    (*map)[flutter::EncodableValue("changed")] = flutter::EncodableValue(false);
+    return;
+  }
+  (*map)[flutter::EncodableValue("changed")] = flutter::EncodableValue(true);
+  if (change.action == capture_core::ChangeAction::kPatch) {
+    const capture_core::Rect& bounds = change.patch_bounds;
+    (*map)[flutter::EncodableValue("patchX")] = flutter::EncodableValue(bounds.x);
+    (*map)[flutter::EncodableValue("patchY")] = flutter::EncodableValue(bounds.y);
+    (*map)[flutter::EncodableValue("patchWidth")] = flutter::EncodableValue(bounds.width);
+    (*map)[flutter::EncodableValue("patchHeight")] = flutter::EncodableValue(bounds.height);
+    if (options->format == capture_core::ImageFormat::kJpeg) {
+      options->format = capture_core::ImageFormat::kPng;
+    }
+  } else {
+    (*map)[flutter::EncodableValue("keyframe")] = flutter::EncodableValue(true);
+  }
+}
+
+// 编码格式对应的扩展名（与 Dart 端 ImageFormat.extension 一致）
+static const char* ImageFormatExtension(capture_core::ImageFormat format) {
+  switch (format) {
+    case capture_core::ImageFormat::kJpeg:
+      return ".jpg";
+    case capture_core::ImageFormat::kQoi:
+      return ".qoi";
+    default:
+      return ".png";
+  }
+}
+
+void FlutterWindow::OnEncodeComplete(capture_core::EncodeResult encoded,
+                                     const std::string& save_path) {
+  std::string status = "failed";
+  bool saved = false;
+  if (encoded.status == capture_core::EncodeStatus::kOk) {
+    status = "ok";
+    // 保存也留在编码线程，平台线程只负责转发结果
+    if (!save_path.empty()) {
+      saved = WriteBytesToFile(save_path, encoded.bytes);
+      if (!saved) {
+        LOG_FLUTTER_FMT("Failed to save encoded frame to %s", save_path.c_str());
+        status = "failed";
+      }
+    }
+  } else if (encoded.status == capture_core::EncodeStatus::kCancelled) {
+    status = "cancelled";
+  }
+
+  // std::function 需要可拷贝，编码结果用 shared_ptr 持有，避免拷贝整张 PNG
+  auto shared = std::make_shared<capture_core::EncodeResult>(std::move(encoded));
+  std::string path = saved ? save_path : std::string();
+  PostToPlatformThread([this, shared, status, path]() {
+    if (!screenshot_method_channel_) {
+      return;
+    }
+    flutter::EncodableMap args;
+    args[flutter::EncodableValue("handle")] =
+        flutter::EncodableValue(static_cast<int64_t>(shared->handle));
+    args[flutter::EncodableValue("status")] = flutter::EncodableValue(status);
+    if (status == "ok") {
+      args[flutter::EncodableValue("bytes")] = flutter::EncodableValue(std::move(shared->bytes));
+    }
+    if (!path.empty()) {
+      args[flutter::EncodableValue("path")] = flutter::EncodableValue(path);
+    }
+    screenshot_method_channel_->InvokeMethod("onEncodeComplete",
+        std::make_unique<flutter::EncodableValue>(args));
+  });
+}
+
+void FlutterWindow::OnTranscodeComplete(capture_core::TranscodeResult transcoded) {
+  const char* status = "failed";
+  if (transcoded.status == capture_core::TranscodeStatus::kOk) {
+    status = "ok";
+  } else if (transcoded.status == capture_core::TranscodeStatus::kCancelled) {
+    status = "cancelled";
+  } else {
+    LOG_FLUTTER_FMT("Failed to transcode %s", transcoded.source.c_str());
+  }
+
+  auto shared = std::make_shared<capture_core::TranscodeResult>(std::move(transcoded));
+  PostToPlatformThread([this, shared, status]() {
+    if (!screenshot_method_channel_) {
+      return;
+    }
+    flutter::EncodableMap args;
+    args[flutter::EncodableValue("source")] = flutter::EncodableValue(shared->source);
+    args[flutter::EncodableValue("target")] = flutter::EncodableValue(shared->target);
+    args[flutter::EncodableValue("status")] = flutter::EncodableValue(std::string(status));
+    screenshot_method_channel_->InvokeMethod("onTranscodeComplete",
+        std::make_unique<flutter::EncodableValue>(args));
+  });
+}
+
+// 一个原生调度的循环任务（startSchedule 的参数和过滤状态）
+struct FlutterWindow::ScheduledTask {
+  std::string task_id;
+  capture_core::ScheduleId schedule_id = 0;
+  CaptureTarget target;
+  // 文件写到 directory 下的 <file_prefix><毫秒时间戳>.<扩展名>
+  std::string directory;
+  std::string file_prefix;
+  capture_core::EncodeOptions options;
+  // 非空时按分块和上一次保存的整帧比较（ChangeTracker 的键）
+  std::string change_key;
+  bool tile_delta = false;
+  // 近似重复过滤的汉明距离阈值，负值表示不过滤
+  int dedup_distance = -1;
+  // 上一次保存的帧的感知哈希；同一计划同时只有一次触发在执行，
+  // 前后两次之间由 ScheduledShot::busy 的释放和获取保证可见性
+  bool has_kept_hash = false;
+  uint64_t kept_hash = 0;
+};
+
+// onScheduledShot 的公共字段
+static flutter::EncodableMap ScheduledShotEvent(const std::string& task_id,
+                                                const capture_core::ScheduledShot& shot) {
+  flutter::EncodableMap event;
+  event[flutter::EncodableValue("taskId")] = flutter::EncodableValue(task_id);
+  event[flutter::EncodableValue("scheduleId")] =
+      flutter::EncodableValue(static_cast<int64_t>(shot.schedule));
+  event[flutter::EncodableValue("index")] = flutter::EncodableValue(shot.index);
+  event[flutter::EncodableValue("missed")] = flutter::EncodableValue(shot.missed);
+  event[flutter::EncodableValue("last")] = flutter::EncodableValue(shot.last);
+  event[flutter::EncodableValue("latenessUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(shot.lateness.count()));
+  return event;
+}
+
+static const char* SkipReasonName(capture_core::SkipReason reason) {
+  switch (reason) {
+    case capture_core::SkipReason::kBusy:
+      return "busy";
+    case capture_core::SkipReason::kQueueFull:
+      return "queueFull";
+    default:
+      return "cancelled";
+  }
+}
+
+void FlutterWindow::RunScheduledShot(const std::shared_ptr<ScheduledTask>& task,
+                                     capture_core::ScheduledShot shot,
+                                     const capture_core::CancellationToken& token) {
+  if (shot.last) {
+    EndScheduledTask(task->task_id, shot.schedule);
+  }
+  flutter::EncodableMap event = ScheduledShotEvent(task->task_id, shot);
+  auto post_status = [&](const char* status) {
+    event[flutter::EncodableValue("status")] = flutter::EncodableValue(std::string(status));
+    PostScheduledShot(std::move(event));
+  };
+  if (token.cancelled()) {
+    event[flutter::EncodableValue("reason")] = flutter::EncodableValue(std::string("cancelled"));
+    post_status("skipped");
+    return;
+  }
+
+  capture_core::FrameBuffer frame = encode_queue_->AcquireFrame();
+  const int64_t capturedAt = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  if (!CaptureTargetFrame(task->target, &frame)) {
+    post_status("failed");
+    return;
+  }
+  event[flutter::EncodableValue("time")] = flutter::EncodableValue(capturedAt);
+  event[flutter::EncodableValue("width")] = flutter::EncodableValue(frame.width());
+  event[flutter::EncodableValue("height")] = flutter::EncodableValue(frame.height());
+  const uint64_t hash = capture_core::DifferenceHash(frame);
+  event[flutter::EncodableValue("perceptualHash")] =
+      flutter::EncodableValue(static_cast<int64_t>(hash));
+
+  // 近似重复在变化检测之前判断，被丢弃的帧不会成为参考帧
+  if (task->dedup_distance >= 0 && task->has_kept_hash &&
+      capture_core::HammingDistance(hash, task->kept_hash) <= task->dedup_distance) {
+    encode_queue_->ReleaseFrame(std::move(frame));
+    post_status("duplicate");
+    return;
+  }
+
+  capture_core::EncodeOptions options = task->options;
+  bool keyframe = false;
+  if (!task->change_key.empty()) {
+    const capture_core::ChangeDecision change =
+        change_tracker_.Process(task->change_key, task->tile_delta, &frame);
+    WriteChangeDecision(change, &event, &options);
+    if (change.action == capture_core::ChangeAction::kUnchanged) {
+      encode_queue_->ReleaseFrame(std::move(frame));
+      post_status("unchanged");
+      return;
+    }
+    keyframe = change.action == capture_core::ChangeAction::kFullFrame;
+  }
+
+  const std::string path = task->directory + "\\" + task->file_prefix +
+                           std::to_string(capturedAt) + ImageFormatExtension(options.format);
+  // 编码线程写完文件才释放 busy：写盘跟不上时后面的触发被跳过，而不是越积越多
+  auto done = [this, task, event, path, keyframe, hash, busy = shot.busy](
+                  capture_core::EncodeResult encoded) mutable {
+    const bool saved = encoded.status == capture_core::EncodeStatus::kOk &&
+                       WriteBytesToFile(path, encoded.bytes);
+    if (saved) {
+      event[flutter::EncodableValue("status")] = flutter::EncodableValue(std::string("saved"));
+      event[flutter::EncodableValue("path")] = flutter::EncodableValue(path);
+      // 只有真正保存下来的帧才作为之后近似重复的参照（在释放 busy 之前写入）
+      if (task->dedup_distance >= 0) {
+        task->kept_hash = hash;
+        task->has_kept_hash = true;
+      }
+    } else {
+      LOG_FLUTTER_FMT("Scheduled capture was not saved to %s", path.c_str());
+      event[flutter::EncodableValue("status")] = flutter::EncodableValue(std::string("failed"));
+      if (keyframe) {
+        // 参考帧没写成功，之后的补丁没有可依附的整帧
+        change_tracker_.Forget(task->change_key);
+      }
+    }
+    busy.reset();
+    PostScheduledShot(std::move(event));
+  };
+  if (encode_queue_->Submit(std::move(frame), done, options) == 0) {
+    LOG_FLUTTER("Encode queue is full, skipping scheduled capture");
+    if (!task->change_key.empty()) {
+      change_tracker_.Forget(task->change_key);
+    }
+    event[flutter::EncodableValue("reason")] = flutter::EncodableValue(std::string("queueFull"));
+    post_status("skipped");
+  }
+}
+
+void FlutterWindow::PostScheduledShot(flutter::EncodableMap event) {
+  PostToPlatformThread([this, event = std::move(event)]() {
+    if (!screenshot_method_channel_) {
+      return;
+    }
+    screenshot_method_channel_->InvokeMethod("onScheduledShot",
+        std::make_unique<flutter::EncodableValue>(event));
+  });
+}
+
+void FlutterWindow::EndScheduledTask(const std::string& task_id, capture_core::ScheduleId id) {
+  std::lock_guard<std::mutex> lock(scheduled_tasks_mutex_);
+  auto it = scheduled_tasks_.find(task_id);
+  if (it == scheduled_tasks_.end() || it->second->schedule_id != id) {
+    return;
+  }
+  scheduled_tasks_.erase(it);
+  UpdateTimerResolution();
+}
+
+void FlutterWindow::UpdateTimerResolution() {
+  const bool wanted = !scheduled_tasks_.empty() || recording_;
+  if (wanted == timer_period_raised_) {
+    return;
+  }
+  if (wanted) {
+    timeBeginPeriod(1);
+  } else {
+    timeEndPeriod(1);
+  }
+  timer_period_raised_ = wanted;
+}
+
+void FlutterWindow::SaveInstantReplayFromHotkey() {
+  std::shared_ptr<capture_core::InstantReplay> replay = instant_replay_;
+  const capture_core::AnimationFormat format = replay_format_;
+  const std::string path = ReplayFilePath(replay_directory_, format);
+  auto run = [this, replay, format, path](const capture_core::CancellationToken&) {
+    capture_core::ReplayExport exported;
+    const bool ok = replay->Save(format, path, &exported);
+    if (!ok) {
+      LOG_FLUTTER_FMT("Failed to save instant replay to %s", path.c_str());
+    }
+    flutter::EncodableMap event = ReplayExportToEncodable(path, format, exported);
+    event[flutter::EncodableValue("ok")] = flutter::EncodableValue(ok);
+    PostToPlatformThread([this, event = std::move(event)]() {
+      if (screenshot_method_channel_) {
+        screenshot_method_channel_->InvokeMethod(
+            "onReplaySaved", std::make_unique<flutter::EncodableValue>(event));
+      }
+    });
+  };
+  if (!capture_jobs_ || capture_jobs_->Submit(run, []() {}) == 0) {
+    LOG_FLUTTER("Capture queue is full, instant replay not saved");
+  }
+}
+
+void FlutterWindow::SubmitCaptureJob(
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+    std::function<flutter::EncodableValue(const capture_core::CancellationToken&)> work) {
+  // std::function 需要可拷贝，MethodResult 用 shared_ptr 持有
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(
+      std::move(result));
+
+  auto run = [this, shared_result, work](const capture_core::CancellationToken& token) {
+    flutter::EncodableValue value = work(token);
+    bool cancelled = token.cancelled();
+    PostToPlatformThread([shared_result, cancelled, value = std::move(value)]() {
+      if (cancelled) {
+        shared_result->Error("CANCELLED", "Capture request was cancelled");
+      } else {
+        shared_result->Success(value);
+      }
+    });
+  };
+  auto on_cancelled = [this, shared_result]() {
+    PostToPlatformThread([shared_result]() {
+      shared_result->Error("CANCELLED", "Capture request was cancelled");
+    });
+  };
+
+  if (!capture_jobs_ || capture_jobs_->Submit(run, on_cancelled) == 0) {
+    LOG_FLUTTER("Capture queue is full, rejecting request");
+    shared_result->Error("BUSY", "Too many pending capture requests");
+  }
+}
+
 void FlutterWindow::HandleScreenshotMethodCall(
     const flutter::MethodCall<flutter::EncodableValue>& call,
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
   const auto& method = call.method_name();
+  // 所有截图方法都接受 format / quality，编码在工作线程按设置选择 PNG 或 JPEG
+  const capture_core::EncodeOptions encodeOptions = ReadEncodeOptions(call.arguments());
+  // 有截图活动时推迟后台的 QOI -> PNG 转码
+  if (transcoder_ && method != "transcodeWhenIdle") {
+    transcoder_->NotifyActivity();
+  }
 
+  // 捕获、编码和窗口枚举都可能耗时数百毫秒（CaptureWindow 的兜底路径还会 Sleep），
+  // 在工作线程执行，避免阻塞 UI 线程；参数在平台线程上解析
   if (method == "captureFullScreen") {
-    try {
-      std::vector<uint8_t> imageData = CaptureFullScreen();
-
-      // Convert to Flutter byte data
-      flutter::EncodableList dataList(imageData.begin(), imageData.end());
-      result->Success(flutter::EncodableValue(dataList));
-    } catch (const std::exception& e) {
-      result->Error("CAPTURE_ERROR", e.what());
-    }
+    SubmitCaptureJob(std::move(result), [encodeOptions](const capture_core::CancellationToken&) {
+      // std::vector<uint8_t> 按 Uint8List 编码（整块拷贝），不要转成 EncodableList
+      return flutter::EncodableValue(CaptureFullScreen(encodeOptions));
+    });
   } else if (method == "captureRegion") {
     try {
       const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
@@ -342,13 +1023,44 @@ void FlutterWindow::HandleScreenshotMethodCall(
       int width = std::get<int>(width_it->second);
       int height = std::get<int>(height_it->second);
 
-      std::vector<uint8_t> imageData = CaptureRegion(x, y, width, height);
-
-      flutter::EncodableList dataList(imageData.begin(), imageData.end());
-      result->Success(flutter::EncodableValue(dataList));
+      SubmitCaptureJob(std::move(result), [x, y, width, height, encodeOptions](
+                                              const capture_core::CancellationToken&) {
+        return flutter::EncodableValue(CaptureRegion(x, y, width, height, encodeOptions));
+      });
     } catch (const std::exception& e) {
       result->Error("CAPTURE_ERROR", e.what());
     }
+  } else if (method == "captureSelectedRegion") {
+    // 参数与 captureRegion 相同；优先从选择蒙版的冻结帧裁剪
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+
+    auto x_it = arguments->find(flutter::EncodableValue("x"));
+    auto y_it = arguments->find(flutter::EncodableValue("y"));
+    auto width_it = arguments->find(flutter::EncodableValue("width"));
+    auto height_it = arguments->find(flutter::EncodableValue("height"));
+    if (x_it == arguments->end() || y_it == arguments->end() ||
+        width_it == arguments->end() || height_it == arguments->end()) {
+      result->Error("INVALID_ARGUMENTS", "Missing required parameters");
+      return;
+    }
+
+    const auto* x = std::get_if<int>(&x_it->second);
+    const auto* y = std::get_if<int>(&y_it->second);
+    const auto* width = std::get_if<int>(&width_it->second);
+    const auto* height = std::get_if<int>(&height_it->second);
+    if (!x || !y || !width || !height) {
+      result->Error("INVALID_ARGUMENTS", "Invalid region type, expected int");
+      return;
+    }
+
+    SubmitCaptureJob(std::move(result), [x = *x, y = *y, width = *width, height = *height,
+                                         encodeOptions](const capture_core::CancellationToken&) {
+      return flutter::EncodableValue(CaptureSelectedRegion(x, y, width, height, encodeOptions));
+    });
   } else if (method == "captureWindow") {
     try {
       const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
@@ -366,15 +1078,71 @@ void FlutterWindow::HandleScreenshotMethodCall(
       std::string windowId = std::get<std::string>(windowId_it->second);
       HWND hwnd = HwndFromString(windowId);
 
-      std::vector<uint8_t> imageData = CaptureWindow(hwnd);
-
-      flutter::EncodableList dataList(imageData.begin(), imageData.end());
-      result->Success(flutter::EncodableValue(dataList));
+      SubmitCaptureJob(std::move(result), [hwnd, encodeOptions](
+                                              const capture_core::CancellationToken&) {
+        return flutter::EncodableValue(CaptureWindow(hwnd, encodeOptions));
+      });
     } catch (const std::exception& e) {
       result->Error("CAPTURE_ERROR", e.what());
     }
+  } else if (method == "captureWindows") {
+    // 一次调用截取多个窗口（窗口选择器的缩略图），在线程池上并行截取、缩小和编码。
+    // 回复与 windowIds 顺序相同的列表，截取失败的窗口对应 null
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    auto ids_it = arguments->find(flutter::EncodableValue("windowIds"));
+    const auto* ids = ids_it == arguments->end()
+                          ? nullptr
+                          : std::get_if<flutter::EncodableList>(&ids_it->second);
+    if (!ids) {
+      result->Error("INVALID_ARGUMENTS", "Missing windowIds parameter");
+      return;
+    }
+    std::vector<std::string> windowIds;
+    std::vector<HWND> hwnds;
+    for (const auto& value : *ids) {
+      const auto* id = std::get_if<std::string>(&value);
+      if (!id) {
+        result->Error("INVALID_ARGUMENTS", "Invalid windowIds type, expected strings");
+        return;
+      }
+      windowIds.push_back(*id);
+      hwnds.push_back(HwndFromString(*id));
+    }
+    int64_t maxSize = 0;
+    ReadIntArgument(*arguments, "maxSize", &maxSize);
+    maxSize = std::clamp<int64_t>(maxSize, 0, 16384);
+
+    SubmitCaptureJob(std::move(result), [windowIds = std::move(windowIds),
+                                         hwnds = std::move(hwnds), maxSize, encodeOptions](
+                                             const capture_core::CancellationToken&) {
+      std::vector<capture_core::BatchCaptureItem> items =
+          CaptureWindows(hwnds, static_cast<int>(maxSize), encodeOptions);
+
+      flutter::EncodableList list;
+      for (size_t i = 0; i < items.size(); i++) {
+        capture_core::BatchCaptureItem& item = items[i];
+        if (!item.ok) {
+          list.push_back(flutter::EncodableValue());
+          continue;
+        }
+        flutter::EncodableMap entry;
+        entry[flutter::EncodableValue("id")] = flutter::EncodableValue(windowIds[i]);
+        entry[flutter::EncodableValue("width")] = flutter::EncodableValue(item.width);
+        entry[flutter::EncodableValue("height")] = flutter::EncodableValue(item.height);
+        entry[flutter::EncodableValue("sourceWidth")] = flutter::EncodableValue(item.source_width);
+        entry[flutter::EncodableValue("sourceHeight")] =
+            flutter::EncodableValue(item.source_height);
+        entry[flutter::EncodableValue("bytes")] = flutter::EncodableValue(std::move(item.bytes));
+        list.push_back(flutter::EncodableValue(std::move(entry)));
+      }
+      return flutter::EncodableValue(list);
+    });
   } else if (method == "getAvailableWindows") {
-    try {
+    SubmitCaptureJob(std::move(result), [](const capture_core::CancellationToken&) {
       std::vector<WindowInfo> windows = EnumerateWindows();
 
       flutter::EncodableList windowList;
@@ -390,17 +1158,659 @@ void FlutterWindow::HandleScreenshotMethodCall(
 
         // Add icon if available
         if (!window.icon.empty()) {
-          flutter::EncodableList iconData(window.icon.begin(), window.icon.end());
-          windowMap[flutter::EncodableValue("icon")] = flutter::EncodableValue(iconData);
+          windowMap[flutter::EncodableValue("icon")] = flutter::EncodableValue(window.icon);
         }
 
         windowList.push_back(flutter::EncodableValue(windowMap));
       }
 
-      result->Success(flutter::EncodableValue(windowList));
-    } catch (const std::exception& e) {
-      result->Error("ENUM_ERROR", e.what());
+      return flutter::EncodableValue(windowList);
+    });
+  } else if (method == "startWindowTracking") {
+    // 回复初始列表；之后的变化通过 onWindowsChanged 推送
+    if (window_tracker_ && window_tracker_->running()) {
+      result->Success(
+          flutter::EncodableValue(WindowRecordsToEncodable(window_tracker_->Snapshot())));
+      return;
+    }
+    if (!window_tracker_) {
+      window_tracker_ = std::make_unique<WindowTracker>();
+    }
+    std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(
+        std::move(result));
+    window_tracker_->Start(
+        [this, shared_result](std::vector<capture_core::WindowRecord> windows) {
+          flutter::EncodableList list = WindowRecordsToEncodable(windows);
+          PostToPlatformThread([shared_result, list = std::move(list)]() {
+            shared_result->Success(flutter::EncodableValue(list));
+          });
+        },
+        [this](const capture_core::WindowListDiff& diff) {
+          flutter::EncodableList removed;
+          for (uint64_t id : diff.removed) {
+            removed.push_back(flutter::EncodableValue(WindowTracker::FormatId(id)));
+          }
+          flutter::EncodableMap event;
+          event[flutter::EncodableValue("added")] =
+              flutter::EncodableValue(WindowRecordsToEncodable(diff.added));
+          event[flutter::EncodableValue("updated")] =
+              flutter::EncodableValue(WindowRecordsToEncodable(diff.updated));
+          event[flutter::EncodableValue("removed")] = flutter::EncodableValue(removed);
+          PostToPlatformThread([this, event = std::move(event)]() {
+            if (screenshot_method_channel_) {
+              screenshot_method_channel_->InvokeMethod(
+                  "onWindowsChanged", std::make_unique<flutter::EncodableValue>(event));
+            }
+          });
+        });
+  } else if (method == "stopWindowTracking") {
+    if (window_tracker_) {
+      window_tracker_->Stop();
+    }
+    result->Success();
+  } else if (method == "getMonitors") {
+    SubmitCaptureJob(std::move(result), [](const capture_core::CancellationToken&) {
+      return flutter::EncodableValue(MonitorListToEncodable(EnumerateMonitors()));
+    });
+  } else if (method == "captureVirtualDesktop") {
+    // 所有显示器拼接成一张图；失败时返回 null
+    SubmitCaptureJob(std::move(result), [encodeOptions](const capture_core::CancellationToken&) {
+      capture_core::Rect bounds;
+      std::vector<capture_core::MonitorInfo> monitors;
+      std::vector<uint8_t> image = CaptureVirtualDesktop(&bounds, &monitors, encodeOptions);
+      if (image.empty()) {
+        return flutter::EncodableValue();
+      }
+
+      flutter::EncodableMap map;
+      map[flutter::EncodableValue("bytes")] = flutter::EncodableValue(std::move(image));
+      map[flutter::EncodableValue("x")] = flutter::EncodableValue(bounds.x);
+      map[flutter::EncodableValue("y")] = flutter::EncodableValue(bounds.y);
+      map[flutter::EncodableValue("width")] = flutter::EncodableValue(bounds.width);
+      map[flutter::EncodableValue("height")] = flutter::EncodableValue(bounds.height);
+      map[flutter::EncodableValue("monitors")] =
+          flutter::EncodableValue(MonitorListToEncodable(monitors));
+      return flutter::EncodableValue(map);
+    });
+  } else if (method == "captureMonitors") {
+    // 每个显示器一张图，顺序与 getMonitors 相同；失败时返回 null
+    SubmitCaptureJob(std::move(result), [encodeOptions](const capture_core::CancellationToken&) {
+      std::vector<capture_core::MonitorInfo> monitors;
+      std::vector<std::vector<uint8_t>> images = CaptureMonitors(&monitors, encodeOptions);
+      if (images.empty() || images.size() != monitors.size()) {
+        return flutter::EncodableValue();
+      }
+
+      flutter::EncodableList list;
+      for (size_t i = 0; i < monitors.size(); i++) {
+        flutter::EncodableMap entry = MonitorToEncodable(monitors[i]);
+        entry[flutter::EncodableValue("bytes")] = flutter::EncodableValue(std::move(images[i]));
+        list.push_back(flutter::EncodableValue(std::move(entry)));
+      }
+      return flutter::EncodableValue(list);
+    });
+  } else if (method == "beginCapture") {
+    // 两阶段截图：像素进入内存后立即回复 {handle, width, height}，
+    // 编码和保存在后台完成，结果通过 onEncodeComplete 推送
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    CaptureTarget target;
+    if (const char* error = ReadCaptureTarget(*arguments, &target)) {
+      result->Error("INVALID_ARGUMENTS", error);
+      return;
+    }
+
+    const std::string savePath = ReadStringArgument(*arguments, "savePath");
+    // deferEncode：帧先暂存不编码，预览走纹理，用户保存时再调用 encodeFrame
+    const bool deferEncode = ReadBoolArgument(*arguments, "deferEncode");
+    // changeKey：循环任务 id，和同一任务上一次保存的帧按分块比较，未变化时不编码；
+    // tileDelta：变化不大时只保存脏分块补丁（带 alpha，JPEG 改为 PNG）
+    const std::string changeKey = ReadStringArgument(*arguments, "changeKey");
+    const bool tileDelta = ReadBoolArgument(*arguments, "tileDelta");
+
+    SubmitCaptureJob(std::move(result), [this, target, savePath, deferEncode, encodeOptions,
+                                         changeKey, tileDelta](
+                                             const capture_core::CancellationToken& token) {
+      // 借用上一帧留下的缓冲，连续截图时不再分配整帧内存
+      capture_core::FrameBuffer frame = encode_queue_->AcquireFrame();
+      if (!CaptureTargetFrame(target, &frame)) {
+        return flutter::EncodableValue();
+      }
+
+      flutter::EncodableMap map;
+      map[flutter::EncodableValue("width")] = flutter::EncodableValue(frame.width());
+      map[flutter::EncodableValue("height")] = flutter::EncodableValue(frame.height());
+      // 整帧的感知哈希，Dart 端用于近似重复过滤和相似截图查找
+      map[flutter::EncodableValue("perceptualHash")] = flutter::EncodableValue(
+          static_cast<int64_t>(capture_core::DifferenceHash(frame)));
+
+      // 截图期间收到 cancelPendingCaptures：回复 CANCELLED 时 Dart 拿不到 handle，
+      // 不再推进参考帧，也不再提交或暂存（暂存的帧没有 handle 就永远不会释放）
+      if (token.cancelled()) {
+        return flutter::EncodableValue();
+      }
+
+      capture_core::EncodeOptions options = encodeOptions;
+      if (!changeKey.empty()) {
+        const capture_core::ChangeDecision change =
+            change_tracker_.Process(changeKey, tileDelta, &frame);
+        WriteChangeDecision(change, &map, &options);
+        if (change.action == capture_core::ChangeAction::kUnchanged) {
+          // 画面没有变化：不编码也不保存
+          return flutter::EncodableValue(map);
+        }
+      }
+
+      auto done = [this, savePath](capture_core::EncodeResult encoded) {
+        OnEncodeComplete(std::move(encoded), savePath);
+      };
+      capture_core::FrameHandle handle =
+          deferEncode ? encode_queue_->Hold(std::move(frame), done, options)
+                      : encode_queue_->Submit(std::move(frame), done, options);
+      if (handle == 0) {
+        LOG_FLUTTER("Encode queue is full, dropping frame");
+        if (!changeKey.empty()) {
+          // 丢掉的可能是新的参考帧，之后的补丁会没有可依附的整帧
+          change_tracker_.Forget(changeKey);
+        }
+        return flutter::EncodableValue();
+      }
+      if (token.cancelled()) {
+        // 提交或暂存之后才取消：回复同样是 CANCELLED，这里取消编码、释放暂存的帧，
+        // 参考帧也已推进到 Dart 看不到的这一帧
+        encode_queue_->Cancel(handle);
+        if (!changeKey.empty()) {
+          change_tracker_.Forget(changeKey);
+        }
+        return flutter::EncodableValue();
+      }
+
+      map[flutter::EncodableValue("handle")] =
+          flutter::EncodableValue(static_cast<int64_t>(handle));
+      return flutter::EncodableValue(map);
+    });
+  } else if (method == "getFramePreview") {
+    // 编码完成前的原始帧，转成 RGBA（长边不超过 maxDimension）；已编码完时返回 null
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    int64_t handle = 0;
+    if (!arguments || !ReadIntArgument(*arguments, "handle", &handle)) {
+      result->Error("INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    int64_t maxDimension = kDefaultPreviewDimension;
+    ReadIntArgument(*arguments, "maxDimension", &maxDimension);
+
+    SubmitCaptureJob(std::move(result), [this, handle, maxDimension](
+                                            const capture_core::CancellationToken&) {
+      std::shared_ptr<const capture_core::FrameBuffer> frame =
+          encode_queue_->Peek(static_cast<capture_core::FrameHandle>(handle));
+      if (!frame) {
+        return flutter::EncodableValue();
+      }
+      capture_core::FrameBuffer preview;
+      capture_core::ConvertFramePreview(*frame, static_cast<int>(maxDimension), &preview);
+
+      flutter::EncodableMap map;
+      map[flutter::EncodableValue("width")] = flutter::EncodableValue(preview.width());
+      map[flutter::EncodableValue("height")] = flutter::EncodableValue(preview.height());
+      map[flutter::EncodableValue("pixels")] = flutter::EncodableValue(
+          std::vector<uint8_t>(preview.data(), preview.data() + preview.size_bytes()));
+      return flutter::EncodableValue(map);
+    });
+  } else if (method == "createFrameTexture") {
+    // 把原始帧转成 RGBA 注册为外部纹理，Dart 端用 Texture 直接显示；
+    // maxDimension 为 0 时保持原尺寸。帧已编码完时返回 null
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    int64_t handle = 0;
+    if (!arguments || !ReadIntArgument(*arguments, "handle", &handle)) {
+      result->Error("INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    int64_t maxDimension = 0;
+    ReadIntArgument(*arguments, "maxDimension", &maxDimension);
+
+    SubmitCaptureJob(std::move(result), [this, handle, maxDimension](
+                                            const capture_core::CancellationToken&) {
+      std::shared_ptr<const capture_core::FrameBuffer> frame =
+          encode_queue_->Peek(static_cast<capture_core::FrameHandle>(handle));
+      if (!frame || !frame_textures_) {
+        return flutter::EncodableValue();
+      }
+      capture_core::FrameBuffer rgba;
+      capture_core::ConvertFramePreview(*frame, static_cast<int>(maxDimension), &rgba);
+      frame.reset();
+
+      const int textureWidth = rgba.width();
+      const int textureHeight = rgba.height();
+      int64_t textureId = frame_textures_->Register(std::move(rgba));
+      if (textureId < 0) {
+        return flutter::EncodableValue();
+      }
+      flutter::EncodableMap map;
+      map[flutter::EncodableValue("textureId")] = flutter::EncodableValue(textureId);
+      map[flutter::EncodableValue("width")] = flutter::EncodableValue(textureWidth);
+      map[flutter::EncodableValue("height")] = flutter::EncodableValue(textureHeight);
+      return flutter::EncodableValue(map);
+    });
+  } else if (method == "disposeFrameTexture") {
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    int64_t textureId = 0;
+    if (!arguments || !ReadIntArgument(*arguments, "textureId", &textureId)) {
+      result->Error("INVALID_ARGUMENTS", "Missing textureId parameter");
+      return;
+    }
+    bool disposed = frame_textures_ && frame_textures_->Unregister(textureId);
+    result->Success(flutter::EncodableValue(disposed));
+  } else if (method == "encodeFrame") {
+    // 开始编码 deferEncode 暂存的帧，结果照常通过 onEncodeComplete 推送
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    int64_t handle = 0;
+    if (!arguments || !ReadIntArgument(*arguments, "handle", &handle)) {
+      result->Error("INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    bool started = encode_queue_ &&
+                   encode_queue_->Encode(static_cast<capture_core::FrameHandle>(handle));
+    result->Success(flutter::EncodableValue(started));
+  } else if (method == "cancelEncode") {
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    int64_t handle = 0;
+    if (!arguments || !ReadIntArgument(*arguments, "handle", &handle)) {
+      result->Error("INVALID_ARGUMENTS", "Missing handle parameter");
+      return;
+    }
+    bool cancelled = encode_queue_ &&
+                     encode_queue_->Cancel(static_cast<capture_core::FrameHandle>(handle));
+    result->Success(flutter::EncodableValue(cancelled));
+  } else if (method == "cancelPendingCaptures") {
+    // 取消排队中的请求（回复 CANCELLED），正在执行的请求完成后也回复 CANCELLED；
+    // 两阶段截图尚未编码完的帧以 cancelled 状态通知
+    size_t cancelled = capture_jobs_ ? capture_jobs_->CancelAll() : 0;
+    cancelled += encode_queue_ ? encode_queue_->CancelAll() : 0;
+    result->Success(flutter::EncodableValue(static_cast<int>(cancelled)));
+  } else if (method == "transcodeWhenIdle") {
+    // 循环截图的 QOI 文件在空闲时转成 PNG，完成后通过 onTranscodeComplete 通知
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    const std::string* source = nullptr;
+    const std::string* target = nullptr;
+    if (arguments) {
+      auto source_it = arguments->find(flutter::EncodableValue("source"));
+      auto target_it = arguments->find(flutter::EncodableValue("target"));
+      if (source_it != arguments->end()) source = std::get_if<std::string>(&source_it->second);
+      if (target_it != arguments->end()) target = std::get_if<std::string>(&target_it->second);
+    }
+    if (!source || !target) {
+      result->Error("INVALID_ARGUMENTS", "Missing source or target parameter");
+      return;
+    }
+    auto done = [this](capture_core::TranscodeResult transcoded) {
+      OnTranscodeComplete(std::move(transcoded));
+    };
+    bool queued = transcoder_ && transcoder_->Enqueue(*source, *target, done);
+    result->Success(flutter::EncodableValue(queued));
+  } else if (method == "resetChangeDetection") {
+    // 丢弃循环任务的参考帧（任务删除或恢复时），下一次截图保存整帧
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    const std::string* changeKey = nullptr;
+    if (arguments) {
+      auto key_it = arguments->find(flutter::EncodableValue("changeKey"));
+      if (key_it != arguments->end()) changeKey = std::get_if<std::string>(&key_it->second);
+    }
+    if (!changeKey) {
+      result->Error("INVALID_ARGUMENTS", "Missing changeKey parameter");
+      return;
+    }
+    change_tracker_.Forget(*changeKey);
+    result->Success();
+  } else if (method == "startSchedule") {
+    // 循环截图交给原生调度器：按 intervalMs 的固定节拍截图、编码、写文件，
+    // 每次触发（包括跳过）通过 onScheduledShot 推送；回复计划 id，同一 taskId 的旧计划被替换
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    auto task = std::make_shared<ScheduledTask>();
+    task->task_id = ReadStringArgument(*arguments, "taskId");
+    task->directory = ReadStringArgument(*arguments, "directory");
+    if (task->task_id.empty() || task->directory.empty()) {
+      result->Error("INVALID_ARGUMENTS", "Missing taskId or directory parameter");
+      return;
     }
+    if (const char* error = ReadCaptureTarget(*arguments, &task->target)) {
+      result->Error("INVALID_ARGUMENTS", error);
+      return;
+    }
+    capture_core::CaptureScheduler::Options options;
+    int64_t intervalMs = 0, totalShots = 0, firstDelayMs = -1, dedupDistance = -1;
+    if (!ReadIntArgument(*arguments, "intervalMs", &intervalMs) || intervalMs <= 0) {
+      result->Error("INVALID_ARGUMENTS", "Invalid intervalMs");
+      return;
+    }
+    ReadIntArgument(*arguments, "totalShots", &totalShots);
+    ReadIntArgument(*arguments, "firstDelayMs", &firstDelayMs);
+    ReadIntArgument(*arguments, "dedupDistance", &dedupDistance);
+    options.interval = std::chrono::milliseconds(intervalMs);
+    options.total_shots = totalShots > 0 ? totalShots : 0;
+    options.first_delay = std::chrono::milliseconds(firstDelayMs);
+    task->file_prefix = ReadStringArgument(*arguments, "filePrefix");
+    task->options = encodeOptions;
+    task->change_key = ReadStringArgument(*arguments, "changeKey");
+    task->tile_delta = ReadBoolArgument(*arguments, "tileDelta");
+    task->dedup_distance = static_cast<int>(std::clamp<int64_t>(dedupDistance, -1, 64));
+
+    std::shared_ptr<ScheduledTask> replaced;
+    capture_core::ScheduleId id = 0;
+    {
+      // 持有锁直到登记完成：第一次触发可能立即就是最后一次，EndScheduledTask 要能看到登记
+      std::lock_guard<std::mutex> lock(scheduled_tasks_mutex_);
+      auto it = scheduled_tasks_.find(task->task_id);
+      if (it != scheduled_tasks_.end()) {
+        replaced = it->second;
+        scheduled_tasks_.erase(it);
+      }
+      if (scheduler_) {
+        id = scheduler_->Start(
+            options,
+            [this, task](capture_core::ScheduledShot shot,
+                         const capture_core::CancellationToken& token) {
+              RunScheduledShot(task, std::move(shot), token);
+            },
+            [this, task](const capture_core::ScheduledShot& shot,
+                         capture_core::SkipReason reason) {
+              if (shot.last) {
+                EndScheduledTask(task->task_id, shot.schedule);
+              }
+              flutter::EncodableMap event = ScheduledShotEvent(task->task_id, shot);
+              event[flutter::EncodableValue("status")] =
+                  flutter::EncodableValue(std::string("skipped"));
+              event[flutter::EncodableValue("reason")] =
+                  flutter::EncodableValue(std::string(SkipReasonName(reason)));
+              PostScheduledShot(std::move(event));
+            });
+      }
+      if (id != 0) {
+        task->schedule_id = id;
+        scheduled_tasks_[task->task_id] = task;
+      }
+      UpdateTimerResolution();
+    }
+    // Stop 会同步取消排队中的触发，回调里要拿 scheduled_tasks_mutex_，必须在锁外调用
+    if (replaced) {
+      scheduler_->Stop(replaced->schedule_id);
+    }
+    if (id == 0) {
+      result->Error("SCHEDULE_ERROR", "Failed to start schedule");
+      return;
+    }
+    result->Success(flutter::EncodableValue(static_cast<int64_t>(id)));
+  } else if (method == "stopSchedule") {
+    // 停止循环任务的原生计划；排队中的触发取消，正在写的文件照常完成
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    const std::string taskId = arguments ? ReadStringArgument(*arguments, "taskId") : std::string();
+    if (taskId.empty()) {
+      result->Error("INVALID_ARGUMENTS", "Missing taskId parameter");
+      return;
+    }
+    std::shared_ptr<ScheduledTask> task;
+    {
+      std::lock_guard<std::mutex> lock(scheduled_tasks_mutex_);
+      auto it = scheduled_tasks_.find(taskId);
+      if (it != scheduled_tasks_.end()) {
+        task = it->second;
+        scheduled_tasks_.erase(it);
+        UpdateTimerResolution();
+      }
+    }
+    const bool stopped = task && scheduler_ && scheduler_->Stop(task->schedule_id);
+    result->Success(flutter::EncodableValue(stopped));
+  } else if (method == "captureScrolling") {
+    // 长截图：在 mode 指定的区域或窗口中央发送 wheelSteps 格滚轮，每次等待 settleMs 后截图
+    // 拼接，直到页面到底、找不到重叠或达到 maxFrames / maxHeight；PNG 边拼边写进 path。
+    // 整个过程在截图工作线程完成，回复 path / width / height / frames / bytes，失败时回复 null
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    CaptureTarget target;
+    if (const char* error = ReadCaptureTarget(*arguments, &target)) {
+      result->Error("INVALID_ARGUMENTS", error);
+      return;
+    }
+    const std::string path = ReadStringArgument(*arguments, "path");
+    if (path.empty()) {
+      result->Error("INVALID_ARGUMENTS", "Missing path parameter");
+      return;
+    }
+    int64_t wheelSteps = 5, maxFrames = 100, maxHeight = 30000, settleMs = 120;
+    ReadIntArgument(*arguments, "wheelSteps", &wheelSteps);
+    ReadIntArgument(*arguments, "maxFrames", &maxFrames);
+    ReadIntArgument(*arguments, "maxHeight", &maxHeight);
+    ReadIntArgument(*arguments, "settleMs", &settleMs);
+    capture_core::ScrollCaptureOptions options;
+    options.max_frames = static_cast<int>(std::clamp<int64_t>(maxFrames, 1, 1000));
+    options.max_height = static_cast<int>(std::clamp<int64_t>(maxHeight, 1, 200000));
+    options.settle = std::chrono::milliseconds(std::clamp<int64_t>(settleMs, 0, 2000));
+    const int wheel = static_cast<int>(std::clamp<int64_t>(wheelSteps, 1, 20));
+    // 滚动时画面在变，选择区域时冻结的整屏画面不再需要
+    FrozenFrameStore::Shared().Clear();
+    SubmitCaptureJob(std::move(result),
+                     [target, path, options, wheel](
+                         const capture_core::CancellationToken& token) -> flutter::EncodableValue {
+      std::unique_ptr<capture_core::FrameSource> source;
+      capture_core::Rect region;
+      if (target.mode == "window") {
+        auto window = std::make_unique<GdiWindowSource>(target.hwnd);
+        region = window->GetBounds();
+        source = std::move(window);
+      } else {
+        auto screen = std::make_unique<GdiScreenSource>();
+        region = target.mode == "fullScreen"
+                     ? screen->GetPrimaryBounds()
+                     : capture_core::Rect(target.x, target.y, target.width, target.height);
+        source = std::move(screen);
+      }
+      if (region.empty()) {
+        return flutter::EncodableValue();
+      }
+
+      // 滚轮消息发给光标下的窗口：滚动前把光标移到区域中央，结束后放回原处
+      POINT cursor;
+      const BOOL restoreCursor = GetCursorPos(&cursor);
+      const int centerX = region.x + region.width / 2;
+      const int centerY = region.y + region.height / 2;
+      auto scroll = [centerX, centerY, wheel]() {
+        SetCursorPos(centerX, centerY);
+        INPUT input = {};
+        input.type = INPUT_MOUSE;
+        input.mi.dwFlags = MOUSEEVENTF_WHEEL;
+        input.mi.mouseData = static_cast<DWORD>(-WHEEL_DELTA * wheel);
+        return SendInput(1, &input, sizeof(INPUT)) == 1;
+      };
+      capture_core::ScrollStitchStats stats;
+      // cancelPendingCaptures 时在下一次滚动前或等待重绘期间停下，回复 CANCELLED
+      const bool ok = capture_core::CaptureScrolling(source.get(), region, path, options, scroll,
+                                                     token, &stats);
+      if (restoreCursor) {
+        SetCursorPos(cursor.x, cursor.y);
+      }
+      if (!ok) {
+        return flutter::EncodableValue();
+      }
+      flutter::EncodableMap map;
+      map[flutter::EncodableValue("path")] = flutter::EncodableValue(path);
+      map[flutter::EncodableValue("width")] = flutter::EncodableValue(region.width);
+      map[flutter::EncodableValue("height")] = flutter::EncodableValue(stats.height);
+      map[flutter::EncodableValue("frames")] = flutter::EncodableValue(stats.frames);
+      map[flutter::EncodableValue("bytes")] =
+          flutter::EncodableValue(static_cast<int64_t>(stats.bytes));
+      return flutter::EncodableValue(map);
+    });
+  } else if (method == "startRecording") {
+    // 区域录屏：按 fps 采集 x/y/width/height（屏幕坐标），边录边把 GIF 或 APNG 写到 path
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    int64_t x = 0, y = 0, width = 0, height = 0, fps = 10;
+    if (!ReadIntArgument(*arguments, "x", &x) || !ReadIntArgument(*arguments, "y", &y) ||
+        !ReadIntArgument(*arguments, "width", &width) ||
+        !ReadIntArgument(*arguments, "height", &height) || width <= 0 || height <= 0) {
+      result->Error("INVALID_ARGUMENTS", "Invalid recording region");
+      return;
+    }
+    ReadIntArgument(*arguments, "fps", &fps);
+    capture_core::RecorderOptions options;
+    options.region = capture_core::Rect(static_cast<int>(x), static_cast<int>(y),
+                                        static_cast<int>(width), static_cast<int>(height));
+    options.fps = static_cast<int>(
+        std::clamp<int64_t>(fps, 1, capture_core::ScreenRecorder::kMaxFps));
+    options.format = ReadStringArgument(*arguments, "format") == "apng"
+                         ? capture_core::AnimationFormat::kApng
+                         : capture_core::AnimationFormat::kGif;
+    options.path = ReadStringArgument(*arguments, "path");
+    if (options.path.empty()) {
+      result->Error("INVALID_ARGUMENTS", "Missing path parameter");
+      return;
+    }
+    if (recorder_) {
+      result->Error("RECORDING_ACTIVE", "A recording is already in progress");
+      return;
+    }
+    // 录屏采集实时画面，选择区域时冻结的整屏画面不再需要
+    FrozenFrameStore::Shared().Clear();
+    auto recorder = std::make_unique<capture_core::ScreenRecorder>(
+        std::make_unique<GdiScreenSource>());
+    if (!recorder->Start(options)) {
+      result->Error("RECORDING_ERROR", "Failed to start recording");
+      return;
+    }
+    recorder_ = std::move(recorder);
+    {
+      std::lock_guard<std::mutex> lock(scheduled_tasks_mutex_);
+      recording_ = true;
+      UpdateTimerResolution();
+    }
+    result->Success(flutter::EncodableValue(true));
+  } else if (method == "stopRecording") {
+    // 停止录屏：写完缓冲中的帧、关闭文件在截图工作线程完成，回复录制统计；
+    // 没有在录屏或文件写入失败时回复 null
+    if (!recorder_) {
+      result->Success();
+      return;
+    }
+    // 不经过 SubmitCaptureJob：录制不能因为排队被拒绝或取消而丢失（析构 ScreenRecorder
+    // 会删除写了一半的文件）。提交成功之前 recorder_ 保持不变，BUSY 时仍在录制、可以再次停止；
+    // 排队中被 cancelPendingCaptures 或关闭窗口取消时在取消的线程上照常 Stop
+    std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result(
+        std::move(result));
+    std::shared_ptr<capture_core::ScreenRecorder> recorder = recorder_;
+    auto finish = [this, shared_result, recorder]() {
+      flutter::EncodableValue value = RecordingStatsToEncodable(recorder->Stop());
+      PostToPlatformThread([shared_result, value = std::move(value)]() {
+        shared_result->Success(value);
+      });
+    };
+    if (!capture_jobs_ ||
+        capture_jobs_->Submit([finish](const capture_core::CancellationToken&) { finish(); },
+                              finish) == 0) {
+      LOG_FLUTTER("Capture queue is full, recording continues");
+      shared_result->Error("BUSY", "Too many pending capture requests");
+      return;
+    }
+    recorder_.reset();
+    {
+      std::lock_guard<std::mutex> lock(scheduled_tasks_mutex_);
+      recording_ = false;
+      UpdateTimerResolution();
+    }
+  } else if (method == "startInstantReplay") {
+    // 即时回放：按 fps 持续采集 x/y/width/height（通常是一个显示器），只保留最近 seconds 秒，
+    // 压缩帧不超过 memoryLimitMb；saveReplay 热键把回放以 format 存到 directory。
+    // 已在运行时按新参数重新开始
+    const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments());
+    if (!arguments) {
+      result->Error("INVALID_ARGUMENTS", "Expected map of arguments");
+      return;
+    }
+    int64_t x = 0, y = 0, width = 0, height = 0, fps = 2, seconds = 30, memoryLimitMb = 64;
+    if (!ReadIntArgument(*arguments, "x", &x) || !ReadIntArgument(*arguments, "y", &y) ||
+        !ReadIntArgument(*arguments, "width", &width) ||
+        !ReadIntArgument(*arguments, "height", &height) || width <= 0 || height <= 0) {
+      result->Error("INVALID_ARGUMENTS", "Invalid replay region");
+      return;
+    }
+    ReadIntArgument(*arguments, "fps", &fps);
+    ReadIntArgument(*arguments, "seconds", &seconds);
+    ReadIntArgument(*arguments, "memoryLimitMb", &memoryLimitMb);
+    const std::string directory = ReadStringArgument(*arguments, "directory");
+    if (directory.empty()) {
+      result->Error("INVALID_ARGUMENTS", "Missing directory parameter");
+      return;
+    }
+    capture_core::ReplayOptions options;
+    options.region = capture_core::Rect(static_cast<int>(x), static_cast<int>(y),
+                                        static_cast<int>(width), static_cast<int>(height));
+    options.fps = static_cast<int>(
+        std::clamp<int64_t>(fps, 1, capture_core::InstantReplay::kMaxFps));
+    options.duration = std::chrono::seconds(std::clamp<int64_t>(seconds, 1, 600));
+    options.memory_limit = static_cast<size_t>(std::clamp<int64_t>(memoryLimitMb, 8, 2048)) << 20;
+
+    instant_replay_ = nullptr;
+    auto replay = std::make_shared<capture_core::InstantReplay>(
+        std::make_unique<GdiScreenSource>());
+    if (!replay->Start(options)) {
+      result->Error("REPLAY_ERROR", "Failed to start instant replay");
+      return;
+    }
+    instant_replay_ = std::move(replay);
+    replay_directory_ = directory;
+    replay_format_ = ReadStringArgument(*arguments, "format") == "gif"
+                         ? capture_core::AnimationFormat::kGif
+                         : capture_core::AnimationFormat::kApng;
+    result->Success(flutter::EncodableValue(true));
+  } else if (method == "stopInstantReplay") {
+    // 停止采集并释放缓冲；回复之前是否在运行
+    const bool running = instant_replay_ != nullptr;
+    instant_replay_ = nullptr;
+    result->Success(flutter::EncodableValue(running));
+  } else if (method == "saveInstantReplay") {
+    // 把最近的画面写到 path（缺省时写到 startInstantReplay 的目录），在截图工作线程完成；
+    // 没有在运行、还没有画面或写入失败时回复 null
+    if (!instant_replay_) {
+      result->Success();
+      return;
+    }
+    std::string path;
+    if (const auto* arguments = std::get_if<flutter::EncodableMap>(call.arguments())) {
+      path = ReadStringArgument(*arguments, "path");
+    }
+    if (path.empty()) {
+      path = ReplayFilePath(replay_directory_, replay_format_);
+    }
+    std::shared_ptr<capture_core::InstantReplay> replay = instant_replay_;
+    const capture_core::AnimationFormat format = replay_format_;
+    SubmitCaptureJob(std::move(result),
+                     [replay, format, path](
+                         const capture_core::CancellationToken&) -> flutter::EncodableValue {
+      capture_core::ReplayExport exported;
+      if (!replay->Save(format, path, &exported)) {
+        return flutter::EncodableValue();
+      }
+      return flutter::EncodableValue(ReplayExportToEncodable(path, format, exported));
+    });
+  } else if (method == "getInstantReplayStats") {
+    // 空闲开销的观测：采集线程的 CPU 时间、压缩帧和工作缓冲的内存；没有在运行时回复 null
+    if (!instant_replay_) {
+      result->Success();
+      return;
+    }
+    result->Success(flutter::EncodableValue(ReplayStatsToEncodable(instant_replay_->stats())));
   } else if (method == "showNativeRegionCapture") {
     LOG_FLUTTER("showNativeRegionCapture called");
 
@@ -588,6 +1998,13 @@ void FlutterWindow::HandleHotkeyMethodCall(
 void FlutterWindow::OnHotkeyPressed(const std::string& actionId) {
   LOG_FLUTTER_FMT("🔥 Hotkey pressed: %s", actionId.c_str());
 
+  // 即时回放的保存在原生端完成，不等 Dart 往返；结果通过 onReplaySaved 通知。
+  // 没有开启即时回放时照常交给 Dart（提示用户先开启）
+  if (actionId == kSaveReplayAction && instant_replay_) {
+    SaveInstantReplayFromHotkey();
+    return;
+  }
+
   // 只负责通知 Dart 层，不做任何截图处理
   // 所有截图逻辑（包括显示窗口）都在 Dart 层统一处理
   if (hotkey_method_channel_) {
@@ -779,33 +2196,21 @@ void FlutterWindow::HandleClipboardMethodCall(
     int rowSize = ((width * bitCount + 31) / 32) * 4; // 对齐到 4 字节
     int imageSize = rowSize * height;
 
-    // 创建字节缓冲区
-    std::vector<uint8_t> imageData;
-    imageData.reserve(sizeof(BITMAPINFOHEADER) + imageSize);
-
-    // 添加 BITMAPINFOHEADER
-    uint8_t* headerBytes = reinterpret_cast<uint8_t*>(&bih);
-    imageData.insert(imageData.end(), headerBytes, headerBytes + sizeof(BITMAPINFOHEADER));
+    // 创建字节缓冲区：BITMAPINFOHEADER + 自上而下的像素数据
+    std::vector<uint8_t> imageData(sizeof(BITMAPINFOHEADER) + imageSize);
+    memcpy(imageData.data(), &bih, sizeof(BITMAPINFOHEADER));
 
-    // 添加像素数据
-    uint8_t* pixels = reinterpret_cast<uint8_t*>(lpbi) + sizeof(BITMAPINFOHEADER);
-    if (bih.biHeight > 0) {
-      // 自下而上的 DIB, 需要翻转
-      for (int y = height - 1; y >= 0; y--) {
-        imageData.insert(imageData.end(), pixels + y * rowSize, pixels + (y + 1) * rowSize);
-      }
-    } else {
-      // 自上而下的 DIB
-      imageData.insert(imageData.end(), pixels, pixels + imageSize);
-    }
+    // 自下而上的 DIB 需要翻转，整块按行拷贝
+    const uint8_t* pixels = reinterpret_cast<const uint8_t*>(lpbi) + sizeof(BITMAPINFOHEADER);
+    capture_core::CopyRows(pixels, rowSize, imageData.data() + sizeof(BITMAPINFOHEADER), rowSize,
+                           rowSize, height, bih.biHeight > 0);
 
     GlobalUnlock(hData);
     CloseClipboard();
 
     LOG_FLUTTER_FMT("Retrieved image from clipboard: %dx%d, %zu bytes", width, height, imageData.size());
 
-    flutter::EncodableList dataList(imageData.begin(), imageData.end());
-    result->Success(flutter::EncodableValue(dataList));
+    result->Success(flutter::EncodableValue(std::move(imageData)));
 
   } else if (call.method_name() == "hasImage") {
     // 检查剪贴板是否有图片
@@ -851,31 +2256,27 @@ void FlutterWindow::HandleClipboardMethodCall(
     const flutter::EncodableValue& args = *call.arguments();
     LOG_FLUTTER_FMT("Argument type index: %zu", args.index());
 
-    std::vector<uint8_t> imageBytes;
-
-    // 尝试作为 EncodableList (Uint8List 会被编码为 EncodableList)
-    const auto* byte_list = std::get_if<flutter::EncodableList>(&args);
-    if (byte_list) {
-      LOG_FLUTTER_FMT("Arguments is an EncodableList with %zu elements", byte_list->size());
-      // 转换为vector<uint8_t>
-      imageBytes.reserve(byte_list->size());
+    // Dart 的 Uint8List 解码为 std::vector<uint8_t>，直接引用参数里的数据，不做拷贝
+    std::vector<uint8_t> legacyBytes;
+    const auto* u8_list = std::get_if<std::vector<uint8_t>>(&args);
+    if (!u8_list) {
+      // 兼容旧调用方传入的 List<int>
+      const auto* byte_list = std::get_if<flutter::EncodableList>(&args);
+      if (!byte_list) {
+        LOG_FLUTTER("Arguments is neither std::vector<uint8_t> nor EncodableList");
+        result->Success(flutter::EncodableValue(false));
+        return;
+      }
+      LOG_FLUTTER_FMT("Arguments is a legacy EncodableList with %zu elements", byte_list->size());
+      legacyBytes.reserve(byte_list->size());
       for (const auto& item : *byte_list) {
         if (auto byte_value = std::get_if<int>(&item)) {
-          imageBytes.push_back(static_cast<uint8_t>(*byte_value));
+          legacyBytes.push_back(static_cast<uint8_t>(*byte_value));
         }
       }
-    } else {
-      // 尝试作为 std::vector<uint8_t> (Uint8List 可能直接映射为这个类型)
-      const auto* u8_list = std::get_if<std::vector<uint8_t>>(&args);
-      if (u8_list) {
-        LOG_FLUTTER_FMT("Arguments is std::vector<uint8_t> with %zu elements", u8_list->size());
-        imageBytes = *u8_list;  // 直接复制
-      } else {
-        LOG_FLUTTER("Arguments is neither EncodableList nor std::vector<uint8_t>");
-        result->Success(flutter::EncodableValue(false));
-        return;
-      }
+      u8_list = &legacyBytes;
     }
+    const std::vector<uint8_t>& imageBytes = *u8_list;
 
     LOG_FLUTTER_FMT("Image data received: %zu bytes", imageBytes.size());
 
@@ -8,10 +8,24 @@
 #include <flutter/encodable_value.h>
 #include <flutter/event_sink.h>
 
+#include <deque>
+#include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include "win32_window.h"
 #include "hotkey_manager.h"
+#include "frame_texture_registry.h"
+#include "window_tracker.h"
+#include "capture_core/capture_scheduler.h"
+#include "capture_core/encode_queue.h"
+#include "capture_core/idle_transcoder.h"
+#include "capture_core/job_queue.h"
+#include "capture_core/replay_buffer.h"
+#include "capture_core/screen_recorder.h"
+#include "capture_core/tile_change_detector.h"
 
 // A window that does nothing but host a Flutter view.
 class FlutterWindow : public Win32Window {
@@ -46,6 +60,94 @@ class FlutterWindow : public Win32Window {
   // Hotkey method channel for triggering Dart callbacks
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> hotkey_method_channel_;
 
+  // 截图任务队列：捕获、编码和窗口枚举在工作线程执行，
+  // 结果通过 kRunPlatformTasksMessage 回到平台线程回复
+  std::unique_ptr<capture_core::JobQueue> capture_jobs_;
+
+  // Screenshot method channel, kept to push encode completions back to Dart
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> screenshot_method_channel_;
+
+  // 两阶段截图的编码阶段：beginCapture 拿到像素就回复帧句柄，
+  // 编码（和可选的保存）在后台完成后通过 onEncodeComplete 通知 Dart
+  std::unique_ptr<capture_core::EncodeQueue> encode_queue_;
+
+  // 循环截图快速存储的 QOI 文件在截图空闲时转成 PNG（transcodeWhenIdle），
+  // 完成后通过 onTranscodeComplete 通知 Dart
+  std::unique_ptr<capture_core::IdleTranscoder> transcoder_;
+
+  // 循环截图的分块变化检测，按任务 id（changeKey）保存参考帧的分块哈希
+  capture_core::ChangeTracker change_tracker_;
+
+  // 循环截图的原生调度（startSchedule / stopSchedule）：计时在调度线程，
+  // 截图在 capture_jobs_ 上执行，编码和写文件在编码线程，Dart 只收到 onScheduledShot
+  struct ScheduledTask;
+  std::unique_ptr<capture_core::CaptureScheduler> scheduler_;
+  std::mutex scheduled_tasks_mutex_;
+  std::map<std::string, std::shared_ptr<ScheduledTask>> scheduled_tasks_;
+  // 有计划运行时用 timeBeginPeriod(1) 提高系统定时器精度，调度线程才能准时醒来
+  bool timer_period_raised_ = false;
+
+  // 区域录屏（startRecording / stopRecording），同一时间只有一段；
+  // 采集和编码在录屏器自己的线程上，stopRecording 的收尾在截图工作线程
+  std::shared_ptr<capture_core::ScreenRecorder> recorder_;
+  // 录屏期间同样提高定时器精度，由 scheduled_tasks_mutex_ 保护
+  bool recording_ = false;
+
+  // 即时回放（startInstantReplay / stopInstantReplay）：后台低帧率采集一个显示器，
+  // 最近一段画面压缩在内存中。saveReplay 热键在原生端直接保存到 replay_directory_，
+  // 不经过 Dart；保存在截图工作线程，结果通过 onReplaySaved 推送。
+  // 帧率很低，不提高定时器精度。只在平台线程访问
+  std::shared_ptr<capture_core::InstantReplay> instant_replay_;
+  std::string replay_directory_;
+  capture_core::AnimationFormat replay_format_ = capture_core::AnimationFormat::kApng;
+
+  // 截图预览的外部纹理（createFrameTexture / disposeFrameTexture）
+  std::unique_ptr<FrameTextureRegistry> frame_textures_;
+
+  // 窗口选择器的实时窗口列表（startWindowTracking / stopWindowTracking），
+  // 变化通过 onWindowsChanged 推送。只在平台线程启停
+  std::unique_ptr<WindowTracker> window_tracker_;
+
+  // 工作线程投递、等待在平台线程执行的闭包
+  std::mutex platform_tasks_mutex_;
+  std::deque<std::function<void()>> platform_tasks_;
+
+  // 把闭包投递到平台线程执行（任意线程可调用）
+  void PostToPlatformThread(std::function<void()> task);
+
+  // 执行所有已投递的闭包（平台线程）
+  void RunPlatformTasks();
+
+  // 在工作线程上执行 work，完成、取消或队列已满时在平台线程回复 result；
+  // work 收到请求的取消标记，取消后回复 CANCELLED，work 交出去的资源要自己收回
+  void SubmitCaptureJob(
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+      std::function<flutter::EncodableValue(const capture_core::CancellationToken&)> work);
+
+  // 编码结束（编码线程，或取消时的调用线程）：按需写文件，再在平台线程通知 Dart
+  void OnEncodeComplete(capture_core::EncodeResult encoded, const std::string& save_path);
+
+  // 转码结束（转码线程），把结果转发给 Dart 的 onTranscodeComplete
+  void OnTranscodeComplete(capture_core::TranscodeResult transcoded);
+
+  // 执行循环计划的一次触发（截图工作线程）：截图、过滤重复和未变化的帧，
+  // 提交编码，编码线程写完文件后通知 Dart
+  void RunScheduledShot(const std::shared_ptr<ScheduledTask>& task,
+                        capture_core::ScheduledShot shot,
+                        const capture_core::CancellationToken& token);
+
+  // 在平台线程把一次触发的结果推送给 Dart 的 onScheduledShot（任意线程可调用）
+  void PostScheduledShot(flutter::EncodableMap event);
+
+  // 计划结束（最后一次触发或被替换）后移除登记；id 不匹配时不做任何事
+  void EndScheduledTask(const std::string& task_id, capture_core::ScheduleId id);
+
+  // 按是否还有计划或录屏调整系统定时器精度，调用方持有 scheduled_tasks_mutex_
+  void UpdateTimerResolution();
+
+  // 在截图工作线程把即时回放写到 replay_directory_，完成后推送 onReplaySaved（平台线程调用）
+  void SaveInstantReplayFromHotkey();
+
   // Handle screenshot method calls from Flutter
   void HandleScreenshotMethodCall(
       const flutter::MethodCall<flutter::EncodableValue>& call,
@@ -0,0 +1,73 @@
+// External textures backing the capture preview
+#include "frame_texture_registry.h"
+
+#include <utility>
+#include <vector>
+
+FrameTextureRegistry::FrameTextureRegistry(flutter::TextureRegistrar* registrar)
+    : registrar_(registrar) {}
+
+FrameTextureRegistry::~FrameTextureRegistry() {
+    UnregisterAll();
+}
+
+int64_t FrameTextureRegistry::Register(capture_core::FrameBuffer rgba) {
+    if (registrar_ == nullptr || rgba.empty() ||
+        rgba.format() != capture_core::PixelFormat::kRgba8 || rgba.stride() != rgba.width() * 4) {
+        return -1;
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->pixels = std::move(rgba);
+    entry->buffer.buffer = entry->pixels.data();
+    entry->buffer.width = static_cast<size_t>(entry->pixels.width());
+    entry->buffer.height = static_cast<size_t>(entry->pixels.height());
+    // 回调只借用 Entry：Entry 持有纹理对象，注销回调执行前由 Release 保持存活
+    Entry* raw = entry.get();
+    entry->texture = std::make_unique<flutter::TextureVariant>(flutter::PixelBufferTexture(
+        [raw](size_t, size_t) -> const FlutterDesktopPixelBuffer* { return &raw->buffer; }));
+
+    int64_t texture_id = registrar_->RegisterTexture(entry->texture.get());
+    if (texture_id < 0) {
+        return -1;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_[texture_id] = entry;
+    }
+    // 像素不会再变化，通知一次即可
+    registrar_->MarkTextureFrameAvailable(texture_id);
+    return texture_id;
+}
+
+bool FrameTextureRegistry::Unregister(int64_t texture_id) {
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(texture_id);
+        if (it == entries_.end()) {
+            return false;
+        }
+        entry = std::move(it->second);
+        entries_.erase(it);
+    }
+    Release(texture_id, std::move(entry));
+    return true;
+}
+
+size_t FrameTextureRegistry::UnregisterAll() {
+    std::unordered_map<int64_t, std::shared_ptr<Entry>> entries;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries.swap(entries_);
+    }
+    for (auto& item : entries) {
+        Release(item.first, std::move(item.second));
+    }
+    return entries.size();
+}
+
+void FrameTextureRegistry::Release(int64_t texture_id, std::shared_ptr<Entry> entry) {
+    // 光栅线程可能正在读像素，回调里才真正释放
+    registrar_->UnregisterTexture(texture_id, [entry]() {});
+}
@@ -0,0 +1,50 @@
+#ifndef RUNNER_FRAME_TEXTURE_REGISTRY_H_
+#define RUNNER_FRAME_TEXTURE_REGISTRY_H_
+
+#include <flutter/texture_registrar.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "capture_core/frame_buffer.h"
+
+// 截图预览用的外部纹理
+//
+// 两阶段截图的原始帧转成 RGBA 后注册为 flutter::PixelBufferTexture，
+// Dart 端用 Texture(textureId) 直接显示，不再经过 PNG 编码、跨通道传输和解码。
+// 纹理持有自己的像素副本，帧句柄编码结束或被取消后预览仍然有效，
+// 直到 Unregister。Flutter 的纹理注册接口可在任意线程调用，这里也一样。
+class FrameTextureRegistry {
+public:
+    explicit FrameTextureRegistry(flutter::TextureRegistrar* registrar);
+    // 注销所有纹理；必须在引擎销毁前调用
+    ~FrameTextureRegistry();
+
+    FrameTextureRegistry(const FrameTextureRegistry&) = delete;
+    FrameTextureRegistry& operator=(const FrameTextureRegistry&) = delete;
+
+    // 注册一帧 kRgba8 像素（行间无填充），返回纹理 id，失败返回 -1
+    int64_t Register(capture_core::FrameBuffer rgba);
+
+    // 注销纹理；像素在光栅线程确认不再使用后才释放。不存在时返回 false
+    bool Unregister(int64_t texture_id);
+    // 注销所有纹理，返回注销的数量
+    size_t UnregisterAll();
+
+private:
+    struct Entry {
+        capture_core::FrameBuffer pixels;
+        FlutterDesktopPixelBuffer buffer = {};
+        std::unique_ptr<flutter::TextureVariant> texture;
+    };
+
+    void Release(int64_t texture_id, std::shared_ptr<Entry> entry);
+
+    flutter::TextureRegistrar* const registrar_;
+    std::mutex mutex_;
+    std::unordered_map<int64_t, std::shared_ptr<Entry>> entries_;
+};
+
+#endif  // RUNNER_FRAME_TEXTURE_REGISTRY_H_
@@ -0,0 +1,58 @@
+// Frozen overlay frame kept for captureSelectedRegion
+#include "frozen_frame_store.h"
+
+using capture_core::Rect;
+
+FrozenFrameStore& FrozenFrameStore::Shared() {
+    static FrozenFrameStore store;
+    return store;
+}
+
+FrozenFrameStore::FrozenFrameStore()
+    : timer_(CreateThreadpoolTimer(&FrozenFrameStore::OnTimeout, this, NULL)) {}
+
+FrozenFrameStore::~FrozenFrameStore() {
+    if (timer_ != NULL) {
+        SetThreadpoolTimer(timer_, NULL, 0, 0);
+        WaitForThreadpoolTimerCallbacks(timer_, TRUE);
+        CloseThreadpoolTimer(timer_);
+    }
+}
+
+void FrozenFrameStore::Put(std::unique_ptr<DibSection> section, const Rect& bounds) {
+    std::unique_ptr<DibSection> previous;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        previous = std::move(section_);
+        section_ = std::move(section);
+        bounds_ = bounds;
+    }
+    DibSectionPool::Shared().Release(std::move(previous));
+
+    if (timer_ != NULL) {
+        // 负值表示相对时间，单位 100ns；重新设置会替换之前的到期时间
+        ULARGE_INTEGER due;
+        due.QuadPart = static_cast<ULONGLONG>(-static_cast<LONGLONG>(kTimeoutMs) * 10000);
+        FILETIME due_time;
+        due_time.dwLowDateTime = due.LowPart;
+        due_time.dwHighDateTime = due.HighPart;
+        SetThreadpoolTimer(timer_, &due_time, 0, 0);
+    }
+}
+
+std::unique_ptr<DibSection> FrozenFrameStore::Take(Rect* bounds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bounds != nullptr) {
+        *bounds = bounds_;
+    }
+    bounds_ = Rect();
+    return std::move(section_);
+}
+
+void FrozenFrameStore::Clear() {
+    DibSectionPool::Shared().Release(Take(nullptr));
+}
+
+VOID CALLBACK FrozenFrameStore::OnTimeout(PTP_CALLBACK_INSTANCE, PVOID context, PTP_TIMER) {
+    static_cast<FrozenFrameStore*>(context)->Clear();
+}
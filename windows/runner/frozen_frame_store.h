@@ -0,0 +1,48 @@
+#ifndef RUNNER_FROZEN_FRAME_STORE_H_
+#define RUNNER_FROZEN_FRAME_STORE_H_
+
+#include <windows.h>
+
+#include <memory>
+#include <mutex>
+
+#include "capture_core/geometry.h"
+#include "dib_section_pool.h"
+
+// 区域选择蒙版的冻结帧
+//
+// NativeScreenshotWindow 显示前截下的整屏画面在用户确认选择后交给这里，
+// captureSelectedRegion 直接从中裁剪编码，不再在蒙版关闭后重新 BitBlt。
+// 冻结帧只能取出一次；kTimeoutMs 内没有被取走时归还给 DibSectionPool，
+// 避免 Dart 端没有跟进时一直占着一整屏内存。
+class FrozenFrameStore {
+public:
+    static constexpr DWORD kTimeoutMs = 10000;
+
+    static FrozenFrameStore& Shared();
+
+    // 保存冻结帧，bounds 为其左上角屏幕坐标和尺寸；之前未取走的帧会被归还
+    void Put(std::unique_ptr<DibSection> section, const capture_core::Rect& bounds);
+
+    // 取出冻结帧，用完后由调用方归还给 DibSectionPool；没有（或已超时）返回 nullptr
+    std::unique_ptr<DibSection> Take(capture_core::Rect* bounds);
+
+    // 立即归还冻结帧
+    void Clear();
+
+private:
+    FrozenFrameStore();
+    ~FrozenFrameStore();
+
+    FrozenFrameStore(const FrozenFrameStore&) = delete;
+    FrozenFrameStore& operator=(const FrozenFrameStore&) = delete;
+
+    static VOID CALLBACK OnTimeout(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer);
+
+    std::mutex mutex_;
+    std::unique_ptr<DibSection> section_;
+    capture_core::Rect bounds_;
+    PTP_TIMER timer_;
+};
+
+#endif  // RUNNER_FROZEN_FRAME_STORE_H_
@@ -0,0 +1,148 @@
+// GDI capture backends for capture_core
+#include "gdi_frame_source.h"
+
+using capture_core::FrameBuffer;
+using capture_core::PixelFormat;
+using capture_core::Rect;
+
+namespace {
+
+// 从共享池借一个能容纳 region 的缓冲放进 *section（先归还上一次借的）
+bool LeaseSection(const Rect& region, std::unique_ptr<DibSection>* section) {
+    DibSectionPool& pool = DibSectionPool::Shared();
+    if (*section && (*section)->Fits(region.width, region.height)) {
+        return true;
+    }
+    pool.Release(std::move(*section));
+    *section = pool.Acquire(region);
+    return *section != nullptr;
+}
+
+// GDI 可能批量延迟绘制，读取 DIB 内存前先刷新
+void WrapSection(const DibSection& section, int width, int height, FrameBuffer* frame) {
+    GdiFlush();
+    frame->Wrap(section.bits(), width, height, section.stride(), PixelFormat::kBgrx8);
+}
+
+}  // namespace
+
+Rect GdiScreenSource::GetBounds() {
+    return Rect(GetSystemMetrics(SM_XVIRTUALSCREEN), GetSystemMetrics(SM_YVIRTUALSCREEN),
+                GetSystemMetrics(SM_CXVIRTUALSCREEN), GetSystemMetrics(SM_CYVIRTUALSCREEN));
+}
+
+Rect GdiScreenSource::GetPrimaryBounds() {
+    return Rect(0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN));
+}
+
+GdiScreenSource::~GdiScreenSource() {
+    DibSectionPool::Shared().Release(std::move(section_));
+}
+
+bool GdiScreenSource::Capture(const Rect& region, FrameBuffer* frame) {
+    if (region.empty() || !LeaseSection(region, &section_)) {
+        return false;
+    }
+
+    HDC hdcScreen = GetDC(NULL);
+    BOOL blitted = BitBlt(section_->dc(), 0, 0, region.width, region.height,
+                          hdcScreen, region.x, region.y, SRCCOPY);
+    ReleaseDC(NULL, hdcScreen);
+    if (!blitted) {
+        return false;
+    }
+
+    WrapSection(*section_, region.width, region.height, frame);
+    return true;
+}
+
+GdiWindowSource::GdiWindowSource(HWND hwnd) : hwnd_(hwnd) {}
+
+GdiWindowSource::~GdiWindowSource() {
+    DibSectionPool::Shared().Release(std::move(section_));
+}
+
+Rect GdiWindowSource::GetBounds() {
+    RECT rect;
+    if (!IsWindow(hwnd_) || !GetWindowRect(hwnd_, &rect)) {
+        return Rect();
+    }
+    return Rect(rect.left, rect.top, rect.right - rect.left, rect.bottom - rect.top);
+}
+
+bool GdiWindowSource::Capture(const Rect& region, FrameBuffer* frame) {
+    // 窗口截图总是渲染整个窗口，region 只用于校验
+    Rect bounds = GetBounds();
+    if (bounds.empty() || region.empty()) {
+        return false;
+    }
+    int width = bounds.width;
+    int height = bounds.height;
+    if (!LeaseSection(bounds, &section_)) {
+        return false;
+    }
+
+    HDC hdcScreen = GetDC(NULL);
+    HDC hdcMem = section_->dc();
+
+    // Fill background with white (not black)
+    RECT bgRect = {0, 0, width, height};
+    FillRect(hdcMem, &bgRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+
+    // Method 1: Try PrintWindow with different flags
+    BOOL success = FALSE;
+
+    // Try PW_RENDERFULLCONTENT (for Windows 8.1+, captures hardware-accelerated content)
+    #ifdef PW_RENDERFULLCONTENT
+    success = PrintWindow(hwnd_, hdcMem, PW_RENDERFULLCONTENT);
+    #endif
+
+    // Try standard PrintWindow if PW_RENDERFULLCONTENT failed or not available
+    if (!success) {
+        success = PrintWindow(hwnd_, hdcMem, 0);
+    }
+
+    // Method 2: If PrintWindow failed, use window DC
+    if (!success) {
+        HDC hdcWindow = GetWindowDC(hwnd_);
+        if (hdcWindow != NULL) {
+            // Center the client area in the bitmap
+            RECT clientRect;
+            GetClientRect(hwnd_, &clientRect);
+            int clientWidth = clientRect.right - clientRect.left;
+            int clientHeight = clientRect.bottom - clientRect.top;
+            int offsetX = (width - clientWidth) / 2;
+            int offsetY = (height - clientHeight) / 2;
+
+            FillRect(hdcMem, &bgRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+            BitBlt(hdcMem, offsetX, offsetY, clientWidth, clientHeight,
+                   hdcWindow, 0, 0, SRCCOPY);
+
+            ReleaseDC(hwnd_, hdcWindow);
+            success = TRUE;
+        }
+    }
+
+    // Method 3: Last resort - capture from screen DC (desktop)
+    if (!success) {
+        if (IsIconic(hwnd_)) {
+            ShowWindow(hwnd_, SW_RESTORE);
+        }
+
+        // Bring window to top without stealing focus
+        SetWindowPos(hwnd_, HWND_TOP, 0, 0, 0, 0,
+                     SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+        UpdateWindow(hwnd_);
+
+        // Small delay to let window paint
+        Sleep(100);
+
+        FillRect(hdcMem, &bgRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+        BitBlt(hdcMem, 0, 0, width, height, hdcScreen, bounds.x, bounds.y, SRCCOPY);
+    }
+
+    ReleaseDC(NULL, hdcScreen);
+
+    WrapSection(*section_, width, height, frame);
+    return true;
+}
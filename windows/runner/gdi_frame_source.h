@@ -0,0 +1,53 @@
+#ifndef RUNNER_GDI_FRAME_SOURCE_H_
+#define RUNNER_GDI_FRAME_SOURCE_H_
+
+#include <windows.h>
+
+#include <memory>
+
+#include "capture_core/frame_source.h"
+#include "dib_section_pool.h"
+
+// 基于 GDI BitBlt 的屏幕帧来源
+// 输出 kBgrx8（BitBlt 之后 alpha 未定义）
+//
+// BitBlt 直接写进从 DibSectionPool 借来的 DIB section，frame 原地指向它，
+// 内容在下一次 Capture 或实例销毁（归还缓冲）之前有效。
+class GdiScreenSource : public capture_core::FrameSource {
+public:
+    GdiScreenSource() = default;
+    ~GdiScreenSource() override;
+
+    GdiScreenSource(const GdiScreenSource&) = delete;
+    GdiScreenSource& operator=(const GdiScreenSource&) = delete;
+
+    // 虚拟桌面范围（包含所有显示器，区域截图可以跨显示器）
+    capture_core::Rect GetBounds() override;
+    // 主显示器范围
+    capture_core::Rect GetPrimaryBounds();
+    bool Capture(const capture_core::Rect& region, capture_core::FrameBuffer* frame) override;
+
+private:
+    std::unique_ptr<DibSection> section_;
+};
+
+// 单个窗口的帧来源
+// 依次尝试 PrintWindow(PW_RENDERFULLCONTENT)、PrintWindow、窗口 DC、屏幕 DC
+// 缓冲的借用方式与 GdiScreenSource 相同
+class GdiWindowSource : public capture_core::FrameSource {
+public:
+    explicit GdiWindowSource(HWND hwnd);
+    ~GdiWindowSource() override;
+
+    GdiWindowSource(const GdiWindowSource&) = delete;
+    GdiWindowSource& operator=(const GdiWindowSource&) = delete;
+
+    capture_core::Rect GetBounds() override;
+    bool Capture(const capture_core::Rect& region, capture_core::FrameBuffer* frame) override;
+
+private:
+    HWND hwnd_;
+    std::unique_ptr<DibSection> section_;
+};
+
+#endif  // RUNNER_GDI_FRAME_SOURCE_H_
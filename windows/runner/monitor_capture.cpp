@@ -0,0 +1,62 @@
+// Monitor enumeration and multi-monitor GDI capture
+#include "monitor_capture.h"
+
+#include "gdi_frame_source.h"
+
+namespace {
+
+BOOL CALLBACK EnumMonitorsProc(HMONITOR hMonitor, HDC, LPRECT, LPARAM lParam) {
+    auto* monitors = reinterpret_cast<std::vector<capture_core::MonitorInfo>*>(lParam);
+
+    MONITORINFOEXW info = {};
+    info.cbSize = sizeof(info);
+    if (!GetMonitorInfoW(hMonitor, &info)) {
+        return TRUE;
+    }
+
+    capture_core::MonitorInfo monitor;
+    monitor.index = static_cast<int>(monitors->size());
+    monitor.bounds = capture_core::Rect(info.rcMonitor.left, info.rcMonitor.top,
+                                        info.rcMonitor.right - info.rcMonitor.left,
+                                        info.rcMonitor.bottom - info.rcMonitor.top);
+    monitor.primary = (info.dwFlags & MONITORINFOF_PRIMARY) != 0;
+
+    // 设备名（\\.\DISPLAY1）转成 UTF-8
+    int nameLen = WideCharToMultiByte(CP_UTF8, 0, info.szDevice, -1, NULL, 0, NULL, NULL);
+    if (nameLen > 1) {
+        monitor.name.resize(nameLen - 1);
+        WideCharToMultiByte(CP_UTF8, 0, info.szDevice, -1, &monitor.name[0], nameLen, NULL, NULL);
+    }
+
+    monitors->push_back(monitor);
+    return TRUE;
+}
+
+}  // namespace
+
+std::vector<capture_core::MonitorInfo> EnumerateMonitors() {
+    std::vector<capture_core::MonitorInfo> monitors;
+    EnumDisplayMonitors(NULL, NULL, EnumMonitorsProc, reinterpret_cast<LPARAM>(&monitors));
+    return monitors;
+}
+
+// 每个显示器一个 GdiScreenSource（各自从 DibSectionPool 借缓冲），
+// 析构时缓冲归还给池，下一次多显示器截图可以直接复用
+capture_core::MultiMonitorCapture::SourceFactory GdiMonitorSourceFactory() {
+    return [](const capture_core::MonitorInfo&) {
+        return std::unique_ptr<capture_core::FrameSource>(new GdiScreenSource());
+    };
+}
+
+bool CaptureVirtualDesktopFrame(capture_core::FrameBuffer* frame,
+                                capture_core::Rect* bounds,
+                                std::vector<capture_core::MonitorInfo>* monitors) {
+    capture_core::MultiMonitorCapture capture(EnumerateMonitors(), GdiMonitorSourceFactory());
+    if (bounds != nullptr) {
+        *bounds = capture.virtual_bounds();
+    }
+    if (monitors != nullptr) {
+        *monitors = capture.monitors();
+    }
+    return capture.CaptureVirtualDesktop(frame);
+}
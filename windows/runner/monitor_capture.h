@@ -0,0 +1,26 @@
+#ifndef RUNNER_MONITOR_CAPTURE_H_
+#define RUNNER_MONITOR_CAPTURE_H_
+
+#include <windows.h>
+
+#include <vector>
+
+#include "capture_core/frame_buffer.h"
+#include "capture_core/monitor_info.h"
+#include "capture_core/multi_monitor_capture.h"
+
+// 按 EnumDisplayMonitors 的顺序列出显示器
+// bounds 为虚拟桌面坐标，主屏左上角为 (0, 0)，副屏可能为负
+std::vector<capture_core::MonitorInfo> EnumerateMonitors();
+
+// 每个显示器一个 GdiScreenSource，各自从 DibSectionPool 借缓冲
+capture_core::MultiMonitorCapture::SourceFactory GdiMonitorSourceFactory();
+
+// 各显示器并行 BitBlt，拼接成整个虚拟桌面写入 frame
+// frame 已是虚拟桌面大小时（例如包装了 DIB section）原地写入
+// bounds / monitors 可以为 nullptr，返回本次使用的虚拟桌面范围和显示器布局
+bool CaptureVirtualDesktopFrame(capture_core::FrameBuffer* frame,
+                                capture_core::Rect* bounds,
+                                std::vector<capture_core::MonitorInfo>* monitors);
+
+#endif  // RUNNER_MONITOR_CAPTURE_H_
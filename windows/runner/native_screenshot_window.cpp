@@ -1,9 +1,14 @@
 #include "native_screenshot_window.h"
 #include <dwmapi.h>
 #include <cwchar>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <windows.h>
 #include <fstream>
+
+#include "frozen_frame_store.h"
+#include "monitor_capture.h"
 #pragma comment(lib, "dwmapi.lib")
 
 static const wchar_t kClassName[] = L"NativeScreenshotWindow";
@@ -39,16 +44,101 @@ static void LogToFile(const char* message) {
     LogToFile(buffer); \
   } while (0)
 
+// 选择框左上方的尺寸文字
+const int SIZE_LABEL_WIDTH = 160;
+const int SIZE_LABEL_HEIGHT = 30;
+
 // 按钮尺寸
 const int BUTTON_WIDTH = 80;
 const int BUTTON_HEIGHT = 30;
 const int BUTTON_MARGIN = 10;
 
+// 悬停检测快照：忽略过小的顶层窗口和子控件，条目总数有上限
+const int kMinHoverWindowSize = 50;
+const int kMinHoverChildSize = 16;
+const size_t kMaxHoverRects = 8192;
+
+// 快照的遍历状态（EnumWindows / EnumChildWindows 的 lParam）
+struct WindowSnapshot {
+    capture_core::WindowRectIndex* index;
+    HWND overlay;
+    int originX;
+    int originY;
+    // 已加入的窗口，子控件由此找到父元素的下标
+    std::unordered_map<HWND, int> added;
+};
+
+// 屏幕矩形转成以 (originX, originY) 为原点的 Rect
+static capture_core::Rect ToIndexRect(const RECT& rect, int originX, int originY) {
+    return capture_core::Rect(rect.left - originX, rect.top - originY,
+                              rect.right - rect.left, rect.bottom - rect.top);
+}
+
+// 被 DWM 隐藏的窗口（其它虚拟桌面、挂起的 UWP 应用）IsWindowVisible 仍为 TRUE
+static bool IsWindowCloaked(HWND hwnd) {
+    DWORD cloaked = 0;
+    return SUCCEEDED(DwmGetWindowAttribute(hwnd, DWMWA_CLOAKED, &cloaked, sizeof(cloaked))) &&
+           cloaked != 0;
+}
+
+static BOOL CALLBACK SnapshotChildProc(HWND hwnd, LPARAM lParam) {
+    WindowSnapshot* snapshot = reinterpret_cast<WindowSnapshot*>(lParam);
+    if (snapshot->index->size() >= kMaxHoverRects) {
+        return FALSE;
+    }
+    // EnumChildWindows 先父后子、同层按 z 序从上到下；父元素被跳过时它的子控件也跳过
+    auto parent = snapshot->added.find(GetAncestor(hwnd, GA_PARENT));
+    if (parent == snapshot->added.end() || !IsWindowVisible(hwnd)) {
+        return TRUE;
+    }
+    RECT rect;
+    if (!GetWindowRect(hwnd, &rect) || rect.right - rect.left < kMinHoverChildSize ||
+        rect.bottom - rect.top < kMinHoverChildSize) {
+        return TRUE;
+    }
+    int index = snapshot->index->Add(reinterpret_cast<uintptr_t>(hwnd),
+                                     ToIndexRect(rect, snapshot->originX, snapshot->originY),
+                                     parent->second);
+    if (index >= 0) {
+        snapshot->added.emplace(hwnd, index);
+    }
+    return TRUE;
+}
+
+static BOOL CALLBACK SnapshotWindowProc(HWND hwnd, LPARAM lParam) {
+    WindowSnapshot* snapshot = reinterpret_cast<WindowSnapshot*>(lParam);
+    if (snapshot->index->size() >= kMaxHoverRects) {
+        return FALSE;
+    }
+    // 与 WindowFromPoint 一样跳过鼠标穿透的窗口
+    if (hwnd == snapshot->overlay || !IsWindowVisible(hwnd) || IsIconic(hwnd) ||
+        (GetWindowLongW(hwnd, GWL_EXSTYLE) & WS_EX_TRANSPARENT) != 0 || IsWindowCloaked(hwnd)) {
+        return TRUE;
+    }
+    // 扩展边框是窗口实际画出来的范围，GetWindowRect 还包括 Windows 10 起不可见的阴影边框
+    RECT rect;
+    if (FAILED(DwmGetWindowAttribute(hwnd, DWMWA_EXTENDED_FRAME_BOUNDS, &rect, sizeof(rect))) &&
+        !GetWindowRect(hwnd, &rect)) {
+        return TRUE;
+    }
+    if (rect.right - rect.left < kMinHoverWindowSize ||
+        rect.bottom - rect.top < kMinHoverWindowSize) {
+        return TRUE;
+    }
+    int index = snapshot->index->Add(reinterpret_cast<uintptr_t>(hwnd),
+                                     ToIndexRect(rect, snapshot->originX, snapshot->originY));
+    if (index >= 0) {
+        snapshot->added.emplace(hwnd, index);
+        EnumChildWindows(hwnd, SnapshotChildProc, lParam);
+    }
+    return TRUE;
+}
+
 NativeScreenshotWindow::NativeScreenshotWindow()
     : hwnd_(NULL), onSelected_(NULL), onCancelled_(NULL),
       state_(ScreenshotState::Idle),
       isDragging_(false), activeHandle_(HandleType::None),
-      hBackgroundBitmap_(NULL), screenWidth_(0), screenHeight_(0),
+      screenLeft_(0), screenTop_(0), screenWidth_(0), screenHeight_(0),
       isHoveringConfirm_(false), isHoveringCancel_(false),
       hHoveredWindow_(NULL) {
     ZeroMemory(&selectionRect_, sizeof(RECT));
@@ -56,14 +146,12 @@ NativeScreenshotWindow::NativeScreenshotWindow()
     ZeroMemory(&dragStartRect_, sizeof(RECT));
     ZeroMemory(&confirmButtonRect_, sizeof(RECT));
     ZeroMemory(&cancelButtonRect_, sizeof(RECT));
+    ZeroMemory(&mousePos_, sizeof(POINT));
 }
 
 NativeScreenshotWindow::~NativeScreenshotWindow() {
     Close();
-    if (hBackgroundBitmap_) {
-        DeleteObject(hBackgroundBitmap_);
-        hBackgroundBitmap_ = NULL;
-    }
+    DibSectionPool::Shared().Release(std::move(background_));
 }
 
 bool NativeScreenshotWindow::Show(RegionSelectedCallback onSelected, CancelledCallback onCancelled) {
@@ -95,15 +183,40 @@ bool NativeScreenshotWindow::Show(RegionSelectedCallback onSelected, CancelledCa
     }
     LOG_DEBUG("Window class registered successfully");
 
-    screenWidth_ = GetSystemMetrics(SM_CXSCREEN);
-    screenHeight_ = GetSystemMetrics(SM_CYSCREEN);
-    LOG_DEBUG_FMT("Screen dimensions: %dx%d", screenWidth_, screenHeight_);
+    // 覆盖所有显示器，而不只是主屏
+    capture_core::Rect desktop =
+        capture_core::VirtualDesktopBounds(EnumerateMonitors());
+    if (desktop.empty()) {
+        desktop = capture_core::Rect(
+            GetSystemMetrics(SM_XVIRTUALSCREEN), GetSystemMetrics(SM_YVIRTUALSCREEN),
+            GetSystemMetrics(SM_CXVIRTUALSCREEN), GetSystemMetrics(SM_CYVIRTUALSCREEN));
+    }
+    screenLeft_ = desktop.x;
+    screenTop_ = desktop.y;
+    screenWidth_ = desktop.width;
+    screenHeight_ = desktop.height;
+    LOG_DEBUG_FMT("Virtual desktop: (%d,%d) %dx%d",
+                  screenLeft_, screenTop_, screenWidth_, screenHeight_);
+
+    // 上一次选择留下的冻结帧已经过时，先归还再截新的背景
+    FrozenFrameStore::Shared().Clear();
 
     // 捕获桌面背景
     if (!CaptureDesktopBackground()) {
         LOG_DEBUG("Failed to capture desktop background");
         return false;
     }
+    // 蒙版创建之前记录窗口矩形，与冻结的背景一致，也不会包含蒙版自己
+    SnapshotWindowRects();
+
+    if (!PrepareBuffers()) {
+        LOG_DEBUG("Failed to create overlay buffers");
+        DibSectionPool::Shared().Release(std::move(background_));
+        return false;
+    }
+    GetCursorPos(&mousePos_);
+    mousePos_.x -= screenLeft_;
+    mousePos_.y -= screenTop_;
 
     LOG_DEBUG("Creating window...");
     hwnd_ = CreateWindowExW(
@@ -111,7 +224,7 @@ bool NativeScreenshotWindow::Show(RegionSelectedCallback onSelected, CancelledCa
         kClassName,
         L"Screenshot",
         WS_POPUP,
-        0, 0, screenWidth_, screenHeight_,
+        screenLeft_, screenTop_, screenWidth_, screenHeight_,
         NULL, NULL, hInstance, this
     );
 
@@ -121,6 +234,10 @@ bool NativeScreenshotWindow::Show(RegionSelectedCallback onSelected, CancelledCa
     }
     LOG_DEBUG_FMT("Window created successfully: 0x%p", hwnd_);
 
+    // 第一帧整屏绘制，之后只重画变化的元素
+    damage_.Reset(capture_core::Rect(0, 0, screenWidth_, screenHeight_));
+    InvalidateOverlay();
+
     LOG_DEBUG("Showing window...");
     ShowWindow(hwnd_, SW_SHOW);
     SetForegroundWindow(hwnd_);
@@ -162,7 +279,18 @@ void NativeScreenshotWindow::Close() {
         PostQuitMessage(0);
         DestroyWindow(hwnd_);
         hwnd_ = NULL;
+
+        const capture_core::DamageStats& stats = damage_.stats();
+        LOG_DEBUG_FMT("Repainted %llu frames, %llu full, %llu pixels per frame",
+                      static_cast<unsigned long long>(stats.frames),
+                      static_cast<unsigned long long>(stats.full_repaints),
+                      static_cast<unsigned long long>(
+                          stats.frames > 0 ? stats.repainted_pixels / stats.frames : 0));
     }
+    windowRects_.Reset(capture_core::Rect());
+    hHoveredWindow_ = NULL;
+    DibSectionPool::Shared().Release(std::move(dimmed_));
+    DibSectionPool::Shared().Release(std::move(backBuffer_));
 }
 
 LRESULT CALLBACK NativeScreenshotWindow::WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
@@ -186,19 +314,23 @@ LRESULT CALLBACK NativeScreenshotWindow::WindowProc(HWND hwnd, UINT msg, WPARAM
 LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
         case WM_PAINT: {
+            // 更新区域要在 BeginPaint 之前取出（之后就被清空），后台缓冲只重画这部分
+            HRGN updateRgn = CreateRectRgn(0, 0, 0, 0);
+            GetUpdateRgn(hwnd_, updateRgn, FALSE);
+
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hwnd_, &ps);
-
-            // 始终绘制
-            DrawSelection(hdc);
-
+            DrawSelection(hdc, ps.rcPaint, updateRgn);
             EndPaint(hwnd_, &ps);
+
+            DeleteObject(updateRgn);
             break;
         }
 
         case WM_MOUSEMOVE: {
             int mouseX = LOWORD(lParam);
             int mouseY = HIWORD(lParam);
+            mousePos_ = {mouseX, mouseY};
 
             // 如果正在拖拽，更新选择区域
             if (isDragging_) {
@@ -212,19 +344,15 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
                     // 从预览框开始拖拽
                     UpdateSelectionFromDrag(mouseX, mouseY);
                 }
-                InvalidateRect(hwnd_, NULL, FALSE);
+                InvalidateOverlay();
             } else if (state_ == ScreenshotState::Selected) {
                 // 检查是否悬停在按钮上
                 POINT pt = {mouseX, mouseY};
-                bool wasHoveringConfirm = isHoveringConfirm_;
-                bool wasHoveringCancel = isHoveringCancel_;
-
                 isHoveringConfirm_ = PointInRect(pt, confirmButtonRect_);
                 isHoveringCancel_ = PointInRect(pt, cancelButtonRect_);
 
-                if (wasHoveringConfirm != isHoveringConfirm_ || wasHoveringCancel != isHoveringCancel_) {
-                    InvalidateRect(hwnd_, NULL, FALSE);
-                }
+                // 放大镜跟随鼠标；按钮的悬停状态变化时工具栏也要重画
+                InvalidateOverlay();
 
                 // 更新光标
                 HandleType handle = HitTest(mouseX, mouseY);
@@ -232,8 +360,8 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
                 if (hCursor) {
                     SetCursor(hCursor);
                 }
-            } else if (state_ == ScreenshotState::Idle) {
-                // 在空闲状态下检测窗体
+            } else if (state_ == ScreenshotState::Idle || state_ == ScreenshotState::Hovering) {
+                // 未选择时跟随鼠标检测窗体（查询快照，不跨进程）
                 RECT windowRect;
                 DetectWindowAtPoint({mouseX, mouseY}, windowRect);
 
@@ -245,7 +373,7 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
                     // 无窗体，保持空闲
                     state_ = ScreenshotState::Idle;
                 }
-                InvalidateRect(hwnd_, NULL, FALSE);
+                InvalidateOverlay();
             }
 
             break;
@@ -264,8 +392,14 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
                     LOG_DEBUG_FMT("🔥 Selection size: %dx%d, position: (%d,%d)",
                                  width, height, selectionRect_.left, selectionRect_.top);
                     if (width >= 10 && height >= 10 && onSelected_) {
+                        // 先交出冻结帧，Dart 收到选择结果后用 captureSelectedRegion 直接裁剪
+                        FrozenFrameStore::Shared().Put(
+                            std::move(background_),
+                            capture_core::Rect(screenLeft_, screenTop_, screenWidth_, screenHeight_));
                         LOG_DEBUG("🔥 Calling onSelected_ callback...");
-                        onSelected_(selectionRect_.left, selectionRect_.top, width, height);
+                        // 回调使用屏幕坐标
+                        onSelected_(selectionRect_.left + screenLeft_, selectionRect_.top + screenTop_,
+                                    width, height);
                         LOG_DEBUG("🔥 onSelected_ callback completed!");
                     } else {
                         LOG_DEBUG("🔥 Selection too small or callback is null!");
@@ -292,7 +426,7 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
                     dragStartPoint_ = {mouseX, mouseY};
                     dragStartRect_ = selectionRect_;
                     SetCapture(hwnd_);
-                    InvalidateRect(hwnd_, NULL, FALSE);
+                    InvalidateOverlay();
                     return 0;
                 }
             }
@@ -370,7 +504,7 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
                     state_ = ScreenshotState::Idle;
                 }
 
-                InvalidateRect(hwnd_, NULL, FALSE);
+                InvalidateOverlay();
             }
             break;
         }
@@ -399,42 +533,43 @@ LRESULT NativeScreenshotWindow::HandleMessage(UINT msg, WPARAM wParam, LPARAM lP
     return 0;
 }
 
-void NativeScreenshotWindow::DrawSelection(HDC hdc) {
-    // 使用双缓冲技术
-    HDC hdcMem = CreateCompatibleDC(hdc);
-    HBITMAP hbmMem = CreateCompatibleBitmap(hdc, screenWidth_, screenHeight_);
-    HBITMAP hbmOld = (HBITMAP)SelectObject(hdcMem, hbmMem);
-
-    // 绘制背景
-    if (hBackgroundBitmap_) {
-        HDC hdcBg = CreateCompatibleDC(hdc);
-        HBITMAP hbmBgOld = (HBITMAP)SelectObject(hdcBg, hBackgroundBitmap_);
-        BitBlt(hdcMem, 0, 0, screenWidth_, screenHeight_, hdcBg, 0, 0, SRCCOPY);
-        SelectObject(hdcBg, hbmBgOld);
-        DeleteDC(hdcBg);
-    } else {
-        RECT rect = {0, 0, screenWidth_, screenHeight_};
-        HBRUSH hBrush = CreateSolidBrush(RGB(0, 0, 0));
-        FillRect(hdcMem, &rect, hBrush);
-        DeleteObject(hBrush);
+void NativeScreenshotWindow::DrawSelection(HDC hdc, const RECT& paintRect, HRGN updateRgn) {
+    int paintWidth = paintRect.right - paintRect.left;
+    int paintHeight = paintRect.bottom - paintRect.top;
+    if (!backBuffer_ || !dimmed_) {
+        FillRect(hdc, &paintRect, (HBRUSH)GetStockObject(BLACK_BRUSH));
+        return;
     }
 
+    // 常驻的后台缓冲：剪裁到更新区域，底图和所有元素（包括 AlphaBlend）只落在失效的部分，
+    // 其余部分保持上一次的画面
+    HDC hdcMem = backBuffer_->dc();
+    SelectClipRgn(hdcMem, updateRgn);
+
+    // 底图：加暗的背景
+    BitBlt(hdcMem, paintRect.left, paintRect.top, paintWidth, paintHeight,
+           dimmed_->dc(), paintRect.left, paintRect.top, SRCCOPY);
+
     // 根据状态绘制不同的内容
     if (state_ == ScreenshotState::Idle && !isDragging_) {
-        // 空闲状态：绘制全屏蒙版（不排除任何区域）
-        RECT emptyRect = {0, 0, 0, 0};
-        DrawDimmedMask(hdcMem, emptyRect);
-        // 不绘制选择框和控制点
+        // 空闲状态：全屏蒙版，不绘制选择框和控制点
     } else {
-        // 有选择内容：绘制遮罩和选择框
-        RECT excludeRect = selectionRect_;
-        DrawDimmedMask(hdcMem, excludeRect);
+        RECT selection = selectionRect_;
+        NormalizeRect(selection);
+
+        // 选择框内是原始背景
+        RECT clearRect;
+        if (background_ && IntersectRect(&clearRect, &selection, &paintRect)) {
+            BitBlt(hdcMem, clearRect.left, clearRect.top, clearRect.right - clearRect.left,
+                   clearRect.bottom - clearRect.top, background_->dc(), clearRect.left,
+                   clearRect.top, SRCCOPY);
+        }
 
         // 绘制选择框
-        int left = selectionRect_.left;
-        int top = selectionRect_.top;
-        int right = selectionRect_.right;
-        int bottom = selectionRect_.bottom;
+        int left = selection.left;
+        int top = selection.top;
+        int right = selection.right;
+        int bottom = selection.bottom;
 
         // 绘制边框
         HPEN hPen = CreatePen(PS_SOLID, 3, RGB(255, 0, 0));
@@ -462,7 +597,7 @@ void NativeScreenshotWindow::DrawSelection(HDC hdc) {
             SelectObject(hdcMem, hHandleBrush);
 
             for (int i = (int)HandleType::TopLeft; i <= (int)HandleType::LeftCenter; i++) {
-                RECT handleRect = GetHandleRect((HandleType)i, selectionRect_);
+                RECT handleRect = GetHandleRect((HandleType)i, selection);
                 Ellipse(hdcMem, handleRect.left, handleRect.top, handleRect.right, handleRect.bottom);
             }
 
@@ -477,12 +612,8 @@ void NativeScreenshotWindow::DrawSelection(HDC hdc) {
                                     DEFAULT_QUALITY, DEFAULT_PITCH | FF_SWISS, L"Arial");
             HFONT hOldFont = (HFONT)SelectObject(hdcMem, hFont);
 
-            // 计算文本宽度
-            SIZE textSize;
-            GetTextExtentPoint32(hdcMem, text, (int)wcslen(text), &textSize);
-
-            // 文本框在左上角外侧上方
-            RECT textRect = {left - textSize.cx - 10, top - 30, left, top};
+            // 文本框在左上角外侧上方，右对齐；宽度固定，与 InvalidateOverlay 失效的矩形一致
+            RECT textRect = {left - SIZE_LABEL_WIDTH, top - SIZE_LABEL_HEIGHT, left, top};
             SetBkMode(hdcMem, TRANSPARENT);
             SetTextColor(hdcMem, RGB(255, 255, 255));
             DrawText(hdcMem, text, -1, &textRect, DT_RIGHT | DT_VCENTER | DT_SINGLELINE);
@@ -495,59 +626,44 @@ void NativeScreenshotWindow::DrawSelection(HDC hdc) {
         }
     }
 
-    // 始终绘制放大镜（在所有状态下）
-    POINT cursorPos;
-    GetCursorPos(&cursorPos);
-    ScreenToClient(hwnd_, &cursorPos);
-    DrawMagnifier(hdcMem, cursorPos.x, cursorPos.y);
+    // 始终绘制放大镜（在所有状态下），位置取最近一次鼠标事件
+    DrawMagnifier(hdcMem, mousePos_.x, mousePos_.y);
 
-    // 一次性拷贝到屏幕
-    BitBlt(hdc, 0, 0, screenWidth_, screenHeight_, hdcMem, 0, 0, SRCCOPY);
+    SelectClipRgn(hdcMem, NULL);
 
-    SelectObject(hdcMem, hbmOld);
-    DeleteObject(hbmMem);
-    DeleteDC(hdcMem);
+    // 只把失效的部分拷贝到屏幕（hdc 已剪裁到更新区域）
+    BitBlt(hdc, paintRect.left, paintRect.top, paintWidth, paintHeight,
+           hdcMem, paintRect.left, paintRect.top, SRCCOPY);
 }
 
-void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
+RECT NativeScreenshotWindow::GetToolbarRect() {
+    // 工具栏参数（与 DrawButtons 中的相同）
+    const int TOOLBAR_PADDING_H = 12;
+    const int TOOLBAR_PADDING_V = 4;
+    RECT toolbarRect = {confirmButtonRect_.left - TOOLBAR_PADDING_H,
+                        confirmButtonRect_.top - TOOLBAR_PADDING_V,
+                        cancelButtonRect_.right + TOOLBAR_PADDING_H,
+                        cancelButtonRect_.bottom + TOOLBAR_PADDING_V};
+    return toolbarRect;
+}
+
+bool NativeScreenshotWindow::GetMagnifierOrigin(int mouseX, int mouseY, POINT* origin) {
     // 如果鼠标不在窗口内，不绘制
     if (mouseX < 0 || mouseX >= screenWidth_ || mouseY < 0 || mouseY >= screenHeight_) {
-        return;
+        return false;
     }
 
-    // 如果已选择，计算工具栏区域并检查是否悬浮
+    // 如果已选择，鼠标悬浮在工具栏上时不绘制放大镜
+    RECT toolbarRect = {0, 0, 0, 0};
     if (state_ == ScreenshotState::Selected) {
-        // 工具栏参数（与 DrawButtons 中的相同）
-        const int BUTTON_SIZE = 32;
-        const int BUTTON_SPACING = 2;
-        const int TOOLBAR_PADDING_H = 12;
-        const int TOOLBAR_PADDING_V = 4;
-        const int GAP_FROM_SELECTION = 0;
-        int toolbarWidth = BUTTON_SIZE * 2 + BUTTON_SPACING + TOOLBAR_PADDING_H * 2;
-        int toolbarHeight = BUTTON_SIZE + TOOLBAR_PADDING_V * 2;
-
-        // 计算工具栏位置（右下角，紧贴选择框）
-        int toolbarRight = selectionRect_.right;
-        int toolbarLeft = toolbarRight - toolbarWidth;
-        int toolbarTop = selectionRect_.bottom + GAP_FROM_SELECTION;
-
-        // 确保工具栏不超出屏幕左边界
-        if (toolbarLeft < 0) {
-            toolbarLeft = 0;
-            toolbarRight = toolbarWidth;
-        }
-
-        // 工具栏区域
-        RECT toolbarRect = {toolbarLeft, toolbarTop, toolbarRight, toolbarTop + toolbarHeight};
-
-        // 如果鼠标悬浮在工具栏上，不绘制放大镜
+        toolbarRect = GetToolbarRect();
         if (mouseX >= toolbarRect.left && mouseX <= toolbarRect.right &&
             mouseY >= toolbarRect.top && mouseY <= toolbarRect.bottom) {
-            return;
+            return false;
         }
     }
 
-    // 放大镜位置（右上角，偏移20px）
+    // 放大镜位置（右下方，偏移20px）
     int magX = mouseX + 20;
     int magY = mouseY + 20;
 
@@ -561,31 +677,8 @@ void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
 
     // 如果已选择，检查放大镜是否与工具栏冲突
     if (state_ == ScreenshotState::Selected) {
-        const int BUTTON_SIZE = 32;
-        const int BUTTON_SPACING = 2;
-        const int TOOLBAR_PADDING_H = 12;
-        const int TOOLBAR_PADDING_V = 4;
-        const int GAP_FROM_SELECTION = 0;
-        int toolbarWidth = BUTTON_SIZE * 2 + BUTTON_SPACING + TOOLBAR_PADDING_H * 2;
-        int toolbarHeight = BUTTON_SIZE + TOOLBAR_PADDING_V * 2;
-
-        int toolbarRight = selectionRect_.right;
-        int toolbarLeft = toolbarRight - toolbarWidth;
-        int toolbarTop = selectionRect_.bottom + GAP_FROM_SELECTION;
-
-        if (toolbarLeft < 0) {
-            toolbarLeft = 0;
-            toolbarRight = toolbarWidth;
-        }
-
-        RECT toolbarRect = {toolbarLeft, toolbarTop, toolbarRight, toolbarTop + toolbarHeight};
-
-        // 放大镜区域
-        RECT magnifierRect = {magX, magY, magX + MAGNIFIER_SIZE, magY + MAGNIFIER_SIZE};
-
-        // 检查是否冲突
-        bool conflictX = (magnifierRect.right > toolbarRect.left && magnifierRect.left < toolbarRect.right);
-        bool conflictY = (magnifierRect.bottom > toolbarRect.top && magnifierRect.top < toolbarRect.bottom);
+        bool conflictX = (magX + MAGNIFIER_SIZE > toolbarRect.left && magX < toolbarRect.right);
+        bool conflictY = (magY + MAGNIFIER_SIZE > toolbarRect.top && magY < toolbarRect.bottom);
 
         if (conflictX && conflictY) {
             // 调整放大镜位置到左侧或上方
@@ -597,6 +690,19 @@ void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
         }
     }
 
+    origin->x = magX;
+    origin->y = magY;
+    return true;
+}
+
+void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
+    POINT origin;
+    if (!GetMagnifierOrigin(mouseX, mouseY, &origin)) {
+        return;
+    }
+    int magX = origin.x;
+    int magY = origin.y;
+
     // 放大镜圆角半径（小圆角）
     const int CORNER_RADIUS = 8;
 
@@ -633,7 +739,9 @@ void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
     // 创建圆角矩形区域用于裁剪
     HRGN hRgn = CreateRoundRectRgn(magRect.left, magRect.top, magRect.right, magRect.bottom,
                                    CORNER_RADIUS, CORNER_RADIUS);
-    SelectClipRgn(hdc, hRgn);
+    // 与调用方的剪裁区域（WM_PAINT 的更新区域）取交集，画完后恢复
+    int savedDC = SaveDC(hdc);
+    ExtSelectClipRgn(hdc, hRgn, RGN_AND);
 
     HBRUSH hBgBrush = CreateSolidBrush(RGB(255, 255, 255));
     FillRect(hdc, &magRect, hBgBrush);
@@ -651,36 +759,22 @@ void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
 
     // 获取鼠标位置的像素颜色
     COLORREF pixelColor = 0;
-    if (hBackgroundBitmap_) {
-        HDC hdcBg = CreateCompatibleDC(hdc);
-        HBITMAP hbmBgOld = (HBITMAP)SelectObject(hdcBg, hBackgroundBitmap_);
-        pixelColor = GetPixel(hdcBg, mouseX, mouseY);
-        SelectObject(hdcBg, hbmBgOld);
-        DeleteDC(hdcBg);
+    if (background_) {
+        pixelColor = GetPixel(background_->dc(), mouseX, mouseY);
     }
 
-    // 重新应用圆角裁剪（用于内容绘制）
-    HRGN hContentRgn = CreateRoundRectRgn(magRect.left, magRect.top, magRect.right, magRect.bottom,
-                                         CORNER_RADIUS, CORNER_RADIUS);
-    SelectClipRgn(hdc, hContentRgn);
-    ExtSelectClipRgn(hdc, NULL, RGN_AND); // 确保裁剪生效
-
+    // 放大的内容沿用上面的圆角裁剪
     // 计算放大区域的源矩形
     int zoomHalfSize = MAGNIFIER_SIZE / (2 * MAGNIFIER_ZOOM);
     int srcX = mouseX - zoomHalfSize;
     int srcY = mouseY - zoomHalfSize;
 
     // 绘制放大的内容
-    if (hBackgroundBitmap_) {
-        HDC hdcBg = CreateCompatibleDC(hdc);
-        HBITMAP hbmBgOld = (HBITMAP)SelectObject(hdcBg, hBackgroundBitmap_);
-
+    if (background_) {
         StretchBlt(hdc, magX, magY, MAGNIFIER_SIZE, MAGNIFIER_SIZE,
-                   hdcBg, srcX, srcY, MAGNIFIER_SIZE / MAGNIFIER_ZOOM, MAGNIFIER_SIZE / MAGNIFIER_ZOOM,
+                   background_->dc(), srcX, srcY,
+                   MAGNIFIER_SIZE / MAGNIFIER_ZOOM, MAGNIFIER_SIZE / MAGNIFIER_ZOOM,
                    SRCCOPY);
-
-        SelectObject(hdcBg, hbmBgOld);
-        DeleteDC(hdcBg);
     }
 
     // 绘制中心十字
@@ -694,8 +788,8 @@ void NativeScreenshotWindow::DrawMagnifier(HDC hdc, int mouseX, int mouseY) {
     DeleteObject(hCrossPen);
 
     // 恢复裁剪区域（取消圆角裁剪）
-    SelectClipRgn(hdc, NULL);
-    DeleteObject(hContentRgn);
+    RestoreDC(hdc, savedDC);
+    DeleteObject(hRgn);
 
     // 绘制RGB值（在放大镜下方，分两行显示）
     int r = GetRValue(pixelColor);
@@ -754,17 +848,10 @@ void NativeScreenshotWindow::DrawButtons(HDC hdc) {
     const int BUTTON_SIZE = 32;
     const int BUTTON_SPACING = 2;
     const int TOOLBAR_PADDING_H = 12;
-    const int TOOLBAR_PADDING_V = 4;
-    const int GAP_FROM_SELECTION = 0;
-    (void)GAP_FROM_SELECTION;  // 标记为故意未使用（预留功能）
     int toolbarWidth = BUTTON_SIZE * 2 + BUTTON_SPACING + TOOLBAR_PADDING_H * 2;
 
     // 计算工具栏区域
-    RECT toolbarRect;
-    toolbarRect.left = confirmButtonRect_.left - TOOLBAR_PADDING_H;
-    toolbarRect.top = confirmButtonRect_.top - TOOLBAR_PADDING_V;
-    toolbarRect.right = cancelButtonRect_.right + TOOLBAR_PADDING_H;
-    toolbarRect.bottom = cancelButtonRect_.bottom + TOOLBAR_PADDING_V;
+    RECT toolbarRect = GetToolbarRect();
 
     // 绘制工具栏背景（黑色半透明，极简风格）
     const int CORNER_RADIUS = 3; // 更小的圆角
@@ -818,85 +905,143 @@ void NativeScreenshotWindow::DrawButtons(HDC hdc) {
     DeleteObject(hFont);
 }
 
-void NativeScreenshotWindow::DrawDimmedMask(HDC hdc, const RECT& excludeRect) {
-    BLENDFUNCTION blend = { AC_SRC_OVER, 0, 160, 0 };
-
-    auto drawDimmedRegion = [&](const RECT& rect) {
-        if (rect.left >= rect.right || rect.top >= rect.bottom) {
-            return;
-        }
-
-        int width = rect.right - rect.left;
-        int height = rect.bottom - rect.top;
+void NativeScreenshotWindow::InvalidateOverlay() {
+    // 蒙版上的元素，id 在帧之间不变
+    enum : uint32_t {
+        kHoleLayer,
+        kTopEdgeLayer,
+        kBottomEdgeLayer,
+        kLeftEdgeLayer,
+        kRightEdgeLayer,
+        kSizeLabelLayer,
+        kToolbarLayer,
+        kMagnifierLayer,
+        kFirstHandleLayer,
+    };
 
-        HDC hdcDim = CreateCompatibleDC(hdc);
-        HBITMAP hbmDim = CreateCompatibleBitmap(hdc, width, height);
-        HBITMAP hbmDimOld = (HBITMAP)SelectObject(hdcDim, hbmDim);
+    if (state_ != ScreenshotState::Idle || isDragging_) {
+        RECT selection = selectionRect_;
+        NormalizeRect(selection);
+        const capture_core::Rect s(selection.left, selection.top,
+                                   selection.right - selection.left,
+                                   selection.bottom - selection.top);
+        // 选择框内外只是底图不同，移动时只重画新旧矩形的对称差
+        damage_.SetHole(kHoleLayer, s);
+
+        // 3px 的边框以边为中心，虚线和实线样式不同
+        const uint64_t dashed = state_ == ScreenshotState::Hovering && !isDragging_;
+        damage_.SetLayer(kTopEdgeLayer, capture_core::Rect(s.x - 2, s.y - 2, s.width + 4, 4), dashed);
+        damage_.SetLayer(kBottomEdgeLayer,
+                         capture_core::Rect(s.x - 2, s.bottom() - 2, s.width + 4, 4), dashed);
+        damage_.SetLayer(kLeftEdgeLayer, capture_core::Rect(s.x - 2, s.y - 2, 4, s.height + 4), dashed);
+        damage_.SetLayer(kRightEdgeLayer,
+                         capture_core::Rect(s.right() - 2, s.y - 2, 4, s.height + 4), dashed);
 
-        HBRUSH hBrush = CreateSolidBrush(RGB(0, 0, 0));
-        RECT fillRect = {0, 0, width, height};
-        FillRect(hdcDim, &fillRect, hBrush);
-        DeleteObject(hBrush);
+        if (state_ == ScreenshotState::Selected) {
+            for (int i = (int)HandleType::TopLeft; i <= (int)HandleType::LeftCenter; i++) {
+                RECT handleRect = GetHandleRect((HandleType)i, selection);
+                damage_.SetLayer(kFirstHandleLayer + i,
+                                 capture_core::Rect(handleRect.left - 1, handleRect.top - 1,
+                                                    handleRect.right - handleRect.left + 2,
+                                                    handleRect.bottom - handleRect.top + 2));
+            }
+            // 文字随尺寸变化
+            damage_.SetLayer(kSizeLabelLayer,
+                             capture_core::Rect(s.x - SIZE_LABEL_WIDTH, s.y - SIZE_LABEL_HEIGHT,
+                                                SIZE_LABEL_WIDTH, SIZE_LABEL_HEIGHT),
+                             (static_cast<uint64_t>(s.width) << 32) | static_cast<uint32_t>(s.height));
+            RECT toolbarRect = GetToolbarRect();
+            damage_.SetLayer(kToolbarLayer,
+                             capture_core::Rect(toolbarRect.left, toolbarRect.top,
+                                                toolbarRect.right - toolbarRect.left,
+                                                toolbarRect.bottom - toolbarRect.top),
+                             (isHoveringConfirm_ ? 1 : 0) | (isHoveringCancel_ ? 2 : 0));
+        }
+    }
 
-        AlphaBlend(hdc, rect.left, rect.top, width, height,
-                   hdcDim, 0, 0, width, height, blend);
+    // 放大镜（含右下的阴影和下方两行颜色值）的内容随鼠标位置变化
+    POINT origin;
+    if (GetMagnifierOrigin(mousePos_.x, mousePos_.y, &origin)) {
+        damage_.SetLayer(kMagnifierLayer,
+                         capture_core::Rect(origin.x - 1, origin.y - 1, MAGNIFIER_SIZE + 5,
+                                            MAGNIFIER_SIZE + 42),
+                         (static_cast<uint64_t>(static_cast<uint32_t>(mousePos_.x)) << 32) |
+                             static_cast<uint32_t>(mousePos_.y));
+    }
 
-        SelectObject(hdcDim, hbmDimOld);
-        DeleteObject(hbmDim);
-        DeleteDC(hdcDim);
-    };
+    for (const capture_core::Rect& rect : damage_.Commit()) {
+        RECT dirty = {rect.x, rect.y, rect.right(), rect.bottom()};
+        InvalidateRect(hwnd_, &dirty, FALSE);
+    }
+}
 
-    // 四个遮罩区域
-    RECT topRect = {0, 0, screenWidth_, excludeRect.top};
-    RECT bottomRect = {0, excludeRect.bottom, screenWidth_, screenHeight_};
-    RECT leftRect = {0, excludeRect.top, excludeRect.left, excludeRect.bottom};
-    RECT rightRect = {excludeRect.right, excludeRect.top, screenWidth_, excludeRect.bottom};
+bool NativeScreenshotWindow::PrepareBuffers() {
+    capture_core::Rect desktop(screenLeft_, screenTop_, screenWidth_, screenHeight_);
+    dimmed_ = DibSectionPool::Shared().Acquire(desktop);
+    backBuffer_ = DibSectionPool::Shared().Acquire(desktop);
+    if (!dimmed_ || !backBuffer_ || !background_) {
+        DibSectionPool::Shared().Release(std::move(dimmed_));
+        DibSectionPool::Shared().Release(std::move(backBuffer_));
+        return false;
+    }
 
-    drawDimmedRegion(topRect);
-    drawDimmedRegion(bottomRect);
-    drawDimmedRegion(leftRect);
-    drawDimmedRegion(rightRect);
+    // 蒙版底图只算一次：与原来每次重画的 AlphaBlend（黑色，不透明度 160/255）相同，
+    // 每个通道乘以 95/255
+    uint8_t scale[256];
+    for (int i = 0; i < 256; i++) {
+        scale[i] = static_cast<uint8_t>((i * (255 - 160) + 127) / 255);
+    }
+    GdiFlush();
+    for (int y = 0; y < screenHeight_; y++) {
+        const uint8_t* src = background_->bits() + static_cast<size_t>(y) * background_->stride();
+        uint8_t* dst = dimmed_->bits() + static_cast<size_t>(y) * dimmed_->stride();
+        for (int x = 0; x < screenWidth_ * 4; x++) {
+            dst[x] = scale[src[x]];
+        }
+    }
+    return true;
 }
 
 bool NativeScreenshotWindow::CaptureDesktopBackground() {
     LOG_DEBUG("Capturing desktop background...");
 
-    HDC hdcDesktop = GetDC(NULL);
-    if (!hdcDesktop) {
-        LOG_DEBUG("Failed to get desktop DC");
+    // 背景直接截进 DIB section：绘制时当作源 DC，确认后原样交给 FrozenFrameStore
+    capture_core::Rect desktop(screenLeft_, screenTop_, screenWidth_, screenHeight_);
+    background_ = DibSectionPool::Shared().Acquire(desktop);
+    if (!background_) {
+        LOG_DEBUG("Failed to create background bitmap");
         return false;
     }
 
-    HDC hdcMem = CreateCompatibleDC(hdcDesktop);
-    if (!hdcMem) {
-        LOG_DEBUG("Failed to create memory DC");
-        ReleaseDC(NULL, hdcDesktop);
-        return false;
+    // 各显示器并行抓取，直接拼接进 DIB section 的内存
+    capture_core::FrameBuffer frame;
+    frame.Wrap(background_->bits(), screenWidth_, screenHeight_, background_->stride(),
+               capture_core::PixelFormat::kBgrx8);
+    capture_core::Rect bounds;
+    if (CaptureVirtualDesktopFrame(&frame, &bounds, nullptr) && bounds == desktop &&
+        frame.data() == background_->bits()) {
+        LOG_DEBUG("Desktop background captured successfully");
+        return true;
     }
 
-    hBackgroundBitmap_ = CreateCompatibleBitmap(hdcDesktop, screenWidth_, screenHeight_);
-    if (!hBackgroundBitmap_) {
-        LOG_DEBUG("Failed to create background bitmap");
-        DeleteDC(hdcMem);
-        ReleaseDC(NULL, hdcDesktop);
+    // 显示器布局在两次枚举之间变化时，整块 BitBlt 虚拟桌面
+    LOG_DEBUG("Per-monitor capture failed, falling back to a single BitBlt");
+    HDC hdcDesktop = GetDC(NULL);
+    if (!hdcDesktop) {
+        LOG_DEBUG("Failed to get desktop DC");
+        DibSectionPool::Shared().Release(std::move(background_));
         return false;
     }
 
-    HBITMAP hbmOld = (HBITMAP)SelectObject(hdcMem, hBackgroundBitmap_);
-
-    if (!BitBlt(hdcMem, 0, 0, screenWidth_, screenHeight_, hdcDesktop, 0, 0, SRCCOPY)) {
+    BOOL blitted = BitBlt(background_->dc(), 0, 0, screenWidth_, screenHeight_,
+                          hdcDesktop, screenLeft_, screenTop_, SRCCOPY);
+    ReleaseDC(NULL, hdcDesktop);
+    if (!blitted) {
         LOG_DEBUG("Failed to capture screen");
-        SelectObject(hdcMem, hbmOld);
-        DeleteObject(hBackgroundBitmap_);
-        hBackgroundBitmap_ = NULL;
-        DeleteDC(hdcMem);
-        ReleaseDC(NULL, hdcDesktop);
+        DibSectionPool::Shared().Release(std::move(background_));
         return false;
     }
-
-    SelectObject(hdcMem, hbmOld);
-    DeleteDC(hdcMem);
-    ReleaseDC(NULL, hdcDesktop);
+    GdiFlush();
 
     LOG_DEBUG("Desktop background captured successfully");
     return true;
@@ -1041,36 +1186,33 @@ void NativeScreenshotWindow::UpdateSelectionFromDrag(int x, int y) {
     NormalizeRect(selectionRect_);
 }
 
-void NativeScreenshotWindow::DetectWindowAtPoint(POINT pt, RECT& windowRect) {
-    HWND hwnd = WindowFromPoint(pt);
-    if (!hwnd || hwnd == hwnd_) {
-        windowRect = {0, 0, 0, 0};
-        hHoveredWindow_ = NULL;
-        return;
-    }
-
-    // 获取窗口矩形
-    GetWindowRect(hwnd, &windowRect);
-
-    // 排除过小的窗口
-    int width = windowRect.right - windowRect.left;
-    int height = windowRect.bottom - windowRect.top;
+void NativeScreenshotWindow::SnapshotWindowRects() {
+    // 快照使用客户区坐标，查询时不用再换算
+    windowRects_.Reset(capture_core::Rect(0, 0, screenWidth_, screenHeight_));
+    WindowSnapshot snapshot;
+    snapshot.index = &windowRects_;
+    snapshot.overlay = hwnd_;
+    snapshot.originX = screenLeft_;
+    snapshot.originY = screenTop_;
+    // EnumWindows 按 z 序从上到下
+    EnumWindows(SnapshotWindowProc, reinterpret_cast<LPARAM>(&snapshot));
+    LOG_DEBUG_FMT("Window snapshot: %u rects, max %u per cell",
+                  static_cast<unsigned>(windowRects_.size()),
+                  static_cast<unsigned>(windowRects_.max_cell_entries()));
+}
 
-    if (width < 50 || height < 50) {
+void NativeScreenshotWindow::DetectWindowAtPoint(POINT pt, RECT& windowRect) {
+    // pt 为客户区坐标；取点所在的最上层窗口里最内层的子控件
+    int index = windowRects_.DeepestAt(pt.x, pt.y);
+    if (index < 0) {
         windowRect = {0, 0, 0, 0};
         hHoveredWindow_ = NULL;
         return;
     }
 
-    // 转换为屏幕坐标
-    RECT screenRect;
-    screenRect.left = windowRect.left;
-    screenRect.top = windowRect.top;
-    screenRect.right = windowRect.right;
-    screenRect.bottom = windowRect.bottom;
-
-    windowRect = screenRect;
-    hHoveredWindow_ = hwnd;
+    const capture_core::WindowRectEntry& entry = windowRects_.entry(index);
+    windowRect = {entry.rect.x, entry.rect.y, entry.rect.right(), entry.rect.bottom()};
+    hHoveredWindow_ = reinterpret_cast<HWND>(static_cast<uintptr_t>(entry.id));
 }
 
 void NativeScreenshotWindow::NormalizeRect(RECT& rect) {
@@ -7,6 +7,12 @@
 
 #include <windows.h>
 
+#include <memory>
+
+#include "capture_core/damage_tracker.h"
+#include "capture_core/window_rect_index.h"
+#include "dib_section_pool.h"
+
 // 窗口状态枚举
 enum class ScreenshotState {
     Idle,           // 初始状态，全屏蒙版
@@ -58,8 +64,18 @@ private:
     static const int MAGNIFIER_SIZE = 150;
     static const int MAGNIFIER_ZOOM = 4;
 
-    // 背景
-    HBITMAP hBackgroundBitmap_;
+    // 背景：显示前截下的整屏画面，确认选择后交给 FrozenFrameStore 供裁剪
+    std::unique_ptr<DibSection> background_;
+    // 加暗的背景（蒙版底图，显示前算好一次）和常驻的后台缓冲；
+    // 鼠标事件只让变化的元素失效（damage_），WM_PAINT 只在后台缓冲里重画更新区域
+    std::unique_ptr<DibSection> dimmed_;
+    std::unique_ptr<DibSection> backBuffer_;
+    capture_core::DamageTracker damage_;
+    // 最近一次鼠标事件的客户区坐标，放大镜按它绘制，与失效的矩形一致
+    POINT mousePos_;
+    // 窗口覆盖整个虚拟桌面；客户区坐标 + (screenLeft_, screenTop_) = 屏幕坐标
+    int screenLeft_;
+    int screenTop_;
     int screenWidth_;
     int screenHeight_;
 
@@ -69,7 +85,9 @@ private:
     bool isHoveringConfirm_;
     bool isHoveringCancel_;
 
-    // 悬停检测
+    // 悬停检测：显示蒙版前（与背景同时）记录的顶层窗口和子控件矩形（客户区坐标），
+    // 鼠标移动时只在内存中查询
+    capture_core::WindowRectIndex windowRects_;
     HWND hHoveredWindow_;
 
     // 静态回调
@@ -77,13 +95,17 @@ private:
     LRESULT HandleMessage(UINT msg, WPARAM wParam, LPARAM lParam);
 
     // 绘制方法
-    void DrawSelection(HDC hdc);
+    void DrawSelection(HDC hdc, const RECT& paintRect, HRGN updateRgn);
     void DrawMagnifier(HDC hdc, int mouseX, int mouseY);
     void DrawButtons(HDC hdc);
-    void DrawDimmedMask(HDC hdc, const RECT& excludeRect);
+    void InvalidateOverlay();
 
     // 辅助方法
     bool CaptureDesktopBackground();
+    bool PrepareBuffers();
+    RECT GetToolbarRect();
+    bool GetMagnifierOrigin(int mouseX, int mouseY, POINT* origin);
+    void SnapshotWindowRects();
     HandleType HitTest(int x, int y);
     RECT GetHandleRect(HandleType handle, const RECT& rect);
     HCURSOR GetHandleCursor(HandleType handle);
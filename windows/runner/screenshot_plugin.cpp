@@ -3,6 +3,21 @@
 #include <shellapi.h>
 #include <comdef.h>
 
+#include <map>
+#include <mutex>
+
+#include "capture_core/batch_capture.h"
+#include "capture_core/capture_pipeline.h"
+#include "capture_core/frozen_frame_source.h"
+#include "capture_core/jpeg_encoder.h"
+#include "capture_core/multi_monitor_capture.h"
+#include "capture_core/png_encoder.h"
+#include "capture_core/qoi_codec.h"
+#include "frozen_frame_store.h"
+#include "gdi_frame_source.h"
+#include "monitor_capture.h"
+#include "window_info_cache.h"
+
 #pragma comment(lib, "gdiplus.lib")
 #pragma comment(lib, "shell32.lib")
 
@@ -22,18 +37,56 @@ void ShutdownGDIPlus() {
     GdiplusShutdown(gdiplusToken);
 }
 
-// Callback function for enumerating windows
-BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
-    auto* windows = reinterpret_cast<std::vector<WindowInfo>*>(lParam);
+// 每个截图工作线程每种格式一个编码器，过滤缓冲、z_stream 和 JPEG 条带在调用之间复用
+static capture_core::FrameEncoder& WorkerEncoder(const capture_core::EncodeOptions& options) {
+    thread_local capture_core::PngEncoder png;
+    thread_local capture_core::JpegEncoder jpeg;
+    thread_local capture_core::QoiEncoder qoi;
+    if (options.format == capture_core::ImageFormat::kJpeg) {
+        jpeg.set_quality(options.quality);
+        return jpeg;
+    }
+    if (options.format == capture_core::ImageFormat::kQoi) {
+        return qoi;
+    }
+    return png;
+}
+
+// 所有截图共用的流水线：FrameSource -> FrameBuffer -> PNG / JPEG
+static std::vector<uint8_t> EncodeFromSource(capture_core::FrameSource* source,
+                                             const capture_core::Rect& region,
+                                             const capture_core::EncodeOptions& options) {
+    capture_core::CapturePipeline pipeline(source, &WorkerEncoder(options));
+
+    std::vector<uint8_t> result;
+    if (!pipeline.CaptureRegion(region, &result)) {
+        result.clear();
+    }
+    return result;
+}
+
+// 两阶段截图：只捕获，把像素拷出来源（来源的 DIB section 析构时归还缓冲池）
+static bool CopyFromSource(capture_core::FrameSource* source, const capture_core::Rect& region,
+                           capture_core::FrameBuffer* frame) {
+    capture_core::CapturePipeline pipeline(source, nullptr);
+    if (!pipeline.CaptureFrame(region)) {
+        frame->Reset();
+        return false;
+    }
+    frame->CopyFrom(pipeline.frame());
+    return !frame->empty();
+}
 
+// Describe a top-level window for the window picker
+bool DescribeWindow(HWND hwnd, WindowInfo* info) {
     // Skip invisible windows
     if (!IsWindowVisible(hwnd)) {
-        return TRUE;
+        return false;
     }
 
     // Skip minimized windows
     if (IsIconic(hwnd)) {
-        return TRUE;
+        return false;
     }
 
     // Get window title
@@ -42,7 +95,7 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
 
     // Skip windows without titles
     if (wcslen(title) == 0) {
-        return TRUE;
+        return false;
     }
 
     // 清理窗口标题：移除所有特殊字符
@@ -72,7 +125,7 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
 
     // 再次检查标题是否为空（清理后可能变空）
     if (wcslen(title) == 0) {
-      return TRUE;
+      return false;
     }
 
 
@@ -86,7 +139,7 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
         wcscmp(className, L"WorkerW") == 0 ||         // Desktop background
         wcscmp(className, L"DV2ControlHost") == 0 ||  // Some overlay windows
         wcscmp(className, L"MsgrSinkWindowClass") == 0) {  // Messenger windows
-        return TRUE;
+        return false;
     }
 
     // Check if window has a reasonable size (too small windows are usually UI elements)
@@ -96,7 +149,7 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
     int height = rect.bottom - rect.top;
 
     if (width < 100 || height < 50) {
-        return TRUE;
+        return false;
     }
 
     // Get window ID as string
@@ -108,37 +161,14 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
     std::string titleUtf8(titleUtf8Len, 0);
     WideCharToMultiByte(CP_UTF8, 0, title, -1, &titleUtf8[0], titleUtf8Len, NULL, NULL);
 
-    // Get application name from class name or process
+    // Get application name and icon (cached by process / icon handle)
+    WindowInfoCache& cache = WindowInfoCache::Shared();
     std::string appName;
+    std::wstring imagePath;
     DWORD processId = 0;
     GetWindowThreadProcessId(hwnd, &processId);
-    if (processId != 0) {
-        HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
-        if (hProcess != NULL) {
-            WCHAR processName[MAX_PATH];
-            DWORD size = MAX_PATH;
-            if (QueryFullProcessImageNameW(hProcess, 0, processName, &size)) {
-                // Extract just the filename without extension
-                std::wstring processPath = processName;
-                size_t lastSlash = processPath.find_last_of(L"\\/");
-                if (lastSlash != std::wstring::npos) {
-                    std::wstring fileName = processPath.substr(lastSlash + 1);
-                    size_t dotPos = fileName.find_last_of(L'.');
-                    if (dotPos != std::wstring::npos) {
-                        fileName = fileName.substr(0, dotPos);
-                    }
-                    // Convert to UTF-8
-                    int nameLen = WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, NULL, 0, NULL, NULL);
-                    appName.resize(nameLen, 0);
-                    WideCharToMultiByte(CP_UTF8, 0, fileName.c_str(), -1, &appName[0], nameLen, NULL, NULL);
-                }
-            }
-            CloseHandle(hProcess);
-        }
-    }
+    cache.LookupProcess(processId, &appName, &imagePath);
 
-    // Get window icon
-    std::vector<uint8_t> iconData;
     HICON hIcon = (HICON)SendMessage(hwnd, WM_GETICON, ICON_SMALL, 0);
     if (hIcon == NULL) {
         hIcon = (HICON)GetClassLongPtr(hwnd, GCLP_HICONSM);
@@ -149,153 +179,38 @@ BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
     if (hIcon == NULL) {
         hIcon = (HICON)GetClassLongPtr(hwnd, GCLP_HICON);
     }
-
-    if (hIcon != NULL) {
-        // Extract icon to PNG
-        ICONINFO iconInfo;
-        if (GetIconInfo(hIcon, &iconInfo)) {
-            BITMAP bm;
-            GetObject(iconInfo.hbmColor, sizeof(BITMAP), &bm);
-
-            // Create GDI+ bitmap from icon
-            Bitmap* gdiBitmap = Bitmap::FromHICON(hIcon);
-            if (gdiBitmap != nullptr) {
-                // Create IStream
-                IStream* stream = NULL;
-                CreateStreamOnHGlobal(NULL, TRUE, &stream);
-
-                // Save to PNG format
-                CLSID pngClsid;
-                if (GetEncoderClsid(L"image/png", &pngClsid) >= 0) {
-                    Gdiplus::Status status = gdiBitmap->Save(stream, &pngClsid);
-                    if (status == Gdiplus::Ok) {
-                        // Get stream size
-                        STATSTG statstg;
-                        stream->Stat(&statstg, STATFLAG_NONAME);
-
-                        // Read stream data
-                        LARGE_INTEGER pos;
-                        pos.QuadPart = 0;
-                        stream->Seek(pos, STREAM_SEEK_SET, NULL);
-
-                        iconData.resize(statstg.cbSize.LowPart);
-                        ULONG bytesRead;
-                        stream->Read(iconData.data(), statstg.cbSize.LowPart, &bytesRead);
-                    }
-                }
-
-                stream->Release();
-                delete gdiBitmap;
-            }
-
-            if (iconInfo.hbmColor != NULL) DeleteObject(iconInfo.hbmColor);
-            if (iconInfo.hbmMask != NULL) DeleteObject(iconInfo.hbmMask);
-        }
-    }
+    std::vector<uint8_t> iconData = cache.Icon(processId, imagePath, hIcon);
 
     // Store window info
-    WindowInfo info;
-    info.title = titleUtf8;
-    info.id = std::string(windowId);
-    info.appName = appName;
-    info.icon = iconData;
-    windows->push_back(info);
+    info->title = titleUtf8;
+    info->id = std::string(windowId);
+    info->appName = std::move(appName);
+    info->icon = std::move(iconData);
+    info->x = rect.left;
+    info->y = rect.top;
+    info->width = width;
+    info->height = height;
+    return true;
+}
 
+// Callback function for enumerating windows
+BOOL CALLBACK EnumWindowsProc(HWND hwnd, LPARAM lParam) {
+    auto* windows = reinterpret_cast<std::vector<WindowInfo>*>(lParam);
+    WindowInfo info;
+    if (DescribeWindow(hwnd, &info)) {
+        windows->push_back(std::move(info));
+    }
     return TRUE;
 }
 
 // Capture full screen
-std::vector<uint8_t> CaptureFullScreen() {
-    // Get screen dimensions
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-
-    // Create device context
-    HDC hdcScreen = GetDC(NULL);
-    HDC hdcMem = CreateCompatibleDC(hdcScreen);
-
-    // Create bitmap
-    HBITMAP hBitmap = CreateCompatibleBitmap(hdcScreen, screenWidth, screenHeight);
-    HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
-
-    // Copy screen to bitmap
-    BitBlt(hdcMem, 0, 0, screenWidth, screenHeight, hdcScreen, 0, 0, SRCCOPY);
-
-    // Select old bitmap back
-    SelectObject(hdcMem, hOldBitmap);
-
-    // Convert to GDI+ bitmap - use Bitmap constructor with width, height, and pixel data
-    BITMAP bitmapInfo;
-    GetObject(hBitmap, sizeof(BITMAP), &bitmapInfo);
-
-    Bitmap* gdiBitmap = new Bitmap(bitmapInfo.bmWidth, bitmapInfo.bmHeight, PixelFormat32bppARGB);
-
-    // Get bitmap data
-    BitmapData bitmapData;
-    Rect rect(0, 0, bitmapInfo.bmWidth, bitmapInfo.bmHeight);
-    Gdiplus::Status status = gdiBitmap->LockBits(&rect, ImageLockModeWrite, PixelFormat32bppARGB, &bitmapData);
-
-    if (status == Gdiplus::Ok) {
-        // Get the bitmap bits from the HBITMAP
-        BYTE* pBits = (BYTE*)bitmapInfo.bmBits;
-        if (pBits == NULL) {
-            // If bmBits is NULL, we need to use GetDIBits
-            BITMAPINFO bmi = {};
-            bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-            bmi.bmiHeader.biWidth = bitmapInfo.bmWidth;
-            bmi.bmiHeader.biHeight = -bitmapInfo.bmHeight;  // Negative for top-down DIB
-            bmi.bmiHeader.biPlanes = 1;
-            bmi.bmiHeader.biBitCount = 32;
-            bmi.bmiHeader.biCompression = BI_RGB;
-
-            GetDIBits(hdcScreen, hBitmap, 0, bitmapInfo.bmHeight,
-                     (BYTE*)bitmapData.Scan0, &bmi, DIB_RGB_COLORS);
-        } else {
-            // Copy the bitmap data
-            memcpy(bitmapData.Scan0, pBits, bitmapData.Stride * bitmapInfo.bmHeight);
-        }
-
-        gdiBitmap->UnlockBits(&bitmapData);
-    }
-
-    // Create IStream
-    IStream* stream = NULL;
-    CreateStreamOnHGlobal(NULL, TRUE, &stream);
-
-    // Save to PNG format
-    CLSID pngClsid;
-    GetEncoderClsid(L"image/png", &pngClsid);
-    status = gdiBitmap->Save(stream, &pngClsid);
-
-    std::vector<uint8_t> result;
-
-    if (status == Gdiplus::Ok) {
-        // Get stream size
-        STATSTG statstg;
-        stream->Stat(&statstg, STATFLAG_NONAME);
-
-        // Read stream data
-        LARGE_INTEGER pos;
-        pos.QuadPart = 0;
-        stream->Seek(pos, STREAM_SEEK_SET, NULL);
-
-        result.resize(statstg.cbSize.LowPart);
-        ULONG bytesRead;
-        stream->Read(result.data(), statstg.cbSize.LowPart, &bytesRead);
-    }
-
-    // Cleanup
-    stream->Release();
-    delete gdiBitmap;
-    DeleteObject(hBitmap);
-    DeleteDC(hdcMem);
-    ReleaseDC(NULL, hdcScreen);
-
-    return result;
+std::vector<uint8_t> CaptureFullScreen(const capture_core::EncodeOptions& options) {
+    GdiScreenSource source;
+    return EncodeFromSource(&source, source.GetPrimaryBounds(), options);
 }
 
-// Helper function to get encoder CLSID
-int GetEncoderClsid(const WCHAR* format, CLSID* pClsid) {
+// 枚举 GDI+ 编码器查找 CLSID（未缓存）
+static int FindEncoderClsid(const WCHAR* format, CLSID* pClsid) {
     UINT  num = 0;          // number of image encoders
     UINT  size = 0;         // size of the image encoder array in bytes
 
@@ -323,243 +238,166 @@ int GetEncoderClsid(const WCHAR* format, CLSID* pClsid) {
     return -1;  // Failure
 }
 
-// Capture specific window
-std::vector<uint8_t> CaptureWindow(HWND hwnd) {
-    // Check if window is valid
-    if (!IsWindow(hwnd)) {
-        return std::vector<uint8_t>();
+// Helper function to get encoder CLSID
+// 编码器列表在进程内不会变化，按 MIME 类型缓存查找结果，避免每次都枚举并分配内存
+int GetEncoderClsid(const WCHAR* format, CLSID* pClsid) {
+    struct CachedEncoder {
+        int index;
+        CLSID clsid;
+    };
+    static std::mutex cacheMutex;
+    static std::map<std::wstring, CachedEncoder> cache;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(format);
+    if (it != cache.end()) {
+        *pClsid = it->second.clsid;
+        return it->second.index;
     }
 
-    // Get window dimensions
-    RECT rect;
-    GetWindowRect(hwnd, &rect);
-    int width = rect.right - rect.left;
-    int height = rect.bottom - rect.top;
+    int index = FindEncoderClsid(format, pClsid);
+    if (index >= 0) {
+        cache[format] = CachedEncoder{index, *pClsid};
+    }
+    return index;
+}
 
-    // Validate dimensions
-    if (width <= 0 || height <= 0) {
+// Capture specific window
+std::vector<uint8_t> CaptureWindow(HWND hwnd, const capture_core::EncodeOptions& options) {
+    // Check if window is valid
+    if (!IsWindow(hwnd)) {
         return std::vector<uint8_t>();
     }
 
-    // Create device contexts
-    HDC hdcScreen = GetDC(NULL);
-    HDC hdcMem = CreateCompatibleDC(hdcScreen);
-
-    // Create bitmap
-    HBITMAP hBitmap = CreateCompatibleBitmap(hdcScreen, width, height);
-    HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
-
-    // Fill background with white (not black)
-    RECT bgRect = {0, 0, width, height};
-    FillRect(hdcMem, &bgRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
-
-    // Method 1: Try PrintWindow with different flags
-    BOOL success = FALSE;
-
-    // Try PW_RENDERFULLCONTENT (for Windows 8.1+, captures hardware-accelerated content)
-    #ifdef PW_RENDERFULLCONTENT
-    success = PrintWindow(hwnd, hdcMem, PW_RENDERFULLCONTENT);
-    #endif
+    GdiWindowSource source(hwnd);
+    return EncodeFromSource(&source, source.GetBounds(), options);
+}
 
-    // Try standard PrintWindow if PW_RENDERFULLCONTENT failed or not available
-    if (!success) {
-        success = PrintWindow(hwnd, hdcMem, 0);
-    }
+// Capture screen region
+std::vector<uint8_t> CaptureRegion(int x, int y, int width, int height,
+                                   const capture_core::EncodeOptions& options) {
+    GdiScreenSource source;
+    return EncodeFromSource(&source, capture_core::Rect(x, y, width, height), options);
+}
 
-    // Method 2: If PrintWindow failed, use window DC
-    if (!success) {
-        HDC hdcWindow = GetWindowDC(hwnd);
-        if (hdcWindow != NULL) {
-            // Get client area dimensions
-            RECT clientRect;
-            GetClientRect(hwnd, &clientRect);
-
-            // Center the client area in the bitmap
-            int clientWidth = clientRect.right - clientRect.left;
-            int clientHeight = clientRect.bottom - clientRect.top;
-            int offsetX = (width - clientWidth) / 2;
-            int offsetY = (height - clientHeight) / 2;
-
-            // Clear the bitmap area first
-            RECT clearRect = {0, 0, width, height};
-            FillRect(hdcMem, &clearRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
-
-            // Copy from window DC (client area only)
-            BitBlt(hdcMem, offsetX, offsetY, clientWidth, clientHeight,
-                   hdcWindow, 0, 0, SRCCOPY);
-
-            ReleaseDC(hwnd, hdcWindow);
-            success = TRUE;
-        }
+// Capture the confirmed selection from the frozen overlay frame
+std::vector<uint8_t> CaptureSelectedRegion(int x, int y, int width, int height,
+                                           const capture_core::EncodeOptions& options) {
+    capture_core::Rect region(x, y, width, height);
+    capture_core::Rect bounds;
+    std::unique_ptr<DibSection> frozen = FrozenFrameStore::Shared().Take(&bounds);
+    if (!frozen || capture_core::IntersectRects(region, bounds) != region) {
+        DibSectionPool::Shared().Release(std::move(frozen));
+        return CaptureRegion(x, y, width, height, options);
     }
 
-    // Method 3: Last resort - capture from screen DC (desktop)
-    if (!success) {
-        // Ensure window is visible and not minimized
-        if (IsIconic(hwnd)) {
-            ShowWindow(hwnd, SW_RESTORE);
-        }
-
-        // Bring window to top without stealing focus
-        SetWindowPos(hwnd, HWND_TOP, 0, 0, 0, 0,
-                     SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
-
-        // Update window
-        UpdateWindow(hwnd);
+    capture_core::FrameBuffer frame;
+    frame.Wrap(frozen->bits(), bounds.width, bounds.height, frozen->stride(),
+               capture_core::PixelFormat::kBgrx8);
+    capture_core::FrozenFrameSource source(frame, bounds.x, bounds.y);
+    std::vector<uint8_t> result = EncodeFromSource(&source, region, options);
+    DibSectionPool::Shared().Release(std::move(frozen));
+    return result;
+}
 
-        // Small delay to let window paint
-        Sleep(100);
+// Two-phase variants of the captures above
+bool CaptureFullScreenFrame(capture_core::FrameBuffer* frame) {
+    GdiScreenSource source;
+    return CopyFromSource(&source, source.GetPrimaryBounds(), frame);
+}
 
-        // Clear bitmap first
-        RECT clearRect = {0, 0, width, height};
-        FillRect(hdcMem, &clearRect, (HBRUSH)GetStockObject(WHITE_BRUSH));
+bool CaptureRegionFrame(int x, int y, int width, int height, capture_core::FrameBuffer* frame) {
+    GdiScreenSource source;
+    return CopyFromSource(&source, capture_core::Rect(x, y, width, height), frame);
+}
 
-        // Capture from screen (desktop)
-        BitBlt(hdcMem, 0, 0, width, height, hdcScreen, rect.left, rect.top, SRCCOPY);
-        success = TRUE;
+bool CaptureSelectedRegionFrame(int x, int y, int width, int height,
+                                capture_core::FrameBuffer* frame) {
+    capture_core::Rect region(x, y, width, height);
+    capture_core::Rect bounds;
+    std::unique_ptr<DibSection> frozen = FrozenFrameStore::Shared().Take(&bounds);
+    if (!frozen || capture_core::IntersectRects(region, bounds) != region) {
+        DibSectionPool::Shared().Release(std::move(frozen));
+        return CaptureRegionFrame(x, y, width, height, frame);
     }
 
-    // Select old bitmap back
-    SelectObject(hdcMem, hOldBitmap);
-
-    // Convert to GDI+ bitmap
-    BITMAP bitmapInfo;
-    GetObject(hBitmap, sizeof(BITMAP), &bitmapInfo);
-
-    Bitmap* gdiBitmap = new Bitmap(bitmapInfo.bmWidth, bitmapInfo.bmHeight, PixelFormat32bppARGB);
-
-    // Get bitmap data
-    BitmapData bitmapData;
-    Rect gdiRect(0, 0, bitmapInfo.bmWidth, bitmapInfo.bmHeight);
-    Gdiplus::Status status = gdiBitmap->LockBits(&gdiRect, ImageLockModeWrite, PixelFormat32bppARGB, &bitmapData);
-
-    if (status == Gdiplus::Ok) {
-        BITMAPINFO bmi = {};
-        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = bitmapInfo.bmWidth;
-        bmi.bmiHeader.biHeight = -bitmapInfo.bmHeight;
-        bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 32;
-        bmi.bmiHeader.biCompression = BI_RGB;
-
-        GetDIBits(hdcScreen, hBitmap, 0, bitmapInfo.bmHeight,
-                 (BYTE*)bitmapData.Scan0, &bmi, DIB_RGB_COLORS);
+    capture_core::FrameBuffer frozenFrame;
+    frozenFrame.Wrap(frozen->bits(), bounds.width, bounds.height, frozen->stride(),
+                     capture_core::PixelFormat::kBgrx8);
+    capture_core::FrozenFrameSource source(frozenFrame, bounds.x, bounds.y);
+    bool ok = CopyFromSource(&source, region, frame);
+    DibSectionPool::Shared().Release(std::move(frozen));
+    return ok;
+}
 
-        gdiBitmap->UnlockBits(&bitmapData);
+bool CaptureWindowFrame(HWND hwnd, capture_core::FrameBuffer* frame) {
+    if (!IsWindow(hwnd)) {
+        frame->Reset();
+        return false;
     }
 
-    // Create IStream
-    IStream* stream = NULL;
-    CreateStreamOnHGlobal(NULL, TRUE, &stream);
+    GdiWindowSource source(hwnd);
+    return CopyFromSource(&source, source.GetBounds(), frame);
+}
 
-    // Save to PNG format
-    CLSID pngClsid;
-    GetEncoderClsid(L"image/png", &pngClsid);
-    status = gdiBitmap->Save(stream, &pngClsid);
+// Capture the whole virtual desktop
+std::vector<uint8_t> CaptureVirtualDesktop(capture_core::Rect* bounds,
+                                           std::vector<capture_core::MonitorInfo>* monitors,
+                                           const capture_core::EncodeOptions& options) {
+    // 拼接缓冲按工作线程保留，多显示器截图稳定后不再分配整张虚拟桌面
+    thread_local capture_core::FrameBuffer frame;
 
     std::vector<uint8_t> result;
-
-    if (status == Gdiplus::Ok) {
-        // Get stream size
-        STATSTG statstg;
-        stream->Stat(&statstg, STATFLAG_NONAME);
-
-        // Read stream data
-        LARGE_INTEGER pos;
-        pos.QuadPart = 0;
-        stream->Seek(pos, STREAM_SEEK_SET, NULL);
-
-        result.resize(statstg.cbSize.LowPart);
-        ULONG bytesRead;
-        stream->Read(result.data(), statstg.cbSize.LowPart, &bytesRead);
+    if (!CaptureVirtualDesktopFrame(&frame, bounds, monitors) ||
+        !WorkerEncoder(options).Encode(frame, &result)) {
+        result.clear();
     }
-
-    // Cleanup
-    stream->Release();
-    delete gdiBitmap;
-    DeleteObject(hBitmap);
-    DeleteDC(hdcMem);
-    ReleaseDC(NULL, hdcScreen);
-
     return result;
 }
 
-// Capture screen region
-std::vector<uint8_t> CaptureRegion(int x, int y, int width, int height) {
-    // Create device context
-    HDC hdcScreen = GetDC(NULL);
-    HDC hdcMem = CreateCompatibleDC(hdcScreen);
-
-    // Create bitmap
-    HBITMAP hBitmap = CreateCompatibleBitmap(hdcScreen, width, height);
-    HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
-
-    // Copy region to bitmap
-    BitBlt(hdcMem, 0, 0, width, height, hdcScreen, x, y, SRCCOPY);
-
-    // Select old bitmap back
-    SelectObject(hdcMem, hOldBitmap);
-
-    // Convert to GDI+ bitmap
-    BITMAP bitmapInfo;
-    GetObject(hBitmap, sizeof(BITMAP), &bitmapInfo);
-
-    Bitmap* gdiBitmap = new Bitmap(bitmapInfo.bmWidth, bitmapInfo.bmHeight, PixelFormat32bppARGB);
-
-    // Get bitmap data
-    BitmapData bitmapData;
-    Rect rect(0, 0, bitmapInfo.bmWidth, bitmapInfo.bmHeight);
-    Gdiplus::Status status = gdiBitmap->LockBits(&rect, ImageLockModeWrite, PixelFormat32bppARGB, &bitmapData);
-
-    if (status == Gdiplus::Ok) {
-        BITMAPINFO bmi = {};
-        bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
-        bmi.bmiHeader.biWidth = bitmapInfo.bmWidth;
-        bmi.bmiHeader.biHeight = -bitmapInfo.bmHeight;
-        bmi.bmiHeader.biPlanes = 1;
-        bmi.bmiHeader.biBitCount = 32;
-        bmi.bmiHeader.biCompression = BI_RGB;
-
-        GetDIBits(hdcScreen, hBitmap, 0, bitmapInfo.bmHeight,
-                 (BYTE*)bitmapData.Scan0, &bmi, DIB_RGB_COLORS);
-
-        gdiBitmap->UnlockBits(&bitmapData);
+// Capture each monitor separately
+std::vector<std::vector<uint8_t>> CaptureMonitors(std::vector<capture_core::MonitorInfo>* monitors,
+                                                  const capture_core::EncodeOptions& options) {
+    capture_core::MultiMonitorCapture capture(EnumerateMonitors(), GdiMonitorSourceFactory());
+    if (monitors != nullptr) {
+        *monitors = capture.monitors();
     }
 
-    // Create IStream
-    IStream* stream = NULL;
-    CreateStreamOnHGlobal(NULL, TRUE, &stream);
-
-    // Save to PNG format
-    CLSID pngClsid;
-    GetEncoderClsid(L"image/png", &pngClsid);
-    status = gdiBitmap->Save(stream, &pngClsid);
-
-    std::vector<uint8_t> result;
-
-    if (status == Gdiplus::Ok) {
-        // Get stream size
-        STATSTG statstg;
-        stream->Stat(&statstg, STATFLAG_NONAME);
-
-        // Read stream data
-        LARGE_INTEGER pos;
-        pos.QuadPart = 0;
-        stream->Seek(pos, STREAM_SEEK_SET, NULL);
-
-        result.resize(statstg.cbSize.LowPart);
-        ULONG bytesRead;
-        stream->Read(result.data(), statstg.cbSize.LowPart, &bytesRead);
+    std::vector<std::vector<uint8_t>> results;
+    if (!capture.CaptureEach()) {
+        return results;
     }
+    results.resize(capture.monitors().size());
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!WorkerEncoder(options).Encode(capture.frame(i), &results[i])) {
+            results.clear();
+            break;
+        }
+    }
+    return results;
+}
 
-    // Cleanup
-    stream->Release();
-    delete gdiBitmap;
-    DeleteObject(hBitmap);
-    DeleteDC(hdcMem);
-    ReleaseDC(NULL, hdcScreen);
+// Capture a batch of windows (thumbnails for the window picker)
+std::vector<capture_core::BatchCaptureItem> CaptureWindows(const std::vector<HWND>& hwnds, int maxSize,
+                                                           const capture_core::EncodeOptions& options) {
+    // 每个窗口一个来源，各自持有 DIB section，可以在不同线程上同时截取
+    std::vector<std::unique_ptr<GdiWindowSource>> owned;
+    std::vector<capture_core::FrameSource*> sources;
+    owned.reserve(hwnds.size());
+    sources.reserve(hwnds.size());
+    for (HWND hwnd : hwnds) {
+        if (IsWindow(hwnd)) {
+            owned.push_back(std::make_unique<GdiWindowSource>(hwnd));
+            sources.push_back(owned.back().get());
+        } else {
+            sources.push_back(nullptr);
+        }
+    }
 
-    return result;
+    capture_core::BatchCaptureOptions batchOptions;
+    batchOptions.max_dimension = maxSize;
+    batchOptions.encode = options;
+    return capture_core::CaptureBatch(sources, batchOptions);
 }
 
 // Enumerate all windows
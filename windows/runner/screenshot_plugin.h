@@ -19,12 +19,22 @@
 
 #include <gdiplus.h>
 
+#include "capture_core/batch_capture.h"
+#include "capture_core/frame_buffer.h"
+#include "capture_core/frame_encoder.h"
+#include "capture_core/monitor_info.h"
+
 // Structure to hold window information with icon
 struct WindowInfo {
     std::string title;
     std::string id;
     std::string appName;
     std::vector<uint8_t> icon;
+    // 屏幕坐标（GetWindowRect）
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
 };
 
 // Initialize GDI+ (call once at startup)
@@ -34,24 +44,65 @@ void InitializeGDIPlus();
 void ShutdownGDIPlus();
 
 // Capture full screen screenshot
-// Returns PNG image data as byte vector
-std::vector<uint8_t> CaptureFullScreen();
+// options 选择编码格式（PNG / JPEG）和 JPEG 质量，以下各函数相同
+// Returns encoded image data as byte vector
+std::vector<uint8_t> CaptureFullScreen(
+    const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
 
 // Capture specific window screenshot
 // hwnd: Window handle
-// Returns PNG image data as byte vector
-std::vector<uint8_t> CaptureWindow(HWND hwnd);
+// Returns encoded image data as byte vector
+std::vector<uint8_t> CaptureWindow(
+    HWND hwnd, const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
 
 // Capture screen region screenshot
 // x, y: Top-left corner of region
 // width, height: Size of region
-// Returns PNG image data as byte vector
-std::vector<uint8_t> CaptureRegion(int x, int y, int width, int height);
+// Returns encoded image data as byte vector
+std::vector<uint8_t> CaptureRegion(
+    int x, int y, int width, int height,
+    const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
+
+// Capture the region the user just confirmed in NativeScreenshotWindow
+// 从 FrozenFrameStore 中的冻结帧裁剪；冻结帧已被取走、超时或不包含该区域时
+// 退回 CaptureRegion 重新截屏
+// Returns encoded image data as byte vector
+std::vector<uint8_t> CaptureSelectedRegion(
+    int x, int y, int width, int height,
+    const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
+
+// Two-phase capture: only grab pixels, copied into frame (which owns them afterwards)
+// 编码交给 EncodeQueue 在后台进行；frame 可以是 EncodeQueue::AcquireFrame 借来的缓冲
+bool CaptureFullScreenFrame(capture_core::FrameBuffer* frame);
+bool CaptureRegionFrame(int x, int y, int width, int height, capture_core::FrameBuffer* frame);
+bool CaptureSelectedRegionFrame(int x, int y, int width, int height,
+                                capture_core::FrameBuffer* frame);
+bool CaptureWindowFrame(HWND hwnd, capture_core::FrameBuffer* frame);
+
+// Capture all monitors stitched into one virtual-desktop image
+std::vector<uint8_t> CaptureVirtualDesktop(
+    capture_core::Rect* bounds, std::vector<capture_core::MonitorInfo>* monitors,
+    const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
+
+// Capture every monitor concurrently, one image per monitor (same order as monitors)
+std::vector<std::vector<uint8_t>> CaptureMonitors(
+    std::vector<capture_core::MonitorInfo>* monitors,
+    const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
+
+// Capture several windows concurrently on the shared thread pool (same order as hwnds)
+// maxSize > 0 时长边缩小到 maxSize 作为缩略图；已经关闭的窗口对应的项 ok 为 false
+std::vector<capture_core::BatchCaptureItem> CaptureWindows(
+    const std::vector<HWND>& hwnds, int maxSize,
+    const capture_core::EncodeOptions& options = capture_core::EncodeOptions());
 
 // Enumerate all visible windows
 // Returns vector of WindowInfo structures
 std::vector<WindowInfo> EnumerateWindows();
 
+// Describe one window with the same filtering as EnumerateWindows
+// 不可见、最小化、没有标题、系统窗口或太小时返回 false
+bool DescribeWindow(HWND hwnd, WindowInfo* info);
+
 // Convert HWND from string representation
 HWND HwndFromString(const std::string& str);
 
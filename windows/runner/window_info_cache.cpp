@@ -0,0 +1,159 @@
+// Process name and icon cache for window enumeration
+#include "window_info_cache.h"
+
+#include <gdiplus.h>
+
+#include "screenshot_plugin.h"
+
+using namespace Gdiplus;
+
+namespace {
+
+std::string WideToUtf8(const std::wstring& text) {
+    int length = WideCharToMultiByte(CP_UTF8, 0, text.c_str(), -1, NULL, 0, NULL, NULL);
+    if (length <= 1) {
+        return std::string();
+    }
+    std::string utf8(length, 0);
+    WideCharToMultiByte(CP_UTF8, 0, text.c_str(), -1, &utf8[0], length, NULL, NULL);
+    utf8.resize(length - 1);
+    return utf8;
+}
+
+// 映像文件名去掉目录和扩展名
+std::string AppNameFromPath(const std::wstring& processPath) {
+    size_t lastSlash = processPath.find_last_of(L"\\/");
+    if (lastSlash == std::wstring::npos) {
+        return std::string();
+    }
+    std::wstring fileName = processPath.substr(lastSlash + 1);
+    size_t dotPos = fileName.find_last_of(L'.');
+    if (dotPos != std::wstring::npos) {
+        fileName = fileName.substr(0, dotPos);
+    }
+    return WideToUtf8(fileName);
+}
+
+// GDI+ 把图标编码为 PNG
+std::vector<uint8_t> EncodeIconPng(HICON hIcon) {
+    std::vector<uint8_t> iconData;
+    Bitmap* gdiBitmap = Bitmap::FromHICON(hIcon);
+    if (gdiBitmap == nullptr) {
+        return iconData;
+    }
+
+    IStream* stream = NULL;
+    CLSID pngClsid;
+    if (SUCCEEDED(CreateStreamOnHGlobal(NULL, TRUE, &stream)) &&
+        GetEncoderClsid(L"image/png", &pngClsid) >= 0 &&
+        gdiBitmap->Save(stream, &pngClsid) == Gdiplus::Ok) {
+        STATSTG statstg;
+        stream->Stat(&statstg, STATFLAG_NONAME);
+
+        LARGE_INTEGER pos;
+        pos.QuadPart = 0;
+        stream->Seek(pos, STREAM_SEEK_SET, NULL);
+
+        iconData.resize(statstg.cbSize.LowPart);
+        ULONG bytesRead = 0;
+        stream->Read(iconData.data(), statstg.cbSize.LowPart, &bytesRead);
+        iconData.resize(bytesRead);
+    }
+
+    if (stream != NULL) {
+        stream->Release();
+    }
+    delete gdiBitmap;
+    return iconData;
+}
+
+}  // namespace
+
+WindowInfoCache& WindowInfoCache::Shared() {
+    static WindowInfoCache cache;
+    return cache;
+}
+
+WindowInfoCache::WindowInfoCache() : processes_(kProcessCapacity), icons_(kIconCapacity) {}
+
+void WindowInfoCache::LookupProcess(DWORD processId, std::string* appName,
+                                    std::wstring* imagePath) {
+    appName->clear();
+    imagePath->clear();
+    if (processId == 0) {
+        return;
+    }
+    HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+    if (hProcess == NULL) {
+        return;
+    }
+
+    FILETIME creation, exitTime, kernel, user;
+    ULONGLONG creationTime = 0;
+    if (GetProcessTimes(hProcess, &creation, &exitTime, &kernel, &user)) {
+        creationTime = (static_cast<ULONGLONG>(creation.dwHighDateTime) << 32) |
+                       creation.dwLowDateTime;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ProcessEntry* entry = processes_.Find(processId);
+        if (entry != nullptr && creationTime != 0 && entry->creationTime == creationTime) {
+            *appName = entry->appName;
+            *imagePath = entry->imagePath;
+            CloseHandle(hProcess);
+            return;
+        }
+    }
+
+    // 未命中或 PID 已经属于另一个进程
+    WCHAR processName[MAX_PATH];
+    DWORD size = MAX_PATH;
+    if (QueryFullProcessImageNameW(hProcess, 0, processName, &size)) {
+        imagePath->assign(processName, size);
+        *appName = AppNameFromPath(*imagePath);
+    }
+    CloseHandle(hProcess);
+
+    if (creationTime != 0 && !imagePath->empty()) {
+        ProcessEntry entry;
+        entry.creationTime = creationTime;
+        entry.imagePath = *imagePath;
+        entry.appName = *appName;
+        std::lock_guard<std::mutex> lock(mutex_);
+        processes_.Put(processId, std::move(entry));
+    }
+}
+
+std::vector<uint8_t> WindowInfoCache::Icon(DWORD processId, const std::wstring& imagePath,
+                                           HICON hIcon) {
+    if (hIcon == NULL) {
+        return std::vector<uint8_t>();
+    }
+
+    // HICON 可能在图标销毁后被复用，加上映像路径（打不开的进程用 PID）区分
+    WCHAR handle[32];
+    swprintf_s(handle, L"|%p", hIcon);
+    std::wstring key = imagePath.empty() ? L"pid:" + std::to_wstring(processId) : imagePath;
+    key += handle;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (const std::vector<uint8_t>* cached = icons_.Find(key)) {
+            return *cached;
+        }
+    }
+
+    std::vector<uint8_t> iconData = EncodeIconPng(hIcon);
+    if (!iconData.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        icons_.Put(key, iconData);
+    }
+    return iconData;
+}
+
+void WindowInfoCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    processes_.Clear();
+    icons_.Clear();
+}
@@ -0,0 +1,54 @@
+#ifndef RUNNER_WINDOW_INFO_CACHE_H_
+#define RUNNER_WINDOW_INFO_CACHE_H_
+
+#include <windows.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "capture_core/lru_cache.h"
+
+// getAvailableWindows 的进程名和图标缓存
+//
+// 每次枚举都为每个窗口 OpenProcess + QueryFullProcessImageNameW 取进程名，
+// 再经 GDI+ 把图标编码成 PNG，窗口多时要几百毫秒，而结果很少变化。
+// 进程按 PID 缓存映像路径和应用名，用进程创建时间校验（PID 被复用后创建时间不同）；
+// 图标按（映像路径, HICON）缓存编码好的 PNG。两者都按最近最少使用淘汰。
+// 重复枚举时每个窗口只剩 OpenProcess + GetProcessTimes 和取 HICON 的消息。
+class WindowInfoCache {
+public:
+    static constexpr size_t kProcessCapacity = 256;
+    static constexpr size_t kIconCapacity = 256;
+
+    static WindowInfoCache& Shared();
+
+    // 进程的应用名（映像文件名去掉扩展名，UTF-8）和映像路径；进程打不开时都为空
+    void LookupProcess(DWORD processId, std::string* appName, std::wstring* imagePath);
+
+    // 图标编码成的 PNG；imagePath 为空时以 PID 区分。hIcon 为 NULL 或编码失败时为空
+    std::vector<uint8_t> Icon(DWORD processId, const std::wstring& imagePath, HICON hIcon);
+
+    void Clear();
+
+private:
+    struct ProcessEntry {
+        ULONGLONG creationTime = 0;
+        std::wstring imagePath;
+        std::string appName;
+    };
+
+    WindowInfoCache();
+
+    WindowInfoCache(const WindowInfoCache&) = delete;
+    WindowInfoCache& operator=(const WindowInfoCache&) = delete;
+
+    // 编码在锁外进行，两个线程同时未命中时各自编码一次，后写入的覆盖前一个
+    std::mutex mutex_;
+    capture_core::LruCache<DWORD, ProcessEntry> processes_;
+    capture_core::LruCache<std::wstring, std::vector<uint8_t>> icons_;
+};
+
+#endif  // RUNNER_WINDOW_INFO_CACHE_H_
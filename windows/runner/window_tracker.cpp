@@ -0,0 +1,212 @@
+// Event driven window list for the window picker
+#include "window_tracker.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "screenshot_plugin.h"
+
+namespace {
+
+// WINEVENT_OUTOFCONTEXT 的回调在安装钩子的线程上执行，通过线程局部变量找到跟踪器
+thread_local WindowTracker* t_tracker = nullptr;
+
+capture_core::WindowRecord ToRecord(HWND hwnd, WindowInfo info) {
+    capture_core::WindowRecord record;
+    record.id = WindowTracker::IdFromHwnd(hwnd);
+    record.title = std::move(info.title);
+    record.app_name = std::move(info.appName);
+    record.bounds = capture_core::Rect(info.x, info.y, info.width, info.height);
+    record.icon = std::move(info.icon);
+    return record;
+}
+
+BOOL CALLBACK CollectWindowsProc(HWND hwnd, LPARAM lParam) {
+    auto* records = reinterpret_cast<std::vector<capture_core::WindowRecord>*>(lParam);
+    WindowInfo info;
+    if (DescribeWindow(hwnd, &info)) {
+        records->push_back(ToRecord(hwnd, std::move(info)));
+    }
+    return TRUE;
+}
+
+}  // namespace
+
+WindowTracker::~WindowTracker() { Stop(); }
+
+uint64_t WindowTracker::IdFromHwnd(HWND hwnd) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(hwnd));
+}
+
+std::string WindowTracker::FormatId(uint64_t id) {
+    char windowId[64];
+    sprintf_s(windowId, "%p", reinterpret_cast<HWND>(static_cast<uintptr_t>(id)));
+    return std::string(windowId);
+}
+
+bool WindowTracker::Start(ReadyCallback on_ready, ChangeCallback on_change) {
+    if (running()) {
+        return false;
+    }
+    on_change_ = std::move(on_change);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        model_ = capture_core::WindowListModel();
+    }
+    dirty_.clear();
+
+    // 线程 id 要在 Stop 投递 WM_QUIT 之前确定，消息队列在线程里第一次 PeekMessage 时创建
+    HANDLE queue_ready = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    thread_ = std::thread([this, queue_ready, on_ready = std::move(on_ready)]() mutable {
+        MSG msg;
+        PeekMessage(&msg, nullptr, WM_USER, WM_USER, PM_NOREMOVE);
+        thread_id_ = GetCurrentThreadId();
+        SetEvent(queue_ready);
+        Run(std::move(on_ready));
+    });
+    WaitForSingleObject(queue_ready, INFINITE);
+    CloseHandle(queue_ready);
+    return true;
+}
+
+void WindowTracker::Stop() {
+    if (!running()) {
+        return;
+    }
+    PostThreadMessage(thread_id_, WM_QUIT, 0, 0);
+    // 跟踪线程可能正在向本线程的窗口发送 WM_GETICON，等待期间继续处理跨线程发送的消息
+    HANDLE handle = thread_.native_handle();
+    MSG msg;
+    while (MsgWaitForMultipleObjects(1, &handle, FALSE, INFINITE, QS_SENDMESSAGE) ==
+           WAIT_OBJECT_0 + 1) {
+        PeekMessage(&msg, nullptr, 0, 0, PM_NOREMOVE | PM_QS_SENDMESSAGE);
+    }
+    thread_.join();
+    thread_id_ = 0;
+    on_change_ = nullptr;
+}
+
+std::vector<capture_core::WindowRecord> WindowTracker::Snapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return model_.Snapshot();
+}
+
+void WindowTracker::Run(ReadyCallback on_ready) {
+    t_tracker = this;
+
+    // 先装钩子再枚举，枚举期间的变化会在第一批事件里补上
+    const DWORD flags = WINEVENT_OUTOFCONTEXT;
+    HWINEVENTHOOK object_hook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_NAMECHANGE,
+                                                nullptr, WinEventProc, 0, 0, flags);
+    HWINEVENTHOOK minimize_hook = SetWinEventHook(EVENT_SYSTEM_MINIMIZESTART,
+                                                  EVENT_SYSTEM_MINIMIZEEND, nullptr,
+                                                  WinEventProc, 0, 0, flags);
+
+    std::vector<capture_core::WindowRecord> records;
+    EnumWindows(CollectWindowsProc, reinterpret_cast<LPARAM>(&records));
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        model_.Reset(std::move(records));
+        model_.TakeDiff();
+    }
+    on_ready(Snapshot());
+
+    MSG msg;
+    bool quit = false;
+    while (!quit) {
+        DWORD timeout = INFINITE;
+        if (!dirty_.empty()) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                dirty_since_ + kCoalesce - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) {
+                Flush();
+                continue;
+            }
+            timeout = static_cast<DWORD>(remaining.count());
+        }
+        // 钩子回调在取消息时分发
+        MsgWaitForMultipleObjectsEx(0, nullptr, timeout, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+        while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+            if (msg.message == WM_QUIT) {
+                quit = true;
+                break;
+            }
+            DispatchMessage(&msg);
+        }
+    }
+
+    if (object_hook != nullptr) UnhookWinEvent(object_hook);
+    if (minimize_hook != nullptr) UnhookWinEvent(minimize_hook);
+    t_tracker = nullptr;
+}
+
+void CALLBACK WindowTracker::WinEventProc(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject,
+                                          LONG idChild, DWORD, DWORD) {
+    if (t_tracker == nullptr || hwnd == nullptr || idObject != OBJID_WINDOW ||
+        idChild != CHILDID_SELF) {
+        return;
+    }
+    switch (event) {
+        case EVENT_OBJECT_DESTROY:
+            // 窗口已经销毁，取不到父窗口；只处理列表里有的
+            {
+                std::lock_guard<std::mutex> lock(t_tracker->mutex_);
+                if (!t_tracker->model_.Contains(IdFromHwnd(hwnd))) return;
+            }
+            break;
+        case EVENT_OBJECT_CREATE:
+        case EVENT_OBJECT_SHOW:
+        case EVENT_OBJECT_HIDE:
+        case EVENT_OBJECT_NAMECHANGE:
+        case EVENT_OBJECT_LOCATIONCHANGE:
+        case EVENT_SYSTEM_MINIMIZESTART:
+        case EVENT_SYSTEM_MINIMIZEEND:
+            // 只关心顶层窗口，子控件的事件最多
+            if (GetAncestor(hwnd, GA_PARENT) != GetDesktopWindow()) return;
+            break;
+        default:
+            return;
+    }
+    t_tracker->MarkDirty(hwnd);
+}
+
+void WindowTracker::MarkDirty(HWND hwnd) {
+    if (dirty_.empty()) {
+        dirty_since_ = std::chrono::steady_clock::now();
+    }
+    if (std::find(dirty_.begin(), dirty_.end(), hwnd) == dirty_.end()) {
+        dirty_.push_back(hwnd);
+    }
+}
+
+void WindowTracker::Flush() {
+    std::vector<HWND> dirty;
+    dirty.swap(dirty_);
+
+    // 描述窗口要发消息，不持锁
+    std::vector<capture_core::WindowRecord> described;
+    std::vector<uint64_t> gone;
+    for (HWND hwnd : dirty) {
+        WindowInfo info;
+        if (IsWindow(hwnd) && DescribeWindow(hwnd, &info)) {
+            described.push_back(ToRecord(hwnd, std::move(info)));
+        } else {
+            gone.push_back(IdFromHwnd(hwnd));
+        }
+    }
+
+    capture_core::WindowListDiff diff;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (uint64_t id : gone) {
+            model_.Remove(id);
+        }
+        for (capture_core::WindowRecord& record : described) {
+            model_.Upsert(std::move(record));
+        }
+        diff = model_.TakeDiff();
+    }
+    if (!diff.empty() && on_change_) {
+        on_change_(diff);
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef RUNNER_WINDOW_TRACKER_H_
+#define RUNNER_WINDOW_TRACKER_H_
+
+#include <windows.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "capture_core/window_list.h"
+
+// 窗口选择器的实时窗口列表（startWindowTracking / stopWindowTracking）
+//
+// 启动时在自己的线程上 EnumWindows 一次，之后用 SetWinEventHook（WINEVENT_OUTOFCONTEXT）
+// 监听顶层窗口的创建、销毁、显示、隐藏、改名、移动和最小化 / 还原，
+// 只重新描述（DescribeWindow，与 EnumerateWindows 相同的过滤）发生变化的窗口。
+// 事件按 kCoalesce 合并，一批事件产生一次 on_change。
+// 两个回调都在跟踪线程上调用。
+class WindowTracker {
+public:
+    using ReadyCallback = std::function<void(std::vector<capture_core::WindowRecord>)>;
+    using ChangeCallback = std::function<void(const capture_core::WindowListDiff&)>;
+
+    static constexpr std::chrono::milliseconds kCoalesce{100};
+
+    WindowTracker() = default;
+    ~WindowTracker();
+
+    WindowTracker(const WindowTracker&) = delete;
+    WindowTracker& operator=(const WindowTracker&) = delete;
+
+    // 启动跟踪线程并立即返回；初始列表枚举完成后调用 on_ready。
+    // 枚举要向各窗口（包括调用线程的窗口）发送 WM_GETICON，所以不在这里等待
+    bool Start(ReadyCallback on_ready, ChangeCallback on_change);
+
+    // 停止并等待跟踪线程退出（等待期间处理跨线程发送的消息）
+    void Stop();
+    bool running() const { return thread_.joinable(); }
+
+    std::vector<capture_core::WindowRecord> Snapshot();
+
+    // WindowRecord::id 与 Dart 使用的 "%p" 窗口 id 互转
+    static uint64_t IdFromHwnd(HWND hwnd);
+    static std::string FormatId(uint64_t id);
+
+private:
+    static void CALLBACK WinEventProc(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                      LONG idChild, DWORD eventThread, DWORD eventTime);
+
+    void Run(ReadyCallback on_ready);
+    void MarkDirty(HWND hwnd);
+    void Flush();
+
+    ChangeCallback on_change_;
+    std::thread thread_;
+    DWORD thread_id_ = 0;
+
+    // 只在跟踪线程上访问
+    std::vector<HWND> dirty_;
+    std::chrono::steady_clock::time_point dirty_since_;
+
+    std::mutex mutex_;
+    capture_core::WindowListModel model_;
+};
+
+#endif  // RUNNER_WINDOW_TRACKER_H_